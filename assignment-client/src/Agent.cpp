@@ -393,6 +393,8 @@ void Agent::executeScript() {
 
     auto avatarHashMap = DependencyManager::set<AvatarHashMap>();
     _scriptEngine->registerGlobalObject("AvatarList", avatarHashMap.data());
+    // scripts have no use for other avatars' face tracking, so don't unpack it
+    avatarHashMap->setIgnoredDataSections(AvatarDataPacket::PACKET_HAS_FACE_TRACKER_INFO);
 
     auto& packetReceiver = DependencyManager::get<NodeList>()->getPacketReceiver();
     packetReceiver.registerListener(PacketType::BulkAvatarData, avatarHashMap.data(), "processAvatarDataPacket");
@@ -548,6 +550,9 @@ void Agent::processAgentAvatar() {
         AvatarData::AvatarDataDetail dataDetail = (randFloat() < AVATAR_SEND_FULL_UPDATE_RATIO) ? AvatarData::SendAllData : AvatarData::CullSmallData;
         QByteArray avatarByteArray = scriptedAvatar->toByteArrayStateful(dataDetail);
         scriptedAvatar->doneEncoding(true);
+        if (avatarByteArray.isEmpty()) {
+            return;
+        }
 
         static AvatarDataSequenceNumber sequenceNumber = 0;
         auto avatarPacket = NLPacket::create(PacketType::AvatarData, avatarByteArray.size() + sizeof(sequenceNumber));
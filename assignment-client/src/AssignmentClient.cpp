@@ -11,6 +11,7 @@
 
 #include <assert.h>
 
+#include <QJsonObject>
 #include <QProcess>
 #include <QSharedMemory>
 #include <QThread>
@@ -21,9 +22,11 @@
 #include <Assignment.h>
 #include <AvatarHashMap.h>
 #include <EntityScriptingInterface.h>
+#include <HTTPConnection.h>
 #include <LogHandler.h>
 #include <LogUtils.h>
 #include <LimitedNodeList.h>
+#include <Metrics.h>
 #include <NodeList.h>
 #include <udt/PacketHeaders.h>
 #include <SharedUtil.h>
@@ -273,6 +276,10 @@ void AssignmentClient::handleCreateAssignmentPacket(QSharedPointer<ReceivedMessa
         // once the worker thread says it is done, we consider the assignment completed
         connect(workerThread, &QThread::destroyed, this, &AssignmentClient::assignmentCompleted);
 
+        metrics::Registry::getInstance().setCommonLabels({ { "type", _currentAssignment->getTypeName() } });
+        connect(&nodeList->getDomainHandler(), &DomainHandler::settingsReceived,
+                this, &AssignmentClient::parseMetricsSettings, Qt::UniqueConnection);
+
         _currentAssignment->moveToThread(workerThread);
 
         // Starts an event loop, and emits workerThread->started()
@@ -295,6 +302,43 @@ void AssignmentClient::handleStopNodePacket(QSharedPointer<ReceivedMessage> mess
     }
 }
 
+void AssignmentClient::parseMetricsSettings(const QJsonObject& settingsObject) {
+    if (!_currentAssignment || _metricsHTTPManager) {
+        return;
+    }
+
+    // each assignment type gets its own port, so the assignment clients on one host can all be scraped;
+    // agents are left out since there can be any number of them
+    auto assignmentType = _currentAssignment->getType();
+    if (assignmentType == Assignment::AgentType) {
+        return;
+    }
+
+    const QString METRICS_SETTINGS_KEY = "metrics";
+    const QString HTTP_PORT_BASE_KEY = "http_port_base";
+    bool ok;
+    int portBase = settingsObject[METRICS_SETTINGS_KEY].toObject()[HTTP_PORT_BASE_KEY].toVariant().toInt(&ok);
+    if (!ok || portBase <= 0) {
+        return;
+    }
+
+    quint16 port = (quint16)(portBase + assignmentType);
+    qCDebug(assignment_client) << "Serving metrics for" << _currentAssignment->getTypeName() << "on port" << port;
+    // metrics are optional: if the port is taken, keep running and keep trying to bind it
+    const bool EXIT_ON_BIND_FAILURE = false;
+    _metricsHTTPManager = new HTTPManager(QHostAddress::AnyIPv4, port, QString(), this, this, EXIT_ON_BIND_FAILURE);
+}
+
+bool AssignmentClient::handleHTTPRequest(HTTPConnection* connection, const QUrl& url, bool skipSubHandler) {
+    if (url.path() == "/metrics") {
+        connection->respond(HTTPConnection::StatusCode200, metrics::Registry::getInstance().serialize(),
+                            metrics::CONTENT_TYPE);
+        return true;
+    }
+
+    return false;
+}
+
 void AssignmentClient::handleAuthenticationRequest() {
     const QString DATA_SERVER_USERNAME_ENV = "HIFI_AC_USERNAME";
     const QString DATA_SERVER_PASSWORD_ENV = "HIFI_AC_PASSWORD";
@@ -326,6 +370,11 @@ void AssignmentClient::assignmentCompleted() {
     // reset our current assignment pointer to null now that it has been deleted
     _currentAssignment = nullptr;
 
+    // the next assignment may be of another type, it will serve its metrics on its own port
+    if (_metricsHTTPManager) {
+        _metricsHTTPManager->deleteLater();
+    }
+
     // reset the logging target to the the CHILD_TARGET_NAME
     LogHandler::getInstance().setTargetName(ASSIGNMENT_CLIENT_TARGET_NAME);
 
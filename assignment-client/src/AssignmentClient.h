@@ -15,11 +15,13 @@
 #include <QtCore/QCoreApplication>
 #include <QtCore/QPointer>
 
+#include <HTTPManager.h>
+
 #include "ThreadedAssignment.h"
 
 class QSharedMemory;
 
-class AssignmentClient : public QObject {
+class AssignmentClient : public QObject, public HTTPRequestHandler {
     Q_OBJECT
 public:
     AssignmentClient(Assignment::Type requestAssignmentType, QString assignmentPool,
@@ -28,6 +30,8 @@ public:
                      quint16 assignmentMonitorPort);
     ~AssignmentClient();
 
+    bool handleHTTPRequest(HTTPConnection* connection, const QUrl& url, bool skipSubHandler = false) override;
+
 private slots:
     void sendAssignmentRequest();
     void assignmentCompleted();
@@ -41,6 +45,7 @@ public slots:
 private slots:
     void handleCreateAssignmentPacket(QSharedPointer<ReceivedMessage> message);
     void handleStopNodePacket(QSharedPointer<ReceivedMessage> message);
+    void parseMetricsSettings(const QJsonObject& settingsObject);
 
 private:
     void setUpStatusToMonitor();
@@ -53,6 +58,7 @@ private:
     QTimer _requestTimer; // timer for requesting and assignment
     QTimer _statsTimerACM; // timer for sending stats to assignment client monitor
     QUuid _childAssignmentUUID = QUuid::createUuid();
+    QPointer<HTTPManager> _metricsHTTPManager; // serves /metrics while an assignment runs, if the domain asks for it
 
  protected:
     HifiSockAddr _assignmentClientMonitorSocket;
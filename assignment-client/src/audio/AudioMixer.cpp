@@ -17,12 +17,14 @@
 #include <QtCore/QJsonValue>
 
 #include <LogHandler.h>
+#include <Metrics.h>
 #include <NetworkAccessManager.h>
 #include <NodeList.h>
 #include <Node.h>
 #include <OctreeConstants.h>
 #include <plugins/PluginManager.h>
 #include <plugins/CodecPlugin.h>
+#include <Profile.h>
 #include <udt/PacketHeaders.h>
 #include <SharedUtil.h>
 #include <StDev.h>
@@ -43,8 +45,10 @@ static const QString AUDIO_MIXER_LOGGING_TARGET_NAME = "audio-mixer";
 static const QString AUDIO_ENV_GROUP_KEY = "audio_env";
 static const QString AUDIO_BUFFER_GROUP_KEY = "audio_buffer";
 static const QString AUDIO_THREADING_GROUP_KEY = "audio_threading";
+static const QString TRACING_GROUP_KEY = "tracing";
 
 int AudioMixer::_numStaticJitterFrames{ -1 };
+float AudioMixer::_jitterBufferPercentile{ InboundAudioStream::DEFAULT_JITTER_BUFFER_PERCENTILE };
 float AudioMixer::_noiseMutingThreshold{ DEFAULT_NOISE_MUTING_THRESHOLD };
 float AudioMixer::_attenuationPerDoublingInDistance{ DEFAULT_ATTENUATION_PER_DOUBLING_IN_DISTANCE };
 std::map<QString, std::shared_ptr<CodecPlugin>> AudioMixer::_availableCodecs{ };
@@ -56,6 +60,12 @@ QVector<AudioMixer::ReverbSettings> AudioMixer::_zoneReverbSettings;
 AudioMixer::AudioMixer(ReceivedMessage& message) :
     ThreadedAssignment(message) {
 
+    auto& metricsRegistry = metrics::Registry::getInstance();
+    _frameTimeMetric = &metricsRegistry.histogram("hifi_audio_mixer_frame_seconds", "Time to mix a frame, without the sleep",
+                                                  metrics::Histogram::exponentialBounds(0.00025, 2.0, 8));
+    _throttlingRatioMetric = &metricsRegistry.gauge("hifi_audio_mixer_throttling_ratio", "Ratio of streams throttled");
+    _silentPacketsMetric = &metricsRegistry.counter("hifi_audio_mixer_silent_packets_total", "Silent audio packets received");
+
     // hash the available codecs (on the mixer)
     auto codecPlugins = PluginManager::getInstance()->getCodecPlugins();
     std::for_each(codecPlugins.cbegin(), codecPlugins.cend(),
@@ -283,6 +293,10 @@ void AudioMixer::sendStatsPacket() {
 
     statsObject["mix_stats"] = mixStats;
 
+    _stats.addToMetrics(_numStatFrames);
+    _throttlingRatioMetric->set(_throttlingRatio);
+    _silentPacketsMetric->increment(_numSilentPackets);
+
     _numStatFrames = _numSilentPackets = 0;
     _stats.reset();
 
@@ -361,25 +375,38 @@ void AudioMixer::start() {
             auto timer = _sleepTiming.timer();
             auto frameDuration = timeFrame(frameTimestamp);
             throttle(frameDuration, frame);
+
+            _frameTimeMetric->record((double)frameDuration.count() / USECS_PER_SECOND);
+
+            // the slow frame is still in the rolling trace
+            if (_traceFrameThreshold.count() > 0 && frameDuration > _traceFrameThreshold) {
+                captureTrace(QString("audio mixer frame took %1us").arg(frameDuration.count()));
+            }
         }
 
         auto frameTimer = _frameTiming.timer();
+        PROFILE_RANGE(mixer, "AudioMixer::frame");
+
+        {
+            // the same nodes are prepared and mixed, even if one is added or removed in between
+            auto nodes = nodeList->getNodeSnapshot();
 
-        nodeList->nestedEach([&](NodeList::const_iterator cbegin, NodeList::const_iterator cend) {
             // prepare frames; pop off any new audio from their streams
             {
                 auto prepareTimer = _prepareTiming.timer();
-                std::for_each(cbegin, cend, [&](const SharedNodePointer& node) {
+                PROFILE_RANGE(mixer, "AudioMixer::prepare");
+                for (const SharedNodePointer& node : *nodes) {
                     _stats.sumStreams += prepareFrame(node, frame);
-                });
+                }
             }
 
             // mix across slave threads
             {
                 auto mixTimer = _mixTiming.timer();
-                _slavePool.mix(cbegin, cend, frame, _throttlingRatio);
+                PROFILE_RANGE(mixer, "AudioMixer::mix");
+                _slavePool.mix(nodes, frame, _throttlingRatio);
             }
-        });
+        }
 
         // gather stats
         _slavePool.each([&](AudioMixerSlave& slave) {
@@ -393,16 +420,16 @@ void AudioMixer::start() {
         // process queued events (networking, global audio packets, &c.)
         {
             auto eventsTimer = _eventsTiming.timer();
+            PROFILE_RANGE(mixer, "AudioMixer::events");
 
             // since we're a while loop we need to yield to qt's event processing
             QCoreApplication::processEvents();
 
             // process (node-isolated) audio packets across slave threads
             {
-                nodeList->nestedEach([&](NodeList::const_iterator cbegin, NodeList::const_iterator cend) {
-                    auto packetsTimer = _packetsTiming.timer();
-                    _slavePool.processPackets(cbegin, cend);
-                });
+                auto packetsTimer = _packetsTiming.timer();
+                PROFILE_RANGE(mixer, "AudioMixer::packets");
+                _slavePool.processPackets(nodeList->getNodeSnapshot());
             }
         }
 
@@ -492,6 +519,17 @@ int AudioMixer::prepareFrame(const SharedNodePointer& node, unsigned int frame)
 void AudioMixer::parseSettingsObject(const QJsonObject &settingsObject) {
     qDebug() << "AVX2 Support:" << (cpuSupportsAVX2() ? "enabled" : "disabled");
 
+    if (settingsObject.contains(TRACING_GROUP_KEY)) {
+        QJsonObject tracingGroupObject = settingsObject[TRACING_GROUP_KEY].toObject();
+        const QString FRAME_THRESHOLD_KEY = "audio_mixer_frame_threshold_ms";
+        bool ok;
+        int frameThreshold = tracingGroupObject[FRAME_THRESHOLD_KEY].toVariant().toInt(&ok);
+        _traceFrameThreshold = std::chrono::milliseconds(ok ? std::max(frameThreshold, 0) : 0);
+        if (_traceFrameThreshold.count() > 0) {
+            qDebug() << "Capturing a trace for frames slower than" << frameThreshold << "ms";
+        }
+    }
+
     if (settingsObject.contains(AUDIO_THREADING_GROUP_KEY)) {
         QJsonObject audioThreadingGroupObject = settingsObject[AUDIO_THREADING_GROUP_KEY].toObject();
         const QString AUTO_THREADS = "auto_threads";
@@ -527,11 +565,21 @@ void AudioMixer::parseSettingsObject(const QJsonObject &settingsObject) {
             _numStaticJitterFrames = -1;
         }
 
+        bool ok;
+
+        const QString JITTER_BUFFER_PERCENTILE_JSON_KEY = "jitter_buffer_percentile";
+        float jitterBufferPercentile = audioBufferGroupObject[JITTER_BUFFER_PERCENTILE_JSON_KEY].toString().toFloat(&ok);
+        if (ok && jitterBufferPercentile >= 0.0f && jitterBufferPercentile <= 100.0f) {
+            _jitterBufferPercentile = jitterBufferPercentile / 100.0f;
+        } else {
+            _jitterBufferPercentile = InboundAudioStream::DEFAULT_JITTER_BUFFER_PERCENTILE;
+        }
+        qDebug() << "Jitter buffer percentile:" << _jitterBufferPercentile;
+
         // check for deprecated audio settings
         auto deprecationNotice = [](const QString& setting, const QString& value) {
             qInfo().nospace() << "[DEPRECATION NOTICE] " << setting << "(" << value << ") has been deprecated, and has no effect";
         };
-        bool ok;
 
         const QString MAX_FRAMES_OVER_DESIRED_JSON_KEY = "max_frames_over_desired";
         int maxFramesOverDesired = audioBufferGroupObject[MAX_FRAMES_OVER_DESIRED_JSON_KEY].toString().toInt(&ok);
@@ -15,6 +15,7 @@
 #include <AABox.h>
 #include <AudioHRTF.h>
 #include <AudioRingBuffer.h>
+#include <Metrics.h>
 #include <ThreadedAssignment.h>
 #include <UUIDHasher.h>
 
@@ -44,6 +45,7 @@ public:
     };
 
     static int getStaticJitterFrames() { return _numStaticJitterFrames; }
+    static float getJitterBufferPercentile() { return _jitterBufferPercentile; }
     static bool shouldMute(float quietestFrame) { return quietestFrame > _noiseMutingThreshold; }
     static float getAttenuationPerDoublingInDistance() { return _attenuationPerDoublingInDistance; }
     static const QHash<QString, AABox>& getAudioZones() { return _audioZones; }
@@ -83,6 +85,12 @@ private:
     float _trailingMixRatio { 0.0f };
     float _throttlingRatio { 0.0f };
 
+    std::chrono::microseconds _traceFrameThreshold { 0 }; // frames slower than this capture a trace, 0 never does
+
+    metrics::Histogram* _frameTimeMetric;
+    metrics::Gauge* _throttlingRatioMetric;
+    metrics::Counter* _silentPacketsMetric;
+
     int _numSilentPackets { 0 };
 
     int _numStatFrames { 0 };
@@ -120,6 +128,7 @@ private:
     Timer _packetsTiming;
 
     static int _numStaticJitterFrames; // -1 denotes dynamic jitter buffering
+    static float _jitterBufferPercentile; // 0 sizes dynamic jitter buffers by the window max gap
     static float _noiseMutingThreshold;
     static float _attenuationPerDoublingInDistance;
     static std::map<QString, CodecPluginPointer> _availableCodecs;
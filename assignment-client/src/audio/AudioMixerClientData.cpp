@@ -206,6 +206,7 @@ int AudioMixerClientData::parseData(ReceivedMessage& message) {
                 bool isStereo = channelFlag == 1;
 
                 auto avatarAudioStream = new AvatarAudioStream(isStereo, AudioMixer::getStaticJitterFrames());
+                avatarAudioStream->setJitterBufferPercentile(AudioMixer::getJitterBufferPercentile());
                 avatarAudioStream->setupCodec(_codec, _selectedCodecName, AudioConstants::MONO);
                 qDebug() << "creating new AvatarAudioStream... codec:" << _selectedCodecName;
 
@@ -240,6 +241,7 @@ int AudioMixerClientData::parseData(ReceivedMessage& message) {
             if (streamIt == _audioStreams.end()) {
                 // we don't have this injected stream yet, so add it
                 auto injectorStream = new InjectedAudioStream(streamIdentifier, isStereo, AudioMixer::getStaticJitterFrames());
+                injectorStream->setJitterBufferPercentile(AudioMixer::getJitterBufferPercentile());
 
 #if INJECTORS_SUPPORT_CODECS
                 injectorStream->setupCodec(_codec, _selectedCodecName, isStereo ? AudioConstants::STEREO : AudioConstants::MONO);
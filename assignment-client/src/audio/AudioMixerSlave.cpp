@@ -60,9 +60,8 @@ void AudioMixerSlave::processPackets(const SharedNodePointer& node) {
     }
 }
 
-void AudioMixerSlave::configureMix(ConstIter begin, ConstIter end, unsigned int frame, float throttlingRatio) {
-    _begin = begin;
-    _end = end;
+void AudioMixerSlave::configureMix(const NodeSnapshot& nodes, unsigned int frame, float throttlingRatio) {
+    _nodes = nodes;
     _frame = frame;
     _throttlingRatio = throttlingRatio;
 }
@@ -126,6 +125,7 @@ bool AudioMixerSlave::prepareMix(const SharedNodePointer& listener) {
 
     // zero out the mix for this listener
     memset(_mixSamples, 0, sizeof(_mixSamples));
+    _hrtfSources.clear();
 
     bool isThrottling = _throttlingRatio > 0.0f;
     std::vector<std::pair<float, SharedNodePointer>> throttledNodes;
@@ -144,7 +144,7 @@ bool AudioMixerSlave::prepareMix(const SharedNodePointer& listener) {
     auto mixStart = p_high_resolution_clock::now();
 #endif
 
-    std::for_each(_begin, _end, [&](const SharedNodePointer& node) {
+    std::for_each(_nodes->cbegin(), _nodes->cend(), [&](const SharedNodePointer& node) {
         AudioMixerClientData* nodeData = static_cast<AudioMixerClientData*>(node->getLinkedData());
         if (!nodeData) {
             return;
@@ -192,7 +192,7 @@ bool AudioMixerSlave::prepareMix(const SharedNodePointer& listener) {
 
     if (isThrottling) {
         // pop the loudest nodes off the heap and mix their streams
-        int numToRetain = (int)(std::distance(_begin, _end) * (1 - _throttlingRatio));
+        int numToRetain = (int)(_nodes->size() * (1 - _throttlingRatio));
         for (int i = 0; i < numToRetain; i++) {
             if (throttledNodes.empty()) {
                 break;
@@ -215,6 +215,8 @@ bool AudioMixerSlave::prepareMix(const SharedNodePointer& listener) {
         }
     }
 
+    renderHRTFBatch();
+
 #ifdef HIFI_AUDIO_MIXER_DEBUG
     auto mixEnd = p_high_resolution_clock::now();
     auto mixTime = std::chrono::duration_cast<std::chrono::nanoseconds>(mixEnd - mixStart);
@@ -328,11 +330,18 @@ void AudioMixerSlave::addStream(AudioMixerClientData& listenerNodeData, const QU
     // get the existing listener-source HRTF object, or create a new one
     auto& hrtf = listenerNodeData.hrtfForStream(sourceNodeID, streamToAdd.getStreamIdentifier());
 
-    streamPopOutput.readSamples(_bufferSamples, AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+    // read the input into the next slot of the HRTF batch
+    size_t sourceIndex = _hrtfSources.size();
+    size_t samplesNeeded = (sourceIndex + 1) * AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL;
+    if (_hrtfSourceSamples.size() < samplesNeeded) {
+        _hrtfSourceSamples.resize(samplesNeeded);
+    }
+    int16_t* sourceSamples = &_hrtfSourceSamples[sourceIndex * AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL];
+    streamPopOutput.readSamples(sourceSamples, AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
 
     if (streamToAdd.getLastPopOutputLoudness() == 0.0f) {
         // call renderSilent to reduce artifacts
-        hrtf.renderSilent(_bufferSamples, _mixSamples, HRTF_DATASET_INDEX, azimuth, distance, gain,
+        hrtf.renderSilent(sourceSamples, _mixSamples, HRTF_DATASET_INDEX, azimuth, distance, gain,
                           AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
 
         ++stats.hrtfSilentRenders;
@@ -341,19 +350,36 @@ void AudioMixerSlave::addStream(AudioMixerClientData& listenerNodeData, const QU
 
     if (throttle) {
         // call renderSilent with actual frame data and a gain of 0.0f to reduce artifacts
-        hrtf.renderSilent(_bufferSamples, _mixSamples, HRTF_DATASET_INDEX, azimuth, distance, 0.0f,
+        hrtf.renderSilent(sourceSamples, _mixSamples, HRTF_DATASET_INDEX, azimuth, distance, 0.0f,
                           AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
 
         ++stats.hrtfThrottleRenders;
         return;
     }
 
-    hrtf.render(_bufferSamples, _mixSamples, HRTF_DATASET_INDEX, azimuth, distance, gain,
-                AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+    // queue the source, renderHRTFBatch renders all of them together
+    _hrtfSources.push_back({ &hrtf, nullptr, azimuth, distance, gain });
 
     ++stats.hrtfRenders;
 }
 
+void AudioMixerSlave::renderHRTFBatch() {
+    if (_hrtfSources.empty()) {
+        return;
+    }
+
+    // point the sources at their input now that it has stopped growing
+    for (size_t i = 0; i < _hrtfSources.size(); ++i) {
+        _hrtfSources[i].input = &_hrtfSourceSamples[i * AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL];
+    }
+
+    const int HRTF_DATASET_INDEX = 1;
+    AudioHRTF::renderBatch(_hrtfSources.data(), (int)_hrtfSources.size(), _mixSamples, HRTF_DATASET_INDEX,
+                           AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+
+    _hrtfSources.clear();
+}
+
 std::unique_ptr<NLPacket> createAudioPacket(PacketType type, int size, quint16 sequence, QString codec) {
     auto audioPacket = NLPacket::create(type, size);
     audioPacket->writePrimitive(sequence);
@@ -12,6 +12,8 @@
 #ifndef hifi_AudioMixerSlave_h
 #define hifi_AudioMixerSlave_h
 
+#include <vector>
+
 #include <AABox.h>
 #include <AudioHRTF.h>
 #include <AudioRingBuffer.h>
@@ -28,13 +30,13 @@ class AudioMixerClientData;
 
 class AudioMixerSlave {
 public:
-    using ConstIter = NodeList::const_iterator;
+    using NodeSnapshot = NodeList::NodeSnapshot;
 
     // process packets for a given node (requires no configuration)
     void processPackets(const SharedNodePointer& node);
 
     // configure a round of mixing
-    void configureMix(ConstIter begin, ConstIter end, unsigned int frame, float throttlingRatio);
+    void configureMix(const NodeSnapshot& nodes, unsigned int frame, float throttlingRatio);
 
     // mix and broadcast non-ignored streams to the node (requires configuration using configureMix, above)
     // returns true if a mixed packet was sent to the node
@@ -53,13 +55,19 @@ private:
             const AvatarAudioStream& listenerStream, const PositionalAudioStream& streamer,
             bool throttle);
 
+    // render the HRTF sources queued by addStream into the mix, in one batch
+    void renderHRTFBatch();
+
     // mixing buffers
     float _mixSamples[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO];
     int16_t _bufferSamples[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO];
 
+    // HRTF sources of the current mix, and their input (reused between mixes)
+    std::vector<AudioHRTF::Source> _hrtfSources;
+    std::vector<int16_t> _hrtfSourceSamples;
+
     // frame state
-    ConstIter _begin;
-    ConstIter _end;
+    NodeSnapshot _nodes;
     unsigned int _frame { 0 };
     float _throttlingRatio { 0.0f };
 };
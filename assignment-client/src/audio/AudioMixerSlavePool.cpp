@@ -12,6 +12,8 @@
 #include <assert.h>
 #include <algorithm>
 
+#include <Profile.h>
+
 #include "AudioMixerSlavePool.h"
 
 void AudioMixerSlaveThread::run() {
@@ -19,9 +21,11 @@ void AudioMixerSlaveThread::run() {
         wait();
 
         // iterate over all available nodes
-        SharedNodePointer node;
-        while (try_pop(node)) {
-            (this->*_function)(node);
+        {
+            PROFILE_RANGE(mixer, "AudioMixerSlaveThread::run");
+            while (auto node = next()) {
+                (this->*_function)(*node);
+            }
         }
 
         bool stopping = _stop;
@@ -60,45 +64,47 @@ void AudioMixerSlaveThread::notify(bool stopping) {
     _pool._poolCondition.notify_one();
 }
 
-bool AudioMixerSlaveThread::try_pop(SharedNodePointer& node) {
-    return _pool._queue.try_pop(node);
+const SharedNodePointer* AudioMixerSlaveThread::next() {
+    // there are no nodes while the pool is being resized
+    if (!_pool._nodes) {
+        return nullptr;
+    }
+    size_t index = _pool._nextNode.fetch_add(1, std::memory_order_relaxed);
+    return index < _pool._nodes->size() ? &(*_pool._nodes)[index] : nullptr;
 }
 
 #ifdef AUDIO_SINGLE_THREADED
 static AudioMixerSlave slave;
 #endif
 
-void AudioMixerSlavePool::processPackets(ConstIter begin, ConstIter end) {
+void AudioMixerSlavePool::processPackets(const NodeSnapshot& nodes) {
     _function = &AudioMixerSlave::processPackets;
     _configure = [](AudioMixerSlave& slave) {};
-    run(begin, end);
+    run(nodes);
 }
 
-void AudioMixerSlavePool::mix(ConstIter begin, ConstIter end, unsigned int frame, float throttlingRatio) {
+void AudioMixerSlavePool::mix(const NodeSnapshot& nodes, unsigned int frame, float throttlingRatio) {
     _function = &AudioMixerSlave::mix;
     _configure = [&](AudioMixerSlave& slave) {
-        slave.configureMix(_begin, _end, _frame, _throttlingRatio);
+        slave.configureMix(_nodes, _frame, _throttlingRatio);
     };
     _frame = frame;
     _throttlingRatio = throttlingRatio;
 
-    run(begin, end);
+    run(nodes);
 }
 
-void AudioMixerSlavePool::run(ConstIter begin, ConstIter end) {
-    _begin = begin;
-    _end = end;
+void AudioMixerSlavePool::run(const NodeSnapshot& nodes) {
+    _nodes = nodes;
 
 #ifdef AUDIO_SINGLE_THREADED
     _configure(slave);
-    std::for_each(begin, end, [&](const SharedNodePointer& node) {
-        _function(slave, node);
+    std::for_each(_nodes->cbegin(), _nodes->cend(), [&](const SharedNodePointer& node) {
+        (slave.*_function)(node);
     });
 #else
-    // fill the queue
-    std::for_each(_begin, _end, [&](const SharedNodePointer& node) {
-        _queue.emplace(node);
-    });
+    // slaves share the snapshot and take the next node by index, no per-node queueing
+    _nextNode = 0;
 
     {
         Lock lock(_mutex);
@@ -116,8 +122,11 @@ void AudioMixerSlavePool::run(ConstIter begin, ConstIter end) {
         assert(_numStarted == _numThreads);
     }
 
-    assert(_queue.empty());
+    assert(_nextNode >= _nodes->size());
 #endif
+
+    // let go of the snapshot so removed nodes are not kept alive until the next run
+    _nodes.reset();
 }
 
 void AudioMixerSlavePool::each(std::function<void(AudioMixerSlave& slave)> functor) {
@@ -12,12 +12,11 @@
 #ifndef hifi_AudioMixerSlavePool_h
 #define hifi_AudioMixerSlavePool_h
 
+#include <atomic>
 #include <condition_variable>
 #include <mutex>
 #include <vector>
 
-#include <tbb/concurrent_queue.h>
-
 #include <QThread>
 
 #include "AudioMixerSlave.h"
@@ -26,7 +25,6 @@ class AudioMixerSlavePool;
 
 class AudioMixerSlaveThread : public QThread, public AudioMixerSlave {
     Q_OBJECT
-    using ConstIter = NodeList::const_iterator;
     using Mutex = std::mutex;
     using Lock = std::unique_lock<Mutex>;
 
@@ -40,7 +38,7 @@ private:
 
     void wait();
     void notify(bool stopping);
-    bool try_pop(SharedNodePointer& node);
+    const SharedNodePointer* next();
 
     AudioMixerSlavePool& _pool;
     void (AudioMixerSlave::*_function)(const SharedNodePointer& node) { nullptr };
@@ -50,22 +48,21 @@ private:
 // Slave pool for audio mixers
 //   AudioMixerSlavePool is not thread-safe! It should be instantiated and used from a single thread.
 class AudioMixerSlavePool {
-    using Queue = tbb::concurrent_queue<SharedNodePointer>;
     using Mutex = std::mutex;
     using Lock = std::unique_lock<Mutex>;
     using ConditionVariable = std::condition_variable;
 
 public:
-    using ConstIter = NodeList::const_iterator;
+    using NodeSnapshot = NodeList::NodeSnapshot;
 
     AudioMixerSlavePool(int numThreads = QThread::idealThreadCount()) { setNumThreads(numThreads); }
     ~AudioMixerSlavePool() { resize(0); }
 
     // process packets on slave threads
-    void processPackets(ConstIter begin, ConstIter end);
+    void processPackets(const NodeSnapshot& nodes);
 
     // mix on slave threads
-    void mix(ConstIter begin, ConstIter end, unsigned int frame, float throttlingRatio);
+    void mix(const NodeSnapshot& nodes, unsigned int frame, float throttlingRatio);
 
     // iterate over all slaves
     void each(std::function<void(AudioMixerSlave& slave)> functor);
@@ -74,14 +71,14 @@ public:
     int numThreads() { return _numThreads; }
 
 private:
-    void run(ConstIter begin, ConstIter end);
+    void run(const NodeSnapshot& nodes);
     void resize(int numThreads);
 
     std::vector<std::unique_ptr<AudioMixerSlaveThread>> _slaves;
 
     friend void AudioMixerSlaveThread::wait();
     friend void AudioMixerSlaveThread::notify(bool stopping);
-    friend bool AudioMixerSlaveThread::try_pop(SharedNodePointer& node);
+    friend const SharedNodePointer* AudioMixerSlaveThread::next();
 
     // synchronization state
     Mutex _mutex;
@@ -95,11 +92,10 @@ private:
     int _numStopped { 0 }; // guarded by _mutex
 
     // frame state
-    Queue _queue;
+    NodeSnapshot _nodes;
+    std::atomic<size_t> _nextNode { 0 }; // slaves take nodes from _nodes in order
     unsigned int _frame { 0 };
     float _throttlingRatio { 0.0f };
-    ConstIter _begin;
-    ConstIter _end;
 };
 
 #endif // hifi_AudioMixerSlavePool_h
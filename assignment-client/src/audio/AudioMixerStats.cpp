@@ -11,6 +11,8 @@
 
 #include "AudioMixerStats.h"
 
+#include <Metrics.h>
+
 void AudioMixerStats::reset() {
     sumStreams = 0;
     sumListeners = 0;
@@ -38,3 +40,42 @@ void AudioMixerStats::accumulate(const AudioMixerStats& otherStats) {
     mixTime += otherStats.mixTime;
 #endif
 }
+
+void AudioMixerStats::addToMetrics(int numFrames) const {
+    struct Metrics {
+        Metrics() {
+            auto& registry = metrics::Registry::getInstance();
+            streams = &registry.gauge("hifi_audio_mixer_streams", "Average streams mixed per frame");
+            listeners = &registry.gauge("hifi_audio_mixer_listeners", "Average listeners per frame");
+            mixes = &registry.counter("hifi_audio_mixer_mixes_total", "Streams mixed for a listener");
+            const QString RENDERS_NAME = "hifi_audio_mixer_renders_total";
+            const QString RENDERS_HELP = "Streams mixed for a listener, by how they were rendered";
+            hrtf = &registry.counter(RENDERS_NAME, RENDERS_HELP, { { "render", "hrtf" } });
+            hrtfSilent = &registry.counter(RENDERS_NAME, RENDERS_HELP, { { "render", "hrtf_silent" } });
+            hrtfThrottle = &registry.counter(RENDERS_NAME, RENDERS_HELP, { { "render", "hrtf_throttle" } });
+            manualStereo = &registry.counter(RENDERS_NAME, RENDERS_HELP, { { "render", "manual_stereo" } });
+            manualEcho = &registry.counter(RENDERS_NAME, RENDERS_HELP, { { "render", "manual_echo" } });
+        }
+
+        metrics::Gauge* streams;
+        metrics::Gauge* listeners;
+        metrics::Counter* mixes;
+        metrics::Counter* hrtf;
+        metrics::Counter* hrtfSilent;
+        metrics::Counter* hrtfThrottle;
+        metrics::Counter* manualStereo;
+        metrics::Counter* manualEcho;
+    };
+    static Metrics mixerMetrics;
+
+    if (numFrames > 0) {
+        mixerMetrics.streams->set((double)sumStreams / numFrames);
+        mixerMetrics.listeners->set((double)sumListeners / numFrames);
+    }
+    mixerMetrics.mixes->increment(totalMixes);
+    mixerMetrics.hrtf->increment(hrtfRenders);
+    mixerMetrics.hrtfSilent->increment(hrtfSilentRenders);
+    mixerMetrics.hrtfThrottle->increment(hrtfThrottleRenders);
+    mixerMetrics.manualStereo->increment(manualStereoMixes);
+    mixerMetrics.manualEcho->increment(manualEchoMixes);
+}
@@ -35,6 +35,9 @@ struct AudioMixerStats {
 
     void reset();
     void accumulate(const AudioMixerStats& otherStats);
+
+    // adds these stats, gathered over numFrames frames, to the process metrics
+    void addToMetrics(int numFrames) const;
 };
 
 #endif // hifi_AudioMixerStats_h
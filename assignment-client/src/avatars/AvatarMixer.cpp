@@ -25,7 +25,9 @@
 #include <AABox.h>
 #include <AvatarLogging.h>
 #include <LogHandler.h>
+#include <Metrics.h>
 #include <NodeList.h>
+#include <Profile.h>
 #include <udt/PacketHeaders.h>
 #include <SharedUtil.h>
 #include <UUID.h>
@@ -42,6 +44,11 @@ const unsigned int AVATAR_DATA_SEND_INTERVAL_MSECS = (1.0f / (float) AVATAR_MIXE
 AvatarMixer::AvatarMixer(ReceivedMessage& message) :
     ThreadedAssignment(message)
 {
+    _broadcastTimeMetric = &metrics::Registry::getInstance().histogram("hifi_avatar_mixer_broadcast_seconds",
+        "Time to broadcast avatar data to all nodes in a frame", metrics::Histogram::exponentialBounds(0.00025, 2.0, 8));
+    _throttlingRatioMetric = &metrics::Registry::getInstance().gauge("hifi_avatar_mixer_throttling_ratio",
+        "Ratio of avatar data throttled");
+
     // make sure we hear about node kills so we can tell the other nodes
     connect(DependencyManager::get<NodeList>().data(), &NodeList::nodeKilled, this, &AvatarMixer::nodeKilled);
 
@@ -115,19 +122,16 @@ void AvatarMixer::start() {
 
         auto frameDuration = timeFrame(frameTimestamp); // calculates last frame duration and sleeps remainder of target amount
         throttle(frameDuration, frame); // determines _throttlingRatio for upcoming mix frame
+        _throttlingRatioMetric->set(_throttlingRatio);
 
-        int lockWait, nodeTransform, functor;
+        PROFILE_RANGE(mixer, "AvatarMixer::frame");
 
         // Allow nodes to process any pending/queued packets across our worker threads
         {
+            PROFILE_RANGE(mixer, "AvatarMixer::processIncomingPackets");
             auto start = usecTimestampNow();
 
-            nodeList->nestedEach([&](NodeList::const_iterator cbegin, NodeList::const_iterator cend) {
-                auto end = usecTimestampNow();
-                _processQueuedAvatarDataPacketsLockWaitElapsedTime += (end - start);
-
-                _slavePool.processIncomingPackets(cbegin, cend);
-            }, &lockWait, &nodeTransform, &functor);
+            _slavePool.processIncomingPackets(nodeList->getNodeSnapshot());
             auto end = usecTimestampNow();
             _processQueuedAvatarDataPacketsElapsedTime += (end - start);
         }
@@ -136,31 +140,27 @@ void AvatarMixer::start() {
         // side-effects the mixer's data, which is fine because it's a very low cost operation
         {
             auto start = usecTimestampNow();
-            nodeList->nestedEach([&](NodeList::const_iterator cbegin, NodeList::const_iterator cend) {
-                std::for_each(cbegin, cend, [&](const SharedNodePointer& node) {
-                    manageDisplayName(node);
-                    ++_sumListeners;
-                });
-            }, &lockWait, &nodeTransform, &functor);
+            nodeList->eachNode([&](const SharedNodePointer& node) {
+                manageDisplayName(node);
+                ++_sumListeners;
+            });
             auto end = usecTimestampNow();
             _displayNameManagementElapsedTime += (end - start);
         }
 
         // this is where we need to put the real work...
         {
+            PROFILE_RANGE(mixer, "AvatarMixer::broadcastAvatarData");
             auto start = usecTimestampNow();
-            nodeList->nestedEach([&](NodeList::const_iterator cbegin, NodeList::const_iterator cend) {
-                auto start = usecTimestampNow();
-                _slavePool.broadcastAvatarData(cbegin, cend, _lastFrameTimestamp, _maxKbpsPerNode, _throttlingRatio);
-                auto end = usecTimestampNow();
-                _broadcastAvatarDataInner += (end - start);
-            }, &lockWait, &nodeTransform, &functor);
+            _slavePool.broadcastAvatarData(nodeList->getNodeSnapshot(), _lastFrameTimestamp, _maxKbpsPerNode, _throttlingRatio);
             auto end = usecTimestampNow();
+            _broadcastAvatarDataInner += (end - start);
             _broadcastAvatarDataElapsedTime += (end - start);
+            _broadcastTimeMetric->record((double)(end - start) / USECS_PER_SECOND);
 
-            _broadcastAvatarDataLockWait += lockWait;
-            _broadcastAvatarDataNodeTransform += nodeTransform;
-            _broadcastAvatarDataNodeFunctor += functor;
+            if (_traceBroadcastThreshold > 0 && end - start > _traceBroadcastThreshold) {
+                captureTrace(QString("avatar mixer broadcast took %1us").arg(end - start));
+            }
         }
 
         ++frame;
@@ -169,6 +169,7 @@ void AvatarMixer::start() {
 
         // play nice with qt event-looping
         {
+            PROFILE_RANGE(mixer, "AvatarMixer::processEvents");
             // since we're a while loop we need to yield to qt's event processing
             auto start = usecTimestampNow();
             QCoreApplication::processEvents();
@@ -461,16 +462,12 @@ void AvatarMixer::sendStatsPacket() {
 
     QJsonObject processQueuedAvatarDataPacketsStats;
     processQueuedAvatarDataPacketsStats["1_total"] = TIGHT_LOOP_STAT_UINT64(_processQueuedAvatarDataPacketsElapsedTime);
-    processQueuedAvatarDataPacketsStats["2_lockWait"] = TIGHT_LOOP_STAT_UINT64(_processQueuedAvatarDataPacketsLockWaitElapsedTime);
     parallelTasks["processQueuedAvatarDataPackets"] = processQueuedAvatarDataPacketsStats;
 
     QJsonObject broadcastAvatarDataStats;
 
     broadcastAvatarDataStats["1_total"] = TIGHT_LOOP_STAT_UINT64(_broadcastAvatarDataElapsedTime);
     broadcastAvatarDataStats["2_innner"] = TIGHT_LOOP_STAT_UINT64(_broadcastAvatarDataInner);
-    broadcastAvatarDataStats["3_lockWait"] = TIGHT_LOOP_STAT_UINT64(_broadcastAvatarDataLockWait);
-    broadcastAvatarDataStats["4_NodeTransform"] = TIGHT_LOOP_STAT_UINT64(_broadcastAvatarDataNodeTransform);
-    broadcastAvatarDataStats["5_Functor"] = TIGHT_LOOP_STAT_UINT64(_broadcastAvatarDataNodeFunctor);
 
     parallelTasks["broadcastAvatarData"] = broadcastAvatarDataStats;
 
@@ -521,6 +518,7 @@ void AvatarMixer::sendStatsPacket() {
 
         aggregateStats += stats;
     });
+    aggregateStats.addToMetrics();
 
     QJsonObject slavesAggregatObject;
 
@@ -561,7 +559,6 @@ void AvatarMixer::sendStatsPacket() {
     _processEventsElapsedTime = 0;
     _queueIncomingPacketElapsedTime = 0;
     _processQueuedAvatarDataPacketsElapsedTime = 0;
-    _processQueuedAvatarDataPacketsLockWaitElapsedTime = 0;
 
     QJsonObject avatarsObject;
     auto nodeList = DependencyManager::get<NodeList>();
@@ -603,9 +600,6 @@ void AvatarMixer::sendStatsPacket() {
 
     _broadcastAvatarDataElapsedTime = 0;
     _broadcastAvatarDataInner = 0;
-    _broadcastAvatarDataLockWait = 0;
-    _broadcastAvatarDataNodeTransform = 0;
-    _broadcastAvatarDataNodeFunctor = 0;
 
     _displayNameManagementElapsedTime = 0;
     _ignoreCalculationElapsedTime = 0;
@@ -721,4 +715,13 @@ void AvatarMixer::parseDomainServerSettings(const QJsonObject& domainSettings) {
     qCDebug(avatars) << "This domain requires a minimum avatar scale of" << _domainMinimumScale
                      << "and a maximum avatar scale of" << _domainMaximumScale;
 
+    const QString TRACING_SETTINGS_KEY = "tracing";
+    const QString BROADCAST_THRESHOLD_KEY = "avatar_mixer_broadcast_threshold_ms";
+    bool ok;
+    int broadcastThreshold = domainSettings[TRACING_SETTINGS_KEY].toObject()[BROADCAST_THRESHOLD_KEY].toVariant().toInt(&ok);
+    _traceBroadcastThreshold = ok ? std::max(broadcastThreshold, 0) * USECS_PER_MSEC : 0;
+    if (_traceBroadcastThreshold > 0) {
+        qCDebug(avatars) << "Capturing a trace for broadcasts slower than" << broadcastThreshold << "ms";
+    }
+
 }
@@ -16,6 +16,7 @@
 #define hifi_AvatarMixer_h
 
 #include <shared/RateCounter.h>
+#include <Metrics.h>
 #include <PortableHighResolutionClock.h>
 
 #include <ThreadedAssignment.h>
@@ -75,6 +76,10 @@ private:
 
     float _maxKbpsPerNode = 0.0f;
 
+    quint64 _traceBroadcastThreshold { 0 }; // usecs, broadcasts slower than this capture a trace, 0 never does
+    metrics::Histogram* _broadcastTimeMetric;
+    metrics::Gauge* _throttlingRatioMetric;
+
     float _domainMinimumScale { MIN_AVATAR_SCALE };
     float _domainMaximumScale { MAX_AVATAR_SCALE };
 
@@ -89,9 +94,6 @@ private:
 
     quint64 _broadcastAvatarDataElapsedTime { 0 }; // total time spent in broadcastAvatarData since last stats window
     quint64 _broadcastAvatarDataInner { 0 };
-    quint64 _broadcastAvatarDataLockWait { 0 };
-    quint64 _broadcastAvatarDataNodeTransform { 0 };
-    quint64 _broadcastAvatarDataNodeFunctor { 0 };
 
     quint64 _handleAdjustAvatarSortingElapsedTime { 0 };
     quint64 _handleViewFrustumPacketElapsedTime { 0 };
@@ -101,7 +103,6 @@ private:
     quint64 _handleRadiusIgnoreRequestPacketElapsedTime { 0 };
     quint64 _handleRequestsDomainListDataPacketElapsedTime { 0 };
     quint64 _processQueuedAvatarDataPacketsElapsedTime { 0 };
-    quint64 _processQueuedAvatarDataPacketsLockWaitElapsedTime { 0 };
 
     quint64 _processEventsElapsedTime { 0 };
     quint64 _sendStatsElapsedTime { 0 };
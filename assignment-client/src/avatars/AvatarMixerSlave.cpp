@@ -18,6 +18,7 @@
 
 #include <AvatarLogging.h>
 #include <LogHandler.h>
+#include <Metrics.h>
 #include <NetworkAccessManager.h>
 #include <NodeList.h>
 #include <Node.h>
@@ -33,16 +34,50 @@
 #include "AvatarMixerSlave.h"
 
 
-void AvatarMixerSlave::configure(ConstIter begin, ConstIter end) {
-    _begin = begin;
-    _end = end;
+void AvatarMixerSlaveStats::addToMetrics() const {
+    struct Metrics {
+        Metrics() {
+            auto& registry = metrics::Registry::getInstance();
+            nodesProcessed = &registry.counter("hifi_avatar_mixer_nodes_processed_total", "Nodes whose incoming packets were processed");
+            packetsProcessed = &registry.counter("hifi_avatar_mixer_packets_processed_total", "Avatar packets processed");
+            nodesBroadcastedTo = &registry.counter("hifi_avatar_mixer_nodes_broadcasted_to_total", "Nodes sent avatar data");
+            packetsSent = &registry.counter("hifi_avatar_mixer_sent_packets_total", "Avatar data packets sent");
+            bytesSent = &registry.counter("hifi_avatar_mixer_sent_bytes_total", "Avatar data bytes sent");
+            identityPackets = &registry.counter("hifi_avatar_mixer_identity_packets_total", "Avatar identity packets sent");
+            othersIncluded = &registry.counter("hifi_avatar_mixer_others_included_total", "Avatars included in a broadcast");
+            overBudgetAvatars = &registry.counter("hifi_avatar_mixer_over_budget_avatars_total",
+                                                  "Avatars left out of a broadcast for bandwidth");
+        }
+
+        metrics::Counter* nodesProcessed;
+        metrics::Counter* packetsProcessed;
+        metrics::Counter* nodesBroadcastedTo;
+        metrics::Counter* packetsSent;
+        metrics::Counter* bytesSent;
+        metrics::Counter* identityPackets;
+        metrics::Counter* othersIncluded;
+        metrics::Counter* overBudgetAvatars;
+    };
+    static Metrics slaveMetrics;
+
+    slaveMetrics.nodesProcessed->increment(nodesProcessed);
+    slaveMetrics.packetsProcessed->increment(packetsProcessed);
+    slaveMetrics.nodesBroadcastedTo->increment(nodesBroadcastedTo);
+    slaveMetrics.packetsSent->increment(numPacketsSent);
+    slaveMetrics.bytesSent->increment(numBytesSent);
+    slaveMetrics.identityPackets->increment(numIdentityPackets);
+    slaveMetrics.othersIncluded->increment(numOthersIncluded);
+    slaveMetrics.overBudgetAvatars->increment(overBudgetAvatars);
+}
+
+void AvatarMixerSlave::configure(const NodeSnapshot& nodes) {
+    _nodes = nodes;
 }
 
-void AvatarMixerSlave::configureBroadcast(ConstIter begin, ConstIter end, 
+void AvatarMixerSlave::configureBroadcast(const NodeSnapshot& nodes,
                                 p_high_resolution_clock::time_point lastFrameTimestamp,
                                 float maxKbpsPerNode, float throttlingRatio) {
-    _begin = begin;
-    _end = end;
+    _nodes = nodes;
     _lastFrameTimestamp = lastFrameTimestamp;
     _maxKbpsPerNode = maxKbpsPerNode;
     _throttlingRatio = throttlingRatio;
@@ -127,7 +162,8 @@ void AvatarMixerSlave::broadcastAvatarData(const SharedNodePointer& node) {
         auto maxAvatarBytesPerFrame = (_maxKbpsPerNode * BYTES_PER_KILOBIT) / AVATAR_MIXER_BROADCAST_FRAMES_PER_SECOND;
 
         // FIXME - find a way to not send the sessionID for every avatar
-        int minimumBytesPerAvatar = AvatarDataPacket::AVATAR_HAS_FLAGS_SIZE + NUM_BYTES_RFC4122_UUID;
+        int minimumBytesPerAvatar = AvatarDataPacket::AVATAR_DATA_SIZE_SIZE + AvatarDataPacket::AVATAR_HAS_FLAGS_SIZE +
+            NUM_BYTES_RFC4122_UUID;
 
         int overBudgetAvatars = 0;
 
@@ -149,6 +185,10 @@ void AvatarMixerSlave::broadcastAvatarData(const SharedNodePointer& node) {
         // setup a PacketList for the avatarPackets
         auto avatarPacketList = NLPacketList::create(PacketType::BulkAvatarData);
 
+        // each other avatar is encoded here, then copied into its segment
+        static const int MAX_ALLOWED_AVATAR_DATA = (1400 - NUM_BYTES_RFC4122_UUID);
+        unsigned char avatarDataBuffer[MAX_ALLOWED_AVATAR_DATA];
+
         // Define the minimum bubble size
         static const glm::vec3 minBubbleSize = glm::vec3(0.3f, 1.3f, 0.3f);
         // Define the scale of the box for the current node
@@ -169,7 +209,7 @@ void AvatarMixerSlave::broadcastAvatarData(const SharedNodePointer& node) {
         std::unordered_map<AvatarSharedPointer, SharedNodePointer> avatarDataToNodes;
 
         int listItem = 0;
-        std::for_each(_begin, _end, [&](const SharedNodePointer& otherNode) {
+        std::for_each(_nodes->cbegin(), _nodes->cend(), [&](const SharedNodePointer& otherNode) {
             const AvatarMixerClientData* otherNodeData = reinterpret_cast<const AvatarMixerClientData*>(otherNode->getLinkedData());
 
             // theoretically it's possible for a Node to be in the NodeList (and therefore end up here),
@@ -356,34 +396,41 @@ void AvatarMixerSlave::broadcastAvatarData(const SharedNodePointer& node) {
             bool dropFaceTracking = false;
 
             quint64 start = usecTimestampNow();
-            QByteArray bytes = otherAvatar->toByteArray(detail, lastEncodeForOther, lastSentJointsForOther, 
-                                            hasFlagsOut, dropFaceTracking, distanceAdjust, viewerPosition, &lastSentJointsForOther);
+            int numBytes = otherAvatar->toBuffer(avatarDataBuffer, MAX_ALLOWED_AVATAR_DATA, detail, lastEncodeForOther,
+                lastSentJointsForOther, hasFlagsOut, dropFaceTracking, distanceAdjust, viewerPosition, &lastSentJointsForOther);
             quint64 end = usecTimestampNow();
             _stats.toByteArrayElapsedTime += (end - start);
 
-            static const int MAX_ALLOWED_AVATAR_DATA = (1400 - NUM_BYTES_RFC4122_UUID);
-            if (bytes.size() > MAX_ALLOWED_AVATAR_DATA) {
-                qCWarning(avatars) << "otherAvatar.toByteArray() resulted in very large buffer:" << bytes.size() << "... attempt to drop facial data";
+            if (numBytes < 0) {
+                qCWarning(avatars) << "otherAvatar.toBuffer() resulted in very large buffer... attempt to drop facial data";
 
                 dropFaceTracking = true; // first try dropping the facial data
-                bytes = otherAvatar->toByteArray(detail, lastEncodeForOther, lastSentJointsForOther,
-                    hasFlagsOut, dropFaceTracking, distanceAdjust, viewerPosition, &lastSentJointsForOther);
+                numBytes = otherAvatar->toBuffer(avatarDataBuffer, MAX_ALLOWED_AVATAR_DATA, detail, lastEncodeForOther,
+                    lastSentJointsForOther, hasFlagsOut, dropFaceTracking, distanceAdjust, viewerPosition, &lastSentJointsForOther);
+
+                if (numBytes < 0 && detail == AvatarData::SendAllData) {
+                    qCWarning(avatars) << "otherAvatar.toBuffer() without facial data resulted in very large buffer... reduce to CullSmallData";
+                    numBytes = otherAvatar->toBuffer(avatarDataBuffer, MAX_ALLOWED_AVATAR_DATA, AvatarData::CullSmallData,
+                        lastEncodeForOther, lastSentJointsForOther, hasFlagsOut, dropFaceTracking, distanceAdjust, viewerPosition,
+                        &lastSentJointsForOther);
+                }
 
-                if (bytes.size() > MAX_ALLOWED_AVATAR_DATA) {
-                    qCWarning(avatars) << "otherAvatar.toByteArray() without facial data resulted in very large buffer:" << bytes.size() << "... reduce to MinimumData";
-                    bytes = otherAvatar->toByteArray(AvatarData::MinimumData, lastEncodeForOther, lastSentJointsForOther,
-                        hasFlagsOut, dropFaceTracking, distanceAdjust, viewerPosition, &lastSentJointsForOther);
+                if (numBytes < 0) {
+                    qCWarning(avatars) << "otherAvatar.toBuffer() without facial data resulted in very large buffer... reduce to MinimumData";
+                    numBytes = otherAvatar->toBuffer(avatarDataBuffer, MAX_ALLOWED_AVATAR_DATA, AvatarData::MinimumData,
+                        lastEncodeForOther, lastSentJointsForOther, hasFlagsOut, dropFaceTracking, distanceAdjust, viewerPosition,
+                        &lastSentJointsForOther);
                 }
 
-                if (bytes.size() > MAX_ALLOWED_AVATAR_DATA) {
-                    qCWarning(avatars) << "otherAvatar.toByteArray() MinimumData resulted in very large buffer:" << bytes.size() << "... FAIL!!";
+                if (numBytes < 0) {
+                    qCWarning(avatars) << "otherAvatar.toBuffer() MinimumData resulted in very large buffer... FAIL!!";
                     includeThisAvatar = false;
                 }
             }
 
             if (includeThisAvatar) {
                 numAvatarDataBytes += avatarPacketList->write(otherNode->getUUID().toRfc4122());
-                numAvatarDataBytes += avatarPacketList->write(bytes);
+                numAvatarDataBytes += avatarPacketList->write(reinterpret_cast<const char*>(avatarDataBuffer), numBytes);
 
                 if (detail != AvatarData::NoData) {
                     _stats.numOthersIncluded++;
@@ -74,14 +74,17 @@ public:
         return *this;
     }
 
+    // adds these stats to the process metrics
+    void addToMetrics() const;
+
 };
 
 class AvatarMixerSlave {
 public:
-    using ConstIter = NodeList::const_iterator;
+    using NodeSnapshot = NodeList::NodeSnapshot;
 
-    void configure(ConstIter begin, ConstIter end);
-    void configureBroadcast(ConstIter begin, ConstIter end, 
+    void configure(const NodeSnapshot& nodes);
+    void configureBroadcast(const NodeSnapshot& nodes,
                     p_high_resolution_clock::time_point lastFrameTimestamp, 
                     float maxKbpsPerNode, float throttlingRatio);
 
@@ -94,8 +97,7 @@ private:
     int sendIdentityPacket(const AvatarMixerClientData* nodeData, const SharedNodePointer& destinationNode);
 
     // frame state
-    ConstIter _begin;
-    ConstIter _end;
+    NodeSnapshot _nodes;
 
     p_high_resolution_clock::time_point _lastFrameTimestamp;
     float _maxKbpsPerNode { 0.0f };
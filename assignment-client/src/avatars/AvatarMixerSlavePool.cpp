@@ -12,6 +12,8 @@
 #include <assert.h>
 #include <algorithm>
 
+#include <Profile.h>
+
 #include "AvatarMixerSlavePool.h"
 
 void AvatarMixerSlaveThread::run() {
@@ -19,9 +21,11 @@ void AvatarMixerSlaveThread::run() {
         wait();
 
         // iterate over all available nodes
-        SharedNodePointer node;
-        while (try_pop(node)) {
-            (this->*_function)(node);
+        {
+            PROFILE_RANGE(mixer, "AvatarMixerSlaveThread::run");
+            while (auto node = next()) {
+                (this->*_function)(*node);
+            }
         }
 
         bool stopping = _stop;
@@ -59,46 +63,48 @@ void AvatarMixerSlaveThread::notify(bool stopping) {
     _pool._poolCondition.notify_one();
 }
 
-bool AvatarMixerSlaveThread::try_pop(SharedNodePointer& node) {
-    return _pool._queue.try_pop(node);
+const SharedNodePointer* AvatarMixerSlaveThread::next() {
+    // there are no nodes while the pool is being resized
+    if (!_pool._nodes) {
+        return nullptr;
+    }
+    size_t index = _pool._nextNode.fetch_add(1, std::memory_order_relaxed);
+    return index < _pool._nodes->size() ? &(*_pool._nodes)[index] : nullptr;
 }
 
 #ifdef AVATAR_SINGLE_THREADED
 static AvatarMixerSlave slave;
 #endif
 
-void AvatarMixerSlavePool::processIncomingPackets(ConstIter begin, ConstIter end) {
+void AvatarMixerSlavePool::processIncomingPackets(const NodeSnapshot& nodes) {
     _function = &AvatarMixerSlave::processIncomingPackets;
     _configure = [&](AvatarMixerSlave& slave) { 
-        slave.configure(begin, end);
+        slave.configure(nodes);
     };
-    run(begin, end);
+    run(nodes);
 }
 
-void AvatarMixerSlavePool::broadcastAvatarData(ConstIter begin, ConstIter end, 
+void AvatarMixerSlavePool::broadcastAvatarData(const NodeSnapshot& nodes,
                                      p_high_resolution_clock::time_point lastFrameTimestamp, 
                                      float maxKbpsPerNode, float throttlingRatio) {
     _function = &AvatarMixerSlave::broadcastAvatarData;
     _configure = [&](AvatarMixerSlave& slave) { 
-        slave.configureBroadcast(begin, end, lastFrameTimestamp, maxKbpsPerNode, throttlingRatio);
+        slave.configureBroadcast(nodes, lastFrameTimestamp, maxKbpsPerNode, throttlingRatio);
    };
-    run(begin, end);
+    run(nodes);
 }
 
-void AvatarMixerSlavePool::run(ConstIter begin, ConstIter end) {
-    _begin = begin;
-    _end = end;
+void AvatarMixerSlavePool::run(const NodeSnapshot& nodes) {
+    _nodes = nodes;
 
-#ifdef AUDIO_SINGLE_THREADED
+#ifdef AVATAR_SINGLE_THREADED
     _configure(slave);
-    std::for_each(begin, end, [&](const SharedNodePointer& node) {
-        _function(slave, node);
-});
-#else
-    // fill the queue
-    std::for_each(_begin, _end, [&](const SharedNodePointer& node) {
-        _queue.emplace(node);
+    std::for_each(_nodes->cbegin(), _nodes->cend(), [&](const SharedNodePointer& node) {
+        (slave.*_function)(node);
     });
+#else
+    // slaves share the snapshot and take the next node by index, no per-node queueing
+    _nextNode = 0;
 
     {
         Lock lock(_mutex);
@@ -116,8 +122,11 @@ void AvatarMixerSlavePool::run(ConstIter begin, ConstIter end) {
         assert(_numStarted == _numThreads);
     }
 
-    assert(_queue.empty());
+    assert(_nextNode >= _nodes->size());
 #endif
+
+    // let go of the snapshot so removed nodes are not kept alive until the next run
+    _nodes.reset();
 }
 
 
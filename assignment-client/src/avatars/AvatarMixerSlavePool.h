@@ -12,12 +12,11 @@
 #ifndef hifi_AvatarMixerSlavePool_h
 #define hifi_AvatarMixerSlavePool_h
 
+#include <atomic>
 #include <condition_variable>
 #include <mutex>
 #include <vector>
 
-#include <tbb/concurrent_queue.h>
-
 #include <QThread>
 
 #include <NodeList.h>
@@ -28,7 +27,6 @@ class AvatarMixerSlavePool;
 
 class AvatarMixerSlaveThread : public QThread, public AvatarMixerSlave {
     Q_OBJECT
-    using ConstIter = NodeList::const_iterator;
     using Mutex = std::mutex;
     using Lock = std::unique_lock<Mutex>;
 
@@ -42,7 +40,7 @@ private:
 
     void wait();
     void notify(bool stopping);
-    bool try_pop(SharedNodePointer& node);
+    const SharedNodePointer* next();
 
     AvatarMixerSlavePool& _pool;
     void (AvatarMixerSlave::*_function)(const SharedNodePointer& node) { nullptr };
@@ -52,20 +50,19 @@ private:
 // Slave pool for audio mixers
 //   AvatarMixerSlavePool is not thread-safe! It should be instantiated and used from a single thread.
 class AvatarMixerSlavePool {
-    using Queue = tbb::concurrent_queue<SharedNodePointer>;
     using Mutex = std::mutex;
     using Lock = std::unique_lock<Mutex>;
     using ConditionVariable = std::condition_variable;
 
 public:
-    using ConstIter = NodeList::const_iterator;
+    using NodeSnapshot = NodeList::NodeSnapshot;
 
     AvatarMixerSlavePool(int numThreads = QThread::idealThreadCount()) { setNumThreads(numThreads); }
     ~AvatarMixerSlavePool() { resize(0); }
 
     // Jobs the slave pool can do...
-    void processIncomingPackets(ConstIter begin, ConstIter end);
-    void broadcastAvatarData(ConstIter begin, ConstIter end, 
+    void processIncomingPackets(const NodeSnapshot& nodes);
+    void broadcastAvatarData(const NodeSnapshot& nodes,
                     p_high_resolution_clock::time_point lastFrameTimestamp, float maxKbpsPerNode, float throttlingRatio);
 
     // iterate over all slaves
@@ -75,14 +72,14 @@ public:
     int numThreads() { return _numThreads; }
 
 private:
-    void run(ConstIter begin, ConstIter end);
+    void run(const NodeSnapshot& nodes);
     void resize(int numThreads);
 
     std::vector<std::unique_ptr<AvatarMixerSlaveThread>> _slaves;
 
     friend void AvatarMixerSlaveThread::wait();
     friend void AvatarMixerSlaveThread::notify(bool stopping);
-    friend bool AvatarMixerSlaveThread::try_pop(SharedNodePointer& node);
+    friend const SharedNodePointer* AvatarMixerSlaveThread::next();
 
     // synchronization state
     Mutex _mutex;
@@ -96,9 +93,8 @@ private:
     int _numStopped { 0 }; // guarded by _mutex
 
     // frame state
-    Queue _queue;
-    ConstIter _begin;
-    ConstIter _end;
+    NodeSnapshot _nodes;
+    std::atomic<size_t> _nextNode { 0 }; // slaves take nodes from _nodes in order
 };
 
 #endif // hifi_AvatarMixerSlavePool_h
@@ -12,6 +12,7 @@
 #include <chrono>
 #include <thread>
 
+#include <Metrics.h>
 #include <NodeList.h>
 #include <NumericalConstants.h>
 #include <udt/PacketHeaders.h>
@@ -128,6 +129,18 @@ AtomicUIntStat OctreeSendThread::_totalPackets { 0 };
 AtomicUIntStat OctreeSendThread::_totalSpecialBytes { 0 };
 AtomicUIntStat OctreeSendThread::_totalSpecialPackets { 0 };
 
+// the process metrics for the static totals above, which are what the status page shows
+static void addSentPacketToMetrics(int bytes, int wastedBytes) {
+    static auto& registry = metrics::Registry::getInstance();
+    static auto& packets = registry.counter("hifi_octree_sent_packets_total", "Octree packets sent");
+    static auto& sentBytes = registry.counter("hifi_octree_sent_bytes_total", "Octree bytes sent");
+    static auto& sentWastedBytes = registry.counter("hifi_octree_wasted_bytes_total", "Unused bytes in sent octree packets");
+
+    packets.increment();
+    sentBytes.increment(bytes);
+    sentWastedBytes.increment(wastedBytes);
+}
+
 
 int OctreeSendThread::handlePacketSend(SharedNodePointer node, OctreeQueryNode* nodeData, int& trueBytesSent,
                                        int& truePacketsSent, bool dontSuppressDuplicate) {
@@ -169,6 +182,7 @@ int OctreeSendThread::handlePacketSend(SharedNodePointer node, OctreeQueryNode*
             _totalWastedBytes += thisWastedBytes;
             _totalBytes += statsPacket.getDataSize();
             _totalPackets++;
+            addSentPacketToMetrics(statsPacket.getDataSize(), thisWastedBytes);
 
             if (debug) {
                 NLPacket& sentPacket = nodeData->getPacket();
@@ -203,6 +217,7 @@ int OctreeSendThread::handlePacketSend(SharedNodePointer node, OctreeQueryNode*
             _totalWastedBytes += thisWastedBytes;
             _totalBytes += statsPacket.getDataSize();
             _totalPackets++;
+            addSentPacketToMetrics(statsPacket.getDataSize(), thisWastedBytes);
 
             if (debug) {
                 NLPacket& sentPacket = nodeData->getPacket();
@@ -234,6 +249,7 @@ int OctreeSendThread::handlePacketSend(SharedNodePointer node, OctreeQueryNode*
             _totalWastedBytes += thisWastedBytes;
             _totalBytes += nodeData->getPacket().getDataSize();
             _totalPackets++;
+            addSentPacketToMetrics(nodeData->getPacket().getDataSize(), thisWastedBytes);
 
             if (debug) {
                 NLPacket& sentPacket = nodeData->getPacket();
@@ -266,6 +282,7 @@ int OctreeSendThread::handlePacketSend(SharedNodePointer node, OctreeQueryNode*
             _totalWastedBytes += thisWastedBytes;
             _totalBytes += packetSizeWithHeader;
             _totalPackets++;
+            addSentPacketToMetrics(packetSizeWithHeader, thisWastedBytes);
 
             if (debug) {
                 NLPacket& sentPacket = nodeData->getPacket();
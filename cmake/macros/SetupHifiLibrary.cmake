@@ -35,6 +35,17 @@ macro(SETUP_HIFI_LIBRARY)
     endif()
   endforeach()
 
+  # add compiler flags to AVX512 source files
+  file(GLOB_RECURSE AVX512_SRCS "src/avx512/*.cpp" "src/avx512/*.c")
+  foreach(SRC ${AVX512_SRCS})
+    if (WIN32)
+      # MSVC accepts AVX512 intrinsics without /arch:AVX512, which older toolsets lack
+      set_source_files_properties(${SRC} PROPERTIES COMPILE_FLAGS /arch:AVX2)
+    elseif (APPLE OR UNIX)
+      set_source_files_properties(${SRC} PROPERTIES COMPILE_FLAGS "-mavx512f -mfma")
+    endif()
+  endforeach()
+
   setup_memory_debugger()
 
   # create a library and set the property so it can be referenced later
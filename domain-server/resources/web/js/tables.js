@@ -58,6 +58,17 @@ $(document).ready(function(){
     });
   });
   
+  // ask the node for its rolling trace, the download link shows up once it arrives
+  $(document.body).on('click', '.glyphicon-record', function(){
+    $.ajax({
+        url: "/nodes/" + $(this).data('uuid') + "/trace",
+        type: 'POST',
+        success: function(result) {
+          console.log("Successful request for a node trace.");
+        }
+    });
+  });
+  
   $(document.body).on('click', '#kill-all-btn', function() {
     var confirmed_kill = confirm("Are you sure?");
     
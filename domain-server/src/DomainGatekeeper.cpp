@@ -17,16 +17,20 @@
 
 #include <AccountManager.h>
 #include <Assignment.h>
+#include <Metrics.h>
 
 #include "DomainServer.h"
 #include "DomainServerNodeData.h"
 
 using SharedAssignmentPointer = QSharedPointer<Assignment>;
 
+const int ADMIT_INTERVAL_MSECS = 50;
+
 DomainGatekeeper::DomainGatekeeper(DomainServer* server) :
     _server(server)
 {
-
+    _admitTimer.setInterval(ADMIT_INTERVAL_MSECS);
+    connect(&_admitTimer, &QTimer::timeout, this, &DomainGatekeeper::admitQueuedConnectRequests);
 }
 
 void DomainGatekeeper::addPendingAssignedNode(const QUuid& nodeUUID, const QUuid& assignmentUUID,
@@ -101,13 +105,19 @@ void DomainGatekeeper::processConnectRequestPacket(QSharedPointer<ReceivedMessag
             }
         }
 
-        node = processAgentConnectRequest(nodeConnection, username, usernameSignature);
+        // agents wait their turn, so that a burst of them connecting is spread out
+        queueAgentConnectRequest(nodeConnection, username, usernameSignature);
+        return;
     }
 
+    completeConnectRequest(node, nodeConnection);
+}
+
+void DomainGatekeeper::completeConnectRequest(const SharedNodePointer& node, const NodeConnectionData& nodeConnection) {
     if (node) {
         // set the sending sock addr and node interest set on this node
         DomainServerNodeData* nodeData = static_cast<DomainServerNodeData*>(node->getLinkedData());
-        nodeData->setSendingSockAddr(message->getSenderSockAddr());
+        nodeData->setSendingSockAddr(nodeConnection.senderSockAddr);
 
         // guard against patched agents asking to hear about other agents
         auto safeInterestSet = nodeConnection.interestList.toSet();
@@ -119,19 +129,158 @@ void DomainGatekeeper::processConnectRequestPacket(QSharedPointer<ReceivedMessag
         nodeData->setPlaceName(nodeConnection.placeName);
 
         qDebug() << "Allowed connection from node" << uuidStringWithoutCurlyBraces(node->getUUID())
-            << "on" << message->getSenderSockAddr() << "with MAC" << nodeConnection.hardwareAddress
+            << "on" << nodeConnection.senderSockAddr << "with MAC" << nodeConnection.hardwareAddress
             << "and machine fingerprint" << nodeConnection.machineFingerprint;
 
         // signal that we just connected a node so the DomainServer can get it a list
         // and broadcast its presence right away
         emit connectedNode(node);
     } else {
-        qDebug() << "Refusing connection from node at" << message->getSenderSockAddr()
+        qDebug() << "Refusing connection from node at" << nodeConnection.senderSockAddr
             << "with hardware address" << nodeConnection.hardwareAddress
             << "and machine fingerprint" << nodeConnection.machineFingerprint;
     }
 }
 
+const QString CONNECT_ADMIT_RATE = "security.connect_admit_rate";
+
+// the client resends its connect request every second until it is in, anything older has gone away
+const quint64 STALE_CONNECT_REQUEST_USECS = 5 * USECS_PER_SECOND;
+const int MAX_QUEUED_CONNECT_REQUESTS = 2000;
+const quint64 RECONNECT_PRIORITY_USECS = 2 * 60 * USECS_PER_SECOND;
+
+static metrics::Gauge& connectQueueDepthMetric() {
+    static auto& metric = metrics::Registry::getInstance().gauge("hifi_domain_server_connect_queue_depth",
+        "Agent connect requests waiting to be admitted");
+    return metric;
+}
+
+float DomainGatekeeper::getConnectAdmitRate() {
+    // changing it restarts the domain-server, so it is only looked up once
+    if (_connectAdmitRate < 0.0f) {
+        _connectAdmitRate = std::max(_server->_settingsManager.valueOrDefaultValueForKeyPath(CONNECT_ADMIT_RATE).toFloat(), 0.0f);
+    }
+    return _connectAdmitRate;
+}
+
+void DomainGatekeeper::queueAgentConnectRequest(const NodeConnectionData& nodeConnection, const QString& username,
+                                                const QByteArray& usernameSignature) {
+    static auto& droppedMetric = metrics::Registry::getInstance().counter("hifi_domain_server_connect_requests_dropped_total",
+        "Agent connect requests dropped because the admission queue was full");
+
+    quint64 now = usecTimestampNow();
+    ConnectRequestKey key { nodeConnection.senderSockAddr, nodeConnection.localSockAddr };
+
+    auto it = _queuedConnectRequests.find(key);
+    if (it != _queuedConnectRequests.end()) {
+        // a retry keeps its place in line, but the latest request may have a username signature
+        it->nodeConnection = nodeConnection;
+        it->username = username;
+        it->usernameSignature = usernameSignature;
+        it->lastRequestUsecs = now;
+        return;
+    }
+
+    if (_queuedConnectRequests.size() >= MAX_QUEUED_CONNECT_REQUESTS) {
+        // the agent will ask again in a second
+        droppedMetric.increment();
+        return;
+    }
+
+    _queuedConnectRequests.insert(key, { nodeConnection, username, usernameSignature, now, now });
+    if (isReconnect(nodeConnection, username)) {
+        _reconnectQueue.push_back(key);
+    } else {
+        _connectQueue.push_back(key);
+    }
+    connectQueueDepthMetric().set(_queuedConnectRequests.size());
+
+    if (getConnectAdmitRate() <= 0.0f) {
+        // no limit, let them in right away
+        admitQueuedConnectRequests();
+    } else if (!_admitTimer.isActive()) {
+        _admitTimer.start();
+    }
+}
+
+bool DomainGatekeeper::isReconnect(const NodeConnectionData& nodeConnection, const QString& username) {
+    // part way through logging in, we already sent them a connection token
+    if (!username.isEmpty() && _connectionTokenHash.contains(username.toLower())) {
+        return true;
+    }
+
+    quint64 now = usecTimestampNow();
+    for (const QString& identity : { nodeConnection.hardwareAddress, nodeConnection.machineFingerprint.toString() }) {
+        auto it = _recentlyDisconnected.find(identity);
+        if (it != _recentlyDisconnected.end() && now - it.value() < RECONNECT_PRIORITY_USECS) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void DomainGatekeeper::nodeDisconnected(const SharedNodePointer& node) {
+    DomainServerNodeData* nodeData = static_cast<DomainServerNodeData*>(node->getLinkedData());
+    if (node->getType() != NodeType::Agent || !nodeData) {
+        return;
+    }
+
+    quint64 now = usecTimestampNow();
+    if (!nodeData->getHardwareAddress().isEmpty()) {
+        _recentlyDisconnected[nodeData->getHardwareAddress()] = now;
+    }
+    if (!nodeData->getMachineFingerprint().isNull()) {
+        _recentlyDisconnected[nodeData->getMachineFingerprint().toString()] = now;
+    }
+
+    // forget anyone who has been gone too long to count as reconnecting
+    for (auto it = _recentlyDisconnected.begin(); it != _recentlyDisconnected.end();) {
+        if (now - it.value() >= RECONNECT_PRIORITY_USECS) {
+            it = _recentlyDisconnected.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void DomainGatekeeper::admitQueuedConnectRequests() {
+    static auto& admitTimeMetric = metrics::Registry::getInstance().histogram("hifi_domain_server_connect_admit_seconds",
+        "Time from an agent's first connect request to its admission",
+        metrics::Histogram::exponentialBounds(0.01, 2.0, 12));
+
+    float admitRate = getConnectAdmitRate();
+    bool isLimited = admitRate > 0.0f;
+    if (isLimited) {
+        // don't let an idle stretch build up a burst of admissions
+        float admitsPerInterval = admitRate * ADMIT_INTERVAL_MSECS / MSECS_PER_SECOND;
+        _admitAllowance = std::min(_admitAllowance + admitsPerInterval, std::max(admitsPerInterval, 1.0f));
+    }
+
+    quint64 now = usecTimestampNow();
+    while ((!isLimited || _admitAllowance >= 1.0f) && !(_reconnectQueue.empty() && _connectQueue.empty())) {
+        auto& queue = _reconnectQueue.empty() ? _connectQueue : _reconnectQueue;
+        ConnectRequestKey key = queue.front();
+        queue.pop_front();
+
+        QueuedConnectRequest request = _queuedConnectRequests.take(key);
+        if (now - request.lastRequestUsecs > STALE_CONNECT_REQUEST_USECS) {
+            continue;
+        }
+
+        admitTimeMetric.record((double)(now - request.firstRequestUsecs) / USECS_PER_SECOND);
+        completeConnectRequest(processAgentConnectRequest(request.nodeConnection, request.username, request.usernameSignature),
+                               request.nodeConnection);
+        _admitAllowance -= 1.0f;
+    }
+
+    if (_reconnectQueue.empty() && _connectQueue.empty()) {
+        _admitTimer.stop();
+        _admitAllowance = 0.0f;
+    }
+
+    connectQueueDepthMetric().set(_queuedConnectRequests.size());
+}
+
 NodePermissions DomainGatekeeper::setPermissionsForUser(bool isLocalUser, QString verifiedUsername, const QHostAddress& senderAddress,
                                                         const QString& hardwareAddress, const QUuid& machineFingerprint) {
     NodePermissions userPerms;
@@ -254,6 +403,8 @@ void DomainGatekeeper::updateNodePermissions() {
 
     QList<SharedNodePointer> nodesToKill;
 
+    _permissionsCache.clear();
+
     auto limitedNodeList = DependencyManager::get<LimitedNodeList>();
     limitedNodeList->eachNode([this, limitedNodeList, &nodesToKill](const SharedNodePointer& node){
         // the id and the username in NodePermissions will often be the same, but id is set before
@@ -292,6 +443,7 @@ void DomainGatekeeper::updateNodePermissions() {
         }
 
         node->setPermissions(userPerms);
+        _server->recordDomainListChange(node->getUUID());
 
         if (!userPerms.can(NodePermissions::Permission::canConnectToDomain)) {
             qDebug() << "node" << node->getUUID() << "no longer has permission to connect.";
@@ -346,6 +498,9 @@ SharedNodePointer DomainGatekeeper::processAssignmentConnectRequest(const NodeCo
 
     nodeData->setWasAssigned(true);
 
+    // only this assignment client knows the UUID it connected with, so it signs what it sends us with it
+    newNode->setConnectionSecret(nodeConnection.connectUUID);
+
     // cleanup the PendingAssignedNodeData for this assignment now that it's connecting
     _pendingAssignedNodes.erase(it);
 
@@ -405,8 +560,17 @@ SharedNodePointer DomainGatekeeper::processAgentConnectRequest(const NodeConnect
         }
     }
 
-    userPerms = setPermissionsForUser(isLocalUser, verifiedUsername, nodeConnection.senderSockAddr.getAddress(),
-                                      nodeConnection.hardwareAddress, nodeConnection.machineFingerprint);
+    // agents retrying during a burst of connections would otherwise redo every settings lookup each time
+    QString permissionsKey = QString("%1|%2|%3|%4|%5").arg(isLocalUser).arg(verifiedUsername)
+        .arg(senderHostAddress.toString()).arg(nodeConnection.hardwareAddress).arg(nodeConnection.machineFingerprint.toString());
+    auto cachedPermissions = _permissionsCache.find(permissionsKey);
+    if (cachedPermissions != _permissionsCache.end()) {
+        userPerms = cachedPermissions.value();
+    } else {
+        userPerms = setPermissionsForUser(isLocalUser, verifiedUsername, nodeConnection.senderSockAddr.getAddress(),
+                                          nodeConnection.hardwareAddress, nodeConnection.machineFingerprint);
+        _permissionsCache.insert(permissionsKey, userPerms);
+    }
 
     if (!userPerms.can(NodePermissions::Permission::canConnectToDomain)) {
         sendConnectionDeniedPacket("You lack the required permissions to connect to this domain.",
@@ -518,6 +682,7 @@ bool DomainGatekeeper::verifyUserSignature(const QString& username,
     QByteArray publicKeyArray = _userPublicKeys.value(lowerUsername);
 
     const QUuid& connectionToken = _connectionTokenHash.value(lowerUsername);
+    bool isVerificationFailure = false;
 
     if (!publicKeyArray.isEmpty() && !connectionToken.isNull()) {
         // if we do have a public key for the user, check for a signature match
@@ -545,6 +710,7 @@ bool DomainGatekeeper::verifyUserSignature(const QString& username,
                 // free up the public key and remove connection token before we return
                 RSA_free(rsaPublicKey);
                 _connectionTokenHash.remove(username);
+                _publicKeysRefreshedOnFailure.remove(lowerUsername);
 
                 return true;
 
@@ -557,6 +723,7 @@ bool DomainGatekeeper::verifyUserSignature(const QString& username,
 
                 // free up the public key, we don't need it anymore
                 RSA_free(rsaPublicKey);
+                isVerificationFailure = true;
             }
 
         } else {
@@ -567,6 +734,7 @@ bool DomainGatekeeper::verifyUserSignature(const QString& username,
                 sendConnectionDeniedPacket("Couldn't convert data to RSA key.", senderSockAddr,
                     DomainHandler::ConnectionRefusedReason::LoginError);
             }
+            isVerificationFailure = true;
         }
     } else {
         if (!senderSockAddr.isNull()) {
@@ -574,7 +742,7 @@ bool DomainGatekeeper::verifyUserSignature(const QString& username,
         }
     }
 
-    requestUserPublicKey(username); // no joy.  maybe next time?
+    requestUserPublicKey(username, isVerificationFailure); // no joy.  maybe next time?
     return false;
 }
 
@@ -611,7 +779,7 @@ void DomainGatekeeper::preloadAllowedUserPublicKeys() {
     }
 }
 
-void DomainGatekeeper::requestUserPublicKey(const QString& username) {
+void DomainGatekeeper::requestUserPublicKey(const QString& username, bool isVerificationFailure) {
     // don't request public keys for the standard psuedo-account-names
     if (NodePermissions::standardNames.contains(username, Qt::CaseInsensitive)) {
         return;
@@ -622,6 +790,21 @@ void DomainGatekeeper::requestUserPublicKey(const QString& username) {
         // public-key request for this username is already flight, not rerequesting
         return;
     }
+
+    // a user retrying a connection asks for this on every attempt, a key we just got is recent enough. Unless it
+    // just failed to verify their signature: then it may have been rotated, so it's refreshed right away, but only
+    // once until it's next refreshed on time, so failing over and over doesn't ask over and over.
+    const quint64 MIN_PUBLIC_KEY_REFRESH_USECS = 10 * USECS_PER_SECOND;
+    if (_userPublicKeys.contains(lowerUsername)
+        && usecTimestampNow() - _userPublicKeyTimes.value(lowerUsername) < MIN_PUBLIC_KEY_REFRESH_USECS) {
+        if (!isVerificationFailure || _publicKeysRefreshedOnFailure.contains(lowerUsername)) {
+            return;
+        }
+        _publicKeysRefreshedOnFailure += lowerUsername;
+    } else {
+        _publicKeysRefreshedOnFailure.remove(lowerUsername);
+    }
+
     _inFlightPublicKeyRequests += lowerUsername;
 
     // even if we have a public key for them right now, request a new one in case it has just changed
@@ -663,6 +846,7 @@ void DomainGatekeeper::publicKeyJSONCallback(QNetworkReply& requestReply) {
 
         _userPublicKeys[username.toLower()] =
             QByteArray::fromBase64(jsonObject[JSON_DATA_KEY].toObject()[JSON_PUBLIC_KEY_KEY].toString().toUtf8());
+        _userPublicKeyTimes[username.toLower()] = usecTimestampNow();
     }
 
     _inFlightPublicKeyRequests.remove(username);
@@ -901,6 +1085,7 @@ void DomainGatekeeper::getIsGroupMemberJSONCallback(QNetworkReply& requestReply)
             QUuid rankID = QUuid(rank["id"].toString());
             _server->_settingsManager.recordGroupMembership(username, groupID, rankID);
         }
+        _permissionsCache.clear();
     } else {
         qDebug() << "getIsGroupMember api call returned:" << QJsonDocument(jsonObject).toJson(QJsonDocument::Compact);
     }
@@ -950,6 +1135,7 @@ void DomainGatekeeper::getDomainOwnerFriendsListJSONCallback(QNetworkReply& requ
         for (int i = 0; i < friends.size(); i++) {
             _domainOwnerFriends += friends.at(i).toString();
         }
+        _permissionsCache.clear();
     } else {
         qDebug() << "getDomainOwnerFriendsList api call returned:" << QJsonDocument(jsonObject).toJson(QJsonDocument::Compact);
     }
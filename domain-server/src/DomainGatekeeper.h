@@ -14,9 +14,11 @@
 #ifndef hifi_DomainGatekeeper_h
 #define hifi_DomainGatekeeper_h
 
+#include <deque>
 #include <unordered_map>
 
 #include <QtCore/QObject>
+#include <QtCore/QTimer>
 #include <QtNetwork/QNetworkReply>
 
 #include <DomainHandler.h>
@@ -43,6 +45,9 @@ public:
     
     void removeICEPeer(const QUuid& peerUUID) { _icePeers.remove(peerUUID); }
 
+    // remembers who an agent was, so that they are let in ahead of new agents if they come right back
+    void nodeDisconnected(const SharedNodePointer& node);
+
     static void sendProtocolMismatchConnectionDenial(const HifiSockAddr& senderSockAddr);
 public slots:
     void processConnectRequestPacket(QSharedPointer<ReceivedMessage> message);
@@ -70,7 +75,14 @@ public slots:
 
 private slots:
     void handlePeerPingTimeout();
+    void admitQueuedConnectRequests();
 private:
+    void queueAgentConnectRequest(const NodeConnectionData& nodeConnection, const QString& username,
+                                  const QByteArray& usernameSignature);
+    void completeConnectRequest(const SharedNodePointer& node, const NodeConnectionData& nodeConnection);
+    bool isReconnect(const NodeConnectionData& nodeConnection, const QString& username);
+    float getConnectAdmitRate();
+
     SharedNodePointer processAssignmentConnectRequest(const NodeConnectionData& nodeConnection,
                                                       const PendingAssignedNodeData& pendingAssignment);
     SharedNodePointer processAgentConnectRequest(const NodeConnectionData& nodeConnection,
@@ -93,7 +105,7 @@ private:
     
     void pingPunchForConnectingPeer(const SharedNetworkPeer& peer);
     
-    void requestUserPublicKey(const QString& username);
+    void requestUserPublicKey(const QString& username, bool isVerificationFailure = false);
     
     DomainServer* _server;
     
@@ -106,6 +118,30 @@ private:
     QSet<QString> _inFlightPublicKeyRequests; // keep track of which we've already asked for
     QSet<QString> _domainOwnerFriends; // keep track of friends of the domain owner
     QSet<QString> _inFlightGroupMembershipsRequests; // keep track of which we've already asked for
+    QHash<QString, quint64> _userPublicKeyTimes; // when we last got each public key
+    QSet<QString> _publicKeysRefreshedOnFailure; // refreshed early since they were last refreshed on time
+
+    // Agent connect requests wait here to be let in at the admit rate, so that a burst of connections
+    // doesn't stall the domain-server. Agents that just left and agents part way through logging in
+    // go ahead of new ones. A request is keyed by its sender and local sockets, retries keep their place.
+    struct QueuedConnectRequest {
+        NodeConnectionData nodeConnection;
+        QString username;
+        QByteArray usernameSignature;
+        quint64 firstRequestUsecs;
+        quint64 lastRequestUsecs;
+    };
+    using ConnectRequestKey = QPair<HifiSockAddr, HifiSockAddr>;
+    QHash<ConnectRequestKey, QueuedConnectRequest> _queuedConnectRequests;
+    std::deque<ConnectRequestKey> _reconnectQueue;
+    std::deque<ConnectRequestKey> _connectQueue;
+    QTimer _admitTimer;
+    float _admitAllowance { 0.0f };
+    float _connectAdmitRate { -1.0f }; // per second, 0 for no limit
+    QHash<QString, quint64> _recentlyDisconnected; // hardware addresses and machine fingerprints
+
+    // permissions only depend on settings and what we know of users, until either changes
+    QHash<QString, NodePermissions> _permissionsCache;
 
     NodePermissions setPermissionsForUser(bool isLocalUser, QString verifiedUsername, const QHostAddress& senderAddress, 
                                           const QString& hardwareAddress, const QUuid& machineFingerprint);
@@ -31,6 +31,7 @@
 #include <HifiConfigVariantMap.h>
 #include <HTTPConnection.h>
 #include <LogUtils.h>
+#include <Metrics.h>
 #include <NetworkingConstants.h>
 #include <udt/PacketHeaders.h>
 #include <SettingHandle.h>
@@ -77,6 +78,7 @@ DomainServer::DomainServer(int argc, char* argv[]) :
 
     DependencyManager::set<tracing::Tracer>();
     DependencyManager::set<StatTracker>();
+    metrics::Registry::getInstance().setCommonLabels({ { "type", "domain-server" } });
 
     LogUtils::init();
     Setting::init();
@@ -527,6 +529,7 @@ void DomainServer::setupNodeListAndAssignments() {
     packetReceiver.registerListener(PacketType::DomainListRequest, this, "processListRequestPacket");
     packetReceiver.registerListener(PacketType::DomainServerPathQuery, this, "processPathQueryPacket");
     packetReceiver.registerListener(PacketType::NodeJsonStats, this, "processNodeJSONStatsPacket");
+    packetReceiver.registerListener(PacketType::TraceDump, this, "processTraceDumpPacket");
     packetReceiver.registerListener(PacketType::DomainDisconnectRequest, this, "processNodeDisconnectRequestPacket");
 
     // NodeList won't be available to the settings manager when it is created, so call registerListener here
@@ -834,6 +837,10 @@ void DomainServer::processListRequestPacket(QSharedPointer<ReceivedMessage> mess
     QDataStream packetStream(message->getMessage());
     NodeConnectionData nodeRequestData = NodeConnectionData::fromDataStream(packetStream, message->getSenderSockAddr(), false);
 
+    // other nodes need to hear about changed sockets or interests in their next domain list
+    bool hasChanged = sendingNode->getPublicSocket() != nodeRequestData.publicSockAddr
+        || sendingNode->getLocalSocket() != nodeRequestData.localSockAddr;
+
     // update this node's sockets in case they have changed
     sendingNode->setPublicSocket(nodeRequestData.publicSockAddr);
     sendingNode->setLocalSocket(nodeRequestData.localSockAddr);
@@ -847,12 +854,17 @@ void DomainServer::processListRequestPacket(QSharedPointer<ReceivedMessage> mess
         safeInterestSet.remove(NodeType::Agent);
     }
 
+    hasChanged = hasChanged || nodeData->getNodeInterestSet() != safeInterestSet;
     nodeData->setNodeInterestSet(safeInterestSet);
 
     // update the connecting hostname in case it has changed
     nodeData->setPlaceName(nodeRequestData.placeName);
 
-    sendDomainListToNode(sendingNode, message->getSenderSockAddr());
+    if (hasChanged) {
+        recordDomainListChange(sendingNode->getUUID());
+    }
+
+    sendDomainListToNode(sendingNode, message->getSenderSockAddr(), nodeRequestData.domainListVersion);
 }
 
 bool DomainServer::isInInterestSet(const SharedNodePointer& nodeA, const SharedNodePointer& nodeB) {
@@ -950,6 +962,8 @@ QUrl DomainServer::oauthAuthorizationURL(const QUuid& stateUUID) {
 void DomainServer::handleConnectedNode(SharedNodePointer newNode) {
     DomainServerNodeData* nodeData = static_cast<DomainServerNodeData*>(newNode->getLinkedData());
 
+    recordDomainListChange(newNode->getUUID());
+
     // reply back to the user with a PacketType::DomainList
     sendDomainListToNode(newNode, nodeData->getSendingSockAddr());
 
@@ -962,23 +976,12 @@ void DomainServer::handleConnectedNode(SharedNodePointer newNode) {
     broadcastNewNode(newNode);
 }
 
-void DomainServer::sendDomainListToNode(const SharedNodePointer& node, const HifiSockAddr &senderSockAddr) {
-    const int NUM_DOMAIN_LIST_EXTENDED_HEADER_BYTES = NUM_BYTES_RFC4122_UUID + NUM_BYTES_RFC4122_UUID + 2;
-
-    // setup the extended header for the domain list packets
-    // this data is at the beginning of each of the domain list packets
-    QByteArray extendedHeader(NUM_DOMAIN_LIST_EXTENDED_HEADER_BYTES, 0);
-    QDataStream extendedHeaderStream(&extendedHeader, QIODevice::WriteOnly);
-
+void DomainServer::sendDomainListToNode(const SharedNodePointer& node, const HifiSockAddr &senderSockAddr,
+                                        quint32 knownListVersion) {
     auto limitedNodeList = DependencyManager::get<LimitedNodeList>();
 
-    extendedHeaderStream << limitedNodeList->getSessionUUID();
-    extendedHeaderStream << node->getUUID();
-    extendedHeaderStream << node->getPermissions();
-
-    auto domainListPackets = NLPacketList::create(PacketType::DomainList, extendedHeader);
-
-    // always send the node their own UUID back
+    // the list is reliable so that a node never applies part of a delta and moves on to the next version
+    auto domainListPackets = NLPacketList::create(PacketType::DomainList, QByteArray(), true, true);
     QDataStream domainListStream(domainListPackets.get());
 
     DomainServerNodeData* nodeData = static_cast<DomainServerNodeData*>(node->getLinkedData());
@@ -986,36 +989,90 @@ void DomainServer::sendDomainListToNode(const SharedNodePointer& node, const Hif
     // store the nodeInterestSet on this DomainServerNodeData, in case it has changed
     auto& nodeInterestSet = nodeData->getNodeInterestSet();
 
-    if (nodeInterestSet.size() > 0) {
+    // a delta is enough if we still have every change since the node's version, and the node
+    // would still be sent the same nodes as before
+    bool hasFilterChanged = nodeData->setDomainListFilter(nodeInterestSet, node->getCanRez() || node->getCanRezTmp());
+    bool isDelta = knownListVersion > 0 && knownListVersion <= _domainListVersion && !hasFilterChanged
+        && knownListVersion + _domainListChanges.size() >= _domainListVersion;
+
+    domainListStream << limitedNodeList->getSessionUUID();
+    domainListStream << node->getUUID();
+    domainListStream << node->getPermissions();
+    domainListStream << _domainListVersion << isDelta;
+
+    // the nodes to send, along with any removed nodes for a delta
+    std::vector<SharedNodePointer> changedNodes;
+    QList<QUuid> removedNodes;
+
+    if (isDelta) {
+        auto firstChange = std::upper_bound(_domainListChanges.begin(), _domainListChanges.end(), knownListVersion,
+            [](quint32 version, const DomainListChange& change) {
+                return version < change.version;
+            });
 
-        // DTLSServerSession* dtlsSession = _isUsingDTLS ? _dtlsSessions[senderSockAddr] : NULL;
-        if (nodeData->isAuthenticated()) {
-            // if this authenticated node has any interest types, send back those nodes as well
-            limitedNodeList->eachNode([&](const SharedNodePointer& otherNode) {
-                if (otherNode->getUUID() != node->getUUID() && isInInterestSet(node, otherNode)) {
-                    // since we're about to add a node to the packet we start a segment
-                    domainListPackets->startSegment();
+        // only the latest change to each node counts
+        QSet<QUuid> seenNodes;
+        for (auto it = _domainListChanges.rbegin(); it != std::deque<DomainListChange>::reverse_iterator(firstChange); ++it) {
+            if (it->nodeID == node->getUUID() || seenNodes.contains(it->nodeID)) {
+                continue;
+            }
+            seenNodes.insert(it->nodeID);
 
-                    // don't send avatar nodes to other avatars, that will come from avatar mixer
-                    domainListStream << *otherNode.data();
+            if (it->isRemoval) {
+                removedNodes << it->nodeID;
+            } else if (auto changedNode = limitedNodeList->nodeWithUUID(it->nodeID)) {
+                changedNodes.push_back(changedNode);
+            }
+        }
+        domainListStream << removedNodes;
+    } else if (nodeInterestSet.size() > 0) {
+        limitedNodeList->eachNode([&](const SharedNodePointer& otherNode) {
+            if (otherNode->getUUID() != node->getUUID()) {
+                changedNodes.push_back(otherNode);
+            }
+        });
+    }
 
-                    // pack the secret that these two nodes will use to communicate with each other
-                    domainListStream << connectionSecretForNodes(node, otherNode);
+    // DTLSServerSession* dtlsSession = _isUsingDTLS ? _dtlsSessions[senderSockAddr] : NULL;
+    if (nodeData->isAuthenticated()) {
+        // if this authenticated node has any interest types, send back those nodes as well
+        for (const auto& otherNode : changedNodes) {
+            if (isInInterestSet(node, otherNode)) {
+                // since we're about to add a node to the packet we start a segment
+                domainListPackets->startSegment();
 
-                    // we've added the node we wanted so end the segment now
-                    domainListPackets->endSegment();
-                }
-            });
+                // don't send avatar nodes to other avatars, that will come from avatar mixer
+                domainListStream << *otherNode.data();
+
+                // pack the secret that these two nodes will use to communicate with each other
+                domainListStream << connectionSecretForNodes(node, otherNode);
+
+                // we've added the node we wanted so end the segment now
+                domainListPackets->endSegment();
+            }
         }
     }
 
-    // send an empty list to the node, in case there were no other nodes
-    domainListPackets->closeCurrentPacket(true);
+    static auto& fullListsMetric = metrics::Registry::getInstance().counter("hifi_domain_server_domain_lists_total",
+        "Domain lists sent to nodes", { { "kind", "full" } });
+    static auto& deltaListsMetric = metrics::Registry::getInstance().counter("hifi_domain_server_domain_lists_total",
+        "Domain lists sent to nodes", { { "kind", "delta" } });
+    (isDelta ? deltaListsMetric : fullListsMetric).increment();
 
     // write the PacketList to this node
     limitedNodeList->sendPacketList(std::move(domainListPackets), *node);
 }
 
+void DomainServer::recordDomainListChange(const QUuid& nodeID, bool isRemoval) {
+    // enough history for every node checking in once a second under heavy churn, older nodes get a full list
+    const size_t MAX_DOMAIN_LIST_CHANGES = 4096;
+
+    _domainListChanges.push_back({ ++_domainListVersion, nodeID, isRemoval });
+    if (_domainListChanges.size() > MAX_DOMAIN_LIST_CHANGES) {
+        _domainListChanges.pop_front();
+    }
+}
+
 QUuid DomainServer::connectionSecretForNodes(const SharedNodePointer& nodeA, const SharedNodePointer& nodeB) {
     DomainServerNodeData* nodeAData = static_cast<DomainServerNodeData*>(nodeA->getLinkedData());
     DomainServerNodeData* nodeBData = static_cast<DomainServerNodeData*>(nodeB->getLinkedData());
@@ -1549,6 +1606,64 @@ void DomainServer::processNodeJSONStatsPacket(QSharedPointer<ReceivedMessage> pa
     }
 }
 
+// a gzipped ten second trace of a busy mixer is a few MB
+const int MAX_TRACE_DUMP_BYTES = 16 * 1024 * 1024;
+
+bool DomainServer::isAutomaticTraceExpected(const SharedNodePointer& node) {
+    QString thresholdKeyPath;
+    switch (node->getType()) {
+        case NodeType::AudioMixer:
+            thresholdKeyPath = "tracing.audio_mixer_frame_threshold_ms";
+            break;
+        case NodeType::AvatarMixer:
+            thresholdKeyPath = "tracing.avatar_mixer_broadcast_threshold_ms";
+            break;
+        default:
+            // nothing else captures a trace by itself
+            return false;
+    }
+    if (_settingsManager.valueOrDefaultValueForKeyPath(thresholdKeyPath).toInt() <= 0) {
+        return false;
+    }
+
+    // the node captures at most once a window, give or take how long the last one took to get here
+    const QString WINDOW_SECONDS_KEY_PATH = "tracing.window_seconds";
+    double windowSeconds = _settingsManager.valueOrDefaultValueForKeyPath(WINDOW_SECONDS_KEY_PATH).toDouble();
+    auto nodeData = static_cast<DomainServerNodeData*>(node->getLinkedData());
+    qint64 msecsSinceLastTrace = QDateTime::currentMSecsSinceEpoch() - nodeData->getTraceTimestamp();
+    return msecsSinceLastTrace >= (qint64)(windowSeconds * MSECS_PER_SECOND / 2.0);
+}
+
+void DomainServer::processTraceDumpPacket(QSharedPointer<ReceivedMessage> packetList, SharedNodePointer sendingNode) {
+    auto nodeData = static_cast<DomainServerNodeData*>(sendingNode->getLinkedData());
+    QString nodeName = uuidStringWithoutCurlyBraces(sendingNode->getUUID())
+        + " (" + NodeType::getNodeTypeName(sendingNode->getType()) + ")";
+
+    // only assignments trace, and they sign their traces, see DomainGatekeeper::processAssignmentConnectRequest
+    if (!nodeData || !nodeData->wasAssigned() || sendingNode->getType() == NodeType::Agent
+        || sendingNode->getConnectionSecret().isNull()) {
+        qWarning() << "Ignoring a trace from" << nodeName << "- it is not an assignment";
+        return;
+    }
+
+    if (packetList->getSize() > MAX_TRACE_DUMP_BYTES) {
+        qWarning() << "Ignoring a trace of" << packetList->getSize() << "bytes from" << nodeName
+            << "- the most kept is" << MAX_TRACE_DUMP_BYTES;
+        nodeData->setTraceRequested(false);
+        return;
+    }
+
+    if (!nodeData->isTraceRequested() && !isAutomaticTraceExpected(sendingNode)) {
+        qWarning() << "Ignoring a trace from" << nodeName << "- it was not asked for";
+        return;
+    }
+    nodeData->setTraceRequested(false);
+
+    QString reason = packetList->readString();
+    nodeData->setTrace(packetList->readAll(), reason);
+    qDebug() << "Received a trace from" << nodeName << "-" << reason;
+}
+
 QJsonObject DomainServer::jsonForSocket(const HifiSockAddr& socket) {
     QJsonObject socketJSON;
 
@@ -1565,6 +1680,9 @@ const char JSON_KEY_LOCAL_SOCKET[] = "local";
 const char JSON_KEY_POOL[] = "pool";
 const char JSON_KEY_PENDING_CREDITS[] = "pending_credits";
 const char JSON_KEY_UPTIME[] = "uptime";
+const char JSON_KEY_TRACE[] = "trace";
+const char JSON_KEY_TRACE_REASON[] = "reason";
+const char JSON_KEY_TRACE_TIME[] = "time";
 const char JSON_KEY_USERNAME[] = "username";
 const char JSON_KEY_VERSION[] = "version";
 QJsonObject DomainServer::jsonObjectForNode(const SharedNodePointer& node) {
@@ -1595,6 +1713,14 @@ QJsonObject DomainServer::jsonObjectForNode(const SharedNodePointer& node) {
     nodeJson[JSON_KEY_USERNAME] = nodeData->getUsername();
     nodeJson[JSON_KEY_VERSION] = nodeData->getNodeVersion();
 
+    // add when the last trace was captured, and why
+    if (!nodeData->getCompressedTrace().isEmpty()) {
+        QJsonObject traceJson;
+        traceJson[JSON_KEY_TRACE_REASON] = nodeData->getTraceReason();
+        traceJson[JSON_KEY_TRACE_TIME] = QDateTime::fromMSecsSinceEpoch(nodeData->getTraceTimestamp()).toString(Qt::ISODate);
+        nodeJson[JSON_KEY_TRACE] = traceJson;
+    }
+
     SharedAssignmentPointer matchingAssignment = _allAssignments.value(nodeData->getAssignmentUUID());
     if (matchingAssignment) {
         nodeJson[JSON_KEY_POOL] = matchingAssignment->getPool();
@@ -1711,7 +1837,14 @@ bool DomainServer::handleHTTPRequest(HTTPConnection* connection, const QUrl& url
     }
 
     if (connection->requestOperation() == QNetworkAccessManager::GetOperation) {
-        if (url.path() == "/assignments.json") {
+        if (url.path() == "/metrics") {
+            static auto& nodesGauge = metrics::Registry::getInstance().gauge("hifi_domain_server_nodes", "Connected nodes");
+            nodesGauge.set(nodeList->size());
+
+            connection->respond(HTTPConnection::StatusCode200, metrics::Registry::getInstance().serialize(),
+                                metrics::CONTENT_TYPE);
+            return true;
+        } else if (url.path() == "/assignments.json") {
             // user is asking for json list of assignments
 
             // setup the JSON
@@ -1796,6 +1929,25 @@ bool DomainServer::handleHTTPRequest(HTTPConnection* connection, const QUrl& url
 
             return true;
         } else {
+            // check if this is for the last trace of a node
+            const QString NODE_TRACE_REGEX_STRING = QString("\\%1\\/(%2)\\/trace.json.gz$").arg(URI_NODES).arg(UUID_REGEX_STRING);
+            QRegExp nodeTraceRegex(NODE_TRACE_REGEX_STRING);
+
+            if (nodeTraceRegex.indexIn(url.path()) != -1) {
+                SharedNodePointer matchingNode = nodeList->nodeWithUUID(QUuid(nodeTraceRegex.cap(1)));
+                auto nodeData = matchingNode ? static_cast<DomainServerNodeData*>(matchingNode->getLinkedData()) : nullptr;
+                if (nodeData && !nodeData->getCompressedTrace().isEmpty()) {
+                    Headers traceHeaders;
+                    traceHeaders["Content-Disposition"] = QString("attachment; filename=\"%1-%2.json.gz\"")
+                        .arg(NodeType::getNodeTypeName(matchingNode->getType()).toLower().replace(' ', '-'))
+                        .arg(QDateTime::fromMSecsSinceEpoch(nodeData->getTraceTimestamp()).toString("yyyyMMdd-HHmmss")).toUtf8();
+                    connection->respond(HTTPConnection::StatusCode200, nodeData->getCompressedTrace(), "application/gzip", traceHeaders);
+                } else {
+                    connection->respond(HTTPConnection::StatusCode404, "Resource not found.");
+                }
+                return true;
+            }
+
             // check if this is for json stats for a node
             const QString NODE_JSON_REGEX_STRING = QString("\\%1\\/(%2).json\\/?$").arg(URI_NODES).arg(UUID_REGEX_STRING);
             QRegExp nodeShowRegex(NODE_JSON_REGEX_STRING);
@@ -1871,6 +2023,24 @@ bool DomainServer::handleHTTPRequest(HTTPConnection* connection, const QUrl& url
 
             return true;
         }
+
+        // check if this is a request for an assignment to send us its rolling trace
+        const QString NODE_TRACE_REQUEST_REGEX_STRING = QString("\\%1\\/(%2)\\/trace\\/?$").arg(URI_NODES).arg(UUID_REGEX_STRING);
+        QRegExp nodeTraceRequestRegex(NODE_TRACE_REQUEST_REGEX_STRING);
+
+        if (nodeTraceRequestRegex.indexIn(url.path()) != -1) {
+            SharedNodePointer matchingNode = nodeList->nodeWithUUID(QUuid(nodeTraceRequestRegex.cap(1)));
+            if (matchingNode && matchingNode->getType() != NodeType::Agent) {
+                // the trace arrives later, as a TraceDump packet
+                auto traceRequestPacket = NLPacket::create(PacketType::TraceDumpRequest, 0);
+                nodeList->sendPacket(std::move(traceRequestPacket), *matchingNode);
+                static_cast<DomainServerNodeData*>(matchingNode->getLinkedData())->setTraceRequested(true);
+                connection->respond(HTTPConnection::StatusCode200);
+            } else {
+                connection->respond(HTTPConnection::StatusCode404, "Resource not found.");
+            }
+            return true;
+        }
     } else if (connection->requestOperation() == QNetworkAccessManager::DeleteOperation) {
         const QString ALL_NODE_DELETE_REGEX_STRING = QString("\\%1\\/?$").arg(URI_NODES);
         const QString NODE_DELETE_REGEX_STRING = QString("\\%1\\/(%2)\\/$").arg(URI_NODES).arg(UUID_REGEX_STRING);
@@ -2190,6 +2360,9 @@ void DomainServer::nodeAdded(SharedNodePointer node) {
 void DomainServer::nodeKilled(SharedNodePointer node) {
     // if this peer connected via ICE then remove them from our ICE peers hash
     _gatekeeper.removeICEPeer(node->getUUID());
+    _gatekeeper.nodeDisconnected(node);
+
+    recordDomainListChange(node->getUUID(), true);
 
     DomainServerNodeData* nodeData = static_cast<DomainServerNodeData*>(node->getLinkedData());
 
@@ -12,6 +12,8 @@
 #ifndef hifi_DomainServer_h
 #define hifi_DomainServer_h
 
+#include <deque>
+
 #include <QtCore/QCoreApplication>
 #include <QtCore/QHash>
 #include <QtCore/QJsonObject>
@@ -69,6 +71,7 @@ public slots:
     void processRequestAssignmentPacket(QSharedPointer<ReceivedMessage> packet);
     void processListRequestPacket(QSharedPointer<ReceivedMessage> packet, SharedNodePointer sendingNode);
     void processNodeJSONStatsPacket(QSharedPointer<ReceivedMessage> packetList, SharedNodePointer sendingNode);
+    void processTraceDumpPacket(QSharedPointer<ReceivedMessage> packetList, SharedNodePointer sendingNode);
     void processPathQueryPacket(QSharedPointer<ReceivedMessage> packet);
     void processNodeDisconnectRequestPacket(QSharedPointer<ReceivedMessage> message);
     void processICEServerHeartbeatDenialPacket(QSharedPointer<ReceivedMessage> message);
@@ -130,10 +133,17 @@ private:
 
     void handleKillNode(SharedNodePointer nodeToKill);
 
-    void sendDomainListToNode(const SharedNodePointer& node, const HifiSockAddr& senderSockAddr);
+    // knownListVersion is the domain list version the node already has, 0 for none
+    void sendDomainListToNode(const SharedNodePointer& node, const HifiSockAddr& senderSockAddr,
+                              quint32 knownListVersion = 0);
+    // bumps the domain list version for a node that was added, changed or removed
+    void recordDomainListChange(const QUuid& nodeID, bool isRemoval = false);
 
     bool isInInterestSet(const SharedNodePointer& nodeA, const SharedNodePointer& nodeB);
 
+    // whether the node could have captured a trace by itself now, given the tracing settings
+    bool isAutomaticTraceExpected(const SharedNodePointer& node);
+
     QUuid connectionSecretForNodes(const SharedNodePointer& nodeA, const SharedNodePointer& nodeB);
     void broadcastNewNode(const SharedNodePointer& node);
 
@@ -216,6 +226,16 @@ private:
 
     bool _sendICEServerAddressToMetaverseAPIInProgress { false };
     bool _sendICEServerAddressToMetaverseAPIRedo { false };
+
+    // Recent changes to the node list, so that a check in only costs the nodes that changed since
+    // the version the node has. Versions start at 1, older versions than the first change get a full list.
+    struct DomainListChange {
+        quint32 version;
+        QUuid nodeID;
+        bool isRemoval;
+    };
+    std::deque<DomainListChange> _domainListChanges;
+    quint32 _domainListVersion { 0 };
 };
 
 
@@ -10,6 +10,7 @@
 //
 
 #include <QtCore/QDataStream>
+#include <QtCore/QDateTime>
 #include <QtCore/QJsonArray>
 #include <QtCore/QJsonDocument>
 #include <QtCore/QJsonObject>
@@ -31,6 +32,21 @@ void DomainServerNodeData::updateJSONStats(QByteArray statsByteArray) {
     _statsJSONObject = overrideValuesIfNeeded(document.object());
 }
 
+void DomainServerNodeData::setTrace(const QByteArray& compressedTrace, const QString& reason) {
+    _compressedTrace = compressedTrace;
+    _traceReason = reason;
+    _traceTimestamp = QDateTime::currentMSecsSinceEpoch();
+}
+
+bool DomainServerNodeData::setDomainListFilter(const NodeSet& interestSet, bool canRez) {
+    if (interestSet == _domainListInterestSet && canRez == _domainListCanRez) {
+        return false;
+    }
+    _domainListInterestSet = interestSet;
+    _domainListCanRez = canRez;
+    return true;
+}
+
 QJsonObject DomainServerNodeData::overrideValuesIfNeeded(const QJsonObject& newStats) {
     QJsonObject result;
     for (auto it = newStats.constBegin(); it != newStats.constEnd(); ++it) {
@@ -68,6 +68,20 @@ public:
 
     bool wasAssigned() const { return _wasAssigned; };
     void setWasAssigned(bool wasAssigned) { _wasAssigned = wasAssigned; }
+
+    // what picks the nodes in the domain lists sent to this node, returns true if that changed
+    // since the last list, in which case the node needs a full list
+    bool setDomainListFilter(const NodeSet& interestSet, bool canRez);
+
+    // the last rolling trace sent by the node, gzipped Chrome trace JSON
+    void setTrace(const QByteArray& compressedTrace, const QString& reason);
+    const QByteArray& getCompressedTrace() const { return _compressedTrace; }
+    const QString& getTraceReason() const { return _traceReason; }
+    qint64 getTraceTimestamp() const { return _traceTimestamp; }
+
+    // whether we asked the node for its trace and haven't had it yet
+    void setTraceRequested(bool traceRequested) { _traceRequested = traceRequested; }
+    bool isTraceRequested() const { return _traceRequested; }
     
 private:
     QJsonObject overrideValuesIfNeeded(const QJsonObject& newStats);
@@ -93,6 +107,14 @@ private:
     QString _placeName;
 
     bool _wasAssigned { false };
+
+    NodeSet _domainListInterestSet;
+    bool _domainListCanRez { false };
+
+    QByteArray _compressedTrace;
+    QString _traceReason;
+    qint64 _traceTimestamp { 0 }; // msecs since epoch
+    bool _traceRequested { false };
 };
 
 #endif // hifi_DomainServerNodeData_h
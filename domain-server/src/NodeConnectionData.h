@@ -32,6 +32,8 @@ public:
     QUuid machineFingerprint;
 
     QByteArray protocolVersion;
+
+    quint32 domainListVersion { 0 }; // list requests only, the version of the domain list the node has
 };
 
 
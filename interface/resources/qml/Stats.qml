@@ -230,6 +230,10 @@ Item {
                     StatText {
                         text: "     Avatar: " + root.avatarSimulationTime.toFixed(1) + " ms"
                     }
+                    StatText {
+                        text: "     Shapes: " + root.shapeBuildTime.toFixed(1) + " ms avg, " +
+                            root.shapesPending + " pending, " + root.shapeCacheHits + " / " + root.shapesBuilt + " cached"
+                    }
                     StatText {
                         text: "Triangles: " + root.triangles +
                             " / Material Switches: " + root.materialSwitches
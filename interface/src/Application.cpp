@@ -141,6 +141,7 @@
 #include "LODManager.h"
 #include "ModelPackager.h"
 #include "networking/HFWebEngineProfile.h"
+#include "raypick/PickManager.h"
 #include "scripting/TestScriptingInterface.h"
 #include "scripting/AccountScriptingInterface.h"
 #include "scripting/AssetMappingsScriptingInterface.h"
@@ -486,6 +487,7 @@ bool setupEssentials(int& argc, char** argv) {
     DependencyManager::set<UsersScriptingInterface>();
     DependencyManager::set<AvatarManager>();
     DependencyManager::set<LODManager>();
+    DependencyManager::set<PickManager>();
     DependencyManager::set<StandAloneJSConsole>();
     DependencyManager::set<DialogsManager>();
     DependencyManager::set<BandwidthRecorder>();
@@ -1724,6 +1726,9 @@ void Application::cleanupBeforeQuit() {
     DependencyManager::get<ScriptEngines>()->shutdownScripting(); // stop all currently running global scripts
     DependencyManager::destroy<ScriptEngines>();
 
+    // stop picking before what it picks against goes
+    DependencyManager::get<PickManager>()->shutdown();
+
     _displayPlugin.reset();
     PluginManager::getInstance()->shutdown();
 
@@ -1790,6 +1795,7 @@ Application::~Application() {
     DependencyManager::get<AvatarManager>()->getObjectsToRemoveFromPhysics(motionStates);
     _physicsEngine->removeObjects(motionStates);
 
+    DependencyManager::destroy<PickManager>();
     DependencyManager::destroy<AvatarManager>();
     DependencyManager::destroy<AnimationCache>();
     DependencyManager::destroy<FramebufferCache>();
@@ -2062,7 +2068,7 @@ void Application::paintGL() {
 
     auto lastPaintBegin = usecTimestampNow();
     PROFILE_RANGE_EX(render, __FUNCTION__, 0xff0000ff, (uint64_t)_frameCount);
-    PerformanceTimer perfTimer("paintGL");
+    PERFORMANCE_TIMER("paintGL");
 
     if (nullptr == _displayPlugin) {
         return;
@@ -2111,7 +2117,7 @@ void Application::paintGL() {
 
     auto inputs = AvatarInputs::getInstance();
     if (inputs->mirrorVisible()) {
-        PerformanceTimer perfTimer("Mirror");
+        PERFORMANCE_TIMER("Mirror");
 
         renderArgs._renderMode = RenderArgs::MIRROR_RENDER_MODE;
         renderArgs._blitFramebuffer = DependencyManager::get<FramebufferCache>()->getSelfieFramebuffer();
@@ -2125,7 +2131,7 @@ void Application::paintGL() {
     }
 
     {
-        PerformanceTimer perfTimer("renderOverlay");
+        PERFORMANCE_TIMER("renderOverlay");
         // NOTE: There is no batch associated with this renderArgs
         // the ApplicationOverlay class assumes it's viewport is setup to be the device size
         QSize size = getDeviceSize();
@@ -2135,7 +2141,7 @@ void Application::paintGL() {
 
     glm::vec3 boomOffset;
     {
-        PerformanceTimer perfTimer("CameraUpdates");
+        PERFORMANCE_TIMER("CameraUpdates");
 
         auto myAvatar = getMyAvatar();
         boomOffset = myAvatar->getScale() * myAvatar->getBoomLength() * -IDENTITY_FRONT;
@@ -2239,7 +2245,7 @@ void Application::paintGL() {
 
     {
         PROFILE_RANGE(render, "/mainRender");
-        PerformanceTimer perfTimer("mainRender");
+        PERFORMANCE_TIMER("mainRender");
         renderArgs._boomOffset = boomOffset;
         // Viewport is assigned to the size of the framebuffer
         renderArgs._viewport = ivec4(0, 0, size.width(), size.height());
@@ -2294,7 +2300,7 @@ void Application::paintGL() {
     // deliver final scene rendering commands to the display plugin
     {
         PROFILE_RANGE(render, "/pluginOutput");
-        PerformanceTimer perfTimer("pluginOutput");
+        PERFORMANCE_TIMER("pluginOutput");
         _frameCounter.increment();
         displayPlugin->submitFrame(frame);
     }
@@ -3425,7 +3431,7 @@ void getCpuUsage(vec3& systemAndUser) {
 
 
 void Application::idle(float nsecsElapsed) {
-    PerformanceTimer perfTimer("idle");
+    PERFORMANCE_TIMER("idle");
 
     // Update the deadlock watchdog
     updateHeartbeat();
@@ -3502,7 +3508,7 @@ void Application::idle(float nsecsElapsed) {
     PerformanceWarning warn(showWarnings, "idle()");
 
     {
-        PerformanceTimer perfTimer("update");
+        PERFORMANCE_TIMER("update");
         PerformanceWarning warn(showWarnings, "Application::idle()... update()");
         static const float BIGGEST_DELTA_TIME_SECS = 0.25f;
         update(glm::clamp(secondsSinceLastUpdate, 0.0f, BIGGEST_DELTA_TIME_SECS));
@@ -3539,7 +3545,7 @@ void Application::idle(float nsecsElapsed) {
     }
 
     {
-        PerformanceTimer perfTimer("pluginIdle");
+        PERFORMANCE_TIMER("pluginIdle");
         PerformanceWarning warn(showWarnings, "Application::idle()... pluginIdle()");
         getActiveDisplayPlugin()->idle();
         auto inputPlugins = PluginManager::getInstance()->getInputPlugins();
@@ -3550,7 +3556,7 @@ void Application::idle(float nsecsElapsed) {
         }
     }
     {
-        PerformanceTimer perfTimer("rest");
+        PERFORMANCE_TIMER("rest");
         PerformanceWarning warn(showWarnings, "Application::idle()... rest of it");
         _idleLoopStdev.addValue(secondsSinceLastUpdate);
 
@@ -3855,6 +3861,7 @@ void Application::init() {
         return atan2(maxSize, distance);
     });
 
+    _shapeManager.setCacheDirectory(QStandardPaths::writableLocation(QStandardPaths::DataLocation) + "/physics/shapes");
     ObjectMotionState::setShapeManager(&_shapeManager);
     _physicsEngine->init();
 
@@ -3896,7 +3903,7 @@ void Application::init() {
 }
 
 void Application::updateLOD() const {
-    PerformanceTimer perfTimer("LOD");
+    PERFORMANCE_TIMER("LOD");
     // adjust it unless we were asked to disable this feature, or if we're currently in throttleRendering mode
     if (!isThrottleRendering()) {
         DependencyManager::get<LODManager>()->autoAdjustLOD(_frameCounter.rate());
@@ -3915,7 +3922,7 @@ void Application::pushPostUpdateLambda(void* key, std::function<void()> func) {
 // The principal result is to call updateLookAtTargetAvatar() and then setLookAtPosition().
 // Note that it is called BEFORE we update position or joints based on sensors, etc.
 void Application::updateMyAvatarLookAtPosition() {
-    PerformanceTimer perfTimer("lookAt");
+    PERFORMANCE_TIMER("lookAt");
     bool showWarnings = Menu::getInstance()->isOptionChecked(MenuOption::PipelineWarnings);
     PerformanceWarning warn(showWarnings, "Application::updateMyAvatarLookAtPosition()");
 
@@ -4004,7 +4011,7 @@ void Application::updateMyAvatarLookAtPosition() {
 }
 
 void Application::updateThreads(float deltaTime) {
-    PerformanceTimer perfTimer("updateThreads");
+    PERFORMANCE_TIMER("updateThreads");
     bool showWarnings = Menu::getInstance()->isOptionChecked(MenuOption::PipelineWarnings);
     PerformanceWarning warn(showWarnings, "Application::updateThreads()");
 
@@ -4223,7 +4230,7 @@ void Application::setKeyboardFocusOverlay(OverlayID overlayID) {
 }
 
 void Application::updateDialogs(float deltaTime) const {
-    PerformanceTimer perfTimer("updateDialogs");
+    PERFORMANCE_TIMER("updateDialogs");
     bool showWarnings = Menu::getInstance()->isOptionChecked(MenuOption::PipelineWarnings);
     PerformanceWarning warn(showWarnings, "Application::updateDialogs()");
     auto dialogsManager = DependencyManager::get<DialogsManager>();
@@ -4292,7 +4299,7 @@ void Application::update(float deltaTime) {
     }
 
     {
-        PerformanceTimer perfTimer("devices");
+        PERFORMANCE_TIMER("devices");
         DeviceTracker::updateAll();
 
         FaceTracker* tracker = getSelectedFaceTracker();
@@ -4384,12 +4391,12 @@ void Application::update(float deltaTime) {
     if (_physicsEnabled) {
         PROFILE_RANGE_EX(simulation_physics, "Physics", 0xffff0000, (uint64_t)getActiveDisplayPlugin()->presentCount());
 
-        PerformanceTimer perfTimer("physics");
+        PERFORMANCE_TIMER("physics");
 
         {
             PROFILE_RANGE_EX(simulation_physics, "UpdateStats", 0xffffff00, (uint64_t)getActiveDisplayPlugin()->presentCount());
 
-            PerformanceTimer perfTimer("updateStates)");
+            PERFORMANCE_TIMER("updateStates)");
             static VectorOfMotionStates motionStates;
             _entitySimulation->getObjectsToRemoveFromPhysics(motionStates);
             _physicsEngine->removeObjects(motionStates);
@@ -4422,21 +4429,24 @@ void Application::update(float deltaTime) {
         }
         {
             PROFILE_RANGE_EX(simulation_physics, "StepSimulation", 0xffff8000, (uint64_t)getActiveDisplayPlugin()->presentCount());
-            PerformanceTimer perfTimer("stepSimulation");
+            PERFORMANCE_TIMER("stepSimulation");
+            const int NUM_PARALLEL_SOLVER_THREADS = 4;
+            bool parallelSolver = Menu::getInstance()->isOptionChecked(MenuOption::PhysicsMultithreadedSolver);
+            _physicsEngine->setNumSolverThreads(parallelSolver ? NUM_PARALLEL_SOLVER_THREADS : 1);
             getEntities()->getTree()->withWriteLock([&] {
                 _physicsEngine->stepSimulation();
             });
         }
         {
             PROFILE_RANGE_EX(simulation_physics, "HarvestChanges", 0xffffff00, (uint64_t)getActiveDisplayPlugin()->presentCount());
-            PerformanceTimer perfTimer("harvestChanges");
+            PERFORMANCE_TIMER("harvestChanges");
             if (_physicsEngine->hasOutgoingChanges()) {
                 // grab the collision events BEFORE handleOutgoingChanges() because at this point
                 // we have a better idea of which objects we own or should own.
                 auto& collisionEvents = _physicsEngine->getCollisionEvents();
 
                 getEntities()->getTree()->withWriteLock([&] {
-                    PerformanceTimer perfTimer("handleOutgoingChanges");
+                    PERFORMANCE_TIMER("handleOutgoingChanges");
                     const VectorOfMotionStates& outgoingChanges = _physicsEngine->getOutgoingChanges();
                     _entitySimulation->handleOutgoingChanges(outgoingChanges);
                     avatarManager->handleOutgoingChanges(outgoingChanges);
@@ -4444,7 +4454,7 @@ void Application::update(float deltaTime) {
 
                 if (!_aboutToQuit) {
                     // handleCollisionEvents() AFTER handleOutgoinChanges()
-                    PerformanceTimer perfTimer("entities");
+                    PERFORMANCE_TIMER("entities");
                     avatarManager->handleCollisionEvents(collisionEvents);
                     // Collision events (and their scripts) must not be handled when we're locked, above. (That would risk
                     // deadlock.)
@@ -4469,7 +4479,7 @@ void Application::update(float deltaTime) {
 
     // AvatarManager update
     {
-        PerformanceTimer perfTimer("AvatarManager");
+        PERFORMANCE_TIMER("AvatarManager");
         _avatarSimCounter.increment();
 
         {
@@ -4487,10 +4497,15 @@ void Application::update(float deltaTime) {
 
     {
         PROFILE_RANGE_EX(app, "Overlays", 0xffff0000, (uint64_t)getActiveDisplayPlugin()->presentCount());
-        PerformanceTimer perfTimer("overlays");
+        PERFORMANCE_TIMER("overlays");
         _overlays.update(deltaTime);
     }
 
+    {
+        PERFORMANCE_TIMER("picks");
+        DependencyManager::get<PickManager>()->update();
+    }
+
     // Update _viewFrustum with latest camera and view frustum data...
     // NOTE: we get this from the view frustum, to make it simpler, since the
     // loadViewFrumstum() method will get the correct details from the camera
@@ -4508,7 +4523,7 @@ void Application::update(float deltaTime) {
     {
         PROFILE_RANGE_EX(app, "QueryOctree", 0xffff0000, (uint64_t)getActiveDisplayPlugin()->presentCount());
         QMutexLocker viewLocker(&_viewMutex);
-        PerformanceTimer perfTimer("queryOctree");
+        PERFORMANCE_TIMER("queryOctree");
         quint64 sinceLastQuery = now - _lastQueriedTime;
         const quint64 TOO_LONG_SINCE_LAST_QUERY = 3 * USECS_PER_SECOND;
         bool queryIsDue = sinceLastQuery > TOO_LONG_SINCE_LAST_QUERY;
@@ -4906,7 +4921,7 @@ namespace render {
     template <> const Item::Bound payloadGetBound(const WorldBoxRenderData::Pointer& stuff) { return Item::Bound(); }
     template <> void payloadRender(const WorldBoxRenderData::Pointer& stuff, RenderArgs* args) {
         if (args->_renderMode != RenderArgs::MIRROR_RENDER_MODE && Menu::getInstance()->isOptionChecked(MenuOption::WorldAxes)) {
-            PerformanceTimer perfTimer("worldBox");
+            PERFORMANCE_TIMER("worldBox");
 
             auto& batch = *args->_batch;
             DependencyManager::get<GeometryCache>()->bindSimpleProgram(batch);
@@ -4959,7 +4974,7 @@ namespace render {
             case model::SunSkyStage::SKY_BOX: {
                 auto skybox = skyStage->getSkybox();
                 if (!skybox->empty()) {
-                    PerformanceTimer perfTimer("skybox");
+                    PERFORMANCE_TIMER("skybox");
                     skybox->render(batch, args->getViewFrustum());
                     break;
                 }
@@ -5008,7 +5023,7 @@ void Application::displaySide(RenderArgs* renderArgs, Camera& theCamera, bool se
 
     activeRenderingThread = QThread::currentThread();
     PROFILE_RANGE(render, __FUNCTION__);
-    PerformanceTimer perfTimer("display");
+    PERFORMANCE_TIMER("display");
     PerformanceWarning warn(Menu::getInstance()->isOptionChecked(MenuOption::PipelineWarnings), "Application::displaySide()");
 
     // load the view frustum
@@ -5035,7 +5050,7 @@ void Application::displaySide(RenderArgs* renderArgs, Camera& theCamera, bool se
     if (!selfAvatarOnly) {
         if (DependencyManager::get<SceneScriptingInterface>()->shouldRenderEntities()) {
             // render models...
-            PerformanceTimer perfTimer("entities");
+            PERFORMANCE_TIMER("entities");
             PerformanceWarning warn(Menu::getInstance()->isOptionChecked(MenuOption::PipelineWarnings),
                 "Application::displaySide() ... entities...");
 
@@ -5073,7 +5088,7 @@ void Application::displaySide(RenderArgs* renderArgs, Camera& theCamera, bool se
     }
 
     {
-        PerformanceTimer perfTimer("SceneProcessPendingChanges");
+        PERFORMANCE_TIMER("SceneProcessPendingChanges");
         _main3DScene->enqueuePendingChanges(pendingChanges);
 
         _main3DScene->processPendingChangesQueue();
@@ -5081,7 +5096,7 @@ void Application::displaySide(RenderArgs* renderArgs, Camera& theCamera, bool se
 
     // For now every frame pass the renderContext
     {
-        PerformanceTimer perfTimer("EngineRun");
+        PERFORMANCE_TIMER("EngineRun");
 
         {
             QMutexLocker viewLocker(&_viewMutex);
@@ -5532,6 +5547,7 @@ void Application::registerScriptEngineWithApplicationServices(ScriptEngine* scri
     scriptEngine->registerGlobalObject("UndoStack", &_undoStackScriptingInterface);
 
     scriptEngine->registerGlobalObject("LODManager", DependencyManager::get<LODManager>().data());
+    scriptEngine->registerGlobalObject("Picks", DependencyManager::get<PickManager>().data());
 
     scriptEngine->registerGlobalObject("Paths", DependencyManager::get<PathUtils>().data());
 
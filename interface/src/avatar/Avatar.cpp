@@ -205,7 +205,7 @@ void Avatar::setTargetScale(float targetScale) {
 }
 
 void Avatar::updateAvatarEntities() {
-    PerformanceTimer perfTimer("attachments");
+    PERFORMANCE_TIMER("attachments");
     // - if queueEditEntityMessage sees clientOnly flag it does _myAvatar->updateAvatarEntity()
     // - updateAvatarEntity saves the bytes and sets _avatarEntityDataLocallyEdited
     // - MyAvatar::update notices _avatarEntityDataLocallyEdited and calls sendIdentityPacket
@@ -343,7 +343,7 @@ void Avatar::simulate(float deltaTime, bool inView) {
     }
 
 
-    PerformanceTimer perfTimer("simulate");
+    PERFORMANCE_TIMER("simulate");
     {
         PROFILE_RANGE(simulation, "updateJoints");
         if (inView && _hasNewJointData) {
@@ -353,17 +353,9 @@ void Avatar::simulate(float deltaTime, bool inView) {
             _skeletonModel->simulate(deltaTime, true);
             _skeletonModelSimulationRate.increment();
 
-            locationChanged(); // joints changed, so if there are any children, update them.
+            // the rig may only have been queued on its RigBatch, the joint dependent updates wait for finishSimulation().
             _hasNewJointData = false;
-
-            glm::vec3 headPosition = getPosition();
-            if (!_skeletonModel->getHeadPosition(headPosition)) {
-                headPosition = getPosition();
-            }
-            Head* head = getHead();
-            head->setPosition(headPosition);
-            head->setScale(getUniformScale());
-            head->simulate(deltaTime, false);
+            _hasNewPoses = true;
         } else {
             // a non-full update is still required so that the position, rotation, scale and bounds of the skeletonModel are updated.
             _skeletonModel->simulate(deltaTime, false);
@@ -387,6 +379,25 @@ void Avatar::simulate(float deltaTime, bool inView) {
         }
         _displayNameAlpha = abs(_displayNameAlpha - _displayNameTargetAlpha) < 0.01f ? _displayNameTargetAlpha : _displayNameAlpha;
     }
+}
+
+void Avatar::finishSimulation(float deltaTime) {
+    PROFILE_RANGE(simulation, "finishSimulation");
+    PERFORMANCE_TIMER("finishSimulation");
+    if (_hasNewPoses) {
+        _hasNewPoses = false;
+        _skeletonModel->finishUpdateRig();
+        locationChanged(); // joints changed, so if there are any children, update them.
+
+        glm::vec3 headPosition = getPosition();
+        if (!_skeletonModel->getHeadPosition(headPosition)) {
+            headPosition = getPosition();
+        }
+        Head* head = getHead();
+        head->setPosition(headPosition);
+        head->setScale(getUniformScale());
+        head->simulate(deltaTime, false);
+    }
 
     {
         PROFILE_RANGE(simulation, "misc");
@@ -436,7 +447,7 @@ void Avatar::applyPositionDelta(const glm::vec3& delta) {
 }
 
 void Avatar::measureMotionDerivatives(float deltaTime) {
-    PerformanceTimer perfTimer("derivatives");
+    PERFORMANCE_TIMER("derivatives");
     // linear
     float invDeltaTime = 1.0f / deltaTime;
     // Floating point error prevents us from computing velocity in a naive way
@@ -705,7 +716,7 @@ bool Avatar::shouldRenderHead(const RenderArgs* renderArgs) const {
 
 // virtual
 void Avatar::simulateAttachments(float deltaTime) {
-    PerformanceTimer perfTimer("attachments");
+    PERFORMANCE_TIMER("attachments");
     for (int i = 0; i < (int)_attachmentModels.size(); i++) {
         const AttachmentData& attachment = _attachmentData.at(i);
         auto& model = _attachmentModels.at(i);
@@ -1131,8 +1142,8 @@ void Avatar::setAttachmentData(const QVector<AttachmentData>& attachmentData) {
 }
 
 
-int Avatar::parseDataFromBuffer(const QByteArray& buffer) {
-    PerformanceTimer perfTimer("unpack");
+void Avatar::applyDecodedData(const DecodedAvatarData& decoded) {
+    PERFORMANCE_TIMER("unpack");
     if (!_initialized) {
         // now that we have data for this Avatar we are go for init
         init();
@@ -1141,7 +1152,7 @@ int Avatar::parseDataFromBuffer(const QByteArray& buffer) {
     // change in position implies movement
     glm::vec3 oldPosition = getPosition();
 
-    int bytesRead = AvatarData::parseDataFromBuffer(buffer);
+    AvatarData::applyDecodedData(decoded);
 
     const float MOVE_DISTANCE_THRESHOLD = 0.001f;
     _moving = glm::distance(oldPosition, getPosition()) > MOVE_DISTANCE_THRESHOLD;
@@ -1151,8 +1162,6 @@ int Avatar::parseDataFromBuffer(const QByteArray& buffer) {
     if (_moving || _hasNewJointData) {
         locationChanged();
     }
-
-    return bytesRead;
 }
 
 int Avatar::_jointConesID = GeometryCache::UNKNOWN_ID;
@@ -1352,7 +1361,7 @@ void Avatar::setOrientation(const glm::quat& orientation) {
 }
 
 void Avatar::updatePalms() {
-    PerformanceTimer perfTimer("palms");
+    PERFORMANCE_TIMER("palms");
     // update thread-safe caches
     _leftPalmRotationCache.set(getUncachedLeftPalmRotation());
     _rightPalmRotationCache.set(getUncachedRightPalmRotation());
@@ -67,6 +67,9 @@ public:
     void init();
     void updateAvatarEntities();
     void simulate(float deltaTime, bool inView);
+    // the second half of simulate(), for everything that reads joint poses: the head, attachments, palms and avatar entities.
+    // call it once the RigBatch the avatar's rig was queued on has been evaluated.
+    void finishSimulation(float deltaTime);
     virtual void simulateAttachments(float deltaTime);
 
     virtual void render(RenderArgs* renderArgs, const glm::vec3& cameraPosition);
@@ -122,7 +125,7 @@ public:
     void setShowDisplayName(bool showDisplayName);
     virtual void setSessionDisplayName(const QString& sessionDisplayName) override { }; // no-op
 
-    virtual int parseDataFromBuffer(const QByteArray& buffer) override;
+    virtual void applyDecodedData(const DecodedAvatarData& decoded) override;
 
     static void renderJointConnectingCone( gpu::Batch& batch, glm::vec3 position1, glm::vec3 position2,
                                                 float radius1, float radius2, const glm::vec4& color);
@@ -288,6 +291,7 @@ private:
     bool _isLookAtTarget { false };
     bool _inScene { false };
     bool _isAnimatingScale { false };
+    bool _hasNewPoses { false }; // set by simulate() when the rig was updated, cleared by finishSimulation()
 
     float getBoundingRadius() const;
 
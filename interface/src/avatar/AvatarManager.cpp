@@ -29,6 +29,7 @@
 #include <PerfStat.h>
 #include <RegisteredMetaTypes.h>
 #include <Rig.h>
+#include <RigBatch.h>
 #include <SettingHandle.h>
 #include <UsersScriptingInterface.h>
 #include <UUID.h>
@@ -76,11 +77,12 @@ AvatarManager::AvatarManager(QObject* parent) :
 
     auto nodeList = DependencyManager::get<NodeList>();
     auto& packetReceiver = nodeList->getPacketReceiver();
-    packetReceiver.registerListener(PacketType::BulkAvatarData, this, "processAvatarDataPacket");
-    packetReceiver.registerListener(PacketType::KillAvatar, this, "processKillAvatar");
     packetReceiver.registerListener(PacketType::AvatarIdentity, this, "processAvatarIdentityPacket");
     packetReceiver.registerListener(PacketType::ExitingSpaceBubble, this, "processExitingSpaceBubble");
 
+    // avatar data and kills are decoded on their own thread, and applied in updateOtherAvatars
+    startDecodingThread();
+
     // when we hear that the user has ignored an avatar by session UUID
     // immediately remove that avatar instead of waiting for the absence of packets from avatar mixer
     connect(nodeList.data(), &NodeList::ignoredNode, this, [=](const QUuid& nodeID, bool enabled) {
@@ -122,7 +124,7 @@ void AvatarManager::updateMyAvatar(float deltaTime) {
 
     if (dt > MIN_TIME_BETWEEN_MY_AVATAR_DATA_SENDS) {
         // send head/hand data to the avatar mixer and voxel server
-        PerformanceTimer perfTimer("send");
+        PERFORMANCE_TIMER("send");
         _myAvatar->sendAvatarDataPacket();
         _lastSendAvatarDataTime = now;
         _myAvatarSendRate.increment();
@@ -148,7 +150,25 @@ float AvatarManager::getAvatarSimulationRate(const QUuid& sessionID, const QStri
 }
 
 
+// distant and out of view avatars are animated at a lower rate, without IK
+static Rig::AnimationLOD computeAnimationLOD(const ViewFrustum& view, const std::shared_ptr<Avatar>& avatar, bool inView) {
+    const float REDUCED_ANIMATION_DISTANCE = 10.0f; // meters
+    const float MINIMAL_ANIMATION_DISTANCE = 30.0f; // meters
+    if (!inView) {
+        return Rig::AnimationLOD::Minimal;
+    }
+    float distance = glm::distance(view.getPosition(), avatar->getPosition());
+    if (distance > MINIMAL_ANIMATION_DISTANCE) {
+        return Rig::AnimationLOD::Minimal;
+    } else if (distance > REDUCED_ANIMATION_DISTANCE) {
+        return Rig::AnimationLOD::Reduced;
+    }
+    return Rig::AnimationLOD::Full;
+}
+
 void AvatarManager::updateOtherAvatars(float deltaTime) {
+    applyDecodedAvatarData();
+
     // lock the hash for read to check the size
     QReadLocker lock(&_hashLock);
     if (_avatarHash.size() < 2 && _avatarFades.isEmpty()) {
@@ -156,7 +176,7 @@ void AvatarManager::updateOtherAvatars(float deltaTime) {
     }
     lock.unlock();
 
-    PerformanceTimer perfTimer("otherAvatars");
+    PERFORMANCE_TIMER("otherAvatars");
     uint64_t startTime = usecTimestampNow();
 
     auto avatarMap = getHashCopy();
@@ -201,6 +221,7 @@ void AvatarManager::updateOtherAvatars(float deltaTime) {
 
     int numAvatarsUpdated = 0;
     int numAVatarsNotUpdated = 0;
+    QVector<std::shared_ptr<Avatar>> simulatedAvatars; // finished once their rigs have been evaluated
     while (!sortedAvatars.empty()) {
         const AvatarPriority& sortData = sortedAvatars.top();
         const auto& avatar = std::static_pointer_cast<Avatar>(sortData.avatar);
@@ -229,7 +250,9 @@ void AvatarManager::updateOtherAvatars(float deltaTime) {
             if (inView && avatar->hasNewJointData()) {
                 numAvatarsUpdated++;
             }
+            avatar->getSkeletonModel()->getRig()->setAnimationLOD(computeAnimationLOD(cameraView, avatar, inView));
             avatar->simulate(deltaTime, inView);
+            simulatedAvatars.push_back(avatar);
             avatar->updateRenderItem(pendingChanges);
             avatar->setLastRenderUpdateTime(startTime);
         } else if (now < maxExpiry) {
@@ -240,6 +263,7 @@ void AvatarManager::updateOtherAvatars(float deltaTime) {
                 numAVatarsNotUpdated++;
             }
             avatar->simulate(deltaTime, false);
+            simulatedAvatars.push_back(avatar);
         } else {
             // we've spent ALL of our time budget --> bail on the rest of the avatar updates
             // --> more avatars may freeze until their priority trickles up
@@ -274,7 +298,14 @@ void AvatarManager::updateOtherAvatars(float deltaTime) {
     _numAvatarsNotUpdated = numAVatarsNotUpdated;
     qApp->getMain3DScene()->enqueuePendingChanges(pendingChanges);
 
-    simulateAvatarFades(deltaTime);
+    simulateAvatarFades(deltaTime, simulatedAvatars);
+
+    // the rigs of the avatars simulated above have only been queued, evaluate them all in parallel
+    // before anything reads their joints.
+    _rigBatch->evaluate();
+    for (auto& avatar : simulatedAvatars) {
+        avatar->finishSimulation(deltaTime);
+    }
 }
 
 void AvatarManager::postUpdate(float deltaTime) {
@@ -286,7 +317,7 @@ void AvatarManager::postUpdate(float deltaTime) {
     }
 }
 
-void AvatarManager::simulateAvatarFades(float deltaTime) {
+void AvatarManager::simulateAvatarFades(float deltaTime, QVector<std::shared_ptr<Avatar>>& simulatedAvatars) {
     QVector<AvatarSharedPointer>::iterator fadingIterator = _avatarFades.begin();
 
     const float SHRINK_RATE = 0.15f;
@@ -309,6 +340,7 @@ void AvatarManager::simulateAvatarFades(float deltaTime) {
         } else {
             const bool inView = true; // HACK
             avatar->simulate(deltaTime, inView);
+            simulatedAvatars.push_back(avatar);
             ++fadingIterator;
         }
     }
@@ -316,7 +348,9 @@ void AvatarManager::simulateAvatarFades(float deltaTime) {
 }
 
 AvatarSharedPointer AvatarManager::newSharedAvatar() {
-    return std::make_shared<Avatar>(std::make_shared<Rig>());
+    auto rig = std::make_shared<Rig>();
+    rig->setRigBatch(_rigBatch);
+    return std::make_shared<Avatar>(rig);
 }
 
 AvatarSharedPointer AvatarManager::addAvatar(const QUuid& sessionUUID, const QWeakPointer<Node>& mixerWeakPointer) {
@@ -367,6 +401,9 @@ void AvatarManager::handleRemovedAvatar(const AvatarSharedPointer& removedAvatar
 }
 
 void AvatarManager::clearOtherAvatars() {
+    // updates decoded for the avatars being cleared would only bring them back
+    discardDecodedAvatarData();
+
     // clear any avatars that came from an avatar-mixer
     QWriteLocker locker(&_hashLock);
 
@@ -19,6 +19,7 @@
 #include <AvatarHashMap.h>
 #include <PhysicsEngine.h>
 #include <PIDController.h>
+#include <RigBatch.h>
 #include <SimpleMovingAverage.h>
 #include <shared/RateCounter.h>
 
@@ -98,7 +99,7 @@ private:
     explicit AvatarManager(QObject* parent = 0);
     explicit AvatarManager(const AvatarManager& other);
 
-    void simulateAvatarFades(float deltaTime);
+    void simulateAvatarFades(float deltaTime, QVector<std::shared_ptr<Avatar>>& simulatedAvatars);
 
     // virtual overrides
     virtual AvatarSharedPointer newSharedAvatar() override;
@@ -123,6 +124,9 @@ private:
     int _numAvatarsUpdated { 0 };
     int _numAvatarsNotUpdated { 0 };
     float _avatarSimulationTime { 0.0f };
+
+    // animation of the other avatars, evaluated in parallel at the end of updateOtherAvatars()
+    RigBatch::Pointer _rigBatch { std::make_shared<RigBatch>() };
 };
 
 Q_DECLARE_METATYPE(AvatarManager::LocalLight)
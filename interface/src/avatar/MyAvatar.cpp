@@ -444,12 +444,12 @@ extern QByteArray avatarStateToFrame(const AvatarData* _avatar);
 extern void avatarStateFromFrame(const QByteArray& frameData, AvatarData* _avatar);
 
 void MyAvatar::simulate(float deltaTime) {
-    PerformanceTimer perfTimer("simulate");
+    PERFORMANCE_TIMER("simulate");
 
     animateScaleChanges(deltaTime);
 
     {
-        PerformanceTimer perfTimer("transform");
+        PERFORMANCE_TIMER("transform");
         bool stepAction = false;
         // When there are no step values, we zero out the last step pulse.
         // This allows a user to do faster snapping by tapping a control
@@ -468,7 +468,7 @@ void MyAvatar::simulate(float deltaTime) {
     updateSensorToWorldMatrix();
 
     {
-        PerformanceTimer perfTimer("skeleton");
+        PERFORMANCE_TIMER("skeleton");
         _skeletonModel->simulate(deltaTime);
     }
 
@@ -483,7 +483,7 @@ void MyAvatar::simulate(float deltaTime) {
     }
 
     {
-        PerformanceTimer perfTimer("joints");
+        PERFORMANCE_TIMER("joints");
         // copy out the skeleton joints from the model
         if (_rigEnabled) {
             _rig->copyJointsIntoJointData(_jointData);
@@ -491,7 +491,7 @@ void MyAvatar::simulate(float deltaTime) {
     }
 
     {
-        PerformanceTimer perfTimer("head");
+        PERFORMANCE_TIMER("head");
         Head* head = getHead();
         glm::vec3 headPosition;
         if (!_skeletonModel->getHeadPosition(headPosition)) {
@@ -546,7 +546,7 @@ void MyAvatar::simulate(float deltaTime) {
             });
             // also update the position of children in our local octree
             if (moveOperator.hasMovingEntities()) {
-                PerformanceTimer perfTimer("recurseTreeWithOperator");
+                PERFORMANCE_TIMER("recurseTreeWithOperator");
                 entityTree->recurseTreeWithOperator(&moveOperator);
             }
         });
@@ -1035,8 +1035,12 @@ AttachmentData MyAvatar::loadAttachmentData(const QUrl& modelURL, const QString&
 int MyAvatar::parseDataFromBuffer(const QByteArray& buffer) {
     qCDebug(interfaceapp) << "Error: ignoring update packet for MyAvatar"
         << " packetLength = " << buffer.size();
-    // this packet is just bad, so we pretend that we unpacked it ALL
-    return buffer.size();
+    // this data is just bad, so we skip past all of it
+    return getAvatarDataSize(buffer);
+}
+
+void MyAvatar::applyDecodedData(const DecodedAvatarData& decoded) {
+    qCDebug(interfaceapp) << "Error: ignoring update for MyAvatar";
 }
 
 void MyAvatar::updateLookAtTargetAvatar() {
@@ -34,6 +34,8 @@ public:
 
     void simulate(float deltaTime, bool fullUpdate = true) override;
     void updateRig(float deltaTime, glm::mat4 parentTransform) override;
+    // poses the head and eyes of another avatar once its rig is evaluated, see Avatar::finishSimulation()
+    void finishUpdateRig();
     void updateAttitude();
 
     /// Returns the index of the left hand joint, or -1 if not found.
@@ -117,6 +119,8 @@ protected:
 private:
 
     bool getEyeModelPositions(glm::vec3& firstEyePosition, glm::vec3& secondEyePosition) const;
+    // where the eyes look, kept far enough from the face that they don't cross
+    glm::vec3 getEyeLookAt() const;
 
     Avatar* _owningAvatar;
 
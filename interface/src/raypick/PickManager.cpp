@@ -0,0 +1,426 @@
+//
+//  PickManager.cpp
+//  interface/src/raypick
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "PickManager.h"
+
+#include <condition_variable>
+#include <limits>
+#include <mutex>
+
+#include <QtCore/QPointer>
+#include <QtCore/QTimer>
+#include <QtScript/QScriptEngine>
+
+#include <EntityTree.h>
+#include <EntityTreeRenderer.h>
+#include <GenericThread.h>
+#include <GeometryUtil.h>
+#include <TriangleSet.h>
+
+#include "Application.h"
+#include "avatar/Avatar.h"
+#include "avatar/AvatarManager.h"
+
+// One frame's picks, and what they're picked against. Avatars are snapshotted on the main thread, which owns them;
+// the entity tree and overlays have locks of their own.
+class PickBatch : public PickQueue::Batch {
+public:
+    struct AvatarSnapshot {
+        QUuid id;
+        glm::vec3 position;
+        glm::vec3 capsuleStart;
+        glm::vec3 capsuleEnd;
+        float capsuleRadius;
+        // the model's (T-pose) meshes, whose triangle sets never change once its geometry is loaded; null until then
+        Geometry::Pointer geometry;
+        glm::mat4 meshToWorld;
+    };
+
+    bool wantsAvatars() const;
+    void clear();
+
+    // on the worker
+    void pick();
+
+    EntityTreePointer entityTree;
+    Overlays* overlays { nullptr };
+    std::vector<AvatarSnapshot> avatars;
+
+private:
+    void pickEntities(const PickQuery& query, PickResult& result);
+    void pickOverlays(const PickQuery& query, PickResult& result);
+    void pickAvatars(const PickQuery& query, PickResult& result);
+};
+
+static bool isCloser(const PickResult& result, float distance) {
+    return result.type == PickResult::NoneType || distance < result.distance;
+}
+
+static bool isFiltered(const QUuid& id, const QVector<QUuid>& include, const QVector<QUuid>& discard) {
+    return (include.size() > 0 && !include.contains(id)) || (discard.size() > 0 && discard.contains(id));
+}
+
+template <typename ID>
+static QVector<ID> toIDs(const QVector<QUuid>& uuids) {
+    QVector<ID> ids;
+    ids.reserve(uuids.size());
+    for (auto& uuid : uuids) {
+        ids.push_back(uuid);
+    }
+    return ids;
+}
+
+bool PickBatch::wantsAvatars() const {
+    for (auto& query : queries) {
+        if (query.flags & PickQuery::PICK_AVATARS) {
+            return true;
+        }
+    }
+    for (auto& query : oneShotQueries) {
+        if (query.flags & PickQuery::PICK_AVATARS) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void PickBatch::clear() {
+    PickQueue::Batch::clear();
+    entityTree.reset();
+    overlays = nullptr;
+    avatars.clear();
+}
+
+static void normalizeRays(std::vector<PickQuery>& queries) {
+    for (auto& query : queries) {
+        if (query.shape == PickQuery::Ray && query.ray.direction != glm::vec3()) {
+            query.ray.direction = glm::normalize(query.ray.direction);
+        }
+    }
+}
+
+void PickBatch::pick() {
+    // a ray's distances to entities, overlays and avatars are all in units of its direction, which is made a unit
+    // vector so they're distances, as the results say
+    normalizeRays(queries);
+    normalizeRays(oneShotQueries);
+    results.assign(size(), PickResult());
+
+    // A few picks share each read lock, rather than each taking its own, but a precise pick, against models'
+    // triangles, takes one to itself, so nothing waiting to edit the tree waits on more than one of them.
+    const size_t MAX_PICKS_PER_LOCK = 16;
+    if (entityTree) {
+        size_t i = 0;
+        while (i < size()) {
+            entityTree->withReadLock([&] {
+                size_t picked = 0;
+                for (; i < size() && picked < MAX_PICKS_PER_LOCK; i++) {
+                    const PickQuery& query = queryAt(i);
+                    if (!(query.flags & PickQuery::PICK_ENTITIES)) {
+                        continue;
+                    }
+                    bool isPrecise = query.shape == PickQuery::Ray && (query.flags & PickQuery::PICK_PRECISE);
+                    if (isPrecise && picked > 0) {
+                        break;
+                    }
+                    pickEntities(query, results[i]);
+                    picked++;
+                    if (isPrecise) {
+                        i++;
+                        break;
+                    }
+                }
+            });
+        }
+    }
+
+    for (size_t i = 0; i < results.size(); i++) {
+        const PickQuery& query = queryAt(i);
+        if (overlays && (query.flags & PickQuery::PICK_OVERLAYS)) {
+            pickOverlays(query, results[i]);
+        }
+        if (query.flags & PickQuery::PICK_AVATARS) {
+            pickAvatars(query, results[i]);
+        }
+    }
+}
+
+void PickBatch::pickEntities(const PickQuery& query, PickResult& result) {
+    bool visibleOnly = query.flags & PickQuery::PICK_VISIBLE_ONLY;
+    bool collidableOnly = query.flags & PickQuery::PICK_COLLIDABLE_ONLY;
+
+    if (query.shape == PickQuery::Ray) {
+        OctreeElementPointer element;
+        EntityItem* entity = nullptr;
+        float distance;
+        BoxFace face;
+        glm::vec3 surfaceNormal;
+        bool accurate = true;
+        // the batch already holds the tree's read lock, which is recursive
+        bool intersects = entityTree->findRayIntersection(query.ray.origin, query.ray.direction,
+            toIDs<EntityItemID>(query.idsToInclude), toIDs<EntityItemID>(query.idsToDiscard), visibleOnly, collidableOnly, query.flags & PickQuery::PICK_PRECISE,
+            element, distance, face, surfaceNormal, (void**)&entity, Octree::Lock, &accurate);
+        if (intersects && entity && isCloser(result, distance)) {
+            result.type = PickResult::EntityType;
+            result.objectID = entity->getEntityItemID();
+            result.distance = distance;
+            result.face = face;
+            result.intersection = query.ray.origin + query.ray.direction * distance;
+            result.surfaceNormal = surfaceNormal;
+            result.accurate = accurate;
+        }
+        return;
+    }
+
+    QVector<EntityItemPointer> entities;
+    entityTree->findEntities(query.center, query.radius, entities);
+    for (auto& entity : entities) {
+        if (isFiltered(entity->getEntityItemID(), query.idsToInclude, query.idsToDiscard) ||
+            (visibleOnly && !entity->getVisible()) || (collidableOnly && entity->getCollisionless())) {
+            continue;
+        }
+        glm::vec3 position = entity->getPosition();
+        float distance = glm::distance(query.center, position);
+        if (isCloser(result, distance)) {
+            result.type = PickResult::EntityType;
+            result.objectID = entity->getEntityItemID();
+            result.distance = distance;
+            result.face = UNKNOWN_FACE;
+            result.intersection = position;
+            result.surfaceNormal = glm::vec3();
+            result.accurate = true;
+        }
+    }
+}
+
+void PickBatch::pickOverlays(const PickQuery& query, PickResult& result) {
+    bool visibleOnly = query.flags & PickQuery::PICK_VISIBLE_ONLY;
+    bool collidableOnly = query.flags & PickQuery::PICK_COLLIDABLE_ONLY;
+    QVector<OverlayID> overlaysToInclude = toIDs<OverlayID>(query.idsToInclude);
+    QVector<OverlayID> overlaysToDiscard = toIDs<OverlayID>(query.idsToDiscard);
+
+    RayToOverlayIntersectionResult overlayResult;
+    if (query.shape == PickQuery::Ray) {
+        overlayResult = overlays->findRayIntersectionVector(query.ray, query.flags & PickQuery::PICK_PRECISE,
+            overlaysToInclude, overlaysToDiscard, visibleOnly, collidableOnly);
+    } else {
+        overlayResult = overlays->findNearestOverlay(query.center, query.radius,
+            overlaysToInclude, overlaysToDiscard, visibleOnly, collidableOnly);
+    }
+    if (overlayResult.intersects && isCloser(result, overlayResult.distance)) {
+        result.type = PickResult::OverlayType;
+        result.objectID = overlayResult.overlayID;
+        result.distance = overlayResult.distance;
+        result.face = overlayResult.face;
+        result.intersection = overlayResult.intersection;
+        result.surfaceNormal = overlayResult.surfaceNormal;
+        result.accurate = true;
+    }
+}
+
+void PickBatch::pickAvatars(const PickQuery& query, PickResult& result) {
+    for (auto& avatar : avatars) {
+        if (isFiltered(avatar.id, query.idsToInclude, query.idsToDiscard)) {
+            continue;
+        }
+
+        if (query.shape == PickQuery::Sphere) {
+            // touching the capsule, the segment's nearest point within both radii
+            glm::vec3 axis = avatar.capsuleEnd - avatar.capsuleStart;
+            float axisLength2 = glm::dot(axis, axis);
+            float t = axisLength2 > 0.0f ?
+                glm::clamp(glm::dot(query.center - avatar.capsuleStart, axis) / axisLength2, 0.0f, 1.0f) : 0.0f;
+            glm::vec3 nearest = avatar.capsuleStart + t * axis;
+            if (glm::distance(query.center, nearest) > query.radius + avatar.capsuleRadius) {
+                continue;
+            }
+            float distance = glm::distance(query.center, avatar.position);
+            if (isCloser(result, distance)) {
+                result.type = PickResult::AvatarType;
+                result.objectID = avatar.id;
+                result.distance = distance;
+                result.face = UNKNOWN_FACE;
+                result.intersection = avatar.position;
+                result.surfaceNormal = glm::vec3();
+                result.accurate = true;
+            }
+            continue;
+        }
+
+        // as AvatarManager::findRayIntersection: the capsule first, then the model's (T-pose) meshes, which are
+        // picked against in their own frame, as Model::findRayIntersectionAgainstSubMeshes does
+        float distance;
+        if (!avatar.geometry || !findRayCapsuleIntersection(query.ray.origin, query.ray.direction,
+                                                            avatar.capsuleStart, avatar.capsuleEnd,
+                                                            avatar.capsuleRadius, distance)) {
+            continue;
+        }
+        glm::mat4 worldToMeshMatrix = glm::inverse(avatar.meshToWorld);
+        glm::vec3 meshFrameOrigin = glm::vec3(worldToMeshMatrix * glm::vec4(query.ray.origin, 1.0f));
+        glm::vec3 meshFrameDirection = glm::vec3(worldToMeshMatrix * glm::vec4(query.ray.direction, 0.0f));
+
+        distance = std::numeric_limits<float>::max();
+        bool intersects = false;
+        Triangle nearest;
+        for (auto& triangleSet : avatar.geometry->getFBXGeometry().meshTriangleSets) {
+            Triangle triangle;
+            if (triangleSet.findRayIntersection(meshFrameOrigin, meshFrameDirection, distance, triangle)) {
+                intersects = true;
+                nearest = triangle;
+            }
+        }
+        if (intersects && isCloser(result, distance)) {
+            glm::mat3 normalMatrix = glm::transpose(glm::mat3(worldToMeshMatrix));
+            result.type = PickResult::AvatarType;
+            result.objectID = avatar.id;
+            result.distance = distance;
+            result.face = UNKNOWN_FACE;
+            result.intersection = query.ray.origin + query.ray.direction * distance;
+            result.surfaceNormal = glm::normalize(normalMatrix * nearest.getNormal());
+            result.accurate = true;
+        }
+    }
+}
+
+// Picks one batch at a time, handed over and taken back by the main thread.
+class PickThread : public GenericThread {
+public:
+    bool isIdle() {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return !_toPick && !_picking && !_picked;
+    }
+
+    void pick(std::unique_ptr<PickBatch> batch) {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _toPick = std::move(batch);
+        }
+        _condition.notify_one();
+    }
+
+    // null until the batch handed over has been picked
+    std::unique_ptr<PickBatch> takePicked() {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return std::move(_picked);
+    }
+
+protected:
+    bool process() override {
+        std::unique_ptr<PickBatch> batch;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _condition.wait(lock, [&] { return _toPick || !isStillRunning(); });
+            if (!isStillRunning()) {
+                return false;
+            }
+            batch = std::move(_toPick);
+            _picking = true;
+        }
+
+        batch->pick();
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        _picked = std::move(batch);
+        _picking = false;
+        return true;
+    }
+
+    void terminating() override {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _condition.notify_all();
+    }
+
+private:
+    std::mutex _mutex;
+    std::condition_variable _condition;
+    std::unique_ptr<PickBatch> _toPick;
+    std::unique_ptr<PickBatch> _picked;
+    bool _picking { false };
+};
+
+PickManager::~PickManager() {
+    shutdown();
+}
+
+void PickManager::shutdown() {
+    if (_thread) {
+        _thread->terminate();
+        _thread.reset();
+    }
+    _shutDown = true;
+}
+
+void PickManager::update() {
+    if (_shutDown) {
+        return;
+    }
+    if (!_thread) {
+        _thread.reset(new PickThread());
+        _thread->initialize(true, QThread::HighPriority);
+    }
+
+    if (auto picked = _thread->takePicked()) {
+        _queue.setResults(*picked);
+        picked->clear();
+        _batch = std::move(picked);
+    }
+
+    if (!_thread->isIdle()) {
+        return;
+    }
+
+    if (!_batch) {
+        _batch.reset(new PickBatch());
+    }
+    _queue.takeQueries(*_batch);
+    if (_batch->isEmpty()) {
+        return;
+    }
+
+    _batch->entityTree = qApp->getEntities()->getTree();
+    _batch->overlays = &qApp->getOverlays();
+    if (_batch->wantsAvatars()) {
+        for (auto& avatarData : DependencyManager::get<AvatarManager>()->getHashCopy()) {
+            auto avatar = std::static_pointer_cast<Avatar>(avatarData);
+            PickBatch::AvatarSnapshot snapshot;
+            snapshot.id = avatar->getID();
+            snapshot.position = avatar->getPosition();
+            avatar->getCapsule(snapshot.capsuleStart, snapshot.capsuleEnd, snapshot.capsuleRadius);
+            // the model itself is only ever used on this thread
+            auto model = avatar->getSkeletonModel();
+            if (model && model->isActive()) {
+                snapshot.geometry = model->getGeometry();
+                snapshot.meshToWorld = model->getMeshToWorldMatrix();
+            }
+            _batch->avatars.push_back(snapshot);
+        }
+    }
+    _thread->pick(std::move(_batch));
+}
+
+void PickManager::pickAsync(const QVariantMap& properties, QScriptValue callback) {
+    if (!callback.isFunction()) {
+        return;
+    }
+    // the script value is only ever called, and released, on its engine's thread
+    auto sharedCallback = std::make_shared<QScriptValue>(callback);
+    QPointer<QScriptEngine> engine = callback.engine();
+    pickOnce(PickQuery::fromVariantMap(properties), [sharedCallback, engine](const PickResult& result) mutable {
+        std::shared_ptr<QScriptValue> callback;
+        callback.swap(sharedCallback);
+        if (!engine) {
+            return; // the script has stopped
+        }
+        QVariantMap map = result.toVariantMap();
+        QTimer::singleShot(0, engine, [callback, map] {
+            callback->call(QScriptValue(), QScriptValueList { callback->engine()->toScriptValue(map) });
+        });
+    });
+}
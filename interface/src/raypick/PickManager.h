@@ -0,0 +1,103 @@
+//
+//  PickManager.h
+//  interface/src/raypick
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_PickManager_h
+#define hifi_PickManager_h
+
+#include <memory>
+
+#include <QtCore/QObject>
+#include <QtCore/QVariantMap>
+#include <QtScript/QScriptValue>
+
+#include <DependencyManager.h>
+#include <PickQueue.h>
+
+class PickBatch;
+class PickThread;
+
+// Picks against entities, overlays and avatars on a worker thread, in one batch a frame, so the threads asking never
+// wait on the entity tree's lock. A pick is either kept, with its latest result read whenever it's wanted, or run
+// once, with its result handed to a callback. Results arrive the frame after the batch they were in.
+class PickManager : public QObject, public Dependency {
+    Q_OBJECT
+    SINGLETON_DEPENDENCY
+
+public:
+    using Callback = PickQueue::Callback;
+
+    ~PickManager();
+
+    // on the main thread, once a frame
+    void update();
+    // stops the worker, before the things it picks against go
+    void shutdown();
+
+    unsigned int addPick(const PickQuery& query) { return _queue.addPick(query); }
+    void editPick(unsigned int pickID, const PickQuery& query) { _queue.editPick(pickID, query); }
+    void removePick(unsigned int pickID) { _queue.removePick(pickID); }
+    PickResult getPickResult(unsigned int pickID) const { return _queue.getPickResult(pickID); }
+
+    // the callback is called on the main thread
+    void pickOnce(const PickQuery& query, Callback callback) { _queue.pickOnce(query, callback); }
+
+    /**jsdoc
+     * Adds a pick that is run every frame until it's removed. Its properties are a type, "ray" or "sphere";
+     * an origin and direction or a center and radius; what to pick, with booleans entities, overlays and
+     * avatars, precise, visibleOnly and collidableOnly; and arrays of IDs to include and to ignore.
+     *
+     * @function Picks.createPick
+     * @param {Object} properties
+     * @return {number} The ID of the pick.
+     */
+    Q_INVOKABLE unsigned int createPick(const QVariantMap& properties) { return addPick(PickQuery::fromVariantMap(properties)); }
+
+    /**jsdoc
+     * @function Picks.editPick
+     * @param {number} id
+     * @param {Object} properties The pick's new properties, as for createPick.
+     */
+    Q_INVOKABLE void editPick(unsigned int id, const QVariantMap& properties) { editPick(id, PickQuery::fromVariantMap(properties)); }
+
+    /**jsdoc
+     * @function Picks.deletePick
+     * @param {number} id
+     */
+    Q_INVOKABLE void deletePick(unsigned int id) { removePick(id); }
+
+    /**jsdoc
+     * The result of the pick the last time it was run. This never waits.
+     *
+     * @function Picks.getPrevPickResult
+     * @param {number} id
+     * @return {Object} type ("none", "entity", "overlay" or "avatar"), objectID, distance, face, intersection,
+     *     surfaceNormal and accurate.
+     */
+    Q_INVOKABLE QVariantMap getPrevPickResult(unsigned int id) const { return getPickResult(id).toVariantMap(); }
+
+    /**jsdoc
+     * Runs a pick in the next batch and calls back with its result, on the script's thread.
+     *
+     * @function Picks.pickAsync
+     * @param {Object} properties As for createPick.
+     * @param {function} callback Called with the result, as getPrevPickResult returns it.
+     */
+    Q_INVOKABLE void pickAsync(const QVariantMap& properties, QScriptValue callback);
+
+private:
+    PickQueue _queue; // the picks are added to and read from any thread
+
+    // main thread only
+    std::unique_ptr<PickBatch> _batch; // while it's not being picked
+    std::unique_ptr<PickThread> _thread;
+    bool _shutDown { false };
+};
+
+#endif // hifi_PickManager_h
@@ -21,6 +21,7 @@
 #include <AudioClient.h>
 #include <GeometryCache.h>
 #include <LODManager.h>
+#include <ObjectMotionState.h>
 #include <OffscreenUi.h>
 #include <PerfStat.h>
 #include <plugins/DisplayPlugin.h>
@@ -309,6 +310,13 @@ void Stats::updateStats(bool force) {
     STAT_UPDATE(gpuFrameTime, (float)gpuContext->getFrameTimerGPUAverage());
     STAT_UPDATE(batchFrameTime, (float)gpuContext->getFrameTimerBatchAverage());
     STAT_UPDATE(avatarSimulationTime, (float)avatarManager->getAvatarSimulationTime());
+
+    // collision hulls and meshes
+    ShapeManager* shapeManager = ObjectMotionState::getShapeManager();
+    STAT_UPDATE(shapeBuildTime, shapeManager->getAverageBuildTime());
+    STAT_UPDATE(shapesPending, shapeManager->getNumPendingShapes());
+    STAT_UPDATE(shapesBuilt, (int)shapeManager->getNumShapesBuilt());
+    STAT_UPDATE(shapeCacheHits, (int)shapeManager->getNumCacheHits());
     
 
     STAT_UPDATE(gpuBuffers, (int)gpu::Context::getBufferGPUCount());
@@ -382,7 +390,7 @@ void Stats::updateStats(bool force) {
         // a new Map sorted by average time...
         bool onlyDisplayTopTen = Menu::getInstance()->isOptionChecked(MenuOption::OnlyDisplayTopTen);
         QMap<float, QString> sortedRecords;
-        const QMap<QString, PerformanceTimerRecord>& allRecords = PerformanceTimer::getAllTimerRecords();
+        const QMap<QString, PerformanceTimerRecord> allRecords = PerformanceTimer::getAllTimerRecords();
         QMapIterator<QString, PerformanceTimerRecord> i(allRecords);
 
         while (i.hasNext()) {
@@ -402,9 +410,11 @@ void Stats::updateStats(bool force) {
             static const QChar noBreakingSpace = QChar::Nbsp;
             QString functionName = j.value();
             const PerformanceTimerRecord& record = allRecords.value(functionName);
-            perfLines += QString("%1: %2 [%3]\n").
+            perfLines += QString("%1: %2 p95 %3 p99 %4 [%5]\n").
                 arg(QString(qPrintable(functionName)), -80, noBreakingSpace).
                 arg((float)record.getMovingAverage() / (float)USECS_PER_MSEC, 8, 'f', 3, noBreakingSpace).
+                arg((float)record.getPercentile(95.0f) / (float)USECS_PER_MSEC, 8, 'f', 3, noBreakingSpace).
+                arg((float)record.getPercentile(99.0f) / (float)USECS_PER_MSEC, 8, 'f', 3, noBreakingSpace).
                 arg((int)record.getCount(), 6, 10, noBreakingSpace);
             linesDisplayed++;
             if (onlyDisplayTopTen && linesDisplayed == 10) {
@@ -419,6 +429,22 @@ void Stats::updateStats(bool force) {
     }
 }
 
+QVariantMap Stats::getTimingRecords() const {
+    QVariantMap result;
+    const QMap<QString, PerformanceTimerRecord> allRecords = PerformanceTimer::getAllTimerRecords();
+    for (auto it = allRecords.begin(); it != allRecords.end(); ++it) {
+        const PerformanceTimerRecord& record = it.value();
+        QVariantMap timing;
+        timing["average"] = (float)record.getMovingAverage() / (float)USECS_PER_MSEC;
+        timing["p50"] = (float)record.getPercentile(50.0f) / (float)USECS_PER_MSEC;
+        timing["p95"] = (float)record.getPercentile(95.0f) / (float)USECS_PER_MSEC;
+        timing["p99"] = (float)record.getPercentile(99.0f) / (float)USECS_PER_MSEC;
+        timing["count"] = (int)record.getCount();
+        result[it.key()] = timing;
+    }
+    return result;
+}
+
 void Stats::setRenderDetails(const RenderDetails& details) {
     STAT_UPDATE(triangles, details._trianglesRendered);
     STAT_UPDATE(materialSwitches, details._materialSwitches);
@@ -114,6 +114,10 @@ class Stats : public QQuickItem {
     STATS_PROPERTY(float, gpuFrameTime, 0)
     STATS_PROPERTY(float, batchFrameTime, 0)
     STATS_PROPERTY(float, avatarSimulationTime, 0)
+    STATS_PROPERTY(float, shapeBuildTime, 0)
+    STATS_PROPERTY(int, shapesPending, 0)
+    STATS_PROPERTY(int, shapesBuilt, 0)
+    STATS_PROPERTY(int, shapeCacheHits, 0)
 
 public:
     static Stats* getInstance();
@@ -127,6 +131,9 @@ public:
 
     void updateStats(bool force = false);
 
+    // per frame times in ms of every PerformanceTimer scope, by full name, while timing details are shown
+    Q_INVOKABLE QVariantMap getTimingRecords() const;
+
     bool isExpanded() { return _expanded; }
     bool isTimingExpanded() { return _timingExpanded; }
 
@@ -222,6 +229,10 @@ signals:
     void gpuFrameTimeChanged();
     void batchFrameTimeChanged();
     void avatarSimulationTimeChanged();
+    void shapeBuildTimeChanged();
+    void shapesPendingChanged();
+    void shapesBuiltChanged();
+    void shapeCacheHitsChanged();
     void rectifiedTextureCountChanged();
     void decimatedTextureCountChanged();
 
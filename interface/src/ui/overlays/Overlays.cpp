@@ -403,6 +403,15 @@ RayToOverlayIntersectionResult Overlays::findRayIntersection(const PickRay& ray,
                                        overlaysToInclude, overlaysToDiscard, visibleOnly, collidableOnly);
 }
 
+RayToOverlayIntersectionResult Overlays::findRayIntersectionVector(const PickRay& ray, bool precisionPicking,
+                                                                   const QVector<OverlayID>& overlaysToInclude,
+                                                                   const QVector<OverlayID>& overlaysToDiscard,
+                                                                   bool visibleOnly, bool collidableOnly) {
+    QReadLocker lock(&_lock);
+    return findRayIntersectionInternal(ray, precisionPicking,
+                                       overlaysToInclude, overlaysToDiscard, visibleOnly, collidableOnly);
+}
+
 
 RayToOverlayIntersectionResult Overlays::findRayIntersectionInternal(const PickRay& ray, bool precisionPicking,
                                                                      const QVector<OverlayID>& overlaysToInclude,
@@ -750,7 +759,7 @@ RayToOverlayIntersectionResult Overlays::findRayIntersectionForMouseEvent(PickRa
 }
 
 bool Overlays::mousePressEvent(QMouseEvent* event) {
-    PerformanceTimer perfTimer("Overlays::mousePressEvent");
+    PERFORMANCE_TIMER("Overlays::mousePressEvent");
 
     PickRay ray = qApp->computePickRay(event->x(), event->y());
     RayToOverlayIntersectionResult rayPickResult = findRayIntersectionForMouseEvent(ray);
@@ -770,7 +779,7 @@ bool Overlays::mousePressEvent(QMouseEvent* event) {
 }
 
 bool Overlays::mouseReleaseEvent(QMouseEvent* event) {
-    PerformanceTimer perfTimer("Overlays::mouseReleaseEvent");
+    PERFORMANCE_TIMER("Overlays::mouseReleaseEvent");
 
     PickRay ray = qApp->computePickRay(event->x(), event->y());
     RayToOverlayIntersectionResult rayPickResult = findRayIntersectionForMouseEvent(ray);
@@ -789,7 +798,7 @@ bool Overlays::mouseReleaseEvent(QMouseEvent* event) {
 }
 
 bool Overlays::mouseMoveEvent(QMouseEvent* event) {
-    PerformanceTimer perfTimer("Overlays::mouseMoveEvent");
+    PERFORMANCE_TIMER("Overlays::mouseMoveEvent");
 
     PickRay ray = qApp->computePickRay(event->x(), event->y());
     RayToOverlayIntersectionResult rayPickResult = findRayIntersectionForMouseEvent(ray);
@@ -836,6 +845,42 @@ bool Overlays::mouseMoveEvent(QMouseEvent* event) {
 }
 
 QVector<QUuid> Overlays::findOverlays(const glm::vec3& center, float radius) const {
+    QReadLocker lock(&_lock);
+    return findOverlaysInternal(center, radius);
+}
+
+RayToOverlayIntersectionResult Overlays::findNearestOverlay(const glm::vec3& center, float radius,
+                                                            const QVector<OverlayID>& overlaysToInclude,
+                                                            const QVector<OverlayID>& overlaysToDiscard,
+                                                            bool visibleOnly, bool collidableOnly) const {
+    RayToOverlayIntersectionResult result;
+
+    QReadLocker lock(&_lock);
+    for (const auto& id : findOverlaysInternal(center, radius)) {
+        OverlayID thisID = id;
+        if ((overlaysToDiscard.size() > 0 && overlaysToDiscard.contains(thisID)) ||
+            (overlaysToInclude.size() > 0 && !overlaysToInclude.contains(thisID))) {
+            continue;
+        }
+
+        // findOverlaysInternal only finds volume overlays
+        auto overlay = std::static_pointer_cast<Base3DOverlay>(_overlaysWorld.value(thisID));
+        if ((visibleOnly && !overlay->getVisible()) || (collidableOnly && overlay->getIgnoreRayIntersection())) {
+            continue;
+        }
+        glm::vec3 position = overlay->getPosition();
+        float distance = glm::distance(center, position);
+        if (!result.intersects || distance < result.distance) {
+            result.intersects = true;
+            result.overlayID = thisID;
+            result.distance = distance;
+            result.intersection = position;
+        }
+    }
+    return result;
+}
+
+QVector<QUuid> Overlays::findOverlaysInternal(const glm::vec3& center, float radius) const {
     QVector<QUuid> result;
 
     QMapIterator<OverlayID, Overlay::Pointer> i(_overlaysWorld);
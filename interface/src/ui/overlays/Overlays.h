@@ -106,6 +106,20 @@ public:
 
     void cleanupAllOverlays();
 
+    /// Like findRayIntersection, for C++ callers. It locks the overlays, so can be called from any thread.
+    RayToOverlayIntersectionResult findRayIntersectionVector(const PickRay& ray, bool precisionPicking,
+                                                             const QVector<OverlayID>& overlaysToInclude,
+                                                             const QVector<OverlayID>& overlaysToDiscard,
+                                                             bool visibleOnly = false, bool collidableOnly = false);
+
+    /// The nearest of the overlays findOverlays finds, by the distance from center to the overlay's position.
+    /// It locks the overlays, so can be called from any thread. With visibleOnly, it skips hidden overlays, and with
+    /// collidableOnly, overlays that ignore picks.
+    RayToOverlayIntersectionResult findNearestOverlay(const glm::vec3& center, float radius,
+                                                      const QVector<OverlayID>& overlaysToInclude,
+                                                      const QVector<OverlayID>& overlaysToDiscard,
+                                                      bool visibleOnly = false, bool collidableOnly = false) const;
+
 public slots:
     /**jsdoc
      * Add an overlays to the scene. The properties specified will depend
@@ -317,7 +331,7 @@ private:
     QList<Overlay::Pointer> _overlaysToDelete;
     unsigned int _stackOrder { 1 };
 
-    QReadWriteLock _lock;
+    mutable QReadWriteLock _lock;
     QReadWriteLock _deleteLock;
     QScriptEngine* _scriptEngine;
     bool _enabled = true;
@@ -333,6 +347,7 @@ private:
                                                                const QVector<OverlayID>& overlaysToDiscard,
                                                                bool visibleOnly = false, bool collidableOnly = false);
     RayToOverlayIntersectionResult findRayIntersectionForMouseEvent(PickRay ray);
+    QVector<QUuid> findOverlaysInternal(const glm::vec3& center, float radius) const;
 };
 
 #endif // hifi_Overlays_h
@@ -13,6 +13,7 @@
 
 #include <string>
 #include "AnimationCache.h"
+#include "AnimClipData.h"
 #include "AnimNode.h"
 
 // Playback a single animation timeline.
@@ -59,6 +60,7 @@ protected:
     virtual void setCurrentFrameInternal(float frame) override;
 
     void copyFromNetworkAnim();
+    std::vector<AnimPoseVec> retargetNetworkAnim() const;
     void buildMirrorAnim();
 
     // for AnimDebugDraw rendering
@@ -67,9 +69,9 @@ protected:
     AnimationPointer _networkAnim;
     AnimPoseVec _poses;
 
-    // _anim[frame][joint]
-    std::vector<AnimPoseVec> _anim;
-    std::vector<AnimPoseVec> _mirrorAnim;
+    // retargeted frames, shared with other clips playing the same url on the same skeleton
+    AnimClipData::Pointer _anim;
+    AnimClipData::Pointer _mirrorAnim;
 
     QString _url;
     float _startFrame;
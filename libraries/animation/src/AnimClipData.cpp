@@ -0,0 +1,278 @@
+//
+//  AnimClipData.cpp
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AnimClipData.h"
+
+#include <mutex>
+
+#include <QCryptographicHash>
+#include <QHash>
+
+#include <GLMHelpers.h>
+
+#include "AnimSkeleton.h"
+
+static const float CONSTANT_SCALE_EPSILON = 0.00001f;
+static const float CONSTANT_ROT_EPSILON = 0.0000001f;   // 1 - |dot|
+static const float CONSTANT_TRANS_EPSILON = 0.0001f;
+
+static const float QUAT_COMPONENT_RANGE = 0.70710678f;  // smallest three are within +/- 1/sqrt(2)
+static const float QUAT_QUANTA = 32767.0f;                          // 15 bits per component
+static const uint16_t QUAT_INDEX_BIT = 0x8000;
+static const float TRANS_QUANTA = 65535.0f;
+
+static std::mutex cacheMutex;
+static QHash<QString, std::weak_ptr<const AnimClipData>> cache;
+
+// smallest three quaternion encoding. The index of the dropped (largest) component is
+// stored in the top bits of the first two words.
+static void packQuat(const glm::quat& q, uint16_t* out) {
+    int largest = 0;
+    for (int i = 1; i < 4; i++) {
+        if (fabsf(q[i]) > fabsf(q[largest])) {
+            largest = i;
+        }
+    }
+    float sign = q[largest] < 0.0f ? -1.0f : 1.0f;
+
+    int k = 0;
+    for (int i = 0; i < 4; i++) {
+        if (i != largest) {
+            float normalized = glm::clamp((sign * q[i] / QUAT_COMPONENT_RANGE) * 0.5f + 0.5f, 0.0f, 1.0f);
+            out[k++] = (uint16_t)(normalized * QUAT_QUANTA + 0.5f);
+        }
+    }
+    out[0] |= (largest & 1) ? QUAT_INDEX_BIT : 0;
+    out[1] |= (largest & 2) ? QUAT_INDEX_BIT : 0;
+}
+
+static glm::quat unpackQuat(const uint16_t* in) {
+    int largest = ((in[0] & QUAT_INDEX_BIT) ? 1 : 0) | ((in[1] & QUAT_INDEX_BIT) ? 2 : 0);
+
+    glm::quat result;
+    float sumSquares = 0.0f;
+    int k = 0;
+    for (int i = 0; i < 4; i++) {
+        if (i != largest) {
+            float value = ((float)(in[k++] & ~QUAT_INDEX_BIT) / QUAT_QUANTA * 2.0f - 1.0f) * QUAT_COMPONENT_RANGE;
+            result[i] = value;
+            sumSquares += value * value;
+        }
+    }
+    result[largest] = sqrtf(std::max(1.0f - sumSquares, 0.0f));
+    return result;
+}
+
+AnimClipData::AnimClipData(const std::vector<AnimPoseVec>& frames) {
+    _frameCount = (int)frames.size();
+    if (_frameCount == 0) {
+        return;
+    }
+
+    const int jointCount = (int)frames[0].size();
+    _tracks.resize(jointCount);
+
+    // find constant tracks
+    for (int joint = 0; joint < jointCount; joint++) {
+        Track& track = _tracks[joint];
+        const AnimPose& first = frames[0][joint];
+        track.constant = first;
+
+        bool constantScale = true;
+        bool constantRot = true;
+        bool constantTrans = true;
+        glm::vec3 transMin = first.trans();
+        glm::vec3 transMax = first.trans();
+        for (int frame = 1; frame < _frameCount; frame++) {
+            const AnimPose& pose = frames[frame][joint];
+            constantScale = constantScale && glm::all(glm::lessThan(glm::abs(pose.scale() - first.scale()), glm::vec3(CONSTANT_SCALE_EPSILON)));
+            constantRot = constantRot && (1.0f - fabsf(glm::dot(pose.rot(), first.rot())) < CONSTANT_ROT_EPSILON);
+            constantTrans = constantTrans && glm::all(glm::lessThan(glm::abs(pose.trans() - first.trans()), glm::vec3(CONSTANT_TRANS_EPSILON)));
+            transMin = glm::min(transMin, pose.trans());
+            transMax = glm::max(transMax, pose.trans());
+        }
+
+        if (!constantScale) {
+            track.scaleIndex = _numScales++;
+        }
+        if (!constantRot) {
+            track.rotIndex = _numRots++;
+        }
+        if (!constantTrans) {
+            track.transIndex = _numTranses++;
+            track.transMin = transMin;
+            track.transExtent = transMax - transMin;
+        }
+    }
+
+    // quantize animated tracks, frame by frame
+    _scales.resize(_frameCount * _numScales);
+    _rots.resize(_frameCount * _numRots * 3);
+    _transes.resize(_frameCount * _numTranses * 3);
+    for (int frame = 0; frame < _frameCount; frame++) {
+        for (int joint = 0; joint < jointCount; joint++) {
+            const Track& track = _tracks[joint];
+            const AnimPose& pose = frames[frame][joint];
+            if (track.scaleIndex >= 0) {
+                _scales[frame * _numScales + track.scaleIndex] = pose.scale();
+            }
+            if (track.rotIndex >= 0) {
+                packQuat(glm::normalize(pose.rot()), &_rots[(frame * _numRots + track.rotIndex) * 3]);
+            }
+            if (track.transIndex >= 0) {
+                uint16_t* out = &_transes[(frame * _numTranses + track.transIndex) * 3];
+                for (int i = 0; i < 3; i++) {
+                    float normalized = track.transExtent[i] > 0.0f ? (pose.trans()[i] - track.transMin[i]) / track.transExtent[i] : 0.0f;
+                    out[i] = (uint16_t)(glm::clamp(normalized, 0.0f, 1.0f) * TRANS_QUANTA + 0.5f);
+                }
+            }
+        }
+    }
+}
+
+AnimClipData::Pointer AnimClipData::getOrCreate(const QString& key, const Builder& builder) {
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        auto iter = cache.find(key);
+        if (iter != cache.end()) {
+            if (auto clip = iter.value().lock()) {
+                return clip;
+            }
+        }
+    }
+
+    // build outside of the lock, retargeting a long clip can take a while.
+    Pointer clip = std::make_shared<const AnimClipData>(builder());
+
+    std::lock_guard<std::mutex> lock(cacheMutex);
+
+    // another thread may have built the same clip in the meantime.
+    auto existing = cache.value(key).lock();
+    if (existing) {
+        return existing;
+    }
+
+    // drop expired entries
+    for (auto iter = cache.begin(); iter != cache.end();) {
+        if (iter.value().expired()) {
+            iter = cache.erase(iter);
+        } else {
+            ++iter;
+        }
+    }
+
+    cache.insert(key, clip);
+    return clip;
+}
+
+QString AnimClipData::makeKey(const QString& url, const AnimSkeleton& skeleton, bool usePreAndPostPose, bool mirrored) {
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    auto addPose = [&](const AnimPose& pose) {
+        hash.addData((const char*)&pose.scale(), sizeof(glm::vec3));
+        hash.addData((const char*)&pose.rot(), sizeof(glm::quat));
+        hash.addData((const char*)&pose.trans(), sizeof(glm::vec3));
+    };
+
+    int jointCount = skeleton.getNumJoints();
+    hash.addData((const char*)&jointCount, sizeof(jointCount));
+    for (int i = 0; i < jointCount; i++) {
+        int parentIndex = skeleton.getParentIndex(i);
+        hash.addData(skeleton.getJointName(i).toUtf8());
+        hash.addData((const char*)&parentIndex, sizeof(parentIndex));
+        addPose(skeleton.getRelativeDefaultPose(i));
+        addPose(skeleton.getRelativeBindPose(i));
+    }
+
+    return url + "#" + hash.result().toHex() + (usePreAndPostPose ? "" : "-bind") + (mirrored ? "-mirror" : "");
+}
+
+int AnimClipData::getCacheSize() {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    int count = 0;
+    for (auto& entry : cache) {
+        if (!entry.expired()) {
+            count++;
+        }
+    }
+    return count;
+}
+
+size_t AnimClipData::getMemorySize() const {
+    return sizeof(AnimClipData) +
+        _tracks.size() * sizeof(Track) +
+        _scales.size() * sizeof(glm::vec3) +
+        _rots.size() * sizeof(uint16_t) +
+        _transes.size() * sizeof(uint16_t);
+}
+
+glm::vec3 AnimClipData::decodeScale(int frame, const Track& track) const {
+    if (track.scaleIndex < 0) {
+        return track.constant.scale();
+    }
+    return _scales[frame * _numScales + track.scaleIndex];
+}
+
+glm::quat AnimClipData::decodeRot(int frame, const Track& track) const {
+    if (track.rotIndex < 0) {
+        return track.constant.rot();
+    }
+    return unpackQuat(&_rots[(frame * _numRots + track.rotIndex) * 3]);
+}
+
+glm::vec3 AnimClipData::decodeTrans(int frame, const Track& track) const {
+    if (track.transIndex < 0) {
+        return track.constant.trans();
+    }
+    const uint16_t* in = &_transes[(frame * _numTranses + track.transIndex) * 3];
+    glm::vec3 normalized((float)in[0], (float)in[1], (float)in[2]);
+    return track.transMin + (normalized / TRANS_QUANTA) * track.transExtent;
+}
+
+void AnimClipData::sample(int frame, AnimPose* posesOut) const {
+    assert(frame >= 0 && frame < _frameCount);
+    for (size_t i = 0; i < _tracks.size(); i++) {
+        const Track& track = _tracks[i];
+        posesOut[i].scale() = decodeScale(frame, track);
+        posesOut[i].rot() = decodeRot(frame, track);
+        posesOut[i].trans() = decodeTrans(frame, track);
+    }
+}
+
+void AnimClipData::sample(int prevFrame, int nextFrame, float alpha, AnimPose* posesOut) const {
+    assert(prevFrame >= 0 && prevFrame < _frameCount);
+    assert(nextFrame >= 0 && nextFrame < _frameCount);
+    for (size_t i = 0; i < _tracks.size(); i++) {
+        const Track& track = _tracks[i];
+        AnimPose& result = posesOut[i];
+
+        if (track.scaleIndex < 0) {
+            result.scale() = track.constant.scale();
+        } else {
+            result.scale() = lerp(decodeScale(prevFrame, track), decodeScale(nextFrame, track), alpha);
+        }
+
+        if (track.rotIndex < 0) {
+            result.rot() = track.constant.rot();
+        } else {
+            // adjust signs if necessary
+            glm::quat q1 = decodeRot(prevFrame, track);
+            glm::quat q2 = decodeRot(nextFrame, track);
+            if (glm::dot(q1, q2) < 0.0f) {
+                q2 = -q2;
+            }
+            result.rot() = glm::normalize(glm::lerp(q1, q2, alpha));
+        }
+
+        if (track.transIndex < 0) {
+            result.trans() = track.constant.trans();
+        } else {
+            result.trans() = lerp(decodeTrans(prevFrame, track), decodeTrans(nextFrame, track), alpha);
+        }
+    }
+}
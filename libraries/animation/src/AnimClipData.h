@@ -0,0 +1,98 @@
+//
+//  AnimClipData.h
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AnimClipData_h
+#define hifi_AnimClipData_h
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include <QString>
+
+#include "AnimPose.h"
+
+class AnimSkeleton;
+
+// Retargeted animation frames, stored compressed and shared between all AnimClip nodes
+// that play the same url on equivalent skeletons.
+//
+// Each joint has a scale, rotation and translation track. Tracks that don't change over the clip
+// are stored once. Animated rotations are quantized to 48 bits (smallest three components),
+// animated translations to 16 bits per axis over the range of the track.
+// Animated tracks are stored frame by frame, so sampling a frame walks memory linearly.
+
+class AnimClipData {
+public:
+    using Pointer = std::shared_ptr<const AnimClipData>;
+    using Builder = std::function<std::vector<AnimPoseVec>()>;
+
+    // frames[frame][joint], every frame must have the same number of joints.
+    explicit AnimClipData(const std::vector<AnimPoseVec>& frames);
+
+    // Returns the cached clip for key, or builds, compresses and caches a new one.
+    // Entries live as long as some AnimClip holds on to them.
+    static Pointer getOrCreate(const QString& key, const Builder& builder);
+
+    // Cache key for url retargeted onto skeleton, optionally mirrored.
+    // Skeletons with the same joints, hierarchy and default/bind poses share the same key.
+    static QString makeKey(const QString& url, const AnimSkeleton& skeleton, bool usePreAndPostPose, bool mirrored);
+
+    // number of live clips in the cache
+    static int getCacheSize();
+
+    int getFrameCount() const { return _frameCount; }
+    int getJointCount() const { return (int)_tracks.size(); }
+
+    // approximate heap usage, for stats and tests
+    size_t getMemorySize() const;
+
+    // decode a single frame into posesOut, which must hold getJointCount() poses.
+    void sample(int frame, AnimPose* posesOut) const;
+
+    // decode and blend two frames, equivalent to ::blend() over the uncompressed frames.
+    void sample(int prevFrame, int nextFrame, float alpha, AnimPose* posesOut) const;
+
+protected:
+    struct Track {
+        // value of constant channels
+        AnimPose constant;
+
+        // index of the channel within a frame of animated data, or -1 if constant
+        int scaleIndex { -1 };
+        int rotIndex { -1 };
+        int transIndex { -1 };
+
+        // quantization range of animated translations
+        glm::vec3 transMin;
+        glm::vec3 transExtent;
+    };
+
+    glm::vec3 decodeScale(int frame, const Track& track) const;
+    glm::quat decodeRot(int frame, const Track& track) const;
+    glm::vec3 decodeTrans(int frame, const Track& track) const;
+
+    int _frameCount { 0 };
+    std::vector<Track> _tracks;
+
+    // number of animated channels in each frame
+    int _numScales { 0 };
+    int _numRots { 0 };
+    int _numTranses { 0 };
+
+    // _scales[frame * _numScales + scaleIndex]
+    std::vector<glm::vec3> _scales;
+    // _rots[(frame * _numRots + rotIndex) * 3]
+    std::vector<uint16_t> _rots;
+    // _transes[(frame * _numTranses + transIndex) * 3]
+    std::vector<uint16_t> _transes;
+};
+
+#endif // hifi_AnimClipData_h
@@ -59,6 +59,7 @@ public:
     BoneSet _boneSet;
     float _alpha;
     std::vector<float> _boneSetVec;
+    std::vector<float> _alphas;  // per joint blend factors, _boneSetVec * _alpha
 
     QString _boneSetVar;
     QString _alphaVar;
@@ -0,0 +1,244 @@
+//
+//  AnimPoseBuffer.cpp
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AnimPoseBuffer.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "AnimSkeleton.h"
+
+static const float UNIFORM_SCALE_EPSILON = 0.0001f;
+
+void AnimPoseBuffer::resize(size_t size) {
+    size_t paddedSize = (size + 3) & ~(size_t)3;
+    if (paddedSize != _paddedSize) {
+        std::vector<float> data(NUM_STREAMS * paddedSize);
+        size_t numToCopy = std::min(_size, size);
+        if (numToCopy > 0) {
+            for (int s = 0; s < NUM_STREAMS; s++) {
+                const float* from = _data.data() + s * _paddedSize;
+                std::copy(from, from + numToCopy, data.data() + s * paddedSize);
+            }
+        }
+        _data.swap(data);
+        _paddedSize = paddedSize;
+    }
+    size_t oldSize = _size;
+    _size = size;
+
+    // new poses and padding are identity
+    for (size_t i = std::min(oldSize, size); i < _paddedSize; i++) {
+        set(i, AnimPose::identity);
+    }
+}
+
+AnimPose AnimPoseBuffer::get(size_t index) const {
+    return AnimPose(glm::vec3(stream(SCALE_X)[index], stream(SCALE_Y)[index], stream(SCALE_Z)[index]),
+                    glm::quat(stream(ROT_W)[index], stream(ROT_X)[index], stream(ROT_Y)[index], stream(ROT_Z)[index]),
+                    glm::vec3(stream(TRANS_X)[index], stream(TRANS_Y)[index], stream(TRANS_Z)[index]));
+}
+
+void AnimPoseBuffer::set(size_t index, const AnimPose& pose) {
+    stream(SCALE_X)[index] = pose.scale().x;
+    stream(SCALE_Y)[index] = pose.scale().y;
+    stream(SCALE_Z)[index] = pose.scale().z;
+    stream(ROT_X)[index] = pose.rot().x;
+    stream(ROT_Y)[index] = pose.rot().y;
+    stream(ROT_Z)[index] = pose.rot().z;
+    stream(ROT_W)[index] = pose.rot().w;
+    stream(TRANS_X)[index] = pose.trans().x;
+    stream(TRANS_Y)[index] = pose.trans().y;
+    stream(TRANS_Z)[index] = pose.trans().z;
+}
+
+void AnimPoseBuffer::load(const AnimPoseVec& poses) {
+    resize(poses.size());
+    for (size_t i = 0; i < poses.size(); i++) {
+        set(i, poses[i]);
+    }
+}
+
+void AnimPoseBuffer::store(AnimPoseVec& poses) const {
+    poses.resize(_size);
+    for (size_t i = 0; i < _size; i++) {
+        poses[i] = get(i);
+    }
+}
+
+bool AnimPoseBuffer::hasUniformScale() const {
+    const float* scaleX = stream(SCALE_X);
+    const float* scaleY = stream(SCALE_Y);
+    const float* scaleZ = stream(SCALE_Z);
+    for (size_t i = 0; i < _size; i++) {
+        if (fabsf(scaleX[i] - scaleY[i]) > UNIFORM_SCALE_EPSILON || fabsf(scaleX[i] - scaleZ[i]) > UNIFORM_SCALE_EPSILON) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// pointers to the components of a pose inside a buffer
+struct PoseStreams {
+    PoseStreams(const AnimPoseBuffer& buffer) :
+        sx(buffer.stream(AnimPoseBuffer::SCALE_X)), sy(buffer.stream(AnimPoseBuffer::SCALE_Y)), sz(buffer.stream(AnimPoseBuffer::SCALE_Z)),
+        rx(buffer.stream(AnimPoseBuffer::ROT_X)), ry(buffer.stream(AnimPoseBuffer::ROT_Y)), rz(buffer.stream(AnimPoseBuffer::ROT_Z)), rw(buffer.stream(AnimPoseBuffer::ROT_W)),
+        tx(buffer.stream(AnimPoseBuffer::TRANS_X)), ty(buffer.stream(AnimPoseBuffer::TRANS_Y)), tz(buffer.stream(AnimPoseBuffer::TRANS_Z)) {}
+
+    float* sx; float* sy; float* sz;
+    float* rx; float* ry; float* rz; float* rw;
+    float* tx; float* ty; float* tz;
+};
+
+// parent * child, as translation, rotation and scale
+static void composePose(const AnimPose& parent, const PoseStreams& child, int c, const PoseStreams& out, int o) {
+    const glm::quat& pr = parent.rot();
+    const glm::vec3& ps = parent.scale();
+    const glm::vec3& pt = parent.trans();
+
+    float cx = child.rx[c], cy = child.ry[c], cz = child.rz[c], cw = child.rw[c];
+    float vx = ps.x * child.tx[c], vy = ps.y * child.ty[c], vz = ps.z * child.tz[c];
+
+    // rotate v by the parent rotation: v + w * t + cross(q, t), t = 2 * cross(q, v)
+    float tx = 2.0f * (pr.y * vz - pr.z * vy);
+    float ty = 2.0f * (pr.z * vx - pr.x * vz);
+    float tz = 2.0f * (pr.x * vy - pr.y * vx);
+
+    out.tx[o] = pt.x + vx + pr.w * tx + (pr.y * tz - pr.z * ty);
+    out.ty[o] = pt.y + vy + pr.w * ty + (pr.z * tx - pr.x * tz);
+    out.tz[o] = pt.z + vz + pr.w * tz + (pr.x * ty - pr.y * tx);
+
+    out.rw[o] = pr.w * cw - pr.x * cx - pr.y * cy - pr.z * cz;
+    out.rx[o] = pr.w * cx + pr.x * cw + pr.y * cz - pr.z * cy;
+    out.ry[o] = pr.w * cy - pr.x * cz + pr.y * cw + pr.z * cx;
+    out.rz[o] = pr.w * cz + pr.x * cy - pr.y * cx + pr.z * cw;
+
+    out.sx[o] = ps.x * child.sx[c];
+    out.sy[o] = ps.y * child.sy[c];
+    out.sz[o] = ps.z * child.sz[c];
+}
+
+static AnimPose getPose(const PoseStreams& p, int i) {
+    return AnimPose(glm::vec3(p.sx[i], p.sy[i], p.sz[i]), glm::quat(p.rw[i], p.rx[i], p.ry[i], p.rz[i]), glm::vec3(p.tx[i], p.ty[i], p.tz[i]));
+}
+
+void convertRelativeToAbsolute_ref(const AnimPoseBuffer& relativePoses, const AnimSkeleton& skeleton,
+                                   const AnimPose& rootPose, AnimPoseBuffer& absolutePosesOut) {
+    int numJoints = std::min((int)relativePoses.size(), skeleton.getNumJoints());
+    absolutePosesOut.resize(relativePoses.size());
+
+    PoseStreams rel(relativePoses);
+    PoseStreams abs(absolutePosesOut);
+    for (int i = 0; i < numJoints; i++) {
+        int parentIndex = skeleton.getParentIndex(i);
+        if (parentIndex == -1) {
+            composePose(rootPose, rel, i, abs, i);
+        } else {
+            composePose(getPose(abs, parentIndex), rel, i, abs, i);
+        }
+    }
+}
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+
+#include <emmintrin.h>  // SSE2
+
+static inline __m128 gather(const float* stream, const int* indices) {
+    return _mm_setr_ps(stream[indices[0]], stream[indices[1]], stream[indices[2]], stream[indices[3]]);
+}
+
+static inline void scatter(float* stream, const int* indices, __m128 value) {
+    float values[4];
+    _mm_storeu_ps(values, value);
+    stream[indices[0]] = values[0];
+    stream[indices[1]] = values[1];
+    stream[indices[2]] = values[2];
+    stream[indices[3]] = values[3];
+}
+
+// compose 4 joints with their (already absolute) parents
+static void compose4_SSE(const PoseStreams& parent, const int* parentIndices, const PoseStreams& child, const int* childIndices, const PoseStreams& out) {
+    const __m128 two = _mm_set1_ps(2.0f);
+
+    __m128 psx = gather(parent.sx, parentIndices), psy = gather(parent.sy, parentIndices), psz = gather(parent.sz, parentIndices);
+    __m128 prx = gather(parent.rx, parentIndices), pry = gather(parent.ry, parentIndices), prz = gather(parent.rz, parentIndices), prw = gather(parent.rw, parentIndices);
+    __m128 ptx = gather(parent.tx, parentIndices), pty = gather(parent.ty, parentIndices), ptz = gather(parent.tz, parentIndices);
+
+    __m128 csx = gather(child.sx, childIndices), csy = gather(child.sy, childIndices), csz = gather(child.sz, childIndices);
+    __m128 crx = gather(child.rx, childIndices), cry = gather(child.ry, childIndices), crz = gather(child.rz, childIndices), crw = gather(child.rw, childIndices);
+
+    __m128 vx = _mm_mul_ps(psx, gather(child.tx, childIndices));
+    __m128 vy = _mm_mul_ps(psy, gather(child.ty, childIndices));
+    __m128 vz = _mm_mul_ps(psz, gather(child.tz, childIndices));
+
+    // rotate v by the parent rotation
+    __m128 tx = _mm_mul_ps(two, _mm_sub_ps(_mm_mul_ps(pry, vz), _mm_mul_ps(prz, vy)));
+    __m128 ty = _mm_mul_ps(two, _mm_sub_ps(_mm_mul_ps(prz, vx), _mm_mul_ps(prx, vz)));
+    __m128 tz = _mm_mul_ps(two, _mm_sub_ps(_mm_mul_ps(prx, vy), _mm_mul_ps(pry, vx)));
+
+    scatter(out.tx, childIndices, _mm_add_ps(_mm_add_ps(_mm_add_ps(ptx, vx), _mm_mul_ps(prw, tx)), _mm_sub_ps(_mm_mul_ps(pry, tz), _mm_mul_ps(prz, ty))));
+    scatter(out.ty, childIndices, _mm_add_ps(_mm_add_ps(_mm_add_ps(pty, vy), _mm_mul_ps(prw, ty)), _mm_sub_ps(_mm_mul_ps(prz, tx), _mm_mul_ps(prx, tz))));
+    scatter(out.tz, childIndices, _mm_add_ps(_mm_add_ps(_mm_add_ps(ptz, vz), _mm_mul_ps(prw, tz)), _mm_sub_ps(_mm_mul_ps(prx, ty), _mm_mul_ps(pry, tx))));
+
+    // quaternion product
+    scatter(out.rw, childIndices, _mm_sub_ps(_mm_sub_ps(_mm_mul_ps(prw, crw), _mm_mul_ps(prx, crx)), _mm_add_ps(_mm_mul_ps(pry, cry), _mm_mul_ps(prz, crz))));
+    scatter(out.rx, childIndices, _mm_add_ps(_mm_add_ps(_mm_mul_ps(prw, crx), _mm_mul_ps(prx, crw)), _mm_sub_ps(_mm_mul_ps(pry, crz), _mm_mul_ps(prz, cry))));
+    scatter(out.ry, childIndices, _mm_add_ps(_mm_sub_ps(_mm_mul_ps(prw, cry), _mm_mul_ps(prx, crz)), _mm_add_ps(_mm_mul_ps(pry, crw), _mm_mul_ps(prz, crx))));
+    scatter(out.rz, childIndices, _mm_add_ps(_mm_sub_ps(_mm_add_ps(_mm_mul_ps(prw, crz), _mm_mul_ps(prx, cry)), _mm_mul_ps(pry, crx)), _mm_mul_ps(prz, crw)));
+
+    scatter(out.sx, childIndices, _mm_mul_ps(psx, csx));
+    scatter(out.sy, childIndices, _mm_mul_ps(psy, csy));
+    scatter(out.sz, childIndices, _mm_mul_ps(psz, csz));
+}
+
+void convertRelativeToAbsolute(const AnimPoseBuffer& relativePoses, const AnimSkeleton& skeleton,
+                               const AnimPose& rootPose, AnimPoseBuffer& absolutePosesOut) {
+    if ((int)relativePoses.size() != skeleton.getNumJoints()) {
+        convertRelativeToAbsolute_ref(relativePoses, skeleton, rootPose, absolutePosesOut);
+        return;
+    }
+    absolutePosesOut.resize(relativePoses.size());
+
+    PoseStreams rel(relativePoses);
+    PoseStreams abs(absolutePosesOut);
+    const std::vector<int>& joints = skeleton.getJointsByDepth();
+    const std::vector<int>& offsets = skeleton.getDepthOffsets();
+
+    for (size_t depth = 0; depth + 1 < offsets.size(); depth++) {
+        int begin = offsets[depth];
+        int end = offsets[depth + 1];
+        int i = begin;
+
+        if (depth > 0) {
+            for (; i + 4 <= end; i += 4) {
+                int parentIndices[4];
+                for (int k = 0; k < 4; k++) {
+                    parentIndices[k] = skeleton.getParentIndex(joints[i + k]);
+                }
+                compose4_SSE(abs, parentIndices, rel, &joints[i], abs);
+            }
+        }
+
+        // roots and remaining joints
+        for (; i < end; i++) {
+            int joint = joints[i];
+            int parentIndex = skeleton.getParentIndex(joint);
+            composePose(parentIndex == -1 ? rootPose : getPose(abs, parentIndex), rel, joint, abs, joint);
+        }
+    }
+}
+
+#else   // portable reference code
+
+void convertRelativeToAbsolute(const AnimPoseBuffer& relativePoses, const AnimSkeleton& skeleton,
+                               const AnimPose& rootPose, AnimPoseBuffer& absolutePosesOut) {
+    convertRelativeToAbsolute_ref(relativePoses, skeleton, rootPose, absolutePosesOut);
+}
+
+#endif
@@ -0,0 +1,77 @@
+//
+//  AnimPoseBuffer.h
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AnimPoseBuffer_h
+#define hifi_AnimPoseBuffer_h
+
+#include <vector>
+
+#include "AnimPose.h"
+
+class AnimSkeleton;
+
+// Structure of arrays storage for a set of poses, one float stream per component.
+// Streams are padded to a multiple of 4 poses with identity poses, so kernels can
+// always process 4 joints at a time.
+
+class AnimPoseBuffer {
+public:
+    enum Stream {
+        SCALE_X = 0,
+        SCALE_Y,
+        SCALE_Z,
+        ROT_X,
+        ROT_Y,
+        ROT_Z,
+        ROT_W,
+        TRANS_X,
+        TRANS_Y,
+        TRANS_Z,
+        NUM_STREAMS
+    };
+
+    AnimPoseBuffer() {}
+    explicit AnimPoseBuffer(size_t size) { resize(size); }
+
+    void resize(size_t size);
+    size_t size() const { return _size; }
+    size_t paddedSize() const { return _paddedSize; }
+
+    // null, for an empty buffer
+    float* stream(Stream stream) { return _data.empty() ? nullptr : _data.data() + stream * _paddedSize; }
+    const float* stream(Stream stream) const { return _data.empty() ? nullptr : _data.data() + stream * _paddedSize; }
+
+    AnimPose get(size_t index) const;
+    void set(size_t index, const AnimPose& pose);
+
+    // conversion from and to AnimPoseVec, resizing the destination.
+    void load(const AnimPoseVec& poses);
+    void store(AnimPoseVec& poses) const;
+
+    // true if every pose has the same scale on all axes.
+    bool hasUniformScale() const;
+
+protected:
+    size_t _size { 0 };
+    size_t _paddedSize { 0 };
+    std::vector<float> _data;
+};
+
+// Computes absolute poses from relative ones, with root joints relative to rootPose.
+// Joints of the same depth in the hierarchy are independent, so they are composed 4 at a time.
+// Poses are composed as translation * rotation * scale, which only matches AnimPose::operator*
+// (a full matrix product) when parent scales are uniform; callers fall back to AnimPose otherwise.
+void convertRelativeToAbsolute(const AnimPoseBuffer& relativePoses, const AnimSkeleton& skeleton,
+                               const AnimPose& rootPose, AnimPoseBuffer& absolutePosesOut);
+
+// portable reference implementation of convertRelativeToAbsolute
+void convertRelativeToAbsolute_ref(const AnimPoseBuffer& relativePoses, const AnimSkeleton& skeleton,
+                                   const AnimPose& rootPose, AnimPoseBuffer& absolutePosesOut);
+
+#endif // hifi_AnimPoseBuffer_h
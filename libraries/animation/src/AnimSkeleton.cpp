@@ -12,9 +12,19 @@
 
 #include <glm/gtx/transform.hpp>
 
+#include <QtCore/QThreadStorage>
+
 #include <GLMHelpers.h>
 
 #include "AnimationLogging.h"
+#include "AnimPoseBuffer.h"
+
+// scratch space for convertRelativePosesToAbsolute, per thread, because rigs on different threads share skeletons
+struct PoseConversionBuffers {
+    AnimPoseBuffer relativePoses;
+    AnimPoseBuffer absolutePoses;
+};
+static QThreadStorage<PoseConversionBuffers*> poseConversionBuffers;
 
 AnimSkeleton::AnimSkeleton(const FBXGeometry& fbxGeometry) {
     // convert to std::vector of joints
@@ -86,6 +96,19 @@ AnimPose AnimSkeleton::getAbsolutePose(int jointIndex, const AnimPoseVec& poses)
 
 void AnimSkeleton::convertRelativePosesToAbsolute(AnimPoseVec& poses) const {
     // poses start off relative and leave in absolute frame
+    if ((int)poses.size() == _jointsSize) {
+        if (!poseConversionBuffers.hasLocalData()) {
+            poseConversionBuffers.setLocalData(new PoseConversionBuffers());
+        }
+        PoseConversionBuffers* buffers = poseConversionBuffers.localData();
+        buffers->relativePoses.load(poses);
+        if (buffers->relativePoses.hasUniformScale()) {
+            convertRelativeToAbsolute(buffers->relativePoses, *this, AnimPose::identity, buffers->absolutePoses);
+            buffers->absolutePoses.store(poses);
+            return;
+        }
+    }
+
     int lastIndex = std::min((int)poses.size(), _jointsSize);
     for (int i = 0; i < lastIndex; ++i) {
         int parentIndex = _joints[i].parentIndex;
@@ -206,6 +229,27 @@ void AnimSkeleton::buildSkeletonFromJoints(const std::vector<FBXJoint>& joints)
         _jointIndicesByName[_joints[i].name] = i;
     }
 
+    // sort joints by depth, parents always come before their children.
+    std::vector<int> depths(_jointsSize, 0);
+    int maxDepth = -1;
+    for (int i = 0; i < _jointsSize; i++) {
+        int parentIndex = getParentIndex(i);
+        depths[i] = (parentIndex >= 0) ? depths[parentIndex] + 1 : 0;
+        maxDepth = std::max(maxDepth, depths[i]);
+    }
+    _depthOffsets.assign(maxDepth + 2, 0);
+    for (int i = 0; i < _jointsSize; i++) {
+        _depthOffsets[depths[i] + 1]++;
+    }
+    for (int depth = 1; depth < (int)_depthOffsets.size(); depth++) {
+        _depthOffsets[depth] += _depthOffsets[depth - 1];
+    }
+    _jointsByDepth.resize(_jointsSize);
+    std::vector<int> nextSlot(_depthOffsets.begin(), _depthOffsets.end() - 1);
+    for (int i = 0; i < _jointsSize; i++) {
+        _jointsByDepth[nextSlot[depths[i]]++] = i;
+    }
+
     // build mirror map.
     _nonMirroredIndices.clear();
     _mirrorMap.reserve(_jointsSize);
@@ -50,6 +50,11 @@ public:
 
     int getParentIndex(int jointIndex) const;
 
+    // joint indices sorted by depth in the hierarchy, roots first.
+    // joints in [getDepthOffsets()[d], getDepthOffsets()[d + 1]) all have depth d.
+    const std::vector<int>& getJointsByDepth() const { return _jointsByDepth; }
+    const std::vector<int>& getDepthOffsets() const { return _depthOffsets; }
+
     AnimPose getAbsolutePose(int jointIndex, const AnimPoseVec& poses) const;
 
     void convertRelativePosesToAbsolute(AnimPoseVec& poses) const;
@@ -80,6 +85,8 @@ protected:
     mutable AnimPoseVec _nonMirroredPoses;
     std::vector<int> _nonMirroredIndices;
     std::vector<int> _mirrorMap;
+    std::vector<int> _jointsByDepth;
+    std::vector<int> _depthOffsets;
     QHash<QString, int> _jointIndicesByName;
 
     // no copies
@@ -11,13 +11,11 @@
 #include "AnimUtil.h"
 #include "GLMHelpers.h"
 
-// TODO: use restrict keyword
-// TODO: excellent candidate for simd vectorization.
-
-void blend(size_t numPoses, const AnimPose* a, const AnimPose* b, float alpha, AnimPose* result) {
+void blend_ref(size_t numPoses, const AnimPose* a, const AnimPose* b, const float* alphas, size_t alphaStride, AnimPose* result) {
     for (size_t i = 0; i < numPoses; i++) {
         const AnimPose& aPose = a[i];
         const AnimPose& bPose = b[i];
+        float alpha = alphas[i * alphaStride];
 
         // adjust signs if necessary
         const glm::quat& q1 = aPose.rot();
@@ -33,6 +31,113 @@ void blend(size_t numPoses, const AnimPose* a, const AnimPose* b, float alpha, A
     }
 }
 
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+
+#include <emmintrin.h>  // SSE2
+
+// AnimPose is 10 tightly packed floats, so 4 poses are exactly 10 vectors.
+static_assert(sizeof(AnimPose) == 10 * sizeof(float), "AnimPose must be 10 floats");
+static const int FLOATS_PER_POSE = 10;
+static const int VECTORS_PER_BLOCK = 10;
+
+// blend 4 poses. Scale and translation are lerped in place, the rotations are transposed to
+// x, y, z, w vectors so the sign adjustment and normalization are done 4 joints at a time.
+static void blend4_SSE(const AnimPose* a, const AnimPose* b, const float* alphas, size_t alphaStride, AnimPose* result) {
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+
+    __m128 alpha = _mm_setr_ps(alphas[0], alphas[alphaStride], alphas[2 * alphaStride], alphas[3 * alphaStride]);
+
+    // rotations
+    __m128 qa0 = _mm_loadu_ps((const float*)&a[0].rot());
+    __m128 qa1 = _mm_loadu_ps((const float*)&a[1].rot());
+    __m128 qa2 = _mm_loadu_ps((const float*)&a[2].rot());
+    __m128 qa3 = _mm_loadu_ps((const float*)&a[3].rot());
+    __m128 qb0 = _mm_loadu_ps((const float*)&b[0].rot());
+    __m128 qb1 = _mm_loadu_ps((const float*)&b[1].rot());
+    __m128 qb2 = _mm_loadu_ps((const float*)&b[2].rot());
+    __m128 qb3 = _mm_loadu_ps((const float*)&b[3].rot());
+    _MM_TRANSPOSE4_PS(qa0, qa1, qa2, qa3);
+    _MM_TRANSPOSE4_PS(qb0, qb1, qb2, qb3);
+
+    // adjust signs if necessary
+    __m128 dot = _mm_add_ps(_mm_add_ps(_mm_mul_ps(qa0, qb0), _mm_mul_ps(qa1, qb1)),
+                            _mm_add_ps(_mm_mul_ps(qa2, qb2), _mm_mul_ps(qa3, qb3)));
+    __m128 flip = _mm_and_ps(_mm_cmplt_ps(dot, zero), signMask);
+    qb0 = _mm_xor_ps(qb0, flip);
+    qb1 = _mm_xor_ps(qb1, flip);
+    qb2 = _mm_xor_ps(qb2, flip);
+    qb3 = _mm_xor_ps(qb3, flip);
+
+    // nlerp
+    __m128 beta = _mm_sub_ps(one, alpha);
+    __m128 q0 = _mm_add_ps(_mm_mul_ps(qa0, beta), _mm_mul_ps(qb0, alpha));
+    __m128 q1 = _mm_add_ps(_mm_mul_ps(qa1, beta), _mm_mul_ps(qb1, alpha));
+    __m128 q2 = _mm_add_ps(_mm_mul_ps(qa2, beta), _mm_mul_ps(qb2, alpha));
+    __m128 q3 = _mm_add_ps(_mm_mul_ps(qa3, beta), _mm_mul_ps(qb3, alpha));
+
+    __m128 length2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(q0, q0), _mm_mul_ps(q1, q1)),
+                                _mm_add_ps(_mm_mul_ps(q2, q2), _mm_mul_ps(q3, q3)));
+    __m128 oneOverLength = _mm_div_ps(one, _mm_sqrt_ps(length2));
+    q0 = _mm_mul_ps(q0, oneOverLength);
+    q1 = _mm_mul_ps(q1, oneOverLength);
+    q2 = _mm_mul_ps(q2, oneOverLength);
+    q3 = _mm_mul_ps(q3, oneOverLength);
+    _MM_TRANSPOSE4_PS(q0, q1, q2, q3);
+
+    // everything else is a plain lerp over the 40 floats of the block
+    float alphaLanes[4 * VECTORS_PER_BLOCK];
+    for (int i = 0; i < 4 * VECTORS_PER_BLOCK; i++) {
+        alphaLanes[i] = alphas[(i / FLOATS_PER_POSE) * alphaStride];
+    }
+    const float* pa = (const float*)a;
+    const float* pb = (const float*)b;
+    __m128 block[VECTORS_PER_BLOCK];
+    for (int i = 0; i < VECTORS_PER_BLOCK; i++) {
+        __m128 t = _mm_loadu_ps(&alphaLanes[4 * i]);
+        block[i] = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&pa[4 * i]), _mm_sub_ps(one, t)), _mm_mul_ps(_mm_loadu_ps(&pb[4 * i]), t));
+    }
+
+    // all inputs have been read, result may alias a or b.
+    float* pr = (float*)result;
+    for (int i = 0; i < VECTORS_PER_BLOCK; i++) {
+        _mm_storeu_ps(&pr[4 * i], block[i]);
+    }
+    _mm_storeu_ps((float*)&result[0].rot(), q0);
+    _mm_storeu_ps((float*)&result[1].rot(), q1);
+    _mm_storeu_ps((float*)&result[2].rot(), q2);
+    _mm_storeu_ps((float*)&result[3].rot(), q3);
+}
+
+static void blend_SSE(size_t numPoses, const AnimPose* a, const AnimPose* b, const float* alphas, size_t alphaStride, AnimPose* result) {
+    size_t i = 0;
+    for (; i + 4 <= numPoses; i += 4) {
+        blend4_SSE(&a[i], &b[i], &alphas[i * alphaStride], alphaStride, &result[i]);
+    }
+    blend_ref(numPoses - i, &a[i], &b[i], &alphas[i * alphaStride], alphaStride, &result[i]);
+}
+
+void blend(size_t numPoses, const AnimPose* a, const AnimPose* b, float alpha, AnimPose* result) {
+    blend_SSE(numPoses, a, b, &alpha, 0, result);
+}
+
+void blend(size_t numPoses, const AnimPose* a, const AnimPose* b, const float* alphas, AnimPose* result) {
+    blend_SSE(numPoses, a, b, alphas, 1, result);
+}
+
+#else   // portable reference code
+
+void blend(size_t numPoses, const AnimPose* a, const AnimPose* b, float alpha, AnimPose* result) {
+    blend_ref(numPoses, a, b, &alpha, 0, result);
+}
+
+void blend(size_t numPoses, const AnimPose* a, const AnimPose* b, const float* alphas, AnimPose* result) {
+    blend_ref(numPoses, a, b, alphas, 1, result);
+}
+
+#endif
+
 float accumulateTime(float startFrame, float endFrame, float timeScale, float currentFrame, float dt, bool loopFlag,
                      const QString& id, AnimNode::Triggers& triggersOut) {
 
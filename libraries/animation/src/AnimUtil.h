@@ -16,6 +16,12 @@
 // this is where the magic happens
 void blend(size_t numPoses, const AnimPose* a, const AnimPose* b, float alpha, AnimPose* result);
 
+// same as above, with a separate alpha for each pose.
+void blend(size_t numPoses, const AnimPose* a, const AnimPose* b, const float* alphas, AnimPose* result);
+
+// portable reference implementation of blend, alphas[i * alphaStride] is used for pose i.
+void blend_ref(size_t numPoses, const AnimPose* a, const AnimPose* b, const float* alphas, size_t alphaStride, AnimPose* result);
+
 float accumulateTime(float startFrame, float endFrame, float timeScale, float currentFrame, float dt, bool loopFlag,
                      const QString& id, AnimNode::Triggers& triggersOut);
 
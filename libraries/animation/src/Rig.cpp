@@ -29,6 +29,7 @@
 #include "AnimInverseKinematics.h"
 #include "AnimSkeleton.h"
 #include "IKTarget.h"
+#include "RigBatch.h"
 
 static bool isEqual(const glm::vec3& u, const glm::vec3& v) {
     const float EPSILON = 0.0001f;
@@ -48,6 +49,8 @@ const glm::vec3 DEFAULT_LEFT_EYE_POS(0.3f, 0.9f, 0.0f);
 const glm::vec3 DEFAULT_HEAD_POS(0.0f, 0.75f, 0.0f);
 const glm::vec3 DEFAULT_NECK_POS(0.0f, 0.70f, 0.0f);
 
+static const float UNIFORM_SCALE_EPSILON = 0.0001f;
+
 void Rig::overrideAnimation(const QString& url, float fps, bool loop, float firstFrame, float lastFrame) {
 
     UserAnimState::ClipNodeEnum clipNodeEnum;
@@ -808,15 +811,6 @@ void Rig::computeMotionAnimationState(float deltaTime, const glm::vec3& worldPos
         }
 
         t += deltaTime;
-
-        if (_enableInverseKinematics != _lastEnableInverseKinematics) {
-            if (_enableInverseKinematics) {
-                _animVars.set("ikOverlayAlpha", 1.0f);
-            } else {
-                _animVars.set("ikOverlayAlpha", 0.0f);
-            }
-        }
-        _lastEnableInverseKinematics = _enableInverseKinematics;
     }
 
     _lastFront = front;
@@ -907,30 +901,88 @@ void Rig::updateAnimationStateHandlers() { // called on avatar update thread (wh
 void Rig::updateAnimations(float deltaTime, glm::mat4 rootTransform) {
 
     PROFILE_RANGE_EX(simulation_animation_detail, __FUNCTION__, 0xffff00ff, 0);
-    PerformanceTimer perfTimer("updateAnimations");
+    PERFORMANCE_TIMER("updateAnimations");
+
+    prepareAnimations(deltaTime, rootTransform);
 
+    auto rigBatch = _rigBatch.lock();
+    if (rigBatch) {
+        rigBatch->queue(shared_from_this());
+    } else {
+        evaluateAnimations();
+        publishAnimations();
+    }
+}
+
+void Rig::prepareAnimations(float deltaTime, glm::mat4 rootTransform) {
     setModelOffset(rootTransform);
 
+    // distant avatars are evaluated less often, with the time of the skipped frames.
+    _lodDeltaTime += deltaTime;
+    _lodFrameCount++;
+    int updateInterval = (_animationLOD == AnimationLOD::Full) ? 1 : (_animationLOD == AnimationLOD::Reduced) ? 2 : 4;
+    _skipEvaluation = (_lodFrameCount < updateInterval);
+    if (_skipEvaluation) {
+        return;
+    }
+
+    // IK is only solved at full detail, below it the IK node isn't evaluated at all
+    bool enableInverseKinematics = _enableInverseKinematics && _animationLOD == AnimationLOD::Full;
+    if (enableInverseKinematics != _lastEnableInverseKinematics) {
+        if (enableInverseKinematics) {
+            _animVars.set("ikOverlayAlpha", 1.0f);
+        } else {
+            _animVars.set("ikOverlayAlpha", 0.0f);
+        }
+    }
+    _lastEnableInverseKinematics = enableInverseKinematics;
+    _animVars.set("skipInverseKinematics", _animationLOD != AnimationLOD::Full);
+
     if (_animNode && _enabledAnimations) {
-        PerformanceTimer perfTimer("handleTriggers");
+        PERFORMANCE_TIMER("handleTriggers");
 
         updateAnimationStateHandlers();
         _animVars.setRigToGeometryTransform(_rigToGeometryTransform);
+    }
+}
 
+void Rig::evaluateAnimations() {
+    if (_skipEvaluation) {
+        return;
+    }
+
+    if (_hasPendingJointData) {
+        applyJointData(_pendingJointData);
+        _pendingJointData.clear();
+        _hasPendingJointData = false;
+    }
+
+    if (_animNode && _enabledAnimations) {
         // evaluate the animation
-        AnimNode::Triggers triggersOut;
-        _internalPoseSet._relativePoses = _animNode->evaluate(_animVars, deltaTime, triggersOut);
+        _triggersOut.clear();
+        _internalPoseSet._relativePoses = _animNode->evaluate(_animVars, _lodDeltaTime, _triggersOut);
         if ((int)_internalPoseSet._relativePoses.size() != _animSkeleton->getNumJoints()) {
             // animations haven't fully loaded yet.
             _internalPoseSet._relativePoses = _animSkeleton->getRelativeDefaultPoses();
         }
+    }
+    applyOverridePoses();
+    buildAbsoluteRigPoses(_internalPoseSet._relativePoses, _internalPoseSet._absolutePoses);
+}
+
+void Rig::publishAnimations() {
+    if (_skipEvaluation) {
+        return;
+    }
+    _lodDeltaTime = 0.0f;
+    _lodFrameCount = 0;
+
+    if (_animNode && _enabledAnimations) {
         _animVars.clearTriggers();
-        for (auto& trigger : triggersOut) {
+        for (auto& trigger : _triggersOut) {
             _animVars.setTrigger(trigger);
         }
     }
-    applyOverridePoses();
-    buildAbsoluteRigPoses(_internalPoseSet._relativePoses, _internalPoseSet._absolutePoses);
 
     // copy internal poses to external poses
     {
@@ -939,6 +991,15 @@ void Rig::updateAnimations(float deltaTime, glm::mat4 rootTransform) {
     }
 }
 
+void Rig::setAnimationLOD(AnimationLOD lod) {
+    if (lod != _animationLOD) {
+        _animationLOD = lod;
+
+        // evaluate right away when the detail goes up
+        _lodFrameCount = (lod == AnimationLOD::Full) ? 0 : _lodFrameCount;
+    }
+}
+
 void Rig::inverseKinematics(int endIndex, glm::vec3 targetPosition, const glm::quat& targetRotation, float priority,
                             const QVector<int>& freeLineage, glm::mat4 rootTransform) {
     ASSERT(false);
@@ -1200,7 +1261,7 @@ bool Rig::getModelRegistrationPoint(glm::vec3& modelRegistrationPointOut) const
 }
 
 void Rig::applyOverridePoses() {
-    PerformanceTimer perfTimer("override");
+    PERFORMANCE_TIMER("override");
     if (_numOverrides == 0 || !_animSkeleton) {
         return;
     }
@@ -1217,7 +1278,7 @@ void Rig::applyOverridePoses() {
 }
 
 void Rig::buildAbsoluteRigPoses(const AnimPoseVec& relativePoses, AnimPoseVec& absolutePosesOut) {
-    PerformanceTimer perfTimer("buildAbsolute");
+    PERFORMANCE_TIMER("buildAbsolute");
     if (!_animSkeleton) {
         return;
     }
@@ -1226,6 +1287,18 @@ void Rig::buildAbsoluteRigPoses(const AnimPoseVec& relativePoses, AnimPoseVec& a
 
     absolutePosesOut.resize(relativePoses.size());
     AnimPose geometryToRigTransform(_geometryToRigTransform);
+
+    // the structure of arrays path composes poses as translation, rotation and scale, see AnimPoseBuffer.h
+    const glm::vec3& rootScale = geometryToRigTransform.scale();
+    if (fabsf(rootScale.x - rootScale.y) < UNIFORM_SCALE_EPSILON && fabsf(rootScale.x - rootScale.z) < UNIFORM_SCALE_EPSILON) {
+        _relativePoseBuffer.load(relativePoses);
+        if (_relativePoseBuffer.hasUniformScale()) {
+            convertRelativeToAbsolute(_relativePoseBuffer, *_animSkeleton, geometryToRigTransform, _absolutePoseBuffer);
+            _absolutePoseBuffer.store(absolutePosesOut);
+            return;
+        }
+    }
+
     for (int i = 0; i < (int)relativePoses.size(); i++) {
         int parentIndex = _animSkeleton->getParentIndex(i);
         if (parentIndex == -1) {
@@ -1272,7 +1345,18 @@ void Rig::copyJointsIntoJointData(QVector<JointData>& jointDataVec) const {
 }
 
 void Rig::copyJointsFromJointData(const QVector<JointData>& jointDataVec) {
-    PerformanceTimer perfTimer("copyJoints");
+    if (!_rigBatch.expired()) {
+        // converted to relative poses by evaluateAnimations(), on a worker thread
+        _pendingJointData = jointDataVec;
+        _hasPendingJointData = true;
+        return;
+    }
+
+    PERFORMANCE_TIMER("copyJoints");
+    applyJointData(jointDataVec);
+}
+
+void Rig::applyJointData(const QVector<JointData>& jointDataVec) {
     PROFILE_RANGE(simulation_animation_detail, "copyJoints");
     if (_animSkeleton && jointDataVec.size() == (int)_internalPoseSet._relativePoses.size()) {
         // make a vector of rotations in absolute-geometry-frame
@@ -23,9 +23,11 @@
 
 #include "AnimNode.h"
 #include "AnimNodeLoader.h"
+#include "AnimPoseBuffer.h"
 #include "SimpleMovingAverage.h"
 
 class Rig;
+class RigBatch;
 typedef std::shared_ptr<Rig> RigPointer;
 
 // Rig instances are reentrant.
@@ -79,6 +81,13 @@ public:
         Hover
     };
 
+    // Level of detail of the animation, for avatars that are far away or out of view.
+    enum class AnimationLOD {
+        Full = 0,  // every frame, with IK
+        Reduced,   // every other frame, no IK
+        Minimal    // every fourth frame, no IK
+    };
+
     Rig() {}
     virtual ~Rig() {}
 
@@ -147,8 +156,20 @@ public:
     void computeMotionAnimationState(float deltaTime, const glm::vec3& worldPosition, const glm::vec3& worldVelocity, const glm::quat& worldRotation, CharacterControllerState ccState);
 
     // Regardless of who started the animations or how many, update the joints.
+    // When the rig belongs to a RigBatch, the evaluation is deferred to RigBatch::evaluate().
     void updateAnimations(float deltaTime, glm::mat4 rootTransform);
 
+    // The steps of updateAnimations(). prepareAnimations() and publishAnimations() must be called from the
+    // thread that owns the rig, evaluateAnimations() can run on any thread in between.
+    void prepareAnimations(float deltaTime, glm::mat4 rootTransform);
+    void evaluateAnimations();
+    void publishAnimations();
+
+    void setRigBatch(std::weak_ptr<RigBatch> rigBatch) { _rigBatch = rigBatch; }
+
+    void setAnimationLOD(AnimationLOD lod);
+    AnimationLOD getAnimationLOD() const { return _animationLOD; }
+
     // legacy
     void inverseKinematics(int endIndex, glm::vec3 targetPosition, const glm::quat& targetRotation, float priority,
                            const QVector<int>& freeLineage, glm::mat4 rootTransform);
@@ -221,6 +242,7 @@ protected:
     bool isIndexValid(int index) const { return _animSkeleton && index >= 0 && index < _animSkeleton->getNumJoints(); }
     void updateAnimationStateHandlers();
     void applyOverridePoses();
+    void applyJointData(const QVector<JointData>& jointDataVec);
     void buildAbsoluteRigPoses(const AnimPoseVec& relativePoses, AnimPoseVec& absolutePosesOut);
 
     void updateNeckJoint(int index, const HeadParameters& params);
@@ -249,6 +271,10 @@ protected:
 
     AnimPoseVec _absoluteDefaultPoses; // rig space, not relative to parent.
 
+    // scratch buffers for buildAbsoluteRigPoses
+    AnimPoseBuffer _relativePoseBuffer;
+    AnimPoseBuffer _absolutePoseBuffer;
+
     glm::mat4 _geometryToRigTransform;
     glm::mat4 _rigToGeometryTransform;
 
@@ -319,6 +345,16 @@ protected:
 
     mutable uint32_t _jointNameWarningCount { 0 };
 
+    std::weak_ptr<RigBatch> _rigBatch;
+    QVector<JointData> _pendingJointData;  // joint data waiting for evaluateAnimations()
+    bool _hasPendingJointData { false };
+    AnimNode::Triggers _triggersOut;
+
+    AnimationLOD _animationLOD { AnimationLOD::Full };
+    float _lodDeltaTime { 0.0f };  // time since the last evaluation
+    int _lodFrameCount { 0 };      // frames since the last evaluation
+    bool _skipEvaluation { false };
+
 private:
     QMap<int, StateHandler> _stateHandlers;
     int _nextStateHandlerId { 0 };
@@ -0,0 +1,81 @@
+//
+//  RigBatch.cpp
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "RigBatch.h"
+
+#include <algorithm>
+#include <functional>
+
+#include <QRunnable>
+#include <QThread>
+
+#include <NumericalConstants.h>
+#include <Profile.h>
+#include <SharedUtil.h>
+
+// below this many rigs, waking up the workers costs more than it saves
+static const int MIN_RIGS_PER_THREAD = 4;
+
+class RigBatchWorker : public QRunnable {
+public:
+    RigBatchWorker(std::function<void()> work) : _work(work) {}
+    void run() override { _work(); }
+
+private:
+    std::function<void()> _work;
+};
+
+RigBatch::RigBatch() {
+    // leave a core for the main and render threads
+    _pool.setMaxThreadCount(std::max(QThread::idealThreadCount() - 2, 1));
+    _pool.setExpiryTimeout(-1);
+}
+
+RigBatch::~RigBatch() {
+    _pool.waitForDone();
+}
+
+void RigBatch::setMaxThreadCount(int maxThreadCount) {
+    _pool.setMaxThreadCount(std::max(maxThreadCount, 1));
+}
+
+void RigBatch::queue(RigPointer rig) {
+    if (std::find(_queue.begin(), _queue.end(), rig) == _queue.end()) {
+        _queue.push_back(rig);
+    }
+}
+
+void RigBatch::evaluateQueued() {
+    size_t index;
+    while ((index = _nextRig++) < _queue.size()) {
+        _queue[index]->evaluateAnimations();
+    }
+}
+
+void RigBatch::evaluate() {
+    PROFILE_RANGE(simulation_animation, "RigBatch::evaluate");
+    uint64_t start = usecTimestampNow();
+
+    _nextRig = 0;
+
+    int numWorkers = std::min((int)_queue.size() / MIN_RIGS_PER_THREAD, _pool.maxThreadCount());
+    for (int i = 0; i < numWorkers; i++) {
+        _pool.start(new RigBatchWorker([this] { evaluateQueued(); }));
+    }
+    evaluateQueued();
+    _pool.waitForDone();
+
+    for (auto& rig : _queue) {
+        rig->publishAnimations();
+    }
+
+    _numEvaluated = (int)_queue.size();
+    _queue.clear();
+    _evaluationTime = (float)(usecTimestampNow() - start) / (float)USECS_PER_MSEC;
+}
@@ -0,0 +1,62 @@
+//
+//  RigBatch.h
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_RigBatch_h
+#define hifi_RigBatch_h
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include <QThreadPool>
+
+#include "Rig.h"
+
+// Evaluates the animation of many rigs in parallel.
+//
+// Rigs that belong to a batch (see Rig::setRigBatch) only gather their inputs in Rig::updateAnimations()
+// and queue themselves. evaluate() then runs the graphs, IK and pose conversions of all queued rigs
+// on a dedicated thread pool, and publishes the results on the calling thread.
+// Each rig owns the scratch buffers it evaluates into, so workers never share memory.
+
+class RigBatch {
+public:
+    using Pointer = std::shared_ptr<RigBatch>;
+
+    RigBatch();
+    ~RigBatch();
+
+    // called by Rig::updateAnimations(), a rig queued more than once is evaluated once.
+    void queue(RigPointer rig);
+
+    // evaluates and publishes all queued rigs, blocks until they are done.
+    void evaluate();
+
+    int getNumQueued() const { return (int)_queue.size(); }
+
+    // number of worker threads, the calling thread always takes part in the evaluation.
+    void setMaxThreadCount(int maxThreadCount);
+    int getMaxThreadCount() const { return _pool.maxThreadCount(); }
+
+    // stats of the last evaluate()
+    int getNumEvaluated() const { return _numEvaluated; }
+    float getEvaluationTime() const { return _evaluationTime; }  // msecs
+
+protected:
+    void evaluateQueued();
+
+    std::vector<RigPointer> _queue;
+    std::atomic<size_t> _nextRig { 0 };
+    QThreadPool _pool;
+
+    int _numEvaluated { 0 };
+    float _evaluationTime { 0.0f };
+};
+
+#endif // hifi_RigBatch_h
@@ -45,6 +45,7 @@
 
 #include "AudioClientLogging.h"
 #include "AudioLogging.h"
+#include "VirtualAudioDevice.h"
 
 #include "AudioClient.h"
 
@@ -552,9 +553,7 @@ void possibleResampling(AudioSRC* resampler,
     }
 }
 
-void AudioClient::start() {
-
-    // set up the desired audio format
+void AudioClient::setupDesiredFormats() {
     _desiredInputFormat.setSampleRate(AudioConstants::SAMPLE_RATE);
     _desiredInputFormat.setSampleSize(16);
     _desiredInputFormat.setCodec("audio/pcm");
@@ -564,6 +563,12 @@ void AudioClient::start() {
 
     _desiredOutputFormat = _desiredInputFormat;
     _desiredOutputFormat.setChannelCount(OUTPUT_CHANNEL_COUNT);
+}
+
+void AudioClient::start() {
+
+    // set up the desired audio format
+    setupDesiredFormats();
 
     QAudioDeviceInfo inputDeviceInfo = defaultAudioDeviceForMode(QAudio::AudioInput);
     qCDebug(audioclient) << "The default audio input device is" << inputDeviceInfo.deviceName();
@@ -611,7 +616,7 @@ void AudioClient::handleAudioDataPacket(QSharedPointer<ReceivedMessage> message)
     auto nodeList = DependencyManager::get<NodeList>();
     nodeList->flagTimeForConnectionStep(LimitedNodeList::ConnectionStep::ReceiveFirstAudioPacket);
 
-    if (_audioOutput) {
+    if (_audioOutput || _virtualAudioDevice) {
 
         if (!_hasReceivedFirstPacket) {
             _hasReceivedFirstPacket = true;
@@ -890,7 +895,7 @@ void AudioClient::setReverbOptions(const AudioEffectOptions* options) {
 void AudioClient::handleLocalEchoAndReverb(QByteArray& inputByteArray) {
     // If there is server echo, reverb will be applied to the recieved audio stream so no need to have it here.
     bool hasReverb = _reverb || _receivedAudioStream.hasReverb();
-    if (_muted || !_audioOutput || (!_shouldEchoLocally && !hasReverb)) {
+    if (_muted || !(_audioOutput || _virtualAudioDevice) || (!_shouldEchoLocally && !hasReverb)) {
         return;
     }
 
@@ -915,6 +920,8 @@ void AudioClient::handleLocalEchoAndReverb(QByteArray& inputByteArray) {
         if (!_loopbackOutputDevice) {
             return;
         }
+    } else if (!_loopbackOutputDevice && _virtualAudioDevice) {
+        _loopbackOutputDevice = _virtualAudioDevice->startLoopback();
     }
 
     static QByteArray loopBackByteArray;
@@ -1319,7 +1326,7 @@ void AudioClient::setIsStereoInput(bool isStereoInput) {
 
 bool AudioClient::outputLocalInjector(AudioInjector* injector) {
     Lock lock(_injectorsMutex);
-    if (injector->getLocalBuffer() && _audioInput ) {
+    if (injector->getLocalBuffer() && (_audioInput || _virtualAudioDevice)) {
         // just add it to the vector of active local injectors, if 
         // not already there.
         // Since this is invoked with invokeMethod, there _should_ be
@@ -1348,6 +1355,8 @@ void AudioClient::outputFormatChanged() {
 bool AudioClient::switchInputToAudioDevice(const QAudioDeviceInfo& inputDeviceInfo) {
     bool supportedFormat = false;
 
+    releaseVirtualAudioDevice();
+
     // cleanup any previously initialized device
     if (_audioInput) {
         // The call to stop() causes _inputDevice to be destructed.
@@ -1377,20 +1386,7 @@ bool AudioClient::switchInputToAudioDevice(const QAudioDeviceInfo& inputDeviceIn
             qCDebug(audioclient) << "The format to be used for audio input is" << _inputFormat;
 
             // we've got the best we can get for input
-            // if required, setup a resampler for this input to our desired network format
-            if (_inputFormat != _desiredInputFormat
-                && _inputFormat.sampleRate() != _desiredInputFormat.sampleRate()) {
-                qCDebug(audioclient) << "Attemping to create a resampler for input format to network format.";
-
-                assert(_inputFormat.sampleSize() == 16);
-                assert(_desiredInputFormat.sampleSize() == 16);
-                int channelCount = (_inputFormat.channelCount() == 2 && _desiredInputFormat.channelCount() == 2) ? 2 : 1;
-
-                _inputToNetworkResampler = new AudioSRC(_inputFormat.sampleRate(), _desiredInputFormat.sampleRate(), channelCount);
-
-            } else {
-                qCDebug(audioclient) << "No resampling required for audio input to match desired network format.";
-            }
+            createInputResampler();
 
             // if the user wants stereo but this device can't provide then bail
             if (!_isStereoInput || _inputFormat.channelCount() == 2) {
@@ -1420,6 +1416,23 @@ bool AudioClient::switchInputToAudioDevice(const QAudioDeviceInfo& inputDeviceIn
     return supportedFormat;
 }
 
+void AudioClient::createInputResampler() {
+    // if required, setup a resampler for this input to our desired network format
+    if (_inputFormat != _desiredInputFormat
+        && _inputFormat.sampleRate() != _desiredInputFormat.sampleRate()) {
+        qCDebug(audioclient) << "Attemping to create a resampler for input format to network format.";
+
+        assert(_inputFormat.sampleSize() == 16);
+        assert(_desiredInputFormat.sampleSize() == 16);
+        int channelCount = (_inputFormat.channelCount() == 2 && _desiredInputFormat.channelCount() == 2) ? 2 : 1;
+
+        _inputToNetworkResampler = new AudioSRC(_inputFormat.sampleRate(), _desiredInputFormat.sampleRate(), channelCount);
+
+    } else {
+        qCDebug(audioclient) << "No resampling required for audio input to match desired network format.";
+    }
+}
+
 void AudioClient::outputNotify() {
     int recentUnfulfilled = _audioOutputIODevice.getRecentUnfulfilledReads();
     if (recentUnfulfilled > 0) {
@@ -1453,6 +1466,8 @@ void AudioClient::outputNotify() {
 bool AudioClient::switchOutputToAudioDevice(const QAudioDeviceInfo& outputDeviceInfo) {
     bool supportedFormat = false;
 
+    releaseVirtualAudioDevice();
+
     RecursiveLock lock(_localAudioMutex);
     _localSamplesAvailable.exchange(0, std::memory_order_release);
 
@@ -1494,20 +1509,7 @@ bool AudioClient::switchOutputToAudioDevice(const QAudioDeviceInfo& outputDevice
             qCDebug(audioclient) << "The format to be used for audio output is" << _outputFormat;
 
             // we've got the best we can get for input
-            // if required, setup a resampler for this input to our desired network format
-            if (_desiredOutputFormat != _outputFormat
-                && _desiredOutputFormat.sampleRate() != _outputFormat.sampleRate()) {
-                qCDebug(audioclient) << "Attemping to create a resampler for network format to output format.";
-
-                assert(_desiredOutputFormat.sampleSize() == 16);
-                assert(_outputFormat.sampleSize() == 16);
-
-                _networkToOutputResampler = new AudioSRC(_desiredOutputFormat.sampleRate(), _outputFormat.sampleRate(), OUTPUT_CHANNEL_COUNT);
-                _localToOutputResampler = new AudioSRC(_desiredOutputFormat.sampleRate(), _outputFormat.sampleRate(), OUTPUT_CHANNEL_COUNT);
-
-            } else {
-                qCDebug(audioclient) << "No resampling required for network output to match actual output format.";
-            }
+            createOutputResamplers();
 
             outputFormatChanged();
 
@@ -1517,7 +1519,7 @@ bool AudioClient::switchOutputToAudioDevice(const QAudioDeviceInfo& outputDevice
             int osDefaultBufferSize = _audioOutput->bufferSize();
             int deviceChannelCount = _outputFormat.channelCount();
             int deviceFrameSize = (AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL * deviceChannelCount * _outputFormat.sampleRate()) / _desiredOutputFormat.sampleRate();
-            int requestedSize = _sessionOutputBufferSizeFrames * deviceFrameSize * AudioConstants::SAMPLE_SIZE;
+            int requestedSize = calculateNumberOfOutputBufferBytes(_outputFormat);
             _audioOutput->setBufferSize(requestedSize);
 
             connect(_audioOutput, &QAudioOutput::notify, this, &AudioClient::outputNotify);
@@ -1530,12 +1532,7 @@ bool AudioClient::switchOutputToAudioDevice(const QAudioDeviceInfo& outputDevice
             lock.unlock();
 
             int periodSampleSize = _audioOutput->periodSize() / AudioConstants::SAMPLE_SIZE;
-            // device callback is not restricted to periodSampleSize, so double the mix/scratch buffer sizes
-            _outputPeriod = periodSampleSize * 2;
-            _outputMixBuffer = new float[_outputPeriod];
-            _outputScratchBuffer = new int16_t[_outputPeriod];
-            _localOutputMixBuffer = new float[_outputPeriod];
-            _localInjectorsStream.resizeForFrameSize(_outputPeriod * 2);
+            allocateOutputBuffers(periodSampleSize);
 
             qCDebug(audioclient) << "Output Buffer capacity in frames: " << _audioOutput->bufferSize() / AudioConstants::SAMPLE_SIZE / (float)deviceFrameSize <<
                 "requested bytes:" << requestedSize << "actual bytes:" << _audioOutput->bufferSize() <<
@@ -1553,6 +1550,109 @@ bool AudioClient::switchOutputToAudioDevice(const QAudioDeviceInfo& outputDevice
     return supportedFormat;
 }
 
+void AudioClient::createOutputResamplers() {
+    // if required, setup a resampler for this input to our desired network format
+    if (_desiredOutputFormat != _outputFormat
+        && _desiredOutputFormat.sampleRate() != _outputFormat.sampleRate()) {
+        qCDebug(audioclient) << "Attemping to create a resampler for network format to output format.";
+
+        assert(_desiredOutputFormat.sampleSize() == 16);
+        assert(_outputFormat.sampleSize() == 16);
+
+        _networkToOutputResampler = new AudioSRC(_desiredOutputFormat.sampleRate(), _outputFormat.sampleRate(), OUTPUT_CHANNEL_COUNT);
+        _localToOutputResampler = new AudioSRC(_desiredOutputFormat.sampleRate(), _outputFormat.sampleRate(), OUTPUT_CHANNEL_COUNT);
+
+    } else {
+        qCDebug(audioclient) << "No resampling required for network output to match actual output format.";
+    }
+}
+
+void AudioClient::allocateOutputBuffers(int periodSampleSize) {
+    // device callback is not restricted to periodSampleSize, so double the mix/scratch buffer sizes
+    _outputPeriod = periodSampleSize * 2;
+    _outputMixBuffer = new float[_outputPeriod];
+    _outputScratchBuffer = new int16_t[_outputPeriod];
+    _localOutputMixBuffer = new float[_outputPeriod];
+    _localInjectorsStream.resizeForFrameSize(_outputPeriod * 2);
+}
+
+bool AudioClient::switchToVirtualAudioDevice(VirtualAudioDevice* device) {
+    // shut down the system devices, and any virtual device before this one
+    switchInputToAudioDevice(QAudioDeviceInfo());
+    switchOutputToAudioDevice(QAudioDeviceInfo());
+
+    if (!device) {
+        return false;
+    }
+
+    setupDesiredFormats();
+    _inputFormat = device->getInputFormat();
+    _outputFormat = device->getOutputFormat();
+    if (_isStereoInput && _inputFormat.channelCount() != 2) {
+        qCDebug(audioclient) << "The virtual audio device has no stereo input.";
+        return false;
+    }
+    qCDebug(audioclient) << "Switching to a virtual audio device, input" << _inputFormat << "output" << _outputFormat;
+
+    _virtualAudioDevice = device;
+    _inputAudioDeviceName = _outputAudioDeviceName = "Virtual";
+
+    // input, with the same buffering as a system device
+    createInputResampler();
+    _numInputCallbackBytes = calculateNumberOfInputCallbackBytes(_inputFormat);
+    _inputRingBuffer.resizeForFrameSize(calculateNumberOfFrameSamples(_numInputCallbackBytes));
+    _inputDevice = device->startInput();
+    connect(_inputDevice, SIGNAL(readyRead()), this, SLOT(handleAudioInput()));
+
+    // output
+    RecursiveLock lock(_localAudioMutex);
+    createOutputResamplers();
+    outputFormatChanged();
+    allocateOutputBuffers(device->getPeriodBytes(_outputFormat) / AudioConstants::SAMPLE_SIZE);
+    lock.unlock();
+
+    connect(device, &VirtualAudioDevice::notify, this, &AudioClient::outputNotify);
+    _audioOutputIODevice.start();
+    device->startOutput(&_audioOutputIODevice, calculateNumberOfOutputBufferBytes(_outputFormat));
+    _timeSinceLastReceived.start();
+
+    return true;
+}
+
+void AudioClient::releaseVirtualAudioDevice() {
+    if (!_virtualAudioDevice) {
+        return;
+    }
+
+    RecursiveLock lock(_localAudioMutex);
+    _localSamplesAvailable.exchange(0, std::memory_order_release);
+
+    // the device owns the input and loopback devices, stop() destroys them
+    disconnect(_virtualAudioDevice, nullptr, this, nullptr);
+    _virtualAudioDevice->stop();
+    _virtualAudioDevice = nullptr;
+    _inputDevice = NULL;
+    _loopbackOutputDevice = NULL;
+    _numInputCallbackBytes = 0;
+    _inputAudioDeviceName = _outputAudioDeviceName = "";
+    _audioOutputIODevice.stop();
+
+    delete _inputToNetworkResampler;
+    _inputToNetworkResampler = NULL;
+    delete _networkToOutputResampler;
+    _networkToOutputResampler = NULL;
+    delete _localToOutputResampler;
+    _localToOutputResampler = NULL;
+
+    delete[] _outputMixBuffer;
+    _outputMixBuffer = NULL;
+    delete[] _outputScratchBuffer;
+    _outputScratchBuffer = NULL;
+    delete[] _localOutputMixBuffer;
+    _localOutputMixBuffer = NULL;
+    _outputPeriod = 0;
+}
+
 int AudioClient::setOutputBufferSize(int numFrames, bool persist) {
     numFrames = std::min(std::max(numFrames, MIN_BUFFER_FRAMES), MAX_BUFFER_FRAMES);
     if (numFrames != _sessionOutputBufferSizeFrames) {
@@ -1562,7 +1662,9 @@ int AudioClient::setOutputBufferSize(int numFrames, bool persist) {
             _outputBufferSizeFrames.set(numFrames);
         }
 
-        if (_audioOutput) {
+        if (_virtualAudioDevice) {
+            _virtualAudioDevice->setOutputBufferBytes(calculateNumberOfOutputBufferBytes(_outputFormat));
+        } else if (_audioOutput) {
             // The buffer size can't be adjusted after QAudioOutput::start() has been called, so
             // recreate the device by switching to the default.
             QAudioDeviceInfo outputDeviceInfo = defaultAudioDeviceForMode(QAudio::AudioOutput);
@@ -1602,6 +1704,12 @@ int AudioClient::calculateNumberOfFrameSamples(int numBytes) const {
     return frameSamples;
 }
 
+int AudioClient::calculateNumberOfOutputBufferBytes(const QAudioFormat& format) const {
+    int deviceFrameSize = (AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL * format.channelCount() * format.sampleRate()) /
+        _desiredOutputFormat.sampleRate();
+    return _sessionOutputBufferSizeFrames * deviceFrameSize * AudioConstants::SAMPLE_SIZE;
+}
+
 float AudioClient::azimuthForSource(const glm::vec3& relativePosition) {
     // copied from AudioMixer, more or less
     glm::quat inverseOrientation = glm::inverse(_orientationGetter());
@@ -1705,7 +1813,8 @@ qint64 AudioClient::AudioOutputIODevice::readData(char * data, qint64 maxSize) {
         bytesWritten = maxSize;
     }
 
-    int bytesAudioOutputUnplayed = _audio->_audioOutput->bufferSize() - _audio->_audioOutput->bytesFree();
+    int bytesAudioOutputUnplayed = _audio->_virtualAudioDevice ? _audio->_virtualAudioDevice->getOutputBytesUnplayed() :
+        _audio->_audioOutput->bufferSize() - _audio->_audioOutput->bytesFree();
     float msecsAudioOutputUnplayed = bytesAudioOutputUnplayed / (float)_audio->_outputFormat.bytesForDuration(USECS_PER_MSEC);
     _audio->_stats.updateOutputMsUnplayed(msecsAudioOutputUnplayed);
 
@@ -64,6 +64,7 @@
 class QAudioInput;
 class QAudioOutput;
 class QIODevice;
+class VirtualAudioDevice;
 
 
 class Transform;
@@ -197,6 +198,11 @@ public slots:
 
     bool switchInputToAudioDevice(const QString& inputDeviceName);
     bool switchOutputToAudioDevice(const QString& outputDeviceName);
+
+    // runs input and output on a virtual device until stop() or a switch to a system device,
+    // the device must live on this thread until then
+    bool switchToVirtualAudioDevice(VirtualAudioDevice* device);
+
     QString getDeviceName(QAudio::Mode mode) const { return (mode == QAudio::AudioInput) ?
                                                             _inputAudioDeviceName : _outputAudioDeviceName; }
     QString getDefaultDeviceName(QAudio::Mode mode);
@@ -282,6 +288,7 @@ private:
     int _numOutputCallbackBytes;
     QAudioOutput* _loopbackAudioOutput;
     QIODevice* _loopbackOutputDevice;
+    VirtualAudioDevice* _virtualAudioDevice { nullptr };
     AudioRingBuffer _inputRingBuffer;
     LocalInjectorsStream _localInjectorsStream;
     // In order to use _localInjectorsStream as a lock-free pipe,
@@ -349,10 +356,18 @@ private:
 
     bool switchInputToAudioDevice(const QAudioDeviceInfo& inputDeviceInfo);
     bool switchOutputToAudioDevice(const QAudioDeviceInfo& outputDeviceInfo);
+    void releaseVirtualAudioDevice();
+
+    // shared by the system and virtual devices, once _inputFormat or _outputFormat is set
+    void setupDesiredFormats();
+    void createInputResampler();
+    void createOutputResamplers();
+    void allocateOutputBuffers(int periodSamples);
 
     // Callback acceleration dependent calculations
     int calculateNumberOfInputCallbackBytes(const QAudioFormat& format) const;
     int calculateNumberOfFrameSamples(int numBytes) const;
+    int calculateNumberOfOutputBufferBytes(const QAudioFormat& format) const;
 
     quint16 _outgoingAvatarAudioSequenceNumber;
 
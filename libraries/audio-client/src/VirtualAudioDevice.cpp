@@ -0,0 +1,328 @@
+//
+//  VirtualAudioDevice.cpp
+//  libraries/audio-client/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "VirtualAudioDevice.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include <QtCore/QtEndian>
+
+#include <AudioConstants.h>
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+
+#include "AudioClientLogging.h"
+
+const int VirtualAudioDevice::DEFAULT_PERIOD_USECS = AudioConstants::NETWORK_FRAME_USECS / 2;
+
+// loopback audio queued past this is dropped, as a device would when its writer runs ahead
+static const int MAX_LOOPBACK_USECS = USECS_PER_SECOND;
+
+static QAudioFormat makeFormat(int sampleRate, int numChannels) {
+    QAudioFormat format;
+    format.setSampleRate(sampleRate);
+    format.setChannelCount(numChannels);
+    format.setSampleSize(16);
+    format.setCodec("audio/pcm");
+    format.setSampleType(QAudioFormat::SignedInt);
+    format.setByteOrder(QAudioFormat::LittleEndian);
+    return format;
+}
+
+// unlike QAudioFormat::framesForDuration, doesn't overflow in a long run
+static quint64 framesForUsecs(const QAudioFormat& format, quint64 usecs) {
+    return usecs * format.sampleRate() / USECS_PER_SECOND;
+}
+
+ToneAudioSource::ToneAudioSource(int sampleRate, float frequency, float amplitude, int burstFrames, int intervalFrames) :
+    _phaseIncrement(TWO_PI * frequency / sampleRate),
+    _amplitude(amplitude),
+    _burstFrames(burstFrames),
+    _intervalFrames(intervalFrames) {}
+
+void ToneAudioSource::read(int16_t* samples, int numFrames, int numChannels) {
+    for (int i = 0; i < numFrames; ++i, ++_frame) {
+        bool isOn = _intervalFrames <= 0 || (int)(_frame % _intervalFrames) < _burstFrames;
+
+        // restart the phase with every burst, so each one begins the same way
+        quint64 phaseFrame = _intervalFrames > 0 ? _frame % _intervalFrames : _frame;
+        float value = isOn ? _amplitude * sinf(_phaseIncrement * (float)phaseFrame) : 0.0f;
+
+        int16_t sample = (int16_t)(value * AudioConstants::MAX_SAMPLE_VALUE);
+        for (int channel = 0; channel < numChannels; ++channel) {
+            *samples++ = sample;
+        }
+    }
+}
+
+void NoiseAudioSource::read(int16_t* samples, int numFrames, int numChannels) {
+    for (int i = 0; i < numFrames * numChannels; ++i) {
+        float value = ((float)_generator() / (float)std::mt19937::max()) * 2.0f - 1.0f;
+        samples[i] = (int16_t)(_amplitude * value * AudioConstants::MAX_SAMPLE_VALUE);
+    }
+}
+
+FileAudioSource::FileAudioSource(const QString& path) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qCWarning(audioclient) << "Could not open virtual audio source" << path;
+        return;
+    }
+    QByteArray contents = file.readAll();
+
+    // take the data chunk of a WAV file, anything else is raw PCM
+    if (contents.startsWith("RIFF") && contents.mid(8, 4) == "WAVE") {
+        const int RIFF_HEADER_BYTES = 12;
+        const int CHUNK_HEADER_BYTES = 8;
+        int position = RIFF_HEADER_BYTES;
+        while (position + CHUNK_HEADER_BYTES <= contents.size()) {
+            quint32 chunkBytes = qFromLittleEndian<quint32>((const uchar*)contents.constData() + position + 4);
+            if (contents.mid(position, 4) == "data") {
+                _samples = contents.mid(position + CHUNK_HEADER_BYTES, chunkBytes);
+                break;
+            }
+            position += CHUNK_HEADER_BYTES + chunkBytes + (chunkBytes & 1);
+        }
+    } else {
+        _samples = contents;
+    }
+
+    _samples.truncate(_samples.size() - _samples.size() % AudioConstants::SAMPLE_SIZE);
+    if (_samples.isEmpty()) {
+        qCWarning(audioclient) << "No audio in virtual audio source" << path;
+    }
+}
+
+void FileAudioSource::read(int16_t* samples, int numFrames, int numChannels) {
+    int bytes = numFrames * numChannels * AudioConstants::SAMPLE_SIZE;
+    char* destination = reinterpret_cast<char*>(samples);
+    if (_samples.isEmpty()) {
+        memset(destination, 0, bytes);
+        return;
+    }
+
+    // loop the file
+    while (bytes > 0) {
+        int chunk = std::min(bytes, _samples.size() - _position);
+        memcpy(destination, _samples.constData() + _position, chunk);
+        destination += chunk;
+        bytes -= chunk;
+        _position = (_position + chunk) % _samples.size();
+    }
+}
+
+FileAudioSink::FileAudioSink(const QString& path) : _file(path) {
+    if (!_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qCWarning(audioclient) << "Could not open virtual audio sink" << path;
+    }
+}
+
+void FileAudioSink::write(const int16_t* samples, int numFrames, int numChannels) {
+    if (_file.isOpen()) {
+        _file.write(reinterpret_cast<const char*>(samples), numFrames * numChannels * AudioConstants::SAMPLE_SIZE);
+    }
+}
+
+// a sequential device over a byte queue, written on one side and read on the other
+class VirtualAudioDevice::Buffer : public QIODevice {
+public:
+    Buffer() { open(QIODevice::ReadWrite | QIODevice::Unbuffered); }
+
+    bool isSequential() const override { return true; }
+    qint64 bytesAvailable() const override { return _data.size() + QIODevice::bytesAvailable(); }
+
+    void append(const char* data, int size) { _data.append(data, size); }
+    void truncateFront(int maxSize) {
+        if (_data.size() > maxSize) {
+            _data.remove(0, _data.size() - maxSize);
+        }
+    }
+
+protected:
+    qint64 readData(char* data, qint64 maxSize) override {
+        int size = (int)std::min(maxSize, (qint64)_data.size());
+        memcpy(data, _data.constData(), size);
+        _data.remove(0, size);
+        return size;
+    }
+    qint64 writeData(const char* data, qint64 size) override {
+        _data.append(data, (int)size);
+        return size;
+    }
+
+private:
+    QByteArray _data;
+};
+
+VirtualAudioDevice::VirtualAudioDevice(int inputSampleRate, int inputChannels, int outputSampleRate, int outputChannels,
+                                       int periodUsecs) :
+    _inputFormat(makeFormat(inputSampleRate, inputChannels)),
+    _outputFormat(makeFormat(outputSampleRate, outputChannels)),
+    _periodUsecs(periodUsecs),
+    _timer(this)
+{
+    _timer.setTimerType(Qt::PreciseTimer);
+    connect(&_timer, &QTimer::timeout, this, &VirtualAudioDevice::render);
+}
+
+VirtualAudioDevice::~VirtualAudioDevice() {
+    stop();
+}
+
+int VirtualAudioDevice::getPeriodBytes(const QAudioFormat& format) const {
+    return format.bytesForDuration(_periodUsecs);
+}
+
+QIODevice* VirtualAudioDevice::startInput() {
+    startClock();
+    _inputDevice.reset(new Buffer());
+
+    // capture from now on, like a device opened mid-stream
+    _inputStartUsecs = _clock.nsecsElapsed() / NSECS_PER_USEC;
+    _inputFrames = framesForUsecs(_inputFormat, _inputStartUsecs);
+    return _inputDevice.get();
+}
+
+void VirtualAudioDevice::startOutput(QIODevice* device, int bufferBytes) {
+    startClock();
+    _outputDevice = device;
+    _outputBuffer.clear();
+    setOutputBufferBytes(bufferBytes);
+    _outputStartUsecs = _clock.nsecsElapsed() / NSECS_PER_USEC;
+    _outputFrames = framesForUsecs(_outputFormat, _outputStartUsecs);
+    _outputFramesSinceNotify = 0;
+
+    // prime the buffer, so the first period has something to play
+    Period period;
+    playOutput(0, period);
+}
+
+QIODevice* VirtualAudioDevice::startLoopback() {
+    if (!_loopbackDevice) {
+        _loopbackDevice.reset(new Buffer());
+    }
+    return _loopbackDevice.get();
+}
+
+void VirtualAudioDevice::stop() {
+    _timer.stop();
+    _clock.invalidate();
+    _inputDevice.reset();
+    _loopbackDevice.reset();
+    _outputDevice = nullptr;
+    _outputBuffer.clear();
+}
+
+void VirtualAudioDevice::startClock() {
+    if (!_clock.isValid()) {
+        _clock.start();
+        _timer.start(std::max(_periodUsecs / (int)USECS_PER_MSEC, 1));
+    }
+}
+
+void VirtualAudioDevice::render() {
+    Period period;
+    period.timestampUsecs = _clock.nsecsElapsed() / NSECS_PER_USEC;
+
+    if (_inputDevice) {
+        quint64 framesDue = framesForUsecs(_inputFormat, period.timestampUsecs);
+        captureInput((int)(framesDue - _inputFrames), period);
+    }
+    if (_outputDevice) {
+        quint64 framesDue = framesForUsecs(_outputFormat, period.timestampUsecs);
+        playOutput((int)(framesDue - _outputFrames), period);
+    }
+
+    if (_periodListener && (period.inputFrames > 0 || period.outputFrames > 0)) {
+        _periodListener(period);
+    }
+}
+
+void VirtualAudioDevice::captureInput(int numFrames, Period& period) {
+    if (numFrames <= 0) {
+        return;
+    }
+
+    int numChannels = _inputFormat.channelCount();
+    int bytes = numFrames * numChannels * AudioConstants::SAMPLE_SIZE;
+    _scratch.resize(bytes);
+    int16_t* samples = reinterpret_cast<int16_t*>(_scratch.data());
+    if (_source) {
+        _source->read(samples, numFrames, numChannels);
+    } else {
+        memset(samples, 0, bytes);
+    }
+    _inputDevice->append(_scratch.constData(), bytes);
+    _inputFrames += numFrames;
+
+    // the pipeline reads the input in readyRead, when it is connected directly
+    QElapsedTimer timer;
+    timer.start();
+    emit _inputDevice->readyRead();
+    period.inputUsecs = timer.nsecsElapsed() / NSECS_PER_USEC;
+    period.inputFrames = numFrames;
+}
+
+void VirtualAudioDevice::playOutput(int numFrames, Period& period) {
+    int numChannels = _outputFormat.channelCount();
+    int frameBytes = numChannels * AudioConstants::SAMPLE_SIZE;
+
+    if (numFrames > 0) {
+        int bytes = numFrames * frameBytes;
+        int bytesQueued = std::min(bytes, _outputBuffer.size());
+
+        _scratch.resize(bytes);
+        memcpy(_scratch.data(), _outputBuffer.constData(), bytesQueued);
+        memset(_scratch.data() + bytesQueued, 0, bytes - bytesQueued);
+        _outputBuffer.remove(0, bytesQueued);
+        period.underrunFrames = (bytes - bytesQueued) / frameBytes;
+
+        // mix in the loopback, saturating as the OS mixer would
+        int16_t* samples = reinterpret_cast<int16_t*>(_scratch.data());
+        if (_loopbackDevice) {
+            _loopbackDevice->truncateFront(_outputFormat.bytesForDuration(MAX_LOOPBACK_USECS));
+            QByteArray loopback = _loopbackDevice->read(bytes);
+            const int16_t* loopbackSamples = reinterpret_cast<const int16_t*>(loopback.constData());
+            for (int i = 0; i < loopback.size() / AudioConstants::SAMPLE_SIZE; ++i) {
+                int sum = samples[i] + loopbackSamples[i];
+                samples[i] = (int16_t)std::min(std::max(sum, (int)AudioConstants::MIN_SAMPLE_VALUE),
+                                               (int)AudioConstants::MAX_SAMPLE_VALUE);
+            }
+        }
+
+        if (_sink) {
+            _sink->write(samples, numFrames, numChannels);
+        }
+        _outputFrames += numFrames;
+        period.outputFrames = numFrames;
+    }
+
+    // refill the buffer a period at a time, as a device pulls
+    QElapsedTimer timer;
+    timer.start();
+    int periodBytes = getPeriodBytes(_outputFormat);
+    periodBytes -= periodBytes % frameBytes;
+    while (_outputDevice && periodBytes > 0 && _outputBuffer.size() + periodBytes <= std::max(getOutputBufferBytes(), periodBytes)) {
+        QByteArray data = _outputDevice->read(periodBytes);
+        if (data.isEmpty()) {
+            break;
+        }
+        _outputBuffer.append(data);
+    }
+    period.outputUsecs = timer.nsecsElapsed() / NSECS_PER_USEC;
+
+    _outputFramesSinceNotify += numFrames > 0 ? numFrames : 0;
+    if (_outputFramesSinceNotify >= (quint64)_outputFormat.sampleRate()) {
+        _outputFramesSinceNotify -= _outputFormat.sampleRate();
+        emit notify();
+    }
+}
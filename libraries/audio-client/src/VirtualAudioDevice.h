@@ -0,0 +1,175 @@
+//
+//  VirtualAudioDevice.h
+//  libraries/audio-client/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_VirtualAudioDevice_h
+#define hifi_VirtualAudioDevice_h
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <random>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFile>
+#include <QtCore/QIODevice>
+#include <QtCore/QObject>
+#include <QtCore/QTimer>
+#include <QtMultimedia/QAudioFormat>
+
+// Fills a virtual input device with interleaved 16-bit frames, in order.
+class VirtualAudioSource {
+public:
+    virtual ~VirtualAudioSource() {}
+    virtual void read(int16_t* samples, int numFrames, int numChannels) = 0;
+};
+
+// Takes what a virtual output device plays, in order.
+class VirtualAudioSink {
+public:
+    virtual ~VirtualAudioSink() {}
+    virtual void write(const int16_t* samples, int numFrames, int numChannels) = 0;
+};
+
+// A sine tone, optionally in bursts starting every intervalFrames, so the bursts can be found again on the way out.
+class ToneAudioSource : public VirtualAudioSource {
+public:
+    ToneAudioSource(int sampleRate, float frequency, float amplitude, int burstFrames = 0, int intervalFrames = 0);
+    void read(int16_t* samples, int numFrames, int numChannels) override;
+
+private:
+    float _phaseIncrement;
+    float _amplitude;
+    int _burstFrames;
+    int _intervalFrames;
+    quint64 _frame { 0 };
+};
+
+class NoiseAudioSource : public VirtualAudioSource {
+public:
+    NoiseAudioSource(float amplitude, unsigned int seed = 1) : _amplitude(amplitude), _generator(seed) {}
+    void read(int16_t* samples, int numFrames, int numChannels) override;
+
+private:
+    float _amplitude;
+    std::mt19937 _generator;
+};
+
+// Loops a 16-bit WAV or raw PCM file. The file should be in the device's input format, it is not converted.
+class FileAudioSource : public VirtualAudioSource {
+public:
+    FileAudioSource(const QString& path);
+    bool isValid() const { return !_samples.isEmpty(); }
+    void read(int16_t* samples, int numFrames, int numChannels) override;
+
+private:
+    QByteArray _samples;
+    int _position { 0 };
+};
+
+// Writes raw 16-bit PCM.
+class FileAudioSink : public VirtualAudioSink {
+public:
+    FileAudioSink(const QString& path);
+    bool isValid() const { return _file.isOpen(); }
+    void write(const int16_t* samples, int numFrames, int numChannels) override;
+
+private:
+    QFile _file;
+};
+
+// An audio input and output that run on a virtual clock instead of hardware, for running the client audio pipeline
+// on a headless machine. Each period it renders the frames due by the monotonic clock, so timer jitter never
+// accumulates into drift: it captures input from its source and signals readyRead like a QAudioInput, and it plays
+// from a buffer it refills by pulling from a QIODevice like a QAudioOutput. Without a source it captures silence,
+// and without a sink what it plays is dropped.
+class VirtualAudioDevice : public QObject {
+    Q_OBJECT
+public:
+    // the cost of one period, on the device's clock
+    struct Period {
+        quint64 timestampUsecs { 0 };
+        int inputFrames { 0 };
+        int outputFrames { 0 };
+        quint64 inputUsecs { 0 }; // spent signalling input to the pipeline
+        quint64 outputUsecs { 0 }; // spent pulling output from it
+        int underrunFrames { 0 }; // played as silence because the output buffer was empty
+    };
+    using PeriodListener = std::function<void(const Period&)>;
+
+    static const int DEFAULT_PERIOD_USECS;
+
+    VirtualAudioDevice(int inputSampleRate, int inputChannels, int outputSampleRate, int outputChannels,
+                       int periodUsecs = DEFAULT_PERIOD_USECS);
+    ~VirtualAudioDevice();
+
+    const QAudioFormat& getInputFormat() const { return _inputFormat; }
+    const QAudioFormat& getOutputFormat() const { return _outputFormat; }
+    int getPeriodBytes(const QAudioFormat& format) const;
+
+    void setSource(std::unique_ptr<VirtualAudioSource> source) { _source = std::move(source); }
+    void setSink(std::unique_ptr<VirtualAudioSink> sink) { _sink = std::move(sink); }
+    void setPeriodListener(PeriodListener listener) { _periodListener = listener; }
+
+    // like QAudioInput::start(), returns the device captured audio is read from
+    QIODevice* startInput();
+    // like QAudioOutput::start(QIODevice*), pulls from device to keep the output buffer full
+    void startOutput(QIODevice* device, int bufferBytes);
+    // like a second QAudioOutput::start(), returns a device whose audio is mixed into the output as it plays
+    QIODevice* startLoopback();
+    void stop();
+
+    void setOutputBufferBytes(int bufferBytes) { _outputBufferBytes.store(bufferBytes); }
+    int getOutputBufferBytes() const { return _outputBufferBytes.load(); }
+    int getOutputBytesUnplayed() const { return _outputBuffer.size(); }
+
+    // when the source's first frame was captured and the sink's first frame played, on the device's clock
+    quint64 getInputStartUsecs() const { return _inputStartUsecs; }
+    quint64 getOutputStartUsecs() const { return _outputStartUsecs; }
+
+signals:
+    // once a second of output played, like QAudioOutput::notify()
+    void notify();
+
+private slots:
+    void render();
+
+private:
+    class Buffer;
+
+    void startClock();
+    void captureInput(int numFrames, Period& period);
+    void playOutput(int numFrames, Period& period);
+
+    QAudioFormat _inputFormat;
+    QAudioFormat _outputFormat;
+    int _periodUsecs;
+
+    std::unique_ptr<VirtualAudioSource> _source;
+    std::unique_ptr<VirtualAudioSink> _sink;
+    PeriodListener _periodListener;
+
+    std::unique_ptr<Buffer> _inputDevice;
+    std::unique_ptr<Buffer> _loopbackDevice;
+    QIODevice* _outputDevice { nullptr };
+    QByteArray _outputBuffer;
+    std::atomic<int> _outputBufferBytes { 0 };
+    QByteArray _scratch;
+
+    QTimer _timer;
+    QElapsedTimer _clock;
+    quint64 _inputStartUsecs { 0 };
+    quint64 _outputStartUsecs { 0 };
+    quint64 _inputFrames { 0 }; // on the clock, since it started
+    quint64 _outputFrames { 0 };
+    quint64 _outputFramesSinceNotify { 0 };
+};
+
+#endif // hifi_VirtualAudioDevice_h
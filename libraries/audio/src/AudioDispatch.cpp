@@ -0,0 +1,41 @@
+//
+//  AudioDispatch.cpp
+//  libraries/audio/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioDispatch.h"
+
+#include <atomic>
+
+#include <CPUDetect.h>
+
+AudioDispatch::Path AudioDispatch::getSupportedPath() {
+    static const Path supportedPath = cpuSupportsAVX512() ? AVX512 : cpuSupportsAVX2() ? AVX2 : BASELINE;
+    return supportedPath;
+}
+
+static std::atomic<int> dispatchPath { AudioDispatch::getSupportedPath() };
+
+AudioDispatch::Path AudioDispatch::getPath() {
+    return (Path)dispatchPath.load(std::memory_order_relaxed);
+}
+
+void AudioDispatch::setPathLimit(Path limit) {
+    dispatchPath.store(limit < getSupportedPath() ? limit : getSupportedPath(), std::memory_order_relaxed);
+}
+
+const char* AudioDispatch::getPathName(Path path) {
+    switch (path) {
+        case AVX2:
+            return "AVX2";
+        case AVX512:
+            return "AVX512";
+        default:
+            return "baseline";
+    }
+}
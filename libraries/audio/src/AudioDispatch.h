@@ -0,0 +1,38 @@
+//
+//  AudioDispatch.h
+//  libraries/audio/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioDispatch_h
+#define hifi_AudioDispatch_h
+
+//
+// Runtime CPU dispatch of the audio DSP kernels (AudioHRTF, AudioSRC, AudioFOA).
+//
+// Kernels use the best code path the CPU supports. Lowering the limit makes them fall back
+// to slower paths, so tests and benchmarks can run every path on one machine.
+//
+namespace AudioDispatch {
+    enum Path {
+        BASELINE,   // the _ref code, or SSE2 where that is the only x86 version
+        AVX2,
+        AVX512
+    };
+
+    Path getSupportedPath();
+
+    // the path kernels dispatch to
+    Path getPath();
+
+    // limit is clamped to what the CPU supports
+    void setPathLimit(Path limit);
+
+    const char* getPathName(Path path);
+}
+
+#endif // hifi_AudioDispatch_h
@@ -925,7 +925,7 @@ static void rotate_3x3_ref(float* buf[4], const float m0[3][3], const float m1[3
 // Runtime CPU dispatch
 //
 
-#include "CPUDetect.h"
+#include "AudioDispatch.h"
 
 void rfft512_AVX2(float buf[512]);
 void rifft512_AVX2(float buf[512]);
@@ -934,27 +934,27 @@ void convertInput_AVX2(int16_t* src, float *dst[4], float gain, int numFrames);
 void rotate_3x3_AVX2(float* buf[4], const float m0[3][3], const float m1[3][3], const float* win, int numFrames);
 
 static void rfft512(float buf[512]) {
-    static auto f = cpuSupportsAVX2() ? rfft512_AVX2 : rfft512_ref;
+    auto f = AudioDispatch::getPath() >= AudioDispatch::AVX2 ? rfft512_AVX2 : rfft512_ref;
     (*f)(buf);  // dispatch
 }
 
 static void rifft512(float buf[512]) {
-    static auto f = cpuSupportsAVX2() ? rifft512_AVX2 : rifft512_ref;
+    auto f = AudioDispatch::getPath() >= AudioDispatch::AVX2 ? rifft512_AVX2 : rifft512_ref;
     (*f)(buf);  // dispatch
 }
 
 static void rfft512_cmadd_1X2(const float src[512], const float coef0[512], const float coef1[512], float dst0[512], float dst1[512]) {
-    static auto f = cpuSupportsAVX2() ? rfft512_cmadd_1X2_AVX2 : rfft512_cmadd_1X2_ref;
+    auto f = AudioDispatch::getPath() >= AudioDispatch::AVX2 ? rfft512_cmadd_1X2_AVX2 : rfft512_cmadd_1X2_ref;
     (*f)(src, coef0, coef1, dst0, dst1);    // dispatch
 }
 
 static void convertInput(int16_t* src, float *dst[4], float gain, int numFrames) {
-    static auto f = cpuSupportsAVX2() ? convertInput_AVX2 : convertInput_ref;
+    auto f = AudioDispatch::getPath() >= AudioDispatch::AVX2 ? convertInput_AVX2 : convertInput_ref;
     (*f)(src, dst, gain, numFrames);  // dispatch
 }
 
 static void rotate_3x3(float* buf[4], const float m0[3][3], const float m1[3][3], const float* win, int numFrames) {
-    static auto f = cpuSupportsAVX2() ? rotate_3x3_AVX2 : rotate_3x3_ref;
+    auto f = AudioDispatch::getPath() >= AudioDispatch::AVX2 ? rotate_3x3_AVX2 : rotate_3x3_ref;
     (*f)(buf, m0, m1, win, numFrames);  // dispatch
 }
 
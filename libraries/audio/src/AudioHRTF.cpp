@@ -232,20 +232,92 @@ static void FIR_1x4_SSE(float* src, float* dst0, float* dst1, float* dst2, float
     }
 }
 
+// 2 channel input, 4 channel output (2 channels per input)
+static void FIR_2x2_SSE(float* src0, float* src1, float* dst0, float* dst1, float* dst2, float* dst3, float coef[4][HRTF_TAPS], int numFrames) {
+
+    float* coef0 = coef[0] + HRTF_TAPS - 1;     // process backwards
+    float* coef1 = coef[1] + HRTF_TAPS - 1;
+    float* coef2 = coef[2] + HRTF_TAPS - 1;
+    float* coef3 = coef[3] + HRTF_TAPS - 1;
+
+    assert(numFrames % 4 == 0);
+
+    for (int i = 0; i < numFrames; i += 4) {
+
+        __m128 acc0 = _mm_setzero_ps();
+        __m128 acc1 = _mm_setzero_ps();
+        __m128 acc2 = _mm_setzero_ps();
+        __m128 acc3 = _mm_setzero_ps();
+
+        float* ps0 = &src0[i - HRTF_TAPS + 1];  // process forwards
+        float* ps1 = &src1[i - HRTF_TAPS + 1];
+
+        assert(HRTF_TAPS % 4 == 0);
+
+        for (int k = 0; k < HRTF_TAPS; k += 4) {
+
+            __m128 x0 = _mm_loadu_ps(&ps0[k+0]);
+            __m128 y0 = _mm_loadu_ps(&ps1[k+0]);
+            acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_load1_ps(&coef0[-k-0]), x0));
+            acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_load1_ps(&coef1[-k-0]), x0));
+            acc2 = _mm_add_ps(acc2, _mm_mul_ps(_mm_load1_ps(&coef2[-k-0]), y0));
+            acc3 = _mm_add_ps(acc3, _mm_mul_ps(_mm_load1_ps(&coef3[-k-0]), y0));
+
+            __m128 x1 = _mm_loadu_ps(&ps0[k+1]);
+            __m128 y1 = _mm_loadu_ps(&ps1[k+1]);
+            acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_load1_ps(&coef0[-k-1]), x1));
+            acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_load1_ps(&coef1[-k-1]), x1));
+            acc2 = _mm_add_ps(acc2, _mm_mul_ps(_mm_load1_ps(&coef2[-k-1]), y1));
+            acc3 = _mm_add_ps(acc3, _mm_mul_ps(_mm_load1_ps(&coef3[-k-1]), y1));
+
+            __m128 x2 = _mm_loadu_ps(&ps0[k+2]);
+            __m128 y2 = _mm_loadu_ps(&ps1[k+2]);
+            acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_load1_ps(&coef0[-k-2]), x2));
+            acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_load1_ps(&coef1[-k-2]), x2));
+            acc2 = _mm_add_ps(acc2, _mm_mul_ps(_mm_load1_ps(&coef2[-k-2]), y2));
+            acc3 = _mm_add_ps(acc3, _mm_mul_ps(_mm_load1_ps(&coef3[-k-2]), y2));
+
+            __m128 x3 = _mm_loadu_ps(&ps0[k+3]);
+            __m128 y3 = _mm_loadu_ps(&ps1[k+3]);
+            acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_load1_ps(&coef0[-k-3]), x3));
+            acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_load1_ps(&coef1[-k-3]), x3));
+            acc2 = _mm_add_ps(acc2, _mm_mul_ps(_mm_load1_ps(&coef2[-k-3]), y3));
+            acc3 = _mm_add_ps(acc3, _mm_mul_ps(_mm_load1_ps(&coef3[-k-3]), y3));
+        }
+
+        _mm_storeu_ps(&dst0[i], acc0);
+        _mm_storeu_ps(&dst1[i], acc1);
+        _mm_storeu_ps(&dst2[i], acc2);
+        _mm_storeu_ps(&dst3[i], acc3);
+    }
+}
+
 //
 // Runtime CPU dispatch
 //
 
-#include "CPUDetect.h"
+#include "AudioDispatch.h"
 
 void FIR_1x4_AVX2(float* src, float* dst0, float* dst1, float* dst2, float* dst3, float coef[4][HRTF_TAPS], int numFrames);
+void FIR_2x2_AVX2(float* src0, float* src1, float* dst0, float* dst1, float* dst2, float* dst3, float coef[4][HRTF_TAPS], int numFrames);
+void FIR_1x4_AVX512(float* src, float* dst0, float* dst1, float* dst2, float* dst3, float coef[4][HRTF_TAPS], int numFrames);
+void FIR_2x2_AVX512(float* src0, float* src1, float* dst0, float* dst1, float* dst2, float* dst3, float coef[4][HRTF_TAPS], int numFrames);
 
 static void FIR_1x4(float* src, float* dst0, float* dst1, float* dst2, float* dst3, float coef[4][HRTF_TAPS], int numFrames) {
 
-    static auto f = cpuSupportsAVX2() ? FIR_1x4_AVX2 : FIR_1x4_SSE;
+    auto path = AudioDispatch::getPath();
+    auto f = path == AudioDispatch::AVX512 ? FIR_1x4_AVX512 : path == AudioDispatch::AVX2 ? FIR_1x4_AVX2 : FIR_1x4_SSE;
     (*f)(src, dst0, dst1, dst2, dst3, coef, numFrames); // dispatch
 }
 
+// must dispatch the same way as FIR_1x4, so batched output matches render()
+static void FIR_2x2(float* src0, float* src1, float* dst0, float* dst1, float* dst2, float* dst3, float coef[4][HRTF_TAPS], int numFrames) {
+
+    auto path = AudioDispatch::getPath();
+    auto f = path == AudioDispatch::AVX512 ? FIR_2x2_AVX512 : path == AudioDispatch::AVX2 ? FIR_2x2_AVX2 : FIR_2x2_SSE;
+    (*f)(src0, src1, dst0, dst1, dst2, dst3, coef, numFrames); // dispatch
+}
+
 // 4 channel planar to interleaved
 static void interleave_4x4(float* src0, float* src1, float* src2, float* src3, float* dst, int numFrames) {
 
@@ -389,6 +461,43 @@ static void crossfade_4x2(float* src, float* dst, const float* win, int numFrame
     }
 }
 
+// accumulate 4 inputs, as two stereo pairs, into 2 outputs (interleaved)
+static void accumulate_4x2(float* src, float* dst, int numFrames) {
+
+    assert(numFrames % 4 == 0);
+
+    for (int i = 0; i < numFrames; i += 4) {
+
+        __m128 x0 = _mm_loadu_ps(&src[4*i+0]);
+        __m128 x1 = _mm_loadu_ps(&src[4*i+4]);
+        __m128 x2 = _mm_loadu_ps(&src[4*i+8]);
+        __m128 x3 = _mm_loadu_ps(&src[4*i+12]);
+
+        __m128 y0 = _mm_loadu_ps(&dst[2*i+0]);
+        __m128 y1 = _mm_loadu_ps(&dst[2*i+4]);
+
+        // deinterleave (4x4 matrix transpose)
+        __m128 t0 = _mm_unpacklo_ps(x0, x1);
+        __m128 t2 = _mm_unpacklo_ps(x2, x3);
+        __m128 t1 = _mm_unpackhi_ps(x0, x1);
+        __m128 t3 = _mm_unpackhi_ps(x2, x3);
+
+        x0 = _mm_movelh_ps(t0, t2);
+        x1 = _mm_movehl_ps(t2, t0);
+        x2 = _mm_movelh_ps(t1, t3);
+        x3 = _mm_movehl_ps(t3, t1);
+
+        // accumulate the first pair, then the second (same order as two calls to crossfade_4x2)
+        y0 = _mm_add_ps(y0, _mm_unpacklo_ps(x0, x1));
+        y1 = _mm_add_ps(y1, _mm_unpackhi_ps(x0, x1));
+        y0 = _mm_add_ps(y0, _mm_unpacklo_ps(x2, x3));
+        y1 = _mm_add_ps(y1, _mm_unpackhi_ps(x2, x3));
+
+        _mm_storeu_ps(&dst[2*i+0], y0);
+        _mm_storeu_ps(&dst[2*i+4], y1);
+    }
+}
+
 // linear interpolation with gain
 static void interpolate(float* dst, const float* src0, const float* src1, float frac, float gain) {
 
@@ -475,6 +584,72 @@ static void FIR_1x4(float* src, float* dst0, float* dst1, float* dst2, float* ds
     }
 }
 
+// 2 channel input, 4 channel output (2 channels per input)
+static void FIR_2x2(float* src0, float* src1, float* dst0, float* dst1, float* dst2, float* dst3, float coef[4][HRTF_TAPS], int numFrames) {
+
+    float* coef0 = coef[0] + HRTF_TAPS - 1;     // process backwards
+    float* coef1 = coef[1] + HRTF_TAPS - 1;
+    float* coef2 = coef[2] + HRTF_TAPS - 1;
+    float* coef3 = coef[3] + HRTF_TAPS - 1;
+
+    assert(numFrames % 4 == 0);
+
+    for (int i = 0; i < numFrames; i += 4) {
+
+        dst0[i+0] = 0.0f;
+        dst0[i+1] = 0.0f;
+        dst0[i+2] = 0.0f;
+        dst0[i+3] = 0.0f;
+
+        dst1[i+0] = 0.0f;
+        dst1[i+1] = 0.0f;
+        dst1[i+2] = 0.0f;
+        dst1[i+3] = 0.0f;
+
+        dst2[i+0] = 0.0f;
+        dst2[i+1] = 0.0f;
+        dst2[i+2] = 0.0f;
+        dst2[i+3] = 0.0f;
+
+        dst3[i+0] = 0.0f;
+        dst3[i+1] = 0.0f;
+        dst3[i+2] = 0.0f;
+        dst3[i+3] = 0.0f;
+
+        float* ps0 = &src0[i - HRTF_TAPS + 1];  // process forwards
+        float* ps1 = &src1[i - HRTF_TAPS + 1];
+
+        assert(HRTF_TAPS % 4 == 0);
+
+        for (int k = 0; k < HRTF_TAPS; k += 4) {
+
+            // channel 0
+            dst0[i+0] += coef0[-k-0] * ps0[k+0] + coef0[-k-1] * ps0[k+1] + coef0[-k-2] * ps0[k+2] + coef0[-k-3] * ps0[k+3];
+            dst0[i+1] += coef0[-k-0] * ps0[k+1] + coef0[-k-1] * ps0[k+2] + coef0[-k-2] * ps0[k+3] + coef0[-k-3] * ps0[k+4];
+            dst0[i+2] += coef0[-k-0] * ps0[k+2] + coef0[-k-1] * ps0[k+3] + coef0[-k-2] * ps0[k+4] + coef0[-k-3] * ps0[k+5];
+            dst0[i+3] += coef0[-k-0] * ps0[k+3] + coef0[-k-1] * ps0[k+4] + coef0[-k-2] * ps0[k+5] + coef0[-k-3] * ps0[k+6];
+
+            // channel 1
+            dst1[i+0] += coef1[-k-0] * ps0[k+0] + coef1[-k-1] * ps0[k+1] + coef1[-k-2] * ps0[k+2] + coef1[-k-3] * ps0[k+3];
+            dst1[i+1] += coef1[-k-0] * ps0[k+1] + coef1[-k-1] * ps0[k+2] + coef1[-k-2] * ps0[k+3] + coef1[-k-3] * ps0[k+4];
+            dst1[i+2] += coef1[-k-0] * ps0[k+2] + coef1[-k-1] * ps0[k+3] + coef1[-k-2] * ps0[k+4] + coef1[-k-3] * ps0[k+5];
+            dst1[i+3] += coef1[-k-0] * ps0[k+3] + coef1[-k-1] * ps0[k+4] + coef1[-k-2] * ps0[k+5] + coef1[-k-3] * ps0[k+6];
+
+            // channel 2
+            dst2[i+0] += coef2[-k-0] * ps1[k+0] + coef2[-k-1] * ps1[k+1] + coef2[-k-2] * ps1[k+2] + coef2[-k-3] * ps1[k+3];
+            dst2[i+1] += coef2[-k-0] * ps1[k+1] + coef2[-k-1] * ps1[k+2] + coef2[-k-2] * ps1[k+3] + coef2[-k-3] * ps1[k+4];
+            dst2[i+2] += coef2[-k-0] * ps1[k+2] + coef2[-k-1] * ps1[k+3] + coef2[-k-2] * ps1[k+4] + coef2[-k-3] * ps1[k+5];
+            dst2[i+3] += coef2[-k-0] * ps1[k+3] + coef2[-k-1] * ps1[k+4] + coef2[-k-2] * ps1[k+5] + coef2[-k-3] * ps1[k+6];
+
+            // channel 3
+            dst3[i+0] += coef3[-k-0] * ps1[k+0] + coef3[-k-1] * ps1[k+1] + coef3[-k-2] * ps1[k+2] + coef3[-k-3] * ps1[k+3];
+            dst3[i+1] += coef3[-k-0] * ps1[k+1] + coef3[-k-1] * ps1[k+2] + coef3[-k-2] * ps1[k+3] + coef3[-k-3] * ps1[k+4];
+            dst3[i+2] += coef3[-k-0] * ps1[k+2] + coef3[-k-1] * ps1[k+3] + coef3[-k-2] * ps1[k+4] + coef3[-k-3] * ps1[k+5];
+            dst3[i+3] += coef3[-k-0] * ps1[k+3] + coef3[-k-1] * ps1[k+4] + coef3[-k-2] * ps1[k+5] + coef3[-k-3] * ps1[k+6];
+        }
+    }
+}
+
 // 4 channel planar to interleaved
 static void interleave_4x4(float* src0, float* src1, float* src2, float* src3, float* dst, int numFrames) {
 
@@ -669,6 +844,19 @@ static void crossfade_4x2(float* src, float* dst, const float* win, int numFrame
     }
 }
 
+// accumulate 4 inputs, as two stereo pairs, into 2 outputs (interleaved)
+static void accumulate_4x2(float* src, float* dst, int numFrames) {
+
+    for (int i = 0; i < numFrames; i++) {
+
+        dst[2*i+0] += src[4*i+0];
+        dst[2*i+1] += src[4*i+1];
+
+        dst[2*i+0] += src[4*i+2];
+        dst[2*i+1] += src[4*i+3];
+    }
+}
+
 // linear interpolation with gain
 static void interpolate(float* dst, const float* src0, const float* src1, float frac, float gain) {
 
@@ -950,3 +1138,139 @@ void AudioHRTF::renderSilent(int16_t* input, float* output, int index, float azi
 
     _silentState = true;
 }
+
+bool AudioHRTF::isSteady(float azimuth, float distance, float gain) const {
+    return azimuth == _azimuthState && distance == _distanceState && gain * _gainAdjust == _gainState;
+}
+
+void AudioHRTF::renderPair(const Source& source0, const Source& source1, float* output, int index) {
+
+    AudioHRTF& hrtf0 = *source0.hrtf;
+    AudioHRTF& hrtf1 = *source1.hrtf;
+
+    ALIGN32 float in[2][HRTF_TAPS + HRTF_BLOCK];            // mono, per source
+    ALIGN32 float firCoef[4][HRTF_TAPS];                    // 4-channel
+    ALIGN32 float firBuffer[4][HRTF_DELAY + HRTF_BLOCK];    // 4-channel
+    ALIGN32 float bqCoef[5][8];                             // 4-channel (interleaved)
+    ALIGN32 float bqState[3][8];                            // 4-channel (interleaved)
+    ALIGN32 float bqBuffer[4 * HRTF_BLOCK];                 // 4-channel (interleaved)
+    int delay[4];                                           // 4-channel (interleaved)
+
+    //
+    // Old and new filters of a steady source are identical, as is their state, so render()
+    // would crossfade between two identical outputs. Only the new filters are computed here,
+    // with source0 in the old channels and source1 in the new.
+    //
+    setFilters(firCoef, bqCoef, delay, index, hrtf0._azimuthState, hrtf0._distanceState, hrtf0._gainState, L0);
+    setFilters(firCoef, bqCoef, delay, index, hrtf1._azimuthState, hrtf1._distanceState, hrtf1._gainState, L1);
+
+    // convert mono inputs to float
+    for (int i = 0; i < HRTF_BLOCK; i++) {
+        in[0][HRTF_TAPS+i] = (float)source0.input[i] * (1/32768.0f);
+        in[1][HRTF_TAPS+i] = (float)source1.input[i] * (1/32768.0f);
+    }
+
+    // FIR state update
+    memcpy(in[0], hrtf0._firState, HRTF_TAPS * sizeof(float));
+    memcpy(in[1], hrtf1._firState, HRTF_TAPS * sizeof(float));
+    memcpy(hrtf0._firState, &in[0][HRTF_BLOCK], HRTF_TAPS * sizeof(float));
+    memcpy(hrtf1._firState, &in[1][HRTF_BLOCK], HRTF_TAPS * sizeof(float));
+
+    // process both FIR
+    FIR_2x2(&in[0][HRTF_TAPS],
+            &in[1][HRTF_TAPS],
+            &firBuffer[L0][HRTF_DELAY],
+            &firBuffer[R0][HRTF_DELAY],
+            &firBuffer[L1][HRTF_DELAY],
+            &firBuffer[R1][HRTF_DELAY],
+            firCoef, HRTF_BLOCK);
+
+    // delay state update
+    memcpy(firBuffer[L0], hrtf0._delayState[L1], HRTF_DELAY * sizeof(float));
+    memcpy(firBuffer[R0], hrtf0._delayState[R1], HRTF_DELAY * sizeof(float));
+    memcpy(firBuffer[L1], hrtf1._delayState[L1], HRTF_DELAY * sizeof(float));
+    memcpy(firBuffer[R1], hrtf1._delayState[R1], HRTF_DELAY * sizeof(float));
+
+    memcpy(hrtf0._delayState[L0], &firBuffer[L0][HRTF_BLOCK], HRTF_DELAY * sizeof(float));
+    memcpy(hrtf0._delayState[R0], &firBuffer[R0][HRTF_BLOCK], HRTF_DELAY * sizeof(float));
+    memcpy(hrtf0._delayState[L1], &firBuffer[L0][HRTF_BLOCK], HRTF_DELAY * sizeof(float));
+    memcpy(hrtf0._delayState[R1], &firBuffer[R0][HRTF_BLOCK], HRTF_DELAY * sizeof(float));
+
+    memcpy(hrtf1._delayState[L0], &firBuffer[L1][HRTF_BLOCK], HRTF_DELAY * sizeof(float));
+    memcpy(hrtf1._delayState[R0], &firBuffer[R1][HRTF_BLOCK], HRTF_DELAY * sizeof(float));
+    memcpy(hrtf1._delayState[L1], &firBuffer[L1][HRTF_BLOCK], HRTF_DELAY * sizeof(float));
+    memcpy(hrtf1._delayState[R1], &firBuffer[R1][HRTF_BLOCK], HRTF_DELAY * sizeof(float));
+
+    // interleave with integer delay
+    interleave_4x4(&firBuffer[L0][HRTF_DELAY] - delay[L0],
+                   &firBuffer[R0][HRTF_DELAY] - delay[R0],
+                   &firBuffer[L1][HRTF_DELAY] - delay[L1],
+                   &firBuffer[R1][HRTF_DELAY] - delay[R1],
+                   bqBuffer, HRTF_BLOCK);
+
+    // gather the new biquad state of both sources
+    for (int i = 0; i < 3; i++) {
+        bqState[i][L0] = hrtf0._bqState[i][L1];
+        bqState[i][R0] = hrtf0._bqState[i][R1];
+        bqState[i][L1] = hrtf1._bqState[i][L1];
+        bqState[i][R1] = hrtf1._bqState[i][R1];
+        bqState[i][L2] = hrtf0._bqState[i][L3];
+        bqState[i][R2] = hrtf0._bqState[i][R3];
+        bqState[i][L3] = hrtf1._bqState[i][L3];
+        bqState[i][R3] = hrtf1._bqState[i][R3];
+    }
+
+    // process both biquads
+    biquad2_4x4(bqBuffer, bqBuffer, bqCoef, bqState, HRTF_BLOCK);
+
+    // scatter it back, as both old and new state
+    for (int i = 0; i < 3; i++) {
+        hrtf0._bqState[i][L0] = hrtf0._bqState[i][L1] = bqState[i][L0];
+        hrtf0._bqState[i][R0] = hrtf0._bqState[i][R1] = bqState[i][R0];
+        hrtf1._bqState[i][L0] = hrtf1._bqState[i][L1] = bqState[i][L1];
+        hrtf1._bqState[i][R0] = hrtf1._bqState[i][R1] = bqState[i][R1];
+        hrtf0._bqState[i][L2] = hrtf0._bqState[i][L3] = bqState[i][L2];
+        hrtf0._bqState[i][R2] = hrtf0._bqState[i][R3] = bqState[i][R2];
+        hrtf1._bqState[i][L2] = hrtf1._bqState[i][L3] = bqState[i][L3];
+        hrtf1._bqState[i][R2] = hrtf1._bqState[i][R3] = bqState[i][R3];
+    }
+
+    // accumulate both outputs
+    accumulate_4x2(bqBuffer, output, HRTF_BLOCK);
+
+    hrtf0._silentState = false;
+    hrtf1._silentState = false;
+}
+
+void AudioHRTF::renderBatch(const Source* sources, int numSources, float* output, int index, int numFrames) {
+
+    assert(index >= 0);
+    assert(index < HRTF_TABLES);
+    assert(numFrames == HRTF_BLOCK);
+
+    // steady sources first, in pairs (rendering does not change whether a source is steady)
+    const Source* unpaired = nullptr;
+    for (int i = 0; i < numSources; i++) {
+        const Source& source = sources[i];
+        if (!source.hrtf->isSteady(source.azimuth, source.distance, source.gain)) {
+            continue;
+        }
+        if (unpaired) {
+            renderPair(*unpaired, source, output, index);
+            unpaired = nullptr;
+        } else {
+            unpaired = &source;
+        }
+    }
+    if (unpaired) {
+        unpaired->hrtf->render(unpaired->input, output, index, unpaired->azimuth, unpaired->distance, unpaired->gain, numFrames);
+    }
+
+    // then the sources that crossfade to new parameters
+    for (int i = 0; i < numSources; i++) {
+        const Source& source = sources[i];
+        if (!source.hrtf->isSteady(source.azimuth, source.distance, source.gain)) {
+            source.hrtf->render(source.input, output, index, source.azimuth, source.distance, source.gain, numFrames);
+        }
+    }
+}
@@ -44,6 +44,24 @@ public:
     //
     void renderSilent(int16_t* input, float* output, int index, float azimuth, float distance, float gain, int numFrames);
 
+    //
+    // A source to be rendered by renderBatch, with the arguments it would pass to render
+    //
+    struct Source {
+        AudioHRTF* hrtf;
+        int16_t* input;
+        float azimuth;
+        float distance;
+        float gain;
+    };
+
+    //
+    // Render many sources into the same output, as render would for each of them in turn.
+    // Sources whose parameters are unchanged since their last block need no crossfade,
+    // so they are filtered two at a time. Each source must appear at most once.
+    //
+    static void renderBatch(const Source* sources, int numSources, float* output, int index, int numFrames);
+
     //
     // HRTF local gain adjustment in amplitude (1.0 == unity)
     //
@@ -54,6 +72,12 @@ private:
     AudioHRTF(const AudioHRTF&) = delete;
     AudioHRTF& operator=(const AudioHRTF&) = delete;
 
+    // true when the filters for these parameters are the ones already in use
+    bool isSteady(float azimuth, float distance, float gain) const;
+
+    // render two steady sources with a single pass of filters
+    static void renderPair(const Source& source0, const Source& source1, float* output, int index);
+
     // SIMD channel assignmentS
     enum Channel {
         L0, R0,
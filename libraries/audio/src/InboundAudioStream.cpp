@@ -20,6 +20,7 @@
 
 const bool InboundAudioStream::DEFAULT_DYNAMIC_JITTER_BUFFER_ENABLED = true;
 const int InboundAudioStream::DEFAULT_STATIC_JITTER_FRAMES = 1;
+const float InboundAudioStream::DEFAULT_JITTER_BUFFER_PERCENTILE = 0.0f;
 const int InboundAudioStream::MAX_FRAMES_OVER_DESIRED = 10;
 const int InboundAudioStream::WINDOW_STARVE_THRESHOLD = 3;
 const int InboundAudioStream::WINDOW_SECONDS_FOR_DESIRED_CALC_ON_TOO_MANY_STARVES = 50;
@@ -38,6 +39,13 @@ static const int UNPLAYED_MS_WINDOW_SECS = 5;
 // which could lead to a starve soon after.
 static const int DESIRED_JITTER_BUFFER_FRAMES_PADDING = 1;
 
+// In adaptive mode the buffer is trimmed back down as soon as it is this far over the desired frames, rather than
+// MAX_FRAMES_OVER_DESIRED, so the latency a burst of late packets adds does not linger.
+static const int ADAPTIVE_MAX_FRAMES_OVER_DESIRED = 2;
+
+// the gaps needed in the window before its percentile is used, a second of packets
+static const quint32 MIN_GAPS_FOR_JITTER_BUFFER_PERCENTILE = 100;
+
 // this controls the length of the window for stats used in the stats packet (not the stats used in
 // _desiredJitterBufferFrames calculation)
 static const int STATS_FOR_STATS_PACKET_WINDOW_SECONDS = 30;
@@ -53,6 +61,7 @@ InboundAudioStream::InboundAudioStream(int numChannels, int numFrames, int numBl
     _staticJitterBufferFrames(std::max(numStaticJitterBlocks, DEFAULT_STATIC_JITTER_FRAMES)),
     _desiredJitterBufferFrames(_dynamicJitterBufferEnabled ? 1 : _staticJitterBufferFrames),
     _incomingSequenceNumberStats(STATS_FOR_STATS_PACKET_WINDOW_SECONDS),
+    _gapHistograms(WINDOW_SECONDS_FOR_DESIRED_REDUCTION),
     _starveHistory(STARVE_HISTORY_CAPACITY),
     _unplayedMs(0, UNPLAYED_MS_WINDOW_SECS),
     _timeGapStatsForStatsPacket(0, STATS_FOR_STATS_PACKET_WINDOW_SECONDS) {}
@@ -85,6 +94,10 @@ void InboundAudioStream::resetStats() {
     _lastPacketReceivedTime = 0;
     _timeGapStatsForDesiredCalcOnTooManyStarves.reset();
     _timeGapStatsForDesiredReduction.reset();
+    for (auto& histogram : _gapHistograms) {
+        histogram.fill(0);
+    }
+    _gapHistogramWindow.fill(0);
     _starveHistory.clear();
     _framesAvailableStat.reset();
     _currentJitterBufferFrames = 0;
@@ -110,6 +123,57 @@ void InboundAudioStream::perSecondCallbackForUpdatingStats() {
     _timeGapStatsForDesiredReduction.currentIntervalComplete();
     _timeGapStatsForStatsPacket.currentIntervalComplete();
     _unplayedMs.currentIntervalComplete();
+
+    if (isAdaptive()) {
+        updateAdaptiveDesiredFrames();
+    }
+
+    // the oldest second leaves the gap window
+    _currentGapHistogram = (_currentGapHistogram + 1) % (int)_gapHistograms.size();
+    auto& oldest = _gapHistograms[_currentGapHistogram];
+    for (int i = 0; i < GAP_HISTOGRAM_FRAMES; ++i) {
+        _gapHistogramWindow[i] -= oldest[i];
+    }
+    oldest.fill(0);
+}
+
+quint32 InboundAudioStream::getNumGapsInWindow() const {
+    quint32 numGaps = 0;
+    for (auto count : _gapHistogramWindow) {
+        numGaps += count;
+    }
+    return numGaps;
+}
+
+void InboundAudioStream::updateAdaptiveDesiredFrames() {
+    // until there are gaps to go on, the starve logic sizes the buffer
+    quint32 numGaps = getNumGapsInWindow();
+    if (numGaps < MIN_GAPS_FOR_JITTER_BUFFER_PERCENTILE) {
+        return;
+    }
+
+    // the smallest number of frames that covers the target percentile of gaps. this replaces whatever a
+    // starve raised the desired frames to during warm up.
+    quint32 targetGaps = (quint32)ceilf(_jitterBufferPercentile * numGaps);
+    quint32 gapsCovered = 0;
+    int desiredFrames = 0;
+    while (desiredFrames < GAP_HISTOGRAM_FRAMES - 1) {
+        gapsCovered += _gapHistogramWindow[desiredFrames];
+        if (gapsCovered >= targetGaps) {
+            break;
+        }
+        ++desiredFrames;
+    }
+    desiredFrames = std::max(desiredFrames, 1);
+
+    if (desiredFrames != _desiredJitterBufferFrames) {
+        _desiredJitterBufferFrames = desiredFrames;
+        qCInfo(audiostream, "Set desired jitter frames to %d (adaptive)", _desiredJitterBufferFrames);
+    }
+}
+
+int InboundAudioStream::getMaxFramesOverDesired() const {
+    return isAdaptive() ? ADAPTIVE_MAX_FRAMES_OVER_DESIRED : MAX_FRAMES_OVER_DESIRED;
 }
 
 int InboundAudioStream::parseData(ReceivedMessage& message) {
@@ -181,7 +245,7 @@ int InboundAudioStream::parseData(ReceivedMessage& message) {
     }
     // if the ringbuffer exceeds the desired size by more than the threshold specified,
     // drop the oldest frames so the ringbuffer is down to the desired size.
-    if (framesAvailable > _desiredJitterBufferFrames + MAX_FRAMES_OVER_DESIRED) {
+    if (framesAvailable > _desiredJitterBufferFrames + getMaxFramesOverDesired()) {
         int framesToDrop = framesAvailable - (_desiredJitterBufferFrames + DESIRED_JITTER_BUFFER_FRAMES_PADDING);
         _ringBuffer.shiftReadPosition(framesToDrop * _ringBuffer.getNumFrameSamples());
         
@@ -316,10 +380,11 @@ void InboundAudioStream::popSamplesNoCheck(int samples) {
 }
 
 void InboundAudioStream::framesAvailableChanged() {
-    _framesAvailableStat.updateWithSample(_ringBuffer.framesAvailable());
+    quint64 now = getTimestampNow();
+    _framesAvailableStat.updateWithSample(_ringBuffer.framesAvailable(), now);
 
-    if (_framesAvailableStat.getElapsedUsecs() >= FRAMES_AVAILABLE_STAT_WINDOW_USECS) {
-        _currentJitterBufferFrames = (int)ceil(_framesAvailableStat.getAverage());
+    if (_framesAvailableStat.getElapsedUsecs(now) >= FRAMES_AVAILABLE_STAT_WINDOW_USECS) {
+        _currentJitterBufferFrames = (int)ceil(_framesAvailableStat.getAverage(now));
         qCInfo(audiostream, "Set current jitter frames to %d (changed)", _currentJitterBufferFrames);
 
         _framesAvailableStat.reset();
@@ -338,10 +403,12 @@ void InboundAudioStream::setToStarved() {
     _isStarved = (_ringBuffer.framesAvailable() < _desiredJitterBufferFrames);
 
     // record the time of this starve in the starve history
-    quint64 now = usecTimestampNow();
+    quint64 now = getTimestampNow();
     _starveHistory.insert(now);
 
-    if (_dynamicJitterBufferEnabled) {
+    // in adaptive mode, the starves from the gaps past the percentile are the latency trade being made
+    bool isPercentileSized = isAdaptive() && getNumGapsInWindow() >= MIN_GAPS_FOR_JITTER_BUFFER_PERCENTILE;
+    if (_dynamicJitterBufferEnabled && !isPercentileSized) {
         // dynamic jitter buffers are enabled. check if this starve put us over the window
         // starve threshold
         quint64 windowEnd = now - WINDOW_SECONDS_FOR_DESIRED_CALC_ON_TOO_MANY_STARVES * USECS_PER_SECOND;
@@ -387,6 +454,10 @@ void InboundAudioStream::setDynamicJitterBufferEnabled(bool enable) {
     _dynamicJitterBufferEnabled = enable;
 }
 
+void InboundAudioStream::setJitterBufferPercentile(float percentile) {
+    _jitterBufferPercentile = glm::clamp(percentile, 0.0f, 1.0f);
+}
+
 void InboundAudioStream::setStaticJitterBufferFrames(int staticJitterBufferFrames) {
     _staticJitterBufferFrames = staticJitterBufferFrames;
     if (!_dynamicJitterBufferEnabled) {
@@ -399,11 +470,15 @@ void InboundAudioStream::packetReceivedUpdateTimingStats() {
     // update our timegap stats and desired jitter buffer frames if necessary
     // discard the first few packets we receive since they usually have gaps that aren't represensative of normal jitter
     const quint32 NUM_INITIAL_PACKETS_DISCARD = 1000; // 10s
-    quint64 now = usecTimestampNow();
+    quint64 now = getTimestampNow();
     if (_incomingSequenceNumberStats.getReceived() > NUM_INITIAL_PACKETS_DISCARD) {
         quint64 gap = now - _lastPacketReceivedTime;
         _timeGapStatsForStatsPacket.update(gap);
 
+        int gapFrames = std::min((int)ceilf((float)gap / (float)AudioConstants::NETWORK_FRAME_USECS), GAP_HISTOGRAM_FRAMES - 1);
+        _gapHistograms[_currentGapHistogram][gapFrames]++;
+        _gapHistogramWindow[gapFrames]++;
+
         // update all stats used for desired frames calculations under dynamic jitter buffer mode
         _timeGapStatsForDesiredCalcOnTooManyStarves.update(gap);
         _timeGapStatsForDesiredReduction.update(gap);
@@ -414,7 +489,7 @@ void InboundAudioStream::packetReceivedUpdateTimingStats() {
             _timeGapStatsForDesiredCalcOnTooManyStarves.clearNewStatsAvailableFlag();
         }
 
-        if (_dynamicJitterBufferEnabled) {
+        if (_dynamicJitterBufferEnabled && !isAdaptive()) {
             // if the max gap in window B (_timeGapStatsForDesiredReduction) corresponds to a smaller number of frames than _desiredJitterBufferFrames,
             // then reduce _desiredJitterBufferFrames to that number of frames.
             if (_timeGapStatsForDesiredReduction.getNewStatsAvailableFlag() && _timeGapStatsForDesiredReduction.isWindowFilled()) {
@@ -443,7 +518,7 @@ AudioStreamStats InboundAudioStream::getAudioStreamStats() const {
     streamStats._timeGapWindowAverage = _timeGapStatsForStatsPacket.getWindowAverage();
 
     streamStats._framesAvailable = _ringBuffer.framesAvailable();
-    streamStats._framesAvailableAverage = _framesAvailableStat.getAverage();
+    streamStats._framesAvailableAverage = _framesAvailableStat.getAverage(getTimestampNow());
     streamStats._unplayedMs = (quint16)_unplayedMs.getWindowMax();
     streamStats._desiredJitterBufferFrames = _desiredJitterBufferFrames;
     streamStats._starveCount = _starveCount;
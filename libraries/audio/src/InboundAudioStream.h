@@ -12,6 +12,9 @@
 #ifndef hifi_InboundAudioStream_h
 #define hifi_InboundAudioStream_h
 
+#include <array>
+#include <vector>
+
 #include <Node.h>
 #include <NodeData.h>
 #include <NumericalConstants.h>
@@ -37,6 +40,7 @@ public:
     // settings
     static const bool DEFAULT_DYNAMIC_JITTER_BUFFER_ENABLED;
     static const int DEFAULT_STATIC_JITTER_FRAMES;
+    static const float DEFAULT_JITTER_BUFFER_PERCENTILE;
     // legacy (now static) settings
     static const int MAX_FRAMES_OVER_DESIRED;
     static const int WINDOW_STARVE_THRESHOLD;
@@ -62,13 +66,18 @@ public:
     bool lastPopSucceeded() const { return _lastPopSucceeded; };
     const AudioRingBuffer::ConstIterator& getLastPopOutput() const { return _lastPopOutput; }
 
-    quint64 usecsSinceLastPacket() { return usecTimestampNow() - _lastPacketReceivedTime; }
+    quint64 usecsSinceLastPacket() { return getTimestampNow() - _lastPacketReceivedTime; }
 
     void setToStarved();
 
     void setDynamicJitterBufferEnabled(bool enable);
     void setStaticJitterBufferFrames(int staticJitterBufferFrames);
 
+    /// with dynamic jitter buffers, size the buffer for this percentile of packet inter-arrival gaps (e.g. 0.95)
+    /// instead of the largest gap in the window. 0 keeps the window-max scheme.
+    void setJitterBufferPercentile(float percentile);
+    float getJitterBufferPercentile() const { return _jitterBufferPercentile; }
+
     virtual AudioStreamStats getAudioStreamStats() const;
 
     /// returns the desired number of jitter buffer frames under the dyanmic jitter buffers scheme
@@ -81,7 +90,7 @@ public:
     int getNumFrameSamples() const { return _ringBuffer.getNumFrameSamples(); }
     int getFrameCapacity() const { return _ringBuffer.getFrameCapacity(); }
     int getFramesAvailable() const { return _ringBuffer.framesAvailable(); }
-    double getFramesAvailableAverage() const { return _framesAvailableStat.getAverage(); }
+    double getFramesAvailableAverage() const { return _framesAvailableStat.getAverage(getTimestampNow()); }
     int getSamplesAvailable() const { return _ringBuffer.samplesAvailable(); }
 
     bool isStarved() const { return _isStarved; }
@@ -118,6 +127,11 @@ private:
     void popSamplesNoCheck(int samples);
     void framesAvailableChanged();
 
+    bool isAdaptive() const { return _dynamicJitterBufferEnabled && _jitterBufferPercentile > 0.0f; }
+    quint32 getNumGapsInWindow() const;
+    void updateAdaptiveDesiredFrames();
+    int getMaxFramesOverDesired() const;
+
 protected:
     // disallow copying of InboundAudioStream objects
     InboundAudioStream(const InboundAudioStream&);
@@ -137,6 +151,9 @@ protected:
 
     /// writes silent frames to the buffer that may be dropped to reduce latency caused by the buffer
     virtual int writeDroppableSilentFrames(int silentFrames);
+
+    /// the time used for packet timing and starves, overridden to replay packet traces on a simulated clock
+    virtual quint64 getTimestampNow() const { return usecTimestampNow(); }
     
 protected:
 
@@ -167,6 +184,14 @@ protected:
     int _calculatedJitterBufferFrames { 0 };
     MovingMinMaxAvg<quint64> _timeGapStatsForDesiredReduction { 0, WINDOW_SECONDS_FOR_DESIRED_REDUCTION };
 
+    // adaptive mode: per-second histograms of inter-arrival gaps in whole frames, over the reduction window
+    static const int GAP_HISTOGRAM_FRAMES = 64;
+    using GapHistogram = std::array<quint32, GAP_HISTOGRAM_FRAMES>;
+    float _jitterBufferPercentile { DEFAULT_JITTER_BUFFER_PERCENTILE };
+    std::vector<GapHistogram> _gapHistograms;
+    GapHistogram _gapHistogramWindow {};
+    int _currentGapHistogram { 0 };
+
     RingBufferHistory<quint64> _starveHistory;
 
     TimeWeightedAvg<int> _framesAvailableStat;
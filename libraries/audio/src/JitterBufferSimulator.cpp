@@ -0,0 +1,206 @@
+//
+//  JitterBufferSimulator.cpp
+//  libraries/audio/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "JitterBufferSimulator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+#include <QtCore/QFile>
+#include <QtCore/QStringList>
+#include <QtCore/QTextStream>
+
+#include <NLPacket.h>
+#include <ReceivedMessage.h>
+
+#include "AudioConstants.h"
+#include "AudioLogging.h"
+#include "MixedAudioStream.h"
+
+static const int SIMULATED_STREAM_CAPACITY_FRAMES = 100;
+static const quint64 SYNTHETIC_TRACE_BASE_DELAY_USECS = 20 * USECS_PER_MSEC;
+
+namespace {
+
+// a client's received audio stream, on the simulator's clock
+class SimulatedAudioStream : public MixedAudioStream {
+public:
+    SimulatedAudioStream(int numStaticJitterFrames) :
+        MixedAudioStream(SIMULATED_STREAM_CAPACITY_FRAMES, numStaticJitterFrames) {}
+
+    void setTimestamp(quint64 timestamp) { _timestamp = timestamp; }
+
+protected:
+    quint64 getTimestampNow() const override { return _timestamp; }
+
+private:
+    quint64 _timestamp { 0 };
+};
+
+}
+
+JitterTrace JitterBufferSimulator::makeSyntheticTrace(const SyntheticTraceOptions& options) {
+    // std::mt19937 output is specified by the standard, unlike the distributions, so traces match everywhere
+    std::mt19937 generator(options.seed);
+    auto nextUniform = [&] {
+        return ((double)generator() + 0.5) / 4294967296.0;
+    };
+
+    JitterTrace trace;
+    trace.reserve(options.numPackets);
+
+    quint64 lastArrival = 0;
+    for (int i = 0; i < options.numPackets; ++i) {
+        double delayUsecs = -std::log(nextUniform()) * options.jitterMsecs * USECS_PER_MSEC;
+        if (nextUniform() < options.spikeChance) {
+            delayUsecs += options.spikeMsecs * USECS_PER_MSEC;
+        }
+        bool isLost = nextUniform() < options.lossChance;
+
+        quint64 sendTime = (quint64)i * AudioConstants::NETWORK_FRAME_USECS;
+        quint64 arrival = std::max(sendTime + SYNTHETIC_TRACE_BASE_DELAY_USECS + (quint64)delayUsecs, lastArrival);
+
+        // keep the ends so the length of the trace and the loss in it are exact
+        if (isLost && i > 0 && i < options.numPackets - 1) {
+            continue;
+        }
+        trace.push_back({ arrival, (quint16)i });
+        lastArrival = arrival;
+    }
+    return trace;
+}
+
+JitterTrace JitterBufferSimulator::loadTrace(const QString& path) {
+    JitterTrace trace;
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        qCWarning(audio) << "Could not open jitter trace" << path;
+        return trace;
+    }
+
+    QTextStream stream(&file);
+    while (!stream.atEnd()) {
+        QString line = stream.readLine().trimmed();
+        if (line.isEmpty() || line.startsWith('#')) {
+            continue;
+        }
+        QStringList fields = line.split(' ', QString::SkipEmptyParts);
+        bool arrivalOK = false;
+        bool sequenceOK = false;
+        JitterTracePacket packet;
+        if (fields.size() == 2) {
+            packet.arrivalUsecs = fields[0].toULongLong(&arrivalOK);
+            packet.sequence = fields[1].toUShort(&sequenceOK);
+        }
+        if (!arrivalOK || !sequenceOK) {
+            qCWarning(audio) << "Ignoring malformed line in jitter trace" << path << ":" << line;
+            continue;
+        }
+        trace.push_back(packet);
+    }
+
+    std::stable_sort(trace.begin(), trace.end(), [](const JitterTracePacket& a, const JitterTracePacket& b) {
+        return a.arrivalUsecs < b.arrivalUsecs;
+    });
+    return trace;
+}
+
+bool JitterBufferSimulator::saveTrace(const JitterTrace& trace, const QString& path) {
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        qCWarning(audio) << "Could not write jitter trace" << path;
+        return false;
+    }
+
+    QTextStream stream(&file);
+    stream << "# arrival usecs, sequence\n";
+    for (const auto& packet : trace) {
+        stream << packet.arrivalUsecs << ' ' << packet.sequence << '\n';
+    }
+    return true;
+}
+
+JitterBufferSimulator::Report JitterBufferSimulator::run(const JitterTrace& trace, const Settings& settings) {
+    Report report;
+    if (trace.empty()) {
+        return report;
+    }
+
+    SimulatedAudioStream stream(settings.dynamic ? -1 : settings.staticFrames);
+    stream.setJitterBufferPercentile(settings.percentile);
+
+    const quint64 FRAME_USECS = AudioConstants::NETWORK_FRAME_USECS;
+    const int FRAMES_PER_SECOND = (int)(USECS_PER_SECOND / FRAME_USECS);
+    const QByteArray FRAME_AUDIO(AudioConstants::NETWORK_FRAME_BYTES_STEREO, 0);
+
+    std::vector<float> latencies;
+    latencies.reserve(trace.size());
+
+    // the output pulls a frame every network frame from the first arrival until the stream has played out
+    const quint64 startTime = trace.front().arrivalUsecs;
+    size_t nextPacket = 0;
+    for (int frame = 0; ; ++frame) {
+        quint64 frameTime = startTime + frame * FRAME_USECS;
+
+        for (; nextPacket < trace.size() && trace[nextPacket].arrivalUsecs <= frameTime; ++nextPacket) {
+            stream.setTimestamp(trace[nextPacket].arrivalUsecs);
+
+            auto packet = NLPacket::create(PacketType::MixedAudio);
+            packet->writePrimitive(trace[nextPacket].sequence);
+            packet->writeString(QString());
+            packet->write(FRAME_AUDIO);
+            packet->seek(0);
+
+            ReceivedMessage message(*packet);
+            stream.parseData(message);
+        }
+
+        stream.setTimestamp(frameTime);
+        int framesAvailable = stream.getFramesAvailable();
+        if (nextPacket == trace.size() && (framesAvailable == 0 || stream.isStarved())) {
+            // the trace is over, running dry now is the end of the stream rather than a starve
+            break;
+        }
+
+        if (stream.popFrames(1, true) > 0) {
+            latencies.push_back(framesAvailable * AudioConstants::NETWORK_FRAME_MSECS);
+        } else if (stream.hasStarted()) {
+            ++report.framesStarved;
+        }
+
+        if (frame % FRAMES_PER_SECOND == FRAMES_PER_SECOND - 1) {
+            stream.perSecondCallbackForUpdatingStats();
+        }
+    }
+
+    auto stats = stream.getAudioStreamStats();
+    report.framesPlayed = (int)latencies.size();
+    report.starves = stats._starveCount;
+    report.framesDropped = stats._framesDropped;
+    report.packetsLost = stats._packetStreamStats._lost;
+    report.desiredFrames = stats._desiredJitterBufferFrames;
+
+    if (!latencies.empty()) {
+        double latencySum = 0.0;
+        for (float latency : latencies) {
+            latencySum += latency;
+        }
+        report.latencyAverageMsecs = (float)(latencySum / latencies.size());
+
+        const float PERCENTILE = 0.99f;
+        auto percentile = latencies.begin() + (size_t)(PERCENTILE * (latencies.size() - 1));
+        std::nth_element(latencies.begin(), percentile, latencies.end());
+        report.latencyP99Msecs = *percentile;
+    }
+
+    return report;
+}
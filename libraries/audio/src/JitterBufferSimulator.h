@@ -0,0 +1,66 @@
+//
+//  JitterBufferSimulator.h
+//  libraries/audio/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_JitterBufferSimulator_h
+#define hifi_JitterBufferSimulator_h
+
+#include <vector>
+
+#include <QtCore/QString>
+
+// A packet in an arrival trace: when it arrived (usecs, any epoch) and the sequence number it was sent with.
+struct JitterTracePacket {
+    quint64 arrivalUsecs;
+    quint16 sequence;
+};
+using JitterTrace = std::vector<JitterTracePacket>;
+
+// Replays packet arrival traces through an InboundAudioStream on a simulated clock, popping a frame every
+// network frame like a mixer or audio device would, and reports what the jitter buffer cost. Runs are
+// deterministic, so jitter buffer settings can be compared on the same trace.
+class JitterBufferSimulator {
+public:
+    struct Settings {
+        bool dynamic { true };
+        int staticFrames { 1 }; // when not dynamic
+        float percentile { 0.0f }; // InboundAudioStream::setJitterBufferPercentile, 0 for the window-max scheme
+    };
+
+    struct Report {
+        int framesPlayed { 0 };
+        int framesStarved { 0 }; // frames played as silence after the stream started
+        int starves { 0 };
+        int framesDropped { 0 }; // silent and old frames the stream dropped to cut its latency
+        int packetsLost { 0 };
+        float latencyAverageMsecs { 0.0f }; // audio buffered ahead of each frame played
+        float latencyP99Msecs { 0.0f };
+        int desiredFrames { 0 }; // at the end of the trace
+    };
+
+    struct SyntheticTraceOptions {
+        int numPackets { 6000 };
+        float jitterMsecs { 0.0f }; // mean extra delay of each packet, exponentially distributed
+        float spikeChance { 0.0f }; // chance a packet is held back by a network stall
+        float spikeMsecs { 0.0f }; // how long the stall holds it, the packets behind it queue up
+        float lossChance { 0.0f };
+        quint32 seed { 1 };
+    };
+
+    // packets are sent every network frame and arrive in order, as over a single route
+    static JitterTrace makeSyntheticTrace(const SyntheticTraceOptions& options);
+
+    // traces are text, one packet per line: "<arrival usecs> <sequence>", with # comments
+    static JitterTrace loadTrace(const QString& path);
+    static bool saveTrace(const JitterTrace& trace, const QString& path);
+
+    static Report run(const JitterTrace& trace, const Settings& settings);
+};
+
+#endif // hifi_JitterBufferSimulator_h
@@ -12,12 +12,14 @@
 
 #include "AvatarData.h"
 
+#include <algorithm>
 #include <cstdio>
 #include <cstring>
 #include <stdint.h>
 
 #include <QtCore/QDataStream>
 #include <QtCore/QThread>
+#include <QtCore/QThreadStorage>
 #include <QtCore/QUuid>
 #include <QtCore/QJsonDocument>
 #include <QtCore/QJsonArray>
@@ -174,30 +176,81 @@ QByteArray AvatarData::toByteArrayStateful(AvatarDataDetail dataDetail) {
     AvatarDataPacket::HasFlags hasFlagsOut;
     auto lastSentTime = _lastToByteArray;
     _lastToByteArray = usecTimestampNow();
-    return AvatarData::toByteArray(dataDetail, lastSentTime, getLastSentJointData(), 
-                        hasFlagsOut, false, false, glm::vec3(0), nullptr,
-                        &_outboundDataRate);
+    QVector<JointData> lastSentJointData = getLastSentJointData();
+    auto encode = [&](bool dropFaceTracking) {
+        return AvatarData::toByteArray(dataDetail, lastSentTime, lastSentJointData,
+                            hasFlagsOut, dropFaceTracking, false, glm::vec3(0), nullptr,
+                            &_outboundDataRate);
+    };
+
+    QByteArray avatarByteArray = encode(false);
+    if (avatarByteArray.isEmpty()) {
+        // too much for a packet, so drop the face tracking, then the joints that changed only a little, then every joint
+        AvatarDataDetail requestedDetail = dataDetail;
+        avatarByteArray = encode(true);
+        if (avatarByteArray.isEmpty() && dataDetail == SendAllData) {
+            dataDetail = CullSmallData;
+            avatarByteArray = encode(true);
+        }
+        if (avatarByteArray.isEmpty()) {
+            dataDetail = MinimumData;
+            avatarByteArray = encode(true);
+        }
+        if (shouldLogError(usecTimestampNow())) {
+            qCWarning(avatars) << "AvatarData::toByteArrayStateful" << requestedDetail << "doesn't fit in a packet with"
+                << lastSentJointData.size() << "joints, sending" << dataDetail << "without face tracking";
+        }
+    }
+    _lastEncodedDataDetail = dataDetail;
+    return avatarByteArray;
 }
 
 QByteArray AvatarData::toByteArray(AvatarDataDetail dataDetail, quint64 lastSentTime, const QVector<JointData>& lastSentJointData,
     AvatarDataPacket::HasFlags& hasFlagsOut, bool dropFaceTracking, bool distanceAdjust, 
     glm::vec3 viewerPosition, QVector<JointData>* sentJointDataOut, AvatarDataRate* outboundDataRateOut) const {
 
+    // what an AvatarData packet holds after its sequence number
+    QByteArray avatarDataByteArray(NLPacket::maxPayloadSize(PacketType::AvatarData) - (int)sizeof(AvatarDataSequenceNumber), 0);
+    int avatarDataSize = toBuffer(reinterpret_cast<unsigned char*>(avatarDataByteArray.data()), avatarDataByteArray.size(),
+        dataDetail, lastSentTime, lastSentJointData, hasFlagsOut, dropFaceTracking, distanceAdjust, viewerPosition,
+        sentJointDataOut, outboundDataRateOut);
+    avatarDataByteArray.resize(std::max(avatarDataSize, 0));
+    return avatarDataByteArray;
+}
+
+#define PACKET_WRITE_CHECK(SIZE_TO_WRITE)                                                 \
+    if ((endPosition - destinationBuffer) < (int)(SIZE_TO_WRITE)) {                       \
+        return -1;                                                                        \
+    }
+
+int AvatarData::toBuffer(unsigned char* destinationBuffer, int capacity, AvatarDataDetail dataDetail, quint64 lastSentTime,
+    const QVector<JointData>& lastSentJointData, AvatarDataPacket::HasFlags& hasFlagsOut, bool dropFaceTracking,
+    bool distanceAdjust, glm::vec3 viewerPosition, QVector<JointData>* sentJointDataOut,
+    AvatarDataRate* outboundDataRateOut) const {
+
     bool cullSmallChanges = (dataDetail == CullSmallData);
     bool sendAll = (dataDetail == SendAllData);
     bool sendMinimum = (dataDetail == MinimumData);
 
     lazyInitHeadData();
 
-    QByteArray avatarDataByteArray(udt::MAX_PACKET_SIZE, 0);
-    unsigned char* destinationBuffer = reinterpret_cast<unsigned char*>(avatarDataByteArray.data());
     unsigned char* startPosition = destinationBuffer;
+    const unsigned char* endPosition = destinationBuffer + capacity;
+
+    // the size of the whole avatar leads, and is filled in once we know it
+    PACKET_WRITE_CHECK(sizeof(AvatarDataPacket::AvatarDataSize) + sizeof(AvatarDataPacket::HasFlags));
+    destinationBuffer += sizeof(AvatarDataPacket::AvatarDataSize);
 
     // special case, if we were asked for no data, then just include the flags all set to nothing
     if (dataDetail == NoData) {
         AvatarDataPacket::HasFlags packetStateFlags = 0;
         memcpy(destinationBuffer, &packetStateFlags, sizeof(packetStateFlags));
-        return avatarDataByteArray.left(sizeof(packetStateFlags));
+        destinationBuffer += sizeof(packetStateFlags);
+        hasFlagsOut = packetStateFlags;
+
+        AvatarDataPacket::AvatarDataSize avatarDataSize = destinationBuffer - startPosition;
+        memcpy(startPosition, &avatarDataSize, sizeof(avatarDataSize));
+        return avatarDataSize;
     }
 
     // FIXME -
@@ -240,6 +293,7 @@ QByteArray AvatarData::toByteArray(AvatarDataDetail dataDetail, quint64 lastSent
 
     bool hasFaceTrackerInfo = !dropFaceTracking && hasFaceTracker() && (sendAll || faceTrackerInfoChangedSince(lastSentTime));
     bool hasJointData = sendAll || !sendMinimum;
+    bool hasFauxJointData = hasJointData;
 
     // Leading flags, to indicate how much data is actually included in the packet...
     AvatarDataPacket::HasFlags packetStateFlags =
@@ -254,10 +308,15 @@ QByteArray AvatarData::toByteArray(AvatarDataDetail dataDetail, quint64 lastSent
         | (hasParentInfo ? AvatarDataPacket::PACKET_HAS_PARENT_INFO : 0)
         | (hasAvatarLocalPosition ? AvatarDataPacket::PACKET_HAS_AVATAR_LOCAL_POSITION : 0)
         | (hasFaceTrackerInfo ? AvatarDataPacket::PACKET_HAS_FACE_TRACKER_INFO : 0)
-        | (hasJointData ? AvatarDataPacket::PACKET_HAS_JOINT_DATA : 0);
+        | (hasJointData ? AvatarDataPacket::PACKET_HAS_JOINT_DATA : 0)
+        | (hasFauxJointData ? AvatarDataPacket::PACKET_HAS_FAUX_JOINT_DATA : 0);
 
     memcpy(destinationBuffer, &packetStateFlags, sizeof(packetStateFlags));
     destinationBuffer += sizeof(packetStateFlags);
+    hasFlagsOut = packetStateFlags;
+
+    // every fixed size section together fits in less than a packet, so they're checked once
+    PACKET_WRITE_CHECK(AvatarDataPacket::MAX_FIXED_SECTIONS_SIZE);
 
     if (hasAvatarGlobalPosition) {
         auto startSection = destinationBuffer;
@@ -430,6 +489,10 @@ QByteArray AvatarData::toByteArray(AvatarDataDetail dataDetail, quint64 lastSent
     // If it is connected, pack up the data
     if (hasFaceTrackerInfo) {
         auto startSection = destinationBuffer;
+        PACKET_WRITE_CHECK(sizeof(AvatarDataPacket::SectionSize) + sizeof(AvatarDataPacket::FaceTrackerInfo) +
+            _headData->_blendshapeCoefficients.size() * sizeof(float));
+        destinationBuffer += sizeof(AvatarDataPacket::SectionSize);
+
         auto faceTrackerInfo = reinterpret_cast<AvatarDataPacket::FaceTrackerInfo*>(destinationBuffer);
 
         faceTrackerInfo->leftEyeBlink = _headData->_leftEyeBlink;
@@ -443,7 +506,8 @@ QByteArray AvatarData::toByteArray(AvatarDataDetail dataDetail, quint64 lastSent
         memcpy(destinationBuffer, _headData->_blendshapeCoefficients.data(), _headData->_blendshapeCoefficients.size() * sizeof(float));
         destinationBuffer += _headData->_blendshapeCoefficients.size() * sizeof(float);
 
-        int numBytes = destinationBuffer - startSection;
+        AvatarDataPacket::SectionSize numBytes = destinationBuffer - startSection;
+        memcpy(startSection, &numBytes, sizeof(numBytes));
         if (outboundDataRateOut) {
             outboundDataRateOut->faceTrackerRate.increment(numBytes);
         }
@@ -456,14 +520,21 @@ QByteArray AvatarData::toByteArray(AvatarDataDetail dataDetail, quint64 lastSent
 
         // joint rotation data
         int numJoints = _jointData.size();
+        const int bytesOfValidity = (int)ceil((float)numJoints / (float)BITS_IN_BYTE);
+        const int BYTES_PER_ROTATION = 6;
+        const int BYTES_PER_TRANSLATION = 6;
+        // the rotations and translations are checked once their validity bits say how many are sent
+        PACKET_WRITE_CHECK(sizeof(AvatarDataPacket::SectionSize) + sizeof(uint8_t) + bytesOfValidity);
+        destinationBuffer += sizeof(AvatarDataPacket::SectionSize);
+
         *destinationBuffer++ = (uint8_t)numJoints;
 
         unsigned char* validityPosition = destinationBuffer;
         unsigned char validity = 0;
         int validityBit = 0;
+        int rotationSentCount = 0;
 
 #ifdef WANT_DEBUG
-        int rotationSentCount = 0;
         unsigned char* beforeRotations = destinationBuffer;
 #endif
 
@@ -483,9 +554,7 @@ QByteArray AvatarData::toByteArray(AvatarDataDetail dataDetail, quint64 lastSent
                 if (sendAll || !cullSmallChanges || largeEnoughRotation) {
                     if (data.rotationSet) {
                         validity |= (1 << validityBit);
-#ifdef WANT_DEBUG
                         rotationSentCount++;
-#endif
                         if (sentJointDataOut) {
                             auto jointDataOut = *sentJointDataOut;
                             jointDataOut[i].rotation = data.rotation;
@@ -503,6 +572,9 @@ QByteArray AvatarData::toByteArray(AvatarDataDetail dataDetail, quint64 lastSent
             *destinationBuffer++ = validity;
         }
 
+        // the rotations, and the validity bits of the translations
+        PACKET_WRITE_CHECK(rotationSentCount * BYTES_PER_ROTATION + bytesOfValidity);
+
         validityBit = 0;
         validity = *validityPosition++;
         for (int i = 0; i < _jointData.size(); i++) {
@@ -521,9 +593,9 @@ QByteArray AvatarData::toByteArray(AvatarDataDetail dataDetail, quint64 lastSent
         validityPosition = destinationBuffer;
         validity = 0;
         validityBit = 0;
+        int translationSentCount = 0;
 
 #ifdef WANT_DEBUG
-        int translationSentCount = 0;
         unsigned char* beforeTranslations = destinationBuffer;
 #endif
 
@@ -538,9 +610,7 @@ QByteArray AvatarData::toByteArray(AvatarDataDetail dataDetail, quint64 lastSent
                     glm::distance(data.translation, lastSentJointData[i].translation) > minTranslation) {
                     if (data.translationSet) {
                         validity |= (1 << validityBit);
-#ifdef WANT_DEBUG
                         translationSentCount++;
-#endif
                         maxTranslationDimension = glm::max(fabsf(data.translation.x), maxTranslationDimension);
                         maxTranslationDimension = glm::max(fabsf(data.translation.y), maxTranslationDimension);
                         maxTranslationDimension = glm::max(fabsf(data.translation.z), maxTranslationDimension);
@@ -563,6 +633,8 @@ QByteArray AvatarData::toByteArray(AvatarDataDetail dataDetail, quint64 lastSent
             *destinationBuffer++ = validity;
         }
 
+        PACKET_WRITE_CHECK(translationSentCount * BYTES_PER_TRANSLATION);
+
         validityBit = 0;
         validity = *validityPosition++;
         for (int i = 0; i < _jointData.size(); i++) {
@@ -577,16 +649,6 @@ QByteArray AvatarData::toByteArray(AvatarDataDetail dataDetail, quint64 lastSent
             }
         }
 
-        // faux joints
-        Transform controllerLeftHandTransform = Transform(getControllerLeftHandMatrix());
-        destinationBuffer += packOrientationQuatToSixBytes(destinationBuffer, controllerLeftHandTransform.getRotation());
-        destinationBuffer += packFloatVec3ToSignedTwoByteFixed(destinationBuffer, controllerLeftHandTransform.getTranslation(),
-            TRANSLATION_COMPRESSION_RADIX);
-        Transform controllerRightHandTransform = Transform(getControllerRightHandMatrix());
-        destinationBuffer += packOrientationQuatToSixBytes(destinationBuffer, controllerRightHandTransform.getRotation());
-        destinationBuffer += packFloatVec3ToSignedTwoByteFixed(destinationBuffer, controllerRightHandTransform.getTranslation(),
-            TRANSLATION_COMPRESSION_RADIX);
-
 #ifdef WANT_DEBUG
         if (sendAll) {
             qCDebug(avatars) << "AvatarData::toByteArray" << cullSmallChanges << sendAll
@@ -600,17 +662,45 @@ QByteArray AvatarData::toByteArray(AvatarDataDetail dataDetail, quint64 lastSent
         }
 #endif
 
+        AvatarDataPacket::SectionSize numBytes = destinationBuffer - startSection;
+        memcpy(startSection, &numBytes, sizeof(numBytes));
+        if (outboundDataRateOut) {
+            outboundDataRateOut->jointDataRate.increment(numBytes);
+        }
+    }
+
+    // the controller faux joints, which far grab follows
+    if (hasFauxJointData) {
+        auto startSection = destinationBuffer;
+        PACKET_WRITE_CHECK(AvatarDataPacket::FAUX_JOINT_DATA_SIZE);
+
+        Transform controllerLeftHandTransform = Transform(getControllerLeftHandMatrix());
+        destinationBuffer += packOrientationQuatToSixBytes(destinationBuffer, controllerLeftHandTransform.getRotation());
+        destinationBuffer += packFloatVec3ToSignedTwoByteFixed(destinationBuffer, controllerLeftHandTransform.getTranslation(),
+            TRANSLATION_COMPRESSION_RADIX);
+        Transform controllerRightHandTransform = Transform(getControllerRightHandMatrix());
+        destinationBuffer += packOrientationQuatToSixBytes(destinationBuffer, controllerRightHandTransform.getRotation());
+        destinationBuffer += packFloatVec3ToSignedTwoByteFixed(destinationBuffer, controllerRightHandTransform.getTranslation(),
+            TRANSLATION_COMPRESSION_RADIX);
+
         int numBytes = destinationBuffer - startSection;
         if (outboundDataRateOut) {
             outboundDataRateOut->jointDataRate.increment(numBytes);
         }
     }
 
-    int avatarDataSize = destinationBuffer - startPosition;
-    return avatarDataByteArray.left(avatarDataSize);
+    AvatarDataPacket::AvatarDataSize avatarDataSize = destinationBuffer - startPosition;
+    memcpy(startPosition, &avatarDataSize, sizeof(avatarDataSize));
+    return avatarDataSize;
 }
 // NOTE: This is never used in a "distanceAdjust" mode, so it's ok that it doesn't use a variable minimum rotation/translation
 void AvatarData::doneEncoding(bool cullSmallChanges) {
+    // what was encoded may have had fewer joints than was asked for, to fit in a packet
+    if (_lastEncodedDataDetail == MinimumData) {
+        return;
+    }
+    cullSmallChanges = cullSmallChanges || _lastEncodedDataDetail == CullSmallData;
+
     // The server has finished sending this version of the joint-data to other nodes.  Update _lastSentJointData.
     QReadLocker readLock(&_jointDataLock);
     _lastSentJointData.resize(_jointData.size());
@@ -650,7 +740,7 @@ bool AvatarData::shouldLogError(const quint64& now) {
 }
 
 
-const unsigned char* unpackFauxJoint(const unsigned char* sourceBuffer, ThreadSafeValueCache<glm::mat4>& matrixCache) {
+static void unpackFauxJoint(const unsigned char*& sourceBuffer, glm::mat4& matrix) {
     glm::quat orientation;
     glm::vec3 position;
     Transform transform;
@@ -658,33 +748,62 @@ const unsigned char* unpackFauxJoint(const unsigned char* sourceBuffer, ThreadSa
     sourceBuffer += unpackFloatVec3FromSignedTwoByteFixed(sourceBuffer, position, TRANSLATION_COMPRESSION_RADIX);
     transform.setTranslation(position);
     transform.setRotation(orientation);
-    matrixCache.set(transform.getMatrix());
-    return sourceBuffer;
+    matrix = transform.getMatrix();
 }
 
-
 #define PACKET_READ_CHECK(ITEM_NAME, SIZE_TO_READ)                                        \
     if ((endPosition - sourceBuffer) < (int)SIZE_TO_READ) {                               \
-        if (shouldLogError(now)) {                                                        \
-            qCWarning(avatars) << "AvatarData packet too small, attempting to read " <<   \
-                #ITEM_NAME << ", only " << (endPosition - sourceBuffer) <<                \
-                " bytes left, " << getSessionUUID();                                      \
-        }                                                                                 \
-        return buffer.size();                                                             \
+        decoded.error = QString("AvatarData packet too small, attempting to read %1, only %2 bytes left") \
+            .arg(#ITEM_NAME).arg(endPosition - sourceBuffer);                             \
+        return decoded.size;                                                              \
     }
 
-// read data in packet starting at byte offset and return number of bytes parsed
-int AvatarData::parseDataFromBuffer(const QByteArray& buffer) {
-    // lazily allocate memory for HeadData in case we're not an Avatar instance
-    lazyInitHeadData();
+// the size a variable length section leads with, which includes the size itself
+static int readSectionSize(const unsigned char* sourceBuffer) {
+    AvatarDataPacket::SectionSize sectionSize;
+    memcpy(&sectionSize, sourceBuffer, sizeof(sectionSize));
+    return std::max((int)sectionSize, (int)sizeof(sectionSize));
+}
 
-    AvatarDataPacket::HasFlags packetStateFlags;
+// read the bits saying which joints follow, return how many do
+static int unpackValidityBits(const unsigned char*& sourceBuffer, QVector<JointData>& jointData, bool JointData::*valid) {
+    int numValid = 0;
+    unsigned char validity = 0;
+    int validityBit = 0;
+    for (int i = 0; i < jointData.size(); i++) {
+        if (validityBit == 0) {
+            validity = *sourceBuffer++;
+        }
+        jointData[i].*valid = (bool)(validity & (1 << validityBit));
+        if (jointData[i].*valid) {
+            ++numValid;
+        }
+        validityBit = (validityBit + 1) % BITS_IN_BYTE;
+    }
+    return numValid;
+}
+
+// decode the data in the buffer, without touching any avatar, and return number of bytes it took
+int AvatarData::decodeDataFromBuffer(const QByteArray& buffer, DecodedAvatarData& decoded,
+                                     AvatarDataPacket::HasFlags ignoredSections) {
+    decoded.hasFlags = 0;
+    decoded.error.clear();
+
+    // everything we read is bounded by the size the avatar leads with, so a bad avatar never reads into the next
+    int avatarDataSize = getAvatarDataSize(buffer);
+    if (avatarDataSize < (int)(sizeof(AvatarDataPacket::AvatarDataSize) + sizeof(AvatarDataPacket::HasFlags))) {
+        decoded.error = "Discard AvatarData packet: bad avatar data size";
+        decoded.size = buffer.size();
+        return decoded.size;
+    }
+    decoded.size = avatarDataSize;
 
     const unsigned char* startPosition = reinterpret_cast<const unsigned char*>(buffer.data());
-    const unsigned char* endPosition = startPosition + buffer.size();
-    const unsigned char* sourceBuffer = startPosition;
+    const unsigned char* endPosition = startPosition + avatarDataSize;
+    const unsigned char* sourceBuffer = startPosition + sizeof(AvatarDataPacket::AvatarDataSize);
 
     // read the packet flags
+    AvatarDataPacket::HasFlags packetStateFlags;
     memcpy(&packetStateFlags, sourceBuffer, sizeof(packetStateFlags));
     sourceBuffer += sizeof(packetStateFlags);
 
@@ -702,133 +821,68 @@ int AvatarData::parseDataFromBuffer(const QByteArray& buffer) {
     bool hasAvatarLocalPosition  = HAS_FLAG(packetStateFlags, AvatarDataPacket::PACKET_HAS_AVATAR_LOCAL_POSITION);
     bool hasFaceTrackerInfo      = HAS_FLAG(packetStateFlags, AvatarDataPacket::PACKET_HAS_FACE_TRACKER_INFO);
     bool hasJointData            = HAS_FLAG(packetStateFlags, AvatarDataPacket::PACKET_HAS_JOINT_DATA);
-
-    quint64 now = usecTimestampNow();
+    bool hasFauxJointData        = HAS_FLAG(packetStateFlags, AvatarDataPacket::PACKET_HAS_FAUX_JOINT_DATA);
 
     if (hasAvatarGlobalPosition) {
-        auto startSection = sourceBuffer;
-
         PACKET_READ_CHECK(AvatarGlobalPosition, sizeof(AvatarDataPacket::AvatarGlobalPosition));
         auto data = reinterpret_cast<const AvatarDataPacket::AvatarGlobalPosition*>(sourceBuffer);
-        auto newValue = glm::vec3(data->globalPosition[0], data->globalPosition[1], data->globalPosition[2]);
-        if (_globalPosition != newValue) {
-            _globalPosition = newValue;
-            _globalPositionChanged = usecTimestampNow();
-        }
+        decoded.globalPosition = glm::vec3(data->globalPosition[0], data->globalPosition[1], data->globalPosition[2]);
         sourceBuffer += sizeof(AvatarDataPacket::AvatarGlobalPosition);
-        int numBytesRead = sourceBuffer - startSection;
-        _globalPositionRate.increment(numBytesRead);
-        _globalPositionUpdateRate.increment();
-
-        // if we don't have a parent, make sure to also set our local position
-        if (!hasParent()) {
-            setLocalPosition(newValue);
-        }
+        decoded.hasFlags |= AvatarDataPacket::PACKET_HAS_AVATAR_GLOBAL_POSITION;
     }
 
     if (hasAvatarBoundingBox) {
-        auto startSection = sourceBuffer;
-
         PACKET_READ_CHECK(AvatarBoundingBox, sizeof(AvatarDataPacket::AvatarBoundingBox));
         auto data = reinterpret_cast<const AvatarDataPacket::AvatarBoundingBox*>(sourceBuffer);
-        auto newDimensions = glm::vec3(data->avatarDimensions[0], data->avatarDimensions[1], data->avatarDimensions[2]);
-        auto newOffset = glm::vec3(data->boundOriginOffset[0], data->boundOriginOffset[1], data->boundOriginOffset[2]);
-
-
-        if (_globalBoundingBoxDimensions != newDimensions) {
-            _globalBoundingBoxDimensions = newDimensions;
-            _avatarBoundingBoxChanged = usecTimestampNow();
-        }
-        if (_globalBoundingBoxOffset != newOffset) {
-            _globalBoundingBoxOffset = newOffset;
-            _avatarBoundingBoxChanged = usecTimestampNow();
-        }
-
+        decoded.boundingBoxDimensions = glm::vec3(data->avatarDimensions[0], data->avatarDimensions[1], data->avatarDimensions[2]);
+        decoded.boundingBoxOffset = glm::vec3(data->boundOriginOffset[0], data->boundOriginOffset[1], data->boundOriginOffset[2]);
         sourceBuffer += sizeof(AvatarDataPacket::AvatarBoundingBox);
-        int numBytesRead = sourceBuffer - startSection;
-        _avatarBoundingBoxRate.increment(numBytesRead);
-        _avatarBoundingBoxUpdateRate.increment();
+        decoded.hasFlags |= AvatarDataPacket::PACKET_HAS_AVATAR_BOUNDING_BOX;
     }
 
     if (hasAvatarOrientation) {
-        auto startSection = sourceBuffer;
         PACKET_READ_CHECK(AvatarOrientation, sizeof(AvatarDataPacket::AvatarOrientation));
-        glm::quat newOrientation;
-        sourceBuffer += unpackOrientationQuatFromSixBytes(sourceBuffer, newOrientation);
-        glm::quat currentOrientation = getLocalOrientation();
-
-        if (currentOrientation != newOrientation) {
-            _hasNewJointData = true;
-            setLocalOrientation(newOrientation);
-        }
-        int numBytesRead = sourceBuffer - startSection;
-        _avatarOrientationRate.increment(numBytesRead);
-        _avatarOrientationUpdateRate.increment();
+        sourceBuffer += unpackOrientationQuatFromSixBytes(sourceBuffer, decoded.orientation);
+        decoded.hasFlags |= AvatarDataPacket::PACKET_HAS_AVATAR_ORIENTATION;
     }
 
     if (hasAvatarScale) {
-        auto startSection = sourceBuffer;
-
         PACKET_READ_CHECK(AvatarScale, sizeof(AvatarDataPacket::AvatarScale));
         auto data = reinterpret_cast<const AvatarDataPacket::AvatarScale*>(sourceBuffer);
-        float scale;
-        unpackFloatRatioFromTwoByte((uint8_t*)&data->scale, scale);
-        if (isNaN(scale)) {
-            if (shouldLogError(now)) {
-                qCWarning(avatars) << "Discard AvatarData packet: scale NaN, uuid " << getSessionUUID();
-            }
-            return buffer.size();
+        unpackFloatRatioFromTwoByte((uint8_t*)&data->scale, decoded.scale);
+        if (isNaN(decoded.scale)) {
+            decoded.error = "Discard AvatarData packet: scale NaN";
+            return decoded.size;
         }
-        setTargetScale(scale);
         sourceBuffer += sizeof(AvatarDataPacket::AvatarScale);
-        int numBytesRead = sourceBuffer - startSection;
-        _avatarScaleRate.increment(numBytesRead);
-        _avatarScaleUpdateRate.increment();
+        decoded.hasFlags |= AvatarDataPacket::PACKET_HAS_AVATAR_SCALE;
     }
 
     if (hasLookAtPosition) {
-        auto startSection = sourceBuffer;
-
         PACKET_READ_CHECK(LookAtPosition, sizeof(AvatarDataPacket::LookAtPosition));
         auto data = reinterpret_cast<const AvatarDataPacket::LookAtPosition*>(sourceBuffer);
-        glm::vec3 lookAt = glm::vec3(data->lookAtPosition[0], data->lookAtPosition[1], data->lookAtPosition[2]);
-        if (isNaN(lookAt)) {
-            if (shouldLogError(now)) {
-                qCWarning(avatars) << "Discard AvatarData packet: lookAtPosition is NaN, uuid " << getSessionUUID();
-            }
-            return buffer.size();
+        decoded.lookAtPosition = glm::vec3(data->lookAtPosition[0], data->lookAtPosition[1], data->lookAtPosition[2]);
+        if (isNaN(decoded.lookAtPosition)) {
+            decoded.error = "Discard AvatarData packet: lookAtPosition is NaN";
+            return decoded.size;
         }
-        _headData->setLookAtPosition(lookAt);
         sourceBuffer += sizeof(AvatarDataPacket::LookAtPosition);
-        int numBytesRead = sourceBuffer - startSection;
-        _lookAtPositionRate.increment(numBytesRead);
-        _lookAtPositionUpdateRate.increment();
+        decoded.hasFlags |= AvatarDataPacket::PACKET_HAS_LOOK_AT_POSITION;
     }
 
     if (hasAudioLoudness) {
-        auto startSection = sourceBuffer;
-
         PACKET_READ_CHECK(AudioLoudness, sizeof(AvatarDataPacket::AudioLoudness));
         auto data = reinterpret_cast<const AvatarDataPacket::AudioLoudness*>(sourceBuffer);
-        float audioLoudness;
-        audioLoudness = unpackFloatGainFromByte(data->audioLoudness) * AUDIO_LOUDNESS_SCALE;
+        decoded.audioLoudness = unpackFloatGainFromByte(data->audioLoudness) * AUDIO_LOUDNESS_SCALE;
         sourceBuffer += sizeof(AvatarDataPacket::AudioLoudness);
-
-        if (isNaN(audioLoudness)) {
-            if (shouldLogError(now)) {
-                qCWarning(avatars) << "Discard AvatarData packet: audioLoudness is NaN, uuid " << getSessionUUID();
-            }
-            return buffer.size();
+        if (isNaN(decoded.audioLoudness)) {
+            decoded.error = "Discard AvatarData packet: audioLoudness is NaN";
+            return decoded.size;
         }
-        _headData->setAudioLoudness(audioLoudness);
-        int numBytesRead = sourceBuffer - startSection;
-        _audioLoudnessRate.increment(numBytesRead);
-        _audioLoudnessUpdateRate.increment();
+        decoded.hasFlags |= AvatarDataPacket::PACKET_HAS_AUDIO_LOUDNESS;
     }
 
     if (hasSensorToWorldMatrix) {
-        auto startSection = sourceBuffer;
-
         PACKET_READ_CHECK(SensorToWorldMatrix, sizeof(AvatarDataPacket::SensorToWorldMatrix));
         auto data = reinterpret_cast<const AvatarDataPacket::SensorToWorldMatrix*>(sourceBuffer);
         glm::quat sensorToWorldQuat;
@@ -836,26 +890,18 @@ int AvatarData::parseDataFromBuffer(const QByteArray& buffer) {
         float sensorToWorldScale;
         unpackFloatScalarFromSignedTwoByteFixed((int16_t*)&data->sensorToWorldScale, &sensorToWorldScale, SENSOR_TO_WORLD_SCALE_RADIX);
         glm::vec3 sensorToWorldTrans(data->sensorToWorldTrans[0], data->sensorToWorldTrans[1], data->sensorToWorldTrans[2]);
-        glm::mat4 sensorToWorldMatrix = createMatFromScaleQuatAndPos(glm::vec3(sensorToWorldScale), sensorToWorldQuat, sensorToWorldTrans);
-        if (_sensorToWorldMatrixCache.get() != sensorToWorldMatrix) {
-            _sensorToWorldMatrixCache.set(sensorToWorldMatrix);
-            _sensorToWorldMatrixChanged = usecTimestampNow();
-        }
+        decoded.sensorToWorldMatrix = createMatFromScaleQuatAndPos(glm::vec3(sensorToWorldScale), sensorToWorldQuat, sensorToWorldTrans);
         sourceBuffer += sizeof(AvatarDataPacket::SensorToWorldMatrix);
-        int numBytesRead = sourceBuffer - startSection;
-        _sensorToWorldRate.increment(numBytesRead);
-        _sensorToWorldUpdateRate.increment();
+        decoded.hasFlags |= AvatarDataPacket::PACKET_HAS_SENSOR_TO_WORLD_MATRIX;
     }
 
     if (hasAdditionalFlags) {
-        auto startSection = sourceBuffer;
-
         PACKET_READ_CHECK(AdditionalFlags, sizeof(AvatarDataPacket::AdditionalFlags));
         auto data = reinterpret_cast<const AvatarDataPacket::AdditionalFlags*>(sourceBuffer);
         uint8_t bitItems = data->flags;
 
         // key state, stored as a semi-nibble in the bitItems
-        auto newKeyState = (KeyState)getSemiNibbleAt(bitItems, KEY_STATE_START_BIT);
+        decoded.keyState = (KeyState)getSemiNibbleAt(bitItems, KEY_STATE_START_BIT);
 
         // hand state, stored as a semi-nibble plus a bit in the bitItems
         // we store the hand state as well as other items in a shared bitset. The hand state is an octal, but is split
@@ -864,174 +910,116 @@ int AvatarData::parseDataFromBuffer(const QByteArray& buffer) {
         //     |x,x|H0,H1|x,x,x|H2|
         //     +---+-----+-----+--+
         // Hand state - H0,H1,H2 is found in the 3rd, 4th, and 8th bits
-        auto newHandState = getSemiNibbleAt(bitItems, HAND_STATE_START_BIT)
+        decoded.handState = getSemiNibbleAt(bitItems, HAND_STATE_START_BIT)
             + (oneAtBit(bitItems, HAND_STATE_FINGER_POINTING_BIT) ? IS_FINGER_POINTING_FLAG : 0);
 
-        auto newFaceTrackerConnected = oneAtBit(bitItems, IS_FACESHIFT_CONNECTED);
-        auto newEyeTrackerConnected = oneAtBit(bitItems, IS_EYE_TRACKER_CONNECTED);
-
-        bool keyStateChanged = (_keyState != newKeyState);
-        bool handStateChanged = (_handState != newHandState);
-        bool faceStateChanged = (_headData->_isFaceTrackerConnected != newFaceTrackerConnected);
-        bool eyeStateChanged = (_headData->_isEyeTrackerConnected != newEyeTrackerConnected);
-        bool somethingChanged = keyStateChanged || handStateChanged || faceStateChanged || eyeStateChanged;
-
-        _keyState = newKeyState;
-        _handState = newHandState;
-        _headData->_isFaceTrackerConnected = newFaceTrackerConnected;
-        _headData->_isEyeTrackerConnected = newEyeTrackerConnected;
+        decoded.isFaceTrackerConnected = oneAtBit(bitItems, IS_FACESHIFT_CONNECTED);
+        decoded.isEyeTrackerConnected = oneAtBit(bitItems, IS_EYE_TRACKER_CONNECTED);
 
         sourceBuffer += sizeof(AvatarDataPacket::AdditionalFlags);
-
-        if (somethingChanged) {
-            _additionalFlagsChanged = usecTimestampNow();
-        }
-        int numBytesRead = sourceBuffer - startSection;
-        _additionalFlagsRate.increment(numBytesRead);
-        _additionalFlagsUpdateRate.increment();
+        decoded.hasFlags |= AvatarDataPacket::PACKET_HAS_ADDITIONAL_FLAGS;
     }
 
     if (hasParentInfo) {
-        auto startSection = sourceBuffer;
         PACKET_READ_CHECK(ParentInfo, sizeof(AvatarDataPacket::ParentInfo));
         auto parentInfo = reinterpret_cast<const AvatarDataPacket::ParentInfo*>(sourceBuffer);
         sourceBuffer += sizeof(AvatarDataPacket::ParentInfo);
 
         QByteArray byteArray((const char*)parentInfo->parentUUID, NUM_BYTES_RFC4122_UUID);
-
-        auto newParentID = QUuid::fromRfc4122(byteArray);
-
-        if ((getParentID() != newParentID) || (getParentJointIndex() != parentInfo->parentJointIndex)) {
-            SpatiallyNestable::setParentID(newParentID);
-            SpatiallyNestable::setParentJointIndex(parentInfo->parentJointIndex);
-            _parentChanged = usecTimestampNow();
-        }
-
-        int numBytesRead = sourceBuffer - startSection;
-        _parentInfoRate.increment(numBytesRead);
-        _parentInfoUpdateRate.increment();
+        decoded.parentID = QUuid::fromRfc4122(byteArray);
+        decoded.parentJointIndex = parentInfo->parentJointIndex;
+        decoded.hasFlags |= AvatarDataPacket::PACKET_HAS_PARENT_INFO;
     }
 
     if (hasAvatarLocalPosition) {
-        auto startSection = sourceBuffer;
-
         PACKET_READ_CHECK(AvatarLocalPosition, sizeof(AvatarDataPacket::AvatarLocalPosition));
         auto data = reinterpret_cast<const AvatarDataPacket::AvatarLocalPosition*>(sourceBuffer);
-        glm::vec3 position = glm::vec3(data->localPosition[0], data->localPosition[1], data->localPosition[2]);
-        if (isNaN(position)) {
-            if (shouldLogError(now)) {
-                qCWarning(avatars) << "Discard AvatarData packet: position NaN, uuid " << getSessionUUID();
-            }
-            return buffer.size();
-        }
-        if (hasParent()) {
-            setLocalPosition(position);
-        } else {
-            qCWarning(avatars) << "received localPosition for avatar with no parent";
+        decoded.localPosition = glm::vec3(data->localPosition[0], data->localPosition[1], data->localPosition[2]);
+        if (isNaN(decoded.localPosition)) {
+            decoded.error = "Discard AvatarData packet: position NaN";
+            return decoded.size;
         }
         sourceBuffer += sizeof(AvatarDataPacket::AvatarLocalPosition);
-        int numBytesRead = sourceBuffer - startSection;
-        _localPositionRate.increment(numBytesRead);
-        _localPositionUpdateRate.increment();
+        decoded.hasFlags |= AvatarDataPacket::PACKET_HAS_AVATAR_LOCAL_POSITION;
     }
 
-    if (hasFaceTrackerInfo) {
+    if (hasFaceTrackerInfo && HAS_FLAG(ignoredSections, AvatarDataPacket::PACKET_HAS_FACE_TRACKER_INFO)) {
+        PACKET_READ_CHECK(FaceTrackerSize, sizeof(AvatarDataPacket::SectionSize));
+        int sectionSize = readSectionSize(sourceBuffer);
+        PACKET_READ_CHECK(FaceTracker, sectionSize);
+        sourceBuffer += sectionSize;
+    } else if (hasFaceTrackerInfo) {
         auto startSection = sourceBuffer;
 
+        PACKET_READ_CHECK(FaceTrackerSize, sizeof(AvatarDataPacket::SectionSize));
+        int sectionSize = readSectionSize(sourceBuffer);
+        PACKET_READ_CHECK(FaceTracker, sectionSize);
+        sourceBuffer += sizeof(AvatarDataPacket::SectionSize);
         PACKET_READ_CHECK(FaceTrackerInfo, sizeof(AvatarDataPacket::FaceTrackerInfo));
         auto faceTrackerInfo = reinterpret_cast<const AvatarDataPacket::FaceTrackerInfo*>(sourceBuffer);
         sourceBuffer += sizeof(AvatarDataPacket::FaceTrackerInfo);
 
-        _headData->_leftEyeBlink = faceTrackerInfo->leftEyeBlink;
-        _headData->_rightEyeBlink = faceTrackerInfo->rightEyeBlink;
-        _headData->_averageLoudness = faceTrackerInfo->averageLoudness;
-        _headData->_browAudioLift = faceTrackerInfo->browAudioLift;
+        decoded.leftEyeBlink = faceTrackerInfo->leftEyeBlink;
+        decoded.rightEyeBlink = faceTrackerInfo->rightEyeBlink;
+        decoded.averageLoudness = faceTrackerInfo->averageLoudness;
+        decoded.browAudioLift = faceTrackerInfo->browAudioLift;
 
         int numCoefficients = faceTrackerInfo->numBlendshapeCoefficients;
         const int coefficientsSize = sizeof(float) * numCoefficients;
         PACKET_READ_CHECK(FaceTrackerCoefficients, coefficientsSize);
-        _headData->_blendshapeCoefficients.resize(numCoefficients);  // make sure there's room for the copy!
-        memcpy(_headData->_blendshapeCoefficients.data(), sourceBuffer, coefficientsSize);
+        decoded.blendshapeCoefficients.resize(numCoefficients);  // make sure there's room for the copy!
+        memcpy(decoded.blendshapeCoefficients.data(), sourceBuffer, coefficientsSize);
         sourceBuffer += coefficientsSize;
-        int numBytesRead = sourceBuffer - startSection;
-        _faceTrackerRate.increment(numBytesRead);
-        _faceTrackerUpdateRate.increment();
+
+        // the next section starts where the size says, whatever this one holds that we didn't read
+        if (sourceBuffer - startSection > sectionSize) {
+            decoded.error = "Discard AvatarData packet: face tracker info overruns its section";
+            return decoded.size;
+        }
+        sourceBuffer = startSection + sectionSize;
+        decoded.faceTrackerBytes = sectionSize;
+        decoded.hasFlags |= AvatarDataPacket::PACKET_HAS_FACE_TRACKER_INFO;
     }
 
-    if (hasJointData) {
+    if (hasJointData && HAS_FLAG(ignoredSections, AvatarDataPacket::PACKET_HAS_JOINT_DATA)) {
+        PACKET_READ_CHECK(JointDataSize, sizeof(AvatarDataPacket::SectionSize));
+        int sectionSize = readSectionSize(sourceBuffer);
+        PACKET_READ_CHECK(JointData, sectionSize);
+        sourceBuffer += sectionSize;
+    } else if (hasJointData) {
         auto startSection = sourceBuffer;
 
+        PACKET_READ_CHECK(JointDataSize, sizeof(AvatarDataPacket::SectionSize));
+        int sectionSize = readSectionSize(sourceBuffer);
+        PACKET_READ_CHECK(JointData, sectionSize);
+        sourceBuffer += sizeof(AvatarDataPacket::SectionSize);
         PACKET_READ_CHECK(NumJoints, sizeof(uint8_t));
         int numJoints = *sourceBuffer++;
         const int bytesOfValidity = (int)ceil((float)numJoints / (float)BITS_IN_BYTE);
-        PACKET_READ_CHECK(JointRotationValidityBits, bytesOfValidity);
-
-        int numValidJointRotations = 0;
-        QVector<bool> validRotations;
-        validRotations.resize(numJoints);
-        { // rotation validity bits
-            unsigned char validity = 0;
-            int validityBit = 0;
-            for (int i = 0; i < numJoints; i++) {
-                if (validityBit == 0) {
-                    validity = *sourceBuffer++;
-                }
-                bool valid = (bool)(validity & (1 << validityBit));
-                if (valid) {
-                    ++numValidJointRotations;
-                }
-                validRotations[i] = valid;
-                validityBit = (validityBit + 1) % BITS_IN_BYTE;
-            }
-        }
+        decoded.jointData.resize(numJoints);
 
         // each joint rotation is stored in 6 bytes.
-        QWriteLocker writeLock(&_jointDataLock);
-        _jointData.resize(numJoints);
+        PACKET_READ_CHECK(JointRotationValidityBits, bytesOfValidity);
+        int numValidJointRotations = unpackValidityBits(sourceBuffer, decoded.jointData, &JointData::rotationSet);
 
         const int COMPRESSED_QUATERNION_SIZE = 6;
         PACKET_READ_CHECK(JointRotations, numValidJointRotations * COMPRESSED_QUATERNION_SIZE);
-        for (int i = 0; i < numJoints; i++) {
-            JointData& data = _jointData[i];
-            if (validRotations[i]) {
+        for (auto& data : decoded.jointData) {
+            if (data.rotationSet) {
                 sourceBuffer += unpackOrientationQuatFromSixBytes(sourceBuffer, data.rotation);
-                _hasNewJointData = true;
-                data.rotationSet = true;
             }
         }
 
-        PACKET_READ_CHECK(JointTranslationValidityBits, bytesOfValidity);
-
         // get translation validity bits -- these indicate which translations were packed
-        int numValidJointTranslations = 0;
-        QVector<bool> validTranslations;
-        validTranslations.resize(numJoints);
-        { // translation validity bits
-            unsigned char validity = 0;
-            int validityBit = 0;
-            for (int i = 0; i < numJoints; i++) {
-                if (validityBit == 0) {
-                    validity = *sourceBuffer++;
-                }
-                bool valid = (bool)(validity & (1 << validityBit));
-                if (valid) {
-                    ++numValidJointTranslations;
-                }
-                validTranslations[i] = valid;
-                validityBit = (validityBit + 1) % BITS_IN_BYTE;
-            }
-        } // 1 + bytesOfValidity bytes
+        PACKET_READ_CHECK(JointTranslationValidityBits, bytesOfValidity);
+        int numValidJointTranslations = unpackValidityBits(sourceBuffer, decoded.jointData, &JointData::translationSet);
 
         // each joint translation component is stored in 6 bytes.
         const int COMPRESSED_TRANSLATION_SIZE = 6;
         PACKET_READ_CHECK(JointTranslation, numValidJointTranslations * COMPRESSED_TRANSLATION_SIZE);
-
-        for (int i = 0; i < numJoints; i++) {
-            JointData& data = _jointData[i];
-            if (validTranslations[i]) {
+        for (auto& data : decoded.jointData) {
+            if (data.translationSet) {
                 sourceBuffer += unpackFloatVec3FromSignedTwoByteFixed(sourceBuffer, data.translation, TRANSLATION_COMPRESSION_RADIX);
-                _hasNewJointData = true;
-                data.translationSet = true;
             }
         }
 
@@ -1042,22 +1030,214 @@ int AvatarData::parseDataFromBuffer(const QByteArray& buffer) {
                 << "size:" << (int)(sourceBuffer - startPosition);
         }
 #endif
-        // faux joints
-        sourceBuffer = unpackFauxJoint(sourceBuffer, _controllerLeftHandMatrixCache);
-        sourceBuffer = unpackFauxJoint(sourceBuffer, _controllerRightHandMatrixCache);
+        if (sourceBuffer - startSection > sectionSize) {
+            decoded.error = "Discard AvatarData packet: joint data overruns its section";
+            return decoded.size;
+        }
+        sourceBuffer = startSection + sectionSize;
+        decoded.jointDataBytes = sectionSize;
+        decoded.hasFlags |= AvatarDataPacket::PACKET_HAS_JOINT_DATA;
+    }
+
+    if (hasFauxJointData) {
+        PACKET_READ_CHECK(FauxJointData, AvatarDataPacket::FAUX_JOINT_DATA_SIZE);
+        if (HAS_FLAG(ignoredSections, AvatarDataPacket::PACKET_HAS_FAUX_JOINT_DATA)) {
+            sourceBuffer += AvatarDataPacket::FAUX_JOINT_DATA_SIZE;
+        } else {
+            unpackFauxJoint(sourceBuffer, decoded.controllerLeftHandMatrix);
+            unpackFauxJoint(sourceBuffer, decoded.controllerRightHandMatrix);
+            decoded.hasFlags |= AvatarDataPacket::PACKET_HAS_FAUX_JOINT_DATA;
+        }
+    }
+
+    // anything left is from sections newer than we are, skip it
+    return decoded.size;
+}
+
+void AvatarData::applyDecodedData(const DecodedAvatarData& decoded) {
+    // lazily allocate memory for HeadData in case we're not an Avatar instance
+    lazyInitHeadData();
+
+    quint64 now = usecTimestampNow();
+    AvatarDataPacket::HasFlags hasFlags = decoded.hasFlags;
+
+    if (HAS_FLAG(hasFlags, AvatarDataPacket::PACKET_HAS_AVATAR_GLOBAL_POSITION)) {
+        auto newValue = decoded.globalPosition;
+        if (_globalPosition != newValue) {
+            _globalPosition = newValue;
+            _globalPositionChanged = now;
+        }
+        _globalPositionRate.increment(AvatarDataPacket::AVATAR_GLOBAL_POSITION_SIZE);
+        _globalPositionUpdateRate.increment();
+
+        // if we don't have a parent, make sure to also set our local position
+        if (!hasParent()) {
+            setLocalPosition(newValue);
+        }
+    }
+
+    if (HAS_FLAG(hasFlags, AvatarDataPacket::PACKET_HAS_AVATAR_BOUNDING_BOX)) {
+        if (_globalBoundingBoxDimensions != decoded.boundingBoxDimensions) {
+            _globalBoundingBoxDimensions = decoded.boundingBoxDimensions;
+            _avatarBoundingBoxChanged = now;
+        }
+        if (_globalBoundingBoxOffset != decoded.boundingBoxOffset) {
+            _globalBoundingBoxOffset = decoded.boundingBoxOffset;
+            _avatarBoundingBoxChanged = now;
+        }
+        _avatarBoundingBoxRate.increment(AvatarDataPacket::AVATAR_BOUNDING_BOX_SIZE);
+        _avatarBoundingBoxUpdateRate.increment();
+    }
+
+    if (HAS_FLAG(hasFlags, AvatarDataPacket::PACKET_HAS_AVATAR_ORIENTATION)) {
+        if (getLocalOrientation() != decoded.orientation) {
+            _hasNewJointData = true;
+            setLocalOrientation(decoded.orientation);
+        }
+        _avatarOrientationRate.increment(AvatarDataPacket::AVATAR_ORIENTATION_SIZE);
+        _avatarOrientationUpdateRate.increment();
+    }
+
+    if (HAS_FLAG(hasFlags, AvatarDataPacket::PACKET_HAS_AVATAR_SCALE)) {
+        setTargetScale(decoded.scale);
+        _avatarScaleRate.increment(AvatarDataPacket::AVATAR_SCALE_SIZE);
+        _avatarScaleUpdateRate.increment();
+    }
+
+    if (HAS_FLAG(hasFlags, AvatarDataPacket::PACKET_HAS_LOOK_AT_POSITION)) {
+        _headData->setLookAtPosition(decoded.lookAtPosition);
+        _lookAtPositionRate.increment(AvatarDataPacket::LOOK_AT_POSITION_SIZE);
+        _lookAtPositionUpdateRate.increment();
+    }
+
+    if (HAS_FLAG(hasFlags, AvatarDataPacket::PACKET_HAS_AUDIO_LOUDNESS)) {
+        _headData->setAudioLoudness(decoded.audioLoudness);
+        _audioLoudnessRate.increment(AvatarDataPacket::AUDIO_LOUDNESS_SIZE);
+        _audioLoudnessUpdateRate.increment();
+    }
+
+    if (HAS_FLAG(hasFlags, AvatarDataPacket::PACKET_HAS_SENSOR_TO_WORLD_MATRIX)) {
+        if (_sensorToWorldMatrixCache.get() != decoded.sensorToWorldMatrix) {
+            _sensorToWorldMatrixCache.set(decoded.sensorToWorldMatrix);
+            _sensorToWorldMatrixChanged = now;
+        }
+        _sensorToWorldRate.increment(AvatarDataPacket::SENSOR_TO_WORLD_SIZE);
+        _sensorToWorldUpdateRate.increment();
+    }
+
+    if (HAS_FLAG(hasFlags, AvatarDataPacket::PACKET_HAS_ADDITIONAL_FLAGS)) {
+        bool keyStateChanged = (_keyState != decoded.keyState);
+        bool handStateChanged = (_handState != decoded.handState);
+        bool faceStateChanged = (_headData->_isFaceTrackerConnected != decoded.isFaceTrackerConnected);
+        bool eyeStateChanged = (_headData->_isEyeTrackerConnected != decoded.isEyeTrackerConnected);
+        bool somethingChanged = keyStateChanged || handStateChanged || faceStateChanged || eyeStateChanged;
+
+        _keyState = decoded.keyState;
+        _handState = decoded.handState;
+        _headData->_isFaceTrackerConnected = decoded.isFaceTrackerConnected;
+        _headData->_isEyeTrackerConnected = decoded.isEyeTrackerConnected;
+
+        if (somethingChanged) {
+            _additionalFlagsChanged = now;
+        }
+        _additionalFlagsRate.increment(AvatarDataPacket::ADDITIONAL_FLAGS_SIZE);
+        _additionalFlagsUpdateRate.increment();
+    }
+
+    if (HAS_FLAG(hasFlags, AvatarDataPacket::PACKET_HAS_PARENT_INFO)) {
+        if ((getParentID() != decoded.parentID) || (getParentJointIndex() != decoded.parentJointIndex)) {
+            SpatiallyNestable::setParentID(decoded.parentID);
+            SpatiallyNestable::setParentJointIndex(decoded.parentJointIndex);
+            _parentChanged = now;
+        }
+        _parentInfoRate.increment(AvatarDataPacket::PARENT_INFO_SIZE);
+        _parentInfoUpdateRate.increment();
+    }
+
+    if (HAS_FLAG(hasFlags, AvatarDataPacket::PACKET_HAS_AVATAR_LOCAL_POSITION)) {
+        if (hasParent()) {
+            setLocalPosition(decoded.localPosition);
+        } else {
+            qCWarning(avatars) << "received localPosition for avatar with no parent";
+        }
+        _localPositionRate.increment(AvatarDataPacket::AVATAR_LOCAL_POSITION_SIZE);
+        _localPositionUpdateRate.increment();
+    }
 
-        int numBytesRead = sourceBuffer - startSection;
-        _jointDataRate.increment(numBytesRead);
+    if (HAS_FLAG(hasFlags, AvatarDataPacket::PACKET_HAS_FACE_TRACKER_INFO)) {
+        _headData->_leftEyeBlink = decoded.leftEyeBlink;
+        _headData->_rightEyeBlink = decoded.rightEyeBlink;
+        _headData->_averageLoudness = decoded.averageLoudness;
+        _headData->_browAudioLift = decoded.browAudioLift;
+        _headData->_blendshapeCoefficients.resize(decoded.blendshapeCoefficients.size());
+        std::copy(decoded.blendshapeCoefficients.cbegin(), decoded.blendshapeCoefficients.cend(),
+            _headData->_blendshapeCoefficients.begin());
+        _faceTrackerRate.increment(decoded.faceTrackerBytes);
+        _faceTrackerUpdateRate.increment();
+    }
+
+    if (HAS_FLAG(hasFlags, AvatarDataPacket::PACKET_HAS_JOINT_DATA)) {
+        QWriteLocker writeLock(&_jointDataLock);
+        int numJoints = decoded.jointData.size();
+        _jointData.resize(numJoints);
+        for (int i = 0; i < numJoints; i++) {
+            const JointData& source = decoded.jointData[i];
+            JointData& data = _jointData[i];
+            if (source.rotationSet) {
+                data.rotation = source.rotation;
+                data.rotationSet = true;
+                _hasNewJointData = true;
+            }
+            if (source.translationSet) {
+                data.translation = source.translation;
+                data.translationSet = true;
+                _hasNewJointData = true;
+            }
+        }
+        _jointDataRate.increment(decoded.jointDataBytes);
         _jointDataUpdateRate.increment();
     }
 
-    int numBytesRead = sourceBuffer - startPosition;
-    _averageBytesReceived.updateAverage(numBytesRead);
+    if (HAS_FLAG(hasFlags, AvatarDataPacket::PACKET_HAS_FAUX_JOINT_DATA)) {
+        _controllerLeftHandMatrixCache.set(decoded.controllerLeftHandMatrix);
+        _controllerRightHandMatrixCache.set(decoded.controllerRightHandMatrix);
+        _jointDataRate.increment(AvatarDataPacket::FAUX_JOINT_DATA_SIZE);
+    }
+
+    if (!decoded.error.isEmpty()) {
+        if (shouldLogError(now)) {
+            qCWarning(avatars) << decoded.error << ", uuid " << getSessionUUID();
+        }
+        return;
+    }
+
+    _averageBytesReceived.updateAverage(decoded.size);
 
-    _parseBufferRate.increment(numBytesRead);
+    _parseBufferRate.increment(decoded.size);
     _parseBufferUpdateRate.increment();
+}
+
+// decoding scratch for parseDataFromBuffer, one per parsing thread rather than one per avatar
+static QThreadStorage<DecodedAvatarData*> parseScratch;
 
-    return numBytesRead;
+// read data in packet starting at byte offset and return number of bytes parsed
+int AvatarData::parseDataFromBuffer(const QByteArray& buffer) {
+    if (!parseScratch.hasLocalData()) {
+        parseScratch.setLocalData(new DecodedAvatarData());
+    }
+    DecodedAvatarData& decoded = *parseScratch.localData();
+    decodeDataFromBuffer(buffer, decoded, _ignoredDataSections);
+    applyDecodedData(decoded);
+    return decoded.size;
+}
+
+int AvatarData::getAvatarDataSize(const QByteArray& buffer) {
+    AvatarDataPacket::AvatarDataSize avatarDataSize = 0;
+    if (buffer.size() < (int)sizeof(avatarDataSize)) {
+        return buffer.size();
+    }
+    memcpy(&avatarDataSize, buffer.data(), sizeof(avatarDataSize));
+    return std::min((int)avatarDataSize, buffer.size());
 }
 
 float AvatarData::getDataRate(const QString& rateName) const {
@@ -1647,6 +1827,10 @@ void AvatarData::sendAvatarDataPacket() {
     auto dataDetail = cullSmallData ? SendAllData : CullSmallData;
     QByteArray avatarByteArray = toByteArrayStateful(dataDetail);
     doneEncoding(cullSmallData);
+    if (avatarByteArray.isEmpty()) {
+        // not even the minimum fits, the mixer would drop an empty one
+        return;
+    }
 
     static AvatarDataSequenceNumber sequenceNumber = 0;
 
@@ -137,10 +137,21 @@ namespace AvatarDataPacket {
     const HasFlags PACKET_HAS_AVATAR_LOCAL_POSITION  = 1U << 9;
     const HasFlags PACKET_HAS_FACE_TRACKER_INFO      = 1U << 10;
     const HasFlags PACKET_HAS_JOINT_DATA             = 1U << 11;
+    const HasFlags PACKET_HAS_FAUX_JOINT_DATA        = 1U << 12;
     const size_t AVATAR_HAS_FLAGS_SIZE = 2;
 
     // NOTE: AvatarDataPackets start with a uint16_t sequence number that is not reflected in the Header structure.
 
+    // Each avatar's data leads with its size in bytes, this size included, so a receiver can skip an avatar
+    // without parsing it, and skip any trailing sections newer than it knows about.
+    using AvatarDataSize = uint16_t;
+    const size_t AVATAR_DATA_SIZE_SIZE = 2;
+
+    // The variable length sections - face tracker info and joint data - lead with their size the same way,
+    // so a receiver can skip the sections it has no use for.
+    using SectionSize = uint16_t;
+    const size_t SECTION_SIZE_SIZE = 2;
+
     PACKED_BEGIN struct Header {
         HasFlags packetHasFlags;        // state flags, indicated which additional records are included in the packet
     } PACKED_END;
@@ -218,7 +229,7 @@ namespace AvatarDataPacket {
     } PACKED_END;
     const size_t AVATAR_LOCAL_POSITION_SIZE = 12;
 
-    // only present if IS_FACESHIFT_CONNECTED flag is set in AvatarInfo.flags
+    // only present if IS_FACESHIFT_CONNECTED flag is set in AvatarInfo.flags, after its SectionSize
     PACKED_BEGIN struct FaceTrackerInfo {
         float leftEyeBlink;
         float rightEyeBlink;
@@ -232,6 +243,7 @@ namespace AvatarDataPacket {
     // variable length structure follows
     /*
     struct JointData {
+        SectionSize sectionSize;
         uint8_t numJoints;
         uint8_t rotationValidityBits[ceil(numJoints / 8)];     // one bit per joint, if true then a compressed rotation follows.
         SixByteQuat rotation[numValidRotations];               // encodeded and compressed by packOrientationQuatToSixBytes()
@@ -239,6 +251,15 @@ namespace AvatarDataPacket {
         SixByteTrans translation[numValidTranslations];        // encodeded and compressed by packFloatVec3ToSignedTwoByteFixed()
     };
     */
+
+    // the left and right hand controllers, that far grab follows, each a SixByteQuat rotation and a SixByteTrans
+    // translation
+    const size_t FAUX_JOINT_DATA_SIZE = 24;
+
+    // the most every fixed size section could take together
+    const size_t MAX_FIXED_SECTIONS_SIZE = AVATAR_GLOBAL_POSITION_SIZE + AVATAR_BOUNDING_BOX_SIZE + AVATAR_ORIENTATION_SIZE +
+        AVATAR_SCALE_SIZE + LOOK_AT_POSITION_SIZE + AUDIO_LOUDNESS_SIZE + SENSOR_TO_WORLD_SIZE + ADDITIONAL_FLAGS_SIZE +
+        PARENT_INFO_SIZE + AVATAR_LOCAL_POSITION_SIZE;
 }
 
 static const float MAX_AVATAR_SCALE = 1000.0f;
@@ -309,6 +330,46 @@ public:
     RateCounter<> jointDataRate;
 };
 
+// One avatar's data, decoded from the wire without touching the avatar, so it can be decoded on any thread and
+// applied on the avatar's. Only the sections in hasFlags were decoded; for joints, rotationSet and translationSet
+// say which were sent.
+class DecodedAvatarData {
+public:
+    AvatarDataPacket::HasFlags hasFlags { 0 };
+    int size { 0 }; // bytes of the buffer the avatar's data took
+    QString error; // why decoding stopped early, if it did
+
+    glm::vec3 globalPosition;
+    glm::vec3 boundingBoxDimensions;
+    glm::vec3 boundingBoxOffset;
+    glm::quat orientation;
+    float scale { 1.0f };
+    glm::vec3 lookAtPosition;
+    float audioLoudness { 0.0f };
+    glm::mat4 sensorToWorldMatrix;
+    KeyState keyState { NO_KEY_DOWN };
+    char handState { 0 };
+    bool isFaceTrackerConnected { false };
+    bool isEyeTrackerConnected { false };
+    QUuid parentID;
+    quint16 parentJointIndex { 0 };
+    glm::vec3 localPosition;
+
+    float leftEyeBlink { 0.0f };
+    float rightEyeBlink { 0.0f };
+    float averageLoudness { 0.0f };
+    float browAudioLift { 0.0f };
+    QVector<float> blendshapeCoefficients;
+    int faceTrackerBytes { 0 };
+
+    QVector<JointData> jointData;
+    int jointDataBytes { 0 };
+
+    glm::mat4 controllerLeftHandMatrix;
+    glm::mat4 controllerRightHandMatrix;
+};
+using DecodedAvatarDataPointer = std::shared_ptr<DecodedAvatarData>;
+
 class AvatarPriority {
 public:
     AvatarPriority(AvatarSharedPointer a, float p) : avatar(a), priority(p) {}
@@ -384,10 +445,18 @@ public:
 
     virtual QByteArray toByteArrayStateful(AvatarDataDetail dataDetail);
 
-    virtual QByteArray toByteArray(AvatarDataDetail dataDetail, quint64 lastSentTime, const QVector<JointData>& lastSentJointData,
+    QByteArray toByteArray(AvatarDataDetail dataDetail, quint64 lastSentTime, const QVector<JointData>& lastSentJointData,
         AvatarDataPacket::HasFlags& hasFlagsOut, bool dropFaceTracking, bool distanceAdjust, glm::vec3 viewerPosition, 
         QVector<JointData>* sentJointDataOut, AvatarDataRate* outboundDataRateOut = nullptr) const;
 
+    /// like toByteArray, but writes into a buffer the caller owns and can reuse
+    /// \param capacity number of bytes destinationBuffer has room for
+    /// \return number of bytes written, or -1 if the data didn't fit
+    virtual int toBuffer(unsigned char* destinationBuffer, int capacity, AvatarDataDetail dataDetail, quint64 lastSentTime,
+        const QVector<JointData>& lastSentJointData, AvatarDataPacket::HasFlags& hasFlagsOut, bool dropFaceTracking,
+        bool distanceAdjust, glm::vec3 viewerPosition, QVector<JointData>* sentJointDataOut,
+        AvatarDataRate* outboundDataRateOut = nullptr) const;
+
     virtual void doneEncoding(bool cullSmallChanges);
 
     /// \return true if an error should be logged
@@ -398,6 +467,24 @@ public:
     /// \return number of bytes parsed
     virtual int parseDataFromBuffer(const QByteArray& buffer);
 
+    /// decodes without touching any avatar, so is safe on any thread; parseDataFromBuffer is this then applyDecodedData
+    /// \param ignoredSections sections to skip rather than decode, see setIgnoredDataSections
+    /// \return number of bytes decoded
+    static int decodeDataFromBuffer(const QByteArray& buffer, DecodedAvatarData& decoded,
+                                    AvatarDataPacket::HasFlags ignoredSections = 0);
+
+    /// applies data decodeDataFromBuffer decoded for this avatar, on the avatar's thread
+    virtual void applyDecodedData(const DecodedAvatarData& decoded);
+
+    /// \param buffer byte array starting at an avatar's data
+    /// \return number of bytes of it the avatar's data takes, without parsing it
+    static int getAvatarDataSize(const QByteArray& buffer);
+
+    /// sections parseDataFromBuffer skips rather than parses, of PACKET_HAS_FACE_TRACKER_INFO, PACKET_HAS_JOINT_DATA
+    /// and PACKET_HAS_FAUX_JOINT_DATA
+    void setIgnoredDataSections(AvatarDataPacket::HasFlags sections) { _ignoredDataSections = sections; }
+    AvatarDataPacket::HasFlags getIgnoredDataSections() const { return _ignoredDataSections; }
+
     // Body Rotation (degrees)
     float getBodyYaw() const;
     void setBodyYaw(float bodyYaw);
@@ -713,6 +800,9 @@ protected:
     quint64 _parentChanged { 0 };
 
     quint64  _lastToByteArray { 0 }; // tracks the last time we did a toByteArray
+    AvatarDataDetail _lastEncodedDataDetail { SendAllData }; // less than was asked for when that didn't fit
+
+    AvatarDataPacket::HasFlags _ignoredDataSections { 0 };
 
     // Some rate data for incoming data in bytes
     RateCounter<> _parseBufferRate;
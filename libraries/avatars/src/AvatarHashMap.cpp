@@ -25,6 +25,60 @@ AvatarHashMap::AvatarHashMap() {
     connect(nodeList.data(), &NodeList::uuidChanged, this, &AvatarHashMap::sessionUUIDChanged);
 }
 
+AvatarHashMap::~AvatarHashMap() {
+    if (_packetDecoder) {
+        _packetDecoder->terminate();
+    }
+}
+
+void AvatarHashMap::startDecodingThread(bool isThreaded) {
+    if (_packetDecoder) {
+        return;
+    }
+
+    auto nodeList = DependencyManager::get<NodeList>();
+
+    _packetDecoder.reset(new AvatarPacketDecoder());
+    _packetDecoder->setIgnoredDataSections(_ignoredDataSections);
+    // the decoder's thread has no event loop, and nodeKilled locks what it touches
+    connect(nodeList.data(), &NodeList::nodeKilled, _packetDecoder.get(), &ReceivedPacketProcessor::nodeKilled,
+            Qt::DirectConnection);
+    _packetDecoder->initialize(isThreaded);
+}
+
+void AvatarHashMap::applyDecodedAvatarData() {
+    if (!_packetDecoder) {
+        return;
+    }
+
+    PERFORMANCE_TIMER("receiveAvatar");
+    _packetDecoder->takeUpdates(_decodedUpdates);
+
+    auto nodeList = DependencyManager::get<NodeList>();
+    for (auto& update : _decodedUpdates) {
+        if (!update.data) {
+            removeAvatar(update.sessionUUID, update.killReason);
+            continue;
+        }
+
+        // make sure this isn't our own avatar data or for a node ignored since it was decoded
+        if (update.sessionUUID != _lastOwnerSessionUUID &&
+            (!nodeList->isIgnoringNode(update.sessionUUID) || nodeList->getRequestsDomainListData())) {
+            auto avatar = newOrExistingAvatar(update.sessionUUID, update.mixer);
+            avatar->applyDecodedData(*update.data);
+        }
+    }
+
+    _packetDecoder->recycle(_decodedUpdates);
+}
+
+void AvatarHashMap::discardDecodedAvatarData() {
+    if (_packetDecoder) {
+        _packetDecoder->takeUpdates(_decodedUpdates);
+        _packetDecoder->recycle(_decodedUpdates);
+    }
+}
+
 QVector<QUuid> AvatarHashMap::getAvatarIdentifiers() {
     QReadLocker locker(&_hashLock);
     return _avatarHash.keys().toVector();
@@ -61,6 +115,17 @@ int AvatarHashMap::numberOfAvatarsInRange(const glm::vec3& position, float range
     return count;
 }
 
+void AvatarHashMap::setIgnoredDataSections(AvatarDataPacket::HasFlags sections) {
+    QWriteLocker locker(&_hashLock);
+    _ignoredDataSections = sections;
+    if (_packetDecoder) {
+        _packetDecoder->setIgnoredDataSections(sections);
+    }
+    for (auto& avatar : _avatarHash) {
+        avatar->setIgnoredDataSections(sections);
+    }
+}
+
 AvatarSharedPointer AvatarHashMap::newSharedAvatar() {
     return std::make_shared<AvatarData>();
 }
@@ -71,6 +136,7 @@ AvatarSharedPointer AvatarHashMap::addAvatar(const QUuid& sessionUUID, const QWe
     auto avatar = newSharedAvatar();
     avatar->setSessionUUID(sessionUUID);
     avatar->setOwningAvatarMixer(mixerWeakPointer);
+    avatar->setIgnoredDataSections(_ignoredDataSections);
 
     _avatarHash.insert(sessionUUID, avatar);
     emit avatarAddedEvent(sessionUUID);
@@ -99,7 +165,7 @@ AvatarSharedPointer AvatarHashMap::findAvatar(const QUuid& sessionUUID) const {
 }
 
 void AvatarHashMap::processAvatarDataPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer sendingNode) {
-    PerformanceTimer perfTimer("receiveAvatar");
+    PERFORMANCE_TIMER("receiveAvatar");
     // enumerate over all of the avatars in this packet
     // only add them if mixerWeakPointer points to something (meaning that mixer is still around)
     while (message->getBytesLeftToRead()) {
@@ -119,10 +185,8 @@ void AvatarHashMap::processAvatarDataPacket(QSharedPointer<ReceivedMessage> mess
             int bytesRead = avatar->parseDataFromBuffer(byteArray);
             message->seek(positionBeforeRead + bytesRead);
         } else {
-            // create a dummy AvatarData class to throw this data on the ground
-            AvatarData dummyData;
-            int bytesRead = dummyData.parseDataFromBuffer(byteArray);
-            message->seek(positionBeforeRead + bytesRead);
+            // throw this data on the ground, its size says how much to skip
+            message->seek(positionBeforeRead + AvatarData::getAvatarDataSize(byteArray));
         }
     }
 }
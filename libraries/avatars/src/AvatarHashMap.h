@@ -26,6 +26,7 @@
 #include <Node.h>
 
 #include "AvatarData.h"
+#include "AvatarPacketDecoder.h"
 
 class AvatarHashMap : public QObject, public Dependency {
     Q_OBJECT
@@ -42,6 +43,14 @@ public:
     virtual AvatarSharedPointer getAvatarBySessionID(const QUuid& sessionID) const { return findAvatar(sessionID); }
     int numberOfAvatarsInRange(const glm::vec3& position, float rangeMeters);
 
+    // the sections of other avatars' data this map's avatars skip rather than parse, see AvatarData
+    void setIgnoredDataSections(AvatarDataPacket::HasFlags sections);
+
+    // Decode BulkAvatarData and KillAvatar packets on their own thread, instead of in processAvatarDataPacket and
+    // processKillAvatar. The owner applies what was decoded by calling applyDecodedAvatarData() on this thread.
+    // If isThreaded is false, the decoder's threadRoutine() must be called to decode what it has received.
+    void startDecodingThread(bool isThreaded = true);
+
 signals:
     void avatarAddedEvent(const QUuid& sessionUUID);
     void avatarRemovedEvent(const QUuid& sessionUUID);
@@ -60,6 +69,13 @@ private slots:
 
 protected:
     AvatarHashMap();
+    virtual ~AvatarHashMap();
+
+    // applies the updates and kills decoded since the last call, in the order they arrived
+    void applyDecodedAvatarData();
+    // drops them instead, for when the avatars they are for have gone
+    void discardDecodedAvatarData();
+    AvatarPacketDecoder* getPacketDecoder() const { return _packetDecoder.get(); }
 
     virtual AvatarSharedPointer newSharedAvatar();
     virtual AvatarSharedPointer addAvatar(const QUuid& sessionUUID, const QWeakPointer<Node>& mixerWeakPointer);
@@ -76,6 +92,10 @@ protected:
 
 private:
     QUuid _lastOwnerSessionUUID;
+    AvatarDataPacket::HasFlags _ignoredDataSections { 0 };
+
+    std::unique_ptr<AvatarPacketDecoder> _packetDecoder;
+    AvatarPacketDecoder::Updates _decodedUpdates; // kept to reuse its storage
 };
 
 #endif // hifi_AvatarHashMap_h
@@ -0,0 +1,100 @@
+//
+//  AvatarPacketDecoder.cpp
+//  libraries/avatars/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <NodeList.h>
+#include <PerfStat.h>
+#include <udt/PacketHeaders.h>
+
+#include "AvatarPacketDecoder.h"
+
+AvatarPacketDecoder::AvatarPacketDecoder() {
+    auto& packetReceiver = DependencyManager::get<NodeList>()->getPacketReceiver();
+
+    packetReceiver.registerDirectListenerForTypes({ PacketType::BulkAvatarData, PacketType::KillAvatar },
+                                                  this, "handleAvatarPacket");
+}
+
+void AvatarPacketDecoder::handleAvatarPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer sendingNode) {
+    queueReceivedPacket(message, sendingNode);
+}
+
+void AvatarPacketDecoder::processPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer sendingNode) {
+    Updates updates;
+
+    if (message->getType() == PacketType::BulkAvatarData) {
+        processAvatarDataPacket(*message, sendingNode, updates);
+    } else {
+        Update kill;
+        kill.sessionUUID = QUuid::fromRfc4122(message->readWithoutCopy(NUM_BYTES_RFC4122_UUID));
+        message->readPrimitive(&kill.killReason);
+        updates.push_back(kill);
+    }
+
+    std::lock_guard<std::mutex> lock(_updatesMutex);
+    _updates.insert(_updates.end(), std::make_move_iterator(updates.begin()), std::make_move_iterator(updates.end()));
+}
+
+void AvatarPacketDecoder::processAvatarDataPacket(ReceivedMessage& message, const SharedNodePointer& sendingNode,
+                                                  Updates& updates) {
+    PERFORMANCE_TIMER("decodeAvatar");
+    auto nodeList = DependencyManager::get<NodeList>();
+    auto ignoredDataSections = _ignoredDataSections.load();
+
+    while (message.getBytesLeftToRead()) {
+        QUuid sessionUUID = QUuid::fromRfc4122(message.readWithoutCopy(NUM_BYTES_RFC4122_UUID));
+
+        int positionBeforeRead = message.getPosition();
+
+        QByteArray byteArray = message.readWithoutCopy(message.getBytesLeftToRead());
+
+        if (nodeList->isIgnoringNode(sessionUUID) && !nodeList->getRequestsDomainListData()) {
+            // throw this data on the ground, its size says how much to skip
+            message.seek(positionBeforeRead + AvatarData::getAvatarDataSize(byteArray));
+            continue;
+        }
+
+        Update update;
+        update.sessionUUID = sessionUUID;
+        update.mixer = sendingNode;
+        update.data = takeFreeData();
+
+        int bytesRead = AvatarData::decodeDataFromBuffer(byteArray, *update.data, ignoredDataSections);
+        message.seek(positionBeforeRead + bytesRead);
+
+        updates.push_back(std::move(update));
+    }
+}
+
+DecodedAvatarDataPointer AvatarPacketDecoder::takeFreeData() {
+    {
+        std::lock_guard<std::mutex> lock(_updatesMutex);
+        if (!_freeData.empty()) {
+            auto data = std::move(_freeData.back());
+            _freeData.pop_back();
+            return data;
+        }
+    }
+    return std::make_shared<DecodedAvatarData>();
+}
+
+void AvatarPacketDecoder::takeUpdates(Updates& updates) {
+    std::lock_guard<std::mutex> lock(_updatesMutex);
+    updates.swap(_updates);
+}
+
+void AvatarPacketDecoder::recycle(Updates& updates) {
+    std::lock_guard<std::mutex> lock(_updatesMutex);
+    for (auto& update : updates) {
+        if (update.data) {
+            _freeData.push_back(std::move(update.data));
+        }
+    }
+    updates.clear();
+}
@@ -0,0 +1,65 @@
+//
+//  AvatarPacketDecoder.h
+//  libraries/avatars/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AvatarPacketDecoder_h
+#define hifi_AvatarPacketDecoder_h
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+#include <ReceivedPacketProcessor.h>
+#include <ReceivedMessage.h>
+
+#include "AvatarData.h"
+
+/// Decodes BulkAvatarData packets off the main thread. Each avatar in a packet is decoded into a DecodedAvatarData,
+/// and the owner takes the decoded updates, in the order they arrived, to apply to its avatars with
+/// AvatarData::applyDecodedData(). KillAvatar packets are queued with them, so an avatar killed after an update
+/// is never brought back by it.
+class AvatarPacketDecoder : public ReceivedPacketProcessor {
+    Q_OBJECT
+public:
+    struct Update {
+        QUuid sessionUUID;
+        QWeakPointer<Node> mixer;
+        DecodedAvatarDataPointer data; // null if the avatar was killed
+        KillAvatarReason killReason { KillAvatarReason::NoReason };
+    };
+    using Updates = std::vector<Update>;
+
+    AvatarPacketDecoder();
+
+    void setIgnoredDataSections(AvatarDataPacket::HasFlags sections) { _ignoredDataSections.store(sections); }
+
+    /// Swaps the updates decoded since the last call into updates, which should be empty.
+    void takeUpdates(Updates& updates);
+
+    /// Hands the decoded data in updates back to be reused, and clears it.
+    void recycle(Updates& updates);
+
+protected:
+    virtual void processPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer sendingNode) override;
+
+private slots:
+    void handleAvatarPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer sendingNode);
+
+private:
+    void processAvatarDataPacket(ReceivedMessage& message, const SharedNodePointer& sendingNode, Updates& updates);
+    DecodedAvatarDataPointer takeFreeData();
+
+    std::atomic<AvatarDataPacket::HasFlags> _ignoredDataSections { 0 };
+
+    std::mutex _updatesMutex;
+    Updates _updates;
+    std::vector<DecodedAvatarDataPointer> _freeData;
+};
+
+#endif // hifi_AvatarPacketDecoder_h
@@ -23,12 +23,14 @@
 const int SOCKET_ERROR_EXIT_CODE = 2;
 const int SOCKET_CHECK_INTERVAL_IN_MS = 30000;
 
-HTTPManager::HTTPManager(const QHostAddress& listenAddress, quint16 port, const QString& documentRoot, HTTPRequestHandler* requestHandler, QObject* parent) :
+HTTPManager::HTTPManager(const QHostAddress& listenAddress, quint16 port, const QString& documentRoot, HTTPRequestHandler* requestHandler,
+                         QObject* parent, bool exitOnBindFailure) :
     QTcpServer(parent),
     _listenAddress(listenAddress),
     _documentRoot(documentRoot),
     _requestHandler(requestHandler),
-    _port(port)
+    _port(port),
+    _exitOnBindFailure(exitOnBindFailure)
 {
     bindSocket();
     
@@ -183,6 +185,11 @@ bool HTTPManager::bindSocket() {
         qCDebug(embeddedwebserver) << "TCP socket is listening on" << serverAddress() << "and port" << serverPort();
         
         return true;
+    } else if (!_exitOnBindFailure) {
+        // isTcpServerListening() tries again
+        qCWarning(embeddedwebserver) << "Failed to open HTTP server socket on port" << _port << ":" << errorString()
+            << ", retrying in" << SOCKET_CHECK_INTERVAL_IN_MS << "ms";
+        return false;
     } else {
         QString errorMessage = "Failed to open HTTP server socket: " + errorString() + ", can't continue";
         QMetaObject::invokeMethod(this, "queuedExit", Qt::QueuedConnection, Q_ARG(QString, errorMessage));
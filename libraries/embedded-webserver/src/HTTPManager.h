@@ -33,7 +33,10 @@ class HTTPManager : public QTcpServer, public HTTPRequestHandler {
    Q_OBJECT
 public:
     /// Initializes the manager.
-    HTTPManager(const QHostAddress& listenAddress, quint16 port, const QString& documentRoot, HTTPRequestHandler* requestHandler = NULL, QObject* parent = 0);
+    /// If the port can't be bound, the application exits, unless exitOnBindFailure is false: then the failure
+    /// is logged and the bind retried periodically, check isListening() to know whether it is serving.
+    HTTPManager(const QHostAddress& listenAddress, quint16 port, const QString& documentRoot, HTTPRequestHandler* requestHandler = NULL,
+                QObject* parent = 0, bool exitOnBindFailure = true);
     
     bool handleHTTPRequest(HTTPConnection* connection, const QUrl& url, bool skipSubHandler = false) override;
 
@@ -54,6 +57,7 @@ protected:
     HTTPRequestHandler* _requestHandler;
     QTimer* _isListeningTimer;
     const quint16 _port;
+    const bool _exitOnBindFailure;
 };
 
 #endif // hifi_HTTPManager_h
@@ -189,7 +189,7 @@ void RenderablePolyLineEntityItem::render(RenderArgs* args) {
         _texturesChangedFlag = false;
     }
 
-    PerformanceTimer perfTimer("RenderablePolyLineEntityItem::render");
+    PERFORMANCE_TIMER("RenderablePolyLineEntityItem::render");
     Q_ASSERT(getType() == EntityTypes::PolyLine);
     Q_ASSERT(args->_batch);
 
@@ -552,7 +552,7 @@ void RenderablePolyVoxEntityItem::setZTextureURL(QString zTextureURL) {
 }
 
 void RenderablePolyVoxEntityItem::render(RenderArgs* args) {
-    PerformanceTimer perfTimer("RenderablePolyVoxEntityItem::render");
+    PERFORMANCE_TIMER("RenderablePolyVoxEntityItem::render");
     assert(getType() == EntityTypes::PolyVox);
     Q_ASSERT(args->_batch);
 
@@ -82,7 +82,7 @@ bool RenderableShapeEntityItem::isTransparent() {
 }
 
 void RenderableShapeEntityItem::render(RenderArgs* args) {
-    PerformanceTimer perfTimer("RenderableShapeEntityItem::render");
+    PERFORMANCE_TIMER("RenderableShapeEntityItem::render");
     //Q_ASSERT(getType() == EntityTypes::Shape);
     Q_ASSERT(args->_batch);
     checkFading();
@@ -223,7 +223,7 @@ void RenderableWebEntityItem::render(RenderArgs* args) {
         _texture->setExternalTexture(newTextureAndFence.first, newTextureAndFence.second);
     }
 
-    PerformanceTimer perfTimer("RenderableWebEntityItem::render");
+    PERFORMANCE_TIMER("RenderableWebEntityItem::render");
     Q_ASSERT(getType() == EntityTypes::Web);
     static const glm::vec2 texMin(0.0f), texMax(1.0f), topLeft(-0.5f), bottomRight(0.5f);
 
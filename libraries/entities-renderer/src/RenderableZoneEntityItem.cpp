@@ -112,7 +112,7 @@ void RenderableZoneEntityItem::render(RenderArgs* args) {
     if (_drawZoneBoundaries) {
         switch (getShapeType()) {
             case SHAPE_TYPE_COMPOUND: {
-                PerformanceTimer perfTimer("zone->renderCompound");
+                PERFORMANCE_TIMER("zone->renderCompound");
                 updateGeometry();
                 if (_model && _model->needsFixupInScene()) {
                     // check to see if when we added our models to the scene they were ready, if they were not ready, then
@@ -132,7 +132,7 @@ void RenderableZoneEntityItem::render(RenderArgs* args) {
             }
             case SHAPE_TYPE_BOX:
             case SHAPE_TYPE_SPHERE: {
-                PerformanceTimer perfTimer("zone->renderPrimitive");
+                PERFORMANCE_TIMER("zone->renderPrimitive");
                 glm::vec4 DEFAULT_COLOR(1.0f, 1.0f, 1.0f, 1.0f);
                 
                 Q_ASSERT(args->_batch);
@@ -35,7 +35,7 @@ void EntitySimulation::updateEntities() {
     callUpdateOnEntitiesThatNeedIt(now);
     moveSimpleKinematics(now);
     updateEntitiesInternal(now);
-    PerformanceTimer perfTimer("sortingEntities");
+    PERFORMANCE_TIMER("sortingEntities");
     sortEntitiesThatMoved();
 }
 
@@ -121,7 +121,7 @@ void EntitySimulation::expireMortalEntities(const quint64& now) {
 
 // protected
 void EntitySimulation::callUpdateOnEntitiesThatNeedIt(const quint64& now) {
-    PerformanceTimer perfTimer("updatingEntities");
+    PERFORMANCE_TIMER("updatingEntities");
     QMutexLocker lock(&_mutex);
     SetOfEntities::iterator itemItr = _entitiesToUpdate.begin();
     while (itemItr != _entitiesToUpdate.end()) {
@@ -160,7 +160,7 @@ void EntitySimulation::sortEntitiesThatMoved() {
         }
     }
     if (moveOperator.hasMovingEntities()) {
-        PerformanceTimer perfTimer("recurseTreeWithOperator");
+        PERFORMANCE_TIMER("recurseTreeWithOperator");
         _entityTree->recurseTreeWithOperator(&moveOperator);
     }
 
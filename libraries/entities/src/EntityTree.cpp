@@ -1252,7 +1252,7 @@ void EntityTree::fixupMissingParents() {
     }
 
     if (moveOperator.hasMovingEntities()) {
-        PerformanceTimer perfTimer("recurseTreeWithOperator");
+        PERFORMANCE_TIMER("recurseTreeWithOperator");
         recurseTreeWithOperator(&moveOperator);
     }
 }
@@ -130,6 +130,49 @@ QString FBXGeometry::getModelNameOfMesh(int meshIndex) const {
     return QString();
 }
 
+void FBXGeometry::buildMeshTriangleSets() {
+    const int INDICES_PER_TRIANGLE = 3;
+    const int INDICES_PER_QUAD = 4;
+
+    meshTriangleSets.clear();
+    meshTriangleSets.resize(meshes.size());
+    for (int i = 0; i < meshes.size(); i++) {
+        const FBXMesh& mesh = meshes.at(i);
+        TriangleSet& triangleSet = meshTriangleSets[i];
+
+        QVector<glm::vec3> vertices;
+        vertices.reserve(mesh.vertices.size());
+        for (const glm::vec3& vertex : mesh.vertices) {
+            vertices.push_back(glm::vec3(mesh.modelTransform * glm::vec4(vertex, 1.0f)));
+        }
+
+        for (const FBXMeshPart& part : mesh.parts) {
+            int numberOfQuads = part.quadIndices.size() / INDICES_PER_QUAD;
+            int vIndex = 0;
+            for (int q = 0; q < numberOfQuads; q++) {
+                const glm::vec3& v0 = vertices[part.quadIndices[vIndex++]];
+                const glm::vec3& v1 = vertices[part.quadIndices[vIndex++]];
+                const glm::vec3& v2 = vertices[part.quadIndices[vIndex++]];
+                const glm::vec3& v3 = vertices[part.quadIndices[vIndex++]];
+
+                // Sam's recommended triangle slices
+                triangleSet.insert({ v0, v1, v3 });
+                triangleSet.insert({ v1, v2, v3 });
+            }
+
+            int numberOfTris = part.triangleIndices.size() / INDICES_PER_TRIANGLE;
+            vIndex = 0;
+            for (int t = 0; t < numberOfTris; t++) {
+                const glm::vec3& v0 = vertices[part.triangleIndices[vIndex++]];
+                const glm::vec3& v1 = vertices[part.triangleIndices[vIndex++]];
+                const glm::vec3& v2 = vertices[part.triangleIndices[vIndex++]];
+                triangleSet.insert({ v0, v1, v2 });
+            }
+        }
+        triangleSet.build();
+    }
+}
+
 int fbxGeometryMetaTypeId = qRegisterMetaType<FBXGeometry>();
 int fbxAnimationFrameMetaTypeId = qRegisterMetaType<FBXAnimationFrame>();
 int fbxAnimationFrameVectorMetaTypeId = qRegisterMetaType<QVector<FBXAnimationFrame> >();
@@ -24,6 +24,7 @@
 
 #include <Extents.h>
 #include <Transform.h>
+#include <TriangleSet.h>
 
 #include <model/Geometry.h>
 #include <model/Material.h>
@@ -345,6 +346,12 @@ public:
     QString getModelNameOfMesh(int meshIndex) const;
     
     QList<QString> blendshapeChannelNames;
+
+    /// the triangles of each mesh in model space, before the offset, for picking against
+    QVector<TriangleSet> meshTriangleSets;
+
+    /// Fills meshTriangleSets. The model cache does this as it loads a geometry, so every model using it shares them.
+    void buildMeshTriangleSets();
 };
 
 Q_DECLARE_METATYPE(FBXGeometry)
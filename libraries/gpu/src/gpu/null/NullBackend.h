@@ -27,13 +27,12 @@ class Backend : public gpu::Backend {
     // Context Backend static interface required
     friend class gpu::Context;
     static void init() {}
-    static gpu::Backend* createBackend() { return new Backend(); }
+    static BackendPointer createBackend() { return std::make_shared<Backend>(); }
     static bool makeProgram(Shader& shader, const Shader::BindingSet& slotBindings) { return true; }
 
-protected:
+public:
     explicit Backend(bool syncCache) : Parent() { }
     Backend() : Parent() { }
-public:
     ~Backend() { }
 
     void render(const Batch& batch) final { }
@@ -44,6 +43,10 @@ public:
     // Let's try to avoid to do that as much as possible!
     void syncCache() final { }
 
+    // Nothing is ever allocated on the gpu
+    void recycle() const final { }
+    bool isTextureManagementSparseEnabled() const final { return false; }
+
     // This is the ugly "download the pixels to sysmem for taking a snapshot"
     // Just avoid using it, it's ugly and will break performances
     virtual void downloadFramebuffer(const FramebufferPointer& srcFramebuffer, const Vec4i& region, QImage& destImage) final { }
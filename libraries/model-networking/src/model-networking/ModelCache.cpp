@@ -183,6 +183,9 @@ void GeometryReader::run() {
                 throw QString("unsupported format");
             }
 
+            // picks need these, and building them here keeps it off the main thread
+            fbxGeometry->buildMeshTriangleSets();
+
             // Ensure the resource has not been deleted
             auto resource = _resource.toStrongRef();
             if (!resource) {
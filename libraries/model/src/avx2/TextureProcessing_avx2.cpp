@@ -0,0 +1,169 @@
+//
+//  TextureProcessing_avx2.cpp
+//  libraries/model/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+
+#include <string.h>
+#include <immintrin.h>  // AVX2
+
+#include "../model/TextureProcessing.h"
+
+#ifndef __AVX2__
+#error Must be compiled with /arch:AVX2 or -mavx2 -mfma.
+#endif
+
+using namespace model::image;
+
+// 4 channels: 8 source pixels into 4 destination pixels
+static inline void downsample4_AVX2(const uint8_t* row0, const uint8_t* row1, uint8_t* dst) {
+    const __m256i round = _mm256_set1_epi16(2);
+    const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 0, 4, 1, 5);
+
+    __m128i a0 = _mm_loadu_si128((const __m128i*)&row0[0]);
+    __m128i a1 = _mm_loadu_si128((const __m128i*)&row0[16]);
+    __m128i b0 = _mm_loadu_si128((const __m128i*)&row1[0]);
+    __m128i b1 = _mm_loadu_si128((const __m128i*)&row1[16]);
+
+    // vertical sum, pixels [p0 p1 | p2 p3] and [p4 p5 | p6 p7]
+    __m256i lo = _mm256_add_epi16(_mm256_cvtepu8_epi16(a0), _mm256_cvtepu8_epi16(b0));
+    __m256i hi = _mm256_add_epi16(_mm256_cvtepu8_epi16(a1), _mm256_cvtepu8_epi16(b1));
+
+    // horizontal sum [q0 q2 | q1 q3]
+    __m256i sum = _mm256_add_epi16(_mm256_unpacklo_epi64(lo, hi), _mm256_unpackhi_epi64(lo, hi));
+    sum = _mm256_srli_epi16(_mm256_add_epi16(sum, round), 2);
+
+    // pack and reorder to [q0 q1 q2 q3]
+    __m256i result = _mm256_permutevar8x32_epi32(_mm256_packus_epi16(sum, sum), order);
+    _mm_storeu_si128((__m128i*)dst, _mm256_castsi256_si128(result));
+}
+
+// 1 channel: 32 source pixels into 16 destination pixels
+static inline void downsample1_AVX2(const uint8_t* row0, const uint8_t* row1, uint8_t* dst) {
+    const __m256i ones = _mm256_set1_epi16(1);
+    const __m256i round = _mm256_set1_epi16(2);
+    const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 0, 4, 1, 5);
+
+    __m128i a0 = _mm_loadu_si128((const __m128i*)&row0[0]);
+    __m128i a1 = _mm_loadu_si128((const __m128i*)&row0[16]);
+    __m128i b0 = _mm_loadu_si128((const __m128i*)&row1[0]);
+    __m128i b1 = _mm_loadu_si128((const __m128i*)&row1[16]);
+
+    __m256i lo = _mm256_add_epi16(_mm256_cvtepu8_epi16(a0), _mm256_cvtepu8_epi16(b0));
+    __m256i hi = _mm256_add_epi16(_mm256_cvtepu8_epi16(a1), _mm256_cvtepu8_epi16(b1));
+
+    // sum adjacent pairs, [0-3 8-11 | 4-7 12-15]
+    __m256i sum = _mm256_packs_epi32(_mm256_madd_epi16(lo, ones), _mm256_madd_epi16(hi, ones));
+    sum = _mm256_srli_epi16(_mm256_add_epi16(sum, round), 2);
+
+    __m256i result = _mm256_permutevar8x32_epi32(_mm256_packus_epi16(sum, sum), order);
+    _mm_storeu_si128((__m128i*)dst, _mm256_castsi256_si128(result));
+}
+
+void model::image::avx2::downsampleRow(const uint8_t* row0, const uint8_t* row1, int srcWidth, uint8_t* dst, int dstWidth, int numChannels) {
+    int x = 0;
+    if (numChannels == 4) {
+        for (; 2 * (x + 4) <= srcWidth && x + 4 <= dstWidth; x += 4) {
+            downsample4_AVX2(&row0[8 * x], &row1[8 * x], &dst[4 * x]);
+        }
+    } else if (numChannels == 1) {
+        for (; 2 * (x + 16) <= srcWidth && x + 16 <= dstWidth; x += 16) {
+            downsample1_AVX2(&row0[2 * x], &row1[2 * x], &dst[x]);
+        }
+    }
+
+    // remaining pixels, odd edges and 3 channel images
+    const int srcOffset = 2 * x * numChannels;
+    ref::downsampleRow(&row0[srcOffset], &row1[srcOffset], srcWidth - 2 * x, &dst[x * numChannels], dstWidth - x, numChannels);
+}
+
+// sRGB: 4 source pixels into 2 destination pixels, color decoded and encoded using table gathers
+void model::image::avx2::downsampleRowSRGB(const uint8_t* row0, const uint8_t* row1, int srcWidth, uint8_t* dst, int dstWidth) {
+    const float* toLinear = srgbToLinearTable();
+    const int* toSRGB = (const int*)linearToSRGBTable();
+
+    // [p0 p2 p1 p3] so that the low and high halves hold the left and right texels of each output
+    const __m128i interleave = _mm_setr_epi8(0, 1, 2, 3, 8, 9, 10, 11, 4, 5, 6, 7, 12, 13, 14, 15);
+    const __m256 scale = _mm256_set1_ps(0.25f * (float)(LINEAR_TO_SRGB_TABLE_SIZE - 1));
+    const __m256 half = _mm256_set1_ps(0.5f);
+    const __m256i round = _mm256_set1_epi32(2);
+    const int ALPHA_LANES = 0x88;
+
+    int x = 0;
+    for (; 2 * (x + 2) <= srcWidth && x + 2 <= dstWidth; x += 2) {
+        __m128i a = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)&row0[8 * x]), interleave);
+        __m128i b = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)&row1[8 * x]), interleave);
+
+        __m256i aL = _mm256_cvtepu8_epi32(a);
+        __m256i aR = _mm256_cvtepu8_epi32(_mm_srli_si128(a, 8));
+        __m256i bL = _mm256_cvtepu8_epi32(b);
+        __m256i bR = _mm256_cvtepu8_epi32(_mm_srli_si128(b, 8));
+
+        // color, averaged in linear space
+        __m256 sum = _mm256_add_ps(_mm256_add_ps(_mm256_i32gather_ps(toLinear, aL, 4), _mm256_i32gather_ps(toLinear, aR, 4)),
+                                   _mm256_add_ps(_mm256_i32gather_ps(toLinear, bL, 4), _mm256_i32gather_ps(toLinear, bR, 4)));
+        __m256i index = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(sum, scale), half));
+        __m256i color = _mm256_i32gather_epi32(toSRGB, index, 4);
+
+        // alpha, averaged as stored
+        __m256i alpha = _mm256_add_epi32(_mm256_add_epi32(aL, aR), _mm256_add_epi32(bL, bR));
+        alpha = _mm256_srli_epi32(_mm256_add_epi32(alpha, round), 2);
+
+        __m256i result = _mm256_blend_epi32(color, alpha, ALPHA_LANES);
+
+        // pack 8 x 32-bit into 8 bytes
+        __m128i result16 = _mm_packus_epi32(_mm256_castsi256_si128(result), _mm256_extracti128_si256(result, 1));
+        _mm_storel_epi64((__m128i*)&dst[4 * x], _mm_packus_epi16(result16, result16));
+    }
+
+    const int srcOffset = 8 * x;
+    ref::downsampleRowSRGB(&row0[srcOffset], &row1[srcOffset], srcWidth - 2 * x, &dst[4 * x], dstWidth - x);
+}
+
+static inline void storeNormalized_AVX2(__m256 n, uint8_t* dst) {
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 scale = _mm256_set1_ps(127.5f);
+
+    __m256i i32 = _mm256_cvttps_epi32(_mm256_max_ps(_mm256_mul_ps(_mm256_add_ps(n, one), scale), _mm256_setzero_ps()));
+    __m128i i16 = _mm_packs_epi32(_mm256_castsi256_si128(i32), _mm256_extracti128_si256(i32, 1));
+    _mm_storel_epi64((__m128i*)dst, _mm_packus_epi16(i16, i16));
+}
+
+void model::image::avx2::sobelRow(const float* above, const float* row, const float* below, int width, uint8_t* dstX, uint8_t* dstY, uint8_t* dstZ) {
+    const __m256 strength = _mm256_set1_ps(2.0f);
+    const __m256 dZ = _mm256_set1_ps(255.0f / 2.0f);
+    const __m256 dZ2 = _mm256_mul_ps(dZ, dZ);
+
+    int x = 0;
+    for (; x + 8 <= width; x += 8) {
+        __m256 aL = _mm256_loadu_ps(&above[x - 1]);
+        __m256 aC = _mm256_loadu_ps(&above[x]);
+        __m256 aR = _mm256_loadu_ps(&above[x + 1]);
+        __m256 rL = _mm256_loadu_ps(&row[x - 1]);
+        __m256 rR = _mm256_loadu_ps(&row[x + 1]);
+        __m256 bL = _mm256_loadu_ps(&below[x - 1]);
+        __m256 bC = _mm256_loadu_ps(&below[x]);
+        __m256 bR = _mm256_loadu_ps(&below[x + 1]);
+
+        __m256 dX = _mm256_sub_ps(_mm256_add_ps(_mm256_add_ps(aL, _mm256_mul_ps(strength, rL)), bL),
+                                  _mm256_add_ps(_mm256_add_ps(aR, _mm256_mul_ps(strength, rR)), bR));
+        __m256 dY = _mm256_sub_ps(_mm256_add_ps(_mm256_add_ps(aL, _mm256_mul_ps(strength, aC)), aR),
+                                  _mm256_add_ps(_mm256_add_ps(bL, _mm256_mul_ps(strength, bC)), bR));
+
+        __m256 length = _mm256_sqrt_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dX, dX), _mm256_mul_ps(dY, dY)), dZ2));
+
+        storeNormalized_AVX2(_mm256_div_ps(dX, length), &dstX[x]);
+        storeNormalized_AVX2(_mm256_div_ps(dY, length), &dstY[x]);
+        storeNormalized_AVX2(_mm256_div_ps(dZ, length), &dstZ[x]);
+    }
+
+    ref::sobelRow(&above[x], &row[x], &below[x], width - x, &dstX[x], &dstY[x], &dstZ[x]);
+}
+
+#endif
@@ -17,6 +17,8 @@
 #include <Profile.h>
 
 #include "ModelLogging.h"
+#include "TextureProcessing.h"
+
 using namespace model;
 using namespace gpu;
 
@@ -202,19 +204,34 @@ const QImage& image, bool isLinear, bool doCompress) {
 
 #define CPU_MIPMAPS 1
 
+static bool isSRGBSemantic(const gpu::Element& format) {
+    auto semantic = format.getSemantic();
+    return semantic == gpu::SRGB || semantic == gpu::SRGBA || semantic == gpu::SBGRA;
+}
+
+// Each level is a 2x2 box filter of the previous one, falling back to QImage scaling for formats
+// the image kernels don't handle.
+static QImage evalNextMip(const QImage& mipImage, const QImage& image, const QSize& mipSize, bool isSRGB, bool fastResize) {
+    QImage nextMip = image::downsampleImage(mipImage, isSRGB);
+    if (!nextMip.isNull() && nextMip.size() == mipSize) {
+        return nextMip;
+    }
+    if (fastResize) {
+        return mipImage.scaled(mipSize);
+    }
+    return image.scaled(mipSize, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+}
+
 void generateMips(gpu::Texture* texture, QImage& image, gpu::Element formatMip, bool fastResize) {
 #if CPU_MIPMAPS
     PROFILE_RANGE(resource_parse, "generateMips");
+    bool isSRGB = isSRGBSemantic(formatMip);
+    QImage mipImage = image;
     auto numMips = texture->evalNumMips();
     for (uint16 level = 1; level < numMips; ++level) {
         QSize mipSize(texture->evalMipWidth(level), texture->evalMipHeight(level));
-        if (fastResize) {
-            image = image.scaled(mipSize);
-            texture->assignStoredMip(level, formatMip, image.byteCount(), image.constBits());
-        } else {
-            QImage mipImage = image.scaled(mipSize, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
-            texture->assignStoredMip(level, formatMip, mipImage.byteCount(), mipImage.constBits());
-        }
+        mipImage = evalNextMip(mipImage, image, mipSize, isSRGB, fastResize);
+        texture->assignStoredMip(level, formatMip, mipImage.byteCount(), mipImage.constBits());
     }
 #else
     texture->autoGenerateMips(-1);
@@ -224,10 +241,12 @@ void generateMips(gpu::Texture* texture, QImage& image, gpu::Element formatMip,
 void generateFaceMips(gpu::Texture* texture, QImage& image, gpu::Element formatMip, uint8 face) {
 #if CPU_MIPMAPS
     PROFILE_RANGE(resource_parse, "generateFaceMips");
+    bool isSRGB = isSRGBSemantic(formatMip);
+    QImage mipImage = image;
     auto numMips = texture->evalNumMips();
     for (uint16 level = 1; level < numMips; ++level) {
         QSize mipSize(texture->evalMipWidth(level), texture->evalMipHeight(level));
-        QImage mipImage = image.scaled(mipSize, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+        mipImage = evalNextMip(mipImage, image, mipSize, isSRGB, false);
         texture->assignStoredMipFace(level, formatMip, mipImage.byteCount(), mipImage.constBits(), face);
     }
 #else
@@ -311,18 +330,6 @@ gpu::Texture* TextureUsage::createNormalTextureFromNormalImage(const QImage& src
     return theTexture;
 }
 
-int clampPixelCoordinate(int coordinate, int maxCoordinate) {
-    return coordinate - ((int)(coordinate < 0) * coordinate) + ((int)(coordinate > maxCoordinate) * (maxCoordinate - coordinate));
-}
-
-const int RGBA_MAX = 255;
-
-// transform -1 - 1 to 0 - 255 (from sobel value to rgb)
-double mapComponent(double sobelValue) {
-    const double factor = RGBA_MAX / 2.0;
-    return (sobelValue + 1.0) * factor;
-}
-
 gpu::Texture* TextureUsage::createNormalTextureFromBumpImage(const QImage& srcImage, const std::string& srcImageName) {
     PROFILE_RANGE(resource_parse, "createNormalTextureFromBumpImage");
     QImage image = processSourceImage(srcImage, false);
@@ -333,62 +340,23 @@ gpu::Texture* TextureUsage::createNormalTextureFromBumpImage(const QImage& srcIm
 
     // PR 5540 by AlessandroSigna integrated here as a specialized TextureLoader for bumpmaps
     // The conversion is done using the Sobel Filter to calculate the derivatives from the grayscale image
-    const double pStrength = 2.0;
+    // since it's a grayscale image, the value of each component RGB is the same, so only red is sampled
+    const int RGB888_PIXEL_SIZE = 3;
     int width = image.width();
     int height = image.height();
     QImage result(width, height, QImage::Format_RGB888);
-    
-    for (int i = 0; i < width; i++) {
-        const int iNextClamped = clampPixelCoordinate(i + 1, width - 1);
-        const int iPrevClamped = clampPixelCoordinate(i - 1, width - 1);
-    
-        for (int j = 0; j < height; j++) {
-            const int jNextClamped = clampPixelCoordinate(j + 1, height - 1);
-            const int jPrevClamped = clampPixelCoordinate(j - 1, height - 1);
-    
-            // surrounding pixels
-            const QRgb topLeft = image.pixel(iPrevClamped, jPrevClamped);
-            const QRgb top = image.pixel(iPrevClamped, j);
-            const QRgb topRight = image.pixel(iPrevClamped, jNextClamped);
-            const QRgb right = image.pixel(i, jNextClamped);
-            const QRgb bottomRight = image.pixel(iNextClamped, jNextClamped);
-            const QRgb bottom = image.pixel(iNextClamped, j);
-            const QRgb bottomLeft = image.pixel(iNextClamped, jPrevClamped);
-            const QRgb left = image.pixel(i, jPrevClamped);
-    
-            // take their gray intensities
-            // since it's a grayscale image, the value of each component RGB is the same
-            const double tl = qRed(topLeft);
-            const double t = qRed(top);
-            const double tr = qRed(topRight);
-            const double r = qRed(right);
-            const double br = qRed(bottomRight);
-            const double b = qRed(bottom);
-            const double bl = qRed(bottomLeft);
-            const double l = qRed(left);
-    
-            // apply the sobel filter
-            const double dX = (tr + pStrength * r + br) - (tl + pStrength * l + bl);
-            const double dY = (bl + pStrength * b + br) - (tl + pStrength * t + tr);
-            const double dZ = RGBA_MAX / pStrength;
-    
-            glm::vec3 v(dX, dY, dZ);
-            glm::normalize(v);
-    
-            // convert to rgb from the value obtained computing the filter
-            QRgb qRgbValue = qRgba(mapComponent(v.x), mapComponent(v.y), mapComponent(v.z), 1.0);
-            result.setPixel(i, j, qRgbValue);
-        }
-    }
+    image::bumpToNormal(image.constBits(), width, height, image.bytesPerLine(), RGB888_PIXEL_SIZE,
+                        result.bits(), result.bytesPerLine());
 
     gpu::Texture* theTexture = nullptr;
-    if ((image.width() > 0) && (image.height() > 0)) {
+    if ((result.width() > 0) && (result.height() > 0)) {
         gpu::Element formatGPU = gpu::Element(gpu::VEC3, gpu::NUINT8, gpu::RGB);
         gpu::Element formatMip = gpu::Element(gpu::VEC3, gpu::NUINT8, gpu::RGB);
 
-        theTexture = (gpu::Texture::create2D(formatGPU, image.width(), image.height(), gpu::Sampler(gpu::Sampler::FILTER_MIN_MAG_MIP_LINEAR)));
+        theTexture = (gpu::Texture::create2D(formatGPU, result.width(), result.height(), gpu::Sampler(gpu::Sampler::FILTER_MIN_MAG_MIP_LINEAR)));
         theTexture->setSource(srcImageName);
-        theTexture->assignStoredMip(0, formatMip, image.byteCount(), image.constBits());
+        theTexture->assignStoredMip(0, formatMip, result.byteCount(), result.constBits());
+        generateMips(theTexture, result, formatMip, true);
     }
 
     return theTexture;
@@ -442,10 +410,10 @@ gpu::Texture* TextureUsage::createRoughnessTextureFromGlossImage(const QImage& s
         }
     }
 
-    // Gloss turned into Rough
-    image.invertPixels(QImage::InvertRgba);
-    
     image = image.convertToFormat(QImage::Format_Grayscale8);
+
+    // Gloss turned into Rough
+    image::invert(image.bits(), image.byteCount());
     
     gpu::Texture* theTexture = nullptr;
     if ((image.width() > 0) && (image.height() > 0)) {
@@ -0,0 +1,368 @@
+//
+//  TextureProcessing.cpp
+//  libraries/model/src/model
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+#include "TextureProcessing.h"
+
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include <array>
+#include <vector>
+
+#include <QImage>
+
+#include <CPUDetect.h>
+
+using namespace model::image;
+
+static const float SOBEL_STRENGTH = 2.0f;
+static const float SOBEL_DZ = 255.0f / SOBEL_STRENGTH;
+
+const float* model::image::srgbToLinearTable() {
+    static const std::array<float, 256> table = [] {
+        std::array<float, 256> result;
+        for (int i = 0; i < 256; i++) {
+            float s = (float)i / 255.0f;
+            result[i] = (s <= 0.04045f) ? (s / 12.92f) : powf((s + 0.055f) / 1.055f, 2.4f);
+        }
+        return result;
+    }();
+    return table.data();
+}
+
+const uint32_t* model::image::linearToSRGBTable() {
+    static const std::array<uint32_t, LINEAR_TO_SRGB_TABLE_SIZE> table = [] {
+        std::array<uint32_t, LINEAR_TO_SRGB_TABLE_SIZE> result;
+        for (int i = 0; i < LINEAR_TO_SRGB_TABLE_SIZE; i++) {
+            float l = (float)i / (float)(LINEAR_TO_SRGB_TABLE_SIZE - 1);
+            float s = (l <= 0.0031308f) ? (l * 12.92f) : (1.055f * powf(l, 1.0f / 2.4f) - 0.055f);
+            result[i] = (uint32_t)std::min(std::max((int)(s * 255.0f + 0.5f), 0), 255);
+        }
+        return result;
+    }();
+    return table.data();
+}
+
+//
+// Portable reference code
+//
+
+void model::image::ref::downsampleRow(const uint8_t* row0, const uint8_t* row1, int srcWidth, uint8_t* dst, int dstWidth, int numChannels) {
+    for (int x = 0; x < dstWidth; x++) {
+        const int x0 = std::min(2 * x, srcWidth - 1) * numChannels;
+        const int x1 = std::min(2 * x + 1, srcWidth - 1) * numChannels;
+        for (int c = 0; c < numChannels; c++) {
+            int sum = row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c];
+            dst[x * numChannels + c] = (uint8_t)((sum + 2) >> 2);
+        }
+    }
+}
+
+void model::image::ref::downsampleRowSRGB(const uint8_t* row0, const uint8_t* row1, int srcWidth, uint8_t* dst, int dstWidth) {
+    const float* toLinear = srgbToLinearTable();
+    const uint32_t* toSRGB = linearToSRGBTable();
+    const float SCALE = 0.25f * (float)(LINEAR_TO_SRGB_TABLE_SIZE - 1);
+
+    for (int x = 0; x < dstWidth; x++) {
+        const int x0 = std::min(2 * x, srcWidth - 1) * 4;
+        const int x1 = std::min(2 * x + 1, srcWidth - 1) * 4;
+        for (int c = 0; c < 3; c++) {
+            float sum = (toLinear[row0[x0 + c]] + toLinear[row0[x1 + c]]) + (toLinear[row1[x0 + c]] + toLinear[row1[x1 + c]]);
+            dst[x * 4 + c] = (uint8_t)toSRGB[(int)(sum * SCALE + 0.5f)];
+        }
+        int alpha = row0[x0 + 3] + row0[x1 + 3] + row1[x0 + 3] + row1[x1 + 3];
+        dst[x * 4 + 3] = (uint8_t)((alpha + 2) >> 2);
+    }
+}
+
+// above, row and below must be readable from [-1] to [width]
+// The normal is (-dh/dx, -dh/dy, 1), with x to the right and y down the image, so it tilts downhill.
+void model::image::ref::sobelRow(const float* above, const float* row, const float* below, int width, uint8_t* dstX, uint8_t* dstY, uint8_t* dstZ) {
+    for (int x = 0; x < width; x++) {
+        float dX = (above[x - 1] + SOBEL_STRENGTH * row[x - 1] + below[x - 1]) - (above[x + 1] + SOBEL_STRENGTH * row[x + 1] + below[x + 1]);
+        float dY = (above[x - 1] + SOBEL_STRENGTH * above[x] + above[x + 1]) - (below[x - 1] + SOBEL_STRENGTH * below[x] + below[x + 1]);
+        float length = sqrtf(dX * dX + dY * dY + SOBEL_DZ * SOBEL_DZ);
+
+        // transform -1 - 1 to 0 - 255
+        dstX[x] = (uint8_t)std::max((dX / length + 1.0f) * 127.5f, 0.0f);
+        dstY[x] = (uint8_t)std::max((dY / length + 1.0f) * 127.5f, 0.0f);
+        dstZ[x] = (uint8_t)std::max((SOBEL_DZ / length + 1.0f) * 127.5f, 0.0f);
+    }
+}
+
+void model::image::ref::invert(uint8_t* data, size_t numBytes) {
+    for (size_t i = 0; i < numBytes; i++) {
+        data[i] = 255 - data[i];
+    }
+}
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+
+#include <emmintrin.h>  // SSE2
+
+//
+// SSE2 code, always available on x86
+//
+
+// 4 channels: 8 source pixels into 4 destination pixels
+static inline void downsample4_SSE(const uint8_t* row0, const uint8_t* row1, uint8_t* dst) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i round = _mm_set1_epi16(2);
+
+    __m128i result[2];
+    for (int i = 0; i < 2; i++) {
+        __m128i a = _mm_loadu_si128((const __m128i*)&row0[16 * i]);
+        __m128i b = _mm_loadu_si128((const __m128i*)&row1[16 * i]);
+
+        // vertical sum, pixels [p0 p1] and [p2 p3]
+        __m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+        __m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+
+        // horizontal sum [p0+p1 p2+p3]
+        __m128i sum = _mm_add_epi16(_mm_unpacklo_epi64(lo, hi), _mm_unpackhi_epi64(lo, hi));
+        result[i] = _mm_srli_epi16(_mm_add_epi16(sum, round), 2);
+    }
+    _mm_storeu_si128((__m128i*)dst, _mm_packus_epi16(result[0], result[1]));
+}
+
+// 1 channel: 32 source pixels into 16 destination pixels
+static inline void downsample1_SSE(const uint8_t* row0, const uint8_t* row1, uint8_t* dst) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i ones = _mm_set1_epi16(1);
+    const __m128i round = _mm_set1_epi16(2);
+
+    __m128i result[2];
+    for (int i = 0; i < 2; i++) {
+        __m128i a = _mm_loadu_si128((const __m128i*)&row0[16 * i]);
+        __m128i b = _mm_loadu_si128((const __m128i*)&row1[16 * i]);
+
+        __m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+        __m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+
+        // sum adjacent pairs
+        __m128i sum = _mm_packs_epi32(_mm_madd_epi16(lo, ones), _mm_madd_epi16(hi, ones));
+        result[i] = _mm_srli_epi16(_mm_add_epi16(sum, round), 2);
+    }
+    _mm_storeu_si128((__m128i*)dst, _mm_packus_epi16(result[0], result[1]));
+}
+
+void model::image::sse::downsampleRow(const uint8_t* row0, const uint8_t* row1, int srcWidth, uint8_t* dst, int dstWidth, int numChannels) {
+    int x = 0;
+    if (numChannels == 4) {
+        for (; 2 * (x + 4) <= srcWidth && x + 4 <= dstWidth; x += 4) {
+            downsample4_SSE(&row0[8 * x], &row1[8 * x], &dst[4 * x]);
+        }
+    } else if (numChannels == 1) {
+        for (; 2 * (x + 16) <= srcWidth && x + 16 <= dstWidth; x += 16) {
+            downsample1_SSE(&row0[2 * x], &row1[2 * x], &dst[x]);
+        }
+    }
+
+    // remaining pixels, odd edges and 3 channel images
+    const int srcOffset = 2 * x * numChannels;
+    ref::downsampleRow(&row0[srcOffset], &row1[srcOffset], srcWidth - 2 * x, &dst[x * numChannels], dstWidth - x, numChannels);
+}
+
+static inline void storeNormalized_SSE(__m128 n, uint8_t* dst) {
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 scale = _mm_set1_ps(127.5f);
+
+    __m128i i32 = _mm_cvttps_epi32(_mm_max_ps(_mm_mul_ps(_mm_add_ps(n, one), scale), _mm_setzero_ps()));
+    __m128i i16 = _mm_packs_epi32(i32, i32);
+    int32_t bytes = _mm_cvtsi128_si32(_mm_packus_epi16(i16, i16));
+    memcpy(dst, &bytes, sizeof(bytes));
+}
+
+void model::image::sse::sobelRow(const float* above, const float* row, const float* below, int width, uint8_t* dstX, uint8_t* dstY, uint8_t* dstZ) {
+    const __m128 strength = _mm_set1_ps(SOBEL_STRENGTH);
+    const __m128 dZ = _mm_set1_ps(SOBEL_DZ);
+    const __m128 dZ2 = _mm_set1_ps(SOBEL_DZ * SOBEL_DZ);
+
+    int x = 0;
+    for (; x + 4 <= width; x += 4) {
+        __m128 aL = _mm_loadu_ps(&above[x - 1]);
+        __m128 aC = _mm_loadu_ps(&above[x]);
+        __m128 aR = _mm_loadu_ps(&above[x + 1]);
+        __m128 rL = _mm_loadu_ps(&row[x - 1]);
+        __m128 rR = _mm_loadu_ps(&row[x + 1]);
+        __m128 bL = _mm_loadu_ps(&below[x - 1]);
+        __m128 bC = _mm_loadu_ps(&below[x]);
+        __m128 bR = _mm_loadu_ps(&below[x + 1]);
+
+        __m128 dX = _mm_sub_ps(_mm_add_ps(_mm_add_ps(aL, _mm_mul_ps(strength, rL)), bL),
+                               _mm_add_ps(_mm_add_ps(aR, _mm_mul_ps(strength, rR)), bR));
+        __m128 dY = _mm_sub_ps(_mm_add_ps(_mm_add_ps(aL, _mm_mul_ps(strength, aC)), aR),
+                               _mm_add_ps(_mm_add_ps(bL, _mm_mul_ps(strength, bC)), bR));
+
+        __m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dX, dX), _mm_mul_ps(dY, dY)), dZ2));
+
+        storeNormalized_SSE(_mm_div_ps(dX, length), &dstX[x]);
+        storeNormalized_SSE(_mm_div_ps(dY, length), &dstY[x]);
+        storeNormalized_SSE(_mm_div_ps(dZ, length), &dstZ[x]);
+    }
+
+    ref::sobelRow(&above[x], &row[x], &below[x], width - x, &dstX[x], &dstY[x], &dstZ[x]);
+}
+
+void model::image::sse::invert(uint8_t* data, size_t numBytes) {
+    const __m128i ones = _mm_set1_epi8(-1);
+
+    size_t i = 0;
+    for (; i + 16 <= numBytes; i += 16) {
+        __m128i x = _mm_loadu_si128((__m128i*)&data[i]);
+        _mm_storeu_si128((__m128i*)&data[i], _mm_xor_si128(x, ones));
+    }
+    ref::invert(&data[i], numBytes - i);
+}
+
+//
+// Runtime dispatch
+//
+
+static void downsampleRow(const uint8_t* row0, const uint8_t* row1, int srcWidth, uint8_t* dst, int dstWidth, int numChannels) {
+    static auto f = cpuSupportsAVX2() ? avx2::downsampleRow : sse::downsampleRow;
+    (*f)(row0, row1, srcWidth, dst, dstWidth, numChannels); // dispatch
+}
+
+static void downsampleRowSRGB(const uint8_t* row0, const uint8_t* row1, int srcWidth, uint8_t* dst, int dstWidth) {
+    static auto f = cpuSupportsAVX2() ? avx2::downsampleRowSRGB : ref::downsampleRowSRGB;
+    (*f)(row0, row1, srcWidth, dst, dstWidth); // dispatch
+}
+
+static void sobelRow(const float* above, const float* row, const float* below, int width, uint8_t* dstX, uint8_t* dstY, uint8_t* dstZ) {
+    static auto f = cpuSupportsAVX2() ? avx2::sobelRow : sse::sobelRow;
+    (*f)(above, row, below, width, dstX, dstY, dstZ); // dispatch
+}
+
+static void invertBytes(uint8_t* data, size_t numBytes) {
+    sse::invert(data, numBytes);
+}
+
+#else   // portable reference code
+
+static void downsampleRow(const uint8_t* row0, const uint8_t* row1, int srcWidth, uint8_t* dst, int dstWidth, int numChannels) {
+    ref::downsampleRow(row0, row1, srcWidth, dst, dstWidth, numChannels);
+}
+
+static void downsampleRowSRGB(const uint8_t* row0, const uint8_t* row1, int srcWidth, uint8_t* dst, int dstWidth) {
+    ref::downsampleRowSRGB(row0, row1, srcWidth, dst, dstWidth);
+}
+
+static void sobelRow(const float* above, const float* row, const float* below, int width, uint8_t* dstX, uint8_t* dstY, uint8_t* dstZ) {
+    ref::sobelRow(above, row, below, width, dstX, dstY, dstZ);
+}
+
+static void invertBytes(uint8_t* data, size_t numBytes) {
+    ref::invert(data, numBytes);
+}
+
+#endif
+
+void model::image::downsample2x2(const uint8_t* src, int srcWidth, int srcHeight, int srcStride,
+                                 uint8_t* dst, int dstStride, int numChannels) {
+    const int dstWidth = std::max(srcWidth / 2, 1);
+    const int dstHeight = std::max(srcHeight / 2, 1);
+
+    for (int y = 0; y < dstHeight; y++) {
+        const uint8_t* row0 = &src[std::min(2 * y, srcHeight - 1) * srcStride];
+        const uint8_t* row1 = &src[std::min(2 * y + 1, srcHeight - 1) * srcStride];
+        ::downsampleRow(row0, row1, srcWidth, &dst[y * dstStride], dstWidth, numChannels);
+    }
+}
+
+void model::image::downsample2x2SRGB(const uint8_t* src, int srcWidth, int srcHeight, int srcStride,
+                                     uint8_t* dst, int dstStride) {
+    const int dstWidth = std::max(srcWidth / 2, 1);
+    const int dstHeight = std::max(srcHeight / 2, 1);
+
+    for (int y = 0; y < dstHeight; y++) {
+        const uint8_t* row0 = &src[std::min(2 * y, srcHeight - 1) * srcStride];
+        const uint8_t* row1 = &src[std::min(2 * y + 1, srcHeight - 1) * srcStride];
+        ::downsampleRowSRGB(row0, row1, srcWidth, &dst[y * dstStride], dstWidth);
+    }
+}
+
+void model::image::bumpToNormal(const uint8_t* src, int width, int height, int srcStride, int srcPixelSize,
+                                uint8_t* dst, int dstStride) {
+    if (width <= 0 || height <= 0) {
+        return;
+    }
+
+    // three rolling rows of heights, padded by one clamped texel on each side
+    std::vector<float> rows[3];
+    for (auto& row : rows) {
+        row.resize(width + 2);
+    }
+    auto loadRow = [&](std::vector<float>& row, int y) {
+        const uint8_t* srcRow = &src[std::min(std::max(y, 0), height - 1) * srcStride];
+        for (int x = 0; x < width; x++) {
+            row[x + 1] = (float)srcRow[x * srcPixelSize];
+        }
+        row[0] = row[1];
+        row[width + 1] = row[width];
+    };
+
+    std::vector<uint8_t> normals(3 * width);
+    uint8_t* normalX = &normals[0];
+    uint8_t* normalY = &normals[width];
+    uint8_t* normalZ = &normals[2 * width];
+
+    loadRow(rows[0], -1);
+    loadRow(rows[1], 0);
+    for (int y = 0; y < height; y++) {
+        std::vector<float>& above = rows[y % 3];
+        std::vector<float>& row = rows[(y + 1) % 3];
+        std::vector<float>& below = rows[(y + 2) % 3];
+        loadRow(below, y + 1);
+
+        ::sobelRow(&above[1], &row[1], &below[1], width, normalX, normalY, normalZ);
+
+        uint8_t* dstRow = &dst[y * dstStride];
+        for (int x = 0; x < width; x++) {
+            dstRow[3 * x + 0] = normalX[x];
+            dstRow[3 * x + 1] = normalY[x];
+            dstRow[3 * x + 2] = normalZ[x];
+        }
+    }
+}
+
+void model::image::invert(uint8_t* data, size_t numBytes) {
+    invertBytes(data, numBytes);
+}
+
+QImage model::image::downsampleImage(const QImage& image, bool isSRGB) {
+    int numChannels;
+    switch (image.format()) {
+        case QImage::Format_RGB32:
+        case QImage::Format_ARGB32:
+        case QImage::Format_RGBX8888:
+        case QImage::Format_RGBA8888:
+            numChannels = 4;
+            break;
+        case QImage::Format_RGB888:
+            numChannels = 3;
+            break;
+        case QImage::Format_Grayscale8:
+        case QImage::Format_Alpha8:
+            numChannels = 1;
+            break;
+        default:
+            return QImage();
+    }
+
+    QImage result(std::max(image.width() / 2, 1), std::max(image.height() / 2, 1), image.format());
+    if (isSRGB && numChannels == 4) {
+        downsample2x2SRGB(image.constBits(), image.width(), image.height(), image.bytesPerLine(),
+                          result.bits(), result.bytesPerLine());
+    } else {
+        downsample2x2(image.constBits(), image.width(), image.height(), image.bytesPerLine(),
+                      result.bits(), result.bytesPerLine(), numChannels);
+    }
+    return result;
+}
@@ -0,0 +1,75 @@
+//
+//  TextureProcessing.h
+//  libraries/model/src/model
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+#ifndef hifi_model_TextureProcessing_h
+#define hifi_model_TextureProcessing_h
+
+#include <stdint.h>
+#include <stddef.h>
+
+class QImage;
+
+namespace model {
+namespace image {
+
+//
+// CPU image kernels used by TextureUsage to build mips and derived maps.
+// Each kernel has a portable reference implementation and SSE2/AVX2 variants,
+// selected at runtime using CPUDetect.h.
+//
+
+// 2x2 box downsample of an 8-bit image with numChannels interleaved channels (1, 3 or 4).
+// The destination is max(srcWidth / 2, 1) x max(srcHeight / 2, 1); odd source edges are clamped.
+void downsample2x2(const uint8_t* src, int srcWidth, int srcHeight, int srcStride,
+                   uint8_t* dst, int dstStride, int numChannels);
+
+// Same as downsample2x2, for 4-channel sRGB color images. The three color channels are
+// averaged in linear space, the alpha channel (byte 3) is averaged as stored.
+void downsample2x2SRGB(const uint8_t* src, int srcWidth, int srcHeight, int srcStride,
+                       uint8_t* dst, int dstStride);
+
+// Generates a tangent-space normal map (RGB888) from a height map, using a Sobel filter on
+// the first channel of each source pixel. srcPixelSize is the number of bytes per source pixel.
+// Normals are (-dh/dx, -dh/dy, 1) normalized, x to the right and y down the image, so they tilt downhill.
+void bumpToNormal(const uint8_t* src, int width, int height, int srcStride, int srcPixelSize,
+                  uint8_t* dst, int dstStride);
+
+// In-place 255 - x over a byte buffer (gloss to roughness).
+void invert(uint8_t* data, size_t numBytes);
+
+// Returns the next mip level of image (each dimension halved, clamped to 1), in the same format.
+// Returns a null QImage when the format is not handled by the kernels above.
+QImage downsampleImage(const QImage& image, bool isSRGB);
+
+// Per-ISA entry points, exposed for tests and benchmarks
+namespace ref {
+    void downsampleRow(const uint8_t* row0, const uint8_t* row1, int srcWidth, uint8_t* dst, int dstWidth, int numChannels);
+    void downsampleRowSRGB(const uint8_t* row0, const uint8_t* row1, int srcWidth, uint8_t* dst, int dstWidth);
+    void sobelRow(const float* above, const float* row, const float* below, int width, uint8_t* dstX, uint8_t* dstY, uint8_t* dstZ);
+    void invert(uint8_t* data, size_t numBytes);
+}
+namespace sse {
+    void downsampleRow(const uint8_t* row0, const uint8_t* row1, int srcWidth, uint8_t* dst, int dstWidth, int numChannels);
+    void sobelRow(const float* above, const float* row, const float* below, int width, uint8_t* dstX, uint8_t* dstY, uint8_t* dstZ);
+    void invert(uint8_t* data, size_t numBytes);
+}
+namespace avx2 {
+    void downsampleRow(const uint8_t* row0, const uint8_t* row1, int srcWidth, uint8_t* dst, int dstWidth, int numChannels);
+    void downsampleRowSRGB(const uint8_t* row0, const uint8_t* row1, int srcWidth, uint8_t* dst, int dstWidth);
+    void sobelRow(const float* above, const float* row, const float* below, int width, uint8_t* dstX, uint8_t* dstY, uint8_t* dstZ);
+}
+
+// Lookup tables shared by the sRGB kernels
+const float* srgbToLinearTable();       // 256 entries
+const uint32_t* linearToSRGBTable();    // LINEAR_TO_SRGB_TABLE_SIZE entries, indexed by linear * (size - 1)
+const int LINEAR_TO_SRGB_TABLE_SIZE = 4096;
+
+} }
+
+#endif // hifi_model_TextureProcessing_h
@@ -270,11 +270,8 @@ bool LimitedNodeList::packetSourceAndHashMatchAndTrackBandwidth(const udt::Packe
         if (matchingNode) {
             if (!NON_VERIFIED_PACKETS.contains(headerType)) {
 
-                QByteArray packetHeaderHash = NLPacket::verificationHashInHeader(packet);
-                QByteArray expectedHash = NLPacket::hashForPacketAndSecret(packet, matchingNode->getConnectionSecret());
-
-                // check if the md5 hash in the header matches the hash we would expect
-                if (packetHeaderHash != expectedHash) {
+                // check if the hash in the header matches the hash we would expect
+                if (!NLPacket::verifyHashForPacketAndSecret(packet, matchingNode->getConnectionSecret())) {
                     static QMultiMap<QUuid, PacketType> hashDebugSuppressMap;
 
                     if (!hashDebugSuppressMap.contains(sourceID, headerType)) {
@@ -421,14 +418,15 @@ qint64 LimitedNodeList::sendPacketList(NLPacketList& packetList, const HifiSockA
     return bytesSent;
 }
 
-qint64 LimitedNodeList::sendPacketList(std::unique_ptr<NLPacketList> packetList, const HifiSockAddr& sockAddr) {
+qint64 LimitedNodeList::sendPacketList(std::unique_ptr<NLPacketList> packetList, const HifiSockAddr& sockAddr,
+                                       const QUuid& connectionSecret) {
     // close the last packet in the list
     packetList->closeCurrentPacket();
 
     for (std::unique_ptr<udt::Packet>& packet : packetList->_packets) {
         NLPacket* nlPacket = static_cast<NLPacket*>(packet.get());
         collectPacketStats(*nlPacket);
-        fillPacketHeader(*nlPacket);
+        fillPacketHeader(*nlPacket, connectionSecret);
     }
 
     return _nodeSocket.writePacketList(std::move(packetList), sockAddr);
@@ -514,6 +512,8 @@ void LimitedNodeList::eraseAllNodes() {
                 killedNodes.insert(it->second);
                 it = _nodeHash.unsafe_erase(it);
             }
+
+            publishNodeSnapshot();
         }
     }
 
@@ -541,6 +541,7 @@ bool LimitedNodeList::killNodeWithUUID(const QUuid& nodeUUID) {
         {
             QWriteLocker writeLocker(&_nodeMutex);
             _nodeHash.unsafe_erase(it);
+            publishNodeSnapshot();
         }
 
         handleNodeKill(matchingNode);
@@ -550,6 +551,20 @@ bool LimitedNodeList::killNodeWithUUID(const QUuid& nodeUUID) {
     return false;
 }
 
+void LimitedNodeList::publishNodeSnapshot() {
+    // inserts only take the read lock, so more than one thread can get here at once - rebuilding from the
+    // whole hash (instead of patching the last snapshot) means whichever publishes last includes every insert
+    std::lock_guard<std::mutex> lock(_nodeSnapshotMutex);
+
+    auto nodes = std::make_shared<std::vector<SharedNodePointer>>();
+    nodes->reserve(_nodeHash.size());
+    for (const auto& pair : _nodeHash) {
+        nodes->push_back(pair.second);
+    }
+
+    std::atomic_store(&_nodeSnapshot, NodeSnapshot(std::move(nodes)));
+}
+
 void LimitedNodeList::processKillNode(ReceivedMessage& message) {
     // read the node id
     QUuid nodeUUID = QUuid::fromRfc4122(message.readWithoutCopy(NUM_BYTES_RFC4122_UUID));
@@ -610,6 +625,7 @@ SharedNodePointer LimitedNodeList::addOrUpdateNode(const QUuid& uuid, NodeType_t
                 auto oldSoloNode = previousSoloIt->second;
 
                 _nodeHash.unsafe_erase(previousSoloIt);
+                publishNodeSnapshot();
                 handleNodeKill(oldSoloNode);
 
                 // convert the current lock back to a read lock for insertion of new node
@@ -620,6 +636,7 @@ SharedNodePointer LimitedNodeList::addOrUpdateNode(const QUuid& uuid, NodeType_t
 
         // insert the new node and release our read lock
         _nodeHash.insert(UUIDNodePair(newNode->getUUID(), newNodePointer));
+        publishNodeSnapshot();
         readLocker.unlock();
 
         qCDebug(networking) << "Added" << *newNode;
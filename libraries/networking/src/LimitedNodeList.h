@@ -16,8 +16,10 @@
 #include <stdint.h>
 #include <iterator>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <unordered_map>
+#include <vector>
 
 #ifndef _WIN32
 #include <unistd.h> // not on windows, not needed for mac or windows
@@ -133,7 +135,8 @@ public:
     qint64 sendPacketList(NLPacketList& packetList, const Node& destinationNode);
     qint64 sendPacketList(NLPacketList& packetList, const HifiSockAddr& sockAddr,
                           const QUuid& connectionSecret = QUuid());
-    qint64 sendPacketList(std::unique_ptr<NLPacketList> packetList, const HifiSockAddr& sockAddr);
+    qint64 sendPacketList(std::unique_ptr<NLPacketList> packetList, const HifiSockAddr& sockAddr,
+                          const QUuid& connectionSecret = QUuid());
     qint64 sendPacketList(std::unique_ptr<NLPacketList> packetList, const Node& destinationNode);
 
     std::function<void(Node*)> linkedDataCreateCallback;
@@ -175,69 +178,38 @@ public:
 
     SharedNodePointer findNodeWithAddr(const HifiSockAddr& addr);
 
-    using value_type = SharedNodePointer;
-    using const_iterator = std::vector<value_type>::const_iterator;
-
-    // Cede control of iteration under a single read lock (e.g. for use by thread pools)
-    // Use this for nested loops instead of taking nested read locks!
-    //   This allows multiple threads (i.e. a thread pool) to share a lock
-    //   without deadlocking when a dying node attempts to acquire a write lock
-    template<typename NestedNodeLambda>
-    void nestedEach(NestedNodeLambda functor, 
-                    int* lockWaitOut = nullptr, 
-                    int* nodeTransformOut = nullptr, 
-                    int* functorOut = nullptr) {
-        auto start = usecTimestampNow();
-        {
-            QReadLocker readLock(&_nodeMutex);
-            auto endLock = usecTimestampNow();
-            if (lockWaitOut) {
-                *lockWaitOut = (endLock - start);
-            }
-
-            std::vector<SharedNodePointer> nodes(_nodeHash.size());
-            std::transform(_nodeHash.cbegin(), _nodeHash.cend(), nodes.begin(), [](const NodeHash::value_type& it) {
-                return it.second;
-            });
-            auto endTransform = usecTimestampNow();
-            if (nodeTransformOut) {
-                *nodeTransformOut = (endTransform - endLock);
-            }
-
-            functor(nodes.cbegin(), nodes.cend());
-            auto endFunctor = usecTimestampNow();
-            if (functorOut) {
-                *functorOut = (endFunctor - endTransform);
-            }
-        }
-    }
+    // An immutable list of the nodes, republished whenever a node is added or removed.
+    // Readers can hold on to a snapshot and iterate it from any thread without taking the node lock;
+    // a node removed after the snapshot was taken is still in it (and kept alive) until the snapshot is released.
+    using NodeSnapshot = std::shared_ptr<const std::vector<SharedNodePointer>>;
+    NodeSnapshot getNodeSnapshot() const { return std::atomic_load(&_nodeSnapshot); }
 
     template<typename NodeLambda>
     void eachNode(NodeLambda functor) {
-        QReadLocker readLock(&_nodeMutex);
+        auto nodes = getNodeSnapshot();
 
-        for (NodeHash::const_iterator it = _nodeHash.cbegin(); it != _nodeHash.cend(); ++it) {
-            functor(it->second);
+        for (const SharedNodePointer& node : *nodes) {
+            functor(node);
         }
     }
 
     template<typename PredLambda, typename NodeLambda>
     void eachMatchingNode(PredLambda predicate, NodeLambda functor) {
-        QReadLocker readLock(&_nodeMutex);
+        auto nodes = getNodeSnapshot();
 
-        for (NodeHash::const_iterator it = _nodeHash.cbegin(); it != _nodeHash.cend(); ++it) {
-            if (predicate(it->second)) {
-                functor(it->second);
+        for (const SharedNodePointer& node : *nodes) {
+            if (predicate(node)) {
+                functor(node);
             }
         }
     }
 
     template<typename BreakableNodeLambda>
     void eachNodeBreakable(BreakableNodeLambda functor) {
-        QReadLocker readLock(&_nodeMutex);
+        auto nodes = getNodeSnapshot();
 
-        for (NodeHash::const_iterator it = _nodeHash.cbegin(); it != _nodeHash.cend(); ++it) {
-            if (!functor(it->second)) {
+        for (const SharedNodePointer& node : *nodes) {
+            if (!functor(node)) {
                 break;
             }
         }
@@ -281,7 +253,7 @@ public slots:
     void reset();
     void eraseAllNodes();
 
-    void removeSilentNodes();
+    virtual void removeSilentNodes();
 
     void updateLocalSocket();
 
@@ -339,6 +311,9 @@ protected:
 
     void handleNodeKill(const SharedNodePointer& node);
 
+    // rebuild _nodeSnapshot from _nodeHash, call after any change to _nodeHash while still holding _nodeMutex
+    void publishNodeSnapshot();
+
     void stopInitialSTUNUpdate(bool success);
 
     void sendPacketToIceServer(PacketType packetType, const HifiSockAddr& iceServerSockAddr, const QUuid& clientID,
@@ -349,6 +324,8 @@ protected:
     QUuid _sessionUUID;
     NodeHash _nodeHash;
     mutable QReadWriteLock _nodeMutex;
+    std::mutex _nodeSnapshotMutex; // serializes publishNodeSnapshot, which can run under the read lock
+    NodeSnapshot _nodeSnapshot { std::make_shared<const std::vector<SharedNodePointer>>() };
     udt::Socket _nodeSocket;
     QUdpSocket* _dtlsSocket;
     HifiSockAddr _localSockAddr;
@@ -383,6 +360,8 @@ protected:
         while (it != _nodeHash.end()) {
             functor(it);
         }
+
+        publishNodeSnapshot();
     }
 
 private slots:
@@ -11,10 +11,14 @@
 
 #include "NLPacket.h"
 
+#include <QtCore/QtEndian>
+
+#include <SipHash.h>
+
 int NLPacket::localHeaderSize(PacketType type) {
     bool nonSourced = NON_SOURCED_PACKETS.contains(type);
     bool nonVerified = NON_VERIFIED_PACKETS.contains(type);
-    qint64 optionalSize = (nonSourced ? 0 : NUM_BYTES_RFC4122_UUID) + ((nonSourced || nonVerified) ? 0 : NUM_BYTES_MD5_HASH);
+    qint64 optionalSize = (nonSourced ? 0 : NUM_BYTES_RFC4122_UUID) + ((nonSourced || nonVerified) ? 0 : NUM_BYTES_PACKET_HASH);
     return sizeof(PacketType) + sizeof(PacketVersion) + optionalSize;
 }
 int NLPacket::totalHeaderSize(PacketType type, bool isPartOfMessage) {
@@ -144,23 +148,43 @@ QUuid NLPacket::sourceIDInHeader(const udt::Packet& packet) {
     return QUuid::fromRfc4122(QByteArray::fromRawData(packet.getData() + offset, NUM_BYTES_RFC4122_UUID));
 }
 
-QByteArray NLPacket::verificationHashInHeader(const udt::Packet& packet) {
-    int offset = Packet::totalHeaderSize(packet.isPartOfMessage()) + sizeof(PacketType) + sizeof(PacketVersion) + NUM_BYTES_RFC4122_UUID;
-    return QByteArray(packet.getData() + offset, NUM_BYTES_MD5_HASH);
+void NLPacket::hashForPacketAndSecret(const udt::Packet& packet, const QUuid& connectionSecret, char* hashOut,
+                                      PacketVerificationScheme scheme) {
+    int offset = Packet::totalHeaderSize(packet.isPartOfMessage()) + sizeof(PacketType) + sizeof(PacketVersion)
+        + NUM_BYTES_RFC4122_UUID + NUM_BYTES_PACKET_HASH;
+
+    // the secret in RFC 4122 byte order, without going through a QByteArray
+    uint8_t secret[NUM_BYTES_RFC4122_UUID];
+    qToBigEndian(connectionSecret.data1, secret);
+    qToBigEndian(connectionSecret.data2, secret + 4);
+    qToBigEndian(connectionSecret.data3, secret + 6);
+    memcpy(secret + 8, connectionSecret.data4, sizeof(connectionSecret.data4));
+
+    switch (scheme) {
+        case PacketVerificationScheme::SipHash:
+            // the secret is the key of a MAC over the packet payload
+            sipHash128(secret, packet.getData() + offset, packet.getDataSize() - offset, reinterpret_cast<uint8_t*>(hashOut));
+            break;
+
+        case PacketVerificationScheme::MD5: {
+            // the packet payload followed by the connection secret
+            QCryptographicHash hash(QCryptographicHash::Md5);
+            hash.addData(packet.getData() + offset, packet.getDataSize() - offset);
+            hash.addData(reinterpret_cast<const char*>(secret), NUM_BYTES_RFC4122_UUID);
+            memcpy(hashOut, hash.result().constData(), NUM_BYTES_PACKET_HASH);
+            break;
+        }
+    }
 }
 
-QByteArray NLPacket::hashForPacketAndSecret(const udt::Packet& packet, const QUuid& connectionSecret) {
-    QCryptographicHash hash(QCryptographicHash::Md5);
-    
+bool NLPacket::verifyHashForPacketAndSecret(const udt::Packet& packet, const QUuid& connectionSecret,
+                                            PacketVerificationScheme scheme) {
     int offset = Packet::totalHeaderSize(packet.isPartOfMessage()) + sizeof(PacketType) + sizeof(PacketVersion)
-        + NUM_BYTES_RFC4122_UUID + NUM_BYTES_MD5_HASH;
-    
-    // add the packet payload and the connection UUID
-    hash.addData(packet.getData() + offset, packet.getDataSize() - offset);
-    hash.addData(connectionSecret.toRfc4122());
-    
-    // return the hash
-    return hash.result();
+        + NUM_BYTES_RFC4122_UUID;
+
+    char expectedHash[NUM_BYTES_PACKET_HASH];
+    hashForPacketAndSecret(packet, connectionSecret, expectedHash, scheme);
+    return memcmp(packet.getData() + offset, expectedHash, NUM_BYTES_PACKET_HASH) == 0;
 }
 
 void NLPacket::writeTypeAndVersion() {
@@ -217,7 +241,5 @@ void NLPacket::writeVerificationHashGivenSecret(const QUuid& connectionSecret) c
     
     auto offset = Packet::totalHeaderSize(isPartOfMessage()) + sizeof(PacketType) + sizeof(PacketVersion)
                 + NUM_BYTES_RFC4122_UUID;
-    QByteArray verificationHash = hashForPacketAndSecret(*this, connectionSecret);
-    
-    memcpy(_packet.get() + offset, verificationHash.data(), verificationHash.size());
+    hashForPacketAndSecret(*this, connectionSecret, _packet.get() + offset);
 }
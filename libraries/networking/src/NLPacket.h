@@ -35,7 +35,7 @@ public:
     // this is used by the Octree classes - must be known at compile time
     static const int MAX_PACKET_HEADER_SIZE =
         sizeof(udt::Packet::SequenceNumberAndBitField) + sizeof(udt::Packet::MessageNumberAndBitField) +
-        sizeof(PacketType) + sizeof(PacketVersion) + NUM_BYTES_RFC4122_UUID + NUM_BYTES_MD5_HASH;
+        sizeof(PacketType) + sizeof(PacketVersion) + NUM_BYTES_RFC4122_UUID + NUM_BYTES_PACKET_HASH;
     
     static std::unique_ptr<NLPacket> create(PacketType type, qint64 size = -1,
                     bool isReliable = false, bool isPartOfMessage = false, PacketVersion version = 0);
@@ -58,8 +58,12 @@ public:
     static PacketVersion versionInHeader(const udt::Packet& packet);
     
     static QUuid sourceIDInHeader(const udt::Packet& packet);
-    static QByteArray verificationHashInHeader(const udt::Packet& packet);
-    static QByteArray hashForPacketAndSecret(const udt::Packet& packet, const QUuid& connectionSecret);
+    // writes the NUM_BYTES_PACKET_HASH byte hash of the packet payload and the connection secret to hashOut
+    static void hashForPacketAndSecret(const udt::Packet& packet, const QUuid& connectionSecret, char* hashOut,
+                                       PacketVerificationScheme scheme = PACKET_VERIFICATION_SCHEME);
+    // checks the hash in the header against the one for the connection secret, without allocating
+    static bool verifyHashForPacketAndSecret(const udt::Packet& packet, const QUuid& connectionSecret,
+                                             PacketVerificationScheme scheme = PACKET_VERIFICATION_SCHEME);
     
     PacketType getType() const { return _type; }
     void setType(PacketType type);
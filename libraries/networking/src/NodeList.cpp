@@ -159,6 +159,22 @@ qint64 NodeList::sendStatsToDomainServer(QJsonObject statsObject) {
     return sendStats(statsObject, _domainHandler.getSockAddr());
 }
 
+void NodeList::sendTraceToDomainServer(QByteArray compressedTrace, QString reason) {
+    if (thread() != QThread::currentThread()) {
+        QMetaObject::invokeMethod(this, "sendTraceToDomainServer", Qt::QueuedConnection,
+                                  Q_ARG(QByteArray, compressedTrace),
+                                  Q_ARG(QString, reason));
+        return;
+    }
+
+    auto tracePacketList = NLPacketList::create(PacketType::TraceDump, QByteArray(), true, true);
+    tracePacketList->writeString(reason);
+    tracePacketList->write(compressedTrace);
+
+    // signed with the UUID we connected with, which only the domain-server that assigned us knows
+    sendPacketList(std::move(tracePacketList), _domainHandler.getSockAddr(), _domainHandler.getAssignmentUUID());
+}
+
 void NodeList::timePingReply(ReceivedMessage& message, const SharedNodePointer& sendingNode) {
     PingType_t pingType;
     
@@ -238,6 +254,7 @@ void NodeList::reset() {
     LimitedNodeList::reset();
 
     _numNoReplyDomainCheckIns = 0;
+    _domainListVersion = 0;
 
     // lock and clear our set of radius ignored IDs
     _radiusIgnoredSetLock.lockForWrite();
@@ -392,7 +409,10 @@ void NodeList::sendDomainServerCheckIn() {
         packetStream << _ownerType.load() << _publicSockAddr << _localSockAddr << _nodeTypesOfInterest.toList();
         packetStream << DependencyManager::get<AddressManager>()->getPlaceName();
 
-        if (!_domainHandler.isConnected()) {
+        if (_domainHandler.isConnected()) {
+            // let the domain-server know which domain list we have so it only sends what changed
+            packetStream << _domainListVersion;
+        } else {
             DataServerAccountInfo& accountInfo = accountManager->getAccountInfo();
             packetStream << accountInfo.getUsername();
 
@@ -621,10 +641,36 @@ void NodeList::processDomainServerList(QSharedPointer<ReceivedMessage> message)
     packetStream >> newPermissions;
     setPermissions(newPermissions);
 
+    quint32 domainListVersion;
+    bool isDelta;
+    packetStream >> domainListVersion >> isDelta;
+
+    // a delta only has the nodes that changed since our version, along with the ones that are gone
+    if (isDelta) {
+        QList<QUuid> removedNodes;
+        packetStream >> removedNodes;
+        for (const auto& nodeID : removedNodes) {
+            killNodeWithUUID(nodeID);
+        }
+    }
+
     // pull each node in the packet
     while (packetStream.device()->pos() < message->getSize()) {
         parseNodeFromPacketStream(packetStream);
     }
+
+    _domainListVersion = domainListVersion;
+}
+
+void NodeList::removeSilentNodes() {
+    auto numNodes = size();
+
+    LimitedNodeList::removeSilentNodes();
+
+    // a delta would not bring back nodes we dropped ourselves, ask for a full list instead
+    if (size() < numNodes) {
+        _domainListVersion = 0;
+    }
 }
 
 void NodeList::processDomainServerAddedNode(QSharedPointer<ReceivedMessage> message) {
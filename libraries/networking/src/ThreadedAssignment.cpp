@@ -11,15 +11,29 @@
 
 #include <QtCore/QCoreApplication>
 #include <QtCore/QJsonObject>
+#include <QtCore/QRunnable>
 #include <QtCore/QThread>
 #include <QtCore/QTimer>
 
+#include <Gzip.h>
 #include <LogHandler.h>
+#include <SharedUtil.h>
+#include <Trace.h>
 
 #include "ThreadedAssignment.h"
 
 #include "NetworkLogging.h"
 
+static const double DEFAULT_TRACE_WINDOW_SECONDS = 10.0;
+
+class TraceCaptureRunnable : public QRunnable {
+public:
+    TraceCaptureRunnable(std::function<void()> function) : _function(function) {}
+    void run() override { _function(); }
+private:
+    std::function<void()> _function;
+};
+
 ThreadedAssignment::ThreadedAssignment(ReceivedMessage& message) :
     Assignment(message),
     _isFinished(false),
@@ -36,6 +50,12 @@ ThreadedAssignment::ThreadedAssignment(ReceivedMessage& message) :
     // if the NL tells us we got a DS response, clear our member variable of queued check-ins
     auto nodeList = DependencyManager::get<NodeList>();
     connect(nodeList.data(), &NodeList::receivedDomainServerList, this, &ThreadedAssignment::clearQueuedCheckIns);
+
+    // connected before the subclasses connect their start to the same signal, since that may never return
+    connect(&nodeList->getDomainHandler(), &DomainHandler::settingsReceived, this, &ThreadedAssignment::parseTracingSettings);
+
+    // traces are written out one at a time, off the assignment thread
+    _traceThreadPool.setMaxThreadCount(1);
 }
 
 void ThreadedAssignment::setFinished(bool isFinished) {
@@ -63,6 +83,8 @@ void ThreadedAssignment::setFinished(bool isFinished) {
             _domainServerTimer.stop();
             _statsTimer.stop();
 
+            stopTracing();
+
             // call our virtual aboutToFinish method - this gives the ThreadedAssignment subclass a chance to cleanup
             aboutToFinish();
 
@@ -78,6 +100,9 @@ void ThreadedAssignment::commonInit(const QString& targetName, NodeType_t nodeTy
     auto nodeList = DependencyManager::get<NodeList>();
     nodeList->setOwnerType(nodeType);
 
+    // the domain-server can ask for the rolling trace at any time
+    nodeList->getPacketReceiver().registerListener(PacketType::TraceDumpRequest, this, "handleTraceDumpRequestPacket");
+
     // send a domain-server check in immediately and start the timer to fire them every DOMAIN_SERVER_CHECK_IN_MSECS
     checkInWithDomainServerOrExit();
     _domainServerTimer.start();
@@ -132,3 +157,80 @@ void ThreadedAssignment::domainSettingsRequestFailed() {
     qCDebug(networking) << "Failed to retreive settings object from domain-server. Bailing on assignment.";
     setFinished(true);
 }
+
+void ThreadedAssignment::parseTracingSettings(const QJsonObject& settingsObject) {
+    auto tracer = DependencyManager::get<tracing::Tracer>();
+    if (!tracer) {
+        return;
+    }
+
+    const QString TRACING_SETTINGS_KEY = "tracing";
+    QJsonObject tracingGroupObject = settingsObject[TRACING_SETTINGS_KEY].toObject();
+
+    const QString WINDOW_SECONDS_KEY = "window_seconds";
+    bool ok;
+    double windowSeconds = tracingGroupObject[WINDOW_SECONDS_KEY].toVariant().toDouble(&ok);
+    if (!ok || windowSeconds <= 0.0) {
+        windowSeconds = DEFAULT_TRACE_WINDOW_SECONDS;
+    }
+    tracer->setRollingWindow((uint64_t)(windowSeconds * USECS_PER_SECOND));
+
+    const QString ROLLING_TRACE_KEY = "rolling_trace";
+    bool rollingTrace = tracingGroupObject[ROLLING_TRACE_KEY].toBool(true);
+    if (rollingTrace && !_isTracing && !tracer->isEnabled()) {
+        qCDebug(networking) << "Keeping a rolling trace of the last" << windowSeconds << "seconds";
+        tracer->startTracing();
+        _isTracing = true;
+    } else if (!rollingTrace) {
+        stopTracing();
+    }
+}
+
+void ThreadedAssignment::stopTracing() {
+    if (_isTracing) {
+        DependencyManager::get<tracing::Tracer>()->stopTracing();
+        _isTracing = false;
+    }
+}
+
+void ThreadedAssignment::captureTrace(const QString& reason, bool isAutomatic) {
+    if (!_isTracing) {
+        return;
+    }
+
+    auto tracer = DependencyManager::get<tracing::Tracer>();
+    auto now = usecTimestampNow();
+    if (isAutomatic && now - _lastTraceCaptureTime < tracer->getRollingWindow()) {
+        // the last capture already covers most of this window
+        return;
+    }
+
+    bool isCapturing = false;
+    if (!_isCapturingTrace.compare_exchange_strong(isCapturing, true)) {
+        return;
+    }
+    _lastTraceCaptureTime = now;
+
+    qCDebug(networking) << "Capturing the rolling trace:" << reason;
+    _traceThreadPool.start(new TraceCaptureRunnable([this, tracer, reason] {
+        QByteArray compressedTrace;
+        gzip(tracer->snapshot(), compressedTrace);
+        DependencyManager::get<NodeList>()->sendTraceToDomainServer(compressedTrace, reason);
+        _isCapturingTrace = false;
+    }));
+}
+
+void ThreadedAssignment::handleTraceDumpRequestPacket(QSharedPointer<ReceivedMessage> message) {
+    auto nodeList = DependencyManager::get<NodeList>();
+    if (message->getSenderSockAddr() != nodeList->getDomainHandler().getSockAddr()) {
+        qCWarning(networking) << "Ignoring a trace request from" << message->getSenderSockAddr() << "- it is not our domain-server";
+        return;
+    }
+
+    if (!_isTracing) {
+        qCWarning(networking) << "The domain-server requested a trace, but the rolling trace is disabled";
+        return;
+    }
+
+    captureTrace("requested from the domain-server", false);
+}
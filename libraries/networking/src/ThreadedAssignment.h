@@ -12,7 +12,10 @@
 #ifndef hifi_ThreadedAssignment_h
 #define hifi_ThreadedAssignment_h
 
+#include <atomic>
+
 #include <QtCore/QSharedPointer>
+#include <QtCore/QThreadPool>
 
 #include "ReceivedMessage.h"
 
@@ -28,6 +31,10 @@ public:
     virtual void aboutToFinish() { };
     void addPacketStatsAndSendStatsPacket(QJsonObject statsObject);
 
+    // sends the rolling trace to the domain-server, automatic captures are limited to one per trace window
+    void captureTrace(const QString& reason, bool isAutomatic = true);
+    bool isTracing() const { return _isTracing; }
+
 public slots:
     /// threaded run of assignment
     virtual void run() = 0;
@@ -50,6 +57,16 @@ protected slots:
     
 private slots:
     void checkInWithDomainServerOrExit();
+    void parseTracingSettings(const QJsonObject& settingsObject);
+    void handleTraceDumpRequestPacket(QSharedPointer<ReceivedMessage> message);
+
+private:
+    void stopTracing();
+
+    bool _isTracing { false };
+    quint64 _lastTraceCaptureTime { 0 };
+    std::atomic<bool> _isCapturingTrace { false };
+    QThreadPool _traceThreadPool; // last, so that a capture in flight finishes before the rest goes
 };
 
 typedef QSharedPointer<ThreadedAssignment> SharedAssignmentPointer;
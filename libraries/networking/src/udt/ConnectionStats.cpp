@@ -11,9 +11,59 @@
 
 #include "ConnectionStats.h"
 
+#include <Metrics.h>
+#include <NumericalConstants.h>
+
 using namespace udt;
 using namespace std::chrono;
 
+namespace {
+
+// totals across all the connections of the process
+struct ConnectionMetrics {
+    ConnectionMetrics() {
+        static const char* EVENT_NAMES[ConnectionStats::Stats::NumEvents] = {
+            "sent_ack", "received_ack", "processed_ack", "sent_light_ack", "received_light_ack", "sent_ack2",
+            "received_ack2", "sent_nak", "received_nak", "sent_timeout_nak", "received_timeout_nak",
+            "retransmission", "duplicate"
+        };
+        auto& registry = metrics::Registry::getInstance();
+        for (int i = 0; i < ConnectionStats::Stats::NumEvents; ++i) {
+            events[i] = &registry.counter("hifi_udt_events_total", "Reliable connection control events",
+                                          { { "event", EVENT_NAMES[i] } });
+        }
+        for (int i = 0; i < NumReliabilities; ++i) {
+            metrics::Labels labels { { "reliability", i == Reliable ? "reliable" : "unreliable" } };
+            sentPackets[i] = &registry.counter("hifi_udt_sent_packets_total", "Packets sent on connections", labels);
+            receivedPackets[i] = &registry.counter("hifi_udt_received_packets_total", "Packets received on connections", labels);
+            sentBytes[i] = &registry.counter("hifi_udt_sent_bytes_total", "Bytes sent on connections, with headers", labels);
+            receivedBytes[i] = &registry.counter("hifi_udt_received_bytes_total", "Bytes received on connections, with headers", labels);
+        }
+        rtt = &registry.histogram("hifi_udt_rtt_seconds", "Round trip time samples of connections",
+                                  metrics::Histogram::exponentialBounds(0.005, 2.0, 10));
+    }
+
+    enum Reliability {
+        Reliable = 0,
+        Unreliable,
+        NumReliabilities
+    };
+
+    metrics::Counter* events[ConnectionStats::Stats::NumEvents];
+    metrics::Counter* sentPackets[NumReliabilities];
+    metrics::Counter* receivedPackets[NumReliabilities];
+    metrics::Counter* sentBytes[NumReliabilities];
+    metrics::Counter* receivedBytes[NumReliabilities];
+    metrics::Histogram* rtt;
+};
+
+ConnectionMetrics& getMetrics() {
+    static ConnectionMetrics connectionMetrics;
+    return connectionMetrics;
+}
+
+}
+
 ConnectionStats::ConnectionStats() {
     auto now = duration_cast<microseconds>(system_clock::now().time_since_epoch());
     _currentSample.startTime = now;
@@ -34,6 +84,8 @@ ConnectionStats::Stats ConnectionStats::sample() {
 void ConnectionStats::record(Stats::Event event) {
     ++_currentSample.events[(int) event];
     ++_total.events[(int) event];
+
+    getMetrics().events[(int) event]->increment();
 }
 
 void ConnectionStats::recordSentPackets(int payload, int total) {
@@ -45,6 +97,10 @@ void ConnectionStats::recordSentPackets(int payload, int total) {
     
     _currentSample.sentBytes += total;
     _total.sentBytes += total;
+
+    auto& connectionMetrics = getMetrics();
+    connectionMetrics.sentPackets[ConnectionMetrics::Reliable]->increment();
+    connectionMetrics.sentBytes[ConnectionMetrics::Reliable]->increment(total);
 }
 
 void ConnectionStats::recordReceivedPackets(int payload, int total) {
@@ -56,6 +112,10 @@ void ConnectionStats::recordReceivedPackets(int payload, int total) {
     
     _currentSample.receivedBytes += total;
     _total.receivedBytes += total;
+
+    auto& connectionMetrics = getMetrics();
+    connectionMetrics.receivedPackets[ConnectionMetrics::Reliable]->increment();
+    connectionMetrics.receivedBytes[ConnectionMetrics::Reliable]->increment(total);
 }
 
 void ConnectionStats::recordUnreliableSentPackets(int payload, int total) {
@@ -67,6 +127,10 @@ void ConnectionStats::recordUnreliableSentPackets(int payload, int total) {
     
     _currentSample.sentUnreliableBytes += total;
     _total.sentUnreliableBytes += total;
+
+    auto& connectionMetrics = getMetrics();
+    connectionMetrics.sentPackets[ConnectionMetrics::Unreliable]->increment();
+    connectionMetrics.sentBytes[ConnectionMetrics::Unreliable]->increment(total);
 }
 
 void ConnectionStats::recordUnreliableReceivedPackets(int payload, int total) {
@@ -78,6 +142,10 @@ void ConnectionStats::recordUnreliableReceivedPackets(int payload, int total) {
     
     _currentSample.sentUnreliableBytes += total;
     _total.receivedUnreliableBytes += total;
+
+    auto& connectionMetrics = getMetrics();
+    connectionMetrics.receivedPackets[ConnectionMetrics::Unreliable]->increment();
+    connectionMetrics.receivedBytes[ConnectionMetrics::Unreliable]->increment(total);
 }
 
 static const double EWMA_CURRENT_SAMPLE_WEIGHT = 0.125;
@@ -101,6 +169,8 @@ void ConnectionStats::recordEstimatedBandwidth(int sample) {
 void ConnectionStats::recordRTT(int sample) {
     _currentSample.rtt = sample;
     _total.rtt = (int)((_total.rtt * EWMA_PREVIOUS_SAMPLES_WEIGHT) + (sample * EWMA_CURRENT_SAMPLE_WEIGHT));
+
+    getMetrics().rtt->record((double)sample / USECS_PER_SECOND);
 }
 
 void ConnectionStats::recordCongestionWindowSize(int sample) {
@@ -113,13 +113,23 @@ public:
         EntityPhysics,
         EntityServerScriptLog,
         AdjustAvatarSorting,
-        LAST_PACKET_TYPE = AdjustAvatarSorting
+        TraceDumpRequest,
+        TraceDump,
+        LAST_PACKET_TYPE = TraceDump
     };
 };
 
 using PacketType = PacketTypeEnum::Value;
 
-const int NUM_BYTES_MD5_HASH = 16;
+// how sourced packets are signed with the connection secret, part of the protocol signature so that
+// nodes with another scheme are refused at connect time
+enum class PacketVerificationScheme : uint8_t {
+    MD5 = 0,
+    SipHash
+};
+const PacketVerificationScheme PACKET_VERIFICATION_SCHEME = PacketVerificationScheme::SipHash;
+
+const int NUM_BYTES_PACKET_HASH = 16;
 
 typedef char PacketVersion;
 
@@ -228,7 +238,8 @@ enum class AvatarMixerPacketVersion : PacketVersion {
     Unignore,
     ImmediateSessionDisplayNameUpdates,
     VariableAvatarData,
-    AvatarAsChildFixes
+    AvatarAsChildFixes,
+    SizedAvatarDataSections
 };
 
 enum class DomainConnectRequestVersion : PacketVersion {
@@ -254,7 +265,13 @@ enum class DomainListVersion : PacketVersion {
     PrePermissionsGrid = 18,
     PermissionsGrid,
     GetUsernameFromUUIDSupport,
-    GetMachineFingerprintFromUUIDSupport
+    GetMachineFingerprintFromUUIDSupport,
+    DeltaUpdates
+};
+
+enum class DomainListRequestVersion : PacketVersion {
+    PreDomainListVersion = 17,
+    HasDomainListVersion
 };
 
 enum class AudioVersion : PacketVersion {
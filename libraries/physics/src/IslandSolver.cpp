@@ -0,0 +1,55 @@
+//
+//  IslandSolver.cpp
+//  libraries/physics/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "IslandSolver.h"
+
+void IslandSolver::addIsland(btCollisionObject** bodies, int numBodies, btPersistentManifold** manifolds, int numManifolds,
+                             btTypedConstraint** constraints, int numConstraints) {
+    for (int i = 0; i < numBodies; ++i) {
+        _bodies.push_back(bodies[i]);
+    }
+    for (int i = 0; i < numManifolds; ++i) {
+        _manifolds.push_back(manifolds[i]);
+    }
+    for (int i = 0; i < numConstraints; ++i) {
+        _constraints.push_back(constraints[i]);
+    }
+    // each manifold holds up to 4 contacts, constraints have up to 6 rows
+    const int COST_PER_MANIFOLD = 4;
+    const int COST_PER_CONSTRAINT = 6;
+    _cost += numBodies + COST_PER_MANIFOLD * numManifolds + COST_PER_CONSTRAINT * numConstraints;
+}
+
+void IslandSolver::clear() {
+    _bodies.resize(0);
+    _manifolds.resize(0);
+    _constraints.resize(0);
+    _cost = 0;
+}
+
+void IslandSolver::setup(const btContactSolverInfo& info, btIDebugDraw* debugDrawer) {
+    solveGroupCacheFriendlySetup(getBodies(), _bodies.size(), getManifolds(), _manifolds.size(),
+                                 getConstraints(), _constraints.size(), info, debugDrawer);
+}
+
+void IslandSolver::iterate(const btContactSolverInfo& info) {
+    // same as solveGroupCacheFriendlyIterations(), without the profiler
+    solveGroupCacheFriendlySplitImpulseIterations(getBodies(), _bodies.size(), getManifolds(), _manifolds.size(),
+                                                  getConstraints(), _constraints.size(), info, nullptr);
+    int maxIterations = m_maxOverrideNumSolverIterations > info.m_numIterations ? m_maxOverrideNumSolverIterations : info.m_numIterations;
+    for (int iteration = 0; iteration < maxIterations; ++iteration) {
+        solveSingleIteration(iteration, getBodies(), _bodies.size(), getManifolds(), _manifolds.size(),
+                             getConstraints(), _constraints.size(), info, nullptr);
+    }
+}
+
+void IslandSolver::finish(const btContactSolverInfo& info) {
+    solveGroupCacheFriendlyFinish(getBodies(), _bodies.size(), info);
+}
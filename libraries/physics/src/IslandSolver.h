@@ -0,0 +1,51 @@
+//
+//  IslandSolver.h
+//  libraries/physics/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_IslandSolver_h
+#define hifi_IslandSolver_h
+
+#include <BulletDynamics/ConstraintSolver/btSequentialImpulseConstraintSolver.h>
+
+// A btSequentialImpulseConstraintSolver for a set of simulation islands, split into its setup, iteration
+// and finish phases so that the iterations of several solvers can run on different threads.
+//
+// Solvers must not share dynamic bodies, and only one of them may touch kinematic bodies (Bullet stores
+// the solver index of kinematic bodies in the body itself).  Bullet's profiler is not thread safe, so
+// setup() and finish() must be called on the simulation thread. iterate() doesn't use the profiler.
+
+ATTRIBUTE_ALIGNED16(class) IslandSolver : public btSequentialImpulseConstraintSolver {
+public:
+    BT_DECLARE_ALIGNED_ALLOCATOR();
+
+    void addIsland(btCollisionObject** bodies, int numBodies, btPersistentManifold** manifolds, int numManifolds,
+                   btTypedConstraint** constraints, int numConstraints);
+    void clear();
+
+    bool isEmpty() const { return _bodies.size() == 0; }
+
+    // rough measure of the iteration cost of the islands added so far
+    int getCost() const { return _cost; }
+
+    void setup(const btContactSolverInfo& info, btIDebugDraw* debugDrawer);
+    void iterate(const btContactSolverInfo& info);
+    void finish(const btContactSolverInfo& info);
+
+private:
+    btCollisionObject** getBodies() { return _bodies.size() > 0 ? &_bodies[0] : nullptr; }
+    btPersistentManifold** getManifolds() { return _manifolds.size() > 0 ? &_manifolds[0] : nullptr; }
+    btTypedConstraint** getConstraints() { return _constraints.size() > 0 ? &_constraints[0] : nullptr; }
+
+    btAlignedObjectArray<btCollisionObject*> _bodies;
+    btAlignedObjectArray<btPersistentManifold*> _manifolds;
+    btAlignedObjectArray<btTypedConstraint*> _constraints;
+    int _cost { 0 };
+};
+
+#endif // hifi_IslandSolver_h
@@ -225,17 +225,23 @@ void PhysicsEngine::reinsertObject(ObjectMotionState* object) {
 
 void PhysicsEngine::removeContacts(ObjectMotionState* motionState) {
     // trigger events for new/existing/old contacts
-    ContactMap::iterator contactItr = _contactMap.begin();
-    while (contactItr != _contactMap.end()) {
-        if (contactItr->first._a == motionState || contactItr->first._b == motionState) {
-            contactItr = _contactMap.erase(contactItr);
-        } else {
-            ++contactItr;
+    // (walk backwards: removal moves the last contact into the removed slot)
+    for (int i = _contactMap.size() - 1; i >= 0; --i) {
+        ContactKey key = _contactMap.getKeyAtIndex(i);
+        if (key._a == motionState || key._b == motionState) {
+            _contactMap.remove(key);
         }
     }
 }
 
 void PhysicsEngine::stepSimulation() {
+    const float MAX_TIMESTEP = (float)PHYSICS_ENGINE_MAX_NUM_SUBSTEPS * PHYSICS_ENGINE_FIXED_SUBSTEP;
+    float dt = 1.0e-6f * (float)(_clock.getTimeMicroseconds());
+    _clock.reset();
+    stepSimulation(btMin(dt, MAX_TIMESTEP));
+}
+
+void PhysicsEngine::stepSimulation(float timeStep) {
     CProfileManager::Reset();
     BT_PROFILE("stepSimulation");
     // NOTE: the grand order of operations is:
@@ -244,11 +250,6 @@ void PhysicsEngine::stepSimulation() {
     // (3) synchronize outgoing motion states
     // (4) send outgoing packets
 
-    const float MAX_TIMESTEP = (float)PHYSICS_ENGINE_MAX_NUM_SUBSTEPS * PHYSICS_ENGINE_FIXED_SUBSTEP;
-    float dt = 1.0e-6f * (float)(_clock.getTimeMicroseconds());
-    _clock.reset();
-    float timeStep = btMin(dt, MAX_TIMESTEP);
-
     if (_myAvatarController) {
         BT_PROFILE("avatarController");
         // TODO: move this stuff outside and in front of stepSimulation, because
@@ -382,7 +383,13 @@ void PhysicsEngine::updateContactMap() {
             ObjectMotionState* b = static_cast<ObjectMotionState*>(objectB->getUserPointer());
             if (a || b) {
                 // the manifold has up to 4 distinct points, but only extract info from the first
-                _contactMap[ContactKey(a, b)].update(_numContactFrames, contactManifold->getContactPoint(0));
+                ContactKey key(a, b);
+                ContactInfo* contact = _contactMap.find(key);
+                if (!contact) {
+                    _contactMap.insert(key, ContactInfo());
+                    contact = _contactMap.find(key);
+                }
+                contact->update(_numContactFrames, contactManifold->getContactPoint(0));
             }
 
             if (!Physics::getSessionUUID().isNull()) {
@@ -396,17 +403,17 @@ const CollisionEvents& PhysicsEngine::getCollisionEvents() {
     _collisionEvents.clear();
 
     // scan known contacts and trigger events
-    ContactMap::iterator contactItr = _contactMap.begin();
-
-    while (contactItr != _contactMap.end()) {
-        ContactInfo& contact = contactItr->second;
+    // (walk backwards: removal moves the last contact into the removed slot)
+    for (int i = _contactMap.size() - 1; i >= 0; --i) {
+        ContactKey key = _contactMap.getKeyAtIndex(i);
+        ContactInfo& contact = *_contactMap.getAtIndex(i);
         ContactEventType type = contact.computeType(_numContactFrames);
         const btScalar SIGNIFICANT_DEPTH = -0.002f; // penetrations have negative distance
         if (type != CONTACT_EVENT_TYPE_CONTINUE ||
                 (contact.distance < SIGNIFICANT_DEPTH &&
                  contact.readyForContinue(_numContactFrames))) {
-            ObjectMotionState* motionStateA = static_cast<ObjectMotionState*>(contactItr->first._a);
-            ObjectMotionState* motionStateB = static_cast<ObjectMotionState*>(contactItr->first._b);
+            ObjectMotionState* motionStateA = static_cast<ObjectMotionState*>(key._a);
+            ObjectMotionState* motionStateB = static_cast<ObjectMotionState*>(key._b);
 
             // NOTE: the MyAvatar RigidBody is the only object in the simulation that does NOT have a MotionState
             // which means should we ever want to report ALL collision events against the avatar we can
@@ -441,9 +448,7 @@ const CollisionEvents& PhysicsEngine::getCollisionEvents() {
         }
 
         if (type == CONTACT_EVENT_TYPE_END) {
-            contactItr = _contactMap.erase(contactItr);
-        } else {
-            ++contactItr;
+            _contactMap.remove(key);
         }
     }
     return _collisionEvents;
@@ -462,6 +467,12 @@ const VectorOfMotionStates& PhysicsEngine::getOutgoingChanges() {
     return _dynamicsWorld->getChangedMotionStates();
 }
 
+void PhysicsEngine::setNumSolverThreads(int numThreads) {
+    if (_dynamicsWorld) {
+        _dynamicsWorld->setNumSolverThreads(numThreads);
+    }
+}
+
 void PhysicsEngine::dumpStatsIfNecessary() {
     if (_dumpNextStats) {
         _dumpNextStats = false;
@@ -18,6 +18,7 @@
 #include <QUuid>
 #include <btBulletDynamicsCommon.h>
 #include <BulletCollision/CollisionDispatch/btGhostObject.h>
+#include <LinearMath/btHashMap.h>
 
 #include "BulletUtil.h"
 #include "ContactInfo.h"
@@ -36,11 +37,23 @@ public:
     ContactKey(void* a, void* b) : _a(a), _b(b) {}
     bool operator<(const ContactKey& other) const { return _a < other._a || (_a == other._a && _b < other._b); }
     bool operator==(const ContactKey& other) const { return _a == other._a && _b == other._b; }
+
+    // for use with btHashMap
+    bool equals(const ContactKey& other) const { return *this == other; }
+    unsigned int getHash() const {
+        // motion states are at least 16 byte aligned
+        uint64_t a = (uint64_t)(uintptr_t)_a >> 4;
+        uint64_t b = (uint64_t)(uintptr_t)_b >> 4;
+        uint64_t hash = (a * 0x9e3779b97f4a7c15ULL) ^ (b + 0x7f4a7c15ULL + (a << 6) + (a >> 2));
+        return (unsigned int)(hash ^ (hash >> 32));
+    }
+
     void* _a; // ObjectMotionState pointer
     void* _b; // ObjectMotionState pointer
 };
 
-typedef std::map<ContactKey, ContactInfo> ContactMap;
+// contacts are stored in flat arrays, so iterating them every substep doesn't chase tree nodes
+typedef btHashMap<ContactKey, ContactInfo> ContactMap;
 typedef std::vector<Collision> CollisionEvents;
 
 class PhysicsEngine {
@@ -59,6 +72,8 @@ public:
     void reinsertObject(ObjectMotionState* object);
 
     void stepSimulation();
+    // step by a fixed amount of time instead of the time since the last step (for tests)
+    void stepSimulation(float timeStep);
     void harvestPerformanceStats();
     void updateContactMap();
 
@@ -83,6 +98,10 @@ public:
 
     void dumpNextStats() { _dumpNextStats = true; }
 
+    /// solve independent groups of touching objects on numThreads threads (1 is single threaded)
+    void setNumSolverThreads(int numThreads);
+    int getNumContacts() const { return _contactMap.size(); }
+
     EntityActionPointer getActionByID(const QUuid& actionID) const;
     void addAction(EntityActionPointer action);
     void removeAction(const QUuid actionID);
@@ -0,0 +1,297 @@
+//
+//  ShapeCache.cpp
+//  libraries/physics/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ShapeCache.h"
+
+#include <algorithm>
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+
+#include "PhysicsLogging.h"
+#include "ShapeFactory.h"
+
+static const quint32 SHAPE_CACHE_MAGIC = 0x48465343; // "HFSC"
+
+// bump whenever ShapeFactory changes how shapes are built, so stale entries are ignored
+static const quint32 SHAPE_CACHE_VERSION = 1;
+
+// guards against corrupt files asking for huge allocations
+static const qint32 MAX_CACHED_ELEMENTS = 1 << 24;
+
+bool ShapeCache::isCacheable(const ShapeInfo& info) {
+    switch (info.getType()) {
+        case SHAPE_TYPE_COMPOUND:
+        case SHAPE_TYPE_SIMPLE_HULL:
+        case SHAPE_TYPE_SIMPLE_COMPOUND:
+        case SHAPE_TYPE_STATIC_MESH:
+            return true;
+        default:
+            return false;
+    }
+}
+
+QByteArray ShapeCache::computeKey(const ShapeInfo& info) {
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    quint32 version = SHAPE_CACHE_VERSION;
+    qint32 type = (qint32)info.getType();
+    hash.addData((const char*)&version, sizeof(version));
+    hash.addData((const char*)&type, sizeof(type));
+    hash.addData((const char*)&info.getHalfExtents(), sizeof(glm::vec3));
+    hash.addData((const char*)&info.getOffset(), sizeof(glm::vec3));
+
+    const ShapeInfo::PointCollection& pointCollection = info.getPointCollection();
+    for (const ShapeInfo::PointList& points : pointCollection) {
+        qint32 numPoints = points.size();
+        hash.addData((const char*)&numPoints, sizeof(numPoints));
+        hash.addData((const char*)points.constData(), numPoints * sizeof(glm::vec3));
+    }
+    const ShapeInfo::TriangleIndices& indices = info.getTriangleIndices();
+    hash.addData((const char*)indices.constData(), indices.size() * sizeof(int32_t));
+    return hash.result().toHex();
+}
+
+ShapeCache::ShapeCache(const QString& directory) : _directory(directory) {
+    QDir().mkpath(_directory);
+}
+
+QString ShapeCache::getPath(const QByteArray& key) const {
+    return _directory + "/" + QString::fromLatin1(key);
+}
+
+// util method
+static void writeTransform(QDataStream& stream, const btTransform& transform) {
+    const btVector3& origin = transform.getOrigin();
+    btQuaternion rotation = transform.getRotation();
+    stream << (float)origin.x() << (float)origin.y() << (float)origin.z();
+    stream << (float)rotation.x() << (float)rotation.y() << (float)rotation.z() << (float)rotation.w();
+}
+
+// util method
+static btTransform readTransform(QDataStream& stream) {
+    float values[7];
+    for (float& value : values) {
+        stream >> value;
+    }
+    return btTransform(btQuaternion(values[3], values[4], values[5], values[6]), btVector3(values[0], values[1], values[2]));
+}
+
+// util method
+static bool writeShape(QDataStream& stream, const btCollisionShape* shape) {
+    qint32 type = shape->getShapeType();
+    stream << type;
+    switch (type) {
+        case CONVEX_HULL_SHAPE_PROXYTYPE: {
+            const btConvexHullShape* hull = static_cast<const btConvexHullShape*>(shape);
+            qint32 numPoints = hull->getNumPoints();
+            stream << (float)hull->getMargin() << numPoints;
+            const btVector3* points = hull->getUnscaledPoints();
+            for (qint32 i = 0; i < numPoints; ++i) {
+                stream << (float)points[i].x() << (float)points[i].y() << (float)points[i].z();
+            }
+            return true;
+        }
+        case COMPOUND_SHAPE_PROXYTYPE: {
+            const btCompoundShape* compound = static_cast<const btCompoundShape*>(shape);
+            qint32 numChildren = compound->getNumChildShapes();
+            stream << numChildren;
+            for (qint32 i = 0; i < numChildren; ++i) {
+                writeTransform(stream, compound->getChildTransform(i));
+                if (!writeShape(stream, compound->getChildShape(i))) {
+                    return false;
+                }
+            }
+            return true;
+        }
+        case TRIANGLE_MESH_SHAPE_PROXYTYPE: {
+            // ShapeFactory only makes StaticMeshShapes, each with a single float mesh
+            auto meshShape = static_cast<const ShapeFactory::StaticMeshShape*>(shape);
+            const btIndexedMesh& mesh = meshShape->getDataArray()->getIndexedMeshArray()[0];
+            if (mesh.m_vertexType != PHY_FLOAT || sizeof(btScalar) != sizeof(float)) {
+                return false;
+            }
+            int indexSize = (mesh.m_indexType == PHY_SHORT) ? sizeof(int16_t) : sizeof(int32_t);
+            stream << (qint32)mesh.m_numVertices << (qint32)mesh.m_numTriangles << (qint32)mesh.m_indexType;
+            stream.writeRawData((const char*)mesh.m_vertexBase, mesh.m_numVertices * 3 * sizeof(float));
+            stream.writeRawData((const char*)mesh.m_triangleIndexBase, mesh.m_numTriangles * 3 * indexSize);
+
+            const btOptimizedBvh* bvh = meshShape->getOptimizedBvh();
+            quint32 bvhSize = bvh ? bvh->calculateSerializeBufferSize() : 0;
+            stream << bvhSize;
+            if (bvhSize > 0) {
+                void* buffer = btAlignedAlloc(bvhSize, 16);
+                bvh->serializeInPlace(buffer, bvhSize, false);
+                stream.writeRawData((const char*)buffer, bvhSize);
+                btAlignedFree(buffer);
+            }
+            return true;
+        }
+        default:
+            // primitives are cheap to build and not worth caching
+            return false;
+    }
+}
+
+// util method
+static btCollisionShape* readShape(QDataStream& stream) {
+    qint32 type;
+    stream >> type;
+    if (stream.status() != QDataStream::Ok) {
+        return nullptr;
+    }
+    switch (type) {
+        case CONVEX_HULL_SHAPE_PROXYTYPE: {
+            float margin;
+            qint32 numPoints;
+            stream >> margin >> numPoints;
+            if (numPoints <= 0 || numPoints > MAX_CACHED_ELEMENTS) {
+                return nullptr;
+            }
+            btConvexHullShape* hull = new btConvexHullShape();
+            hull->setMargin(margin);
+            for (qint32 i = 0; i < numPoints; ++i) {
+                float x, y, z;
+                stream >> x >> y >> z;
+                hull->addPoint(btVector3(x, y, z), false);
+            }
+            hull->recalcLocalAabb();
+            if (stream.status() != QDataStream::Ok) {
+                delete hull;
+                return nullptr;
+            }
+            return hull;
+        }
+        case COMPOUND_SHAPE_PROXYTYPE: {
+            qint32 numChildren;
+            stream >> numChildren;
+            if (numChildren <= 0 || numChildren > MAX_CACHED_ELEMENTS) {
+                return nullptr;
+            }
+            btCompoundShape* compound = new btCompoundShape();
+            for (qint32 i = 0; i < numChildren; ++i) {
+                btTransform transform = readTransform(stream);
+                btCollisionShape* child = readShape(stream);
+                if (!child) {
+                    ShapeFactory::deleteShape(compound);
+                    return nullptr;
+                }
+                compound->addChildShape(transform, child);
+            }
+            return compound;
+        }
+        case TRIANGLE_MESH_SHAPE_PROXYTYPE: {
+            qint32 numVertices, numTriangles, indexType;
+            stream >> numVertices >> numTriangles >> indexType;
+            if (numVertices <= 0 || numVertices > MAX_CACHED_ELEMENTS ||
+                    numTriangles <= 0 || numTriangles > MAX_CACHED_ELEMENTS ||
+                    (indexType != PHY_SHORT && indexType != PHY_INTEGER)) {
+                return nullptr;
+            }
+
+            // same layout as ShapeFactory's createStaticMeshArray(), so StaticMeshShape can delete it
+            const int32_t VERTICES_PER_TRIANGLE = 3;
+            int indexSize = (indexType == PHY_SHORT) ? sizeof(int16_t) : sizeof(int32_t);
+            btIndexedMesh mesh;
+            mesh.m_numTriangles = numTriangles;
+            mesh.m_indexType = (PHY_ScalarType)indexType;
+            mesh.m_triangleIndexStride = VERTICES_PER_TRIANGLE * indexSize;
+            mesh.m_triangleIndexBase = new unsigned char[(size_t)numTriangles * mesh.m_triangleIndexStride];
+            mesh.m_numVertices = numVertices;
+            mesh.m_vertexType = PHY_FLOAT;
+            mesh.m_vertexStride = VERTICES_PER_TRIANGLE * sizeof(float);
+            mesh.m_vertexBase = new unsigned char[(size_t)numVertices * mesh.m_vertexStride];
+            stream.readRawData((char*)mesh.m_vertexBase, numVertices * mesh.m_vertexStride);
+            stream.readRawData((char*)mesh.m_triangleIndexBase, numTriangles * mesh.m_triangleIndexStride);
+
+            quint32 bvhSize;
+            stream >> bvhSize;
+            void* bvhBuffer = nullptr;
+            if (stream.status() == QDataStream::Ok && bvhSize > 0 && bvhSize <= (quint32)MAX_CACHED_ELEMENTS * 16) {
+                bvhBuffer = btAlignedAlloc(bvhSize, 16);
+                stream.readRawData((char*)bvhBuffer, bvhSize);
+            }
+            if (stream.status() != QDataStream::Ok) {
+                delete [] mesh.m_vertexBase;
+                delete [] mesh.m_triangleIndexBase;
+                if (bvhBuffer) {
+                    btAlignedFree(bvhBuffer);
+                }
+                return nullptr;
+            }
+
+            btTriangleIndexVertexArray* dataArray = new btTriangleIndexVertexArray;
+            dataArray->addIndexedMesh(mesh, mesh.m_indexType);
+            btOptimizedBvh* bvh = bvhBuffer ? btOptimizedBvh::deSerializeInPlace(bvhBuffer, bvhSize, false) : nullptr;
+            if (!bvh) {
+                // no usable bvh: build a new one
+                if (bvhBuffer) {
+                    btAlignedFree(bvhBuffer);
+                }
+                return new ShapeFactory::StaticMeshShape(dataArray);
+            }
+            return new ShapeFactory::StaticMeshShape(dataArray, bvh, bvhBuffer);
+        }
+        default:
+            return nullptr;
+    }
+}
+
+btCollisionShape* ShapeCache::load(const QByteArray& key) const {
+    QFile file(getPath(key));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return nullptr;
+    }
+    QDataStream stream(&file);
+    stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
+
+    quint32 magic, version;
+    stream >> magic >> version;
+    if (magic != SHAPE_CACHE_MAGIC || version != SHAPE_CACHE_VERSION) {
+        return nullptr;
+    }
+    btCollisionShape* shape = readShape(stream);
+    if (!shape) {
+        qCWarning(physics) << "ShapeCache: ignoring invalid entry" << file.fileName();
+    }
+    return shape;
+}
+
+bool ShapeCache::save(const QByteArray& key, const btCollisionShape* shape) const {
+    QSaveFile file(getPath(key));
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    QDataStream stream(&file);
+    stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
+    stream << SHAPE_CACHE_MAGIC << SHAPE_CACHE_VERSION;
+    if (!writeShape(stream, shape) || stream.status() != QDataStream::Ok) {
+        file.cancelWriting();
+        return false;
+    }
+    return file.commit();
+}
+
+void ShapeCache::trim(qint64 maxSize) const {
+    QFileInfoList entries = QDir(_directory).entryInfoList(QDir::Files, QDir::Time);
+    qint64 totalSize = 0;
+    for (const QFileInfo& entry : entries) {
+        totalSize += entry.size();
+    }
+    // entries are sorted newest first
+    while (totalSize > maxSize && !entries.isEmpty()) {
+        QFileInfo oldest = entries.takeLast();
+        totalSize -= oldest.size();
+        QFile::remove(oldest.filePath());
+    }
+}
@@ -0,0 +1,54 @@
+//
+//  ShapeCache.h
+//  libraries/physics/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ShapeCache_h
+#define hifi_ShapeCache_h
+
+#include <btBulletDynamicsCommon.h>
+
+#include <QByteArray>
+#include <QString>
+
+#include <ShapeInfo.h>
+
+// Disk cache of built convex hulls and static meshes, keyed by a hash of the ShapeInfo content.
+// Reduced hull points are stored as built, and static meshes keep their bounding volume hierarchy,
+// so loading an entry skips the expensive part of ShapeFactory::createShapeFromInfo.
+// Entries are written to a temporary file and renamed, so load() and save() may be called from any thread.
+
+class ShapeCache {
+public:
+    explicit ShapeCache(const QString& directory);
+
+    const QString& getDirectory() const { return _directory; }
+
+    // true for shape types that are worth caching (and building off the main thread)
+    static bool isCacheable(const ShapeInfo& info);
+
+    // hash of everything that goes into building the shape, unlike ShapeInfo::getHash() which
+    // only covers type, extents and url
+    static QByteArray computeKey(const ShapeInfo& info);
+
+    // \return new shape to be deleted with ShapeFactory::deleteShape(), or nullptr if there is no valid entry
+    btCollisionShape* load(const QByteArray& key) const;
+
+    // \return true if the shape was written
+    bool save(const QByteArray& key, const btCollisionShape* shape) const;
+
+    // delete the least recently written entries until the cache fits in maxSize bytes
+    void trim(qint64 maxSize) const;
+
+private:
+    QString getPath(const QByteArray& key) const;
+
+    QString _directory;
+};
+
+#endif // hifi_ShapeCache_h
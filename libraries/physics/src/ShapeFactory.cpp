@@ -409,7 +409,19 @@ ShapeFactory::StaticMeshShape::StaticMeshShape(btTriangleIndexVertexArray* dataA
     assert(dataArray);
 }
 
+ShapeFactory::StaticMeshShape::StaticMeshShape(btTriangleIndexVertexArray* dataArray, btOptimizedBvh* bvh, void* bvhBuffer)
+:   btBvhTriangleMeshShape(dataArray, true, false), _dataArray(dataArray), _bvhBuffer(bvhBuffer) {
+    assert(dataArray);
+    assert(bvh);
+    setOptimizedBvh(bvh);
+}
+
 ShapeFactory::StaticMeshShape::~StaticMeshShape() {
     deleteStaticMeshArray(_dataArray);
     _dataArray = nullptr;
+    if (_bvhBuffer) {
+        // the bvh lives in the buffer and doesn't own any other memory
+        btAlignedFree(_bvhBuffer);
+        _bvhBuffer = nullptr;
+    }
 }
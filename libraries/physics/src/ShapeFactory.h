@@ -30,11 +30,17 @@ namespace ShapeFactory {
     public:
         StaticMeshShape() = delete;
         StaticMeshShape(btTriangleIndexVertexArray* dataArray);
+        // uses a bvh that was deserialized in place into bvhBuffer (allocated with btAlignedAlloc)
+        // instead of building a new one
+        StaticMeshShape(btTriangleIndexVertexArray* dataArray, btOptimizedBvh* bvh, void* bvhBuffer);
         ~StaticMeshShape();
 
+        const btTriangleIndexVertexArray* getDataArray() const { return _dataArray; }
+
     private:
         // the StaticMeshShape owns its vertex/index data
         btTriangleIndexVertexArray* _dataArray;
+        void* _bvhBuffer { nullptr };
     };
 };
 
@@ -9,17 +9,46 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <functional>
+
 #include <QDebug>
 
 #include <glm/gtx/norm.hpp>
 
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+
+#include "ShapeCache.h"
 #include "ShapeFactory.h"
 #include "ShapeManager.h"
 
+// hull reduction and bvh construction are single threaded, a couple of workers is enough to keep the main thread free
+static const int MAX_SHAPE_BUILD_THREADS = 2;
+static const qint64 MAX_SHAPE_CACHE_SIZE = 256 * 1024 * 1024; // bytes
+
+class ShapeBuildRunnable : public QRunnable {
+public:
+    ShapeBuildRunnable(std::function<void()> function) : _function(function) {}
+    void run() override { _function(); }
+private:
+    std::function<void()> _function;
+};
+
 ShapeManager::ShapeManager() {
+    _threadPool.setMaxThreadCount(MAX_SHAPE_BUILD_THREADS);
 }
 
 ShapeManager::~ShapeManager() {
+    _threadPool.waitForDone();
+    int numJobs = _pendingJobs.size();
+    for (int i = 0; i < numJobs; ++i) {
+        const ShapeJobPointer& job = *_pendingJobs.getAtIndex(i);
+        if (job->shape) {
+            ShapeFactory::deleteShape(job->shape);
+        }
+    }
+    _pendingJobs.clear();
+
     int numShapes = _shapeMap.size();
     for (int i = 0; i < numShapes; ++i) {
         ShapeReference* shapeRef = _shapeMap.getAtIndex(i);
@@ -28,14 +57,58 @@ ShapeManager::~ShapeManager() {
     _shapeMap.clear();
 }
 
-const btCollisionShape* ShapeManager::getShape(const ShapeInfo& info) {
+bool ShapeManager::isValidInfo(const ShapeInfo& info) const {
     if (info.getType() == SHAPE_TYPE_NONE) {
-        return nullptr;
+        return false;
     }
     const float MIN_SHAPE_DIAGONAL_SQUARED = 3.0e-4f; // 1 cm cube
     if (4.0f * glm::length2(info.getHalfExtents()) < MIN_SHAPE_DIAGONAL_SQUARED) {
         // tiny shapes are not supported
         // qCDebug(physics) << "ShapeManager::getShape -- not making shape due to size" << diagonal;
+        return false;
+    }
+    return true;
+}
+
+// private helper method
+void ShapeManager::addShape(const DoubleHashKey& key, const btCollisionShape* shape, int refCount) {
+    ShapeReference newRef;
+    newRef.refCount = refCount;
+    newRef.shape = shape;
+    newRef.key = key;
+    _shapeMap.insert(key, newRef);
+}
+
+// may be called from a worker thread
+const btCollisionShape* ShapeManager::buildShape(const ShapeInfo& info, const std::shared_ptr<ShapeCache>& cache, Stats& stats) {
+    if (!ShapeCache::isCacheable(info)) {
+        // primitives are cheap, don't count them
+        return ShapeFactory::createShapeFromInfo(info);
+    }
+
+    quint64 start = usecTimestampNow();
+    const btCollisionShape* shape = nullptr;
+    QByteArray cacheKey;
+    if (cache) {
+        cacheKey = ShapeCache::computeKey(info);
+        shape = cache->load(cacheKey);
+        if (shape) {
+            stats.numCacheHits++;
+        }
+    }
+    if (!shape) {
+        shape = ShapeFactory::createShapeFromInfo(info);
+        if (shape && cache) {
+            cache->save(cacheKey, shape);
+        }
+    }
+    stats.buildTime += usecTimestampNow() - start;
+    stats.numBuilt++;
+    return shape;
+}
+
+const btCollisionShape* ShapeManager::getShape(const ShapeInfo& info) {
+    if (!isValidInfo(info)) {
         return nullptr;
     }
 
@@ -45,17 +118,77 @@ const btCollisionShape* ShapeManager::getShape(const ShapeInfo& info) {
         shapeRef->refCount++;
         return shapeRef->shape;
     }
-    const btCollisionShape* shape = ShapeFactory::createShapeFromInfo(info);
+    const btCollisionShape* shape = buildShape(info, _cache, _stats);
     if (shape) {
-        ShapeReference newRef;
-        newRef.refCount = 1;
-        newRef.shape = shape;
-        newRef.key = key;
-        _shapeMap.insert(key, newRef);
+        addShape(key, shape, 1);
     }
     return shape;
 }
 
+const btCollisionShape* ShapeManager::getShapeAsync(const ShapeInfo& info) {
+    if (!isValidInfo(info)) {
+        return nullptr;
+    }
+
+    DoubleHashKey key = info.getHash();
+    ShapeReference* shapeRef = _shapeMap.find(key);
+    if (shapeRef) {
+        shapeRef->refCount++;
+        return shapeRef->shape;
+    }
+    if (!ShapeCache::isCacheable(info)) {
+        return getShape(info);
+    }
+    if (_failedShapes.find(key)) {
+        return nullptr;
+    }
+
+    ShapeJobPointer* pendingJob = _pendingJobs.find(key);
+    if (pendingJob) {
+        ShapeJobPointer job = *pendingJob;
+        if (!job->finished) {
+            return nullptr;
+        }
+        _pendingJobs.remove(key);
+        if (job->shape) {
+            addShape(key, job->shape, 1);
+        } else {
+            // remember the failure, building the same info again would fail again
+            _failedShapes.insert(key, true);
+        }
+        return job->shape;
+    }
+
+    auto job = std::make_shared<ShapeJob>();
+    job->info = info;
+    auto cache = _cache;
+    Stats& stats = _stats;
+    _threadPool.start(new ShapeBuildRunnable([job, cache, &stats] {
+        job->shape = buildShape(job->info, cache, stats);
+        job->finished = true;
+    }));
+    _pendingJobs.insert(key, job);
+    return nullptr;
+}
+
+bool ShapeManager::hasFailedShape(const ShapeInfo& info) const {
+    return _failedShapes.find(info.getHash()) != nullptr;
+}
+
+void ShapeManager::setCacheDirectory(const QString& directory) {
+    if (directory.isEmpty()) {
+        _cache.reset();
+    } else {
+        _cache = std::make_shared<ShapeCache>(directory);
+        _cache->trim(MAX_SHAPE_CACHE_SIZE);
+    }
+}
+
+float ShapeManager::getAverageBuildTime() const {
+    uint32_t numBuilt = _stats.numBuilt;
+    return numBuilt > 0 ? (float)_stats.buildTime / (float)(numBuilt * USECS_PER_MSEC) : 0.0f;
+}
+
 // private helper method
 bool ShapeManager::releaseShapeByKey(const DoubleHashKey& key) {
     ShapeReference* shapeRef = _shapeMap.find(key);
@@ -103,6 +236,36 @@ void ShapeManager::collectGarbage() {
         }
     }
     _pendingGarbage.clear();
+
+    claimFinishedJobs();
+}
+
+// private helper method
+void ShapeManager::claimFinishedJobs() {
+    // shapes that finished building after their requester lost interest (or got the shape another way)
+    // are kept around without references until the next collection, in case someone asks again
+    btAlignedObjectArray<DoubleHashKey> finishedKeys;
+    int numJobs = _pendingJobs.size();
+    for (int i = 0; i < numJobs; ++i) {
+        if ((*_pendingJobs.getAtIndex(i))->finished) {
+            finishedKeys.push_back(_pendingJobs.getKeyAtIndex(i));
+        }
+    }
+    for (int i = 0; i < finishedKeys.size(); ++i) {
+        const DoubleHashKey& key = finishedKeys[i];
+        ShapeJobPointer job = *_pendingJobs.find(key);
+        _pendingJobs.remove(key);
+        if (!job->shape) {
+            _failedShapes.insert(key, true);
+            continue;
+        }
+        if (_shapeMap.find(key)) {
+            ShapeFactory::deleteShape(job->shape);
+        } else {
+            addShape(key, job->shape, 0);
+            _pendingGarbage.push_back(key);
+        }
+    }
 }
 
 int ShapeManager::getNumReferences(const ShapeInfo& info) const {
@@ -12,13 +12,20 @@
 #ifndef hifi_ShapeManager_h
 #define hifi_ShapeManager_h
 
+#include <atomic>
+#include <memory>
+
 #include <btBulletDynamicsCommon.h>
 #include <LinearMath/btHashMap.h>
 
+#include <QThreadPool>
+
 #include <ShapeInfo.h>
 
 #include "DoubleHashKey.h"
 
+class ShapeCache;
+
 class ShapeManager {
 public:
 
@@ -28,6 +35,17 @@ public:
     /// \return pointer to shape
     const btCollisionShape* getShape(const ShapeInfo& info);
 
+    /// Like getShape(), but hulls and meshes are built (or loaded from the cache) on a worker thread.
+    /// \return pointer to shape, or nullptr while it is being built: call again with the same info later
+    /// unless hasFailedShape() says the build failed, failed builds are not retried
+    const btCollisionShape* getShapeAsync(const ShapeInfo& info);
+
+    /// \return true if an async build for this info finished without producing a shape
+    bool hasFailedShape(const ShapeInfo& info) const;
+
+    /// keep built hulls and meshes in directory across sessions, or disable the cache with an empty path
+    void setCacheDirectory(const QString& directory);
+
     /// \return true if shape was found and released
     bool releaseShape(const btCollisionShape* shape);
 
@@ -40,8 +58,36 @@ public:
     int getNumReferences(const btCollisionShape* shape) const;
     bool hasShape(const btCollisionShape* shape) const;
 
+    // stats for hulls and meshes
+    int getNumPendingShapes() const { return _pendingJobs.size(); }
+    int getNumFailedShapes() const { return _failedShapes.size(); }
+    uint32_t getNumShapesBuilt() const { return _stats.numBuilt; }
+    uint32_t getNumCacheHits() const { return _stats.numCacheHits; }
+    float getAverageBuildTime() const; // msec
+
 private:
     bool releaseShapeByKey(const DoubleHashKey& key);
+    bool isValidInfo(const ShapeInfo& info) const;
+    void addShape(const DoubleHashKey& key, const btCollisionShape* shape, int refCount);
+    void claimFinishedJobs();
+
+    // updated by the worker threads
+    struct Stats {
+        std::atomic<uint32_t> numBuilt { 0 };
+        std::atomic<uint32_t> numCacheHits { 0 };
+        std::atomic<uint64_t> buildTime { 0 }; // usec
+    };
+
+    static const btCollisionShape* buildShape(const ShapeInfo& info, const std::shared_ptr<ShapeCache>& cache, Stats& stats);
+
+    // shape being built on a worker thread, shape is only valid once finished is set
+    class ShapeJob {
+    public:
+        ShapeInfo info;
+        const btCollisionShape* shape { nullptr };
+        std::atomic<bool> finished { false };
+    };
+    using ShapeJobPointer = std::shared_ptr<ShapeJob>;
 
     class ShapeReference {
     public:
@@ -53,6 +99,12 @@ private:
 
     btHashMap<DoubleHashKey, ShapeReference> _shapeMap;
     btAlignedObjectArray<DoubleHashKey> _pendingGarbage;
+
+    btHashMap<DoubleHashKey, ShapeJobPointer> _pendingJobs;
+    btHashMap<DoubleHashKey, bool> _failedShapes; // keys whose build produced no shape
+    std::shared_ptr<ShapeCache> _cache;
+    Stats _stats;
+    QThreadPool _threadPool;
 };
 
 #endif // hifi_ShapeManager_h
@@ -15,7 +15,12 @@
  * Copied and modified from btDiscreteDynamicsWorld.cpp by AndrewMeadows on 2014.11.12.
  * */
 
+#include <algorithm>
+#include <utility>
+#include <vector>
+
 #include <LinearMath/btQuickprof.h>
+#include <BulletCollision/CollisionDispatch/btSimulationIslandManager.h>
 
 #include "ThreadSafeDynamicsWorld.h"
 
@@ -27,6 +32,10 @@ ThreadSafeDynamicsWorld::ThreadSafeDynamicsWorld(
     :   btDiscreteDynamicsWorld(dispatcher, pairCache, constraintSolver, collisionConfiguration) {
 }
 
+ThreadSafeDynamicsWorld::~ThreadSafeDynamicsWorld() {
+    setNumSolverThreads(1);
+}
+
 int ThreadSafeDynamicsWorld::stepSimulationWithSubstepCallback(btScalar timeStep, int maxSubSteps,
                                                                btScalar fixedTimeStep, SubStepCallback onSubStep) {
     BT_PROFILE("stepSimulationWithSubstepCallback");
@@ -167,3 +176,153 @@ void ThreadSafeDynamicsWorld::saveKinematicState(btScalar timeStep) {
 }
 
 
+
+void ThreadSafeDynamicsWorld::setNumSolverThreads(int numThreads) {
+    numThreads = std::max(numThreads, 1);
+    if (numThreads == _numSolverThreads) {
+        return;
+    }
+    _numSolverThreads = numThreads;
+    for (auto solver : _islandSolvers) {
+        delete solver;
+    }
+    _islandSolvers.clear();
+    if (numThreads > 1) {
+        for (int i = 0; i < numThreads; ++i) {
+            _islandSolvers.push_back(new IslandSolver());
+        }
+        _solverThreadPool.setMaxThreadCount(numThreads - 1);
+    }
+}
+
+// same as btGetConstraintIslandId() in btDiscreteDynamicsWorld.cpp
+static int getConstraintIslandId(const btTypedConstraint* constraint) {
+    const btCollisionObject& objectA = constraint->getRigidBodyA();
+    const btCollisionObject& objectB = constraint->getRigidBodyB();
+    return objectA.getIslandTag() >= 0 ? objectA.getIslandTag() : objectB.getIslandTag();
+}
+
+class SortConstraintOnIslandPredicate {
+public:
+    bool operator() (const btTypedConstraint* lhs, const btTypedConstraint* rhs) const {
+        return getConstraintIslandId(lhs) < getConstraintIslandId(rhs);
+    }
+};
+
+static bool isKinematic(const btCollisionObject* object) {
+    return object->isKinematicObject();
+}
+
+// distributes awake islands over the solvers, balancing their cost
+class IslandDistributor : public btSimulationIslandManager::IslandCallback {
+public:
+    IslandDistributor(std::vector<IslandSolver*>& solvers, btAlignedObjectArray<btTypedConstraint*>& sortedConstraints) :
+        _solvers(solvers), _sortedConstraints(sortedConstraints) {
+        // constraints are sorted by island: find where each island's run starts and ends once, rather than per island
+        int numConstraints = _sortedConstraints.size();
+        if (numConstraints > 0) {
+            int maxIslandId = getConstraintIslandId(_sortedConstraints[numConstraints - 1]);
+            if (maxIslandId >= 0) {
+                _constraintRanges.resize(maxIslandId + 1, std::make_pair(0, 0));
+            }
+        }
+        int start = 0;
+        while (start < numConstraints) {
+            int islandId = getConstraintIslandId(_sortedConstraints[start]);
+            int end = start + 1;
+            while (end < numConstraints && getConstraintIslandId(_sortedConstraints[end]) == islandId) {
+                ++end;
+            }
+            if (islandId >= 0) {
+                _constraintRanges[islandId] = std::make_pair(start, end);
+            }
+            start = end;
+        }
+    }
+
+    virtual void processIsland(btCollisionObject** bodies, int numBodies, btPersistentManifold** manifolds,
+                               int numManifolds, int islandId) override {
+        int start = 0;
+        int end = 0;
+        if (islandId >= 0 && islandId < (int)_constraintRanges.size()) {
+            start = _constraintRanges[islandId].first;
+            end = _constraintRanges[islandId].second;
+        }
+        btTypedConstraint** constraints = (end > start) ? &_sortedConstraints[start] : nullptr;
+
+        // kinematic bodies are not part of any island, so they can touch several: keep all those islands together
+        bool touchesKinematic = false;
+        for (int i = 0; i < numManifolds && !touchesKinematic; ++i) {
+            touchesKinematic = isKinematic(manifolds[i]->getBody0()) || isKinematic(manifolds[i]->getBody1());
+        }
+        for (int i = start; i < end && !touchesKinematic; ++i) {
+            touchesKinematic = isKinematic(&_sortedConstraints[i]->getRigidBodyA()) || isKinematic(&_sortedConstraints[i]->getRigidBodyB());
+        }
+
+        IslandSolver* target = _solvers[0];
+        if (!touchesKinematic) {
+            for (auto solver : _solvers) {
+                if (solver->getCost() < target->getCost()) {
+                    target = solver;
+                }
+            }
+        }
+        target->addIsland(bodies, numBodies, manifolds, numManifolds, constraints, end - start);
+    }
+
+private:
+    std::vector<IslandSolver*>& _solvers;
+    btAlignedObjectArray<btTypedConstraint*>& _sortedConstraints;
+    std::vector<std::pair<int, int>> _constraintRanges; // [start, end) in _sortedConstraints, indexed by island id
+};
+
+class IslandSolverRunnable : public QRunnable {
+public:
+    IslandSolverRunnable(IslandSolver* solver, const btContactSolverInfo& info) : _solver(solver), _info(info) {}
+    void run() override { _solver->iterate(_info); }
+private:
+    IslandSolver* _solver;
+    const btContactSolverInfo& _info;
+};
+
+void ThreadSafeDynamicsWorld::solveConstraints(btContactSolverInfo& solverInfo) {
+    if (_numSolverThreads <= 1) {
+        btDiscreteDynamicsWorld::solveConstraints(solverInfo);
+        return;
+    }
+    BT_PROFILE("solveConstraints");
+
+    m_sortedConstraints.resize(m_constraints.size());
+    for (int i = 0; i < getNumConstraints(); ++i) {
+        m_sortedConstraints[i] = m_constraints[i];
+    }
+    m_sortedConstraints.quickSort(SortConstraintOnIslandPredicate());
+
+    IslandDistributor distributor(_islandSolvers, m_sortedConstraints);
+    m_islandManager->buildAndProcessIslands(getCollisionWorld()->getDispatcher(), getCollisionWorld(), &distributor);
+
+    // setup and finish use the profiler, only the iterations run in parallel
+    for (auto solver : _islandSolvers) {
+        if (!solver->isEmpty()) {
+            solver->setup(solverInfo, getDebugDrawer());
+        }
+    }
+    {
+        BT_PROFILE("solveIslands");
+        for (size_t i = 1; i < _islandSolvers.size(); ++i) {
+            if (!_islandSolvers[i]->isEmpty()) {
+                _solverThreadPool.start(new IslandSolverRunnable(_islandSolvers[i], solverInfo));
+            }
+        }
+        if (!_islandSolvers[0]->isEmpty()) {
+            _islandSolvers[0]->iterate(solverInfo);
+        }
+        _solverThreadPool.waitForDone();
+    }
+    for (auto solver : _islandSolvers) {
+        if (!solver->isEmpty()) {
+            solver->finish(solverInfo);
+        }
+        solver->clear();
+    }
+}
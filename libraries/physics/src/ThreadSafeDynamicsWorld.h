@@ -21,9 +21,13 @@
 #include <BulletDynamics/Dynamics/btRigidBody.h>
 #include <BulletDynamics/Dynamics/btDiscreteDynamicsWorld.h>
 
+#include <QThreadPool>
+
+#include "IslandSolver.h"
 #include "ObjectMotionState.h"
 
 #include <functional>
+#include <vector>
 
 using SubStepCallback = std::function<void()>;
 
@@ -36,6 +40,7 @@ public:
             btBroadphaseInterface* pairCache,
             btConstraintSolver* constraintSolver,
             btCollisionConfiguration* collisionConfiguration);
+    ~ThreadSafeDynamicsWorld();
 
     int stepSimulationWithSubstepCallback(btScalar timeStep, int maxSubSteps = 1,
                                           btScalar fixedTimeStep = btScalar(1.)/btScalar(60.),
@@ -50,11 +55,23 @@ public:
 
     const VectorOfMotionStates& getChangedMotionStates() const { return _changedMotionStates; }
 
+    // solve independent simulation islands on numThreads threads, including the simulation thread
+    // (1 uses the world's own constraint solver)
+    void setNumSolverThreads(int numThreads);
+    int getNumSolverThreads() const { return _numSolverThreads; }
+
+protected:
+    virtual void solveConstraints(btContactSolverInfo& solverInfo) override;
+
 private:
     // call this instead of non-virtual btDiscreteDynamicsWorld::synchronizeSingleMotionState()
     void synchronizeMotionState(btRigidBody* body);
 
     VectorOfMotionStates _changedMotionStates;
+
+    int _numSolverThreads { 1 };
+    std::vector<IslandSolver*> _islandSolvers;
+    QThreadPool _solverThreadPool;
 };
 
 #endif // hifi_ThreadSafeDynamicsWorld_h
@@ -268,7 +268,7 @@ void MeshPartPayload::bindTransform(gpu::Batch& batch, const ShapePipeline::Loca
 
 
 void MeshPartPayload::render(RenderArgs* args) const {
-    PerformanceTimer perfTimer("MeshPartPayload::render");
+    PERFORMANCE_TIMER("MeshPartPayload::render");
 
     gpu::Batch& batch = *(args->_batch);
 
@@ -290,7 +290,7 @@ void MeshPartPayload::render(RenderArgs* args) const {
 
     // Draw!
     {
-        PerformanceTimer perfTimer("batch.drawIndexed()");
+        PERFORMANCE_TIMER("batch.drawIndexed()");
         drawCall(batch);
     }
 
@@ -555,7 +555,7 @@ float ModelMeshPartPayload::computeFadeAlpha() const {
 }
 
 void ModelMeshPartPayload::render(RenderArgs* args) const {
-    PerformanceTimer perfTimer("ModelMeshPartPayload::render");
+    PERFORMANCE_TIMER("ModelMeshPartPayload::render");
 
     if (!_model->addedToScene() || !_model->isVisible()) {
         return; // bail asap
@@ -600,7 +600,7 @@ void ModelMeshPartPayload::render(RenderArgs* args) const {
 
     // Draw!
     {
-        PerformanceTimer perfTimer("batch.drawIndexed()");
+        PERFORMANCE_TIMER("batch.drawIndexed()");
         drawCall(batch);
     }
 
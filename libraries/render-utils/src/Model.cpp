@@ -96,9 +96,7 @@ Model::Model(RigPointer rig, QObject* parent, SpatiallyNestable* spatiallyNestab
     _isVisible(true),
     _blendNumber(0),
     _appliedBlendNumber(0),
-    _calculatedMeshPartBoxesValid(false),
     _calculatedMeshBoxesValid(false),
-    _calculatedMeshTrianglesValid(false),
     _isWireframe(false),
     _rig(rig)
 {
@@ -369,10 +367,16 @@ bool Model::findRayIntersectionAgainstSubMeshes(const glm::vec3& origin, const g
 
         const FBXGeometry& geometry = getFBXGeometry();
 
+        // triangles are picked against in the frame of the geometry's meshes, where they are shared by every model.
+        // The transform is affine, so a distance along the ray is the same in both frames.
+        glm::mat4 worldToMeshMatrix = glm::inverse(getMeshToWorldMatrix());
+        glm::vec3 meshFrameOrigin = glm::vec3(worldToMeshMatrix * glm::vec4(origin, 1.0f));
+        glm::vec3 meshFrameDirection = glm::vec3(worldToMeshMatrix * glm::vec4(direction, 0.0f));
+
         // If we hit the models box, then consider the submeshes...
         _mutex.lock();
-        if (!_calculatedMeshBoxesValid || (pickAgainstTriangles && !_calculatedMeshTrianglesValid)) {
-            recalculateMeshBoxes(pickAgainstTriangles);
+        if (!_calculatedMeshBoxesValid) {
+            recalculateMeshBoxes();
         }
 
         for (const auto& subMeshBox : _calculatedMeshBoxes) {
@@ -381,18 +385,17 @@ bool Model::findRayIntersectionAgainstSubMeshes(const glm::vec3& origin, const g
                 if (distanceToSubMesh < bestDistance) {
                     if (pickAgainstTriangles) {
                         // check our triangles here....
-                        const QVector<Triangle>& meshTriangles = _calculatedMeshTriangles[subMeshIndex];
-                        for(const auto& triangle : meshTriangles) {
-                            float thisTriangleDistance;
-                            if (findRayTriangleIntersection(origin, direction, triangle, thisTriangleDistance)) {
-                                if (thisTriangleDistance < bestDistance) {
-                                    bestDistance = thisTriangleDistance;
-                                    intersectedSomething = true;
-                                    face = subMeshFace;
-                                    surfaceNormal = triangle.getNormal();
-                                    extraInfo = geometry.getModelNameOfMesh(subMeshIndex);
-                                }
-                            }
+                        float triangleDistance = bestDistance;
+                        Triangle triangle;
+                        if (subMeshIndex < geometry.meshTriangleSets.size() &&
+                                geometry.meshTriangleSets[subMeshIndex].findRayIntersection(meshFrameOrigin,
+                                    meshFrameDirection, triangleDistance, triangle)) {
+                            bestDistance = triangleDistance;
+                            intersectedSomething = true;
+                            face = subMeshFace;
+                            glm::mat3 normalMatrix = glm::transpose(glm::mat3(worldToMeshMatrix));
+                            surfaceNormal = glm::normalize(normalMatrix * triangle.getNormal());
+                            extraInfo = geometry.getModelNameOfMesh(subMeshIndex);
                         }
                     } else {
                         // this is the non-triangle picking case...
@@ -442,35 +445,15 @@ bool Model::convexHullContains(glm::vec3 point) {
     // we can use the AABox's contains() by mapping our point into the model frame
     // and testing there.
     if (modelFrameBox.contains(modelFramePoint)){
-        _mutex.lock();
-        if (!_calculatedMeshTrianglesValid) {
-            recalculateMeshBoxes(true);
-        }
-
-        // If we are inside the models box, then consider the submeshes...
-        int subMeshIndex = 0;
-        foreach(const AABox& subMeshBox, _calculatedMeshBoxes) {
-            if (subMeshBox.contains(point)) {
-                bool insideMesh = true;
-                // To be inside the sub mesh, we need to be behind every triangles' planes
-                const QVector<Triangle>& meshTriangles = _calculatedMeshTriangles[subMeshIndex];
-                foreach (const Triangle& triangle, meshTriangles) {
-                    if (!isPointBehindTrianglesPlane(point, triangle.v0, triangle.v1, triangle.v2)) {
-                        // it's not behind at least one so we bail
-                        insideMesh = false;
-                        break;
-                    }
+        glm::vec3 meshFramePoint = glm::vec3(glm::inverse(getMeshToWorldMatrix()) * glm::vec4(point, 1.0f));
 
-                }
-                if (insideMesh) {
-                    // It's inside this mesh, return true.
-                    _mutex.unlock();
-                    return true;
-                }
+        // To be inside a sub mesh, we need to be behind every triangles' planes
+        for (const auto& triangleSet : getFBXGeometry().meshTriangleSets) {
+            if (triangleSet.convexHullContains(meshFramePoint)) {
+                // It's inside this mesh, return true.
+                return true;
             }
-            subMeshIndex++;
         }
-        _mutex.unlock();
     }
     // It wasn't in any mesh, return false.
     return false;
@@ -481,120 +464,29 @@ bool Model::convexHullContains(glm::vec3 point) {
 // can occur multiple times. In addition, rendering does it's own ray picking in order to decide which
 // entity-scripts to call.  I think it would be best to do the picking once-per-frame (in cpu, or gpu if possible)
 // and then the calls use the most recent such result.
-void Model::recalculateMeshBoxes(bool pickAgainstTriangles) {
+void Model::recalculateMeshBoxes() {
     PROFILE_RANGE(render, __FUNCTION__);
-    bool calculatedMeshTrianglesNeeded = pickAgainstTriangles && !_calculatedMeshTrianglesValid;
 
-    if (!_calculatedMeshBoxesValid || calculatedMeshTrianglesNeeded || (!_calculatedMeshPartBoxesValid && pickAgainstTriangles) ) {
+    if (!_calculatedMeshBoxesValid) {
         const FBXGeometry& geometry = getFBXGeometry();
         int numberOfMeshes = geometry.meshes.size();
         _calculatedMeshBoxes.resize(numberOfMeshes);
-        _calculatedMeshTriangles.clear();
-        _calculatedMeshTriangles.resize(numberOfMeshes);
-        _calculatedMeshPartBoxes.clear();
         for (int i = 0; i < numberOfMeshes; i++) {
             const FBXMesh& mesh = geometry.meshes.at(i);
             Extents scaledMeshExtents = calculateScaledOffsetExtents(mesh.meshExtents, _translation, _rotation);
 
             _calculatedMeshBoxes[i] = AABox(scaledMeshExtents);
-
-            if (pickAgainstTriangles) {
-                QVector<Triangle> thisMeshTriangles;
-                for (int j = 0; j < mesh.parts.size(); j++) {
-                    const FBXMeshPart& part = mesh.parts.at(j);
-
-                    bool atLeastOnePointInBounds = false;
-                    AABox thisPartBounds;
-
-                    const int INDICES_PER_TRIANGLE = 3;
-                    const int INDICES_PER_QUAD = 4;
-
-                    if (part.quadIndices.size() > 0) {
-                        int numberOfQuads = part.quadIndices.size() / INDICES_PER_QUAD;
-                        int vIndex = 0;
-                        for (int q = 0; q < numberOfQuads; q++) {
-                            int i0 = part.quadIndices[vIndex++];
-                            int i1 = part.quadIndices[vIndex++];
-                            int i2 = part.quadIndices[vIndex++];
-                            int i3 = part.quadIndices[vIndex++];
-
-                            glm::vec3 mv0 = glm::vec3(mesh.modelTransform * glm::vec4(mesh.vertices[i0], 1.0f));
-                            glm::vec3 mv1 = glm::vec3(mesh.modelTransform * glm::vec4(mesh.vertices[i1], 1.0f));
-                            glm::vec3 mv2 = glm::vec3(mesh.modelTransform * glm::vec4(mesh.vertices[i2], 1.0f));
-                            glm::vec3 mv3 = glm::vec3(mesh.modelTransform * glm::vec4(mesh.vertices[i3], 1.0f));
-
-                            // track the mesh parts in model space
-                            if (!atLeastOnePointInBounds) {
-                                thisPartBounds.setBox(mv0, 0.0f);
-                                atLeastOnePointInBounds = true;
-                            } else {
-                                thisPartBounds += mv0;
-                            }
-                            thisPartBounds += mv1;
-                            thisPartBounds += mv2;
-                            thisPartBounds += mv3;
-
-                            glm::vec3 v0 = calculateScaledOffsetPoint(mv0);
-                            glm::vec3 v1 = calculateScaledOffsetPoint(mv1);
-                            glm::vec3 v2 = calculateScaledOffsetPoint(mv2);
-                            glm::vec3 v3 = calculateScaledOffsetPoint(mv3);
-
-                            // Sam's recommended triangle slices
-                            Triangle tri1 = { v0, v1, v3 };
-                            Triangle tri2 = { v1, v2, v3 };
-
-                            // NOTE: Random guy on the internet's recommended triangle slices
-                            //Triangle tri1 = { v0, v1, v2 };
-                            //Triangle tri2 = { v2, v3, v0 };
-
-                            thisMeshTriangles.push_back(tri1);
-                            thisMeshTriangles.push_back(tri2);
-
-                        }
-                    }
-
-                    if (part.triangleIndices.size() > 0) {
-                        int numberOfTris = part.triangleIndices.size() / INDICES_PER_TRIANGLE;
-                        int vIndex = 0;
-                        for (int t = 0; t < numberOfTris; t++) {
-                            int i0 = part.triangleIndices[vIndex++];
-                            int i1 = part.triangleIndices[vIndex++];
-                            int i2 = part.triangleIndices[vIndex++];
-
-                            glm::vec3 mv0 = glm::vec3(mesh.modelTransform * glm::vec4(mesh.vertices[i0], 1.0f));
-                            glm::vec3 mv1 = glm::vec3(mesh.modelTransform * glm::vec4(mesh.vertices[i1], 1.0f));
-                            glm::vec3 mv2 = glm::vec3(mesh.modelTransform * glm::vec4(mesh.vertices[i2], 1.0f));
-
-                            // track the mesh parts in model space
-                            if (!atLeastOnePointInBounds) {
-                                thisPartBounds.setBox(mv0, 0.0f);
-                                atLeastOnePointInBounds = true;
-                            } else {
-                                thisPartBounds += mv0;
-                            }
-                            thisPartBounds += mv1;
-                            thisPartBounds += mv2;
-
-                            glm::vec3 v0 = calculateScaledOffsetPoint(mv0);
-                            glm::vec3 v1 = calculateScaledOffsetPoint(mv1);
-                            glm::vec3 v2 = calculateScaledOffsetPoint(mv2);
-
-                            Triangle tri = { v0, v1, v2 };
-
-                            thisMeshTriangles.push_back(tri);
-                        }
-                    }
-                    _calculatedMeshPartBoxes[QPair<int,int>(i, j)] = thisPartBounds;
-                }
-                _calculatedMeshTriangles[i] = thisMeshTriangles;
-                _calculatedMeshPartBoxesValid = true;
-            }
         }
         _calculatedMeshBoxesValid = true;
-        _calculatedMeshTrianglesValid = pickAgainstTriangles;
     }
 }
 
+glm::mat4 Model::getMeshToWorldMatrix() const {
+    // the same transform as calculateScaledOffsetPoint
+    return glm::translate(_translation) * glm::mat4_cast(_rotation) * glm::scale(_scale) * glm::translate(_offset) *
+        getFBXGeometry().offset;
+}
+
 void Model::renderSetup(RenderArgs* args) {
     // set up dilated textures on first render after load/simulate
     const FBXGeometry& geometry = getFBXGeometry();
@@ -1121,7 +1013,7 @@ void Model::snapToRegistrationPoint() {
 
 void Model::simulate(float deltaTime, bool fullUpdate) {
     PROFILE_RANGE(simulation_detail, __FUNCTION__);
-    PerformanceTimer perfTimer("Model::simulate");
+    PERFORMANCE_TIMER("Model::simulate");
     fullUpdate = updateGeometry() || fullUpdate || (_scaleToFit && !_scaledToFit)
                     || (_snapModelToRegistrationPoint && !_snappedToRegistrationPoint);
 
@@ -1131,7 +1023,6 @@ void Model::simulate(float deltaTime, bool fullUpdate) {
         //       not too bad at this point, because it doesn't impact rendering. However it does slow down ray picking
         //       because ray picking needs valid boxes to work
         _calculatedMeshBoxesValid = false;
-        _calculatedMeshTrianglesValid = false;
         onInvalidate();
 
         // check for scale to fit
@@ -1165,7 +1056,7 @@ void Model::computeMeshPartLocalBounds() {
 
 // virtual
 void Model::updateClusterMatrices() {
-    PerformanceTimer perfTimer("Model::updateClusterMatrices");
+    PERFORMANCE_TIMER("Model::updateClusterMatrices");
 
     if (!_needsUpdateClusterMatrices || !isLoaded()) {
         return;
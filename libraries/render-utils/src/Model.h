@@ -160,6 +160,9 @@ public:
                                              BoxFace& face, glm::vec3& surfaceNormal, 
                                              QString& extraInfo, bool pickAgainstTriangles = false);
 
+    // from the frame of the geometry's meshes, where their triangle sets are, to the world
+    glm::mat4 getMeshToWorldMatrix() const;
+
     void setOffset(const glm::vec3& offset);
     const glm::vec3& getOffset() const { return _offset; }
 
@@ -332,8 +335,6 @@ protected:
     /// Allow sub classes to force invalidating the bboxes
     void invalidCalculatedMeshBoxes() {
         _calculatedMeshBoxesValid = false;
-        _calculatedMeshPartBoxesValid = false;
-        _calculatedMeshTrianglesValid = false;
     }
 
     // hook for derived classes to be notified when setUrl invalidates the current model.
@@ -357,17 +358,12 @@ protected:
     int _blendNumber;
     int _appliedBlendNumber;
 
-    QHash<QPair<int,int>, AABox> _calculatedMeshPartBoxes; // world coordinate AABoxes for all sub mesh part boxes
-
-    bool _calculatedMeshPartBoxesValid;
     QVector<AABox> _calculatedMeshBoxes; // world coordinate AABoxes for all sub mesh boxes
     bool _calculatedMeshBoxesValid;
 
-    QVector< QVector<Triangle> > _calculatedMeshTriangles; // world coordinate triangles for all sub meshes
-    bool _calculatedMeshTrianglesValid;
     QMutex _mutex;
 
-    void recalculateMeshBoxes(bool pickAgainstTriangles = false);
+    void recalculateMeshBoxes();
 
     void createRenderItemSet();
     virtual void createVisibleRenderItemSet();
@@ -42,13 +42,13 @@ void render::cullItems(const RenderContextPointer& renderContext, const CullFunc
         // when they are outside of the view frustum...
         bool inView;
         {
-            PerformanceTimer perfTimer("boxIntersectsFrustum");
+            PERFORMANCE_TIMER("boxIntersectsFrustum");
             inView = frustum.boxIntersectsFrustum(item.bound);
         }
         if (inView) {
             bool bigEnoughToRender;
             {
-                PerformanceTimer perfTimer("shouldRender");
+                PERFORMANCE_TIMER("shouldRender");
                 bigEnoughToRender = cullFunctor(args, item.bound);
             }
             if (bigEnoughToRender) {
@@ -191,7 +191,7 @@ void CullSpatialSelection::run(const SceneContextPointer& sceneContext, const Re
     if (_skipCulling) {
         // inside & fit items: filter only, culling is disabled
         {
-            PerformanceTimer perfTimer("insideFitItems");
+            PERFORMANCE_TIMER("insideFitItems");
             for (auto id : inSelection.insideItems) {
                 auto& item = scene->getItem(id);
                 if (_filter.test(item.getKey())) {
@@ -203,7 +203,7 @@ void CullSpatialSelection::run(const SceneContextPointer& sceneContext, const Re
 
         // inside & subcell items: filter only, culling is disabled
         {
-            PerformanceTimer perfTimer("insideSmallItems");
+            PERFORMANCE_TIMER("insideSmallItems");
             for (auto id : inSelection.insideSubcellItems) {
                 auto& item = scene->getItem(id);
                 if (_filter.test(item.getKey())) {
@@ -215,7 +215,7 @@ void CullSpatialSelection::run(const SceneContextPointer& sceneContext, const Re
 
         // partial & fit items: filter only, culling is disabled
         {
-            PerformanceTimer perfTimer("partialFitItems");
+            PERFORMANCE_TIMER("partialFitItems");
             for (auto id : inSelection.partialItems) {
                 auto& item = scene->getItem(id);
                 if (_filter.test(item.getKey())) {
@@ -227,7 +227,7 @@ void CullSpatialSelection::run(const SceneContextPointer& sceneContext, const Re
 
         // partial & subcell items: filter only, culling is disabled
         {
-            PerformanceTimer perfTimer("partialSmallItems");
+            PERFORMANCE_TIMER("partialSmallItems");
             for (auto id : inSelection.partialSubcellItems) {
                 auto& item = scene->getItem(id);
                 if (_filter.test(item.getKey())) {
@@ -241,7 +241,7 @@ void CullSpatialSelection::run(const SceneContextPointer& sceneContext, const Re
 
         // inside & fit items: easy, just filter
         {
-            PerformanceTimer perfTimer("insideFitItems");
+            PERFORMANCE_TIMER("insideFitItems");
             for (auto id : inSelection.insideItems) {
                 auto& item = scene->getItem(id);
                 if (_filter.test(item.getKey())) {
@@ -253,7 +253,7 @@ void CullSpatialSelection::run(const SceneContextPointer& sceneContext, const Re
 
         // inside & subcell items: filter & distance cull
         {
-            PerformanceTimer perfTimer("insideSmallItems");
+            PERFORMANCE_TIMER("insideSmallItems");
             for (auto id : inSelection.insideSubcellItems) {
                 auto& item = scene->getItem(id);
                 if (_filter.test(item.getKey())) {
@@ -267,7 +267,7 @@ void CullSpatialSelection::run(const SceneContextPointer& sceneContext, const Re
 
         // partial & fit items: filter & frustum cull
         {
-            PerformanceTimer perfTimer("partialFitItems");
+            PERFORMANCE_TIMER("partialFitItems");
             for (auto id : inSelection.partialItems) {
                 auto& item = scene->getItem(id);
                 if (_filter.test(item.getKey())) {
@@ -281,7 +281,7 @@ void CullSpatialSelection::run(const SceneContextPointer& sceneContext, const Re
 
         // partial & subcell items:: filter & frutum cull & solidangle cull
         {
-            PerformanceTimer perfTimer("partialSmallItems");
+            PERFORMANCE_TIMER("partialSmallItems");
             for (auto id : inSelection.partialSubcellItems) {
                 auto& item = scene->getItem(id);
                 if (_filter.test(item.getKey())) {
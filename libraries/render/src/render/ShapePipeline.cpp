@@ -100,7 +100,7 @@ const ShapePipelinePointer ShapePlumber::pickPipeline(RenderArgs* args, const Ke
     assert(args);
     assert(args->_batch);
 
-    PerformanceTimer perfTimer("ShapePlumber::pickPipeline");
+    PERFORMANCE_TIMER("ShapePlumber::pickPipeline");
 
     const auto& pipelineIterator = _pipelineMap.find(key);
     if (pipelineIterator == _pipelineMap.end()) {
@@ -13,7 +13,7 @@
 #define hifi_CPUDetect_h
 
 //
-// Lightweight functions to detect SSE/AVX/AVX2 support
+// Lightweight functions to detect SSE/AVX/AVX2/AVX512 support
 //
 
 #if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
@@ -26,6 +26,7 @@
 #define MASK_SSE42  ((1 << 20) | (1 << 23)) // SSE4.2 and POPCNT
 #define MASK_AVX    ((1 << 27) | (1 << 28)) // OSXSAVE and AVX
 #define MASK_AVX2   (1 << 5)                // AVX2
+#define MASK_AVX512 (1 << 16)               // AVX512F
 
 #if defined(ARCH_X86) && defined(_MSC_VER)
 
@@ -94,6 +95,25 @@ static inline bool cpuSupportsAVX2() {
     return result;
 }
 
+static inline bool cpuSupportsAVX512() {
+    int info[4];
+
+    bool result = false;
+    if (cpuSupportsAVX2()) {
+
+        __cpuidex(info, 0x7, 0);
+
+        if ((info[1] & MASK_AVX512) == MASK_AVX512) {
+
+            // verify OS support for ZMM and opmask state
+            if ((_xgetbv(_XCR_XFEATURE_ENABLED_MASK) & 0xe6) == 0xe6) {
+                result = true;
+            }
+        }
+    }
+    return result;
+}
+
 #elif defined(ARCH_X86) && defined(__GNUC__)
 
 #include <cpuid.h>
@@ -157,6 +177,26 @@ static inline bool cpuSupportsAVX2() {
     return result;
 }
 
+static inline bool cpuSupportsAVX512() {
+    unsigned int eax, ebx, ecx, edx;
+
+    bool result = false;
+    if (cpuSupportsAVX2()) {
+
+        __cpuid_count(0x7, 0x0, eax, ebx, ecx, edx);
+
+        if ((ebx & MASK_AVX512) == MASK_AVX512) {
+
+            // verify OS support for ZMM and opmask state
+            __asm__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+            if ((eax & 0xe6) == 0xe6) {
+                result = true;
+            }
+        }
+    }
+    return result;
+}
+
 #else
 
 static inline bool cpuSupportsSSE3() {
@@ -183,6 +223,10 @@ static inline bool cpuSupportsAVX2() {
     return false;
 }
 
+static inline bool cpuSupportsAVX512() {
+    return false;
+}
+
 #endif
 
 #endif // hifi_CPUDetect_h
@@ -0,0 +1,198 @@
+//
+//  Metrics.cpp
+//  libraries/shared/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "Metrics.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <QtCore/QDebug>
+
+using namespace metrics;
+
+const char* metrics::CONTENT_TYPE = "text/plain; version=0.0.4";
+
+Histogram::Histogram(const std::vector<double>& bounds) :
+    _bounds(bounds),
+    _counts(new std::atomic<uint64_t>[bounds.size() + 1]())
+{
+    Q_ASSERT(std::is_sorted(_bounds.begin(), _bounds.end()));
+}
+
+void Histogram::record(double value) {
+    // the first bucket with an upper bound >= value, or +Inf
+    size_t bucket = std::lower_bound(_bounds.begin(), _bounds.end(), value) - _bounds.begin();
+    _counts[bucket].fetch_add(1, std::memory_order_relaxed);
+
+    double sum = _sum.load(std::memory_order_relaxed);
+    while (!_sum.compare_exchange_weak(sum, sum + value, std::memory_order_relaxed)) {}
+}
+
+std::vector<uint64_t> Histogram::getCumulativeCounts() const {
+    std::vector<uint64_t> counts(_bounds.size() + 1);
+    uint64_t total = 0;
+    for (size_t i = 0; i < counts.size(); ++i) {
+        total += _counts[i].load(std::memory_order_relaxed);
+        counts[i] = total;
+    }
+    return counts;
+}
+
+uint64_t Histogram::getCount() const {
+    return getCumulativeCounts().back();
+}
+
+std::vector<double> Histogram::exponentialBounds(double start, double factor, int count) {
+    std::vector<double> bounds;
+    bounds.reserve(count);
+    double bound = start;
+    for (int i = 0; i < count; ++i) {
+        bounds.push_back(bound);
+        bound *= factor;
+    }
+    return bounds;
+}
+
+Registry& Registry::getInstance() {
+    static Registry registry;
+    return registry;
+}
+
+Registry::Series& Registry::getSeries(const QString& name, const QString& help, Type type, const Labels& labels) {
+    auto it = _families.find(name);
+    if (it == _families.end()) {
+        it = _families.emplace(name, Family { type, help, {} }).first;
+    } else if (it->second.type != type) {
+        qWarning() << "Metric" << name << "was registered with another type, it will not be written out";
+    }
+
+    auto& series = it->second.series;
+    auto match = std::find_if(series.begin(), series.end(), [&](const std::unique_ptr<Series>& other) {
+        return other->labels == labels;
+    });
+    if (match != series.end()) {
+        return **match;
+    }
+    series.emplace_back(new Series { labels, nullptr, nullptr, nullptr });
+    return *series.back();
+}
+
+Counter& Registry::counter(const QString& name, const QString& help, const Labels& labels) {
+    std::lock_guard<std::mutex> guard(_mutex);
+    auto& series = getSeries(name, help, CounterType, labels);
+    if (!series.counter) {
+        series.counter.reset(new Counter());
+    }
+    return *series.counter;
+}
+
+Gauge& Registry::gauge(const QString& name, const QString& help, const Labels& labels) {
+    std::lock_guard<std::mutex> guard(_mutex);
+    auto& series = getSeries(name, help, GaugeType, labels);
+    if (!series.gauge) {
+        series.gauge.reset(new Gauge());
+    }
+    return *series.gauge;
+}
+
+Histogram& Registry::histogram(const QString& name, const QString& help, const std::vector<double>& bounds, const Labels& labels) {
+    std::lock_guard<std::mutex> guard(_mutex);
+    auto& series = getSeries(name, help, HistogramType, labels);
+    if (!series.histogram) {
+        series.histogram.reset(new Histogram(bounds));
+    }
+    return *series.histogram;
+}
+
+void Registry::setCommonLabels(const Labels& labels) {
+    std::lock_guard<std::mutex> guard(_mutex);
+    _commonLabels = labels;
+}
+
+static QByteArray formatValue(double value) {
+    if (std::isnan(value)) {
+        return "NaN";
+    } else if (std::isinf(value)) {
+        return value > 0 ? "+Inf" : "-Inf";
+    }
+    return QByteArray::number(value, 'g', 15);
+}
+
+static QByteArray escape(const QString& text, bool isLabelValue) {
+    QString escaped = text;
+    escaped.replace("\\", "\\\\").replace("\n", "\\n");
+    if (isLabelValue) {
+        escaped.replace("\"", "\\\"");
+    }
+    return escaped.toUtf8();
+}
+
+static QByteArray formatLabels(const Labels& labels) {
+    if (labels.isEmpty()) {
+        return QByteArray();
+    }
+    QByteArray result = "{";
+    for (auto it = labels.begin(); it != labels.end(); ++it) {
+        if (it != labels.begin()) {
+            result += ",";
+        }
+        result += it.key().toUtf8() + "=\"" + escape(it.value(), true) + "\"";
+    }
+    result += "}";
+    return result;
+}
+
+QByteArray Registry::serialize() const {
+    std::lock_guard<std::mutex> guard(_mutex);
+
+    static const char* TYPE_NAMES[] = { "counter", "gauge", "histogram" };
+
+    QByteArray out;
+    for (const auto& entry : _families) {
+        QByteArray name = entry.first.toUtf8();
+        const Family& family = entry.second;
+        out += "# HELP " + name + " " + escape(family.help, false) + "\n";
+        out += "# TYPE " + name + " " + TYPE_NAMES[family.type] + "\n";
+
+        for (const auto& series : family.series) {
+            Labels labels = _commonLabels;
+            for (auto it = series->labels.begin(); it != series->labels.end(); ++it) {
+                labels[it.key()] = it.value();
+            }
+
+            switch (family.type) {
+                case CounterType:
+                    if (series->counter) {
+                        out += name + formatLabels(labels) + " " + QByteArray::number((qulonglong)series->counter->get()) + "\n";
+                    }
+                    break;
+                case GaugeType:
+                    if (series->gauge) {
+                        out += name + formatLabels(labels) + " " + formatValue(series->gauge->get()) + "\n";
+                    }
+                    break;
+                case HistogramType:
+                    if (series->histogram) {
+                        const auto& bounds = series->histogram->getBounds();
+                        auto counts = series->histogram->getCumulativeCounts();
+                        for (size_t i = 0; i < counts.size(); ++i) {
+                            Labels bucketLabels = labels;
+                            bucketLabels["le"] = i < bounds.size() ? QString::fromUtf8(formatValue(bounds[i])) : QString("+Inf");
+                            out += name + "_bucket" + formatLabels(bucketLabels) + " " + QByteArray::number((qulonglong)counts[i]) + "\n";
+                        }
+                        out += name + "_sum" + formatLabels(labels) + " " + formatValue(series->histogram->getSum()) + "\n";
+                        out += name + "_count" + formatLabels(labels) + " " + QByteArray::number((qulonglong)counts.back()) + "\n";
+                    }
+                    break;
+            }
+        }
+    }
+    return out;
+}
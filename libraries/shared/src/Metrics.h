@@ -0,0 +1,124 @@
+//
+//  Metrics.h
+//  libraries/shared/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_Metrics_h
+#define hifi_Metrics_h
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QMap>
+#include <QtCore/QString>
+
+// Typed process metrics, written out in the Prometheus text exposition format for scraping.
+// Metrics are registered once (which takes a lock) and the returned reference is kept by the
+// code that updates them; updating a metric never takes a lock.
+namespace metrics {
+
+using Labels = QMap<QString, QString>;
+
+// the content type of Registry::serialize()
+extern const char* CONTENT_TYPE;
+
+// A total that only goes up, e.g. packets sent
+class Counter {
+public:
+    void increment(uint64_t amount = 1) { _value.fetch_add(amount, std::memory_order_relaxed); }
+    uint64_t get() const { return _value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<uint64_t> _value { 0 };
+};
+
+// A value that goes up and down, e.g. connected nodes
+class Gauge {
+public:
+    void set(double value) { _value.store(value, std::memory_order_relaxed); }
+    double get() const { return _value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<double> _value { 0.0 };
+};
+
+// Counts of values in fixed buckets, e.g. frame times. Buckets are plain atomic counts so values
+// can be recorded from any number of threads in per frame code.
+class Histogram {
+public:
+    // the upper bounds of the buckets, increasing; larger values only count in the +Inf bucket
+    Histogram(const std::vector<double>& bounds);
+
+    void record(double value);
+
+    const std::vector<double>& getBounds() const { return _bounds; }
+    // one count per bound, then the +Inf bucket, each including the buckets below it
+    std::vector<uint64_t> getCumulativeCounts() const;
+    uint64_t getCount() const;
+    double getSum() const { return _sum.load(std::memory_order_relaxed); }
+
+    // count bounds, starting at start and each factor times the previous one
+    static std::vector<double> exponentialBounds(double start, double factor, int count);
+
+private:
+    const std::vector<double> _bounds;
+    std::unique_ptr<std::atomic<uint64_t>[]> _counts;
+    std::atomic<double> _sum { 0.0 };
+};
+
+class Registry {
+public:
+    static Registry& getInstance();
+
+    // The same name and labels always give back the same metric. A name is a family of metrics
+    // of one type and help text, which are taken from its first registration.
+    Counter& counter(const QString& name, const QString& help, const Labels& labels = Labels());
+    Gauge& gauge(const QString& name, const QString& help, const Labels& labels = Labels());
+    Histogram& histogram(const QString& name, const QString& help, const std::vector<double>& bounds,
+                         const Labels& labels = Labels());
+
+    // labels added to every metric when written out, e.g. the assignment type
+    void setCommonLabels(const Labels& labels);
+
+    QByteArray serialize() const;
+
+private:
+    enum Type {
+        CounterType,
+        GaugeType,
+        HistogramType
+    };
+
+    struct Series {
+        Labels labels;
+        std::unique_ptr<Counter> counter;
+        std::unique_ptr<Gauge> gauge;
+        std::unique_ptr<Histogram> histogram;
+    };
+
+    struct Family {
+        Type type;
+        QString help;
+        std::vector<std::unique_ptr<Series>> series;
+    };
+
+    Series& getSeries(const QString& name, const QString& help, Type type, const Labels& labels);
+
+    mutable std::mutex _mutex;
+    std::map<QString, Family> _families;
+    Labels _commonLabels;
+};
+
+}
+
+#endif // hifi_Metrics_h
@@ -9,12 +9,19 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <algorithm>
+#include <cmath>
 #include <cstdio>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include <QDebug>
 #include <QThread>
+#include <QThreadStorage>
 
 #include "PerfStat.h"
 
@@ -65,42 +72,220 @@ PerformanceWarning::~PerformanceWarning() {
 // ----------------------------------------------------------------------------
 const quint64 STALE_STAT_PERIOD = 4 * USECS_PER_SECOND;
 
+const int PerformanceTimerRecord::NUM_FRAME_SAMPLES;
+
 void PerformanceTimerRecord::tallyResult(const quint64& now) {
     if (_numAccumulations > 0) {
         _numTallies++;
-        _movingAverage.updateAverage(_runningTotal - _lastTotal);
+        quint64 frameTotal = _runningTotal - _lastTotal;
+        _movingAverage.updateAverage(frameTotal);
         _lastTotal = _runningTotal;
         _numAccumulations = 0;
         _expiry = now + STALE_STAT_PERIOD;
+
+        _frameSamples[_nextFrameSample] = frameTotal;
+        _nextFrameSample = (_nextFrameSample + 1) % NUM_FRAME_SAMPLES;
+        _numFrameSamples = std::min(_numFrameSamples + 1, NUM_FRAME_SAMPLES);
+    }
+}
+
+quint64 PerformanceTimerRecord::getPercentile(float percentile) const {
+    if (_numFrameSamples == 0) {
+        return 0;
     }
+    // nearest rank
+    std::array<quint64, NUM_FRAME_SAMPLES> samples = _frameSamples;
+    int rank = (int)ceilf(std::min(std::max(percentile, 0.0f), 100.0f) / 100.0f * _numFrameSamples);
+    auto nth = samples.begin() + std::max(rank - 1, 0);
+    std::nth_element(samples.begin(), nth, samples.begin() + _numFrameSamples);
+    return *nth;
 }
 
 // ----------------------------------------------------------------------------
 // PerformanceTimer
 // ----------------------------------------------------------------------------
 
+using ScopeID = PerformanceTimer::ScopeID;
+
+const int PerformanceTimer::MAX_NODES_PER_THREAD;
+
+// A scope reached through its parent scopes on one thread. Only that thread adds to it,
+// tallyAllTimerRecords() takes what it added since the last frame.
+struct ScopeNode {
+    QString fullName;
+    std::atomic<quint64> elapsed { 0 };
+    std::atomic<quint64> count { 0 };
+};
+
+class ThreadTimerRecords {
+public:
+    ThreadTimerRecords() : nodes(new ScopeNode[PerformanceTimer::MAX_NODES_PER_THREAD]) {}
+
+    std::unique_ptr<ScopeNode[]> nodes;
+    std::atomic<int> numNodes { 1 }; // the root, with an empty name; names are set before a node is counted
+    std::atomic<quint64> numDropped { 0 }; // scopes timed since the last tally that had no room for a node
+    std::atomic<bool> isFinished { false };
+};
+
+using ThreadTimerRecordsPointer = std::shared_ptr<ThreadTimerRecords>;
+
+// Shared by all the threads
+class TimerState {
+public:
+    std::mutex namesMutex;
+    QHash<QString, ScopeID> nameIDs;
+    std::vector<QString> names;
+
+    std::mutex threadsMutex;
+    std::vector<ThreadTimerRecordsPointer> threads;
+
+    std::mutex recordsMutex;
+    QMap<QString, PerformanceTimerRecord> records;
+    quint64 numDroppedScopes { 0 };
+};
+
+static TimerState& getState() {
+    static TimerState state;
+    return state;
+}
+
+// Per thread scope tree and name cache, so that timing a scope takes no lock
+class ThreadTimerState {
+public:
+    ThreadTimerState() : records(std::make_shared<ThreadTimerRecords>()) {
+        auto& state = getState();
+        std::lock_guard<std::mutex> guard(state.threadsMutex);
+        state.threads.push_back(records);
+    }
+
+    ~ThreadTimerState() {
+        records->isFinished = true;
+    }
+
+    // the node for scope under the current node, or -1 once this thread has too many
+    int enter(ScopeID scope) {
+        quint64 key = ((quint64)currentNode << 32) | scope;
+        auto it = children.find(key);
+        if (it != children.end()) {
+            return it->second;
+        }
+
+        int node = records->numNodes.load(std::memory_order_relaxed);
+        if (node == PerformanceTimer::MAX_NODES_PER_THREAD) {
+            records->numDropped.fetch_add(1, std::memory_order_relaxed);
+            return -1;
+        }
+        QString name;
+        {
+            auto& state = getState();
+            std::lock_guard<std::mutex> guard(state.namesMutex);
+            name = state.names[scope];
+        }
+        records->nodes[node].fullName = records->nodes[currentNode].fullName + "/" + name;
+        records->numNodes.store(node + 1, std::memory_order_release);
+        children[key] = node;
+        return node;
+    }
+
+    ThreadTimerRecordsPointer records;
+    int currentNode { 0 };
+    std::unordered_map<quint64, int> children;
+    QHash<QString, ScopeID> nameIDs;
+};
+
+static QThreadStorage<ThreadTimerState*> threadTimerStates;
+
+static ThreadTimerState& getThreadState() {
+    if (!threadTimerStates.hasLocalData()) {
+        threadTimerStates.setLocalData(new ThreadTimerState());
+    }
+    return *threadTimerStates.localData();
+}
+
+// hands what every thread timed since the last call to f(fullName, elapsed, count),
+// and returns how many scopes they dropped since then
+template <typename F>
+static quint64 drainThreads(F f) {
+    auto& state = getState();
+    std::vector<ThreadTimerRecordsPointer> threads;
+    {
+        std::lock_guard<std::mutex> guard(state.threadsMutex);
+        threads = state.threads;
+    }
+    quint64 numDropped = 0;
+    for (const auto& thread : threads) {
+        numDropped += thread->numDropped.exchange(0, std::memory_order_relaxed);
+        int numNodes = thread->numNodes.load(std::memory_order_acquire);
+        for (int i = 1; i < numNodes; ++i) {
+            ScopeNode& node = thread->nodes[i];
+            quint64 count = node.count.exchange(0, std::memory_order_relaxed);
+            if (count > 0) {
+                f(node.fullName, node.elapsed.exchange(0, std::memory_order_relaxed), count);
+            }
+        }
+    }
+
+    // forget the records of exited threads, they were drained above
+    std::lock_guard<std::mutex> guard(state.threadsMutex);
+    state.threads.erase(std::remove_if(state.threads.begin(), state.threads.end(), [](const ThreadTimerRecordsPointer& thread) {
+        return thread->isFinished.load();
+    }), state.threads.end());
+    return numDropped;
+}
+
 std::atomic<bool> PerformanceTimer::_isActive(false);
-QHash<QThread*, QString> PerformanceTimer::_fullNames;
-QMap<QString, PerformanceTimerRecord> PerformanceTimer::_records;
 
+// static
+ScopeID PerformanceTimer::internName(const QString& name) {
+    auto& state = getState();
+    std::lock_guard<std::mutex> guard(state.namesMutex);
+    auto it = state.nameIDs.find(name);
+    if (it != state.nameIDs.end()) {
+        return it.value();
+    }
+    ScopeID scope = (ScopeID)state.names.size();
+    state.names.push_back(name);
+    state.nameIDs.insert(name, scope);
+    return scope;
+}
+
+PerformanceTimer::PerformanceTimer(ScopeID scope) {
+    if (_isActive) {
+        start(scope);
+    }
+}
 
 PerformanceTimer::PerformanceTimer(const QString& name) {
     if (_isActive) {
-        _name = name;
-        QString& fullName = _fullNames[QThread::currentThread()];
-        fullName.append("/");
-        fullName.append(_name);
+        // only the first use of a name on each thread takes the lock
+        auto& nameIDs = getThreadState().nameIDs;
+        auto it = nameIDs.find(name);
+        if (it == nameIDs.end()) {
+            it = nameIDs.insert(name, internName(name));
+        }
+        start(it.value());
+    }
+}
+
+void PerformanceTimer::start(ScopeID scope) {
+    auto& threadState = getThreadState();
+    int node = threadState.enter(scope);
+    if (node >= 0) {
+        _parentNode = threadState.currentNode;
+        _node = node;
+        threadState.currentNode = node;
         _start = usecTimestampNow();
     }
 }
 
 PerformanceTimer::~PerformanceTimer() {
-    if (_isActive && _start != 0) {
+    if (_start != 0) {
         quint64 elapsedUsec = (usecTimestampNow() - _start);
-        QString& fullName = _fullNames[QThread::currentThread()];
-        PerformanceTimerRecord& namedRecord = _records[fullName];
-        namedRecord.accumulateResult(elapsedUsec);
-        fullName.resize(fullName.size() - (_name.size() + 1));
+        auto& threadState = getThreadState();
+        ScopeNode& node = threadState.records->nodes[_node];
+        node.elapsed.fetch_add(elapsedUsec, std::memory_order_relaxed);
+        node.count.fetch_add(1, std::memory_order_relaxed);
+        threadState.currentNode = _parentNode;
     }
 }
 
@@ -111,13 +296,29 @@ bool PerformanceTimer::isActive() {
 
 // static
 QString PerformanceTimer::getContextName() {
-    return _fullNames[QThread::currentThread()];
+    auto& threadState = getThreadState();
+    return threadState.records->nodes[threadState.currentNode].fullName;
 }
 
 // static
 void PerformanceTimer::addTimerRecord(const QString& fullName, quint64 elapsedUsec) {
-    PerformanceTimerRecord& namedRecord = _records[fullName];
-    namedRecord.accumulateResult(elapsedUsec);
+    auto& state = getState();
+    std::lock_guard<std::mutex> guard(state.recordsMutex);
+    state.records[fullName].accumulateResult(elapsedUsec);
+}
+
+// static
+PerformanceTimerRecord PerformanceTimer::getTimerRecord(const QString& name) {
+    auto& state = getState();
+    std::lock_guard<std::mutex> guard(state.recordsMutex);
+    return state.records.value(name);
+}
+
+// static
+QMap<QString, PerformanceTimerRecord> PerformanceTimer::getAllTimerRecords() {
+    auto& state = getState();
+    std::lock_guard<std::mutex> guard(state.recordsMutex);
+    return state.records;
 }
 
 // static
@@ -125,8 +326,11 @@ void PerformanceTimer::setActive(bool active) {
     if (active != _isActive) {
         _isActive.store(active);
         if (!active) {
-            _fullNames.clear();
-            _records.clear();
+            drainThreads([](const QString&, quint64, quint64) {});
+            auto& state = getState();
+            std::lock_guard<std::mutex> guard(state.recordsMutex);
+            state.records.clear();
+            state.numDroppedScopes = 0;
         }
 
         qCDebug(shared) << "PerformanceTimer has been turned" << ((active) ? "on" : "off");
@@ -135,26 +339,52 @@ void PerformanceTimer::setActive(bool active) {
 
 // static
 void PerformanceTimer::tallyAllTimerRecords() {
-    QMap<QString, PerformanceTimerRecord>::iterator recordsItr = _records.begin();
-    QMap<QString, PerformanceTimerRecord>::const_iterator recordsEnd = _records.end();
+    auto& state = getState();
+    std::lock_guard<std::mutex> guard(state.recordsMutex);
+    quint64 numDropped = drainThreads([&](const QString& fullName, quint64 elapsed, quint64 count) {
+        state.records[fullName].accumulateResult(elapsed, count);
+    });
+    if (numDropped > 0) {
+        if (state.numDroppedScopes == 0) {
+            qCWarning(shared) << "PerformanceTimer is dropping scopes, a thread has timed more than"
+                << PerformanceTimer::MAX_NODES_PER_THREAD - 1 << "different ones";
+        }
+        state.numDroppedScopes += numDropped;
+    }
+
+    QMap<QString, PerformanceTimerRecord>::iterator recordsItr = state.records.begin();
+    QMap<QString, PerformanceTimerRecord>::const_iterator recordsEnd = state.records.end();
     quint64 now = usecTimestampNow();
     while (recordsItr != recordsEnd) {
         recordsItr.value().tallyResult(now);
         if (recordsItr.value().isStale(now)) {
             // purge stale records
-            recordsItr = _records.erase(recordsItr);
+            recordsItr = state.records.erase(recordsItr);
         } else {
             ++recordsItr;
         }
     }
 }
 
+// static
+quint64 PerformanceTimer::getNumDroppedScopes() {
+    auto& state = getState();
+    std::lock_guard<std::mutex> guard(state.recordsMutex);
+    return state.numDroppedScopes;
+}
+
 void PerformanceTimer::dumpAllTimerRecords() {
-    QMapIterator<QString, PerformanceTimerRecord> i(_records);
+    auto numDropped = getNumDroppedScopes();
+    if (numDropped > 0) {
+        qCDebug(shared) << "PerformanceTimer dropped" << numDropped << "scopes, threads had too many to keep";
+    }
+    QMapIterator<QString, PerformanceTimerRecord> i(getAllTimerRecords());
     while (i.hasNext()) {
         i.next();
         qCDebug(shared) << i.key() << ": average " << i.value().getAverage()
             << " [" << i.value().getMovingAverage() << "]"
+            << "p50/p95/p99" << i.value().getPercentile(50.0f) << "/" << i.value().getPercentile(95.0f)
+            << "/" << i.value().getPercentile(99.0f)
             << "usecs over" << i.value().getCount() << "calls";
     }
 }
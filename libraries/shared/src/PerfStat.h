@@ -19,6 +19,7 @@
 #include "SharedUtil.h"
 #include "SimpleMovingAverage.h"
 
+#include <array>
 #include <atomic>
 #include <cstring>
 #include <string>
@@ -57,25 +58,51 @@ class PerformanceTimerRecord {
 public:
     PerformanceTimerRecord() : _runningTotal(0), _lastTotal(0), _numAccumulations(0), _numTallies(0), _expiry(0) {}
 
-    void accumulateResult(const quint64& elapsed) { _runningTotal += elapsed; ++_numAccumulations; }
+    void accumulateResult(const quint64& elapsed, quint64 count = 1) {
+        _runningTotal += elapsed;
+        _numAccumulations += count;
+        _numCalls += count;
+    }
     void tallyResult(const quint64& now);
     bool isStale(const quint64& now) const { return now > _expiry; }
     quint64 getAverage() const { return (_numTallies == 0) ? 0 : _runningTotal / _numTallies; }
     quint64 getMovingAverage() const { return (_numTallies == 0) ? 0 : _movingAverage.getAverage(); }
     quint64 getCount() const { return _numTallies; }
+    // over every frame so far
+    quint64 getTotal() const { return _runningTotal; }
+    quint64 getNumCalls() const { return _numCalls; }
+
+    // the given percentile (0 to 100) of the per frame totals over the last NUM_FRAME_SAMPLES frames
+    quint64 getPercentile(float percentile) const;
+
+    static const int NUM_FRAME_SAMPLES = 120;
 
 private:
     quint64 _runningTotal;
     quint64 _lastTotal;
     quint64 _numAccumulations;
     quint64 _numTallies;
+    quint64 _numCalls { 0 };
     quint64 _expiry;
     SimpleMovingAverage _movingAverage;
+    std::array<quint64, NUM_FRAME_SAMPLES> _frameSamples;
+    int _numFrameSamples { 0 };
+    int _nextFrameSample { 0 };
 };
 
+// Times a scope and its nested scopes, named like "/paintGL/display". Each thread accumulates into
+// its own slots without taking a lock, and tallyAllTimerRecords() merges them once per frame.
 class PerformanceTimer {
 public:
+    using ScopeID = uint32_t;
+
+    // scopes a thread keeps, each name under each parent scope being one, including an unnamed root
+    static const int MAX_NODES_PER_THREAD = 1024;
+
+    // the same name always gives back the same id, see PERFORMANCE_TIMER
+    static ScopeID internName(const QString& name);
 
+    PerformanceTimer(ScopeID scope);
     PerformanceTimer(const QString& name);
     ~PerformanceTimer();
 
@@ -84,18 +111,27 @@ public:
 
     static QString getContextName();
     static void addTimerRecord(const QString& fullName, quint64 elapsedUsec);
-    static const PerformanceTimerRecord& getTimerRecord(const QString& name) { return _records[name]; };
-    static const QMap<QString, PerformanceTimerRecord>& getAllTimerRecords() { return _records; };
+    static PerformanceTimerRecord getTimerRecord(const QString& name);
+    static QMap<QString, PerformanceTimerRecord> getAllTimerRecords();
     static void tallyAllTimerRecords();
     static void dumpAllTimerRecords();
 
+    // scopes that went untimed, as tallied so far, because their thread already had as many as it can keep
+    static quint64 getNumDroppedScopes();
+
 private:
+    void start(ScopeID scope);
+
     quint64 _start = 0;
-    QString _name;
+    int _node { 0 };
+    int _parentNode { 0 };
     static std::atomic<bool> _isActive;
-    static QHash<QThread*, QString> _fullNames;
-    static QMap<QString, PerformanceTimerRecord> _records;
 };
 
+// Times the rest of the enclosing scope, interning its name the first time through
+#define PERFORMANCE_TIMER(name) \
+    static const PerformanceTimer::ScopeID perfTimerScope = PerformanceTimer::internName(name); \
+    PerformanceTimer perfTimer(perfTimerScope)
+
 
 #endif // hifi_PerfStat_h
@@ -0,0 +1,170 @@
+//
+//  PickQueue.cpp
+//  libraries/shared/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "PickQueue.h"
+
+PickQuery PickQuery::fromVariantMap(const QVariantMap& properties) {
+    PickQuery query;
+    if (properties.value("type").toString() == "sphere") {
+        query.shape = Sphere;
+        query.center = vec3FromVariant(properties.value("center"));
+        query.radius = properties.value("radius").toFloat();
+    } else {
+        query.ray.origin = vec3FromVariant(properties.value("origin"));
+        query.ray.direction = vec3FromVariant(properties.value("direction"));
+    }
+
+    auto setFlag = [&](const char* name, int flag, bool defaultValue) {
+        if (properties.value(name, defaultValue).toBool()) {
+            query.flags |= flag;
+        } else {
+            query.flags &= ~flag;
+        }
+    };
+    setFlag("entities", PICK_ENTITIES, true);
+    setFlag("overlays", PICK_OVERLAYS, true);
+    setFlag("avatars", PICK_AVATARS, true);
+    setFlag("precise", PICK_PRECISE, false);
+    setFlag("visibleOnly", PICK_VISIBLE_ONLY, false);
+    setFlag("collidableOnly", PICK_COLLIDABLE_ONLY, false);
+
+    for (auto& id : properties.value("include").toList()) {
+        query.idsToInclude.push_back(QUuid(id.toString()));
+    }
+    for (auto& id : properties.value("ignore").toList()) {
+        query.idsToDiscard.push_back(QUuid(id.toString()));
+    }
+    return query;
+}
+
+QVariantMap PickResult::toVariantMap() const {
+    QVariantMap map;
+    map["intersects"] = type != NoneType;
+
+    QString typeName;
+    switch (type) {
+        case EntityType:
+            typeName = "entity";
+            break;
+        case OverlayType:
+            typeName = "overlay";
+            break;
+        case AvatarType:
+            typeName = "avatar";
+            break;
+        case NoneType:
+            typeName = "none";
+            break;
+    }
+    map["type"] = typeName;
+    map["objectID"] = objectID;
+    map["distance"] = distance;
+
+    QString faceName;
+    // handle BoxFace
+    switch (face) {
+        case MIN_X_FACE:
+            faceName = "MIN_X_FACE";
+            break;
+        case MAX_X_FACE:
+            faceName = "MAX_X_FACE";
+            break;
+        case MIN_Y_FACE:
+            faceName = "MIN_Y_FACE";
+            break;
+        case MAX_Y_FACE:
+            faceName = "MAX_Y_FACE";
+            break;
+        case MIN_Z_FACE:
+            faceName = "MIN_Z_FACE";
+            break;
+        case MAX_Z_FACE:
+            faceName = "MAX_Z_FACE";
+            break;
+        case UNKNOWN_FACE:
+            faceName = "UNKNOWN_FACE";
+            break;
+    }
+    map["face"] = faceName;
+    map["intersection"] = vec3toVariant(intersection);
+    map["surfaceNormal"] = vec3toVariant(surfaceNormal);
+    map["accurate"] = accurate;
+    return map;
+}
+
+void PickQueue::Batch::clear() {
+    pickIDs.clear();
+    queries.clear();
+    oneShotQueries.clear();
+    oneShotCallbacks.clear();
+    results.clear();
+}
+
+unsigned int PickQueue::addPick(const PickQuery& query) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    unsigned int pickID = _nextPickID++;
+    _picks[pickID] = query;
+    _results[pickID] = PickResult();
+    return pickID;
+}
+
+void PickQueue::editPick(unsigned int pickID, const PickQuery& query) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto pick = _picks.find(pickID);
+    if (pick != _picks.end()) {
+        pick->second = query;
+    }
+}
+
+void PickQueue::removePick(unsigned int pickID) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _picks.erase(pickID);
+    _results.erase(pickID);
+}
+
+PickResult PickQueue::getPickResult(unsigned int pickID) const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto result = _results.find(pickID);
+    return result != _results.end() ? result->second : PickResult();
+}
+
+void PickQueue::pickOnce(const PickQuery& query, Callback callback) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _oneShotPicks.emplace_back(query, callback);
+}
+
+void PickQueue::takeQueries(Batch& batch) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (auto& pick : _picks) {
+        batch.pickIDs.push_back(pick.first);
+        batch.queries.push_back(pick.second);
+    }
+    for (auto& oneShot : _oneShotPicks) {
+        batch.oneShotQueries.push_back(std::move(oneShot.first));
+        batch.oneShotCallbacks.push_back(std::move(oneShot.second));
+    }
+    _oneShotPicks.clear();
+}
+
+void PickQueue::setResults(const Batch& batch) {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        for (size_t i = 0; i < batch.pickIDs.size(); i++) {
+            // it may have been removed while it was being picked
+            if (_picks.find(batch.pickIDs[i]) != _picks.end()) {
+                _results[batch.pickIDs[i]] = batch.results[i];
+            }
+        }
+    }
+    size_t offset = batch.queries.size();
+    for (size_t i = 0; i < batch.oneShotCallbacks.size(); i++) {
+        batch.oneShotCallbacks[i](batch.results[offset + i]);
+    }
+}
@@ -0,0 +1,115 @@
+//
+//  PickQueue.h
+//  libraries/shared/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_PickQueue_h
+#define hifi_PickQueue_h
+
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include <QtCore/QUuid>
+#include <QtCore/QVariantMap>
+#include <QtCore/QVector>
+
+#include "BoxBase.h"
+#include "RegisteredMetaTypes.h"
+
+// What to pick against, and how.
+class PickQuery {
+public:
+    enum Shape { Ray, Sphere };
+    enum Flags {
+        PICK_ENTITIES = 1 << 0,
+        PICK_OVERLAYS = 1 << 1,
+        PICK_AVATARS = 1 << 2,
+        PICK_PRECISE = 1 << 3, // against models' triangles rather than their boxes
+        PICK_VISIBLE_ONLY = 1 << 4,
+        PICK_COLLIDABLE_ONLY = 1 << 5
+    };
+
+    static PickQuery fromVariantMap(const QVariantMap& properties);
+
+    Shape shape { Ray };
+    PickRay ray;
+    glm::vec3 center; // of a sphere
+    float radius { 0.0f };
+    int flags { PICK_ENTITIES | PICK_OVERLAYS | PICK_AVATARS };
+
+    // entities, overlays and avatars are included or discarded by ID, which they never share
+    QVector<QUuid> idsToInclude;
+    QVector<QUuid> idsToDiscard;
+};
+
+// The nearest thing a pick found. A ray's distance is along it; a sphere's is from its center to the thing's position,
+// which is also its intersection.
+class PickResult {
+public:
+    enum Type { NoneType, EntityType, OverlayType, AvatarType };
+
+    QVariantMap toVariantMap() const;
+
+    Type type { NoneType };
+    QUuid objectID;
+    float distance { 0.0f };
+    BoxFace face { UNKNOWN_FACE };
+    glm::vec3 intersection;
+    glm::vec3 surfaceNormal;
+    bool accurate { true };
+};
+
+// The picks asked for, from any thread, and their latest results. Whatever does the picking takes the pending queries
+// a batch at a time and hands the batch back with its results: a kept pick's result replaces its last one, unless
+// it was removed in the meantime, and a one-shot pick's goes to its callback.
+class PickQueue {
+public:
+    using Callback = std::function<void(const PickResult&)>;
+
+    class Batch {
+    public:
+        bool isEmpty() const { return pickIDs.empty() && oneShotQueries.empty(); }
+        size_t size() const { return queries.size() + oneShotQueries.size(); }
+        // queries then oneShotQueries
+        const PickQuery& queryAt(size_t i) const {
+            return i < queries.size() ? queries[i] : oneShotQueries[i - queries.size()];
+        }
+        void clear();
+
+        std::vector<unsigned int> pickIDs;
+        std::vector<PickQuery> queries;
+        std::vector<PickQuery> oneShotQueries;
+        std::vector<Callback> oneShotCallbacks;
+
+        // one for each query, in queryAt's order
+        std::vector<PickResult> results;
+    };
+
+    unsigned int addPick(const PickQuery& query);
+    void editPick(unsigned int pickID, const PickQuery& query);
+    void removePick(unsigned int pickID);
+    PickResult getPickResult(unsigned int pickID) const;
+
+    void pickOnce(const PickQuery& query, Callback callback);
+
+    // adds every kept pick and every pending one-shot pick to the batch, which is expected to be empty
+    void takeQueries(Batch& batch);
+    // calls the one-shot callbacks on this thread, without the queue locked, so they may ask for more picks
+    void setResults(const Batch& batch);
+
+private:
+    mutable std::mutex _mutex;
+    unsigned int _nextPickID { 1 };
+    std::unordered_map<unsigned int, PickQuery> _picks;
+    std::unordered_map<unsigned int, PickResult> _results;
+    std::vector<std::pair<PickQuery, Callback>> _oneShotPicks;
+};
+
+#endif // hifi_PickQueue_h
@@ -11,6 +11,7 @@
 Q_LOGGING_CATEGORY(trace_app, "trace.app")
 Q_LOGGING_CATEGORY(trace_app_detail, "trace.app.detail")
 Q_LOGGING_CATEGORY(trace_metadata, "trace.metadata")
+Q_LOGGING_CATEGORY(trace_mixer, "trace.mixer")
 Q_LOGGING_CATEGORY(trace_network, "trace.network")
 Q_LOGGING_CATEGORY(trace_parse, "trace.parse")
 Q_LOGGING_CATEGORY(trace_render, "trace.render")
@@ -33,34 +34,48 @@ Q_LOGGING_CATEGORY(trace_simulation_physics_detail, "trace.simulation.physics.de
 #define NSIGHT_TRACING
 #endif
 
-static bool tracingEnabled() {
-    return DependencyManager::get<tracing::Tracer>()->isEnabled();
+Duration::Duration(const QLoggingCategory& category, const QString& name, uint32_t argbColor, uint64_t payload, const QVariantMap& baseArgs) : _category(category) {
+    if (tracing::enabled() && category.isDebugEnabled()) {
+        begin(tracing::internName(name), argbColor, payload, baseArgs);
+    }
+}
+
+Duration::Duration(const QLoggingCategory& category, const char* name, uint32_t argbColor, uint64_t payload, const QVariantMap& baseArgs) : _category(category) {
+    if (tracing::enabled() && category.isDebugEnabled()) {
+        begin(tracing::internName(name), argbColor, payload, baseArgs);
+    }
 }
 
-Duration::Duration(const QLoggingCategory& category, const QString& name, uint32_t argbColor, uint64_t payload, const QVariantMap& baseArgs) : _name(name), _category(category) {
-    if (tracingEnabled() && category.isDebugEnabled()) {
+void Duration::begin(uint32_t name, uint32_t argbColor, uint64_t payload, const QVariantMap& baseArgs) {
+    _name = name;
+    if (baseArgs.empty()) {
+        static const uint32_t PAYLOAD_KEY = tracing::internName(QString("nv_payload"));
+        tracing::TraceArg arg = tracing::TraceArg::fromInt(PAYLOAD_KEY, (int64_t)payload);
+        tracing::traceEvent(_category, _name, tracing::DurationBegin, &arg, 1);
+    } else {
         QVariantMap args = baseArgs;
         args["nv_payload"] = QVariant::fromValue(payload);
-        tracing::traceEvent(_category, _name, tracing::DurationBegin, "", args);
+        tracing::traceEvent(_category, tracing::getName(_name), tracing::DurationBegin, "", args);
+    }
 
 #if defined(NSIGHT_TRACING)
-        nvtxEventAttributes_t eventAttrib { 0 };
-        eventAttrib.version = NVTX_VERSION;
-        eventAttrib.size = NVTX_EVENT_ATTRIB_STRUCT_SIZE;
-        eventAttrib.colorType = NVTX_COLOR_ARGB;
-        eventAttrib.color = argbColor;
-        eventAttrib.messageType = NVTX_MESSAGE_TYPE_ASCII;
-        eventAttrib.message.ascii = name.toUtf8().data();
-        eventAttrib.payload.llValue = payload;
-        eventAttrib.payloadType = NVTX_PAYLOAD_TYPE_UNSIGNED_INT64;
+    nvtxEventAttributes_t eventAttrib { 0 };
+    eventAttrib.version = NVTX_VERSION;
+    eventAttrib.size = NVTX_EVENT_ATTRIB_STRUCT_SIZE;
+    eventAttrib.colorType = NVTX_COLOR_ARGB;
+    eventAttrib.color = argbColor;
+    eventAttrib.messageType = NVTX_MESSAGE_TYPE_ASCII;
+    QByteArray asciiName = tracing::getName(_name).toUtf8();
+    eventAttrib.message.ascii = asciiName.constData();
+    eventAttrib.payload.llValue = payload;
+    eventAttrib.payloadType = NVTX_PAYLOAD_TYPE_UNSIGNED_INT64;
 
-        nvtxRangePushEx(&eventAttrib);
+    nvtxRangePushEx(&eventAttrib);
 #endif
-    }
 }
 
 Duration::~Duration() {
-    if (tracingEnabled() && _category.isDebugEnabled()) {
+    if (_name != 0) {
         tracing::traceEvent(_category, _name, tracing::DurationEnd);
 #ifdef NSIGHT_TRACING
         nvtxRangePop();
@@ -71,7 +86,7 @@ Duration::~Duration() {
 // FIXME
 uint64_t Duration::beginRange(const QLoggingCategory& category, const char* name, uint32_t argbColor) {
 #ifdef NSIGHT_TRACING
-    if (tracingEnabled() && category.isDebugEnabled()) {
+    if (tracing::enabled() && category.isDebugEnabled()) {
         nvtxEventAttributes_t eventAttrib = { 0 };
         eventAttrib.version = NVTX_VERSION;
         eventAttrib.size = NVTX_EVENT_ATTRIB_STRUCT_SIZE;
@@ -88,7 +103,7 @@ uint64_t Duration::beginRange(const QLoggingCategory& category, const char* name
 // FIXME
 void Duration::endRange(const QLoggingCategory& category, uint64_t rangeId) {
 #ifdef NSIGHT_TRACING
-    if (tracingEnabled() && category.isDebugEnabled()) {
+    if (tracing::enabled() && category.isDebugEnabled()) {
         nvtxRangeEnd(rangeId);
     }
 #endif
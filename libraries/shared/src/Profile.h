@@ -17,6 +17,7 @@
 Q_DECLARE_LOGGING_CATEGORY(trace_app)
 Q_DECLARE_LOGGING_CATEGORY(trace_app_detail)
 Q_DECLARE_LOGGING_CATEGORY(trace_metadata)
+Q_DECLARE_LOGGING_CATEGORY(trace_mixer)
 Q_DECLARE_LOGGING_CATEGORY(trace_network)
 Q_DECLARE_LOGGING_CATEGORY(trace_render)
 Q_DECLARE_LOGGING_CATEGORY(trace_render_detail)
@@ -36,38 +37,42 @@ Q_DECLARE_LOGGING_CATEGORY(trace_simulation_physics_detail)
 class Duration {
 public:
     Duration(const QLoggingCategory& category, const QString& name, uint32_t argbColor = 0xff0000ff, uint64_t payload = 0, const QVariantMap& args = QVariantMap());
+    // literal names are interned without building a QString
+    Duration(const QLoggingCategory& category, const char* name, uint32_t argbColor = 0xff0000ff, uint64_t payload = 0, const QVariantMap& args = QVariantMap());
     ~Duration();
 
     static uint64_t beginRange(const QLoggingCategory& category, const char* name, uint32_t argbColor);
     static void endRange(const QLoggingCategory& category, uint64_t rangeId);
 
 private:
-    QString _name;
+    void begin(uint32_t name, uint32_t argbColor, uint64_t payload, const QVariantMap& args);
+
+    uint32_t _name { 0 }; // interned, 0 when no begin event was recorded
     const QLoggingCategory& _category;
 };
 
 inline void asyncBegin(const QLoggingCategory& category, const QString& name, const QString& id, const QVariantMap& args = QVariantMap(), const QVariantMap& extra = QVariantMap()) {
-    if (category.isDebugEnabled()) {
+    if (tracing::enabled() && category.isDebugEnabled()) {
         tracing::traceEvent(category, name, tracing::AsyncNestableStart, id, args, extra);
     }
 }
 
 
 inline void asyncEnd(const QLoggingCategory& category, const QString& name, const QString& id, const QVariantMap& args = QVariantMap(), const QVariantMap& extra = QVariantMap()) {
-    if (category.isDebugEnabled()) {
+    if (tracing::enabled() && category.isDebugEnabled()) {
         tracing::traceEvent(category, name, tracing::AsyncNestableEnd, id, args, extra);
     }
 }
 
 inline void instant(const QLoggingCategory& category, const QString& name, const QString& scope = "t", const QVariantMap& args = QVariantMap(), QVariantMap extra = QVariantMap()) {
-    if (category.isDebugEnabled()) {
+    if (tracing::enabled() && category.isDebugEnabled()) {
         extra["s"] = scope;
         tracing::traceEvent(category, name, tracing::Instant, "", args, extra);
     }
 }
 
 inline void counter(const QLoggingCategory& category, const QString& name, const QVariantMap& args, const QVariantMap& extra = QVariantMap()) {
-    if (category.isDebugEnabled()) {
+    if (tracing::enabled() && category.isDebugEnabled()) {
         tracing::traceEvent(category, name, tracing::Counter, "", args, extra);
     }
 }
@@ -0,0 +1,90 @@
+//
+//  SipHash.cpp
+//  libraries/shared/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "SipHash.h"
+
+// after the reference implementation by Jean-Philippe Aumasson and Daniel J. Bernstein
+
+static inline uint64_t rotateLeft(uint64_t value, int bits) {
+    return (value << bits) | (value >> (64 - bits));
+}
+
+// the input and output are little endian whatever the platform
+static inline uint64_t readLittleEndian64(const uint8_t* bytes) {
+    return (uint64_t)bytes[0] | ((uint64_t)bytes[1] << 8) | ((uint64_t)bytes[2] << 16) | ((uint64_t)bytes[3] << 24)
+        | ((uint64_t)bytes[4] << 32) | ((uint64_t)bytes[5] << 40) | ((uint64_t)bytes[6] << 48) | ((uint64_t)bytes[7] << 56);
+}
+
+static inline void writeLittleEndian64(uint64_t value, uint8_t* bytes) {
+    for (int i = 0; i < 8; ++i) {
+        bytes[i] = (uint8_t)(value >> (8 * i));
+    }
+}
+
+#define SIP_ROUND \
+    do { \
+        v0 += v1; v1 = rotateLeft(v1, 13); v1 ^= v0; v0 = rotateLeft(v0, 32); \
+        v2 += v3; v3 = rotateLeft(v3, 16); v3 ^= v2; \
+        v0 += v3; v3 = rotateLeft(v3, 21); v3 ^= v0; \
+        v2 += v1; v1 = rotateLeft(v1, 17); v1 ^= v2; v2 = rotateLeft(v2, 32); \
+    } while (0)
+
+void sipHash128(const uint8_t key[NUM_BYTES_SIPHASH_KEY], const void* data, size_t length, uint8_t out[NUM_BYTES_SIPHASH_128]) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+
+    uint64_t k0 = readLittleEndian64(key);
+    uint64_t k1 = readLittleEndian64(key + 8);
+
+    uint64_t v0 = 0x736f6d6570736575ULL ^ k0;
+    uint64_t v1 = 0x646f72616e646f6dULL ^ k1 ^ 0xee;
+    uint64_t v2 = 0x6c7967656e657261ULL ^ k0;
+    uint64_t v3 = 0x7465646279746573ULL ^ k1;
+
+    const uint8_t* end = bytes + (length - (length % 8));
+    for (; bytes != end; bytes += 8) {
+        uint64_t m = readLittleEndian64(bytes);
+        v3 ^= m;
+        SIP_ROUND;
+        SIP_ROUND;
+        v0 ^= m;
+    }
+
+    // the last 0 to 7 bytes, with the length in the top byte
+    uint64_t b = ((uint64_t)length) << 56;
+    switch (length & 7) {
+        case 7: b |= ((uint64_t)bytes[6]) << 48; // fall through
+        case 6: b |= ((uint64_t)bytes[5]) << 40; // fall through
+        case 5: b |= ((uint64_t)bytes[4]) << 32; // fall through
+        case 4: b |= ((uint64_t)bytes[3]) << 24; // fall through
+        case 3: b |= ((uint64_t)bytes[2]) << 16; // fall through
+        case 2: b |= ((uint64_t)bytes[1]) << 8; // fall through
+        case 1: b |= ((uint64_t)bytes[0]); break;
+        case 0: break;
+    }
+
+    v3 ^= b;
+    SIP_ROUND;
+    SIP_ROUND;
+    v0 ^= b;
+
+    v2 ^= 0xee;
+    SIP_ROUND;
+    SIP_ROUND;
+    SIP_ROUND;
+    SIP_ROUND;
+    writeLittleEndian64(v0 ^ v1 ^ v2 ^ v3, out);
+
+    v1 ^= 0xdd;
+    SIP_ROUND;
+    SIP_ROUND;
+    SIP_ROUND;
+    SIP_ROUND;
+    writeLittleEndian64(v0 ^ v1 ^ v2 ^ v3, out + 8);
+}
@@ -0,0 +1,24 @@
+//
+//  SipHash.h
+//  libraries/shared/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_SipHash_h
+#define hifi_SipHash_h
+
+#include <cstddef>
+#include <cstdint>
+
+const int NUM_BYTES_SIPHASH_KEY = 16;
+const int NUM_BYTES_SIPHASH_128 = 16;
+
+// SipHash-2-4 with a 128 bit output, a keyed hash that is fast on short inputs like packets.
+// Writes NUM_BYTES_SIPHASH_128 bytes to out, without allocating.
+void sipHash128(const uint8_t key[NUM_BYTES_SIPHASH_KEY], const void* data, size_t length, uint8_t out[NUM_BYTES_SIPHASH_128]);
+
+#endif // hifi_SipHash_h
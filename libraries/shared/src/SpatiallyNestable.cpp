@@ -33,6 +33,7 @@ SpatiallyNestable::SpatiallyNestable(NestableType nestableType, QUuid id) :
 
 SpatiallyNestable::~SpatiallyNestable() {
     forEachChild([&](SpatiallyNestablePointer object) {
+        object->invalidateWorldTransform();
         object->parentDeleted();
     });
 }
@@ -64,12 +65,17 @@ const QUuid SpatiallyNestable::getParentID() const {
 }
 
 void SpatiallyNestable::setParentID(const QUuid& parentID) {
+    bool changed = false;
     _idLock.withWriteLock([&] {
         if (_parentID != parentID) {
             _parentID = parentID;
             _parentKnowsMe = false;
+            changed = true;
         }
     });
+    if (changed) {
+        invalidateWorldTransform();
+    }
 
     bool success = false;
     getParentPointer(success);
@@ -149,7 +155,10 @@ void SpatiallyNestable::forgetChild(SpatiallyNestablePointer newChild) const {
 }
 
 void SpatiallyNestable::setParentJointIndex(quint16 parentJointIndex) {
-    _parentJointIndex = parentJointIndex;
+    if (_parentJointIndex != parentJointIndex) {
+        _parentJointIndex = parentJointIndex;
+        invalidateWorldTransform();
+    }
 }
 
 glm::vec3 SpatiallyNestable::worldToLocal(const glm::vec3& position,
@@ -408,6 +417,9 @@ void SpatiallyNestable::setPosition(const glm::vec3& position, bool& success, bo
             _translationChanged = usecTimestampNow();
         }
     });
+    if (changed) {
+        invalidateWorldTransform();
+    }
     if (success && changed) {
         locationChanged(tellPhysics);
     }
@@ -461,6 +473,9 @@ void SpatiallyNestable::setOrientation(const glm::quat& orientation, bool& succe
             _rotationChanged = usecTimestampNow();
         }
     });
+    if (changed) {
+        invalidateWorldTransform();
+    }
     if (success && changed) {
         locationChanged(tellPhysics);
     }
@@ -596,11 +611,40 @@ glm::vec3 SpatiallyNestable::getParentAngularVelocity(bool& success) const {
 
 const Transform SpatiallyNestable::getTransform(bool& success, int depth) const {
     Transform result;
+    if (isWorldTransformCached()) {
+        bool cached = false;
+        _transformLock.withReadLock([&] {
+            // again, now that it can't be written
+            if (isWorldTransformCached()) {
+                result = _worldTransform;
+                cached = true;
+            }
+        });
+        if (cached) {
+            success = true;
+            return result;
+        }
+    }
+
     // return a world-space transform for this object's location
+    uint32_t version = _transformVersion;
     Transform parentTransform = getParentTransform(success, depth);
     _transformLock.withReadLock([&] {
         Transform::mult(result, parentTransform, _transform);
     });
+
+    if (success) {
+        SpatiallyNestablePointer parent = _parent.lock();
+        if (!parent || (_parentJointIndex == INVALID_JOINT_INDEX && parent->isWorldTransformCached())) {
+            _transformLock.withWriteLock([&] {
+                // unless this or an ancestor changed while it was being computed
+                if (_transformVersion == version) {
+                    _worldTransform = result;
+                    _worldTransformVersion = version;
+                }
+            });
+        }
+    }
     return result;
 }
 
@@ -661,6 +705,9 @@ void SpatiallyNestable::setTransform(const Transform& transform, bool& success)
             _rotationChanged = usecTimestampNow();
         }
     });
+    if (changed) {
+        invalidateWorldTransform();
+    }
     if (success && changed) {
         locationChanged();
     }
@@ -703,6 +750,7 @@ void SpatiallyNestable::setScale(const glm::vec3& scale) {
         }
     });
     if (changed) {
+        invalidateWorldTransform();
         dimensionsChanged();
     }
 }
@@ -726,6 +774,7 @@ void SpatiallyNestable::setScale(float value) {
     });
 
     if (changed) {
+        invalidateWorldTransform();
         dimensionsChanged();
     }
 }
@@ -757,6 +806,7 @@ void SpatiallyNestable::setLocalTransform(const Transform& transform) {
     });
 
     if (changed) {
+        invalidateWorldTransform();
         locationChanged();
     }
 }
@@ -784,6 +834,7 @@ void SpatiallyNestable::setLocalPosition(const glm::vec3& position, bool tellPhy
         }
     });
     if (changed) {
+        invalidateWorldTransform();
         locationChanged(tellPhysics);
     }
 }
@@ -811,6 +862,7 @@ void SpatiallyNestable::setLocalOrientation(const glm::quat& orientation) {
         }
     });
     if (changed) {
+        invalidateWorldTransform();
         locationChanged();
     }
 }
@@ -869,6 +921,7 @@ void SpatiallyNestable::setLocalScale(const glm::vec3& scale) {
         }
     });
     if (changed) {
+        invalidateWorldTransform();
         dimensionsChanged();
     }
 }
@@ -936,6 +989,13 @@ void SpatiallyNestable::forEachDescendant(std::function<void(SpatiallyNestablePo
     }
 }
 
+void SpatiallyNestable::invalidateWorldTransform() {
+    _transformVersion++;
+    forEachChild([&](SpatiallyNestablePointer object) {
+        object->invalidateWorldTransform();
+    });
+}
+
 void SpatiallyNestable::locationChanged(bool tellPhysics) {
     forEachChild([&](SpatiallyNestablePointer object) {
         object->locationChanged(tellPhysics);
@@ -1123,6 +1183,7 @@ void SpatiallyNestable::setLocalTransformAndVelocities(
     });
 
     if (changed) {
+        invalidateWorldTransform();
         locationChanged(false);
     }
 }
@@ -12,6 +12,8 @@
 #ifndef hifi_SpatiallyNestable_h
 #define hifi_SpatiallyNestable_h
 
+#include <atomic>
+
 #include <QUuid>
 
 #include "Transform.h"
@@ -211,11 +213,19 @@ private:
     QUuid _parentID; // what is this thing's transform relative to?
     quint16 _parentJointIndex { INVALID_JOINT_INDEX }; // which joint of the parent is this relative to?
 
+    // world transforms are cached, and recomputed when this or an ancestor changes. A transform relative to a joint
+    // is never cached: joints move without this knowing.
+    bool isWorldTransformCached() const { return _worldTransformVersion == _transformVersion; }
+    void invalidateWorldTransform();
+
     mutable ReadWriteLockable _transformLock;
     mutable ReadWriteLockable _idLock;
     mutable ReadWriteLockable _velocityLock;
     mutable ReadWriteLockable _angularVelocityLock;
     Transform _transform; // this is to be combined with parent's world-transform to produce this' world-transform.
+    mutable Transform _worldTransform; // written under _transformLock
+    std::atomic<uint32_t> _transformVersion { 1 }; // bumped when this or an ancestor changes
+    mutable std::atomic<uint32_t> _worldTransformVersion { 0 }; // the version _worldTransform was computed at
     glm::vec3 _velocity;
     glm::vec3 _angularVelocity;
     mutable bool _parentKnowsMe { false };
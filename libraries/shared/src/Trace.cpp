@@ -8,7 +8,12 @@
 
 #include "Trace.h"
 
+#include <algorithm>
 #include <chrono>
+#include <condition_variable>
+#include <list>
+#include <string>
+#include <unordered_map>
 
 #include <QtCore/QDebug>
 #include <QtCore/QCoreApplication>
@@ -17,6 +22,7 @@
 #include <QtCore/QDir>
 #include <QtCore/QStandardPaths>
 #include <QtCore/QDateTime>
+#include <QtCore/QThreadStorage>
 
 #include <QtCore/QFile>
 #include <QtCore/QFileInfo>
@@ -35,28 +41,478 @@
 
 using namespace tracing;
 
+// records per thread, a power of two
+static const uint32_t TRACE_BUFFER_CAPACITY = 1 << 14;
+static const uint32_t TRACE_BUFFER_MASK = TRACE_BUFFER_CAPACITY - 1;
+static const std::chrono::milliseconds DRAIN_INTERVAL { 10 };
+
+static std::atomic<bool> tracingEnabled { false };
+
+namespace {
+
+// Single producer (the tracing thread), single consumer (the drain) ring of records
+class TraceBuffer {
+public:
+    TraceBuffer(qint64 threadID) :
+        _threadID(threadID), _records(TRACE_BUFFER_CAPACITY), _strings(TRACE_BUFFER_CAPACITY * TraceRecord::MAX_ARGS) {}
+
+    qint64 getThreadID() const { return _threadID; }
+    uint64_t getNumDropped() const { return _numDropped.load(std::memory_order_relaxed); }
+
+    // the first record is the event, the others are its continuations
+    // strings holds the values of the Text arguments, and may be null if there are none
+    // returns true if the buffer is now half full
+    bool push(const TraceRecord& record, const TraceArg* args, const QString* strings, int numArgs) {
+        const int maxArgs = TraceRecord::MAX_ARGS;
+        uint32_t numRecords = 1;
+        if (numArgs > maxArgs) {
+            numRecords += (numArgs - 1) / maxArgs;
+        }
+        uint32_t head = _head.load(std::memory_order_relaxed);
+        uint32_t tail = _tail.load(std::memory_order_acquire);
+        uint32_t used = head - tail;
+        if (TRACE_BUFFER_CAPACITY - used < numRecords) {
+            _numDropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        for (uint32_t i = 0; i < numRecords; ++i) {
+            uint32_t index = (head + i) & TRACE_BUFFER_MASK;
+            TraceRecord& slot = _records[index];
+            slot = record;
+            if (i > 0) {
+                // keeps the timestamp, so that a rolling window drops the event as a whole
+                slot.flags = TraceRecord::Continuation;
+            }
+            int firstArg = i * maxArgs;
+            slot.numArgs = (uint8_t)std::min(numArgs - firstArg, maxArgs);
+            for (int j = 0; j < slot.numArgs; ++j) {
+                slot.args[j] = args[firstArg + j];
+                if (slot.args[j].type == TraceArg::Text) {
+                    _strings[index * maxArgs + j] = strings[firstArg + j];
+                }
+            }
+        }
+        _head.store(head + numRecords, std::memory_order_release);
+
+        const uint32_t HALF_CAPACITY = TRACE_BUFFER_CAPACITY / 2;
+        return used < HALF_CAPACITY && used + numRecords >= HALF_CAPACITY;
+    }
+
+    // f(record, strings) may take the Text argument values out of strings, whatever is left is released
+    template <typename F>
+    void drain(F f) {
+        uint32_t tail = _tail.load(std::memory_order_relaxed);
+        uint32_t head = _head.load(std::memory_order_acquire);
+        for (; tail != head; ++tail) {
+            uint32_t index = tail & TRACE_BUFFER_MASK;
+            const TraceRecord& record = _records[index];
+            QString* strings = &_strings[index * TraceRecord::MAX_ARGS];
+            f(record, strings);
+            for (int j = 0; j < record.numArgs; ++j) {
+                if (record.args[j].type == TraceArg::Text) {
+                    strings[j].clear();
+                }
+            }
+        }
+        _tail.store(tail, std::memory_order_release);
+    }
+
+    bool isEmpty() const { return _head.load(std::memory_order_acquire) == _tail.load(std::memory_order_relaxed); }
+
+    // the thread has exited: once drained, the buffer can go
+    void finish() { _finished = true; }
+    bool isFinished() const { return _finished; }
+
+private:
+    const qint64 _threadID;
+    std::vector<TraceRecord> _records;
+    std::vector<QString> _strings; // MAX_ARGS per record
+    std::atomic<uint32_t> _head { 0 };
+    std::atomic<uint32_t> _tail { 0 };
+    std::atomic<uint64_t> _numDropped { 0 };
+    std::atomic<bool> _finished { false };
+};
+
+using TraceBufferPointer = std::shared_ptr<TraceBuffer>;
+
+// Shared by all the threads, and by all Tracers
+class TraceState {
+public:
+    std::mutex namesMutex;
+    QHash<QString, uint32_t> nameIDs;
+    std::vector<QString> names { QString() };
+
+    std::mutex buffersMutex;
+    std::vector<TraceBufferPointer> buffers;
+    uint64_t numDroppedByFinishedBuffers { 0 };
+
+    std::mutex metadataMutex;
+    std::list<TraceEvent> metadataEvents;
+
+    std::mutex drainMutex;
+    std::condition_variable drainCondition;
+    std::atomic<bool> drainRequested { false };
+};
+
+static TraceState& getState() {
+    static TraceState state;
+    return state;
+}
+
+// Per thread name caches and ring buffer, so that recording an event takes no lock
+class ThreadTraceState {
+public:
+    ~ThreadTraceState() {
+        if (buffer) {
+            buffer->finish();
+        }
+    }
+
+    TraceBuffer& getBuffer() {
+        if (!buffer) {
+            buffer = std::make_shared<TraceBuffer>(int64_t(QThread::currentThreadId()));
+            auto& state = getState();
+            std::lock_guard<std::mutex> guard(state.buffersMutex);
+            state.buffers.push_back(buffer);
+        }
+        return *buffer;
+    }
+
+    TraceBufferPointer buffer;
+    QHash<QString, uint32_t> names;
+    std::unordered_map<const char*, std::pair<uint32_t, std::string>> literalNames;
+};
+
+QThreadStorage<ThreadTraceState*> threadStates;
+
+static ThreadTraceState& getThreadState() {
+    if (!threadStates.hasLocalData()) {
+        threadStates.setLocalData(new ThreadTraceState());
+    }
+    return *threadStates.localData();
+}
+
+static uint64_t getTotalDropped() {
+    auto& state = getState();
+    std::lock_guard<std::mutex> guard(state.buffersMutex);
+    uint64_t total = state.numDroppedByFinishedBuffers;
+    for (const auto& buffer : state.buffers) {
+        total += buffer->getNumDropped();
+    }
+    return total;
+}
+
+template <typename F>
+static void drainBuffers(F f) {
+    auto& state = getState();
+    std::vector<TraceBufferPointer> buffers;
+    {
+        std::lock_guard<std::mutex> guard(state.buffersMutex);
+        buffers = state.buffers;
+    }
+    for (const auto& buffer : buffers) {
+        buffer->drain([&](const TraceRecord& record, QString* strings) {
+            f(buffer->getThreadID(), record, strings);
+        });
+    }
+
+    // forget the buffers of exited threads, nothing can write to them anymore
+    std::lock_guard<std::mutex> guard(state.buffersMutex);
+    auto it = state.buffers.begin();
+    while (it != state.buffers.end()) {
+        if ((*it)->isFinished() && (*it)->isEmpty()) {
+            state.numDroppedByFinishedBuffers += (*it)->getNumDropped();
+            it = state.buffers.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+// strings are stored with the event rather than interned, they are rarely repeated
+static TraceArg toTraceArg(uint32_t key, const QVariant& value, QString& text) {
+    switch ((QMetaType::Type)value.userType()) {
+        case QMetaType::Bool:
+            return TraceArg::fromBool(key, value.toBool());
+        case QMetaType::Int:
+        case QMetaType::UInt:
+        case QMetaType::Long:
+        case QMetaType::ULong:
+        case QMetaType::LongLong:
+        case QMetaType::ULongLong:
+        case QMetaType::Short:
+        case QMetaType::UShort:
+            return TraceArg::fromInt(key, value.toLongLong());
+        case QMetaType::Float:
+        case QMetaType::Double:
+            return TraceArg::fromDouble(key, value.toDouble());
+        default:
+            if (value.canConvert<QString>()) {
+                text = value.toString();
+            } else {
+                // maps and lists end up as a JSON string
+                text = QString::fromUtf8(QJsonDocument::fromVariant(value).toJson(QJsonDocument::Compact));
+            }
+            TraceArg arg { key, TraceArg::Text, false };
+            arg.stringValue = 0; // set when the record is drained
+            return arg;
+    }
+}
+
+static QVariant fromTraceArg(const TraceArg& arg, const std::vector<QString>& names,
+                             const std::deque<QString>& argStrings, uint32_t firstArgString) {
+    switch (arg.type) {
+        case TraceArg::Int:
+            return QVariant((qint64)arg.intValue);
+        case TraceArg::Double:
+            return QVariant(arg.doubleValue);
+        case TraceArg::Bool:
+            return QVariant(arg.intValue != 0);
+        case TraceArg::Text: {
+            uint32_t index = arg.stringValue - firstArgString;
+            return QVariant(index < argStrings.size() ? argStrings[index] : QString());
+        }
+        case TraceArg::String:
+        default:
+            return QVariant(names[arg.stringValue]);
+    }
+}
+
+static void recordEvent(const QLoggingCategory& category, uint32_t name, EventType type, uint32_t id, uint8_t flags,
+                        const TraceArg* args, const QString* strings, int numArgs) {
+    TraceRecord record;
+    record.timestamp = p_high_resolution_clock::now().time_since_epoch().count();
+    record.category = &category;
+    record.name = name;
+    record.id = id;
+    record.type = type;
+    record.flags = flags;
+
+    if (getThreadState().getBuffer().push(record, args, strings, numArgs)) {
+        auto& state = getState();
+        state.drainRequested = true;
+        state.drainCondition.notify_one();
+    }
+}
+
+}
+
 bool tracing::enabled() {
-    return DependencyManager::get<Tracer>()->isEnabled();
+    return tracingEnabled.load(std::memory_order_relaxed);
 }
 
-void Tracer::startTracing() {
-    std::lock_guard<std::mutex> guard(_eventsMutex);
-    if (_enabled) {
-        qWarning() << "Tried to enable tracer, but already enabled";
+uint32_t tracing::internName(const QString& name) {
+    auto& cache = getThreadState().names;
+    auto cached = cache.find(name);
+    if (cached != cache.end()) {
+        return cached.value();
+    }
+
+    auto& state = getState();
+    uint32_t id;
+    {
+        std::lock_guard<std::mutex> guard(state.namesMutex);
+        auto it = state.nameIDs.find(name);
+        if (it != state.nameIDs.end()) {
+            id = it.value();
+        } else {
+            id = (uint32_t)state.names.size();
+            state.names.push_back(name);
+            state.nameIDs.insert(name, id);
+        }
+    }
+    cache.insert(name, id);
+    return id;
+}
+
+uint32_t tracing::internName(const char* name) {
+    // the same address may hold a different string later (e.g. std::string::c_str()), so check the contents
+    auto& cache = getThreadState().literalNames;
+    auto cached = cache.find(name);
+    if (cached != cache.end() && cached->second.second == name) {
+        return cached->second.first;
+    }
+    uint32_t id = internName(QString::fromUtf8(name));
+    cache[name] = { id, std::string(name) };
+    return id;
+}
+
+QString tracing::getName(uint32_t name) {
+    auto& state = getState();
+    std::lock_guard<std::mutex> guard(state.namesMutex);
+    return name < state.names.size() ? state.names[name] : QString();
+}
+
+void tracing::traceEvent(const QLoggingCategory& category, uint32_t name, EventType type, const TraceArg* args, int numArgs) {
+    if (!enabled()) {
+        return;
+    }
+    recordEvent(category, name, type, 0, 0, args, nullptr, numArgs);
+}
+
+void tracing::traceEvent(const QLoggingCategory& category, const QString& name, EventType type,
+                         const QString& id, const QVariantMap& args, const QVariantMap& extra) {
+    // We always want to store metadata events even if tracing is not enabled so that when
+    // tracing is enabled we will be able to associate that metadata with that trace.
+    // Metadata events should be used sparingly - as of 12/30/16 the Chrome Tracing
+    // spec only supports thread+process metadata, so we should only expect to see metadata
+    // events created when a new thread or process is created.
+    if (type == Metadata) {
+        auto timestamp = std::chrono::duration_cast<std::chrono::microseconds>(p_high_resolution_clock::now().time_since_epoch()).count();
+        auto processID = QCoreApplication::applicationPid();
+        auto threadID = int64_t(QThread::currentThreadId());
+        auto& state = getState();
+        std::lock_guard<std::mutex> guard(state.metadataMutex);
+        state.metadataEvents.push_back({ id, name, type, timestamp, processID, threadID, category, args, extra });
         return;
     }
+    if (!enabled()) {
+        return;
+    }
+
+    uint32_t recordID = 0;
+    uint8_t flags = 0;
+    bool isTextID = false;
+    if (!id.isEmpty()) {
+        bool isNumber;
+        recordID = id.toUInt(&isNumber);
+        if (isNumber && QString::number(recordID) == id) {
+            flags |= TraceRecord::NumericID;
+        } else {
+            // IDs, such as UUIDs, rarely repeat, so interning them would grow the names without limit
+            recordID = 0;
+            flags |= TraceRecord::TextID;
+            isTextID = true;
+        }
+    }
+
+    int numArgs = (isTextID ? 1 : 0) + args.size() + extra.size();
+    std::vector<TraceArg> recordArgs;
+    std::vector<QString> recordStrings(numArgs);
+    recordArgs.reserve(numArgs);
+    if (isTextID) {
+        recordArgs.push_back(toTraceArg(0, id, recordStrings[0]));
+    }
+    for (auto it = args.begin(); it != args.end(); ++it) {
+        recordArgs.push_back(toTraceArg(internName(it.key()), it.value(), recordStrings[recordArgs.size()]));
+    }
+    for (auto it = extra.begin(); it != extra.end(); ++it) {
+        recordArgs.push_back(toTraceArg(internName(it.key()), it.value(), recordStrings[recordArgs.size()]));
+        recordArgs.back().isExtra = true;
+    }
+    recordEvent(category, internName(name), type, recordID, flags, recordArgs.data(), recordStrings.data(), numArgs);
+}
 
-    _events.clear();
-    _enabled = true;
+Tracer::~Tracer() {
+    if (_enabled) {
+        stopTracing();
+    }
+}
+
+void Tracer::startTracing() {
+    {
+        std::lock_guard<std::mutex> guard(_recordsMutex);
+        if (_enabled) {
+            qWarning() << "Tried to enable tracer, but already enabled";
+            return;
+        }
+
+        // throw away anything recorded while stopping the last trace
+        drainBuffers([](qint64, const TraceRecord&, QString*) {});
+        _records.clear();
+        _argStrings.clear();
+        _droppedAtStart = getTotalDropped();
+        _enabled = true;
+    }
+    tracingEnabled = true;
+    _draining = true;
+    _drainThread = std::thread(&Tracer::drainLoop, this);
 }
 
 void Tracer::stopTracing() {
-    std::lock_guard<std::mutex> guard(_eventsMutex);
-    if (!_enabled) {
-        qWarning() << "Cannot stop tracing, already disabled";
+    {
+        std::lock_guard<std::mutex> guard(_recordsMutex);
+        if (!_enabled) {
+            qWarning() << "Cannot stop tracing, already disabled";
+            return;
+        }
+        _enabled = false;
+    }
+    tracingEnabled = false;
+
+    auto& state = getState();
+    {
+        std::lock_guard<std::mutex> guard(state.drainMutex);
+        _draining = false;
+    }
+    state.drainCondition.notify_all();
+    if (_drainThread.joinable()) {
+        _drainThread.join();
+    }
+    drain();
+
+    auto numDropped = getNumDroppedEvents();
+    if (numDropped > 0) {
+        qWarning() << "Tracer dropped" << numDropped << "events, thread buffers were full";
+    }
+}
+
+uint64_t Tracer::getNumDroppedEvents() const {
+    return getTotalDropped() - _droppedAtStart;
+}
+
+void Tracer::setRollingWindow(uint64_t usecs) {
+    _rollingWindow = usecs;
+}
+
+void Tracer::drain() {
+    std::lock_guard<std::mutex> guard(_recordsMutex);
+    drainBuffers([&](qint64 threadID, const TraceRecord& record, QString* strings) {
+        _records.push_back({ threadID, record });
+        TraceRecord& stored = _records.back().record;
+        for (int j = 0; j < stored.numArgs; ++j) {
+            if (stored.args[j].type == TraceArg::Text) {
+                stored.args[j].stringValue = _firstArgString + (uint32_t)_argStrings.size();
+                _argStrings.push_back(QString());
+                _argStrings.back().swap(strings[j]);
+            }
+        }
+    });
+    trim();
+}
+
+void Tracer::trim() {
+    uint64_t window = _rollingWindow;
+    if (window == 0) {
         return;
     }
-    _enabled = false;
+    // records are drained a thread at a time, so they are only in order to within a drain interval
+    auto now = p_high_resolution_clock::now().time_since_epoch();
+    auto cutoff = now - std::chrono::duration_cast<p_high_resolution_clock::duration>(std::chrono::microseconds(window));
+    while (!_records.empty() && _records.front().record.timestamp < (TraceTimestamp)cutoff.count()) {
+        // the strings were added in record order, so the front record's are at the front
+        const TraceRecord& record = _records.front().record;
+        for (int j = 0; j < record.numArgs; ++j) {
+            if (record.args[j].type == TraceArg::Text) {
+                _argStrings.pop_front();
+                ++_firstArgString;
+            }
+        }
+        _records.pop_front();
+    }
+}
+
+void Tracer::drainLoop() {
+    auto& state = getState();
+    while (_draining) {
+        drain();
+        std::unique_lock<std::mutex> lock(state.drainMutex);
+        state.drainCondition.wait_for(lock, DRAIN_INTERVAL, [&] {
+            return !_draining || state.drainRequested;
+        });
+        state.drainRequested = false;
+    }
 }
 
 void TraceEvent::writeJson(QTextStream& out) const {
@@ -104,6 +560,83 @@ void TraceEvent::writeJson(QTextStream& out) const {
 #endif
 }
 
+static QByteArray writeTrace(const std::deque<Tracer::ThreadRecord>& records,
+                             const std::deque<QString>& argStrings, uint32_t firstArgString) {
+    std::list<TraceEvent> metadataEvents;
+    std::vector<QString> names;
+    {
+        auto& state = getState();
+        std::lock_guard<std::mutex> metadataGuard(state.metadataMutex);
+        metadataEvents.insert(metadataEvents.end(), state.metadataEvents.begin(), state.metadataEvents.end());
+        std::lock_guard<std::mutex> namesGuard(state.namesMutex);
+        names = state.names;
+    }
+
+    QByteArray data;
+    QTextStream out(&data);
+    out << "[\n";
+    bool first = true;
+    auto writeEvent = [&](const TraceEvent& event) {
+        if (first) {
+            first = false;
+        } else {
+            out << ",\n";
+        }
+        event.writeJson(out);
+    };
+
+    auto processID = QCoreApplication::applicationPid();
+    size_t numRecords = records.size();
+    for (size_t i = 0; i < numRecords; ++i) {
+        const TraceRecord& record = records[i].record;
+        if (record.flags & TraceRecord::Continuation) {
+            continue;
+        }
+        QString id;
+        bool isTextID = record.flags & TraceRecord::TextID;
+        if (record.flags & TraceRecord::NumericID) {
+            id = QString::number(record.id);
+        } else if (isTextID && record.numArgs > 0) {
+            id = fromTraceArg(record.args[0], names, argStrings, firstArgString).toString();
+        }
+        auto timestamp = std::chrono::duration_cast<std::chrono::microseconds>(p_high_resolution_clock::duration(record.timestamp)).count();
+        TraceEvent event { id, names[record.name], record.type, timestamp, processID, records[i].threadID, *record.category, {}, {} };
+
+        // arguments, including the continuation records that follow
+        for (size_t j = i; j < numRecords; ++j) {
+            const TraceRecord& argsRecord = records[j].record;
+            if (j > i && !(argsRecord.flags & TraceRecord::Continuation)) {
+                break;
+            }
+            for (int k = (j == i && isTextID) ? 1 : 0; k < argsRecord.numArgs; ++k) {
+                const TraceArg& arg = argsRecord.args[k];
+                (arg.isExtra ? event.extra : event.args)[names[arg.key]] = fromTraceArg(arg, names, argStrings, firstArgString);
+            }
+        }
+        writeEvent(event);
+    }
+    for (const auto& event : metadataEvents) {
+        writeEvent(event);
+    }
+    out << "\n]";
+    out.flush();
+    return data;
+}
+
+QByteArray Tracer::snapshot() {
+    drain();
+    std::deque<ThreadRecord> currentRecords;
+    std::deque<QString> currentArgStrings;
+    uint32_t firstArgString;
+    {
+        std::lock_guard<std::mutex> guard(_recordsMutex);
+        currentRecords = _records;
+        currentArgStrings = _argStrings;
+        firstArgString = _firstArgString;
+    }
+    return writeTrace(currentRecords, currentArgStrings, firstArgString);
+}
+
 void Tracer::serialize(const QString& originalPath) {
 
     QString path = originalPath;
@@ -128,13 +661,15 @@ void Tracer::serialize(const QString& originalPath) {
 
 
 
-    std::list<TraceEvent> currentEvents;
+    drain();
+    std::deque<ThreadRecord> currentRecords;
+    std::deque<QString> currentArgStrings;
+    uint32_t firstArgString;
     {
-        std::lock_guard<std::mutex> guard(_eventsMutex);
-        currentEvents.swap(_events);
-        for (auto& event : _metadataEvents) {
-            currentEvents.push_back(event);
-        }
+        std::lock_guard<std::mutex> guard(_recordsMutex);
+        currentRecords.swap(_records);
+        currentArgStrings.swap(_argStrings);
+        firstArgString = _firstArgString;
     }
 
     // If the file exists and we can't remove it, fail early
@@ -142,22 +677,7 @@ void Tracer::serialize(const QString& originalPath) {
         return;
     }
 
-    // If we can't open a temp file for writing, fail early
-    QByteArray data;
-    {
-        QTextStream out(&data);
-        out << "[\n";
-        bool first = true;
-        for (const auto& event : currentEvents) {
-            if (first) {
-                first = false;
-            } else {
-                out << ",\n";
-            }
-            event.writeJson(out);
-        }
-        out << "\n]";
-    }
+    QByteArray data = writeTrace(currentRecords, currentArgStrings, firstArgString);
 
     if (path.endsWith(".gz")) {
         QByteArray compressed;
@@ -198,58 +718,7 @@ void Tracer::serialize(const QString& originalPath) {
 }
 
 void Tracer::traceEvent(const QLoggingCategory& category,
-    const QString& name, EventType type,
-    qint64 timestamp, qint64 processID, qint64 threadID,
-    const QString& id,
-    const QVariantMap& args, const QVariantMap& extra) {
-    std::lock_guard<std::mutex> guard(_eventsMutex);
-
-    // We always want to store metadata events even if tracing is not enabled so that when
-    // tracing is enabled we will be able to associate that metadata with that trace.
-    // Metadata events should be used sparingly - as of 12/30/16 the Chrome Tracing
-    // spec only supports thread+process metadata, so we should only expect to see metadata
-    // events created when a new thread or process is created.
-    if (!_enabled && type != Metadata) {
-        return;
-    }
-
-    if (type == Metadata) {
-        _metadataEvents.push_back({
-            id,
-            name,
-            type,
-            timestamp,
-            processID,
-            threadID,
-            category,
-            args,
-            extra
-        });
-    } else {
-        _events.push_back({
-            id,
-            name,
-            type,
-            timestamp,
-            processID,
-            threadID,
-            category,
-            args,
-            extra
-        });
-    }
-}
-
-void Tracer::traceEvent(const QLoggingCategory& category, 
-    const QString& name, EventType type, const QString& id, 
+    const QString& name, EventType type, const QString& id,
     const QVariantMap& args, const QVariantMap& extra) {
-    if (!_enabled && type != Metadata) {
-        return;
-    }
-
-    auto timestamp = std::chrono::duration_cast<std::chrono::microseconds>(p_high_resolution_clock::now().time_since_epoch()).count();
-    auto processID = QCoreApplication::applicationPid();
-    auto threadID = int64_t(QThread::currentThreadId());
-
-    traceEvent(category, name, type, timestamp, processID, threadID, id, args, extra);
+    tracing::traceEvent(category, name, type, id, args, extra);
 }
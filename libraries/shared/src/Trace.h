@@ -10,8 +10,13 @@
 #ifndef hifi_Trace_h
 #define hifi_Trace_h
 
+#include <atomic>
 #include <cstdint>
+#include <deque>
+#include <memory>
 #include <mutex>
+#include <thread>
+#include <vector>
 
 #include <QtCore/QString>
 #include <QtCore/QVariantMap>
@@ -23,6 +28,7 @@
 
 namespace tracing {
 
+// true while a Tracer is recording, cheap enough to check before building event arguments
 bool enabled();
 
 using TraceTimestamp = uint64_t;
@@ -62,6 +68,7 @@ enum EventType : char {
     ContextLeave = ')'
 };
 
+// A Chrome trace event, only built for metadata events and when writing a trace out
 struct TraceEvent {
     QString id;
     QString name;
@@ -76,11 +83,82 @@ struct TraceEvent {
     void writeJson(QTextStream& out) const;
 };
 
+// An event argument stored inline in a TraceRecord: keys and String values are interned names,
+// Text values are kept next to the record and dropped with it
+struct TraceArg {
+    enum Type : uint8_t {
+        Int = 0,
+        Double,
+        Bool,
+        String,
+        Text
+    };
+
+    uint32_t key;
+    Type type;
+    bool isExtra; // written next to "name" and "ph" rather than in "args"
+    union {
+        int64_t intValue;
+        double doubleValue;
+        uint32_t stringValue;
+    };
+
+    static TraceArg fromInt(uint32_t key, int64_t value) { TraceArg arg { key, Int, false }; arg.intValue = value; return arg; }
+    static TraceArg fromDouble(uint32_t key, double value) { TraceArg arg { key, Double, false }; arg.doubleValue = value; return arg; }
+    static TraceArg fromBool(uint32_t key, bool value) { TraceArg arg { key, Bool, false }; arg.intValue = value; return arg; }
+    static TraceArg fromString(uint32_t key, uint32_t value) { TraceArg arg { key, String, false }; arg.stringValue = value; return arg; }
+};
+
+// Fixed size binary event, written by the tracing thread into its own ring buffer.
+// Events with more than MAX_ARGS arguments continue in the records that follow them.
+struct TraceRecord {
+    static const int MAX_ARGS = 2;
+
+    enum Flags : uint8_t {
+        NumericID = 0x01, // id holds a number
+        Continuation = 0x02, // only holds more arguments for the previous record
+        TextID = 0x04 // the id is the first argument, a Text one, so it goes with the event rather than being interned
+    };
+
+    TraceTimestamp timestamp;
+    const QLoggingCategory* category;
+    uint32_t name;
+    uint32_t id;
+    EventType type;
+    uint8_t flags;
+    uint8_t numArgs;
+    TraceArg args[MAX_ARGS];
+};
+
+// Interned names are never freed; they are meant for event names, argument keys and the like, not for IDs or values.
+// Interning a const char* is cached per thread by address, so prefer it for literals.
+uint32_t internName(const QString& name);
+uint32_t internName(const char* name);
+QString getName(uint32_t name);
+
+// Records an event without any allocation on the calling thread, if tracing is enabled
+void traceEvent(const QLoggingCategory& category, uint32_t name, EventType type, const TraceArg* args = nullptr, int numArgs = 0);
+
+// Records an event, converting its names and arguments to a TraceRecord. Metadata events are kept
+// even when tracing is disabled
+void traceEvent(const QLoggingCategory& category, const QString& name, EventType type,
+    const QString& id = "", const QVariantMap& args = QVariantMap(), const QVariantMap& extra = QVariantMap());
+
+inline void traceEvent(const QLoggingCategory& category, const QString& name, EventType type, int id, const QVariantMap& args = {}, const QVariantMap& extra = {}) {
+    traceEvent(category, name, type, QString::number(id), args, extra);
+}
+
+// Collects the events of all threads while enabled, and writes them out as a Chrome trace.
+// Each thread records into a lock free ring buffer that a background thread drains; a thread
+// that outruns the drain loses events rather than blocking, see getNumDroppedEvents().
+// With a rolling window, only the most recent events are kept, so tracing can be left on.
 class Tracer : public Dependency {
 public:
-    void traceEvent(const QLoggingCategory& category, 
+    ~Tracer();
+
+    void traceEvent(const QLoggingCategory& category,
         const QString& name, EventType type,
-        const QString& id = "", 
+        const QString& id = "",
         const QVariantMap& args = QVariantMap(), const QVariantMap& extra = QVariantMap());
 
     void startTracing();
@@ -88,30 +166,39 @@ public:
     void serialize(const QString& file);
     bool isEnabled() const { return _enabled; }
 
+    // keep only the events of the last usecs microseconds, 0 keeps everything
+    void setRollingWindow(uint64_t usecs);
+    uint64_t getRollingWindow() const { return _rollingWindow; }
+
+    // the Chrome trace of the events recorded so far, without discarding them
+    QByteArray snapshot();
+
+    // events lost since tracing was started because a thread's buffer was full
+    uint64_t getNumDroppedEvents() const;
+
+    struct ThreadRecord {
+        qint64 threadID;
+        TraceRecord record;
+    };
+
 private:
-    void traceEvent(const QLoggingCategory& category, 
-        const QString& name, EventType type,
-        qint64 timestamp, qint64 processID, qint64 threadID,
-        const QString& id = "",
-        const QVariantMap& args = QVariantMap(), const QVariantMap& extra = QVariantMap());
+    void drain();
+    void drainLoop();
+    void trim();
 
     bool _enabled { false };
-    std::list<TraceEvent> _events;
-    std::list<TraceEvent> _metadataEvents;
-    std::mutex _eventsMutex;
+    std::atomic<uint64_t> _rollingWindow { 0 };
+    std::deque<ThreadRecord> _records;
+    std::mutex _recordsMutex;
+    std::thread _drainThread;
+    std::atomic<bool> _draining { false };
+    uint64_t _droppedAtStart { 0 };
+
+    // the Text arguments of _records, in record order; index n is at _argStrings[n - _firstArgString]
+    std::deque<QString> _argStrings;
+    uint32_t _firstArgString { 0 };
 };
 
-inline void traceEvent(const QLoggingCategory& category, const QString& name, EventType type, const QString& id = "", const QVariantMap& args = {}, const QVariantMap& extra = {}) {
-    const auto& tracer = DependencyManager::get<Tracer>();
-    if (tracer) {
-        tracer->traceEvent(category, name, type, id, args, extra);
-    }
-}
-
-inline void traceEvent(const QLoggingCategory& category, const QString& name, EventType type, int id, const QVariantMap& args = {}, const QVariantMap& extra = {}) {
-    traceEvent(category, name, type, QString::number(id), args, extra);
-}
-
 }
 
 #endif // hifi_Trace_h
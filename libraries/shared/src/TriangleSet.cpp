@@ -0,0 +1,161 @@
+//
+//  TriangleSet.cpp
+//  libraries/shared/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "TriangleSet.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "GLMHelpers.h"
+
+// leaves small enough that testing their triangles costs about as much as one more level of boxes
+const uint32_t MAX_TRIANGLES_PER_LEAF = 4;
+
+// median splits halve every level, so this is deep enough for any set that fits in memory
+const int MAX_DEPTH = 64;
+
+static glm::vec3 getCentroid(const Triangle& triangle) {
+    return (triangle.v0 + triangle.v1 + triangle.v2) * (1.0f / 3.0f);
+}
+
+void TriangleSet::clear() {
+    _triangles.clear();
+    _nodes.clear();
+    _bounds.reset();
+}
+
+void TriangleSet::build() {
+    _nodes.clear();
+    _bounds.reset();
+    if (_triangles.empty()) {
+        return;
+    }
+
+    // a tree split at the median has fewer than twice as many nodes as leaves
+    _nodes.reserve(2 * (_triangles.size() / MAX_TRIANGLES_PER_LEAF + 1));
+    buildNode(0, (uint32_t)_triangles.size());
+    _bounds = _nodes[0].bounds;
+}
+
+uint32_t TriangleSet::buildNode(uint32_t start, uint32_t count) {
+    uint32_t index = (uint32_t)_nodes.size();
+    _nodes.emplace_back();
+
+    Extents bounds;
+    Extents centroidBounds;
+    for (uint32_t i = start; i < start + count; i++) {
+        const Triangle& triangle = _triangles[i];
+        bounds.addPoint(triangle.v0);
+        bounds.addPoint(triangle.v1);
+        bounds.addPoint(triangle.v2);
+        centroidBounds.addPoint(getCentroid(triangle));
+    }
+    _nodes[index].bounds = bounds;
+
+    glm::vec3 centroidSize = centroidBounds.size();
+    uint8_t axis = (centroidSize.x > centroidSize.y) ?
+        ((centroidSize.x > centroidSize.z) ? 0 : 2) : ((centroidSize.y > centroidSize.z) ? 1 : 2);
+
+    // triangles whose centroids coincide can't be split any further
+    if (count <= MAX_TRIANGLES_PER_LEAF || centroidSize[axis] == 0.0f) {
+        _nodes[index].start = start;
+        _nodes[index].count = count;
+        return index;
+    }
+
+    uint32_t half = count / 2;
+    auto first = _triangles.begin() + start;
+    std::nth_element(first, first + half, first + count, [axis](const Triangle& a, const Triangle& b) {
+        return getCentroid(a)[axis] < getCentroid(b)[axis];
+    });
+
+    // _nodes may grow, so don't hold a reference to this node across the children
+    buildNode(start, half);
+    uint32_t secondChild = buildNode(start + half, count - half);
+    _nodes[index].secondChild = secondChild;
+    _nodes[index].axis = axis;
+    return index;
+}
+
+// the slab test, with the ray's reciprocal direction precomputed
+static bool rayHitsBox(const glm::vec3& origin, const glm::vec3& inverseDirection, const Extents& box, float maxDistance) {
+    float entry = 0.0f;
+    float exit = maxDistance;
+    for (int i = 0; i < 3; i++) {
+        if (std::isinf(inverseDirection[i])) {
+            // the ray is parallel to this slab: 0 * inf would be NaN for an origin on one of its planes
+            if (origin[i] < box.minimum[i] || origin[i] > box.maximum[i]) {
+                return false;
+            }
+            continue;
+        }
+        float toMinimum = (box.minimum[i] - origin[i]) * inverseDirection[i];
+        float toMaximum = (box.maximum[i] - origin[i]) * inverseDirection[i];
+        entry = std::max(entry, std::min(toMinimum, toMaximum));
+        exit = std::min(exit, std::max(toMinimum, toMaximum));
+    }
+    return entry <= exit;
+}
+
+bool TriangleSet::findRayIntersection(const glm::vec3& origin, const glm::vec3& direction, float& distance,
+                                      Triangle& triangle) const {
+    if (_nodes.empty()) {
+        return false;
+    }
+
+    glm::vec3 inverseDirection = 1.0f / direction;
+    bool intersectedSomething = false;
+
+    uint32_t stack[MAX_DEPTH];
+    int stackSize = 0;
+    stack[stackSize++] = 0;
+
+    while (stackSize > 0) {
+        uint32_t index = stack[--stackSize];
+        const Node& node = _nodes[index];
+        if (!rayHitsBox(origin, inverseDirection, node.bounds, distance)) {
+            continue;
+        }
+
+        if (node.count > 0) {
+            for (uint32_t i = node.start; i < node.start + node.count; i++) {
+                float thisTriangleDistance;
+                if (findRayTriangleIntersection(origin, direction, _triangles[i], thisTriangleDistance) &&
+                        thisTriangleDistance < distance) {
+                    distance = thisTriangleDistance;
+                    triangle = _triangles[i];
+                    intersectedSomething = true;
+                }
+            }
+        } else if (direction[node.axis] < 0.0f) {
+            // visit the nearer child first, so the farther is more often culled by what it hit
+            stack[stackSize++] = index + 1;
+            stack[stackSize++] = node.secondChild;
+        } else {
+            stack[stackSize++] = node.secondChild;
+            stack[stackSize++] = index + 1;
+        }
+    }
+    return intersectedSomething;
+}
+
+bool TriangleSet::convexHullContains(const glm::vec3& point) const {
+    if (_triangles.empty() || !_bounds.containsPoint(point)) {
+        return false;
+    }
+
+    for (const auto& triangle : _triangles) {
+        if (!isPointBehindTrianglesPlane(point, triangle.v0, triangle.v1, triangle.v2)) {
+            // it's not behind at least one so we bail
+            return false;
+        }
+    }
+    return true;
+}
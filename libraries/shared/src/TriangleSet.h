@@ -0,0 +1,61 @@
+//
+//  TriangleSet.h
+//  libraries/shared/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_TriangleSet_h
+#define hifi_TriangleSet_h
+
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "Extents.h"
+#include "GeometryUtil.h"
+
+/// A set of triangles with a bounding volume hierarchy over them, so a ray can be picked against a high
+/// poly mesh without testing every triangle. Insert the triangles, then build() before picking.
+class TriangleSet {
+public:
+    void reserve(size_t size) { _triangles.reserve(size); }
+    void insert(const Triangle& triangle) { _triangles.push_back(triangle); }
+    void clear();
+
+    /// Sorts the triangles into the hierarchy. Inserting after this needs another build().
+    void build();
+
+    bool isEmpty() const { return _triangles.empty(); }
+    size_t size() const { return _triangles.size(); }
+    const Extents& getBounds() const { return _bounds; }
+
+    /// Finds the nearest triangle the ray hits closer than distance, which is updated to the distance to it.
+    /// Pass the farthest distance of interest, std::numeric_limits<float>::max() for any.
+    bool findRayIntersection(const glm::vec3& origin, const glm::vec3& direction, float& distance,
+                             Triangle& triangle) const;
+
+    /// Is the point behind the plane of every triangle?
+    bool convexHullContains(const glm::vec3& point) const;
+
+private:
+    class Node {
+    public:
+        Extents bounds;
+        uint32_t start { 0 }; // the first triangle in a leaf
+        uint32_t count { 0 }; // the triangles in a leaf, zero for an interior node
+        uint32_t secondChild { 0 }; // an interior node's first child follows it
+        uint8_t axis { 0 }; // an interior node's split axis
+    };
+
+    uint32_t buildNode(uint32_t start, uint32_t count);
+
+    std::vector<Triangle> _triangles;
+    std::vector<Node> _nodes;
+    Extents _bounds;
+};
+
+#endif // hifi_TriangleSet_h
@@ -0,0 +1,333 @@
+//
+//  AnimPoseBufferTests.cpp
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AnimPoseBufferTests.h"
+
+#include <thread>
+
+#include <AnimPoseBuffer.h>
+#include <AnimSkeleton.h>
+#include <AnimUtil.h>
+
+#include "../QTestExtensions.h"
+
+QTEST_MAIN(AnimPoseBufferTests)
+
+const float EPSILON = 0.0001f;
+
+// joint count of a typical avatar skeleton
+const int BENCHMARK_JOINT_COUNT = 60;
+const int BENCHMARK_AVATAR_COUNT = 100;
+
+static float randFloat(float min, float max) {
+    return min + (max - min) * ((float)qrand() / (float)RAND_MAX);
+}
+
+static glm::quat randRot() {
+    return glm::normalize(glm::quat(randFloat(-1.0f, 1.0f), randFloat(-1.0f, 1.0f), randFloat(-1.0f, 1.0f), randFloat(-1.0f, 1.0f)));
+}
+
+static AnimPose randPose(bool uniformScale) {
+    glm::vec3 scale = uniformScale ? glm::vec3(randFloat(0.5f, 2.0f)) : glm::vec3(randFloat(0.5f, 2.0f), randFloat(0.5f, 2.0f), randFloat(0.5f, 2.0f));
+    return AnimPose(scale, randRot(), glm::vec3(randFloat(-1.0f, 1.0f), randFloat(-1.0f, 1.0f), randFloat(-1.0f, 1.0f)));
+}
+
+static AnimPoseVec randPoses(size_t size, bool uniformScale = true) {
+    AnimPoseVec poses(size);
+    for (auto& pose : poses) {
+        pose = randPose(uniformScale);
+    }
+    return poses;
+}
+
+// a tree where every joint has up to three children, so every depth has several joints
+static std::vector<FBXJoint> makeTestJoints(int jointCount) {
+    std::vector<FBXJoint> joints(jointCount);
+    for (int i = 0; i < jointCount; i++) {
+        FBXJoint& joint = joints[i];
+        joint.parentIndex = (i == 0) ? -1 : (i - 1) / 3;
+        joint.name = QString("joint%1").arg(i);
+        joint.translation = glm::vec3(0.0f, 0.1f, 0.0f);
+        joint.preTransform = glm::mat4();
+        joint.preRotation = glm::quat();
+        joint.rotation = glm::quat();
+        joint.postRotation = glm::quat();
+        joint.postTransform = glm::mat4();
+        joint.transform = glm::mat4();
+        joint.bindTransform = glm::mat4();
+        joint.bindTransformFoundInCluster = false;
+    }
+    return joints;
+}
+
+static void comparePoses(const AnimPose& actual, const AnimPose& expected) {
+    QCOMPARE_WITH_ABS_ERROR((glm::mat4)actual, (glm::mat4)expected, EPSILON);
+}
+
+void AnimPoseBufferTests::testBuffer() {
+    AnimPoseBuffer empty;
+    QVERIFY(empty.stream(AnimPoseBuffer::TRANS_X) == nullptr);
+    empty.resize(0);
+    empty.load(AnimPoseVec());
+    QCOMPARE(empty.size(), (size_t)0);
+    empty.resize(3);
+    QCOMPARE(empty.get(2).scale(), glm::vec3(1.0f));
+
+    AnimPoseVec poses = randPoses(7);
+    AnimPoseBuffer buffer;
+    buffer.load(poses);
+    QCOMPARE(buffer.size(), (size_t)7);
+    QCOMPARE(buffer.paddedSize(), (size_t)8);
+
+    // padding is identity
+    QCOMPARE(buffer.stream(AnimPoseBuffer::SCALE_X)[7], 1.0f);
+    QCOMPARE(buffer.stream(AnimPoseBuffer::ROT_W)[7], 1.0f);
+    QCOMPARE(buffer.stream(AnimPoseBuffer::TRANS_X)[7], 0.0f);
+
+    AnimPoseVec result;
+    buffer.store(result);
+    QCOMPARE(result.size(), poses.size());
+    for (size_t i = 0; i < poses.size(); i++) {
+        QCOMPARE(result[i].scale(), poses[i].scale());
+        QCOMPARE(result[i].rot(), poses[i].rot());
+        QCOMPARE(result[i].trans(), poses[i].trans());
+    }
+    QVERIFY(buffer.hasUniformScale());
+
+    // growing keeps the existing poses
+    buffer.resize(9);
+    QCOMPARE(buffer.get(6).trans(), poses[6].trans());
+    QCOMPARE(buffer.get(8).scale(), glm::vec3(1.0f));
+
+    buffer.set(0, AnimPose(glm::vec3(1.0f, 2.0f, 1.0f), glm::quat(), glm::vec3()));
+    QVERIFY(!buffer.hasUniformScale());
+}
+
+void AnimPoseBufferTests::testBlend() {
+    // sizes around the 4 pose blocks of the SIMD kernel
+    for (size_t size : { 0, 1, 3, 4, 5, 8, 13, 60 }) {
+        AnimPoseVec a = randPoses(size, false);
+        AnimPoseVec b = randPoses(size, false);
+        std::vector<float> alphas(size);
+        for (auto& alpha : alphas) {
+            alpha = randFloat(0.0f, 1.0f);
+        }
+
+        AnimPoseVec expected(size);
+        AnimPoseVec actual(size);
+        for (float alpha : { 0.0f, 0.3f, 1.0f }) {
+            blend_ref(size, a.data(), b.data(), &alpha, 0, expected.data());
+            blend(size, a.data(), b.data(), alpha, actual.data());
+            for (size_t i = 0; i < size; i++) {
+                comparePoses(actual[i], expected[i]);
+            }
+        }
+
+        blend_ref(size, a.data(), b.data(), alphas.data(), 1, expected.data());
+        blend(size, a.data(), b.data(), alphas.data(), actual.data());
+        for (size_t i = 0; i < size; i++) {
+            comparePoses(actual[i], expected[i]);
+        }
+    }
+}
+
+void AnimPoseBufferTests::testBlendAliasing() {
+    // AnimBlendLinear and AnimManipulator blend into one of their inputs
+    const size_t SIZE = 11;
+    AnimPoseVec a = randPoses(SIZE);
+    AnimPoseVec b = randPoses(SIZE);
+
+    AnimPoseVec expected(SIZE);
+    blend(SIZE, a.data(), b.data(), 0.25f, expected.data());
+
+    AnimPoseVec actual = a;
+    blend(SIZE, actual.data(), b.data(), 0.25f, actual.data());
+    for (size_t i = 0; i < SIZE; i++) {
+        comparePoses(actual[i], expected[i]);
+    }
+
+    actual = b;
+    blend(SIZE, a.data(), actual.data(), 0.25f, actual.data());
+    for (size_t i = 0; i < SIZE; i++) {
+        comparePoses(actual[i], expected[i]);
+    }
+}
+
+void AnimPoseBufferTests::testConvertRelativeToAbsolute() {
+    for (int jointCount : { 1, 2, 5, 13, BENCHMARK_JOINT_COUNT }) {
+        AnimSkeleton skeleton(makeTestJoints(jointCount));
+        AnimPoseVec relativePoses = randPoses(jointCount);
+        AnimPose rootPose = randPose(true);
+
+        // full matrix products
+        AnimPoseVec expected(jointCount);
+        for (int i = 0; i < jointCount; i++) {
+            int parentIndex = skeleton.getParentIndex(i);
+            expected[i] = (parentIndex == -1 ? rootPose : expected[parentIndex]) * relativePoses[i];
+        }
+
+        AnimPoseBuffer relativeBuffer;
+        relativeBuffer.load(relativePoses);
+        AnimPoseBuffer absoluteBuffer;
+
+        convertRelativeToAbsolute_ref(relativeBuffer, skeleton, rootPose, absoluteBuffer);
+        QCOMPARE(absoluteBuffer.size(), (size_t)jointCount);
+        for (int i = 0; i < jointCount; i++) {
+            comparePoses(absoluteBuffer.get(i), expected[i]);
+        }
+
+        convertRelativeToAbsolute(relativeBuffer, skeleton, rootPose, absoluteBuffer);
+        QCOMPARE(absoluteBuffer.size(), (size_t)jointCount);
+        for (int i = 0; i < jointCount; i++) {
+            comparePoses(absoluteBuffer.get(i), expected[i]);
+        }
+    }
+}
+
+void AnimPoseBufferTests::testSkeletonRelativeToAbsolute() {
+    const int JOINT_COUNT = 20;
+    AnimSkeleton skeleton(makeTestJoints(JOINT_COUNT));
+
+    // uniform scales take the buffer path, non uniform scales the matrix path.
+    for (bool uniformScale : { true, false }) {
+        AnimPoseVec poses = randPoses(JOINT_COUNT, uniformScale);
+        AnimPoseVec expected = poses;
+        for (int i = 0; i < JOINT_COUNT; i++) {
+            int parentIndex = skeleton.getParentIndex(i);
+            if (parentIndex != -1) {
+                expected[i] = expected[parentIndex] * poses[i];
+            }
+        }
+
+        skeleton.convertRelativePosesToAbsolute(poses);
+        for (int i = 0; i < JOINT_COUNT; i++) {
+            comparePoses(poses[i], expected[i]);
+        }
+    }
+
+    // rigs on different threads share a skeleton
+    const int NUM_THREADS = 4;
+    const int NUM_ITERATIONS = 1000;
+    std::vector<AnimPoseVec> relativePoses;
+    std::vector<AnimPoseVec> expectedPoses;
+    for (int t = 0; t < NUM_THREADS; t++) {
+        relativePoses.push_back(randPoses(JOINT_COUNT));
+        AnimPoseVec expected = relativePoses.back();
+        skeleton.convertRelativePosesToAbsolute(expected);
+        expectedPoses.push_back(expected);
+    }
+    // the same code on the same input, so any difference is a race
+    auto matches = [&](const AnimPoseVec& poses, const AnimPoseVec& expected) {
+        for (int i = 0; i < JOINT_COUNT; i++) {
+            if (poses[i].trans() != expected[i].trans() || poses[i].rot() != expected[i].rot()) {
+                return false;
+            }
+        }
+        return true;
+    };
+    std::vector<AnimPoseVec> results(NUM_THREADS);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < NUM_THREADS; t++) {
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < NUM_ITERATIONS; i++) {
+                results[t] = relativePoses[t];
+                skeleton.convertRelativePosesToAbsolute(results[t]);
+                if (!matches(results[t], expectedPoses[t])) {
+                    return;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (int t = 0; t < NUM_THREADS; t++) {
+        for (int i = 0; i < JOINT_COUNT; i++) {
+            comparePoses(results[t][i], expectedPoses[t][i]);
+        }
+    }
+}
+
+enum Variant {
+    REFERENCE,
+    OPTIMIZED
+};
+
+void AnimPoseBufferTests::benchmarkBlend_data() {
+    QTest::addColumn<int>("variant");
+    QTest::newRow("reference") << (int)REFERENCE;
+    QTest::newRow("optimized") << (int)OPTIMIZED;
+}
+
+// a two way blend of every joint of a crowd of avatars, as AnimBlendLinear does
+void AnimPoseBufferTests::benchmarkBlend() {
+    QFETCH(int, variant);
+
+    const size_t SIZE = BENCHMARK_JOINT_COUNT * BENCHMARK_AVATAR_COUNT;
+    AnimPoseVec a = randPoses(SIZE);
+    AnimPoseVec b = randPoses(SIZE);
+    AnimPoseVec result(SIZE);
+    float alpha = 0.4f;
+
+    QBENCHMARK {
+        for (int avatar = 0; avatar < BENCHMARK_AVATAR_COUNT; avatar++) {
+            size_t offset = avatar * BENCHMARK_JOINT_COUNT;
+            if (variant == REFERENCE) {
+                blend_ref(BENCHMARK_JOINT_COUNT, &a[offset], &b[offset], &alpha, 0, &result[offset]);
+            } else {
+                blend(BENCHMARK_JOINT_COUNT, &a[offset], &b[offset], alpha, &result[offset]);
+            }
+        }
+    }
+}
+
+enum RelativeToAbsoluteVariant {
+    ANIM_POSE,
+    BUFFER_REFERENCE,
+    BUFFER_OPTIMIZED
+};
+
+void AnimPoseBufferTests::benchmarkRelativeToAbsolute_data() {
+    QTest::addColumn<int>("variant");
+    QTest::newRow("AnimPose") << (int)ANIM_POSE;
+    QTest::newRow("buffer reference") << (int)BUFFER_REFERENCE;
+    QTest::newRow("buffer optimized") << (int)BUFFER_OPTIMIZED;
+}
+
+// local to global conversion for a crowd of avatars, as Rig::buildAbsoluteRigPoses does
+void AnimPoseBufferTests::benchmarkRelativeToAbsolute() {
+    QFETCH(int, variant);
+
+    AnimSkeleton skeleton(makeTestJoints(BENCHMARK_JOINT_COUNT));
+    std::vector<AnimPoseVec> relativePoses(BENCHMARK_AVATAR_COUNT);
+    std::vector<AnimPoseBuffer> relativeBuffers(BENCHMARK_AVATAR_COUNT);
+    for (int avatar = 0; avatar < BENCHMARK_AVATAR_COUNT; avatar++) {
+        relativePoses[avatar] = randPoses(BENCHMARK_JOINT_COUNT);
+        relativeBuffers[avatar].load(relativePoses[avatar]);
+    }
+    AnimPose rootPose = randPose(true);
+    AnimPoseVec absolutePoses(BENCHMARK_JOINT_COUNT);
+    AnimPoseBuffer absoluteBuffer;
+
+    QBENCHMARK {
+        for (int avatar = 0; avatar < BENCHMARK_AVATAR_COUNT; avatar++) {
+            if (variant == ANIM_POSE) {
+                const AnimPoseVec& poses = relativePoses[avatar];
+                for (int i = 0; i < BENCHMARK_JOINT_COUNT; i++) {
+                    int parentIndex = skeleton.getParentIndex(i);
+                    absolutePoses[i] = (parentIndex == -1 ? rootPose : absolutePoses[parentIndex]) * poses[i];
+                }
+            } else if (variant == BUFFER_REFERENCE) {
+                convertRelativeToAbsolute_ref(relativeBuffers[avatar], skeleton, rootPose, absoluteBuffer);
+            } else {
+                convertRelativeToAbsolute(relativeBuffers[avatar], skeleton, rootPose, absoluteBuffer);
+            }
+        }
+    }
+}
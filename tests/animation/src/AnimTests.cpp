@@ -10,6 +10,7 @@
 #include "AnimTests.h"
 #include <AnimNodeLoader.h>
 #include <AnimClip.h>
+#include <AnimClipData.h>
 #include <AnimBlendLinear.h>
 #include <AnimationLogging.h>
 #include <AnimVariant.h>
@@ -131,6 +132,99 @@ void AnimTests::testClipEvaulateWithVars() {
     QVERIFY(clip._loopFlag == loopFlag2);
 }
 
+// a few joints with constant tracks and a few animated ones.
+static std::vector<AnimPoseVec> buildTestFrames(int frameCount) {
+    const int JOINT_COUNT = 4;
+    std::vector<AnimPoseVec> frames(frameCount);
+    for (int frame = 0; frame < frameCount; frame++) {
+        float t = (float)frame / (float)frameCount;
+        AnimPoseVec& poses = frames[frame];
+        poses.resize(JOINT_COUNT);
+
+        // constant
+        poses[0] = AnimPose(glm::vec3(1.0f), glm::angleAxis(0.3f, glm::vec3(0.0f, 1.0f, 0.0f)), glm::vec3(0.0f, 10.0f, 0.0f));
+
+        // animated rotation
+        poses[1] = AnimPose(glm::vec3(1.0f), glm::angleAxis(t * 6.0f, glm::normalize(glm::vec3(1.0f, 2.0f, 3.0f))), glm::vec3(0.0f, 5.0f, 0.0f));
+
+        // animated translation
+        poses[2] = AnimPose(glm::vec3(1.0f), glm::quat(), glm::vec3(sinf(t * 3.0f) * 50.0f, -20.0f * t, 3.0f));
+
+        // everything animated, including a flipped quaternion sign
+        glm::quat rot = glm::angleAxis(t * 2.0f, glm::vec3(0.0f, 0.0f, 1.0f));
+        poses[3] = AnimPose(glm::vec3(1.0f + t), (frame % 2) ? -rot : rot, glm::vec3(t, t * 2.0f, -t));
+    }
+    return frames;
+}
+
+void AnimTests::testClipDataCompression() {
+    const int FRAME_COUNT = 60;
+    const float ROT_EPSILON = 0.0001f;
+    const float TRANS_EPSILON = 0.01f;
+
+    std::vector<AnimPoseVec> frames = buildTestFrames(FRAME_COUNT);
+    AnimClipData clip(frames);
+    QCOMPARE(clip.getFrameCount(), FRAME_COUNT);
+    QCOMPARE(clip.getJointCount(), (int)frames[0].size());
+
+    // smaller than the uncompressed frames
+    size_t uncompressedSize = FRAME_COUNT * frames[0].size() * sizeof(AnimPose);
+    QVERIFY(clip.getMemorySize() < uncompressedSize / 2);
+
+    AnimPoseVec decoded(clip.getJointCount());
+    for (int frame = 0; frame < FRAME_COUNT; frame++) {
+        clip.sample(frame, decoded.data());
+        for (int joint = 0; joint < clip.getJointCount(); joint++) {
+            const AnimPose& expected = frames[frame][joint];
+            QVERIFY(glm::distance(decoded[joint].scale(), expected.scale()) < EPSILON);
+            QVERIFY(1.0f - fabsf(glm::dot(decoded[joint].rot(), expected.rot())) < ROT_EPSILON);
+            QVERIFY(glm::distance(decoded[joint].trans(), expected.trans()) < TRANS_EPSILON);
+        }
+    }
+
+    // constant tracks are exact
+    QVERIFY(decoded[0].rot() == frames[0][0].rot());
+    QVERIFY(decoded[0].trans() == frames[0][0].trans());
+
+    // blending two compressed frames matches blending the uncompressed ones
+    AnimPoseVec expected(clip.getJointCount());
+    AnimPoseVec actual(clip.getJointCount());
+    for (int frame = 0; frame < FRAME_COUNT - 1; frame++) {
+        float alpha = 0.37f;
+        ::blend(expected.size(), &frames[frame][0], &frames[frame + 1][0], alpha, &expected[0]);
+        clip.sample(frame, frame + 1, alpha, actual.data());
+        for (int joint = 0; joint < clip.getJointCount(); joint++) {
+            QVERIFY(glm::distance(actual[joint].scale(), expected[joint].scale()) < EPSILON);
+            QVERIFY(1.0f - fabsf(glm::dot(actual[joint].rot(), expected[joint].rot())) < ROT_EPSILON);
+            QVERIFY(glm::distance(actual[joint].trans(), expected[joint].trans()) < TRANS_EPSILON);
+        }
+    }
+}
+
+void AnimTests::testClipDataCache() {
+    int buildCount = 0;
+    auto builder = [&] {
+        buildCount++;
+        return buildTestFrames(10);
+    };
+
+    int cacheSize = AnimClipData::getCacheSize();
+    {
+        AnimClipData::Pointer a = AnimClipData::getOrCreate("testClipDataCache#a", builder);
+        AnimClipData::Pointer b = AnimClipData::getOrCreate("testClipDataCache#a", builder);
+        AnimClipData::Pointer c = AnimClipData::getOrCreate("testClipDataCache#c", builder);
+        QVERIFY(a == b);
+        QVERIFY(a != c);
+        QCOMPARE(buildCount, 2);
+        QCOMPARE(AnimClipData::getCacheSize(), cacheSize + 2);
+    }
+
+    // released when the last clip lets go
+    QCOMPARE(AnimClipData::getCacheSize(), cacheSize);
+    AnimClipData::getOrCreate("testClipDataCache#a", builder);
+    QCOMPARE(buildCount, 3);
+}
+
 void AnimTests::testLoader() {
     auto url = QUrl("https://gist.githubusercontent.com/hyperlogic/857129fe04567cbe670f/raw/0c54500f480fd7314a5aeb147c45a8a707edcc2e/test.json");
     // NOTE: This will warn about missing "test01.fbx", "test02.fbx", etc. if the resource loading code doesn't handle relative pathnames!
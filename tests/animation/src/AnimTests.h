@@ -23,6 +23,8 @@ private slots:
     void testClipInternalState();
     void testClipEvaulate();
     void testClipEvaulateWithVars();
+    void testClipDataCompression();
+    void testClipDataCache();
     void testLoader();
     void testVariant();
     void testAccumulateTime();
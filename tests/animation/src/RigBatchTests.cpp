@@ -0,0 +1,197 @@
+//
+//  RigBatchTests.cpp
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "RigBatchTests.h"
+
+#include <Rig.h>
+#include <RigBatch.h>
+
+#include "../QTestExtensions.h"
+
+QTEST_MAIN(RigBatchTests)
+
+const float EPSILON = 0.0001f;
+const float DELTA_TIME = 1.0f / 60.0f;
+
+const int CROWD_JOINT_COUNT = 60;
+const int CROWD_AVATAR_COUNT = 100;
+const int CROWD_FRAME_COUNT = 10;
+
+static float randFloat(float min, float max) {
+    return min + (max - min) * ((float)qrand() / (float)RAND_MAX);
+}
+
+// a tree where every joint has up to three children
+static FBXGeometry makeTestGeometry(int jointCount) {
+    FBXGeometry geometry;
+    for (int i = 0; i < jointCount; i++) {
+        FBXJoint joint;
+        joint.parentIndex = (i == 0) ? -1 : (i - 1) / 3;
+        joint.name = QString("joint%1").arg(i);
+        joint.translation = glm::vec3(0.0f, 0.1f, 0.0f);
+        joint.preTransform = glm::mat4();
+        joint.preRotation = glm::quat();
+        joint.rotation = glm::quat();
+        joint.postRotation = glm::quat();
+        joint.postTransform = glm::mat4();
+        joint.transform = glm::mat4();
+        joint.bindTransform = glm::mat4();
+        joint.bindTransformFoundInCluster = false;
+        geometry.joints.push_back(joint);
+    }
+    return geometry;
+}
+
+// joints as received from the avatar mixer
+static QVector<JointData> makeJointData(int jointCount) {
+    QVector<JointData> jointData(jointCount);
+    for (auto& data : jointData) {
+        data.rotation = glm::normalize(glm::quat(randFloat(-1.0f, 1.0f), randFloat(-1.0f, 1.0f), randFloat(-1.0f, 1.0f), randFloat(-1.0f, 1.0f)));
+        data.rotationSet = true;
+        data.translation = glm::vec3(randFloat(-0.1f, 0.1f), randFloat(0.0f, 0.2f), randFloat(-0.1f, 0.1f));
+        data.translationSet = true;
+    }
+    return jointData;
+}
+
+static std::vector<RigPointer> makeCrowd(int avatarCount, int jointCount, RigBatch::Pointer batch) {
+    FBXGeometry geometry = makeTestGeometry(jointCount);
+    std::vector<RigPointer> rigs;
+    for (int i = 0; i < avatarCount; i++) {
+        auto rig = std::make_shared<Rig>();
+        rig->initJointStates(geometry, glm::mat4());
+        rig->setRigBatch(batch);
+        rigs.push_back(rig);
+    }
+    return rigs;
+}
+
+void RigBatchTests::testDeferredEvaluation() {
+    auto batch = std::make_shared<RigBatch>();
+    auto rigs = makeCrowd(1, 10, batch);
+    RigPointer rig = rigs[0];
+
+    rig->copyJointsFromJointData(makeJointData(10));
+    rig->updateAnimations(DELTA_TIME, glm::mat4());
+    rig->updateAnimations(DELTA_TIME, glm::mat4());
+    QCOMPARE(batch->getNumQueued(), 1);
+
+    // nothing is published until the batch is evaluated
+    AnimPose pose;
+    QVERIFY(!rig->getAbsoluteJointPoseInRigFrame(0, pose));
+
+    batch->evaluate();
+    QCOMPARE(batch->getNumQueued(), 0);
+    QCOMPARE(batch->getNumEvaluated(), 1);
+    QVERIFY(rig->getAbsoluteJointPoseInRigFrame(0, pose));
+}
+
+void RigBatchTests::testBatchMatchesSerial() {
+    const int AVATAR_COUNT = 20;
+    const int JOINT_COUNT = 30;
+
+    auto batch = std::make_shared<RigBatch>();
+    batch->setMaxThreadCount(4);
+    auto batchedRigs = makeCrowd(AVATAR_COUNT, JOINT_COUNT, batch);
+    auto serialRigs = makeCrowd(AVATAR_COUNT, JOINT_COUNT, nullptr);
+
+    for (int frame = 0; frame < 3; frame++) {
+        for (int i = 0; i < AVATAR_COUNT; i++) {
+            auto jointData = makeJointData(JOINT_COUNT);
+            batchedRigs[i]->copyJointsFromJointData(jointData);
+            batchedRigs[i]->updateAnimations(DELTA_TIME, glm::mat4());
+            serialRigs[i]->copyJointsFromJointData(jointData);
+            serialRigs[i]->updateAnimations(DELTA_TIME, glm::mat4());
+        }
+        batch->evaluate();
+        QCOMPARE(batch->getNumEvaluated(), AVATAR_COUNT);
+
+        for (int i = 0; i < AVATAR_COUNT; i++) {
+            for (int joint = 0; joint < JOINT_COUNT; joint++) {
+                AnimPose expected;
+                AnimPose actual;
+                QVERIFY(serialRigs[i]->getAbsoluteJointPoseInRigFrame(joint, expected));
+                QVERIFY(batchedRigs[i]->getAbsoluteJointPoseInRigFrame(joint, actual));
+                QCOMPARE_WITH_ABS_ERROR((glm::mat4)actual, (glm::mat4)expected, EPSILON);
+            }
+        }
+    }
+}
+
+void RigBatchTests::testAnimationLOD() {
+    const int JOINT_COUNT = 4;
+    auto rigs = makeCrowd(1, JOINT_COUNT, nullptr);
+    RigPointer rig = rigs[0];
+
+    auto updateAndGetTrans = [&] {
+        auto jointData = makeJointData(JOINT_COUNT);
+        rig->copyJointsFromJointData(jointData);
+        rig->updateAnimations(DELTA_TIME, glm::mat4());
+        AnimPose pose;
+        rig->getAbsoluteJointPoseInRigFrame(JOINT_COUNT - 1, pose);
+        return pose.trans();
+    };
+
+    glm::vec3 trans0 = updateAndGetTrans();
+
+    // reduced detail only updates every other frame
+    rig->setAnimationLOD(Rig::AnimationLOD::Reduced);
+    glm::vec3 trans1 = updateAndGetTrans();
+    QCOMPARE(trans1, trans0);
+    glm::vec3 trans2 = updateAndGetTrans();
+    QVERIFY(trans2 != trans1);
+    glm::vec3 trans3 = updateAndGetTrans();
+    QCOMPARE(trans3, trans2);
+
+    // going back to full detail updates right away
+    rig->setAnimationLOD(Rig::AnimationLOD::Full);
+    QVERIFY(updateAndGetTrans() != trans3);
+}
+
+enum CrowdVariant {
+    SERIAL,
+    BATCHED,
+    BATCHED_WITH_LOD
+};
+
+void RigBatchTests::benchmarkCrowd_data() {
+    QTest::addColumn<int>("variant");
+    QTest::newRow("serial") << (int)SERIAL;
+    QTest::newRow("batched") << (int)BATCHED;
+    QTest::newRow("batched with LOD") << (int)BATCHED_WITH_LOD;
+}
+
+// A crowd of avatars updated from network joint data, as AvatarManager::updateOtherAvatars does.
+// The LOD variant puts two thirds of the crowd at reduced and minimal detail.
+void RigBatchTests::benchmarkCrowd() {
+    QFETCH(int, variant);
+
+    auto batch = std::make_shared<RigBatch>();
+    auto rigs = makeCrowd(CROWD_AVATAR_COUNT, CROWD_JOINT_COUNT, variant == SERIAL ? nullptr : batch);
+    if (variant == BATCHED_WITH_LOD) {
+        for (int i = 0; i < CROWD_AVATAR_COUNT; i++) {
+            rigs[i]->setAnimationLOD((Rig::AnimationLOD)(i % 3));
+        }
+    }
+
+    std::vector<QVector<JointData>> jointData;
+    for (int frame = 0; frame < CROWD_FRAME_COUNT; frame++) {
+        jointData.push_back(makeJointData(CROWD_JOINT_COUNT));
+    }
+
+    int frame = 0;
+    QBENCHMARK {
+        for (auto& rig : rigs) {
+            rig->copyJointsFromJointData(jointData[frame % CROWD_FRAME_COUNT]);
+            rig->updateAnimations(DELTA_TIME, glm::mat4());
+        }
+        batch->evaluate();
+        frame++;
+    }
+}
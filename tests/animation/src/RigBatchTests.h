@@ -0,0 +1,25 @@
+//
+//  RigBatchTests.h
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_RigBatchTests_h
+#define hifi_RigBatchTests_h
+
+#include <QtTest/QtTest>
+
+class RigBatchTests : public QObject {
+    Q_OBJECT
+private slots:
+    void testDeferredEvaluation();
+    void testBatchMatchesSerial();
+    void testAnimationLOD();
+    void benchmarkCrowd_data();
+    void benchmarkCrowd();
+};
+
+#endif // hifi_RigBatchTests_h
@@ -0,0 +1,153 @@
+//
+//  AudioDSPBenchmarkTests.cpp
+//  tests/audio/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioDSPBenchmarkTests.h"
+
+#include <AudioConstants.h>
+#include <AudioLimiter.h>
+#include <AudioReverb.h>
+
+#include "AudioDSPTestUtils.h"
+
+QTEST_MAIN(AudioDSPBenchmarkTests)
+
+// Each benchmark times one block, at the block size the mixer or client renders, on every
+// dispatch path this CPU supports. Reverb and limiter have no SIMD paths.
+
+static void addPaths() {
+    QTest::addColumn<int>("path");
+    QTest::newRow(AudioDispatch::getPathName(AudioDispatch::BASELINE)) << (int)AudioDispatch::BASELINE;
+    for (auto path : getSIMDPaths()) {
+        QTest::newRow(AudioDispatch::getPathName(path)) << (int)path;
+    }
+}
+
+void AudioDSPBenchmarkTests::benchmarkHRTF_data() {
+    addPaths();
+}
+
+// a moving source, so the block crossfades between old and new filters
+void AudioDSPBenchmarkTests::benchmarkHRTF() {
+    QFETCH(int, path);
+    ScopedDispatchPath dispatchPath((AudioDispatch::Path)path);
+
+    AudioHRTF hrtf;
+    auto input = makeNoise(HRTF_BLOCK, 1);
+    float output[2 * HRTF_BLOCK] = {};
+    float azimuth = 0.0f;
+
+    QBENCHMARK {
+        azimuth += 0.01f;
+        hrtf.render(input.data(), output, 1, azimuth, 2.0f, 0.5f, HRTF_BLOCK);
+    }
+}
+
+void AudioDSPBenchmarkTests::benchmarkFOA_data() {
+    addPaths();
+}
+
+void AudioDSPBenchmarkTests::benchmarkFOA() {
+    QFETCH(int, path);
+    ScopedDispatchPath dispatchPath((AudioDispatch::Path)path);
+
+    AudioFOA foa;
+    auto input = makeNoise(4 * FOA_BLOCK, 2);
+    float output[2 * FOA_BLOCK] = {};
+    float angle = 0.0f;
+
+    QBENCHMARK {
+        angle += 0.01f;
+        foa.render(input.data(), output, 1, std::cos(angle / 2), 0.0f, std::sin(angle / 2), 0.0f, 0.5f, FOA_BLOCK);
+    }
+}
+
+void AudioDSPBenchmarkTests::benchmarkSRC_data() {
+    QTest::addColumn<int>("inputRate");
+    QTest::addColumn<int>("outputRate");
+    QTest::addColumn<int>("numChannels");
+    QTest::addColumn<int>("path");
+
+    struct Conversion {
+        const char* name;
+        int inputRate;
+        int outputRate;
+        int numChannels;
+    };
+
+    // microphone to network, network to output device, and ambisonic injectors
+    const Conversion CONVERSIONS[] = {
+        { "48000 to 24000 mono", 48000, 24000, 1 },
+        { "44100 to 24000 mono", 44100, 24000, 1 },
+        { "24000 to 48000 stereo", 24000, 48000, 2 },
+        { "24000 to 44100 stereo", 24000, 44100, 2 },
+        { "48000 to 24000 ambisonic", 48000, 24000, 4 },
+    };
+
+    std::vector<AudioDispatch::Path> paths { AudioDispatch::BASELINE };
+    for (auto path : getSIMDPaths()) {
+        paths.push_back(path);
+    }
+
+    for (const auto& conversion : CONVERSIONS) {
+        for (auto path : paths) {
+            QTest::newRow(qPrintable(QString("%1, %2").arg(conversion.name).arg(AudioDispatch::getPathName(path))))
+                << conversion.inputRate << conversion.outputRate << conversion.numChannels << (int)path;
+        }
+    }
+}
+
+// one 10ms block
+void AudioDSPBenchmarkTests::benchmarkSRC() {
+    QFETCH(int, inputRate);
+    QFETCH(int, outputRate);
+    QFETCH(int, numChannels);
+    QFETCH(int, path);
+    ScopedDispatchPath dispatchPath((AudioDispatch::Path)path);
+
+    AudioSRC src(inputRate, outputRate, numChannels);
+    int inputFrames = inputRate / 100;
+    auto input = makeFloatNoise(inputFrames * numChannels, 3);
+    std::vector<float> output(src.getMaxOutput(inputFrames) * numChannels);
+
+    QBENCHMARK {
+        src.render(input.data(), output.data(), inputFrames);
+    }
+}
+
+void AudioDSPBenchmarkTests::benchmarkReverb() {
+    AudioReverb reverb(AudioConstants::SAMPLE_RATE);
+    ReverbParameters parameters;
+    reverb.getParameters(&parameters);
+    parameters.wetDryMix = 100.0f;
+    reverb.setParameters(&parameters);
+
+    const int NUM_FRAMES = AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL;
+    auto input = makeFloatNoise(2 * NUM_FRAMES, 4);
+    std::vector<float> output(2 * NUM_FRAMES);
+
+    QBENCHMARK {
+        reverb.render(input.data(), output.data(), NUM_FRAMES);
+    }
+}
+
+void AudioDSPBenchmarkTests::benchmarkLimiter() {
+    AudioLimiter limiter(AudioConstants::SAMPLE_RATE, AudioConstants::STEREO);
+
+    const int NUM_FRAMES = AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL;
+    auto input = makeFloatNoise(2 * NUM_FRAMES, 5);
+    for (auto& sample : input) {
+        sample *= 4.0f;
+    }
+    std::vector<int16_t> output(2 * NUM_FRAMES);
+
+    QBENCHMARK {
+        limiter.render(input.data(), output.data(), NUM_FRAMES);
+    }
+}
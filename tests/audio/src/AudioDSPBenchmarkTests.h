@@ -0,0 +1,29 @@
+//
+//  AudioDSPBenchmarkTests.h
+//  tests/audio/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioDSPBenchmarkTests_h
+#define hifi_AudioDSPBenchmarkTests_h
+
+#include <QtTest/QtTest>
+
+class AudioDSPBenchmarkTests : public QObject {
+    Q_OBJECT
+private slots:
+    void benchmarkHRTF_data();
+    void benchmarkHRTF();
+    void benchmarkFOA_data();
+    void benchmarkFOA();
+    void benchmarkSRC_data();
+    void benchmarkSRC();
+    void benchmarkReverb();
+    void benchmarkLimiter();
+};
+
+#endif // hifi_AudioDSPBenchmarkTests_h
@@ -0,0 +1,107 @@
+//
+//  AudioDSPTestUtils.h
+//  tests/audio/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioDSPTestUtils_h
+#define hifi_AudioDSPTestUtils_h
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include <AudioDispatch.h>
+#include <AudioFOA.h>
+#include <AudioHRTF.h>
+#include <AudioSRC.h>
+
+// Inputs and render loops shared by the DSP tests and benchmarks. Every render is deterministic,
+// so the same call under two dispatch paths should give the same output, to within rounding.
+
+// the dispatch paths above the baseline that this CPU supports
+inline std::vector<AudioDispatch::Path> getSIMDPaths() {
+    std::vector<AudioDispatch::Path> paths;
+    if (AudioDispatch::getSupportedPath() >= AudioDispatch::AVX2) {
+        paths.push_back(AudioDispatch::AVX2);
+    }
+    if (AudioDispatch::getSupportedPath() >= AudioDispatch::AVX512) {
+        paths.push_back(AudioDispatch::AVX512);
+    }
+    return paths;
+}
+
+// lowers the dispatch path for a scope
+class ScopedDispatchPath {
+public:
+    ScopedDispatchPath(AudioDispatch::Path path) { AudioDispatch::setPathLimit(path); }
+    ~ScopedDispatchPath() { AudioDispatch::setPathLimit(AudioDispatch::getSupportedPath()); }
+};
+
+// uniform noise at half of full scale
+inline std::vector<int16_t> makeNoise(size_t numSamples, unsigned int seed) {
+    std::mt19937 generator(seed);
+    std::vector<int16_t> samples(numSamples);
+    for (auto& sample : samples) {
+        sample = (int16_t)((int)(generator() % 32768) - 16384);
+    }
+    return samples;
+}
+
+inline std::vector<float> makeFloatNoise(size_t numSamples, unsigned int seed) {
+    std::vector<float> samples;
+    samples.reserve(numSamples);
+    for (int16_t sample : makeNoise(numSamples, seed)) {
+        samples.push_back(sample * (1 / 32768.0f));
+    }
+    return samples;
+}
+
+// a source circling the listener and moving away, so every block crossfades
+inline std::vector<float> renderHRTF(int numBlocks) {
+    AudioHRTF hrtf;
+    auto input = makeNoise(numBlocks * HRTF_BLOCK, 1);
+    std::vector<float> output(numBlocks * 2 * HRTF_BLOCK, 0.0f);
+
+    for (int block = 0; block < numBlocks; block++) {
+        float azimuth = 0.3f * block;
+        float distance = 1.0f + 2.0f * block;
+        hrtf.render(&input[block * HRTF_BLOCK], &output[block * 2 * HRTF_BLOCK], 1, azimuth, distance, 0.5f, HRTF_BLOCK);
+    }
+    return output;
+}
+
+// an ambisonic source turning about the vertical axis
+inline std::vector<float> renderFOA(int numBlocks) {
+    AudioFOA foa;
+    auto input = makeNoise(numBlocks * 4 * FOA_BLOCK, 2);
+    std::vector<float> output(numBlocks * 2 * FOA_BLOCK, 0.0f);
+
+    for (int block = 0; block < numBlocks; block++) {
+        float angle = 0.2f * block;
+        foa.render(&input[block * 4 * FOA_BLOCK], &output[block * 2 * FOA_BLOCK], 1,
+                   std::cos(angle / 2), 0.0f, std::sin(angle / 2), 0.0f, 0.5f, FOA_BLOCK);
+    }
+    return output;
+}
+
+// 10ms blocks of interleaved float audio
+inline std::vector<float> renderSRC(int inputRate, int outputRate, int numChannels, int numBlocks) {
+    AudioSRC src(inputRate, outputRate, numChannels);
+    int inputFrames = inputRate / 100;
+    auto input = makeFloatNoise(numBlocks * inputFrames * numChannels, 3);
+    std::vector<float> block(src.getMaxOutput(inputFrames) * numChannels);
+    std::vector<float> output;
+
+    for (int i = 0; i < numBlocks; i++) {
+        int outputFrames = src.render(&input[i * inputFrames * numChannels], block.data(), inputFrames);
+        output.insert(output.end(), block.begin(), block.begin() + outputFrames * numChannels);
+    }
+    return output;
+}
+
+#endif // hifi_AudioDSPTestUtils_h
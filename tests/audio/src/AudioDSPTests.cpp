@@ -0,0 +1,179 @@
+//
+//  AudioDSPTests.cpp
+//  tests/audio/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioDSPTests.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <AudioConstants.h>
+#include <AudioLimiter.h>
+#include <AudioReverb.h>
+
+#include "AudioDSPTestUtils.h"
+
+QTEST_MAIN(AudioDSPTests)
+
+static const int NUM_BLOCKS = 50;
+
+// the SIMD paths use FMA and sum in a different order, so outputs differ from the baseline by rounding
+static const float HRTF_TOLERANCE = 1.0e-5f;
+static const float FOA_TOLERANCE = 1.0e-5f;
+static const float SRC_TOLERANCE = 1.0e-5f;
+
+static void compareOutputs(const std::vector<float>& actual, const std::vector<float>& expected, float tolerance,
+                           AudioDispatch::Path path) {
+    QCOMPARE(actual.size(), expected.size());
+
+    float maxError = 0.0f;
+    for (size_t i = 0; i < actual.size(); i++) {
+        maxError = std::max(maxError, std::abs(actual[i] - expected[i]));
+    }
+    QVERIFY2(maxError <= tolerance, qPrintable(QString("%1 path is off by %2").arg(AudioDispatch::getPathName(path)).arg(maxError)));
+}
+
+void AudioDSPTests::testHRTF() {
+    std::vector<float> expected;
+    {
+        ScopedDispatchPath baseline(AudioDispatch::BASELINE);
+        expected = renderHRTF(NUM_BLOCKS);
+    }
+
+    for (auto path : getSIMDPaths()) {
+        ScopedDispatchPath simd(path);
+        compareOutputs(renderHRTF(NUM_BLOCKS), expected, HRTF_TOLERANCE, path);
+    }
+}
+
+void AudioDSPTests::testFOA() {
+    std::vector<float> expected;
+    {
+        ScopedDispatchPath baseline(AudioDispatch::BASELINE);
+        expected = renderFOA(NUM_BLOCKS);
+    }
+
+    for (auto path : getSIMDPaths()) {
+        ScopedDispatchPath simd(path);
+        compareOutputs(renderFOA(NUM_BLOCKS), expected, FOA_TOLERANCE, path);
+    }
+}
+
+void AudioDSPTests::testSRC_data() {
+    QTest::addColumn<int>("inputRate");
+    QTest::addColumn<int>("outputRate");
+    QTest::addColumn<int>("numChannels");
+
+    // multirateFilter1/2/4, with rational and irrational ratios
+    QTest::newRow("48000 to 24000 mono") << 48000 << 24000 << 1;
+    QTest::newRow("48000 to 24000 stereo") << 48000 << 24000 << 2;
+    QTest::newRow("24000 to 48000 stereo") << 24000 << 48000 << 2;
+    QTest::newRow("44100 to 24000 stereo") << 44100 << 24000 << 2;
+    QTest::newRow("24000 to 44100 stereo") << 24000 << 44100 << 2;
+    QTest::newRow("48000 to 24000 ambisonic") << 48000 << 24000 << 4;
+}
+
+void AudioDSPTests::testSRC() {
+    QFETCH(int, inputRate);
+    QFETCH(int, outputRate);
+    QFETCH(int, numChannels);
+
+    std::vector<float> expected;
+    {
+        ScopedDispatchPath baseline(AudioDispatch::BASELINE);
+        expected = renderSRC(inputRate, outputRate, numChannels, NUM_BLOCKS);
+    }
+    QVERIFY(!expected.empty());
+
+    for (auto path : getSIMDPaths()) {
+        ScopedDispatchPath simd(path);
+        compareOutputs(renderSRC(inputRate, outputRate, numChannels, NUM_BLOCKS), expected, SRC_TOLERANCE, path);
+    }
+}
+
+void AudioDSPTests::testReverbDryIsUnchanged() {
+    AudioReverb reverb(AudioConstants::SAMPLE_RATE);
+    ReverbParameters parameters;
+    reverb.getParameters(&parameters);
+    parameters.wetDryMix = 0.0f;
+    reverb.setParameters(&parameters);
+
+    const int NUM_FRAMES = AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL;
+    auto input = makeFloatNoise(NUM_BLOCKS * 2 * NUM_FRAMES, 4);
+    std::vector<float> output(input.size());
+    for (int block = 0; block < NUM_BLOCKS; block++) {
+        reverb.render(&input[block * 2 * NUM_FRAMES], &output[block * 2 * NUM_FRAMES], NUM_FRAMES);
+    }
+    QVERIFY(output == input);
+}
+
+void AudioDSPTests::testReverbReset() {
+    const int NUM_FRAMES = AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL;
+    auto input = makeFloatNoise(NUM_BLOCKS * 2 * NUM_FRAMES, 5);
+    std::vector<float> silence(input.size(), 0.0f);
+
+    auto render = [&](AudioReverb& reverb, const std::vector<float>& in) {
+        std::vector<float> output(in.size());
+        for (int block = 0; block < NUM_BLOCKS; block++) {
+            reverb.render(&in[block * 2 * NUM_FRAMES], &output[block * 2 * NUM_FRAMES], NUM_FRAMES);
+        }
+        return output;
+    };
+
+    ReverbParameters parameters;
+    AudioReverb reverb(AudioConstants::SAMPLE_RATE);
+    reverb.getParameters(&parameters);
+    parameters.wetDryMix = 100.0f;
+    reverb.setParameters(&parameters);
+
+    AudioReverb sameReverb(AudioConstants::SAMPLE_RATE);
+    sameReverb.setParameters(&parameters);
+
+    auto output = render(reverb, input);
+    QVERIFY(std::all_of(output.begin(), output.end(), [](float sample) { return std::isfinite(sample); }));
+    QVERIFY(render(sameReverb, input) == output);
+
+    // the tail rings on until reset clears it, leaving only the reverb's anti-denormal offset
+    auto peak = [](const std::vector<float>& samples) {
+        float result = 0.0f;
+        for (float sample : samples) {
+            result = std::max(result, std::abs(sample));
+        }
+        return result;
+    };
+    QVERIFY(peak(render(reverb, silence)) > 1.0e-3f);
+    reverb.reset();
+    QVERIFY(peak(render(reverb, silence)) < 1.0e-12f);
+}
+
+void AudioDSPTests::testLimiterCeiling() {
+    AudioLimiter limiter(AudioConstants::SAMPLE_RATE, AudioConstants::STEREO);
+    limiter.setThreshold(-6.0f);
+
+    // noise at four times full scale
+    const int NUM_FRAMES = AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL;
+    auto input = makeFloatNoise(NUM_BLOCKS * 2 * NUM_FRAMES, 6);
+    for (auto& sample : input) {
+        sample *= 8.0f;
+    }
+
+    std::vector<int16_t> output(input.size());
+    for (int block = 0; block < NUM_BLOCKS; block++) {
+        limiter.render(&input[block * 2 * NUM_FRAMES], &output[block * 2 * NUM_FRAMES], NUM_FRAMES);
+    }
+
+    // the output ceiling is -0.3dBFS, with a little dither on top
+    const int CEILING = (int)(32768 * std::pow(10.0, -0.3 / 20.0)) + 2;
+    int peak = 0;
+    for (int16_t sample : output) {
+        peak = std::max(peak, std::abs((int)sample));
+    }
+    QVERIFY2(peak <= CEILING, qPrintable(QString("peak %1 is over the ceiling %2").arg(peak).arg(CEILING)));
+    QVERIFY(peak > CEILING / 2);
+}
@@ -0,0 +1,151 @@
+//
+//  AudioHRTFTests.cpp
+//  tests/audio/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioHRTFTests.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <AudioHRTF.h>
+
+QTEST_MAIN(AudioHRTFTests)
+
+static const int HRTF_INDEX = 1;
+static const int NUM_SOURCES = 9; // odd, so one steady source is left without a pair
+static const int NUM_BLOCKS = 40;
+
+// reordering the sum of the sources can change the output by an ulp or so
+static const float MIX_TOLERANCE = 1.0e-6f;
+
+// the same sources, rendered one at a time and in a batch
+struct SourceSet {
+    SourceSet(int numSources) :
+        serial(new AudioHRTF[numSources]),
+        batched(new AudioHRTF[numSources]),
+        input(numSources * HRTF_BLOCK),
+        azimuth(numSources),
+        distance(numSources),
+        gain(numSources) {
+
+        for (int i = 0; i < numSources; i++) {
+            azimuth[i] = 0.7f * i;
+            distance[i] = 1.0f + 3.0f * i;
+            gain[i] = 1.0f - 0.05f * i;
+        }
+    }
+
+    std::unique_ptr<AudioHRTF[]> serial;
+    std::unique_ptr<AudioHRTF[]> batched;
+    std::vector<int16_t> input;
+    std::vector<float> azimuth;
+    std::vector<float> distance;
+    std::vector<float> gain;
+};
+
+static void fillInput(std::vector<int16_t>& input, std::mt19937& generator) {
+    for (auto& sample : input) {
+        sample = (int16_t)((int)(generator() % 20001) - 10000);
+    }
+}
+
+// renders a block of every source both ways, returning the largest difference in the output
+static float renderBlock(SourceSet& set, int numSources, bool isExact) {
+    float serialOutput[2 * HRTF_BLOCK] = {};
+    float batchedOutput[2 * HRTF_BLOCK] = {};
+
+    std::vector<AudioHRTF::Source> sources;
+    for (int i = 0; i < numSources; i++) {
+        int16_t* input = &set.input[i * HRTF_BLOCK];
+        set.serial[i].render(input, serialOutput, HRTF_INDEX, set.azimuth[i], set.distance[i], set.gain[i], HRTF_BLOCK);
+        sources.push_back({ &set.batched[i], input, set.azimuth[i], set.distance[i], set.gain[i] });
+    }
+    AudioHRTF::renderBatch(sources.data(), numSources, batchedOutput, HRTF_INDEX, HRTF_BLOCK);
+
+    float maxDifference = 0.0f;
+    for (int i = 0; i < 2 * HRTF_BLOCK; i++) {
+        if (isExact && serialOutput[i] != batchedOutput[i]) {
+            qWarning() << "sample" << i << ":" << batchedOutput[i] << "!=" << serialOutput[i];
+            return std::numeric_limits<float>::infinity();
+        }
+        maxDifference = std::max(maxDifference, std::abs(serialOutput[i] - batchedOutput[i]));
+    }
+    return maxDifference;
+}
+
+void AudioHRTFTests::steadySourcesAreBitExact() {
+    std::mt19937 generator(1);
+    SourceSet set(NUM_SOURCES);
+
+    // the first block crossfades in from the initial parameters, every block after it is steady
+    for (int block = 0; block < NUM_BLOCKS; block++) {
+        fillInput(set.input, generator);
+        QCOMPARE(renderBlock(set, NUM_SOURCES, true), 0.0f);
+    }
+}
+
+void AudioHRTFTests::movingSourcesMatchRender() {
+    std::mt19937 generator(2);
+    SourceSet set(NUM_SOURCES);
+
+    for (int block = 0; block < NUM_BLOCKS; block++) {
+        fillInput(set.input, generator);
+
+        // move some of the sources, the batch renders them after the steady ones
+        for (int i = block % 3; i < NUM_SOURCES; i += 3) {
+            set.azimuth[i] += 0.05f;
+            set.distance[i] *= 1.1f;
+        }
+        QVERIFY(renderBlock(set, NUM_SOURCES, false) < MIX_TOLERANCE);
+    }
+
+    // per-source state came out the same either way
+    fillInput(set.input, generator);
+    QCOMPARE(renderBlock(set, NUM_SOURCES, true), 0.0f);
+}
+
+// A listener in a crowd of steady sources, as the audio mixer renders it every frame.
+void AudioHRTFTests::benchmarkThroughput() {
+    const int NUM_CROWD_SOURCES = 100;
+    const int NUM_CROWD_BLOCKS = 1000;
+
+    std::mt19937 generator(3);
+    SourceSet set(NUM_CROWD_SOURCES);
+    fillInput(set.input, generator);
+
+    std::vector<AudioHRTF::Source> sources;
+    for (int i = 0; i < NUM_CROWD_SOURCES; i++) {
+        sources.push_back({ &set.batched[i], &set.input[i * HRTF_BLOCK], set.azimuth[i], set.distance[i], set.gain[i] });
+    }
+    float output[2 * HRTF_BLOCK] = {};
+
+    QElapsedTimer timer;
+    timer.start();
+    for (int block = 0; block < NUM_CROWD_BLOCKS; block++) {
+        for (int i = 0; i < NUM_CROWD_SOURCES; i++) {
+            set.serial[i].render(&set.input[i * HRTF_BLOCK], output, HRTF_INDEX,
+                                 set.azimuth[i], set.distance[i], set.gain[i], HRTF_BLOCK);
+        }
+    }
+    double serialMsecs = timer.nsecsElapsed() / 1.0e6;
+
+    timer.restart();
+    for (int block = 0; block < NUM_CROWD_BLOCKS; block++) {
+        AudioHRTF::renderBatch(sources.data(), NUM_CROWD_SOURCES, output, HRTF_INDEX, HRTF_BLOCK);
+    }
+    double batchedMsecs = timer.nsecsElapsed() / 1.0e6;
+
+    const double NUM_RENDERS = (double)NUM_CROWD_SOURCES * NUM_CROWD_BLOCKS;
+    qDebug("render      %8.1f sources/ms", NUM_RENDERS / serialMsecs);
+    qDebug("renderBatch %8.1f sources/ms", NUM_RENDERS / batchedMsecs);
+}
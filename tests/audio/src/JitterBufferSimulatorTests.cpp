@@ -0,0 +1,128 @@
+//
+//  JitterBufferSimulatorTests.cpp
+//  tests/audio/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "JitterBufferSimulatorTests.h"
+
+#include <AudioConstants.h>
+#include <JitterBufferSimulator.h>
+
+QTEST_MAIN(JitterBufferSimulatorTests)
+
+static const float ADAPTIVE_PERCENTILE = 0.95f;
+
+static JitterBufferSimulator::Settings legacySettings() {
+    return JitterBufferSimulator::Settings();
+}
+
+static JitterBufferSimulator::Settings adaptiveSettings() {
+    JitterBufferSimulator::Settings settings;
+    settings.percentile = ADAPTIVE_PERCENTILE;
+    return settings;
+}
+
+static void compareReports(const JitterBufferSimulator::Report& a, const JitterBufferSimulator::Report& b) {
+    QCOMPARE(a.framesPlayed, b.framesPlayed);
+    QCOMPARE(a.framesStarved, b.framesStarved);
+    QCOMPARE(a.starves, b.starves);
+    QCOMPARE(a.framesDropped, b.framesDropped);
+    QCOMPARE(a.packetsLost, b.packetsLost);
+    QCOMPARE(a.latencyAverageMsecs, b.latencyAverageMsecs);
+    QCOMPARE(a.latencyP99Msecs, b.latencyP99Msecs);
+    QCOMPARE(a.desiredFrames, b.desiredFrames);
+}
+
+static void printReport(const char* name, const JitterBufferSimulator::Report& report) {
+    qDebug("%-10s latency avg %6.1f ms, p99 %6.1f ms | starves %4d, frames starved %5d | dropped %4d | desired %2d",
+           name, report.latencyAverageMsecs, report.latencyP99Msecs, report.starves, report.framesStarved,
+           report.framesDropped, report.desiredFrames);
+}
+
+void JitterBufferSimulatorTests::steadyTrace() {
+    // packets arriving exactly every frame play straight through a one frame buffer in either mode
+    JitterBufferSimulator::SyntheticTraceOptions options;
+    auto trace = JitterBufferSimulator::makeSyntheticTrace(options);
+    QCOMPARE((int)trace.size(), options.numPackets);
+
+    for (const auto& settings : { legacySettings(), adaptiveSettings() }) {
+        auto report = JitterBufferSimulator::run(trace, settings);
+        QCOMPARE(report.framesPlayed, options.numPackets);
+        QCOMPARE(report.starves, 0);
+        QCOMPARE(report.framesStarved, 0);
+        QCOMPARE(report.framesDropped, 0);
+        QCOMPARE(report.packetsLost, 0);
+        QCOMPARE(report.desiredFrames, 1);
+        QCOMPARE(report.latencyAverageMsecs, AudioConstants::NETWORK_FRAME_MSECS);
+    }
+}
+
+void JitterBufferSimulatorTests::lossIsCounted() {
+    JitterBufferSimulator::SyntheticTraceOptions options;
+    options.lossChance = 0.05f;
+    auto trace = JitterBufferSimulator::makeSyntheticTrace(options);
+    int packetsLost = options.numPackets - (int)trace.size();
+    QVERIFY(packetsLost > 0);
+
+    auto report = JitterBufferSimulator::run(trace, legacySettings());
+    QCOMPARE(report.packetsLost, packetsLost);
+}
+
+void JitterBufferSimulatorTests::runsAreDeterministic() {
+    JitterBufferSimulator::SyntheticTraceOptions options;
+    options.jitterMsecs = 3.0f;
+    options.spikeChance = 0.002f;
+    options.spikeMsecs = 80.0f;
+    options.lossChance = 0.01f;
+
+    auto trace = JitterBufferSimulator::makeSyntheticTrace(options);
+    auto sameTrace = JitterBufferSimulator::makeSyntheticTrace(options);
+    QCOMPARE(trace.size(), sameTrace.size());
+    for (size_t i = 0; i < trace.size(); ++i) {
+        QCOMPARE(trace[i].arrivalUsecs, sameTrace[i].arrivalUsecs);
+        QCOMPARE(trace[i].sequence, sameTrace[i].sequence);
+    }
+
+    for (const auto& settings : { legacySettings(), adaptiveSettings() }) {
+        compareReports(JitterBufferSimulator::run(trace, settings), JitterBufferSimulator::run(trace, settings));
+    }
+}
+
+void JitterBufferSimulatorTests::traceRoundTrip() {
+    JitterBufferSimulator::SyntheticTraceOptions options;
+    options.numPackets = 2000;
+    options.jitterMsecs = 5.0f;
+    options.lossChance = 0.02f;
+    auto trace = JitterBufferSimulator::makeSyntheticTrace(options);
+
+    QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+    QString path = directory.filePath("trace.txt");
+    QVERIFY(JitterBufferSimulator::saveTrace(trace, path));
+
+    auto loadedTrace = JitterBufferSimulator::loadTrace(path);
+    QCOMPARE(loadedTrace.size(), trace.size());
+    compareReports(JitterBufferSimulator::run(loadedTrace, legacySettings()),
+                   JitterBufferSimulator::run(trace, legacySettings()));
+}
+
+void JitterBufferSimulatorTests::adaptiveCutsLatency() {
+    // two minutes of moderate jitter: the window max the legacy scheme sizes for is far out in the tail
+    JitterBufferSimulator::SyntheticTraceOptions options;
+    options.numPackets = 12000;
+    options.jitterMsecs = 3.0f;
+    auto trace = JitterBufferSimulator::makeSyntheticTrace(options);
+
+    auto legacy = JitterBufferSimulator::run(trace, legacySettings());
+    auto adaptive = JitterBufferSimulator::run(trace, adaptiveSettings());
+    printReport("window max", legacy);
+    printReport("p95", adaptive);
+
+    QVERIFY(adaptive.latencyAverageMsecs < legacy.latencyAverageMsecs);
+    QVERIFY(adaptive.desiredFrames <= legacy.desiredFrames);
+}
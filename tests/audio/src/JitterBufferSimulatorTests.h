@@ -0,0 +1,26 @@
+//
+//  JitterBufferSimulatorTests.h
+//  tests/audio/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_JitterBufferSimulatorTests_h
+#define hifi_JitterBufferSimulatorTests_h
+
+#include <QtTest/QtTest>
+
+class JitterBufferSimulatorTests : public QObject {
+    Q_OBJECT
+private slots:
+    void steadyTrace();
+    void lossIsCounted();
+    void runsAreDeterministic();
+    void traceRoundTrip();
+    void adaptiveCutsLatency();
+};
+
+#endif // hifi_JitterBufferSimulatorTests_h
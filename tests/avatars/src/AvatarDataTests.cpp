@@ -0,0 +1,252 @@
+//
+//  AvatarDataTests.cpp
+//  tests/avatars/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AvatarDataTests.h"
+
+#include <memory>
+
+#include <AvatarData.h>
+#include <HeadData.h>
+#include <udt/Constants.h>
+
+#include <../GLMTestUtils.h>
+#include <../QTestExtensions.h>
+
+QTEST_MAIN(AvatarDataTests)
+
+const int NUM_JOINTS = 60;
+const int NUM_BLENDSHAPES = 50;
+
+// an avatar with a face tracker and every joint set, so every section is sent
+class TestAvatar : public AvatarData {
+public:
+    TestAvatar(int numJoints = NUM_JOINTS) {
+        setForceFaceTrackerConnected(true);
+        lazyInitHeadData();
+
+        _globalPosition = glm::vec3(1.0f, 2.0f, 3.0f);
+        setBlendshapeCoefficients(QVector<float>(NUM_BLENDSHAPES, 0.5f));
+
+        QVector<JointData> joints(numJoints);
+        for (int i = 0; i < numJoints; i++) {
+            joints[i].rotation = glm::angleAxis(0.01f * i, glm::vec3(0.0f, 1.0f, 0.0f));
+            joints[i].rotationSet = true;
+            joints[i].translation = glm::vec3(0.0f, 0.1f, 0.0f);
+            joints[i].translationSet = true;
+        }
+        setRawJointData(joints);
+    }
+
+    // a full update, as the mixer sends it
+    int encode(unsigned char* buffer, int capacity) const {
+        AvatarDataPacket::HasFlags hasFlags;
+        return toBuffer(buffer, capacity, SendAllData, 0, QVector<JointData>(getRawJointData().size()), hasFlags, false,
+            false, glm::vec3(0.0f), nullptr);
+    }
+
+    QByteArray encode() const {
+        QByteArray buffer(udt::MAX_PACKET_SIZE, 0);
+        buffer.resize(encode(reinterpret_cast<unsigned char*>(buffer.data()), buffer.size()));
+        return buffer;
+    }
+};
+
+void AvatarDataTests::testRoundTrip() {
+    TestAvatar sender;
+    QByteArray buffer = sender.encode();
+    QVERIFY(buffer.size() > 0);
+    QCOMPARE(AvatarData::getAvatarDataSize(buffer), buffer.size());
+
+    AvatarData receiver;
+    QCOMPARE(receiver.parseDataFromBuffer(buffer), buffer.size());
+    QCOMPARE_WITH_ABS_ERROR(receiver.getClientGlobalPosition(), sender.getClientGlobalPosition(), EPSILON);
+    QCOMPARE(receiver.getHeadData()->getBlendshapeCoefficients().size(), NUM_BLENDSHAPES);
+
+    const auto& joints = receiver.getRawJointData();
+    QCOMPARE(joints.size(), NUM_JOINTS);
+    for (int i = 0; i < NUM_JOINTS; i++) {
+        QCOMPARE_QUATS(joints[i].rotation, sender.getRawJointData()[i].rotation, 0.001f);
+    }
+}
+
+// the data for two avatars back to back, as in a BulkAvatarData packet
+void AvatarDataTests::testSkipAvatar() {
+    TestAvatar first;
+    TestAvatar second;
+    QByteArray firstBuffer = first.encode();
+    QByteArray buffer = firstBuffer + second.encode();
+
+    int skipped = AvatarData::getAvatarDataSize(buffer);
+    QCOMPARE(skipped, firstBuffer.size());
+
+    AvatarData receiver;
+    QCOMPARE(receiver.parseDataFromBuffer(buffer.mid(skipped)), buffer.size() - skipped);
+    QCOMPARE(receiver.getRawJointData().size(), NUM_JOINTS);
+}
+
+void AvatarDataTests::testIgnoredSections() {
+    TestAvatar sender;
+    QByteArray buffer = sender.encode();
+
+    AvatarData receiver;
+    receiver.setIgnoredDataSections(AvatarDataPacket::PACKET_HAS_FACE_TRACKER_INFO | AvatarDataPacket::PACKET_HAS_JOINT_DATA);
+    QCOMPARE(receiver.parseDataFromBuffer(buffer), buffer.size());
+    QCOMPARE_WITH_ABS_ERROR(receiver.getClientGlobalPosition(), sender.getClientGlobalPosition(), EPSILON);
+    QCOMPARE(receiver.getHeadData()->getBlendshapeCoefficients().size(), 0);
+    QCOMPARE(receiver.getRawJointData().size(), 0);
+}
+
+void AvatarDataTests::testBufferTooSmall() {
+    TestAvatar sender;
+    QByteArray buffer = sender.encode();
+
+    std::vector<unsigned char> smallBuffer(buffer.size() - 1);
+    QCOMPARE(sender.encode(smallBuffer.data(), (int)smallBuffer.size()), -1);
+}
+
+// too many joints for a full update still sends the ones that changed, and never sends nothing
+void AvatarDataTests::testManyJoints() {
+    const int MANY_JOINTS = 200;
+    TestAvatar sender(MANY_JOINTS);
+    unsigned char buffer[udt::MAX_PACKET_SIZE];
+    QCOMPARE(sender.encode(buffer, udt::MAX_PACKET_SIZE), -1);
+
+    const int NUM_CHANGED_JOINTS = 10;
+    QVector<JointData> lastSentJointData = sender.getRawJointData();
+    for (int i = 0; i < NUM_CHANGED_JOINTS; i++) {
+        lastSentJointData[i].rotation = glm::angleAxis(1.0f, glm::vec3(1.0f, 0.0f, 0.0f));
+    }
+    AvatarDataPacket::HasFlags hasFlags;
+    QByteArray culled = sender.toByteArray(AvatarData::CullSmallData, 0, lastSentJointData, hasFlags, false, false,
+        glm::vec3(0.0f), nullptr);
+    QVERIFY(!culled.isEmpty());
+    QVERIFY(hasFlags & AvatarDataPacket::PACKET_HAS_JOINT_DATA);
+
+    AvatarData receiver;
+    QCOMPARE(receiver.parseDataFromBuffer(culled), culled.size());
+    const auto& joints = receiver.getRawJointData();
+    QCOMPARE(joints.size(), MANY_JOINTS);
+    for (int i = 0; i < NUM_CHANGED_JOINTS; i++) {
+        QCOMPARE_QUATS(joints[i].rotation, sender.getRawJointData()[i].rotation, 0.001f);
+    }
+
+    QByteArray stateful = sender.toByteArrayStateful(AvatarData::SendAllData);
+    QVERIFY(!stateful.isEmpty());
+    QCOMPARE(AvatarData::getAvatarDataSize(stateful), stateful.size());
+}
+
+// a newer sender may put more in a section than we read, the section after it still starts where the size says
+void AvatarDataTests::testLongerSection() {
+    TestAvatar sender;
+    QByteArray buffer = sender.encode();
+    DecodedAvatarData decoded;
+    AvatarData::decodeDataFromBuffer(buffer, decoded);
+
+    // the joint data is followed by the faux joints, which end the avatar
+    int jointSectionStart = buffer.size() - (int)AvatarDataPacket::FAUX_JOINT_DATA_SIZE - decoded.jointDataBytes;
+    const int NUM_EXTRA_BYTES = 4;
+    buffer.insert(jointSectionStart + decoded.jointDataBytes, QByteArray(NUM_EXTRA_BYTES, 0x7f));
+    AvatarDataPacket::SectionSize sectionSize = decoded.jointDataBytes + NUM_EXTRA_BYTES;
+    memcpy(buffer.data() + jointSectionStart, &sectionSize, sizeof(sectionSize));
+    AvatarDataPacket::AvatarDataSize avatarDataSize = buffer.size();
+    memcpy(buffer.data(), &avatarDataSize, sizeof(avatarDataSize));
+
+    AvatarData receiver;
+    QCOMPARE(receiver.parseDataFromBuffer(buffer), buffer.size());
+    QCOMPARE(receiver.getRawJointData().size(), NUM_JOINTS);
+    QCOMPARE_WITH_ABS_ERROR(receiver.getControllerLeftHandMatrix(), sender.getControllerLeftHandMatrix(), EPSILON);
+    QCOMPARE_WITH_ABS_ERROR(receiver.getControllerRightHandMatrix(), sender.getControllerRightHandMatrix(), EPSILON);
+}
+
+void AvatarDataTests::benchmarkEncode() {
+    TestAvatar sender;
+    unsigned char buffer[udt::MAX_PACKET_SIZE];
+
+    QBENCHMARK {
+        sender.encode(buffer, udt::MAX_PACKET_SIZE);
+    }
+}
+
+void AvatarDataTests::benchmarkDecode() {
+    TestAvatar sender;
+    QByteArray buffer = sender.encode();
+    AvatarData receiver;
+
+    QBENCHMARK {
+        receiver.parseDataFromBuffer(buffer);
+    }
+}
+
+// decoding on one thread and applying on another leaves an avatar as parsing does
+void AvatarDataTests::testDecodeThenApply() {
+    TestAvatar sender;
+    QByteArray buffer = sender.encode();
+
+    DecodedAvatarData decoded;
+    QCOMPARE(AvatarData::decodeDataFromBuffer(buffer, decoded), buffer.size());
+    QVERIFY(decoded.error.isEmpty());
+    QVERIFY(decoded.hasFlags & AvatarDataPacket::PACKET_HAS_JOINT_DATA);
+
+    AvatarData receiver;
+    receiver.applyDecodedData(decoded);
+    QCOMPARE_WITH_ABS_ERROR(receiver.getClientGlobalPosition(), sender.getClientGlobalPosition(), EPSILON);
+    QCOMPARE(receiver.getHeadData()->getBlendshapeCoefficients().size(), NUM_BLENDSHAPES);
+
+    const auto& joints = receiver.getRawJointData();
+    QCOMPARE(joints.size(), NUM_JOINTS);
+    for (int i = 0; i < NUM_JOINTS; i++) {
+        QCOMPARE_QUATS(joints[i].rotation, sender.getRawJointData()[i].rotation, 0.001f);
+    }
+}
+
+const int NUM_REMOTE_AVATARS = 200;
+
+// What the main thread spent on each frame's avatar data for a crowd, before and after decoding moved off it:
+// parsing every avatar, against applying the decoded updates. Decoding them is what the decoder thread spends.
+void AvatarDataTests::benchmarkParseCrowd() {
+    QByteArray buffer = TestAvatar().encode();
+    std::vector<std::unique_ptr<AvatarData>> receivers;
+    for (int i = 0; i < NUM_REMOTE_AVATARS; i++) {
+        receivers.emplace_back(new AvatarData());
+    }
+
+    QBENCHMARK {
+        for (auto& receiver : receivers) {
+            receiver->parseDataFromBuffer(buffer);
+        }
+    }
+}
+
+void AvatarDataTests::benchmarkDecodeCrowd() {
+    QByteArray buffer = TestAvatar().encode();
+    std::vector<DecodedAvatarData> decoded(NUM_REMOTE_AVATARS);
+
+    QBENCHMARK {
+        for (auto& data : decoded) {
+            AvatarData::decodeDataFromBuffer(buffer, data);
+        }
+    }
+}
+
+void AvatarDataTests::benchmarkApplyCrowd() {
+    QByteArray buffer = TestAvatar().encode();
+    DecodedAvatarData decoded;
+    AvatarData::decodeDataFromBuffer(buffer, decoded);
+    std::vector<std::unique_ptr<AvatarData>> receivers;
+    for (int i = 0; i < NUM_REMOTE_AVATARS; i++) {
+        receivers.emplace_back(new AvatarData());
+    }
+
+    QBENCHMARK {
+        for (auto& receiver : receivers) {
+            receiver->applyDecodedData(decoded);
+        }
+    }
+}
@@ -0,0 +1,193 @@
+//
+//  AvatarPacketDecoderTests.cpp
+//  tests/avatars/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AvatarPacketDecoderTests.h"
+
+#include <AccountManager.h>
+#include <AddressManager.h>
+#include <AvatarHashMap.h>
+#include <AvatarPacketDecoder.h>
+#include <NodeList.h>
+
+#include <../GLMTestUtils.h>
+#include <../QTestExtensions.h>
+
+QTEST_MAIN(AvatarPacketDecoderTests)
+
+// an avatar standing somewhere, as the mixer sends it
+class TestAvatar : public AvatarData {
+public:
+    TestAvatar(const glm::vec3& position) { _globalPosition = position; }
+
+    QByteArray encode() const {
+        AvatarDataPacket::HasFlags hasFlags;
+        return toByteArray(SendAllData, 0, QVector<JointData>(), hasFlags, false, false, glm::vec3(0.0f), nullptr);
+    }
+};
+
+// decodes on the test's thread, when a packet is received
+class TestAvatarHashMap : public AvatarHashMap {
+public:
+    TestAvatarHashMap() { startDecodingThread(false); }
+    ~TestAvatarHashMap() {}
+
+    void receive(QSharedPointer<ReceivedMessage> message, SharedNodePointer mixer) {
+        getPacketDecoder()->queueReceivedPacket(message, mixer);
+        getPacketDecoder()->threadRoutine();
+    }
+
+    using AvatarHashMap::applyDecodedAvatarData;
+    using AvatarHashMap::discardDecodedAvatarData;
+};
+
+static QSharedPointer<ReceivedMessage> makeAvatarDataMessage(const QUuid& sessionUUID, const glm::vec3& position) {
+    auto packet = NLPacket::create(PacketType::BulkAvatarData);
+    packet->write(sessionUUID.toRfc4122());
+    packet->write(TestAvatar(position).encode());
+    packet->seek(0);
+    return QSharedPointer<ReceivedMessage>::create(*packet);
+}
+
+static QSharedPointer<ReceivedMessage> makeKillAvatarMessage(const QUuid& sessionUUID, KillAvatarReason reason) {
+    auto packet = NLPacket::create(PacketType::KillAvatar, NUM_BYTES_RFC4122_UUID + sizeof(KillAvatarReason));
+    packet->write(sessionUUID.toRfc4122());
+    packet->writePrimitive(reason);
+    packet->seek(0);
+    return QSharedPointer<ReceivedMessage>::create(*packet);
+}
+
+static SharedNodePointer makeMixer() {
+    return SharedNodePointer(new Node(QUuid::createUuid(), NodeType::AvatarMixer, HifiSockAddr(), HifiSockAddr(),
+                                      NodePermissions()));
+}
+
+void AvatarPacketDecoderTests::initTestCase() {
+    DependencyManager::set<AccountManager>();
+    DependencyManager::set<AddressManager>();
+    DependencyManager::set<NodeList>(NodeType::Agent);
+}
+
+void AvatarPacketDecoderTests::testUpdateOrder() {
+    AvatarPacketDecoder decoder;
+    decoder.initialize(false);
+    SharedNodePointer mixer = makeMixer();
+    QUuid first = QUuid::createUuid();
+    QUuid second = QUuid::createUuid();
+
+    // kills are queued with the updates, in the order they arrived
+    decoder.queueReceivedPacket(makeAvatarDataMessage(first, glm::vec3(1.0f)), mixer);
+    decoder.queueReceivedPacket(makeKillAvatarMessage(first, KillAvatarReason::AvatarDisconnected), mixer);
+    decoder.queueReceivedPacket(makeAvatarDataMessage(second, glm::vec3(2.0f)), mixer);
+    decoder.threadRoutine();
+
+    AvatarPacketDecoder::Updates updates;
+    decoder.takeUpdates(updates);
+    QCOMPARE((int)updates.size(), 3);
+
+    QCOMPARE(updates[0].sessionUUID, first);
+    QVERIFY(updates[0].data != nullptr);
+    QCOMPARE_WITH_ABS_ERROR(updates[0].data->globalPosition, glm::vec3(1.0f), EPSILON);
+    QVERIFY(updates[0].mixer.toStrongRef() == mixer);
+
+    QCOMPARE(updates[1].sessionUUID, first);
+    QVERIFY(updates[1].data == nullptr);
+    QCOMPARE(updates[1].killReason, KillAvatarReason::AvatarDisconnected);
+
+    QCOMPARE(updates[2].sessionUUID, second);
+    QVERIFY(updates[2].data != nullptr);
+    QCOMPARE_WITH_ABS_ERROR(updates[2].data->globalPosition, glm::vec3(2.0f), EPSILON);
+
+    // taken updates are gone
+    AvatarPacketDecoder::Updates more;
+    decoder.takeUpdates(more);
+    QVERIFY(more.empty());
+
+    decoder.recycle(updates);
+}
+
+void AvatarPacketDecoderTests::testRecycle() {
+    AvatarPacketDecoder decoder;
+    decoder.initialize(false);
+    SharedNodePointer mixer = makeMixer();
+    QUuid sessionUUID = QUuid::createUuid();
+
+    decoder.queueReceivedPacket(makeAvatarDataMessage(sessionUUID, glm::vec3(1.0f)), mixer);
+    decoder.threadRoutine();
+    AvatarPacketDecoder::Updates updates;
+    decoder.takeUpdates(updates);
+    QCOMPARE((int)updates.size(), 1);
+    const DecodedAvatarData* firstData = updates[0].data.get();
+
+    decoder.recycle(updates);
+    QVERIFY(updates.empty());
+
+    // the next avatar is decoded into the recycled data, with nothing left over from the last one
+    decoder.queueReceivedPacket(makeAvatarDataMessage(sessionUUID, glm::vec3(3.0f)), mixer);
+    decoder.threadRoutine();
+    decoder.takeUpdates(updates);
+    QCOMPARE((int)updates.size(), 1);
+    QVERIFY(updates[0].data.get() == firstData);
+    QCOMPARE_WITH_ABS_ERROR(updates[0].data->globalPosition, glm::vec3(3.0f), EPSILON);
+    QVERIFY(updates[0].data->error.isEmpty());
+
+    decoder.recycle(updates);
+}
+
+void AvatarPacketDecoderTests::testApplyKillAfterUpdate() {
+    TestAvatarHashMap avatars;
+    SharedNodePointer mixer = makeMixer();
+    QUuid sessionUUID = QUuid::createUuid();
+
+    // an update decoded before the kill doesn't bring the avatar back
+    avatars.receive(makeAvatarDataMessage(sessionUUID, glm::vec3(1.0f)), mixer);
+    avatars.receive(makeKillAvatarMessage(sessionUUID, KillAvatarReason::AvatarDisconnected), mixer);
+    avatars.applyDecodedAvatarData();
+    QVERIFY(avatars.getAvatarBySessionID(sessionUUID) == nullptr);
+    QCOMPARE(avatars.size(), 0);
+}
+
+void AvatarPacketDecoderTests::testApplyUpdateAfterKill() {
+    TestAvatarHashMap avatars;
+    SharedNodePointer mixer = makeMixer();
+    QUuid sessionUUID = QUuid::createUuid();
+
+    avatars.receive(makeAvatarDataMessage(sessionUUID, glm::vec3(1.0f)), mixer);
+    avatars.applyDecodedAvatarData();
+    QVERIFY(avatars.getAvatarBySessionID(sessionUUID) != nullptr);
+
+    // a kill followed by an update, e.g. the avatar left and came back, leaves a new avatar with the update
+    avatars.receive(makeKillAvatarMessage(sessionUUID, KillAvatarReason::NoReason), mixer);
+    avatars.receive(makeAvatarDataMessage(sessionUUID, glm::vec3(2.0f)), mixer);
+    avatars.applyDecodedAvatarData();
+    auto avatar = avatars.getAvatarBySessionID(sessionUUID);
+    QVERIFY(avatar != nullptr);
+    QCOMPARE_WITH_ABS_ERROR(avatar->getClientGlobalPosition(), glm::vec3(2.0f), EPSILON);
+    QCOMPARE(avatars.size(), 1);
+}
+
+void AvatarPacketDecoderTests::testDiscard() {
+    TestAvatarHashMap avatars;
+    SharedNodePointer mixer = makeMixer();
+    QUuid sessionUUID = QUuid::createUuid();
+
+    avatars.receive(makeAvatarDataMessage(sessionUUID, glm::vec3(1.0f)), mixer);
+    avatars.applyDecodedAvatarData();
+    QVERIFY(avatars.getAvatarBySessionID(sessionUUID) != nullptr);
+
+    // discarded updates are never applied, later ones are
+    avatars.receive(makeAvatarDataMessage(sessionUUID, glm::vec3(2.0f)), mixer);
+    avatars.discardDecodedAvatarData();
+    avatars.applyDecodedAvatarData();
+    QCOMPARE_WITH_ABS_ERROR(avatars.getAvatarBySessionID(sessionUUID)->getClientGlobalPosition(), glm::vec3(1.0f), EPSILON);
+
+    avatars.receive(makeAvatarDataMessage(sessionUUID, glm::vec3(3.0f)), mixer);
+    avatars.applyDecodedAvatarData();
+    QCOMPARE_WITH_ABS_ERROR(avatars.getAvatarBySessionID(sessionUUID)->getClientGlobalPosition(), glm::vec3(3.0f), EPSILON);
+}
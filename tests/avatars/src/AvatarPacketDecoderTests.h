@@ -0,0 +1,27 @@
+//
+//  AvatarPacketDecoderTests.h
+//  tests/avatars/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AvatarPacketDecoderTests_h
+#define hifi_AvatarPacketDecoderTests_h
+
+#include <QtTest/QtTest>
+
+class AvatarPacketDecoderTests : public QObject {
+    Q_OBJECT
+private slots:
+    void initTestCase();
+    void testUpdateOrder();
+    void testRecycle();
+    void testApplyKillAfterUpdate();
+    void testApplyUpdateAfterKill();
+    void testDiscard();
+};
+
+#endif // hifi_AvatarPacketDecoderTests_h
@@ -0,0 +1,300 @@
+//
+//  TextureProcessingTests.cpp
+//  tests/model/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "TextureProcessingTests.h"
+
+#include <vector>
+
+#include <QImage>
+
+#include <CPUDetect.h>
+#include <model/TextureProcessing.h>
+
+QTEST_MAIN(TextureProcessingTests)
+
+using namespace model::image;
+
+using DownsampleRow = void(*)(const uint8_t*, const uint8_t*, int, uint8_t*, int, int);
+using SobelRow = void(*)(const float*, const float*, const float*, int, uint8_t*, uint8_t*, uint8_t*);
+
+// odd and even widths, shorter and longer than the SIMD blocks
+static const std::vector<int> TEST_WIDTHS { 1, 2, 3, 7, 8, 15, 16, 33, 64, 67, 255 };
+static const int BENCHMARK_SIZE = 4096;
+
+static std::vector<uint8_t> randomBytes(size_t size) {
+    std::vector<uint8_t> result(size);
+    for (auto& value : result) {
+        value = (uint8_t)(qrand() & 0xff);
+    }
+    return result;
+}
+
+static void compareDownsampleRow(DownsampleRow f, const char* name) {
+    for (int numChannels : { 1, 3, 4 }) {
+        for (int srcWidth : TEST_WIDTHS) {
+            auto row0 = randomBytes(srcWidth * numChannels);
+            auto row1 = randomBytes(srcWidth * numChannels);
+            int dstWidth = std::max(srcWidth / 2, 1);
+            std::vector<uint8_t> expected(dstWidth * numChannels);
+            std::vector<uint8_t> actual(dstWidth * numChannels);
+
+            ref::downsampleRow(row0.data(), row1.data(), srcWidth, expected.data(), dstWidth, numChannels);
+            f(row0.data(), row1.data(), srcWidth, actual.data(), dstWidth, numChannels);
+            QVERIFY2(expected == actual, name);
+        }
+    }
+}
+
+void TextureProcessingTests::testDownsample() {
+    // constant images are preserved
+    for (int value : { 0, 1, 128, 255 }) {
+        std::vector<uint8_t> src(5 * 3 * 4, (uint8_t)value);
+        std::vector<uint8_t> dst(2 * 1 * 4);
+        downsample2x2(src.data(), 5, 3, 5 * 4, dst.data(), 2 * 4, 4);
+        for (auto texel : dst) {
+            QCOMPARE((int)texel, value);
+        }
+    }
+
+    // rounding
+    const uint8_t src[] = { 0, 1, 1, 1 };
+    uint8_t dst = 0;
+    downsample2x2(src, 2, 2, 2, &dst, 1, 1);
+    QCOMPARE((int)dst, 1);
+
+#ifdef ARCH_X86
+    compareDownsampleRow(sse::downsampleRow, "SSE");
+    if (cpuSupportsAVX2()) {
+        compareDownsampleRow(avx2::downsampleRow, "AVX2");
+    }
+#endif
+}
+
+void TextureProcessingTests::testDownsampleSRGB() {
+    // sRGB 0 and 255 averaged in linear space is brighter than the sRGB average, alpha stays linear
+    const uint8_t src[] = { 0, 0, 0, 0,  255, 255, 255, 255 };
+    uint8_t dst[4];
+    downsample2x2SRGB(src, 2, 1, 8, dst, 4);
+    QCOMPARE((int)dst[0], 188);
+    QCOMPARE((int)dst[3], 128);
+
+#ifdef ARCH_X86
+    if (cpuSupportsAVX2()) {
+        for (int srcWidth : TEST_WIDTHS) {
+            auto row0 = randomBytes(srcWidth * 4);
+            auto row1 = randomBytes(srcWidth * 4);
+            int dstWidth = std::max(srcWidth / 2, 1);
+            std::vector<uint8_t> expected(dstWidth * 4);
+            std::vector<uint8_t> actual(dstWidth * 4);
+
+            ref::downsampleRowSRGB(row0.data(), row1.data(), srcWidth, expected.data(), dstWidth);
+            avx2::downsampleRowSRGB(row0.data(), row1.data(), srcWidth, actual.data(), dstWidth);
+            for (size_t i = 0; i < expected.size(); i++) {
+                // FMA contraction may round the table index differently
+                QVERIFY(abs(expected[i] - actual[i]) <= 1);
+            }
+        }
+    }
+#endif
+}
+
+static void compareSobelRow(SobelRow f) {
+    for (int width : TEST_WIDTHS) {
+        std::vector<float> rows[3];
+        for (auto& row : rows) {
+            for (auto value : randomBytes(width + 2)) {
+                row.push_back((float)value);
+            }
+        }
+        std::vector<uint8_t> expected(3 * width);
+        std::vector<uint8_t> actual(3 * width);
+
+        ref::sobelRow(&rows[0][1], &rows[1][1], &rows[2][1], width, &expected[0], &expected[width], &expected[2 * width]);
+        f(&rows[0][1], &rows[1][1], &rows[2][1], width, &actual[0], &actual[width], &actual[2 * width]);
+        for (size_t i = 0; i < expected.size(); i++) {
+            QVERIFY(abs(expected[i] - actual[i]) <= 1);
+        }
+    }
+}
+
+void TextureProcessingTests::testBumpToNormal() {
+    // a flat height map points straight up
+    const int SIZE = 9;
+    std::vector<uint8_t> flat(SIZE * SIZE, 100);
+    std::vector<uint8_t> normals(SIZE * SIZE * 3);
+    bumpToNormal(flat.data(), SIZE, SIZE, SIZE, 1, normals.data(), SIZE * 3);
+    for (int i = 0; i < SIZE * SIZE; i++) {
+        QCOMPARE((int)normals[3 * i + 0], 127);
+        QCOMPARE((int)normals[3 * i + 1], 127);
+        QCOMPARE((int)normals[3 * i + 2], 255);
+    }
+
+    // height rising 20 a pixel: the Sobel gradient is 160 against a z of 127.5, so the normal is
+    // (-160, 0, 127.5) / 204.6 downhill, or 27 and 206 once mapped to bytes
+    const int CENTER = (SIZE / 2) * SIZE + SIZE / 2;
+    std::vector<uint8_t> ramp(SIZE * SIZE);
+    for (int y = 0; y < SIZE; y++) {
+        for (int x = 0; x < SIZE; x++) {
+            ramp[y * SIZE + x] = (uint8_t)(x * 20);
+        }
+    }
+    bumpToNormal(ramp.data(), SIZE, SIZE, SIZE, 1, normals.data(), SIZE * 3);
+    QCOMPARE((int)normals[3 * CENTER + 0], 27);
+    QCOMPARE((int)normals[3 * CENTER + 1], 127);
+    QCOMPARE((int)normals[3 * CENTER + 2], 206);
+
+    // the same ramp down the image tilts it up the image
+    for (int y = 0; y < SIZE; y++) {
+        for (int x = 0; x < SIZE; x++) {
+            ramp[y * SIZE + x] = (uint8_t)(y * 20);
+        }
+    }
+    bumpToNormal(ramp.data(), SIZE, SIZE, SIZE, 1, normals.data(), SIZE * 3);
+    QCOMPARE((int)normals[3 * CENTER + 0], 127);
+    QCOMPARE((int)normals[3 * CENTER + 1], 27);
+    QCOMPARE((int)normals[3 * CENTER + 2], 206);
+
+#ifdef ARCH_X86
+    compareSobelRow(sse::sobelRow);
+    if (cpuSupportsAVX2()) {
+        compareSobelRow(avx2::sobelRow);
+    }
+#endif
+}
+
+void TextureProcessingTests::testInvert() {
+    for (size_t size : { 1, 15, 16, 17, 100 }) {
+        auto expected = randomBytes(size);
+        auto actual = expected;
+        ref::invert(expected.data(), expected.size());
+        invert(actual.data(), actual.size());
+        QVERIFY(expected == actual);
+        invert(actual.data(), actual.size());
+        QCOMPARE((int)actual[0], 255 - expected[0]);
+    }
+}
+
+void TextureProcessingTests::testDownsampleImage() {
+    QImage image(67, 1, QImage::Format_ARGB32);
+    image.fill(Qt::red);
+
+    QImage mip = downsampleImage(image, true);
+    QCOMPARE(mip.size(), QSize(33, 1));
+    QCOMPARE(mip.format(), QImage::Format_ARGB32);
+    QCOMPARE(mip.pixel(32, 0), image.pixel(0, 0));
+
+    mip = downsampleImage(image.convertToFormat(QImage::Format_Grayscale8), false);
+    QCOMPARE(mip.size(), QSize(33, 1));
+
+    // unsupported formats are left to the caller
+    QVERIFY(downsampleImage(image.convertToFormat(QImage::Format_RGB16), false).isNull());
+}
+
+enum MipVariant {
+    QIMAGE_SMOOTH,
+    REFERENCE,
+    SSE2,
+    AVX2,
+    DISPATCH,
+};
+
+static void addVariants() {
+    QTest::addColumn<int>("variant");
+    QTest::newRow("QImage::scaled") << (int)QIMAGE_SMOOTH;
+    QTest::newRow("reference") << (int)REFERENCE;
+#ifdef ARCH_X86
+    QTest::newRow("SSE2") << (int)SSE2;
+    if (cpuSupportsAVX2()) {
+        QTest::newRow("AVX2") << (int)AVX2;
+    }
+#endif
+    QTest::newRow("dispatch") << (int)DISPATCH;
+}
+
+void TextureProcessingTests::benchmarkMipChain_data() {
+    addVariants();
+}
+
+// full mip chain of a 4K RGBA image, as generateMips does for linear color and normal maps
+void TextureProcessingTests::benchmarkMipChain() {
+    QFETCH(int, variant);
+
+    QImage image(BENCHMARK_SIZE, BENCHMARK_SIZE, QImage::Format_RGBA8888);
+    auto noise = randomBytes(image.byteCount());
+    memcpy(image.bits(), noise.data(), noise.size());
+
+    DownsampleRow f = ref::downsampleRow;
+#ifdef ARCH_X86
+    if (variant == SSE2) {
+        f = sse::downsampleRow;
+    } else if (variant == AVX2) {
+        f = avx2::downsampleRow;
+    }
+#endif
+
+    QBENCHMARK {
+        QImage mip = image;
+        while (mip.width() > 1 || mip.height() > 1) {
+            if (variant == QIMAGE_SMOOTH) {
+                QSize mipSize(std::max(mip.width() / 2, 1), std::max(mip.height() / 2, 1));
+                mip = image.scaled(mipSize, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+            } else if (variant == DISPATCH) {
+                mip = downsampleImage(mip, false);
+            } else {
+                QImage next(std::max(mip.width() / 2, 1), std::max(mip.height() / 2, 1), mip.format());
+                for (int y = 0; y < next.height(); y++) {
+                    const uint8_t* row0 = mip.constScanLine(std::min(2 * y, mip.height() - 1));
+                    const uint8_t* row1 = mip.constScanLine(std::min(2 * y + 1, mip.height() - 1));
+                    f(row0, row1, mip.width(), next.scanLine(y), next.width(), 4);
+                }
+                mip = next;
+            }
+        }
+    }
+}
+
+void TextureProcessingTests::benchmarkBumpToNormal_data() {
+    QTest::addColumn<int>("variant");
+    QTest::newRow("reference") << (int)REFERENCE;
+#ifdef ARCH_X86
+    QTest::newRow("SSE2") << (int)SSE2;
+    if (cpuSupportsAVX2()) {
+        QTest::newRow("AVX2") << (int)AVX2;
+    }
+#endif
+}
+
+void TextureProcessingTests::benchmarkBumpToNormal() {
+    QFETCH(int, variant);
+
+    std::vector<float> rows[3];
+    for (auto& row : rows) {
+        for (auto value : randomBytes(BENCHMARK_SIZE + 2)) {
+            row.push_back((float)value);
+        }
+    }
+    std::vector<uint8_t> normals(3 * BENCHMARK_SIZE);
+
+    SobelRow f = ref::sobelRow;
+#ifdef ARCH_X86
+    if (variant == SSE2) {
+        f = sse::sobelRow;
+    } else if (variant == AVX2) {
+        f = avx2::sobelRow;
+    }
+#endif
+
+    QBENCHMARK {
+        for (int y = 0; y < BENCHMARK_SIZE; y++) {
+            f(&rows[y % 3][1], &rows[(y + 1) % 3][1], &rows[(y + 2) % 3][1], BENCHMARK_SIZE,
+              &normals[0], &normals[BENCHMARK_SIZE], &normals[2 * BENCHMARK_SIZE]);
+        }
+    }
+}
@@ -0,0 +1,33 @@
+//
+//  TextureProcessingTests.h
+//  tests/model/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_TextureProcessingTests_h
+#define hifi_TextureProcessingTests_h
+
+#include <QtTest/QtTest>
+
+class TextureProcessingTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testDownsample();
+    void testDownsampleSRGB();
+    void testBumpToNormal();
+    void testInvert();
+    void testDownsampleImage();
+
+    // throughput on 4K images
+    void benchmarkMipChain_data();
+    void benchmarkMipChain();
+    void benchmarkBumpToNormal_data();
+    void benchmarkBumpToNormal();
+};
+
+#endif // hifi_TextureProcessingTests_h
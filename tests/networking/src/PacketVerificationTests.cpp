@@ -0,0 +1,103 @@
+//
+//  PacketVerificationTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "PacketVerificationTests.h"
+
+#include <NLPacket.h>
+#include <SipHash.h>
+
+QTEST_MAIN(PacketVerificationTests)
+
+Q_DECLARE_METATYPE(PacketVerificationScheme)
+
+static std::unique_ptr<NLPacket> createSignedPacket(int payloadSize, const QUuid& sourceID, const QUuid& connectionSecret,
+                                                    PacketVerificationScheme scheme = PACKET_VERIFICATION_SCHEME) {
+    auto packet = NLPacket::create(PacketType::AvatarData);
+    QByteArray payload(payloadSize, 0);
+    for (int i = 0; i < payloadSize; ++i) {
+        payload[i] = (char)(i * 31);
+    }
+    packet->write(payload);
+    packet->writeSourceID(sourceID);
+
+    int offset = udt::Packet::totalHeaderSize(false) + sizeof(PacketType) + sizeof(PacketVersion) + NUM_BYTES_RFC4122_UUID;
+    NLPacket::hashForPacketAndSecret(*packet, connectionSecret, const_cast<char*>(packet->getData()) + offset, scheme);
+    return packet;
+}
+
+void PacketVerificationTests::sipHashVectorsTest() {
+    // from the SipHash reference implementation, key 00 01 .. 0f and message 00 01 .. (length - 1)
+    uint8_t key[NUM_BYTES_SIPHASH_KEY];
+    for (int i = 0; i < NUM_BYTES_SIPHASH_KEY; ++i) {
+        key[i] = (uint8_t)i;
+    }
+    uint8_t message[1] = { 0 };
+    uint8_t hash[NUM_BYTES_SIPHASH_128];
+
+    sipHash128(key, message, 0, hash);
+    QCOMPARE(QByteArray((const char*)hash, NUM_BYTES_SIPHASH_128).toHex(), QByteArray("a3817f04ba25a8e66df67214c7550293"));
+
+    sipHash128(key, message, 1, hash);
+    QCOMPARE(QByteArray((const char*)hash, NUM_BYTES_SIPHASH_128).toHex(), QByteArray("da87c1d86b99af44347659119b22fc45"));
+}
+
+void PacketVerificationTests::verifyTest() {
+    QUuid sourceID = QUuid::createUuid();
+    QUuid connectionSecret = QUuid::createUuid();
+
+    auto packet = NLPacket::create(PacketType::AvatarData);
+    packet->write("somedata");
+    packet->writeSourceID(sourceID);
+    packet->writeVerificationHashGivenSecret(connectionSecret);
+
+    QVERIFY(NLPacket::verifyHashForPacketAndSecret(*packet, connectionSecret));
+    QVERIFY(!NLPacket::verifyHashForPacketAndSecret(*packet, QUuid::createUuid()));
+
+    // the legacy scheme still round trips
+    auto md5Packet = createSignedPacket(100, sourceID, connectionSecret, PacketVerificationScheme::MD5);
+    QVERIFY(NLPacket::verifyHashForPacketAndSecret(*md5Packet, connectionSecret, PacketVerificationScheme::MD5));
+    QVERIFY(!NLPacket::verifyHashForPacketAndSecret(*md5Packet, connectionSecret, PacketVerificationScheme::SipHash));
+}
+
+void PacketVerificationTests::tamperTest() {
+    QUuid connectionSecret = QUuid::createUuid();
+    auto packet = createSignedPacket(100, QUuid::createUuid(), connectionSecret);
+    QVERIFY(NLPacket::verifyHashForPacketAndSecret(*packet, connectionSecret));
+
+    // flipping any payload bit breaks the hash
+    char* lastByte = const_cast<char*>(packet->getData()) + packet->getDataSize() - 1;
+    *lastByte ^= 1;
+    QVERIFY(!NLPacket::verifyHashForPacketAndSecret(*packet, connectionSecret));
+}
+
+void PacketVerificationTests::benchmarkVerify_data() {
+    QTest::addColumn<PacketVerificationScheme>("scheme");
+    QTest::addColumn<int>("payloadSize");
+
+    // an audio frame, an avatar data packet and a full packet
+    for (int payloadSize : { 100, 500, 1400 }) {
+        QTest::newRow(qPrintable(QString("MD5 %1 bytes").arg(payloadSize))) << PacketVerificationScheme::MD5 << payloadSize;
+        QTest::newRow(qPrintable(QString("SipHash %1 bytes").arg(payloadSize))) << PacketVerificationScheme::SipHash << payloadSize;
+    }
+}
+
+void PacketVerificationTests::benchmarkVerify() {
+    QFETCH(PacketVerificationScheme, scheme);
+    QFETCH(int, payloadSize);
+
+    QUuid connectionSecret = QUuid::createUuid();
+    auto packet = createSignedPacket(payloadSize, QUuid::createUuid(), connectionSecret, scheme);
+
+    bool isVerified = true;
+    QBENCHMARK {
+        isVerified &= NLPacket::verifyHashForPacketAndSecret(*packet, connectionSecret, scheme);
+    }
+    QVERIFY(isVerified);
+}
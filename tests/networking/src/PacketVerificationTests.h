@@ -0,0 +1,30 @@
+//
+//  PacketVerificationTests.h
+//  tests/networking/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_PacketVerificationTests_h
+#define hifi_PacketVerificationTests_h
+
+#pragma once
+
+#include <QtTest/QtTest>
+
+class PacketVerificationTests : public QObject {
+    Q_OBJECT
+private slots:
+    void sipHashVectorsTest();
+    void verifyTest();
+    void tamperTest();
+
+    // verifications of one inbound packet, for each scheme and payload size
+    void benchmarkVerify_data();
+    void benchmarkVerify();
+};
+
+#endif // hifi_PacketVerificationTests_h
@@ -0,0 +1,189 @@
+//
+//  PhysicsEngineTests.cpp
+//  tests/physics/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "PhysicsEngineTests.h"
+
+#include <memory>
+
+#include <BulletUtil.h>
+#include <PhysicsCollisionGroups.h>
+#include <PhysicsEngine.h>
+#include <PhysicsHelpers.h>
+#include <ShapeManager.h>
+
+QTEST_MAIN(PhysicsEngineTests)
+
+static ShapeManager shapeManager;
+
+// a box or the floor, without any entity behind it
+class TestMotionState : public ObjectMotionState {
+public:
+    TestMotionState(const btCollisionShape* shape, const glm::vec3& position, PhysicsMotionType motionType) :
+        ObjectMotionState(shape), _requestedType(motionType), _id(QUuid::createUuid()) {
+        _transform.setIdentity();
+        _transform.setOrigin(glmToBullet(position));
+        setMass(motionType == MOTION_TYPE_DYNAMIC ? 1.0f : 0.0f);
+    }
+
+    uint32_t getIncomingDirtyFlags() override { return 0; }
+    void clearIncomingDirtyFlags() override {}
+    PhysicsMotionType computePhysicsMotionType() const override { return _requestedType; }
+    bool isMoving() const override { return _requestedType == MOTION_TYPE_DYNAMIC; }
+
+    float getObjectRestitution() const override { return 0.1f; }
+    float getObjectFriction() const override { return 0.5f; }
+    float getObjectLinearDamping() const override { return 0.0f; }
+    float getObjectAngularDamping() const override { return 0.0f; }
+
+    glm::vec3 getObjectPosition() const override { return bulletToGLM(_transform.getOrigin()); }
+    glm::quat getObjectRotation() const override { return bulletToGLM(_transform.getRotation()); }
+    glm::vec3 getObjectLinearVelocity() const override { return glm::vec3(0.0f); }
+    glm::vec3 getObjectAngularVelocity() const override { return glm::vec3(0.0f); }
+    glm::vec3 getObjectGravity() const override { return glm::vec3(0.0f, -9.8f, 0.0f); }
+
+    const QUuid getObjectID() const override { return _id; }
+    QUuid getSimulatorID() const override { return QUuid(); }
+
+    void computeCollisionGroupAndMask(int16_t& group, int16_t& mask) const override {
+        group = (_requestedType == MOTION_TYPE_DYNAMIC) ? BULLET_COLLISION_GROUP_DYNAMIC : BULLET_COLLISION_GROUP_STATIC;
+        mask = (_requestedType == MOTION_TYPE_DYNAMIC) ? BULLET_COLLISION_MASK_DYNAMIC : BULLET_COLLISION_MASK_STATIC;
+    }
+
+    void getWorldTransform(btTransform& worldTrans) const override { worldTrans = _transform; }
+    void setWorldTransform(const btTransform& worldTrans) override { _transform = worldTrans; }
+
+protected:
+    bool isReadyToComputeShape() const override { return true; }
+    const btCollisionShape* computeNewShape() override { return nullptr; }
+
+private:
+    PhysicsMotionType _requestedType;
+    QUuid _id;
+    btTransform _transform;
+};
+
+// stacks of boxes falling onto a static floor, each stack is its own simulation island once it settles
+class TestScene {
+public:
+    TestScene(int numStacks, int stackHeight, int numSolverThreads) : _engine(glm::vec3(0.0f)) {
+        _engine.init();
+        _engine.setNumSolverThreads(numSolverThreads);
+
+        ShapeInfo floorInfo;
+        floorInfo.setBox(glm::vec3(200.0f, 0.5f, 200.0f));
+        _objects.push_back(new TestMotionState(shapeManager.getShape(floorInfo), glm::vec3(0.0f, -0.5f, 0.0f), MOTION_TYPE_STATIC));
+
+        ShapeInfo boxInfo;
+        boxInfo.setBox(glm::vec3(0.25f));
+        int stacksPerRow = (int)ceilf(sqrtf((float)numStacks));
+        const float STACK_SPACING = 1.0f;
+        for (int i = 0; i < numStacks; ++i) {
+            float x = STACK_SPACING * (float)(i % stacksPerRow - stacksPerRow / 2);
+            float z = STACK_SPACING * (float)(i / stacksPerRow - stacksPerRow / 2);
+            for (int j = 0; j < stackHeight; ++j) {
+                glm::vec3 position(x, 0.25f + 0.55f * (float)j, z);
+                _objects.push_back(new TestMotionState(shapeManager.getShape(boxInfo), position, MOTION_TYPE_DYNAMIC));
+            }
+        }
+        _engine.addObjects(_objects);
+    }
+
+    ~TestScene() {
+        _engine.removeObjects(_objects);
+        for (auto object : _objects) {
+            delete object;
+        }
+        shapeManager.collectGarbage();
+    }
+
+    void step(int numFrames) {
+        for (int i = 0; i < numFrames; ++i) {
+            _engine.stepSimulation(PHYSICS_ENGINE_FIXED_SUBSTEP);
+            _engine.getCollisionEvents();
+            _engine.getOutgoingChanges();
+        }
+    }
+
+    PhysicsEngine& getEngine() { return _engine; }
+    const VectorOfMotionStates& getObjects() const { return _objects; }
+
+private:
+    PhysicsEngine _engine;
+    VectorOfMotionStates _objects;
+};
+
+void PhysicsEngineTests::initTestCase() {
+    ObjectMotionState::setShapeManager(&shapeManager);
+}
+
+void PhysicsEngineTests::testContactMap() {
+    const int NUM_STACKS = 9;
+    const int STACK_HEIGHT = 3;
+    TestScene scene(NUM_STACKS, STACK_HEIGHT, 1);
+
+    // let the boxes land
+    const int NUM_FRAMES = 30;
+    scene.step(NUM_FRAMES);
+
+    // one contact between each box and the one below it (or the floor)
+    QCOMPARE(scene.getEngine().getNumContacts(), NUM_STACKS * STACK_HEIGHT);
+
+    // removing a box drops its contacts
+    VectorOfMotionStates removed;
+    removed.push_back(scene.getObjects().back());
+    scene.getEngine().removeObjects(removed);
+    QCOMPARE(scene.getEngine().getNumContacts(), NUM_STACKS * STACK_HEIGHT - 1);
+    scene.getEngine().addObjects(removed);
+}
+
+void PhysicsEngineTests::testParallelSolver() {
+    const int NUM_STACKS = 25;
+    const int STACK_HEIGHT = 4;
+    TestScene serial(NUM_STACKS, STACK_HEIGHT, 1);
+    TestScene parallel(NUM_STACKS, STACK_HEIGHT, 4);
+
+    // islands are independent, so solving them on different threads gives the same result
+    const int NUM_FRAMES = 90;
+    serial.step(NUM_FRAMES);
+    parallel.step(NUM_FRAMES);
+
+    QCOMPARE(parallel.getEngine().getNumContacts(), serial.getEngine().getNumContacts());
+    const float EPSILON = 1.0e-4f;
+    for (int i = 0; i < serial.getObjects().size(); ++i) {
+        glm::vec3 expected = serial.getObjects()[i]->getObjectPosition();
+        glm::vec3 actual = parallel.getObjects()[i]->getObjectPosition();
+        QVERIFY(glm::distance(expected, actual) < EPSILON);
+    }
+
+    // nothing fell through the floor
+    for (auto object : parallel.getObjects()) {
+        QVERIFY(object->getObjectPosition().y > 0.0f);
+    }
+}
+
+void PhysicsEngineTests::benchmarkDrop_data() {
+    QTest::addColumn<int>("numSolverThreads");
+    QTest::newRow("serial") << 1;
+    QTest::newRow("2 threads") << 2;
+    QTest::newRow("4 threads") << 4;
+}
+
+// a few thousand boxes dropped in stacks onto the floor, one frame per iteration
+void PhysicsEngineTests::benchmarkDrop() {
+    QFETCH(int, numSolverThreads);
+
+    const int NUM_STACKS = 625;
+    const int STACK_HEIGHT = 4;
+    TestScene scene(NUM_STACKS, STACK_HEIGHT, numSolverThreads);
+
+    QBENCHMARK {
+        scene.step(1);
+    }
+}
@@ -10,6 +10,11 @@
 //
 
 #include <iostream>
+
+#include <QTemporaryDir>
+
+#include <ShapeCache.h>
+#include <ShapeFactory.h>
 #include <ShapeManager.h>
 #include <StreamUtils.h>
 #include <Extents.h>
@@ -185,7 +190,7 @@ void ShapeManagerTests::addCapsuleShape() {
     */
 }
 
-void ShapeManagerTests::addCompoundShape() {
+static ShapeInfo makeCompoundShapeInfo(int numHulls) {
     // initialize some points for generating tetrahedral convex hulls
     QVector<glm::vec3> tetrahedron;
     tetrahedron.push_back(glm::vec3(1.0f, 1.0f, 1.0f));
@@ -196,7 +201,6 @@ void ShapeManagerTests::addCompoundShape() {
 
     // compute the points of the hulls
     ShapeInfo::PointCollection pointCollection;
-    int numHulls = 5;
     glm::vec3 offsetNormal(1.0f, 0.0f, 0.0f);
     Extents extents;
     for (int i = 0; i < numHulls; ++i) {
@@ -216,6 +220,12 @@ void ShapeManagerTests::addCompoundShape() {
     glm::vec3 halfExtents = 0.5f * (extents.maximum - extents.minimum);
     info.setParams(SHAPE_TYPE_COMPOUND, halfExtents);
     info.setPointCollection(pointCollection);
+    return info;
+}
+
+void ShapeManagerTests::addCompoundShape() {
+    int numHulls = 5;
+    ShapeInfo info = makeCompoundShapeInfo(numHulls);
 
     // create the shape
     ShapeManager shapeManager;
@@ -243,3 +253,202 @@ void ShapeManagerTests::addCompoundShape() {
     QCOMPARE(shapeManager.getNumShapes(), 0);
     QCOMPARE(shapeManager.getNumReferences(info), 0);
 }
+
+void ShapeManagerTests::addCompoundShapeAsync() {
+    int numHulls = 5;
+    ShapeInfo info = makeCompoundShapeInfo(numHulls);
+    ShapeManager shapeManager;
+
+    // hulls are built on a worker thread
+    const btCollisionShape* shape = shapeManager.getShapeAsync(info);
+    QVERIFY(shape == nullptr);
+    QCOMPARE(shapeManager.getNumPendingShapes(), 1);
+    QCOMPARE(shapeManager.getNumShapes(), 0);
+
+    // asking again while the job is running doesn't start another one
+    const int MAX_POLLS = 1000;
+    for (int i = 0; i < MAX_POLLS && !shape; ++i) {
+        shape = shapeManager.getShapeAsync(info);
+        if (!shape) {
+            QCOMPARE(shapeManager.getNumPendingShapes(), 1);
+            QTest::qSleep(1);
+        }
+    }
+    QVERIFY(shape != nullptr);
+    QCOMPARE(shape->getShapeType(), (int)COMPOUND_SHAPE_PROXYTYPE);
+    QCOMPARE(static_cast<const btCompoundShape*>(shape)->getNumChildShapes(), numHulls);
+    QCOMPARE(shapeManager.getNumPendingShapes(), 0);
+    QCOMPARE(shapeManager.getNumReferences(info), 1);
+    QCOMPARE(shapeManager.getNumShapesBuilt(), (uint32_t)1);
+
+    // once built, the shape is shared like any other
+    QCOMPARE(shapeManager.getShapeAsync(info), shape);
+    QCOMPARE(shapeManager.getNumReferences(info), 2);
+
+    // primitives are built immediately
+    ShapeInfo boxInfo;
+    boxInfo.setBox(glm::vec3(1.0f));
+    QVERIFY(shapeManager.getShapeAsync(boxInfo) != nullptr);
+
+    // a job that nobody claims is kept until the next collection after it finishes
+    ShapeInfo otherInfo = makeCompoundShapeInfo(numHulls + 1);
+    QVERIFY(shapeManager.getShapeAsync(otherInfo) == nullptr);
+    for (int i = 0; i < MAX_POLLS && shapeManager.getNumPendingShapes() > 0; ++i) {
+        QTest::qSleep(1);
+        shapeManager.collectGarbage();
+    }
+    QCOMPARE(shapeManager.getNumPendingShapes(), 0);
+    QCOMPARE(shapeManager.getNumReferences(otherInfo), 0);
+    QVERIFY(shapeManager.getShapeAsync(otherInfo) != nullptr);
+
+    // a mesh without enough points to make a triangle can't be built, and isn't built again
+    ShapeInfo::PointCollection badPoints;
+    badPoints.push_back(ShapeInfo::PointList { glm::vec3(0.0f), glm::vec3(1.0f) });
+    ShapeInfo badInfo;
+    badInfo.setParams(SHAPE_TYPE_STATIC_MESH, glm::vec3(1.0f));
+    badInfo.setPointCollection(badPoints);
+    uint32_t numBuilt = shapeManager.getNumShapesBuilt();
+    QVERIFY(shapeManager.getShapeAsync(badInfo) == nullptr);
+    QVERIFY(!shapeManager.hasFailedShape(badInfo));
+    for (int i = 0; i < MAX_POLLS && !shapeManager.hasFailedShape(badInfo); ++i) {
+        QTest::qSleep(1);
+        QVERIFY(shapeManager.getShapeAsync(badInfo) == nullptr);
+    }
+    QVERIFY(shapeManager.hasFailedShape(badInfo));
+    QCOMPARE(shapeManager.getNumFailedShapes(), 1);
+    QCOMPARE(shapeManager.getNumPendingShapes(), 0);
+    QVERIFY(shapeManager.getShapeAsync(badInfo) == nullptr);
+    QCOMPARE(shapeManager.getNumPendingShapes(), 0);
+    QCOMPARE(shapeManager.getNumShapesBuilt(), numBuilt + 1);
+}
+
+void ShapeManagerTests::testShapeCache() {
+    QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+
+    int numHulls = 3;
+    ShapeInfo info = makeCompoundShapeInfo(numHulls);
+    info.setOffset(glm::vec3(1.0f, 2.0f, 3.0f));
+
+    // the key covers the points, not just the extents
+    ShapeInfo otherInfo = makeCompoundShapeInfo(numHulls);
+    ShapeInfo::PointCollection otherPoints = otherInfo.getPointCollection();
+    otherPoints[0][0] *= 0.5f;
+    otherInfo.setPointCollection(otherPoints);
+    QVERIFY(ShapeCache::computeKey(info) != ShapeCache::computeKey(otherInfo));
+    QVERIFY(ShapeCache::isCacheable(info));
+
+    ShapeInfo boxInfo;
+    boxInfo.setBox(glm::vec3(1.0f));
+    QVERIFY(!ShapeCache::isCacheable(boxInfo));
+
+    ShapeCache cache(directory.path());
+    QByteArray key = ShapeCache::computeKey(info);
+    QVERIFY(cache.load(key) == nullptr);
+
+    const btCollisionShape* shape = ShapeFactory::createShapeFromInfo(info);
+    QVERIFY(cache.save(key, shape));
+    btCollisionShape* loaded = cache.load(key);
+    QVERIFY(loaded != nullptr);
+
+    // same hulls, margins and transforms
+    QCOMPARE(loaded->getShapeType(), (int)COMPOUND_SHAPE_PROXYTYPE);
+    auto compound = static_cast<const btCompoundShape*>(shape);
+    auto loadedCompound = static_cast<const btCompoundShape*>(loaded);
+    QCOMPARE(loadedCompound->getNumChildShapes(), numHulls);
+    for (int i = 0; i < numHulls; ++i) {
+        QVERIFY(loadedCompound->getChildTransform(i).getOrigin() == compound->getChildTransform(i).getOrigin());
+        auto hull = static_cast<const btConvexHullShape*>(compound->getChildShape(i));
+        auto loadedHull = static_cast<const btConvexHullShape*>(loadedCompound->getChildShape(i));
+        QCOMPARE(loadedHull->getMargin(), hull->getMargin());
+        QCOMPARE(loadedHull->getNumPoints(), hull->getNumPoints());
+        for (int j = 0; j < hull->getNumPoints(); ++j) {
+            QVERIFY(loadedHull->getUnscaledPoints()[j] == hull->getUnscaledPoints()[j]);
+        }
+    }
+    ShapeFactory::deleteShape(shape);
+    ShapeFactory::deleteShape(loaded);
+
+    // a manager with the same cache loads instead of building
+    ShapeManager shapeManager;
+    shapeManager.setCacheDirectory(directory.path());
+    QVERIFY(shapeManager.getShape(info) != nullptr);
+    QCOMPARE(shapeManager.getNumShapesBuilt(), (uint32_t)1);
+    QCOMPARE(shapeManager.getNumCacheHits(), (uint32_t)1);
+
+    // and fills the cache on a miss
+    QVERIFY(shapeManager.getShape(otherInfo) != nullptr);
+    QCOMPARE(shapeManager.getNumCacheHits(), (uint32_t)1);
+    loaded = cache.load(ShapeCache::computeKey(otherInfo));
+    QVERIFY(loaded != nullptr);
+    ShapeFactory::deleteShape(loaded);
+
+    // corrupt entries are ignored
+    QFile file(directory.path() + "/" + QString::fromLatin1(key));
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    file.write("garbage");
+    file.close();
+    QVERIFY(cache.load(key) == nullptr);
+}
+
+void ShapeManagerTests::testStaticMeshCache() {
+    QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+
+    // a grid of triangles
+    const int GRID_SIZE = 16;
+    ShapeInfo::PointCollection pointCollection;
+    ShapeInfo::PointList points;
+    for (int i = 0; i <= GRID_SIZE; ++i) {
+        for (int j = 0; j <= GRID_SIZE; ++j) {
+            points.push_back(glm::vec3((float)i, 0.1f * (float)((i * j) % 3), (float)j));
+        }
+    }
+    pointCollection.push_back(points);
+    ShapeInfo::TriangleIndices indices;
+    for (int i = 0; i < GRID_SIZE; ++i) {
+        for (int j = 0; j < GRID_SIZE; ++j) {
+            int32_t k = i * (GRID_SIZE + 1) + j;
+            indices << k << k + 1 << k + GRID_SIZE + 1;
+            indices << k + 1 << k + GRID_SIZE + 2 << k + GRID_SIZE + 1;
+        }
+    }
+    ShapeInfo info;
+    info.setParams(SHAPE_TYPE_STATIC_MESH, glm::vec3(0.5f * GRID_SIZE));
+    info.setPointCollection(pointCollection);
+    info.getTriangleIndices() = indices;
+
+    ShapeCache cache(directory.path());
+    QByteArray key = ShapeCache::computeKey(info);
+    const btCollisionShape* shape = ShapeFactory::createShapeFromInfo(info);
+    QVERIFY(shape != nullptr);
+    QVERIFY(cache.save(key, shape));
+    btCollisionShape* loaded = cache.load(key);
+    QVERIFY(loaded != nullptr);
+    QCOMPARE(loaded->getShapeType(), (int)TRIANGLE_MESH_SHAPE_PROXYTYPE);
+
+    // same bounds, and the loaded bvh finds the same triangles
+    btTransform identity;
+    identity.setIdentity();
+    btVector3 minCorner, maxCorner, loadedMin, loadedMax;
+    shape->getAabb(identity, minCorner, maxCorner);
+    loaded->getAabb(identity, loadedMin, loadedMax);
+    QVERIFY(minCorner == loadedMin);
+    QVERIFY(maxCorner == loadedMax);
+
+    class TriangleCounter : public btTriangleCallback {
+    public:
+        void processTriangle(btVector3* triangle, int partId, int triangleIndex) override { ++count; }
+        int count { 0 };
+    };
+    btVector3 queryMin(2.5f, -1.0f, 2.5f);
+    btVector3 queryMax(5.5f, 1.0f, 5.5f);
+    TriangleCounter expected, actual;
+    static_cast<const btBvhTriangleMeshShape*>(shape)->processAllTriangles(&expected, queryMin, queryMax);
+    static_cast<const btBvhTriangleMeshShape*>(loaded)->processAllTriangles(&actual, queryMin, queryMax);
+    QVERIFY(expected.count > 0);
+    QCOMPARE(actual.count, expected.count);
+
+    ShapeFactory::deleteShape(shape);
+    ShapeFactory::deleteShape(loaded);
+}
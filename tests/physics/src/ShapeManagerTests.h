@@ -25,6 +25,9 @@ private slots:
     void addCylinderShape();
     void addCapsuleShape();
     void addCompoundShape();
+    void addCompoundShapeAsync();
+    void testShapeCache();
+    void testStaticMeshCache();
 };
 
 #endif // hifi_ShapeManagerTests_h
@@ -0,0 +1,351 @@
+//
+//  main.cpp
+//  tests/render-null-perf/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+//  Runs the CPU side of the render engine (fetch, cull, sort and batch recording) against the null gpu
+//  backend, so render CPU regressions can be measured on a machine without a gpu.
+//
+//  usage: render-null-perf-test [--items 10000,100000,500000] [--frames 100]
+//
+
+#include <stdio.h>
+#include <random>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <QtCore/QCommandLineParser>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QHash>
+#include <QtCore/QVector>
+
+#include <gpu/Batch.h>
+#include <gpu/Context.h>
+#include <gpu/StandardShaderLib.h>
+#include <gpu/null/NullBackend.h>
+
+#include <GLMHelpers.h>
+#include <NumericalConstants.h>
+#include <OctreeConstants.h>
+#include <OctreeUtils.h>
+#include <ViewFrustum.h>
+
+#include <render/DrawTask.h>
+#include <render/Engine.h>
+#include <render/RenderFetchCullSortTask.h>
+#include <render/ShapePipeline.h>
+
+static const float SCENE_SIZE = 1000.0f;
+static const float MIN_ITEM_SIZE = 0.25f;
+static const float MAX_ITEM_SIZE = 5.0f;
+static const float TRANSPARENT_FRACTION = 0.1f;
+static const int DEFAULT_NUM_FRAMES = 100;
+
+// A synthetic shape: a box with one of a handful of pipelines, recorded like a model part would be
+class TestShape {
+public:
+    using Payload = render::Payload<TestShape>;
+    using Pointer = Payload::DataPointer;
+
+    TestShape(const AABox& bound, const render::ShapeKey& shapeKey, bool isTransparent) :
+        _bound(bound), _shapeKey(shapeKey), _isTransparent(isTransparent) {
+        _transform.setTranslation(bound.calcCenter());
+        _transform.setScale(bound.getScale());
+    }
+
+    AABox _bound;
+    Transform _transform;
+    render::ShapeKey _shapeKey;
+    bool _isTransparent;
+
+    // shared by all the shapes, like a mesh in the model cache
+    static gpu::Stream::FormatPointer _format;
+    static gpu::BufferView _vertices;
+    static gpu::BufferView _indices;
+    static const uint32_t NUM_INDICES = 36;
+};
+
+gpu::Stream::FormatPointer TestShape::_format;
+gpu::BufferView TestShape::_vertices;
+gpu::BufferView TestShape::_indices;
+
+namespace render {
+    template <> const ItemKey payloadGetKey(const TestShape::Pointer& shape) {
+        return shape->_isTransparent ? ItemKey::Builder::transparentShape().build() : ItemKey::Builder::opaqueShape().build();
+    }
+    template <> const Item::Bound payloadGetBound(const TestShape::Pointer& shape) {
+        return shape->_bound;
+    }
+    template <> const ShapeKey shapeGetShapeKey(const TestShape::Pointer& shape) {
+        return shape->_shapeKey;
+    }
+    template <> void payloadRender(const TestShape::Pointer& shape, RenderArgs* args) {
+        gpu::Batch& batch = *(args->_batch);
+        batch.setModelTransform(shape->_transform);
+        batch.setInputFormat(TestShape::_format);
+        batch.setInputBuffer(gpu::Stream::POSITION, TestShape::_vertices);
+        batch.setIndexBuffer(TestShape::_indices);
+        batch.drawIndexed(gpu::TRIANGLES, TestShape::NUM_INDICES);
+    }
+}
+
+static void initTestShapeGeometry() {
+    const glm::vec3 vertices[] = {
+        { -0.5f, -0.5f, -0.5f }, { 0.5f, -0.5f, -0.5f }, { 0.5f, 0.5f, -0.5f }, { -0.5f, 0.5f, -0.5f },
+        { -0.5f, -0.5f, 0.5f }, { 0.5f, -0.5f, 0.5f }, { 0.5f, 0.5f, 0.5f }, { -0.5f, 0.5f, 0.5f }
+    };
+    const uint16_t indices[TestShape::NUM_INDICES] = {
+        0, 2, 1, 0, 3, 2, 4, 5, 6, 4, 6, 7,
+        0, 1, 5, 0, 5, 4, 3, 6, 2, 3, 7, 6,
+        0, 4, 7, 0, 7, 3, 1, 2, 6, 1, 6, 5
+    };
+    auto vertexBuffer = std::make_shared<gpu::Buffer>(sizeof(vertices), (const gpu::Byte*)vertices);
+    auto indexBuffer = std::make_shared<gpu::Buffer>(sizeof(indices), (const gpu::Byte*)indices);
+    TestShape::_vertices = gpu::BufferView(vertexBuffer, gpu::Element(gpu::VEC3, gpu::FLOAT, gpu::XYZ));
+    TestShape::_indices = gpu::BufferView(indexBuffer, gpu::Element(gpu::SCALAR, gpu::UINT16, gpu::INDEX));
+    TestShape::_format = std::make_shared<gpu::Stream::Format>();
+    TestShape::_format->setAttribute(gpu::Stream::POSITION, gpu::Stream::POSITION, gpu::Element(gpu::VEC3, gpu::FLOAT, gpu::XYZ));
+}
+
+// the pipeline variations the synthetic shapes are spread across
+static const std::vector<render::ShapeKey>& getTestShapeKeys() {
+    using Builder = render::ShapeKey::Builder;
+    static const std::vector<render::ShapeKey> keys = {
+        Builder().build(),
+        Builder().withTangents().build(),
+        Builder().withSpecular().build(),
+        Builder().withTangents().withSpecular().build(),
+        Builder().withLightmap().build(),
+        Builder().withUnlit().build(),
+        Builder().withSkinned().build(),
+        Builder().withSkinned().withTangents().build()
+    };
+    return keys;
+}
+
+static render::ShapePlumberPointer createShapePlumber() {
+    auto plumber = std::make_shared<render::ShapePlumber>();
+    auto program = gpu::StandardShaderLib::getProgram(gpu::StandardShaderLib::getDrawTransformUnitQuadVS,
+        gpu::StandardShaderLib::getDrawTexturePS);
+    for (const auto& key : getTestShapeKeys()) {
+        for (bool isTranslucent : { false, true }) {
+            auto state = std::make_shared<gpu::State>();
+            state->setCullMode(gpu::State::CULL_BACK);
+            state->setDepthTest(true, !isTranslucent, gpu::LESS_EQUAL);
+            if (isTranslucent) {
+                state->setBlendFunction(true,
+                    gpu::State::SRC_ALPHA, gpu::State::BLEND_OP_ADD, gpu::State::INV_SRC_ALPHA,
+                    gpu::State::FACTOR_ALPHA, gpu::State::BLEND_OP_ADD, gpu::State::ONE);
+            }
+            // the null backend does not look at the shaders, but pickPipeline() still sets up a batch per key
+            auto shapeKey = isTranslucent ? render::ShapeKey::Builder(key).withTranslucent().build() : key;
+            plumber->addPipeline(shapeKey, program, state, [](const render::ShapePipeline& pipeline, gpu::Batch& batch) {
+                batch.setUniformBuffer(render::ShapePipeline::Slot::BUFFER::MATERIAL, nullptr, 0, 0);
+            });
+        }
+    }
+    return plumber;
+}
+
+// Records a bucket of shapes into a gpu::Batch, as the deferred and forward draw jobs do
+class RecordShapes {
+public:
+    using JobModel = render::Job::ModelI<RecordShapes, render::ItemBounds>;
+
+    RecordShapes(const render::ShapePlumberPointer& shapePlumber, bool stateSort) :
+        _shapePlumber(shapePlumber), _stateSort(stateSort) {}
+
+    void run(const render::SceneContextPointer& sceneContext, const render::RenderContextPointer& renderContext,
+             const render::ItemBounds& inItems) {
+        RenderArgs* args = renderContext->args;
+        gpu::doInBatch(args->_context, [&](gpu::Batch& batch) {
+            args->_batch = &batch;
+            batch.setViewTransform(Transform(args->getViewFrustum().getView()));
+            if (_stateSort) {
+                render::renderStateSortShapes(sceneContext, renderContext, _shapePlumber, inItems);
+            } else {
+                render::renderShapes(sceneContext, renderContext, _shapePlumber, inItems);
+            }
+            args->_batch = nullptr;
+        });
+    }
+
+protected:
+    render::ShapePlumberPointer _shapePlumber;
+    bool _stateSort;
+};
+
+class RecordTask : public render::Task {
+public:
+    using JobModel = Model<RecordTask>;
+
+    RecordTask(render::CullFunctor cullFunctor);
+};
+
+RecordTask::RecordTask(render::CullFunctor cullFunctor) {
+    const auto items = addJob<RenderFetchCullSortTask>("FetchCullSort", cullFunctor);
+    const auto& buckets = items.get<RenderFetchCullSortTask::Output>();
+    auto shapePlumber = createShapePlumber();
+    addJob<RecordShapes>("RecordOpaque", buckets[RenderFetchCullSortTask::OPAQUE_SHAPE], shapePlumber, true);
+    addJob<RecordShapes>("RecordTransparent", buckets[RenderFetchCullSortTask::TRANSPARENT_SHAPE], shapePlumber, false);
+}
+
+static bool cull(const RenderArgs* args, const AABox& bounds) {
+    float renderAccuracy = calculateRenderAccuracy(args->getViewFrustum().getPosition(), bounds, args->_sizeScale, args->_boundaryLevelAdjust);
+    return (renderAccuracy > 0.0f);
+}
+
+static render::ScenePointer createScene(int numItems) {
+    auto scene = std::make_shared<render::Scene>(glm::vec3(-0.5f * (float)TREE_SCALE), (float)TREE_SCALE);
+
+    // fixed seed, so runs are comparable
+    std::mt19937 generator(numItems);
+    std::uniform_real_distribution<float> position(-0.5f * SCENE_SIZE, 0.5f * SCENE_SIZE);
+    std::uniform_real_distribution<float> size(MIN_ITEM_SIZE, MAX_ITEM_SIZE);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    const auto& keys = getTestShapeKeys();
+
+    render::PendingChanges pendingChanges;
+    for (int i = 0; i < numItems; ++i) {
+        glm::vec3 dimensions(size(generator), size(generator), size(generator));
+        glm::vec3 center(position(generator), position(generator), position(generator));
+        AABox bound(center - 0.5f * dimensions, dimensions);
+        bool isTransparent = unit(generator) < TRANSPARENT_FRACTION;
+        render::ShapeKey key = keys[i % keys.size()];
+        if (isTransparent) {
+            key = render::ShapeKey::Builder(key).withTranslucent().build();
+        }
+        auto shape = std::make_shared<TestShape>(bound, key, isTransparent);
+        pendingChanges.resetItem(scene->allocateID(), std::make_shared<TestShape::Payload>(shape));
+    }
+    scene->enqueuePendingChanges(pendingChanges);
+    scene->processPendingChangesQueue();
+    return scene;
+}
+
+class JobTiming {
+public:
+    void add(double msecs) {
+        _total += msecs;
+        _min = (_count == 0) ? msecs : std::min(_min, msecs);
+        _max = std::max(_max, msecs);
+        ++_count;
+    }
+    double getAverage() const { return _count > 0 ? _total / _count : 0.0; }
+
+    double _total { 0.0 };
+    double _min { 0.0 };
+    double _max { 0.0 };
+    int _count { 0 };
+};
+
+// Walks the config tree of the engine, in job order, collecting the cpuRunTime of the last frame
+class JobTimings {
+public:
+    void collect(const QObject* config, const QString& prefix = QString()) {
+        for (auto child : config->children()) {
+            auto jobConfig = qobject_cast<render::JobConfig*>(child);
+            if (!jobConfig) {
+                continue;
+            }
+            QString name = prefix + jobConfig->objectName();
+            if (!_timings.contains(name)) {
+                _names.push_back(name);
+            }
+            _timings[name].add(jobConfig->getCPURunTime());
+            collect(jobConfig, name + "/");
+        }
+    }
+
+    void print() const {
+        printf("  %-60s %10s %10s %10s\n", "job", "avg (ms)", "min (ms)", "max (ms)");
+        for (const auto& name : _names) {
+            const JobTiming& timing = _timings[name];
+            printf("  %-60s %10.3f %10.3f %10.3f\n", qPrintable(name), timing.getAverage(), timing._min, timing._max);
+        }
+    }
+
+private:
+    QVector<QString> _names;
+    QHash<QString, JobTiming> _timings;
+};
+
+static void runBenchmark(const gpu::ContextPointer& gpuContext, int numItems, int numFrames) {
+    QElapsedTimer timer;
+    timer.start();
+    auto scene = createScene(numItems);
+    double sceneTime = (double)timer.nsecsElapsed() / NSECS_PER_MSEC;
+
+    render::CullFunctor cullFunctor = cull;
+    auto engine = std::make_shared<render::Engine>();
+    engine->addJob<RecordTask>("RecordTask", cullFunctor);
+    engine->registerScene(scene);
+
+    ViewFrustum viewFrustum;
+    viewFrustum.setProjection(glm::perspective(glm::radians(45.0f), 16.0f / 9.0f, 0.1f, SCENE_SIZE));
+    viewFrustum.setPosition(glm::vec3(0.0f));
+    viewFrustum.setOrientation(glm::quat());
+    viewFrustum.calculate();
+
+    RenderArgs renderArgs(gpuContext, nullptr, DEFAULT_OCTREE_SIZE_SCALE, 0, RenderArgs::DEFAULT_RENDER_MODE,
+        RenderArgs::MONO, RenderArgs::RENDER_DEBUG_NONE);
+    engine->getRenderContext()->args = &renderArgs;
+
+    // a quarter turn per hundred frames, so the culled and sorted sets change from frame to frame
+    const float YAW_PER_FRAME = 0.5f * PI / 100.0f;
+    JobTimings timings;
+    JobTiming frameTiming;
+    for (int frame = 0; frame < numFrames; ++frame) {
+        viewFrustum.setOrientation(glm::angleAxis(YAW_PER_FRAME * (float)frame, Vectors::UNIT_Y));
+        viewFrustum.calculate();
+        renderArgs.setViewFrustum(viewFrustum);
+
+        timer.restart();
+        gpuContext->beginFrame();
+        engine->run();
+        auto gpuFrame = gpuContext->endFrame();
+        gpuContext->executeFrame(gpuFrame);
+        frameTiming.add((double)timer.nsecsElapsed() / NSECS_PER_MSEC);
+
+        timings.collect(engine->getConfiguration().get());
+    }
+
+    printf("%d items, %d frames, scene built in %.1f ms, %.3f ms per frame (min %.3f, max %.3f)\n",
+        numItems, numFrames, sceneTime, frameTiming.getAverage(), frameTiming._min, frameTiming._max);
+    timings.print();
+    printf("\n");
+}
+
+int main(int argc, char** argv) {
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("render-null-perf-test");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Render engine CPU benchmark on the null gpu backend");
+    parser.addHelpOption();
+    QCommandLineOption itemsOption("items", "Comma separated list of scene sizes", "counts", "10000,50000,100000,500000");
+    QCommandLineOption framesOption("frames", "Number of frames to run for each scene size", "frames",
+        QString::number(DEFAULT_NUM_FRAMES));
+    parser.addOption(itemsOption);
+    parser.addOption(framesOption);
+    parser.process(app);
+
+    int numFrames = std::max(1, parser.value(framesOption).toInt());
+
+    gpu::Context::init<gpu::null::Backend>();
+    auto gpuContext = std::make_shared<gpu::Context>();
+    initTestShapeGeometry();
+
+    for (const auto& count : parser.value(itemsOption).split(',', QString::SkipEmptyParts)) {
+        int numItems = count.toInt();
+        if (numItems > 0) {
+            runBenchmark(gpuContext, numItems, numFrames);
+        }
+    }
+    return 0;
+}
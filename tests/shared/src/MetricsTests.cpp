@@ -0,0 +1,103 @@
+//
+//  MetricsTests.cpp
+//  tests/shared/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "MetricsTests.h"
+
+#include <thread>
+
+#include <Metrics.h>
+
+QTEST_MAIN(MetricsTests)
+
+void MetricsTests::testRegistration() {
+    auto& registry = metrics::Registry::getInstance();
+    auto& first = registry.counter("test_registration_total", "Registered twice", { { "kind", "a" } });
+    auto& second = registry.counter("test_registration_total", "Registered twice", { { "kind", "a" } });
+    auto& other = registry.counter("test_registration_total", "Registered twice", { { "kind", "b" } });
+    QCOMPARE(&first, &second);
+    QVERIFY(&first != &other);
+
+    first.increment();
+    second.increment(2);
+    QCOMPARE(first.get(), (uint64_t)3);
+    QCOMPARE(other.get(), (uint64_t)0);
+}
+
+void MetricsTests::testHistogramBuckets() {
+    metrics::Histogram histogram({ 1.0, 2.0, 4.0 });
+    histogram.record(0.5);
+    histogram.record(1.0); // bounds are inclusive
+    histogram.record(3.0);
+    histogram.record(10.0);
+
+    auto counts = histogram.getCumulativeCounts();
+    QCOMPARE(counts.size(), (size_t)4);
+    QCOMPARE(counts[0], (uint64_t)2);
+    QCOMPARE(counts[1], (uint64_t)2);
+    QCOMPARE(counts[2], (uint64_t)3);
+    QCOMPARE(counts[3], (uint64_t)4);
+    QCOMPARE(histogram.getCount(), (uint64_t)4);
+    QCOMPARE(histogram.getSum(), 14.5);
+
+    auto bounds = metrics::Histogram::exponentialBounds(0.001, 2.0, 4);
+    QCOMPARE(bounds.size(), (size_t)4);
+    QCOMPARE(bounds[3], 0.008);
+}
+
+void MetricsTests::testConcurrentRecording() {
+    const int NUM_THREADS = 4;
+    const int NUM_VALUES = 100000;
+    metrics::Histogram histogram(metrics::Histogram::exponentialBounds(1.0, 2.0, 8));
+    metrics::Counter counter;
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < NUM_THREADS; ++i) {
+        threads.emplace_back([&] {
+            for (int j = 0; j < NUM_VALUES; ++j) {
+                histogram.record((double)(j % 200));
+                counter.increment();
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    // no value is lost, sums of small integers are exact
+    QCOMPARE(counter.get(), (uint64_t)(NUM_THREADS * NUM_VALUES));
+    QCOMPARE(histogram.getCount(), (uint64_t)(NUM_THREADS * NUM_VALUES));
+    const double SUM_PER_200 = 199.0 * 200.0 / 2.0;
+    QCOMPARE(histogram.getSum(), NUM_THREADS * (NUM_VALUES / 200) * SUM_PER_200);
+}
+
+void MetricsTests::testExposition() {
+    auto& registry = metrics::Registry::getInstance();
+    registry.setCommonLabels({ { "type", "test" } });
+    registry.counter("test_packets_total", "Packets \"sent\"\nby the test").increment(7);
+    registry.gauge("test_nodes", "Connected nodes", { { "pool", "a\"b" } }).set(2.5);
+    auto& histogram = registry.histogram("test_frame_seconds", "Frame time", { 0.01, 0.1 });
+    histogram.record(0.005);
+    histogram.record(0.05);
+
+    QString text = QString::fromUtf8(registry.serialize());
+    registry.setCommonLabels({});
+
+    QVERIFY(text.contains("# HELP test_packets_total Packets \"sent\"\\nby the test\n"));
+    QVERIFY(text.contains("# TYPE test_packets_total counter\n"));
+    QVERIFY(text.contains("test_packets_total{type=\"test\"} 7\n"));
+    QVERIFY(text.contains("# TYPE test_nodes gauge\n"));
+    QVERIFY(text.contains("test_nodes{pool=\"a\\\"b\",type=\"test\"} 2.5\n"));
+    QVERIFY(text.contains("# TYPE test_frame_seconds histogram\n"));
+    QVERIFY(text.contains("test_frame_seconds_bucket{le=\"0.01\",type=\"test\"} 1\n"));
+    QVERIFY(text.contains("test_frame_seconds_bucket{le=\"0.1\",type=\"test\"} 2\n"));
+    QVERIFY(text.contains("test_frame_seconds_bucket{le=\"+Inf\",type=\"test\"} 2\n"));
+    QVERIFY(text.contains("test_frame_seconds_sum{type=\"test\"} 0.055\n"));
+    QVERIFY(text.contains("test_frame_seconds_count{type=\"test\"} 2\n"));
+}
@@ -0,0 +1,136 @@
+//
+//  PerformanceTimerTests.cpp
+//  tests/shared/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "PerformanceTimerTests.h"
+
+#include <thread>
+
+#include <PerfStat.h>
+#include <SharedUtil.h>
+
+QTEST_MAIN(PerformanceTimerTests)
+
+void PerformanceTimerTests::initTestCase() {
+    PerformanceTimer::setActive(true);
+}
+
+void PerformanceTimerTests::cleanupTestCase() {
+    PerformanceTimer::setActive(false);
+}
+
+void PerformanceTimerTests::testNestedNames() {
+    {
+        PERFORMANCE_TIMER("outer");
+        QCOMPARE(PerformanceTimer::getContextName(), QString("/outer"));
+        {
+            PerformanceTimer innerTimer(QString("inner"));
+            QCOMPARE(PerformanceTimer::getContextName(), QString("/outer/inner"));
+        }
+        QCOMPARE(PerformanceTimer::getContextName(), QString("/outer"));
+    }
+    QCOMPARE(PerformanceTimer::getContextName(), QString());
+
+    // nothing is merged until the frame is tallied
+    QVERIFY(!PerformanceTimer::getAllTimerRecords().contains("/outer"));
+    PerformanceTimer::tallyAllTimerRecords();
+    auto records = PerformanceTimer::getAllTimerRecords();
+    QVERIFY(records.contains("/outer"));
+    QVERIFY(records.contains("/outer/inner"));
+    QCOMPARE(records["/outer"].getCount(), (quint64)1);
+}
+
+void PerformanceTimerTests::testThreads() {
+    const int NUM_THREADS = 4;
+    const int NUM_SCOPES = 1000;
+
+    // what each thread timed, from outside its scopes
+    std::vector<quint64> threadElapsed(NUM_THREADS);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < NUM_THREADS; ++i) {
+        threads.emplace_back([i, &threadElapsed] {
+            quint64 start = usecTimestampNow();
+            {
+                PERFORMANCE_TIMER("worker");
+                for (int j = 0; j < NUM_SCOPES; ++j) {
+                    PERFORMANCE_TIMER("job");
+                }
+            }
+            threadElapsed[i] = usecTimestampNow() - start;
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    // every thread's scopes land in one record per name, and exited threads are still counted
+    PerformanceTimer::tallyAllTimerRecords();
+    auto records = PerformanceTimer::getAllTimerRecords();
+    QVERIFY(records.contains("/worker"));
+    QVERIFY(records.contains("/worker/job"));
+    QCOMPARE(records["/worker"].getCount(), (quint64)1);
+    QCOMPARE(records["/worker/job"].getCount(), (quint64)1);
+    QCOMPARE(records["/worker"].getNumCalls(), (quint64)NUM_THREADS);
+    QCOMPARE(records["/worker/job"].getNumCalls(), (quint64)(NUM_THREADS * NUM_SCOPES));
+
+    // and their times add up: the jobs within the workers, within what the threads timed themselves
+    quint64 totalElapsed = 0;
+    for (auto elapsed : threadElapsed) {
+        totalElapsed += elapsed;
+    }
+    QVERIFY(records["/worker/job"].getTotal() <= records["/worker"].getTotal());
+    QVERIFY(records["/worker"].getTotal() <= totalElapsed);
+    QCOMPARE(PerformanceTimer::getNumDroppedScopes(), (quint64)0);
+
+    // nothing is merged twice
+    PerformanceTimer::tallyAllTimerRecords();
+    records = PerformanceTimer::getAllTimerRecords();
+    QCOMPARE(records["/worker/job"].getNumCalls(), (quint64)(NUM_THREADS * NUM_SCOPES));
+}
+
+void PerformanceTimerTests::testDroppedScopes() {
+    const int NUM_EXTRA_SCOPES = 10;
+
+    // a thread has room for all but the root's node
+    std::thread thread([] {
+        for (int i = 0; i < PerformanceTimer::MAX_NODES_PER_THREAD - 1 + NUM_EXTRA_SCOPES; ++i) {
+            PerformanceTimer timer(QString("dropped%1").arg(i));
+        }
+    });
+    thread.join();
+
+    PerformanceTimer::tallyAllTimerRecords();
+    auto records = PerformanceTimer::getAllTimerRecords();
+    QVERIFY(records.contains("/dropped0"));
+    QVERIFY(!records.contains(QString("/dropped%1").arg(PerformanceTimer::MAX_NODES_PER_THREAD - 1)));
+    QCOMPARE(PerformanceTimer::getNumDroppedScopes(), (quint64)NUM_EXTRA_SCOPES);
+}
+
+void PerformanceTimerTests::testPercentiles() {
+    PerformanceTimerRecord record;
+    QCOMPARE(record.getPercentile(50.0f), (quint64)0);
+
+    // one frame each of 1 to 100 usecs
+    quint64 now = 0;
+    for (quint64 i = 1; i <= 100; ++i) {
+        record.accumulateResult(i);
+        record.tallyResult(now);
+    }
+    QCOMPARE(record.getPercentile(50.0f), (quint64)50);
+    QCOMPARE(record.getPercentile(95.0f), (quint64)95);
+    QCOMPARE(record.getPercentile(99.0f), (quint64)99);
+    QCOMPARE(record.getPercentile(100.0f), (quint64)100);
+
+    // only the last NUM_FRAME_SAMPLES frames count
+    for (int i = 0; i < PerformanceTimerRecord::NUM_FRAME_SAMPLES; ++i) {
+        record.accumulateResult(1000);
+        record.tallyResult(now);
+    }
+    QCOMPARE(record.getPercentile(50.0f), (quint64)1000);
+}
@@ -0,0 +1,28 @@
+//
+//  PerformanceTimerTests.h
+//  tests/shared/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_PerformanceTimerTests_h
+#define hifi_PerformanceTimerTests_h
+
+#include <QtTest/QtTest>
+
+class PerformanceTimerTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void testNestedNames();
+    void testThreads();
+    void testDroppedScopes();
+    void testPercentiles();
+};
+
+#endif // hifi_PerformanceTimerTests_h
@@ -0,0 +1,227 @@
+//
+//  PickQueueTests.cpp
+//  tests/shared/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "PickQueueTests.h"
+
+#include <PickQueue.h>
+
+#include <../QTestExtensions.h>
+#include <../GLMTestUtils.h>
+
+QTEST_MAIN(PickQueueTests)
+
+const float EPSILON = 0.0001f;
+
+static QVariantMap toVariant(const glm::vec3& v) {
+    return QVariantMap { { "x", v.x }, { "y", v.y }, { "z", v.z } };
+}
+
+// a result as the picker would give it, told apart by its distance
+static PickResult makeResult(float distance) {
+    PickResult result;
+    result.type = PickResult::EntityType;
+    result.objectID = QUuid::createUuid();
+    result.distance = distance;
+    return result;
+}
+
+// takes the pending queries and gives each a result, numbered in the batch's order from firstDistance
+static void pickBatch(PickQueue& queue, PickQueue::Batch& batch, float firstDistance = 1.0f) {
+    batch.clear();
+    queue.takeQueries(batch);
+    for (size_t i = 0; i < batch.size(); i++) {
+        batch.results.push_back(makeResult(firstDistance + (float)i));
+    }
+}
+
+void PickQueueTests::testRayQueryFromVariantMap() {
+    QUuid included = QUuid::createUuid();
+    QUuid ignored = QUuid::createUuid();
+    QVariantMap properties {
+        { "origin", toVariant(glm::vec3(1.0f, 2.0f, 3.0f)) },
+        { "direction", toVariant(glm::vec3(0.0f, -1.0f, 0.0f)) },
+        { "overlays", false },
+        { "precise", true },
+        { "include", QVariantList { included.toString() } },
+        { "ignore", QVariantList { ignored.toString() } }
+    };
+    PickQuery query = PickQuery::fromVariantMap(properties);
+
+    QCOMPARE(query.shape, PickQuery::Ray);
+    QCOMPARE_WITH_ABS_ERROR(query.ray.origin, glm::vec3(1.0f, 2.0f, 3.0f), EPSILON);
+    QCOMPARE_WITH_ABS_ERROR(query.ray.direction, glm::vec3(0.0f, -1.0f, 0.0f), EPSILON);
+    QCOMPARE(query.flags, (int)(PickQuery::PICK_ENTITIES | PickQuery::PICK_AVATARS | PickQuery::PICK_PRECISE));
+    QCOMPARE(query.idsToInclude, QVector<QUuid> { included });
+    QCOMPARE(query.idsToDiscard, QVector<QUuid> { ignored });
+
+    // nothing given picks everything, imprecisely
+    PickQuery defaults = PickQuery::fromVariantMap(QVariantMap());
+    QCOMPARE(defaults.shape, PickQuery::Ray);
+    QCOMPARE(defaults.flags, (int)(PickQuery::PICK_ENTITIES | PickQuery::PICK_OVERLAYS | PickQuery::PICK_AVATARS));
+    QVERIFY(defaults.idsToInclude.isEmpty());
+    QVERIFY(defaults.idsToDiscard.isEmpty());
+}
+
+void PickQueueTests::testSphereQueryFromVariantMap() {
+    QVariantMap properties {
+        { "type", "sphere" },
+        { "center", toVariant(glm::vec3(-1.0f, 0.5f, 4.0f)) },
+        { "radius", 2.5f },
+        { "entities", false },
+        { "avatars", false },
+        { "visibleOnly", true },
+        { "collidableOnly", true }
+    };
+    PickQuery query = PickQuery::fromVariantMap(properties);
+
+    QCOMPARE(query.shape, PickQuery::Sphere);
+    QCOMPARE_WITH_ABS_ERROR(query.center, glm::vec3(-1.0f, 0.5f, 4.0f), EPSILON);
+    QCOMPARE(query.radius, 2.5f);
+    QCOMPARE(query.flags, (int)(PickQuery::PICK_OVERLAYS | PickQuery::PICK_VISIBLE_ONLY |
+                                PickQuery::PICK_COLLIDABLE_ONLY));
+}
+
+void PickQueueTests::testResultToVariantMap() {
+    QVariantMap none = PickResult().toVariantMap();
+    QCOMPARE(none["intersects"].toBool(), false);
+    QCOMPARE(none["type"].toString(), QString("none"));
+    QCOMPARE(none["face"].toString(), QString("UNKNOWN_FACE"));
+
+    PickResult result;
+    result.type = PickResult::AvatarType;
+    result.objectID = QUuid::createUuid();
+    result.distance = 3.5f;
+    result.face = MAX_Y_FACE;
+    result.intersection = glm::vec3(1.0f, 2.0f, 3.0f);
+    result.surfaceNormal = glm::vec3(0.0f, 1.0f, 0.0f);
+    result.accurate = false;
+    QVariantMap map = result.toVariantMap();
+
+    QCOMPARE(map["intersects"].toBool(), true);
+    QCOMPARE(map["type"].toString(), QString("avatar"));
+    QCOMPARE(map["objectID"].toUuid(), result.objectID);
+    QCOMPARE(map["distance"].toFloat(), 3.5f);
+    QCOMPARE(map["face"].toString(), QString("MAX_Y_FACE"));
+    QCOMPARE_WITH_ABS_ERROR(vec3FromVariant(map["intersection"]), result.intersection, EPSILON);
+    QCOMPARE_WITH_ABS_ERROR(vec3FromVariant(map["surfaceNormal"]), result.surfaceNormal, EPSILON);
+    QCOMPARE(map["accurate"].toBool(), false);
+
+    PickResult entity;
+    entity.type = PickResult::EntityType;
+    QCOMPARE(entity.toVariantMap()["type"].toString(), QString("entity"));
+    PickResult overlay;
+    overlay.type = PickResult::OverlayType;
+    QCOMPARE(overlay.toVariantMap()["type"].toString(), QString("overlay"));
+}
+
+void PickQueueTests::testKeptPickResults() {
+    PickQueue queue;
+    PickQuery first;
+    first.radius = 1.0f;
+    PickQuery second;
+    second.radius = 2.0f;
+    unsigned int firstID = queue.addPick(first);
+    unsigned int secondID = queue.addPick(second);
+    QVERIFY(firstID != secondID);
+    QCOMPARE(queue.getPickResult(firstID).type, PickResult::NoneType);
+
+    PickQueue::Batch batch;
+    pickBatch(queue, batch);
+    QCOMPARE(batch.pickIDs.size(), (size_t)2);
+    QCOMPARE(batch.queries.size(), (size_t)2);
+    QVERIFY(batch.oneShotQueries.empty());
+
+    // nothing changes until the batch is handed back
+    QCOMPARE(queue.getPickResult(firstID).type, PickResult::NoneType);
+    queue.setResults(batch);
+
+    // each result goes to the pick whose query it was
+    for (size_t i = 0; i < batch.pickIDs.size(); i++) {
+        unsigned int pickID = batch.pickIDs[i];
+        PickResult result = queue.getPickResult(pickID);
+        QCOMPARE(result.objectID, batch.results[i].objectID);
+        QCOMPARE(result.distance, batch.results[i].distance);
+        QCOMPARE(batch.queries[i].radius, pickID == firstID ? 1.0f : 2.0f);
+    }
+
+    // kept picks are in every batch, as they were last edited
+    PickQuery edited;
+    edited.radius = 3.0f;
+    queue.editPick(secondID, edited);
+    pickBatch(queue, batch, 10.0f);
+    QCOMPARE(batch.pickIDs.size(), (size_t)2);
+    for (size_t i = 0; i < batch.pickIDs.size(); i++) {
+        QCOMPARE(batch.queries[i].radius, batch.pickIDs[i] == firstID ? 1.0f : 3.0f);
+    }
+    queue.setResults(batch);
+    QVERIFY(queue.getPickResult(firstID).distance >= 10.0f);
+    QVERIFY(queue.getPickResult(secondID).distance >= 10.0f);
+}
+
+void PickQueueTests::testRemovedPickResults() {
+    PickQueue queue;
+    unsigned int keptID = queue.addPick(PickQuery());
+    unsigned int removedID = queue.addPick(PickQuery());
+
+    PickQueue::Batch batch;
+    pickBatch(queue, batch);
+
+    // removed while its batch was being picked
+    queue.removePick(removedID);
+    queue.setResults(batch);
+
+    QCOMPARE(queue.getPickResult(keptID).type, PickResult::EntityType);
+    QCOMPARE(queue.getPickResult(removedID).type, PickResult::NoneType);
+
+    pickBatch(queue, batch);
+    QCOMPARE(batch.pickIDs, std::vector<unsigned int> { keptID });
+}
+
+void PickQueueTests::testOneShotPickResults() {
+    PickQueue queue;
+    unsigned int keptID = queue.addPick(PickQuery());
+
+    std::vector<PickResult> firstResults;
+    std::vector<PickResult> secondResults;
+    PickQuery first;
+    first.radius = 1.0f;
+    PickQuery second;
+    second.radius = 2.0f;
+    queue.pickOnce(first, [&](const PickResult& result) { firstResults.push_back(result); });
+    queue.pickOnce(second, [&](const PickResult& result) {
+        secondResults.push_back(result);
+        // the queue isn't locked while it calls back
+        queue.pickOnce(PickQuery(), [](const PickResult&) {});
+    });
+
+    PickQueue::Batch batch;
+    pickBatch(queue, batch);
+    QCOMPARE(batch.queries.size(), (size_t)1);
+    QCOMPARE(batch.oneShotQueries.size(), (size_t)2);
+    QCOMPARE(batch.oneShotQueries[0].radius, 1.0f);
+    QCOMPARE(batch.oneShotQueries[1].radius, 2.0f);
+    QVERIFY(firstResults.empty());
+    queue.setResults(batch);
+
+    // each callback is called once, with its own query's result, and the kept pick gets the kept query's
+    QCOMPARE(firstResults.size(), (size_t)1);
+    QCOMPARE(secondResults.size(), (size_t)1);
+    QCOMPARE(queue.getPickResult(keptID).objectID, batch.results[0].objectID);
+    QCOMPARE(firstResults[0].objectID, batch.results[1].objectID);
+    QCOMPARE(secondResults[0].objectID, batch.results[2].objectID);
+
+    // one-shot picks are only in the batch that took them, alongside any asked for since
+    pickBatch(queue, batch);
+    QCOMPARE(batch.queries.size(), (size_t)1);
+    QCOMPARE(batch.oneShotQueries.size(), (size_t)1);
+    queue.setResults(batch);
+    QCOMPARE(firstResults.size(), (size_t)1);
+    QCOMPARE(secondResults.size(), (size_t)1);
+}
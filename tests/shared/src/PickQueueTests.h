@@ -0,0 +1,27 @@
+//
+//  PickQueueTests.h
+//  tests/shared/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_PickQueueTests_h
+#define hifi_PickQueueTests_h
+
+#include <QtTest/QtTest>
+
+class PickQueueTests : public QObject {
+    Q_OBJECT
+private slots:
+    void testRayQueryFromVariantMap();
+    void testSphereQueryFromVariantMap();
+    void testResultToVariantMap();
+    void testKeptPickResults();
+    void testRemovedPickResults();
+    void testOneShotPickResults();
+};
+
+#endif // hifi_PickQueueTests_h
@@ -0,0 +1,231 @@
+//
+//  SpatiallyNestableTests.cpp
+//  tests/shared/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "SpatiallyNestableTests.h"
+
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <DependencyManager.h>
+#include <SpatialParentFinder.h>
+#include <SpatiallyNestable.h>
+
+#include <../GLMTestUtils.h>
+#include <../QTestExtensions.h>
+
+QTEST_MAIN(SpatiallyNestableTests)
+
+const float TEST_EPSILON = 0.0001f;
+const int DEEP_HIERARCHY_DEPTH = 20;
+const int WIDE_HIERARCHY_CHILDREN = 1000;
+
+class TestNestable : public SpatiallyNestable {
+public:
+    TestNestable() : SpatiallyNestable(NestableType::Entity, QUuid::createUuid()) {}
+
+    // joint 0 moves without telling anyone, as a skeleton's do
+    glm::quat getAbsoluteJointRotationInObjectFrame(int index) const override {
+        return index == 0 ? jointRotation : glm::quat();
+    }
+    glm::vec3 getAbsoluteJointTranslationInObjectFrame(int index) const override {
+        return index == 0 ? jointTranslation : glm::vec3();
+    }
+
+    glm::quat jointRotation;
+    glm::vec3 jointTranslation;
+};
+using TestNestablePointer = std::shared_ptr<TestNestable>;
+
+class TestParentFinder : public SpatialParentFinder {
+public:
+    SpatiallyNestableWeakPointer find(QUuid parentID, bool& success, SpatialParentTree* entityTree = nullptr) const override {
+        success = true;
+        return nestables.value(parentID);
+    }
+
+    QHash<QUuid, SpatiallyNestableWeakPointer> nestables;
+};
+
+static std::mt19937 generator(1);
+
+static glm::vec3 randomPosition() {
+    std::uniform_real_distribution<float> random(-10.0f, 10.0f);
+    return glm::vec3(random(generator), random(generator), random(generator));
+}
+
+static glm::quat randomOrientation() {
+    std::uniform_real_distribution<float> random(-1.0f, 1.0f);
+    return glm::normalize(glm::quat(random(generator), random(generator), random(generator), random(generator)));
+}
+
+static TestNestablePointer makeNestable(const SpatiallyNestablePointer& parent) {
+    auto nestable = std::make_shared<TestNestable>();
+    DependencyManager::get<TestParentFinder>()->nestables[nestable->getID()] = nestable;
+    if (parent) {
+        nestable->setParentID(parent->getID());
+    }
+    nestable->setLocalPosition(randomPosition());
+    nestable->setLocalOrientation(randomOrientation());
+    return nestable;
+}
+
+static std::vector<TestNestablePointer> makeChain(int depth) {
+    std::vector<TestNestablePointer> chain;
+    for (int i = 0; i < depth; i++) {
+        chain.push_back(makeNestable(i > 0 ? chain.back() : nullptr));
+    }
+    return chain;
+}
+
+// each one's world transform, composed from the root's down
+static std::vector<Transform> composeChain(const std::vector<TestNestablePointer>& chain) {
+    std::vector<Transform> transforms;
+    Transform parentTransform;
+    for (const auto& nestable : chain) {
+        Transform transform;
+        Transform::mult(transform, parentTransform, nestable->getLocalTransform());
+        transforms.push_back(transform);
+        parentTransform = transform;
+    }
+    return transforms;
+}
+
+static void readChain(const std::vector<TestNestablePointer>& chain) {
+    for (const auto& nestable : chain) {
+        nestable->getPosition();
+    }
+}
+
+static void compareChain(const std::vector<TestNestablePointer>& chain, const std::vector<Transform>& expected) {
+    for (size_t i = 0; i < chain.size(); i++) {
+        QCOMPARE_WITH_ABS_ERROR(chain[i]->getPosition(), expected[i].getTranslation(), TEST_EPSILON);
+        QCOMPARE_WITH_ABS_ERROR(chain[i]->getOrientation(), expected[i].getRotation(), TEST_EPSILON);
+    }
+}
+
+void SpatiallyNestableTests::initTestCase() {
+    DependencyManager::registerInheritance<SpatialParentFinder, TestParentFinder>();
+    DependencyManager::set<TestParentFinder>();
+}
+
+void SpatiallyNestableTests::testAncestorChanged() {
+    auto chain = makeChain(8);
+    compareChain(chain, composeChain(chain));
+
+    // cached, then moved from above
+    chain[0]->setLocalOrientation(randomOrientation());
+    compareChain(chain, composeChain(chain));
+    chain[3]->setPosition(randomPosition());
+    compareChain(chain, composeChain(chain));
+    chain[5]->setLocalTransform(Transform(randomOrientation(), glm::vec3(1.0f), randomPosition()));
+    compareChain(chain, composeChain(chain));
+}
+
+void SpatiallyNestableTests::testReparented() {
+    auto chain = makeChain(4);
+    auto otherRoot = makeNestable(nullptr);
+    readChain(chain);
+
+    chain[1]->setParentID(otherRoot->getID());
+
+    std::vector<TestNestablePointer> reparented { otherRoot, chain[1], chain[2], chain[3] };
+    compareChain(reparented, composeChain(reparented));
+
+    chain[1]->setParentID(QUuid());
+    std::vector<TestNestablePointer> unparented { chain[1], chain[2], chain[3] };
+    compareChain(unparented, composeChain(unparented));
+}
+
+void SpatiallyNestableTests::testJointMoved() {
+    auto parent = makeNestable(nullptr);
+    auto child = makeNestable(parent);
+    auto grandchild = makeNestable(child);
+    child->setParentJointIndex(0);
+
+    for (int i = 0; i < 2; i++) {
+        parent->jointTranslation = randomPosition();
+        parent->jointRotation = randomOrientation();
+
+        Transform joint(parent->jointRotation, glm::vec3(1.0f), parent->jointTranslation);
+        Transform jointInWorld;
+        Transform::mult(jointInWorld, parent->getLocalTransform(), joint);
+        Transform childInWorld;
+        Transform::mult(childInWorld, jointInWorld, child->getLocalTransform());
+        Transform grandchildInWorld;
+        Transform::mult(grandchildInWorld, childInWorld, grandchild->getLocalTransform());
+
+        QCOMPARE_WITH_ABS_ERROR(child->getPosition(), childInWorld.getTranslation(), TEST_EPSILON);
+        QCOMPARE_WITH_ABS_ERROR(grandchild->getPosition(), grandchildInWorld.getTranslation(), TEST_EPSILON);
+    }
+}
+
+// every object in a chain as deep as a parenting chain may be, as entities attached to entities are
+void SpatiallyNestableTests::benchmarkDeepHierarchy() {
+    auto chain = makeChain(DEEP_HIERARCHY_DEPTH);
+
+    QBENCHMARK {
+        for (const auto& nestable : chain) {
+            nestable->getPosition();
+            nestable->getOrientation();
+        }
+    }
+}
+
+// as above, with the root moving every time, so every transform in the chain is recomputed once, each from the
+// one above it
+void SpatiallyNestableTests::benchmarkDeepHierarchyMoving() {
+    auto chain = makeChain(DEEP_HIERARCHY_DEPTH);
+
+    glm::vec3 position;
+    QBENCHMARK {
+        position.x += 0.01f;
+        chain[0]->setPosition(position);
+        for (const auto& nestable : chain) {
+            nestable->getPosition();
+            nestable->getOrientation();
+        }
+    }
+}
+
+// the children of one parent, as entities attached to an avatar
+void SpatiallyNestableTests::benchmarkWideHierarchy() {
+    auto root = makeNestable(nullptr);
+    std::vector<TestNestablePointer> children;
+    for (int i = 0; i < WIDE_HIERARCHY_CHILDREN; i++) {
+        children.push_back(makeNestable(root));
+    }
+
+    QBENCHMARK {
+        for (const auto& child : children) {
+            child->getPosition();
+            child->getOrientation();
+        }
+    }
+}
+
+// as above, with the parent moving every time, so every child's transform is recomputed once
+void SpatiallyNestableTests::benchmarkWideHierarchyMoving() {
+    auto root = makeNestable(nullptr);
+    std::vector<TestNestablePointer> children;
+    for (int i = 0; i < WIDE_HIERARCHY_CHILDREN; i++) {
+        children.push_back(makeNestable(root));
+    }
+
+    glm::vec3 position;
+    QBENCHMARK {
+        position.x += 0.01f;
+        root->setPosition(position);
+        for (const auto& child : children) {
+            child->getPosition();
+            child->getOrientation();
+        }
+    }
+}
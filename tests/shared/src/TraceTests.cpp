@@ -11,6 +11,16 @@
 #include <QtTest/QtTest>
 #include <QtGui/QDesktopServices>
 
+#include <functional>
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QStandardPaths>
+#include <QtCore/QThread>
+#include <QtCore/QUuid>
+
 #include <Profile.h>
 
 #include <NumericalConstants.h>
@@ -45,3 +55,204 @@ void TraceTests::testTraceSerialization() {
     qDebug() << "Done";
 }
 
+
+void TraceTests::testChromeExport() {
+    const QString EXPORT_FILE = "traces/testExport.json";
+    const int NUM_COUNTERS = 100;
+    auto tracer = DependencyManager::set<tracing::Tracer>();
+    tracer->startTracing();
+    {
+        PROFILE_RANGE(test, "Outer");
+        for (int i = 0; i < NUM_COUNTERS; ++i) {
+            PROFILE_RANGE(test, QString("Inner"));
+            PROFILE_COUNTER(test, "TestCounter", { { "i", i }, { "half", i / 2.0 }, { "odd", (i % 2) == 1 } });
+        }
+        PROFILE_ASYNC_BEGIN(test, "Async", "42", { { "url", "file:///test" } });
+        PROFILE_ASYNC_END(test, "Async", "42");
+        PROFILE_INSTANT(test, "Instant", "g");
+    }
+    tracer->stopTracing();
+    QCOMPARE(tracer->getNumDroppedEvents(), (uint64_t)0);
+    tracer->serialize(EXPORT_FILE);
+
+    QString path = QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation) + "/" + EXPORT_FILE;
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QJsonParseError error;
+    QJsonDocument document = QJsonDocument::fromJson(file.readAll(), &error);
+    QCOMPARE(error.error, QJsonParseError::NoError);
+    QVERIFY(document.isArray());
+
+    int numBegins = 0;
+    int numEnds = 0;
+    int numCounters = 0;
+    bool foundAsync = false;
+    bool foundInstant = false;
+    for (const auto& value : document.array()) {
+        QJsonObject event = value.toObject();
+        QString phase = event["ph"].toString();
+        if (phase == "M") {
+            continue;
+        }
+        QCOMPARE(event["cat"].toString(), QString("trace.test"));
+        QVERIFY(event.contains("ts") && event.contains("pid") && event.contains("tid"));
+        if (phase == "B") {
+            QCOMPARE(event["args"].toObject()["nv_payload"].toInt(), 0);
+            ++numBegins;
+        } else if (phase == "E") {
+            ++numEnds;
+        } else if (phase == "C") {
+            QJsonObject args = event["args"].toObject();
+            QCOMPARE(event["name"].toString(), QString("TestCounter"));
+            QCOMPARE(args["i"].toInt(), numCounters);
+            QCOMPARE(args["half"].toDouble(), numCounters / 2.0);
+            QCOMPARE(args["odd"].toBool(), (numCounters % 2) == 1);
+            ++numCounters;
+        } else if (phase == "b") {
+            QCOMPARE(event["id"].toString(), QString("42"));
+            QCOMPARE(event["args"].toObject()["url"].toString(), QString("file:///test"));
+            foundAsync = true;
+        } else if (phase == "i") {
+            QCOMPARE(event["s"].toString(), QString("g"));
+            foundInstant = true;
+        }
+    }
+    QCOMPARE(numBegins, NUM_COUNTERS + 1);
+    QCOMPARE(numEnds, NUM_COUNTERS + 1);
+    QCOMPARE(numCounters, NUM_COUNTERS);
+    QVERIFY(foundAsync);
+    QVERIFY(foundInstant);
+}
+
+void TraceTests::testRollingWindow() {
+    const uint64_t WINDOW_USECS = 50 * USECS_PER_MSEC;
+    auto tracer = DependencyManager::set<tracing::Tracer>();
+    tracer->setRollingWindow(WINDOW_USECS);
+    tracer->startTracing();
+    PROFILE_COUNTER(test, "Old", { { "text", "old" } });
+    QThread::msleep(2 * WINDOW_USECS / USECS_PER_MSEC);
+    PROFILE_COUNTER(test, "New", { { "a", 1 }, { "b", 2 }, { "c", 3 }, { "text", "new" } });
+
+    // the snapshot leaves the events in place
+    for (int i = 0; i < 2; ++i) {
+        QJsonDocument document = QJsonDocument::fromJson(tracer->snapshot());
+        QVERIFY(document.isArray());
+        QStringList names;
+        for (const auto& value : document.array()) {
+            QJsonObject event = value.toObject();
+            if (event["ph"].toString() != "M") {
+                names << event["name"].toString();
+                // the old event's strings went with it
+                QCOMPARE(event["args"].toObject()["text"].toString(), QString("new"));
+            }
+        }
+        QCOMPARE(names, QStringList { "New" });
+    }
+    tracer->stopTracing();
+}
+
+void TraceTests::testStringArguments() {
+    const int NUM_EVENTS = 1000;
+    auto tracer = DependencyManager::set<tracing::Tracer>();
+    tracer->startTracing();
+    // argument strings are kept with their events, only the names and keys are interned
+    uint32_t before = 0;
+    for (int i = 0; i < NUM_EVENTS; ++i) {
+        if (i == 1) {
+            before = tracing::internName(QString("TraceTests::before"));
+        }
+        PROFILE_COUNTER(test, "Strings", { { "i", i }, { "text", QString("value %1").arg(i) },
+                                           { "list", QVariantList { i, i + 1 } } });
+    }
+    QCOMPARE(tracing::internName(QString("TraceTests::after")), before + 1);
+
+    QJsonDocument document = QJsonDocument::fromJson(tracer->snapshot());
+    tracer->stopTracing();
+    QVERIFY(document.isArray());
+    int numEvents = 0;
+    for (const auto& value : document.array()) {
+        QJsonObject event = value.toObject();
+        if (event["name"].toString() != "Strings") {
+            continue;
+        }
+        QJsonObject args = event["args"].toObject();
+        int i = args["i"].toInt();
+        QCOMPARE(args["text"].toString(), QString("value %1").arg(i));
+        QCOMPARE(args["list"].toString(), QString("[%1,%2]").arg(i).arg(i + 1));
+        ++numEvents;
+    }
+    QCOMPARE(numEvents, NUM_EVENTS);
+}
+
+void TraceTests::testTextIDs() {
+    const int NUM_EVENTS = 100;
+    auto tracer = DependencyManager::set<tracing::Tracer>();
+    tracer->startTracing();
+    // IDs that aren't numbers are kept with their events too
+    QStringList ids;
+    uint32_t before = 0;
+    for (int i = 0; i < NUM_EVENTS; ++i) {
+        if (i == 1) {
+            before = tracing::internName(QString("TraceTests::beforeIDs"));
+        }
+        ids << QUuid::createUuid().toString();
+        PROFILE_ASYNC_BEGIN(test, "TextID", ids.back(), { { "i", i } });
+    }
+    QCOMPARE(tracing::internName(QString("TraceTests::afterIDs")), before + 1);
+
+    QJsonDocument document = QJsonDocument::fromJson(tracer->snapshot());
+    tracer->stopTracing();
+    QVERIFY(document.isArray());
+    int numEvents = 0;
+    for (const auto& value : document.array()) {
+        QJsonObject event = value.toObject();
+        if (event["name"].toString() != "TextID") {
+            continue;
+        }
+        QJsonObject args = event["args"].toObject();
+        // the ID isn't one of the arguments
+        QCOMPARE(args.size(), 1);
+        QCOMPARE(event["id"].toString(), ids[args["i"].toInt()]);
+        ++numEvents;
+    }
+    QCOMPARE(numEvents, NUM_EVENTS);
+}
+
+// reports the cost of recording an event, with tracing off and on
+void TraceTests::testEventOverhead() {
+    const int NUM_EVENTS = 1000000;
+    // small enough batches for the drain to keep up
+    const int EVENTS_PER_BATCH = 1000;
+    auto tracer = DependencyManager::set<tracing::Tracer>();
+
+    auto measure = [&](const char* label, std::function<void()> event) {
+        QElapsedTimer timer;
+        qint64 elapsed = 0;
+        for (int i = 0; i < NUM_EVENTS; i += EVENTS_PER_BATCH) {
+            timer.start();
+            for (int j = 0; j < EVENTS_PER_BATCH; ++j) {
+                event();
+            }
+            elapsed += timer.nsecsElapsed();
+            if (tracer->isEnabled()) {
+                QThread::usleep(100);
+            }
+        }
+        qDebug() << label << (double)elapsed / NUM_EVENTS << "ns per event";
+    };
+
+    auto range = [] {
+        PROFILE_RANGE(test, "TestRange");
+    };
+    auto counter = [] {
+        PROFILE_COUNTER(test, "TestCounter", { { "value", 1 } });
+    };
+
+    measure("disabled range:", range);
+    measure("disabled counter:", counter);
+    tracer->startTracing();
+    measure("enabled range:", range);
+    measure("enabled counter:", counter);
+    tracer->stopTracing();
+    qDebug() << "dropped" << tracer->getNumDroppedEvents() << "events";
+}
@@ -15,6 +15,11 @@ class TraceTests : public QObject {
     Q_OBJECT
 private slots:
     void testTraceSerialization();
+    void testChromeExport();
+    void testRollingWindow();
+    void testStringArguments();
+    void testTextIDs();
+    void testEventOverhead();
 };
 
 #endif // hifi_TraceTests_h
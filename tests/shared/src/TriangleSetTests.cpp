@@ -0,0 +1,229 @@
+//
+//  TriangleSetTests.cpp
+//  tests/shared/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "TriangleSetTests.h"
+
+#include <limits>
+#include <random>
+#include <vector>
+
+#include <NumericalConstants.h>
+#include <TriangleSet.h>
+
+#include <../QTestExtensions.h>
+
+QTEST_MAIN(TriangleSetTests)
+
+// a unit sphere facing out, 2 * rings * segments triangles
+static std::vector<Triangle> makeSphere(int rings, int segments) {
+    auto vertex = [=](int ring, int segment) {
+        float polar = PI * ring / rings;
+        float azimuth = TWO_PI * segment / segments;
+        return glm::vec3(sinf(polar) * cosf(azimuth), cosf(polar), sinf(polar) * sinf(azimuth));
+    };
+
+    std::vector<Triangle> triangles;
+    for (int ring = 0; ring < rings; ring++) {
+        for (int segment = 0; segment < segments; segment++) {
+            glm::vec3 v0 = vertex(ring, segment);
+            glm::vec3 v1 = vertex(ring, segment + 1);
+            glm::vec3 v2 = vertex(ring + 1, segment + 1);
+            glm::vec3 v3 = vertex(ring + 1, segment);
+            triangles.push_back({ v0, v2, v1 });
+            triangles.push_back({ v0, v3, v2 });
+        }
+    }
+    return triangles;
+}
+
+static TriangleSet makeTriangleSet(const std::vector<Triangle>& triangles) {
+    TriangleSet triangleSet;
+    triangleSet.reserve(triangles.size());
+    for (const auto& triangle : triangles) {
+        triangleSet.insert(triangle);
+    }
+    triangleSet.build();
+    return triangleSet;
+}
+
+// rays from outside the sphere towards points near it, so most hit and some miss
+static std::vector<std::pair<glm::vec3, glm::vec3>> makeRays(int numRays) {
+    std::mt19937 generator(1);
+    std::uniform_real_distribution<float> random(-1.0f, 1.0f);
+
+    std::vector<std::pair<glm::vec3, glm::vec3>> rays;
+    for (int i = 0; i < numRays; i++) {
+        glm::vec3 origin = 3.0f * glm::normalize(glm::vec3(random(generator), random(generator), random(generator)));
+        glm::vec3 target = 1.2f * glm::vec3(random(generator), random(generator), random(generator));
+        rays.push_back({ origin, glm::normalize(target - origin) });
+    }
+    return rays;
+}
+
+// what Model did before it had a hierarchy to pick against
+static bool findLinearRayIntersection(const std::vector<Triangle>& triangles, const glm::vec3& origin,
+                                      const glm::vec3& direction, float& distance) {
+    bool intersectedSomething = false;
+    for (const auto& triangle : triangles) {
+        float thisTriangleDistance;
+        if (findRayTriangleIntersection(origin, direction, triangle, thisTriangleDistance) &&
+                thisTriangleDistance < distance) {
+            distance = thisTriangleDistance;
+            intersectedSomething = true;
+        }
+    }
+    return intersectedSomething;
+}
+
+const int NUM_RINGS = 256;
+const int NUM_SEGMENTS = 256; // 131072 triangles, a high poly model
+const int NUM_RAYS = 1000;
+
+void TriangleSetTests::testEmpty() {
+    TriangleSet triangleSet;
+    triangleSet.build();
+    QVERIFY(triangleSet.isEmpty());
+
+    float distance = std::numeric_limits<float>::max();
+    Triangle triangle;
+    QVERIFY(!triangleSet.findRayIntersection(glm::vec3(0.0f), glm::vec3(1.0f, 0.0f, 0.0f), distance, triangle));
+    QVERIFY(!triangleSet.convexHullContains(glm::vec3(0.0f)));
+}
+
+void TriangleSetTests::testMatchesLinearPick() {
+    auto triangles = makeSphere(32, 32);
+    TriangleSet triangleSet = makeTriangleSet(triangles);
+    QCOMPARE(triangleSet.size(), triangles.size());
+
+    int hits = 0;
+    for (const auto& ray : makeRays(NUM_RAYS)) {
+        float linearDistance = std::numeric_limits<float>::max();
+        bool linearHit = findLinearRayIntersection(triangles, ray.first, ray.second, linearDistance);
+
+        float distance = std::numeric_limits<float>::max();
+        Triangle triangle;
+        QCOMPARE(triangleSet.findRayIntersection(ray.first, ray.second, distance, triangle), linearHit);
+        if (linearHit) {
+            QCOMPARE(distance, linearDistance);
+            // the sphere faces out, so a ray from outside hits a triangle facing it
+            QVERIFY(glm::dot(triangle.getNormal(), ray.second) < 0.0f);
+            hits++;
+        }
+    }
+    QVERIFY(hits > 0 && hits < NUM_RAYS);
+}
+
+void TriangleSetTests::testMaxDistance() {
+    TriangleSet triangleSet = makeTriangleSet(makeSphere(16, 16));
+    glm::vec3 origin(0.01f, 0.02f, 3.0f); // off the vertex on the axis
+    glm::vec3 direction(0.0f, 0.0f, -1.0f);
+    Triangle triangle;
+
+    float distance = 1.5f;
+    QVERIFY(!triangleSet.findRayIntersection(origin, direction, distance, triangle));
+    QCOMPARE(distance, 1.5f);
+
+    distance = std::numeric_limits<float>::max();
+    QVERIFY(triangleSet.findRayIntersection(origin, direction, distance, triangle));
+    QCOMPARE_WITH_ABS_ERROR(distance, 2.0f, 0.01f);
+}
+
+// rays parallel to the box planes, with origins on them, take the slab test's infinite reciprocal path
+void TriangleSetTests::testAxisAlignedRays() {
+    // a bumpy grid of quads, so the hierarchy's boxes have planes on the grid lines
+    const int GRID_SIZE = 8;
+    auto height = [](int i, int j) { return 0.25f * (float)((i * 7 + j * 3) % 5); };
+    std::vector<Triangle> triangles;
+    for (int i = 0; i < GRID_SIZE; i++) {
+        for (int j = 0; j < GRID_SIZE; j++) {
+            glm::vec3 v0((float)i, height(i, j), (float)j);
+            glm::vec3 v1((float)(i + 1), height(i + 1, j), (float)j);
+            glm::vec3 v2((float)(i + 1), height(i + 1, j + 1), (float)(j + 1));
+            glm::vec3 v3((float)i, height(i, j + 1), (float)(j + 1));
+            triangles.push_back({ v0, v2, v1 });
+            triangles.push_back({ v0, v3, v2 });
+        }
+    }
+    TriangleSet triangleSet = makeTriangleSet(triangles);
+
+    int hits = 0;
+    const int STEPS_PER_CELL = 4;
+    for (int i = 0; i <= GRID_SIZE * STEPS_PER_CELL; i++) {
+        for (int j = 0; j <= GRID_SIZE * STEPS_PER_CELL; j++) {
+            glm::vec3 origin((float)i / STEPS_PER_CELL, 2.0f, (float)j / STEPS_PER_CELL);
+            // -0.0f has a reciprocal of -inf
+            for (const auto& direction : { glm::vec3(0.0f, -1.0f, 0.0f), glm::vec3(-0.0f, -1.0f, -0.0f) }) {
+                float linearDistance = std::numeric_limits<float>::max();
+                bool linearHit = findLinearRayIntersection(triangles, origin, direction, linearDistance);
+
+                float distance = std::numeric_limits<float>::max();
+                Triangle triangle;
+                QCOMPARE(triangleSet.findRayIntersection(origin, direction, distance, triangle), linearHit);
+                if (linearHit) {
+                    QCOMPARE(distance, linearDistance);
+                    hits++;
+                }
+            }
+        }
+    }
+    QVERIFY(hits > 0);
+
+    // along the grid's edge and its top and bottom planes, where the origin is on the root box
+    float maxHeight = 1.0f;
+    for (const auto& origin : { glm::vec3(-1.0f, 0.5f, 0.0f), glm::vec3(-1.0f, 0.0f, 0.5f), glm::vec3(-1.0f, maxHeight, 4.5f) }) {
+        glm::vec3 direction(1.0f, 0.0f, 0.0f);
+        float linearDistance = std::numeric_limits<float>::max();
+        bool linearHit = findLinearRayIntersection(triangles, origin, direction, linearDistance);
+        float distance = std::numeric_limits<float>::max();
+        Triangle triangle;
+        QCOMPARE(triangleSet.findRayIntersection(origin, direction, distance, triangle), linearHit);
+    }
+}
+
+void TriangleSetTests::testConvexHullContains() {
+    TriangleSet triangleSet = makeTriangleSet(makeSphere(16, 16));
+    QVERIFY(triangleSet.convexHullContains(glm::vec3(0.0f)));
+    QVERIFY(triangleSet.convexHullContains(glm::vec3(0.5f, 0.5f, 0.0f)));
+    QVERIFY(!triangleSet.convexHullContains(glm::vec3(0.0f, 1.5f, 0.0f)));
+}
+
+void TriangleSetTests::benchmarkBuild() {
+    auto triangles = makeSphere(NUM_RINGS, NUM_SEGMENTS);
+
+    QBENCHMARK {
+        makeTriangleSet(triangles);
+    }
+}
+
+// picks per second on a high poly model is NUM_RAYS over the time per iteration, against and without the hierarchy
+void TriangleSetTests::benchmarkPick() {
+    TriangleSet triangleSet = makeTriangleSet(makeSphere(NUM_RINGS, NUM_SEGMENTS));
+    auto rays = makeRays(NUM_RAYS);
+
+    QBENCHMARK {
+        for (const auto& ray : rays) {
+            float distance = std::numeric_limits<float>::max();
+            Triangle triangle;
+            triangleSet.findRayIntersection(ray.first, ray.second, distance, triangle);
+        }
+    }
+}
+
+void TriangleSetTests::benchmarkLinearPick() {
+    auto triangles = makeSphere(NUM_RINGS, NUM_SEGMENTS);
+    auto rays = makeRays(NUM_RAYS);
+
+    QBENCHMARK {
+        for (const auto& ray : rays) {
+            float distance = std::numeric_limits<float>::max();
+            findLinearRayIntersection(triangles, ray.first, ray.second, distance);
+        }
+    }
+}
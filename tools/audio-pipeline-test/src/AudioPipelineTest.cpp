@@ -0,0 +1,490 @@
+//
+//  AudioPipelineTest.cpp
+//  tools/audio-pipeline-test/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioPipelineTest.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+#ifdef Q_OS_WIN
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+#include <QtCore/QCommandLineParser>
+#include <QtCore/QDebug>
+#include <QtCore/QFile>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QStandardPaths>
+
+#include <AccountManager.h>
+#include <AddressManager.h>
+#include <AudioClient.h>
+#include <AudioConstants.h>
+#include <DependencyManager.h>
+#include <DomainHandler.h>
+#include <LogHandler.h>
+#include <NodeList.h>
+#include <NumericalConstants.h>
+#include <SettingHandle.h>
+#include <SharedUtil.h>
+
+const QCommandLineOption DOMAIN_OPTION {
+    "d", "domain-server address (default is 127.0.0.1:" + QString::number(DEFAULT_DOMAIN_SERVER_PORT) + ")", "IP:PORT"
+};
+const QCommandLineOption INPUT_OPTION {
+    "input", "bursts, tone, noise, silence, or a 16-bit WAV or raw file in the input format (default is bursts)", "source"
+};
+const QCommandLineOption OUTPUT_OPTION { "output", "write the output to this raw 16-bit file", "file" };
+const QCommandLineOption INPUT_RATE_OPTION { "input-rate", "input sample rate (default is 48000)", "hz" };
+const QCommandLineOption OUTPUT_RATE_OPTION { "output-rate", "output sample rate (default is 48000)", "hz" };
+const QCommandLineOption OUTPUT_CHANNELS_OPTION { "output-channels", "output channels (default is 2)", "channels" };
+const QCommandLineOption PERIOD_OPTION {
+    "period", "device period (default is " + QString::number(VirtualAudioDevice::DEFAULT_PERIOD_USECS) + ")", "usecs"
+};
+const QCommandLineOption LAUNCH_OPTION {
+    "launch", "start a domain-server and an audio mixer from this build directory", "path"
+};
+const QCommandLineOption DURATION_OPTION { "t", "seconds to run for (default is 30)", "seconds" };
+const QCommandLineOption REPORT_OPTION { "report", "write the samples and a summary to this JSON file at the end", "file" };
+
+const int STATS_INTERVAL_MSECS = 1000;
+
+// a burst of tone every second, long enough to pass the noise gate and any codec, loud enough to find again
+const float BURST_FREQUENCY = 1000.0f;
+const float BURST_AMPLITUDE = 0.25f;
+const quint64 BURST_USECS = 100 * USECS_PER_MSEC;
+const quint64 BURST_INTERVAL_USECS = USECS_PER_SECOND;
+const float BURST_THRESHOLD = 0.05f * AudioConstants::MAX_SAMPLE_VALUE;
+
+namespace {
+
+// CPU time of the calling thread
+quint64 threadCPUUsecs() {
+#ifdef Q_OS_WIN
+    FILETIME creation, exit, kernel, user;
+    GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user);
+    auto toUsecs = [](const FILETIME& time) {
+        const quint64 FILETIME_UNITS_PER_USEC = 10;
+        return (((quint64)time.dwHighDateTime << 32) | time.dwLowDateTime) / FILETIME_UNITS_PER_USEC;
+    };
+    return toUsecs(kernel) + toUsecs(user);
+#else
+    timespec time;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+    return (quint64)time.tv_sec * USECS_PER_SECOND + (quint64)time.tv_nsec / NSECS_PER_USEC;
+#endif
+}
+
+// finds the start of each burst in the output, after at least half an interval of quiet
+class BurstDetector : public VirtualAudioSink {
+public:
+    BurstDetector(int quietFrames, std::function<void(quint64 frame)> onBurst, std::unique_ptr<VirtualAudioSink> sink) :
+        _quietFrames(quietFrames), _onBurst(onBurst), _sink(std::move(sink)) {}
+
+    void write(const int16_t* samples, int numFrames, int numChannels) override {
+        for (int i = 0; i < numFrames; ++i, ++_frame) {
+            bool isLoud = false;
+            for (int channel = 0; channel < numChannels; ++channel) {
+                isLoud = isLoud || std::abs(samples[i * numChannels + channel]) > BURST_THRESHOLD;
+            }
+            if (isLoud) {
+                if (!_hasBeenLoud || _frame - _lastLoudFrame >= (quint64)_quietFrames) {
+                    _onBurst(_frame);
+                }
+                _lastLoudFrame = _frame;
+                _hasBeenLoud = true;
+            }
+        }
+        if (_sink) {
+            _sink->write(samples, numFrames, numChannels);
+        }
+    }
+
+private:
+    int _quietFrames;
+    std::function<void(quint64 frame)> _onBurst;
+    std::unique_ptr<VirtualAudioSink> _sink;
+    quint64 _frame { 0 };
+    quint64 _lastLoudFrame { 0 };
+    bool _hasBeenLoud { false };
+};
+
+float percentile(std::vector<float> values, float fraction) {
+    if (values.empty()) {
+        return 0.0f;
+    }
+    auto nth = values.begin() + (size_t)(fraction * (values.size() - 1));
+    std::nth_element(values.begin(), nth, values.end());
+    return *nth;
+}
+
+float average(const std::vector<float>& values) {
+    if (values.empty()) {
+        return 0.0f;
+    }
+    double sum = 0.0;
+    for (float value : values) {
+        sum += value;
+    }
+    return (float)(sum / values.size());
+}
+
+QJsonObject summarize(const std::vector<float>& values) {
+    QJsonObject summary;
+    summary["avg"] = average(values);
+    summary["p50"] = percentile(values, 0.5f);
+    summary["p99"] = percentile(values, 0.99f);
+    summary["max"] = values.empty() ? 0.0f : *std::max_element(values.begin(), values.end());
+    return summary;
+}
+
+}
+
+AudioPipelineTest::AudioPipelineTest(int& argc, char** argv) :
+    QCoreApplication(argc, argv)
+{
+    qInstallMessageHandler(LogHandler::verboseMessageHandler);
+
+    parseArguments();
+
+    Setting::init();
+    DependencyManager::registerInheritance<LimitedNodeList, NodeList>();
+    DependencyManager::set<AccountManager>([&]{ return QString("Mozilla/5.0 (HighFidelityAudioPipelineTest)"); });
+    DependencyManager::set<AddressManager>();
+    DependencyManager::set<NodeList>(NodeType::Agent);
+
+    auto nodeList = DependencyManager::get<NodeList>();
+
+    QThread* nodeThread = new QThread(this);
+    nodeThread->setObjectName("NodeList Thread");
+    nodeThread->start();
+    nodeThread->setPriority(QThread::TimeCriticalPriority);
+
+    QTimer* domainCheckInTimer = new QTimer(nodeList.data());
+    connect(domainCheckInTimer, &QTimer::timeout, nodeList.data(), &NodeList::sendDomainServerCheckIn);
+    domainCheckInTimer->start(DOMAIN_SERVER_CHECK_IN_MSECS);
+    nodeList->moveToThread(nodeThread);
+
+    connect(nodeList.data(), &NodeList::nodeActivated, this, &AudioPipelineTest::nodeActivated);
+    connect(nodeList.data(), &NodeList::nodeKilled, this, &AudioPipelineTest::nodeKilled);
+    nodeList->addSetOfNodeTypesToNodeInterestSet(NodeSet() << NodeType::AudioMixer);
+
+    startAudio();
+
+    DependencyManager::get<AddressManager>()->handleLookupString(_domainServerAddress, false);
+
+    connect(&_statsTimer, &QTimer::timeout, this, &AudioPipelineTest::sampleStats);
+    _statsTimer.start(STATS_INTERVAL_MSECS);
+    _runTimer.start();
+
+    qDebug() << "Running the client audio pipeline against" << _domainServerAddress << "for" << _durationSeconds << "seconds";
+    qDebug() << "Latency avg/p99 (ms) | Audio thread CPU per frame avg/p99 (us) | Callbacks per frame avg/p99 (us)"
+        << "| Underrun frames";
+}
+
+AudioPipelineTest::~AudioPipelineTest() {
+    // stop the pipeline on its own thread, the thread quits once the client is gone, then the device can go
+    DependencyManager::get<AudioClient>()->beforeAboutToQuit();
+    QMetaObject::invokeMethod(DependencyManager::get<AudioClient>().data(), "stop", Qt::BlockingQueuedConnection);
+    DependencyManager::destroy<AudioClient>();
+    _audioThread->wait();
+    _device.reset();
+
+    // send the domain a disconnect packet, force stoppage of domain-server check-ins
+    auto nodeList = DependencyManager::get<NodeList>();
+    nodeList->getDomainHandler().disconnect();
+    nodeList->setIsShuttingDown(true);
+    nodeList->getPacketReceiver().setShouldDropPackets(true);
+
+    QThread* nodeThread = nodeList->thread();
+    nodeList.reset();
+    DependencyManager::destroy<NodeList>();
+    nodeThread->quit();
+    nodeThread->wait();
+
+    for (auto& server : _servers) {
+        server->terminate();
+        const int SERVER_EXIT_WAIT_MSECS = 3000;
+        if (!server->waitForFinished(SERVER_EXIT_WAIT_MSECS)) {
+            server->kill();
+        }
+    }
+}
+
+void AudioPipelineTest::parseArguments() {
+    QCommandLineParser parser;
+    parser.setApplicationDescription("High Fidelity client audio pipeline test");
+    const QCommandLineOption helpOption = parser.addHelpOption();
+    parser.addOptions({ DOMAIN_OPTION, INPUT_OPTION, OUTPUT_OPTION, INPUT_RATE_OPTION, OUTPUT_RATE_OPTION,
+                        OUTPUT_CHANNELS_OPTION, PERIOD_OPTION, LAUNCH_OPTION, DURATION_OPTION, REPORT_OPTION });
+
+    if (!parser.parse(arguments())) {
+        qCritical() << parser.errorText() << endl;
+        parser.showHelp();
+        Q_UNREACHABLE();
+    }
+
+    if (parser.isSet(helpOption)) {
+        parser.showHelp();
+        Q_UNREACHABLE();
+    }
+
+    _domainServerAddress = "127.0.0.1:" + QString::number(DEFAULT_DOMAIN_SERVER_PORT);
+    if (parser.isSet(DOMAIN_OPTION)) {
+        _domainServerAddress = parser.value(DOMAIN_OPTION);
+    }
+    _input = parser.isSet(INPUT_OPTION) ? parser.value(INPUT_OPTION) : "bursts";
+    _outputPath = parser.value(OUTPUT_OPTION);
+    if (parser.isSet(INPUT_RATE_OPTION)) {
+        _inputSampleRate = std::max(parser.value(INPUT_RATE_OPTION).toInt(), 8000);
+    }
+    if (parser.isSet(OUTPUT_RATE_OPTION)) {
+        _outputSampleRate = std::max(parser.value(OUTPUT_RATE_OPTION).toInt(), 8000);
+    }
+    if (parser.isSet(OUTPUT_CHANNELS_OPTION)) {
+        const int MAX_OUTPUT_CHANNELS = 8;
+        _outputChannels = std::min(std::max(parser.value(OUTPUT_CHANNELS_OPTION).toInt(), 1), MAX_OUTPUT_CHANNELS);
+    }
+    if (parser.isSet(PERIOD_OPTION)) {
+        _periodUsecs = std::max(parser.value(PERIOD_OPTION).toInt(), (int)USECS_PER_MSEC);
+    }
+    if (parser.isSet(DURATION_OPTION)) {
+        _durationSeconds = std::max(parser.value(DURATION_OPTION).toInt(), 1);
+    }
+    _reportPath = parser.value(REPORT_OPTION);
+
+    if (parser.isSet(LAUNCH_OPTION)) {
+        launchServers(parser.value(LAUNCH_OPTION));
+    }
+}
+
+void AudioPipelineTest::launchServers(const QString& buildPath) {
+    auto findServer = [&](const QString& name) {
+        QStringList paths { buildPath + "/" + name, buildPath + "/" + name + "/Release",
+                            buildPath + "/" + name + "/RelWithDebInfo", buildPath };
+        return QStandardPaths::findExecutable(name, paths);
+    };
+
+    QString domainServerPath = findServer("domain-server");
+    QString assignmentClientPath = findServer("assignment-client");
+    if (domainServerPath.isEmpty() || assignmentClientPath.isEmpty()) {
+        qCritical() << "Could not find the domain-server and assignment-client in" << buildPath;
+        ::exit(EXIT_FAILURE);
+    }
+
+    auto launch = [&](const QString& path, const QStringList& arguments) {
+        std::unique_ptr<QProcess> server(new QProcess());
+        server->setStandardOutputFile(QProcess::nullDevice());
+        server->setStandardErrorFile(QProcess::nullDevice());
+        server->start(path, arguments);
+        _servers.push_back(std::move(server));
+    };
+
+    const QString AUDIO_MIXER_TYPE = "0";
+    launch(domainServerPath, {});
+    launch(assignmentClientPath, { "-t", AUDIO_MIXER_TYPE });
+
+    qDebug() << "Launched" << domainServerPath << "and an audio mixer";
+}
+
+void AudioPipelineTest::startAudio() {
+    const int INPUT_CHANNELS = 1;
+    _device.reset(new VirtualAudioDevice(_inputSampleRate, INPUT_CHANNELS, _outputSampleRate, _outputChannels, _periodUsecs));
+
+    std::unique_ptr<VirtualAudioSource> source;
+    if (_input == "bursts") {
+        _burstIntervalUsecs = BURST_INTERVAL_USECS;
+        source.reset(new ToneAudioSource(_inputSampleRate, BURST_FREQUENCY, BURST_AMPLITUDE,
+                                         (int)(BURST_USECS * _inputSampleRate / USECS_PER_SECOND),
+                                         (int)(BURST_INTERVAL_USECS * _inputSampleRate / USECS_PER_SECOND)));
+    } else if (_input == "tone") {
+        source.reset(new ToneAudioSource(_inputSampleRate, BURST_FREQUENCY, BURST_AMPLITUDE));
+    } else if (_input == "noise") {
+        source.reset(new NoiseAudioSource(BURST_AMPLITUDE));
+    } else if (_input != "silence") {
+        std::unique_ptr<FileAudioSource> fileSource(new FileAudioSource(_input));
+        if (!fileSource->isValid()) {
+            ::exit(EXIT_FAILURE);
+        }
+        source = std::move(fileSource);
+    }
+    _device->setSource(std::move(source));
+
+    std::unique_ptr<VirtualAudioSink> sink;
+    if (!_outputPath.isEmpty()) {
+        std::unique_ptr<FileAudioSink> fileSink(new FileAudioSink(_outputPath));
+        if (!fileSink->isValid()) {
+            ::exit(EXIT_FAILURE);
+        }
+        sink = std::move(fileSink);
+    }
+    if (_burstIntervalUsecs > 0) {
+        int quietFrames = (int)(_burstIntervalUsecs / 2 * _outputSampleRate / USECS_PER_SECOND);
+        sink.reset(new BurstDetector(quietFrames, [this](quint64 frame) { onBurstPlayed(frame); }, std::move(sink)));
+    }
+    _device->setSink(std::move(sink));
+    _device->setPeriodListener([this](const VirtualAudioDevice::Period& period) { onPeriod(period); });
+
+    // the pipeline and its device run on the audio thread, as in the interface
+    DependencyManager::set<AudioClient>();
+    auto audioClient = DependencyManager::get<AudioClient>();
+    audioClient->loadSettings();
+    if (_burstIntervalUsecs > 0) {
+        // the mixer sends our own audio back, to time the round trip
+        audioClient->toggleServerEcho();
+    }
+
+    _audioThread = new QThread(this);
+    _audioThread->setObjectName("Audio Thread");
+    audioClient->moveToThread(_audioThread);
+    _device->moveToThread(_audioThread);
+
+    AudioClient* audio = audioClient.data();
+    VirtualAudioDevice* device = _device.get();
+    connect(_audioThread, &QThread::started, audio, [audio, device] {
+        audio->switchToVirtualAudioDevice(device);
+    });
+    // direct, quit() is thread-safe and the main thread is waiting on it
+    connect(audio, &AudioClient::destroyed, _audioThread, &QThread::quit, Qt::DirectConnection);
+    _audioThread->start();
+}
+
+void AudioPipelineTest::nodeActivated(SharedNodePointer node) {
+    if (node->getType() == NodeType::AudioMixer) {
+        qDebug() << "Connected to the audio mixer at" << node->getPublicSocket();
+        DependencyManager::get<AudioClient>()->negotiateAudioFormat();
+    }
+}
+
+void AudioPipelineTest::nodeKilled(SharedNodePointer node) {
+    if (node->getType() == NodeType::AudioMixer) {
+        qDebug() << "Lost the audio mixer";
+        QMetaObject::invokeMethod(DependencyManager::get<AudioClient>().data(), "audioMixerKilled");
+    }
+}
+
+// on the audio thread
+void AudioPipelineTest::onPeriod(const VirtualAudioDevice::Period& period) {
+    quint64 cpuUsecs = threadCPUUsecs();
+    quint64 elapsedUsecs = period.timestampUsecs - _lastPeriodUsecs;
+    quint64 cpuElapsedUsecs = cpuUsecs - _lastThreadCPUUsecs;
+    bool isFirstPeriod = _lastPeriodUsecs == 0;
+    _lastPeriodUsecs = period.timestampUsecs;
+    _lastThreadCPUUsecs = cpuUsecs;
+    if (isFirstPeriod || elapsedUsecs == 0) {
+        return;
+    }
+
+    // everything on the audio thread since the last period - input, packets received, output - per network frame
+    float framesElapsed = (float)elapsedUsecs / AudioConstants::NETWORK_FRAME_USECS;
+    std::lock_guard<std::mutex> lock(_measurementsMutex);
+    _measurements.cpuUsecsPerFrame.push_back(cpuElapsedUsecs / framesElapsed);
+    _measurements.callbackUsecsPerFrame.push_back((period.inputUsecs + period.outputUsecs) / framesElapsed);
+    _measurements.underrunFrames += period.underrunFrames;
+}
+
+// on the audio thread
+void AudioPipelineTest::onBurstPlayed(quint64 frame) {
+    // the bursts start every interval from the first frame captured, so this one is from the last start before it
+    quint64 playedUsecs = _device->getOutputStartUsecs() + frame * USECS_PER_SECOND / _outputSampleRate;
+    quint64 inputStartUsecs = _device->getInputStartUsecs();
+    if (playedUsecs < inputStartUsecs) {
+        return;
+    }
+    quint64 latencyUsecs = (playedUsecs - inputStartUsecs) % _burstIntervalUsecs;
+
+    std::lock_guard<std::mutex> lock(_measurementsMutex);
+    _measurements.latencyMsecs.push_back((float)latencyUsecs / USECS_PER_MSEC);
+}
+
+void AudioPipelineTest::sampleStats() {
+    Measurements measurements;
+    {
+        std::lock_guard<std::mutex> lock(_measurementsMutex);
+        std::swap(measurements, _measurements);
+    }
+
+    auto append = [](std::vector<float>& all, const std::vector<float>& values) {
+        all.insert(all.end(), values.begin(), values.end());
+    };
+    append(_allMeasurements.latencyMsecs, measurements.latencyMsecs);
+    append(_allMeasurements.cpuUsecsPerFrame, measurements.cpuUsecsPerFrame);
+    append(_allMeasurements.callbackUsecsPerFrame, measurements.callbackUsecsPerFrame);
+    _allMeasurements.underrunFrames += measurements.underrunFrames;
+
+    QJsonObject latency = summarize(measurements.latencyMsecs);
+    QJsonObject cpu = summarize(measurements.cpuUsecsPerFrame);
+    QJsonObject callbacks = summarize(measurements.callbackUsecsPerFrame);
+
+    qDebug() << latency["avg"].toDouble() << "/" << latency["p99"].toDouble()
+        << "|" << cpu["avg"].toDouble() << "/" << cpu["p99"].toDouble()
+        << "|" << callbacks["avg"].toDouble() << "/" << callbacks["p99"].toDouble()
+        << "|" << measurements.underrunFrames;
+
+    QJsonObject sample;
+    sample["seconds"] = (double)_runTimer.elapsed() / MSECS_PER_SECOND;
+    sample["bursts"] = (int)measurements.latencyMsecs.size();
+    sample["latency_ms"] = latency;
+    sample["cpu_us_per_frame"] = cpu;
+    sample["callback_us_per_frame"] = callbacks;
+    sample["underrun_frames"] = measurements.underrunFrames;
+    _samples.append(sample);
+
+    if (_runTimer.elapsed() >= (qint64)_durationSeconds * (qint64)MSECS_PER_SECOND) {
+        finish();
+    }
+}
+
+void AudioPipelineTest::finish() {
+    _statsTimer.stop();
+
+    QJsonObject latency = summarize(_allMeasurements.latencyMsecs);
+    QJsonObject cpu = summarize(_allMeasurements.cpuUsecsPerFrame);
+    qDebug() << "End to end latency (ms) avg/p50/p99/max:" << latency["avg"].toDouble() << "/" << latency["p50"].toDouble()
+        << "/" << latency["p99"].toDouble() << "/" << latency["max"].toDouble()
+        << "over" << _allMeasurements.latencyMsecs.size() << "bursts";
+    qDebug() << "Audio thread CPU per frame (us) avg/p99/max:" << cpu["avg"].toDouble() << "/" << cpu["p99"].toDouble()
+        << "/" << cpu["max"].toDouble();
+
+    if (!_reportPath.isEmpty()) {
+        QJsonObject summary;
+        summary["bursts"] = (int)_allMeasurements.latencyMsecs.size();
+        summary["latency_ms"] = latency;
+        summary["cpu_us_per_frame"] = cpu;
+        summary["callback_us_per_frame"] = summarize(_allMeasurements.callbackUsecsPerFrame);
+        summary["underrun_frames"] = _allMeasurements.underrunFrames;
+
+        QJsonObject config;
+        config["input"] = _input;
+        config["input_rate"] = _inputSampleRate;
+        config["output_rate"] = _outputSampleRate;
+        config["output_channels"] = _outputChannels;
+        config["period_us"] = _periodUsecs;
+
+        QJsonObject report;
+        report["config"] = config;
+        report["summary"] = summary;
+        report["samples"] = _samples;
+
+        QFile reportFile(_reportPath);
+        if (reportFile.open(QIODevice::WriteOnly)) {
+            reportFile.write(QJsonDocument(report).toJson());
+            qDebug() << "Wrote the report to" << _reportPath;
+        } else {
+            qWarning() << "Could not write the report to" << _reportPath;
+        }
+    }
+
+    quit();
+}
@@ -0,0 +1,87 @@
+//
+//  AudioPipelineTest.h
+//  tools/audio-pipeline-test/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_AudioPipelineTest_h
+#define hifi_AudioPipelineTest_h
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QJsonArray>
+#include <QtCore/QProcess>
+#include <QtCore/QThread>
+#include <QtCore/QTimer>
+
+#include <Node.h>
+#include <VirtualAudioDevice.h>
+
+// Runs the full client audio pipeline - AudioClient's input, codec and network path up, and its network, reverb,
+// injector and limiter path down - against a domain's audio mixer, on a VirtualAudioDevice instead of a sound card.
+// The input is tone bursts the mixer echoes back, so the time from a burst going in to it coming out is the end to end
+// latency, on the device's clock. It reports that and the audio thread's CPU time per network frame.
+class AudioPipelineTest : public QCoreApplication {
+    Q_OBJECT
+public:
+    AudioPipelineTest(int& argc, char** argv);
+    ~AudioPipelineTest();
+
+private slots:
+    void nodeActivated(SharedNodePointer node);
+    void nodeKilled(SharedNodePointer node);
+    void sampleStats();
+
+private:
+    // filled on the audio thread, taken on this one
+    struct Measurements {
+        std::vector<float> latencyMsecs;
+        std::vector<float> cpuUsecsPerFrame; // audio thread CPU time, per network frame
+        std::vector<float> callbackUsecsPerFrame; // in the device callbacks, per network frame
+        int underrunFrames { 0 };
+    };
+
+    void parseArguments();
+    void launchServers(const QString& buildPath);
+    void startAudio();
+    void onPeriod(const VirtualAudioDevice::Period& period);
+    void onBurstPlayed(quint64 frame);
+    void finish();
+
+    QString _domainServerAddress;
+    QString _input;
+    QString _outputPath;
+    int _inputSampleRate { 48000 };
+    int _outputSampleRate { 48000 };
+    int _outputChannels { 2 };
+    int _periodUsecs { VirtualAudioDevice::DEFAULT_PERIOD_USECS };
+    int _durationSeconds { 30 };
+    QString _reportPath;
+
+    QThread* _audioThread { nullptr };
+    std::unique_ptr<VirtualAudioDevice> _device;
+    quint64 _burstIntervalUsecs { 0 };
+    quint64 _lastThreadCPUUsecs { 0 };
+    quint64 _lastPeriodUsecs { 0 };
+
+    std::mutex _measurementsMutex;
+    Measurements _measurements;
+    Measurements _allMeasurements;
+
+    QTimer _statsTimer;
+    QElapsedTimer _runTimer;
+    std::vector<std::unique_ptr<QProcess>> _servers;
+    QJsonArray _samples;
+};
+
+#endif // hifi_AudioPipelineTest_h
@@ -0,0 +1,337 @@
+//
+//  DomainLoadTest.cpp
+//  tools/domain-load-test/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "DomainLoadTest.h"
+
+#include <algorithm>
+
+#include <QtCore/QCommandLineParser>
+#include <QtCore/QDataStream>
+#include <QtCore/QDebug>
+
+#include <DomainHandler.h>
+#include <LimitedNodeList.h>
+#include <LogHandler.h>
+#include <NLPacket.h>
+#include <NodePermissions.h>
+#include <NodeType.h>
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+#include <udt/PacketHeaders.h>
+
+const QCommandLineOption DOMAIN_OPTION {
+    "d", "domain-server address (default is 127.0.0.1:" + QString::number(DEFAULT_DOMAIN_SERVER_PORT) + ")", "IP:PORT"
+};
+const QCommandLineOption NODES_OPTION { "n", "number of simulated agents (default is 100)", "nodes" };
+const QCommandLineOption RATE_OPTION { "r", "domain list requests per second across all agents (default is 100)", "rate" };
+const QCommandLineOption CHURN_OPTION { "churn", "agents that disconnect and reconnect per second (default is 0)", "agents" };
+const QCommandLineOption DURATION_OPTION { "t", "seconds to run for (default is until stopped)", "seconds" };
+const QCommandLineOption FULL_OPTION { "full", "always ask for a full domain list, to compare against deltas" };
+const QCommandLineOption STORM_OPTION { "storm", "all agents ask to connect at once, instead of one at a time" };
+
+const int SEND_INTERVAL_MSECS = 10;
+const int STATS_INTERVAL_MSECS = 1000;
+const quint64 CONNECT_RETRY_USECS = USECS_PER_SECOND;
+
+DomainLoadTest::DomainLoadTest(int& argc, char** argv) :
+    QCoreApplication(argc, argv)
+{
+    qInstallMessageHandler(LogHandler::verboseMessageHandler);
+
+    parseArguments();
+
+    _socket.bind(QHostAddress::AnyIPv4);
+    _publicSockAddr = HifiSockAddr(QHostAddress::LocalHost, _socket.localPort());
+
+    _socket.setPacketHandler([this](std::unique_ptr<udt::Packet> packet) {
+        handlePacket(std::move(packet));
+    });
+    _socket.setMessageHandler([this](std::unique_ptr<udt::Packet> packet) {
+        handleMessagePacket(std::move(packet));
+    });
+    _socket.setMessageFailureHandler([this](HifiSockAddr from, udt::Packet::MessageNumber messageNumber) {
+        _pendingMessages.erase(messageNumber);
+    });
+
+    _nodes.resize(_numNodes);
+    for (int i = 0; i < _numNodes; ++i) {
+        // every agent looks like its own machine, so the domain-server does not match them up
+        _nodes[i].hardwareAddress = QString("02:00:%1:%2:%3:%4")
+            .arg((i >> 24) & 0xFF, 2, 16, QChar('0')).arg((i >> 16) & 0xFF, 2, 16, QChar('0'))
+            .arg((i >> 8) & 0xFF, 2, 16, QChar('0')).arg(i & 0xFF, 2, 16, QChar('0'));
+        _nodes[i].machineFingerprint = QUuid::createUuid();
+
+        // the domain-server takes a connect request with the same sockets as an existing node to be that node
+        _nodes[i].localSockAddr = HifiSockAddr(QHostAddress(0x0A000001 + i), _socket.localPort());
+    }
+
+    // each agent has to check in more often than the domain-server's silence threshold
+    float secondsBetweenCheckIns = _numNodes / _checkInsPerSecond;
+    if (secondsBetweenCheckIns * MSECS_PER_SECOND >= NODE_SILENCE_THRESHOLD_MSECS) {
+        qWarning() << "Each agent only checks in every" << secondsBetweenCheckIns << "seconds,"
+            << "the domain-server will time them out - raise the rate or lower the number of agents";
+    }
+
+    connect(&_sendTimer, &QTimer::timeout, this, &DomainLoadTest::sendPackets);
+    _sendTimer.start(SEND_INTERVAL_MSECS);
+
+    connect(&_statsTimer, &QTimer::timeout, this, &DomainLoadTest::printStats);
+    _statsTimer.start(STATS_INTERVAL_MSECS);
+
+    _runTimer.start();
+
+    qDebug() << "Simulating" << _numNodes << "agents against" << _domainServerSockAddr
+        << "at" << _checkInsPerSecond << "check ins per second" << (_alwaysFullLists ? "with full lists" : "");
+    qDebug() << "Agents | Connecting | Avg admit (ms) | Check ins | Full lists | Delta lists | Bytes/list"
+        << "| Avg latency (ms) | Max latency (ms)";
+}
+
+void DomainLoadTest::parseArguments() {
+    QCommandLineParser parser;
+    parser.setApplicationDescription("High Fidelity domain-server load test");
+    const QCommandLineOption helpOption = parser.addHelpOption();
+    parser.addOptions({ DOMAIN_OPTION, NODES_OPTION, RATE_OPTION, CHURN_OPTION, DURATION_OPTION, FULL_OPTION, STORM_OPTION });
+
+    if (!parser.parse(arguments())) {
+        qCritical() << parser.errorText() << endl;
+        parser.showHelp();
+        Q_UNREACHABLE();
+    }
+
+    if (parser.isSet(helpOption)) {
+        parser.showHelp();
+        Q_UNREACHABLE();
+    }
+
+    QString domainServerAddress = "127.0.0.1";
+    quint16 domainServerPort = DEFAULT_DOMAIN_SERVER_PORT;
+    if (parser.isSet(DOMAIN_OPTION)) {
+        QStringList parts = parser.value(DOMAIN_OPTION).split(':');
+        domainServerAddress = parts[0];
+        if (parts.size() > 1) {
+            domainServerPort = parts[1].toUShort();
+        }
+    }
+    _domainServerSockAddr = HifiSockAddr(domainServerAddress, domainServerPort, true);
+
+    if (parser.isSet(NODES_OPTION)) {
+        _numNodes = std::max(parser.value(NODES_OPTION).toInt(), 1);
+    }
+    if (parser.isSet(RATE_OPTION)) {
+        _checkInsPerSecond = std::max(parser.value(RATE_OPTION).toFloat(), 1.0f);
+    }
+    if (parser.isSet(CHURN_OPTION)) {
+        _churnPerSecond = parser.value(CHURN_OPTION).toInt();
+    }
+    if (parser.isSet(DURATION_OPTION)) {
+        _durationSeconds = parser.value(DURATION_OPTION).toInt();
+    }
+    _alwaysFullLists = parser.isSet(FULL_OPTION);
+    _isStorm = parser.isSet(STORM_OPTION);
+}
+
+void DomainLoadTest::sendPackets() {
+    quint64 now = usecTimestampNow();
+
+    // in a storm every agent that is out asks to connect, otherwise the next one asks once the last is in
+    for (int i = 0; i < _numNodes && (_isStorm || _connectingNodes.empty()); ++i) {
+        if (_nodes[i].sessionUUID.isNull() && _nodes[i].firstConnectUsecs == 0) {
+            _nodes[i].firstConnectUsecs = now;
+            _connectingNodes.push_back(i);
+        }
+    }
+
+    // retry the way a client does, until the domain-server lets them in
+    for (int nodeIndex : _connectingNodes) {
+        if (now - _nodes[nodeIndex].lastConnectUsecs > CONNECT_RETRY_USECS) {
+            sendConnectRequest(nodeIndex);
+        }
+    }
+
+    if (_nodeIndices.isEmpty()) {
+        return;
+    }
+
+    // spread the list requests evenly over the connected agents
+    _checkInsOwed += _checkInsPerSecond * SEND_INTERVAL_MSECS / MSECS_PER_SECOND;
+    size_t numChecked = 0;
+    while (_checkInsOwed >= 1.0f && numChecked < _nodes.size()) {
+        auto& node = _nodes[_nextCheckInIndex];
+        _nextCheckInIndex = (_nextCheckInIndex + 1) % _nodes.size();
+        ++numChecked;
+
+        if (!node.sessionUUID.isNull()) {
+            sendListRequest(node);
+            _checkInsOwed -= 1.0f;
+            numChecked = 0;
+        }
+    }
+    _checkInsOwed = std::min(_checkInsOwed, 1.0f);
+}
+
+void DomainLoadTest::sendConnectRequest(int nodeIndex) {
+    auto& node = _nodes[nodeIndex];
+
+    auto packet = NLPacket::create(PacketType::DomainConnectRequest);
+    QDataStream packetStream(packet.get());
+
+    packetStream << QUuid();
+
+    QByteArray protocolVersionSig = protocolVersionsSignature();
+    packetStream.writeBytes(protocolVersionSig.constData(), protocolVersionSig.size());
+
+    packetStream << node.hardwareAddress << node.machineFingerprint;
+
+    QList<NodeType_t> interestList { NodeType::AudioMixer, NodeType::AvatarMixer, NodeType::EntityServer,
+        NodeType::AssetServer, NodeType::MessagesMixer };
+    packetStream << NodeType::Agent << _publicSockAddr << node.localSockAddr << interestList << QString();
+
+    // an anonymous agent
+    packetStream << QString();
+
+    node.lastConnectUsecs = usecTimestampNow();
+    _socket.writePacket(std::move(packet), _domainServerSockAddr);
+}
+
+void DomainLoadTest::sendListRequest(SimulatedNode& node) {
+    auto packet = NLPacket::create(PacketType::DomainListRequest);
+    packet->writeSourceID(node.sessionUUID);
+
+    QDataStream packetStream(packet.get());
+
+    QList<NodeType_t> interestList { NodeType::AudioMixer, NodeType::AvatarMixer, NodeType::EntityServer,
+        NodeType::AssetServer, NodeType::MessagesMixer };
+    packetStream << NodeType::Agent << _publicSockAddr << node.localSockAddr << interestList << QString();
+    packetStream << (_alwaysFullLists ? 0 : node.domainListVersion);
+
+    node.lastCheckInUsecs = usecTimestampNow();
+    ++_checkInsSent;
+    _socket.writePacket(std::move(packet), _domainServerSockAddr);
+}
+
+void DomainLoadTest::disconnectNode(int nodeIndex) {
+    auto& node = _nodes[nodeIndex];
+
+    auto packet = NLPacket::create(PacketType::DomainDisconnectRequest, 0);
+    packet->writeSourceID(node.sessionUUID);
+    _socket.writePacket(std::move(packet), _domainServerSockAddr);
+
+    _nodeIndices.remove(node.sessionUUID);
+    node.sessionUUID = QUuid();
+    node.domainListVersion = 0;
+    node.firstConnectUsecs = 0;
+    node.lastConnectUsecs = 0;
+}
+
+void DomainLoadTest::handlePacket(std::unique_ptr<udt::Packet> packet) {
+    auto nlPacket = NLPacket::fromBase(std::move(packet));
+
+    if (nlPacket->getType() == PacketType::DomainConnectionDenied) {
+        qWarning() << "The domain-server refused an agent - check its max capacity and anonymous permissions";
+    }
+
+    // anything else is an added or removed node for the agents, which we don't track
+}
+
+void DomainLoadTest::handleMessagePacket(std::unique_ptr<udt::Packet> packet) {
+    auto messageNumber = packet->getMessageNumber();
+    auto position = packet->getPacketPosition();
+    auto nlPacket = NLPacket::fromBase(std::move(packet));
+
+    if (position == udt::Packet::ONLY) {
+        if (nlPacket->getType() == PacketType::DomainList) {
+            handleDomainList(nlPacket->readAll());
+        }
+        return;
+    }
+
+    // the header of each packet in a list is dropped, the payloads are joined up into the message
+    auto it = _pendingMessages.find(messageNumber);
+    if (it == _pendingMessages.end()) {
+        it = _pendingMessages.emplace(messageNumber, std::unique_ptr<Message>(new Message())).first;
+    }
+    it->second->data.append(nlPacket->readAll());
+
+    if (position == udt::Packet::LAST) {
+        if (nlPacket->getType() == PacketType::DomainList) {
+            handleDomainList(it->second->data);
+        }
+        _pendingMessages.erase(it);
+    }
+}
+
+void DomainLoadTest::handleDomainList(const QByteArray& message) {
+    QDataStream packetStream(message);
+
+    QUuid domainUUID;
+    QUuid sessionUUID;
+    NodePermissions permissions;
+    quint32 domainListVersion;
+    bool isDelta;
+    packetStream >> domainUUID >> sessionUUID >> permissions >> domainListVersion >> isDelta;
+
+    int nodeIndex = _nodeIndices.value(sessionUUID, -1);
+    if (nodeIndex == -1) {
+        if (_connectingNodes.empty()) {
+            // a late reply for an agent we already disconnected
+            return;
+        }
+
+        // the reply to a connect request we have out
+        nodeIndex = _connectingNodes.front();
+        _connectingNodes.pop_front();
+        _nodes[nodeIndex].sessionUUID = sessionUUID;
+        _nodeIndices.insert(sessionUUID, nodeIndex);
+
+        ++_admitted;
+        _totalAdmitUsecs += usecTimestampNow() - _nodes[nodeIndex].firstConnectUsecs;
+    } else {
+        quint64 latency = usecTimestampNow() - _nodes[nodeIndex].lastCheckInUsecs;
+        _totalLatencyUsecs += latency;
+        _maxLatencyUsecs = std::max(_maxLatencyUsecs, latency);
+
+        ++(isDelta ? _deltaLists : _fullLists);
+        _listBytes += message.size();
+    }
+
+    _nodes[nodeIndex].domainListVersion = domainListVersion;
+}
+
+void DomainLoadTest::printStats() {
+    int numLists = _fullLists + _deltaLists;
+    qDebug() << _nodeIndices.size() << "|" << _connectingNodes.size()
+        << "|" << (_admitted > 0 ? (float)_totalAdmitUsecs / _admitted / USECS_PER_MSEC : 0.0f)
+        << "|" << _checkInsSent << "|" << _fullLists << "|" << _deltaLists
+        << "|" << (numLists > 0 ? _listBytes / numLists : 0)
+        << "|" << (numLists > 0 ? (float)_totalLatencyUsecs / numLists / USECS_PER_MSEC : 0.0f)
+        << "|" << (float)_maxLatencyUsecs / USECS_PER_MSEC;
+
+    _checkInsSent = 0;
+    _fullLists = 0;
+    _deltaLists = 0;
+    _listBytes = 0;
+    _totalLatencyUsecs = 0;
+    _maxLatencyUsecs = 0;
+    _admitted = 0;
+    _totalAdmitUsecs = 0;
+
+    // churn some of the connected agents, they come back through the connect queue
+    for (int i = 0; i < _churnPerSecond && !_nodeIndices.isEmpty(); ++i) {
+        auto it = _nodeIndices.begin() + (randIntInRange(0, _nodeIndices.size() - 1));
+        disconnectNode(it.value());
+    }
+
+    if (_durationSeconds > 0 && _runTimer.elapsed() >= _durationSeconds * MSECS_PER_SECOND) {
+        for (int nodeIndex : _nodeIndices.values()) {
+            disconnectNode(nodeIndex);
+        }
+        quit();
+    }
+}
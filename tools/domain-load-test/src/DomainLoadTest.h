@@ -0,0 +1,105 @@
+//
+//  DomainLoadTest.h
+//  tools/domain-load-test/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_DomainLoadTest_h
+#define hifi_DomainLoadTest_h
+
+#include <deque>
+#include <unordered_map>
+#include <vector>
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QHash>
+#include <QtCore/QTimer>
+#include <QtCore/QUuid>
+
+#include <HifiSockAddr.h>
+#include <udt/Socket.h>
+
+// Connects a number of fake agents to a domain-server and has them check in at a given rate, to
+// measure what domain list replies cost as the node count grows. The agents share one socket, so
+// the domain-server sends all of their lists over a single reliable connection. In a storm all of
+// the agents ask to connect at once and keep retrying, like clients do when a big event starts.
+class DomainLoadTest : public QCoreApplication {
+    Q_OBJECT
+public:
+    DomainLoadTest(int& argc, char** argv);
+
+private slots:
+    void sendPackets();
+    void printStats();
+
+private:
+    struct SimulatedNode {
+        QString hardwareAddress;
+        QUuid machineFingerprint;
+        HifiSockAddr localSockAddr; // what tells the agents apart on the domain-server
+        quint64 firstConnectUsecs { 0 };
+        quint64 lastConnectUsecs { 0 };
+        QUuid sessionUUID;
+        quint32 domainListVersion { 0 };
+        quint64 lastCheckInUsecs { 0 };
+    };
+
+    struct Message {
+        QByteArray data;
+    };
+
+    void parseArguments();
+
+    void handlePacket(std::unique_ptr<udt::Packet> packet);
+    void handleMessagePacket(std::unique_ptr<udt::Packet> packet);
+    void handleDomainList(const QByteArray& message);
+
+    void sendConnectRequest(int nodeIndex);
+    void sendListRequest(SimulatedNode& node);
+    void disconnectNode(int nodeIndex);
+
+    udt::Socket _socket;
+    HifiSockAddr _domainServerSockAddr;
+    HifiSockAddr _publicSockAddr;
+
+    std::vector<SimulatedNode> _nodes;
+    QHash<QUuid, int> _nodeIndices; // connected nodes by session UUID
+
+    // agents waiting to connect, by when they first asked. A domain list for an unknown session UUID is
+    // taken as the reply to the first of them - only exact when they connect one at a time.
+    std::deque<int> _connectingNodes;
+
+    int _numNodes { 100 };
+    float _checkInsPerSecond { 100.0f };
+    int _churnPerSecond { 0 };
+    int _durationSeconds { -1 };
+    bool _alwaysFullLists { false };
+    bool _isStorm { false };
+
+    QTimer _sendTimer;
+    QTimer _statsTimer;
+    QElapsedTimer _runTimer;
+    float _checkInsOwed { 0.0f };
+    size_t _nextCheckInIndex { 0 };
+
+    std::unordered_map<udt::Packet::MessageNumber, std::unique_ptr<Message>> _pendingMessages;
+
+    // reset every stats interval
+    int _checkInsSent { 0 };
+    int _fullLists { 0 };
+    int _deltaLists { 0 };
+    qint64 _listBytes { 0 };
+    quint64 _totalLatencyUsecs { 0 };
+    quint64 _maxLatencyUsecs { 0 };
+    int _admitted { 0 };
+    quint64 _totalAdmitUsecs { 0 };
+};
+
+#endif // hifi_DomainLoadTest_h
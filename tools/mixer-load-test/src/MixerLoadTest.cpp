@@ -0,0 +1,464 @@
+//
+//  MixerLoadTest.cpp
+//  tools/mixer-load-test/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "MixerLoadTest.h"
+
+#include <algorithm>
+#include <limits>
+
+#include <QtCore/QCommandLineParser>
+#include <QtCore/QDebug>
+#include <QtCore/QFile>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QStandardPaths>
+#include <QtNetwork/QNetworkReply>
+
+#include <AudioConstants.h>
+#include <DomainHandler.h>
+#include <LogHandler.h>
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+#include <plugins/PluginManager.h>
+
+const QCommandLineOption DOMAIN_OPTION {
+    "d", "domain-server address (default is 127.0.0.1:" + QString::number(DEFAULT_DOMAIN_SERVER_PORT) + ")", "IP:PORT"
+};
+const QCommandLineOption AGENTS_OPTION { "n", "number of synthetic agents (default is 100)", "agents" };
+const QCommandLineOption TALKERS_OPTION { "talkers", "how many of the agents talk, the rest send silence (default is a tenth)", "agents" };
+const QCommandLineOption RAMP_OPTION { "ramp", "agents added per second (default is 50)", "agents" };
+const QCommandLineOption AVATAR_RATE_OPTION { "avatar-rate", "avatar data sends per second per agent (default is 50)", "rate" };
+const QCommandLineOption CODEC_OPTION { "codec", "only offer this audio codec (default is every codec plugin)", "name" };
+const QCommandLineOption METRICS_OPTION {
+    "metrics", "the mixers' metrics http_port_base domain setting, to scrape their frame times and throttling", "port"
+};
+const QCommandLineOption LAUNCH_OPTION {
+    "launch", "start a domain-server and the audio and avatar mixers from this build directory", "path"
+};
+const QCommandLineOption DURATION_OPTION { "t", "seconds to run for (default is until stopped)", "seconds" };
+const QCommandLineOption REPORT_OPTION { "report", "write the samples and a summary to this JSON file at the end", "file" };
+
+const int AUDIO_TIMER_MSECS = 2;
+const int ADD_AGENTS_INTERVAL_MSECS = 100;
+const int CHECK_IN_INTERVAL_MSECS = 100;
+const int STATS_INTERVAL_MSECS = 1000;
+// frames the agents have fallen behind by and still send, any more are skipped
+const quint64 MAX_AUDIO_CATCH_UP_FRAMES = 2;
+
+MixerLoadTest::MixerLoadTest(int& argc, char** argv) :
+    QCoreApplication(argc, argv)
+{
+    qInstallMessageHandler(LogHandler::verboseMessageHandler);
+
+    parseArguments();
+
+    if (!_codecName.isEmpty()) {
+        auto codecPlugins = PluginManager::getInstance()->getCodecPlugins();
+        bool hasCodec = std::any_of(codecPlugins.cbegin(), codecPlugins.cend(), [&](const CodecPluginPointer& codec) {
+            return codec->getName() == _codecName;
+        });
+        if (!hasCodec) {
+            qCritical() << "There is no codec plugin named" << _codecName << "in" << applicationDirPath() + "/plugins";
+            ::exit(EXIT_FAILURE);
+        }
+    }
+
+    connect(&_audioTimer, &QTimer::timeout, this, &MixerLoadTest::sendAudio);
+    _audioTimer.setTimerType(Qt::PreciseTimer);
+    _audioTimer.start(AUDIO_TIMER_MSECS);
+
+    connect(&_avatarTimer, &QTimer::timeout, this, &MixerLoadTest::sendAvatars);
+    _avatarTimer.setTimerType(Qt::PreciseTimer);
+    _avatarTimer.start((int)(MSECS_PER_SECOND / _avatarSendsPerSecond));
+
+    connect(&_addAgentsTimer, &QTimer::timeout, this, &MixerLoadTest::addAgents);
+    _addAgentsTimer.start(ADD_AGENTS_INTERVAL_MSECS);
+
+    connect(&_checkInTimer, &QTimer::timeout, this, &MixerLoadTest::checkIn);
+    _checkInTimer.start(CHECK_IN_INTERVAL_MSECS);
+
+    connect(&_statsTimer, &QTimer::timeout, this, &MixerLoadTest::sampleStats);
+    _statsTimer.start(STATS_INTERVAL_MSECS);
+
+    _runTimer.start();
+    _lastAvatarSendUsecs = usecTimestampNow();
+
+    qDebug() << "Driving the mixers of" << _domainServerSockAddr << "with" << _numAgents << "agents," << _numTalkers << "talking";
+    qDebug() << "Agents | Audio links | Avatar links | Late frames | Audio frame avg/p99 (ms) | Audio throttling"
+        << "| Avatar frame avg/p99 (ms) | Avatar throttling | Mixes dropped | Mic lost | Mic dropped"
+        << "| Receive kbps min/avg/max";
+}
+
+MixerLoadTest::~MixerLoadTest() {
+    // disconnect the agents before taking the servers down
+    _agents.clear();
+
+    for (auto& server : _servers) {
+        server->terminate();
+        const int SERVER_EXIT_WAIT_MSECS = 3000;
+        if (!server->waitForFinished(SERVER_EXIT_WAIT_MSECS)) {
+            server->kill();
+        }
+    }
+}
+
+void MixerLoadTest::parseArguments() {
+    QCommandLineParser parser;
+    parser.setApplicationDescription("High Fidelity audio and avatar mixer load test");
+    const QCommandLineOption helpOption = parser.addHelpOption();
+    parser.addOptions({ DOMAIN_OPTION, AGENTS_OPTION, TALKERS_OPTION, RAMP_OPTION, AVATAR_RATE_OPTION, CODEC_OPTION,
+                        METRICS_OPTION, LAUNCH_OPTION, DURATION_OPTION, REPORT_OPTION });
+
+    if (!parser.parse(arguments())) {
+        qCritical() << parser.errorText() << endl;
+        parser.showHelp();
+        Q_UNREACHABLE();
+    }
+
+    if (parser.isSet(helpOption)) {
+        parser.showHelp();
+        Q_UNREACHABLE();
+    }
+
+    QString domainServerAddress = "127.0.0.1";
+    quint16 domainServerPort = DEFAULT_DOMAIN_SERVER_PORT;
+    if (parser.isSet(DOMAIN_OPTION)) {
+        QStringList parts = parser.value(DOMAIN_OPTION).split(':');
+        domainServerAddress = parts[0];
+        if (parts.size() > 1) {
+            domainServerPort = parts[1].toUShort();
+        }
+    }
+    _domainServerSockAddr = HifiSockAddr(domainServerAddress, domainServerPort, true);
+
+    if (parser.isSet(AGENTS_OPTION)) {
+        _numAgents = std::max(parser.value(AGENTS_OPTION).toInt(), 1);
+    }
+    _numTalkers = parser.isSet(TALKERS_OPTION) ? parser.value(TALKERS_OPTION).toInt() : _numAgents / 10;
+    _numTalkers = glm::clamp(_numTalkers, 0, _numAgents);
+    if (parser.isSet(RAMP_OPTION)) {
+        _agentsPerSecond = std::max(parser.value(RAMP_OPTION).toInt(), 1);
+    }
+    if (parser.isSet(AVATAR_RATE_OPTION)) {
+        _avatarSendsPerSecond = glm::clamp(parser.value(AVATAR_RATE_OPTION).toFloat(), 1.0f, 100.0f);
+    }
+    _codecName = parser.value(CODEC_OPTION);
+    if (parser.isSet(METRICS_OPTION)) {
+        _metricsPortBase = parser.value(METRICS_OPTION).toInt();
+    }
+    if (parser.isSet(DURATION_OPTION)) {
+        _durationSeconds = parser.value(DURATION_OPTION).toInt();
+    }
+    _reportPath = parser.value(REPORT_OPTION);
+
+    if (parser.isSet(LAUNCH_OPTION)) {
+        launchServers(parser.value(LAUNCH_OPTION));
+    }
+}
+
+void MixerLoadTest::launchServers(const QString& buildPath) {
+    auto findServer = [&](const QString& name) {
+        QStringList paths { buildPath + "/" + name, buildPath + "/" + name + "/Release",
+                            buildPath + "/" + name + "/RelWithDebInfo", buildPath };
+        return QStandardPaths::findExecutable(name, paths);
+    };
+
+    QString domainServerPath = findServer("domain-server");
+    QString assignmentClientPath = findServer("assignment-client");
+    if (domainServerPath.isEmpty() || assignmentClientPath.isEmpty()) {
+        qCritical() << "Could not find the domain-server and assignment-client in" << buildPath;
+        ::exit(EXIT_FAILURE);
+    }
+
+    // the domain-server runs with its saved settings - set the metrics http_port_base there to pass it to --metrics
+    auto launch = [&](const QString& path, const QStringList& arguments) {
+        std::unique_ptr<QProcess> server(new QProcess());
+        server->setStandardOutputFile(QProcess::nullDevice());
+        server->setStandardErrorFile(QProcess::nullDevice());
+        server->start(path, arguments);
+        _servers.push_back(std::move(server));
+    };
+
+    const QString AUDIO_MIXER_TYPE = "0";
+    const QString AVATAR_MIXER_TYPE = "1";
+    launch(domainServerPath, {});
+    launch(assignmentClientPath, { "-t", AUDIO_MIXER_TYPE });
+    launch(assignmentClientPath, { "-t", AVATAR_MIXER_TYPE });
+
+    qDebug() << "Launched" << domainServerPath << "and the mixers";
+}
+
+void MixerLoadTest::addAgents() {
+    int numToAdd = std::max(_agentsPerSecond * ADD_AGENTS_INTERVAL_MSECS / (int)MSECS_PER_SECOND, 1);
+    for (int i = 0; i < numToAdd && (int)_agents.size() < _numAgents; ++i) {
+        // spread the talkers evenly over the agents
+        int index = (int)_agents.size();
+        bool isTalking = (index * _numTalkers / _numAgents) != ((index + 1) * _numTalkers / _numAgents);
+
+        _agents.emplace_back(new SyntheticAgent(index, _domainServerSockAddr, isTalking, _codecName));
+        _agents.back()->checkIn();
+    }
+
+    if ((int)_agents.size() == _numAgents) {
+        _addAgentsTimer.stop();
+    }
+}
+
+void MixerLoadTest::checkIn() {
+    // every agent checks in once a second, a slice at a time
+    size_t numToCheckIn = (_agents.size() * CHECK_IN_INTERVAL_MSECS + MSECS_PER_SECOND - 1) / MSECS_PER_SECOND;
+    for (size_t i = 0; i < numToCheckIn && !_agents.empty(); ++i) {
+        _nextCheckInIndex = (_nextCheckInIndex + 1) % _agents.size();
+        auto& agent = _agents[_nextCheckInIndex];
+        agent->checkIn();
+        agent->sendViewFrustum();
+    }
+}
+
+void MixerLoadTest::sendAudio() {
+    // keep to the network frame rate however the timer fires, like an audio device callback would
+    quint64 framesDue = (quint64)_runTimer.nsecsElapsed() / (AudioConstants::NETWORK_FRAME_USECS * NSECS_PER_USEC);
+    if (framesDue <= _audioFramesSent) {
+        return;
+    }
+
+    quint64 framesOwed = framesDue - _audioFramesSent;
+    if (framesOwed > 1) {
+        _lateAudioFrames += (int)(framesOwed - 1);
+    }
+
+    for (quint64 frame = 0; frame < std::min(framesOwed, MAX_AUDIO_CATCH_UP_FRAMES); ++frame) {
+        for (auto& agent : _agents) {
+            agent->sendAudioFrame();
+        }
+    }
+    _audioFramesSent = framesDue;
+}
+
+void MixerLoadTest::sendAvatars() {
+    quint64 now = usecTimestampNow();
+    float deltaTime = (float)(now - _lastAvatarSendUsecs) / USECS_PER_SECOND;
+    _lastAvatarSendUsecs = now;
+
+    for (auto& agent : _agents) {
+        agent->sendAvatarFrame(deltaTime);
+    }
+}
+
+void MixerLoadTest::scrapeMixer(quint16 port, const QString& frameMetric, const QString& throttlingMetric,
+                                MixerSample& sample) {
+    QNetworkRequest request(QUrl(QString("http://127.0.0.1:%1/metrics").arg(port)));
+    QNetworkReply* reply = _networkAccessManager.get(request);
+
+    connect(reply, &QNetworkReply::finished, this, [=, &sample] {
+        reply->deleteLater();
+        if (reply->error() != QNetworkReply::NoError) {
+            return;
+        }
+
+        const QByteArray BUCKET_NAME = (frameMetric + "_bucket").toUtf8();
+        const QByteArray SUM_NAME = (frameMetric + "_sum").toUtf8();
+        const QByteArray COUNT_NAME = (frameMetric + "_count").toUtf8();
+        const QByteArray THROTTLING_NAME = throttlingMetric.toUtf8();
+
+        FrameTimes frameTimes;
+        for (const QByteArray& line : reply->readAll().split('\n')) {
+            if (line.isEmpty() || line.startsWith('#')) {
+                continue;
+            }
+            int valueStart = line.lastIndexOf(' ');
+            QByteArray series = line.left(valueStart);
+            double value = line.mid(valueStart + 1).toDouble();
+            int labelsStart = series.indexOf('{');
+            QByteArray name = labelsStart < 0 ? series : series.left(labelsStart);
+
+            if (name == BUCKET_NAME) {
+                const QByteArray LE_LABEL = "le=\"";
+                int boundStart = series.indexOf(LE_LABEL) + LE_LABEL.size();
+                QByteArray bound = series.mid(boundStart, series.indexOf('"', boundStart) - boundStart);
+                frameTimes.buckets.emplace_back(bound == "+Inf" ? std::numeric_limits<double>::infinity() : bound.toDouble(),
+                                                value);
+            } else if (name == SUM_NAME) {
+                frameTimes.sum = value;
+            } else if (name == COUNT_NAME) {
+                frameTimes.count = value;
+            } else if (name == THROTTLING_NAME) {
+                sample.throttlingRatio = value;
+            }
+        }
+
+        // the frames since the last scrape
+        const FrameTimes& last = sample.frameTimes;
+        double numFrames = frameTimes.count - last.count;
+        if (sample.isScraped && numFrames > 0.0 && frameTimes.buckets.size() == last.buckets.size()) {
+            sample.frameAverageMsecs = (frameTimes.sum - last.sum) / numFrames * MSECS_PER_SECOND;
+
+            // the bucket the 99th percentile is in, the last finite bound if it is past all of them
+            const double PERCENTILE = 0.99;
+            for (size_t i = 0; i < frameTimes.buckets.size(); ++i) {
+                double bound = frameTimes.buckets[i].first;
+                if (bound != std::numeric_limits<double>::infinity()) {
+                    sample.frameP99Msecs = bound * MSECS_PER_SECOND;
+                }
+                if (frameTimes.buckets[i].second - last.buckets[i].second >= PERCENTILE * numFrames) {
+                    break;
+                }
+            }
+        }
+        sample.frameTimes = frameTimes;
+        sample.isScraped = true;
+    });
+}
+
+void MixerLoadTest::sampleStats() {
+    SyntheticAgent::Stats totals;
+    int numAudioLinks = 0;
+    int numAvatarLinks = 0;
+    int numReceiving = 0;
+    float minReceiveKbps = std::numeric_limits<float>::max();
+    float maxReceiveKbps = 0.0f;
+    float totalReceiveKbps = 0.0f;
+
+    const float BITS_PER_KILOBIT = 1000.0f;
+    const float SECONDS_PER_INTERVAL = (float)STATS_INTERVAL_MSECS / MSECS_PER_SECOND;
+    for (auto& agent : _agents) {
+        auto stats = agent->takeStats();
+        totals.mixedAudioDropped += stats.mixedAudioDropped;
+        totals.upstreamAudioLost += stats.upstreamAudioLost;
+        totals.upstreamFramesDropped += stats.upstreamFramesDropped;
+
+        numAudioLinks += agent->isLinkedToAudioMixer() ? 1 : 0;
+        numAvatarLinks += agent->isLinkedToAvatarMixer() ? 1 : 0;
+
+        if (agent->isLinkedToAudioMixer() || agent->isLinkedToAvatarMixer()) {
+            float kbps = (stats.audioBytesReceived + stats.avatarBytesReceived) * BITS_IN_BYTE
+                / BITS_PER_KILOBIT / SECONDS_PER_INTERVAL;
+            minReceiveKbps = std::min(minReceiveKbps, kbps);
+            maxReceiveKbps = std::max(maxReceiveKbps, kbps);
+            totalReceiveKbps += kbps;
+            ++numReceiving;
+        }
+    }
+    if (numReceiving == 0) {
+        minReceiveKbps = 0.0f;
+    }
+    float averageReceiveKbps = numReceiving > 0 ? totalReceiveKbps / numReceiving : 0.0f;
+
+    qDebug() << _agents.size() << "|" << numAudioLinks << "|" << numAvatarLinks << "|" << _lateAudioFrames
+        << "|" << _audioMixerSample.frameAverageMsecs << "/" << _audioMixerSample.frameP99Msecs
+        << "|" << _audioMixerSample.throttlingRatio
+        << "|" << _avatarMixerSample.frameAverageMsecs << "/" << _avatarMixerSample.frameP99Msecs
+        << "|" << _avatarMixerSample.throttlingRatio
+        << "|" << totals.mixedAudioDropped << "|" << totals.upstreamAudioLost << "|" << totals.upstreamFramesDropped
+        << "|" << minReceiveKbps << "/" << averageReceiveKbps << "/" << maxReceiveKbps;
+
+    QJsonObject sample;
+    sample["seconds"] = (double)_runTimer.elapsed() / MSECS_PER_SECOND;
+    sample["agents"] = (int)_agents.size();
+    sample["audio_links"] = numAudioLinks;
+    sample["avatar_links"] = numAvatarLinks;
+    sample["late_audio_frames"] = _lateAudioFrames;
+    sample["audio_frame_avg_ms"] = _audioMixerSample.frameAverageMsecs;
+    sample["audio_frame_p99_ms"] = _audioMixerSample.frameP99Msecs;
+    sample["audio_throttling_ratio"] = _audioMixerSample.throttlingRatio;
+    sample["avatar_frame_avg_ms"] = _avatarMixerSample.frameAverageMsecs;
+    sample["avatar_frame_p99_ms"] = _avatarMixerSample.frameP99Msecs;
+    sample["avatar_throttling_ratio"] = _avatarMixerSample.throttlingRatio;
+    sample["mixes_dropped"] = totals.mixedAudioDropped;
+    sample["mic_packets_lost"] = totals.upstreamAudioLost;
+    sample["mic_frames_dropped"] = totals.upstreamFramesDropped;
+    sample["receive_kbps_min"] = minReceiveKbps;
+    sample["receive_kbps_avg"] = averageReceiveKbps;
+    sample["receive_kbps_max"] = maxReceiveKbps;
+    _samples.append(sample);
+
+    _lateAudioFrames = 0;
+
+    // the values come back in time for the next sample
+    if (_metricsPortBase > 0) {
+        const int AUDIO_MIXER_TYPE = 0;
+        const int AVATAR_MIXER_TYPE = 1;
+        scrapeMixer(_metricsPortBase + AUDIO_MIXER_TYPE, "hifi_audio_mixer_frame_seconds",
+                    "hifi_audio_mixer_throttling_ratio", _audioMixerSample);
+        scrapeMixer(_metricsPortBase + AVATAR_MIXER_TYPE, "hifi_avatar_mixer_broadcast_seconds",
+                    "hifi_avatar_mixer_throttling_ratio", _avatarMixerSample);
+    }
+
+    if (_durationSeconds > 0 && _runTimer.elapsed() >= (qint64)_durationSeconds * (qint64)MSECS_PER_SECOND) {
+        finish();
+    }
+}
+
+void MixerLoadTest::finish() {
+    _statsTimer.stop();
+
+    if (!_reportPath.isEmpty()) {
+        // the summary only covers the samples with every agent added, the ramp up is in the samples
+        QJsonObject summary;
+        double maxAudioP99 = 0.0, maxAvatarP99 = 0.0, maxAudioThrottling = 0.0, maxAvatarThrottling = 0.0;
+        double totalAudioAverage = 0.0, totalAvatarAverage = 0.0, totalReceiveAverage = 0.0;
+        double minReceive = std::numeric_limits<double>::max();
+        int mixesDropped = 0, micLost = 0, micDropped = 0, lateFrames = 0, numSamples = 0;
+        for (const auto& value : _samples) {
+            QJsonObject sample = value.toObject();
+            if (sample["agents"].toInt() < _numAgents) {
+                continue;
+            }
+            ++numSamples;
+            maxAudioP99 = std::max(maxAudioP99, sample["audio_frame_p99_ms"].toDouble());
+            maxAvatarP99 = std::max(maxAvatarP99, sample["avatar_frame_p99_ms"].toDouble());
+            maxAudioThrottling = std::max(maxAudioThrottling, sample["audio_throttling_ratio"].toDouble());
+            maxAvatarThrottling = std::max(maxAvatarThrottling, sample["avatar_throttling_ratio"].toDouble());
+            totalAudioAverage += sample["audio_frame_avg_ms"].toDouble();
+            totalAvatarAverage += sample["avatar_frame_avg_ms"].toDouble();
+            totalReceiveAverage += sample["receive_kbps_avg"].toDouble();
+            minReceive = std::min(minReceive, sample["receive_kbps_min"].toDouble());
+            mixesDropped += sample["mixes_dropped"].toInt();
+            micLost += sample["mic_packets_lost"].toInt();
+            micDropped += sample["mic_frames_dropped"].toInt();
+            lateFrames += sample["late_audio_frames"].toInt();
+        }
+        if (numSamples > 0) {
+            summary["samples"] = numSamples;
+            summary["audio_frame_avg_ms"] = totalAudioAverage / numSamples;
+            summary["audio_frame_p99_ms_max"] = maxAudioP99;
+            summary["audio_throttling_ratio_max"] = maxAudioThrottling;
+            summary["avatar_frame_avg_ms"] = totalAvatarAverage / numSamples;
+            summary["avatar_frame_p99_ms_max"] = maxAvatarP99;
+            summary["avatar_throttling_ratio_max"] = maxAvatarThrottling;
+            summary["receive_kbps_avg"] = totalReceiveAverage / numSamples;
+            summary["receive_kbps_min"] = minReceive;
+            summary["mixes_dropped"] = mixesDropped;
+            summary["mic_packets_lost"] = micLost;
+            summary["mic_frames_dropped"] = micDropped;
+            summary["late_audio_frames"] = lateFrames;
+        }
+
+        QJsonObject config;
+        config["agents"] = _numAgents;
+        config["talkers"] = _numTalkers;
+        config["avatar_rate"] = _avatarSendsPerSecond;
+        config["codec"] = _codecName;
+
+        QJsonObject report;
+        report["config"] = config;
+        report["summary"] = summary;
+        report["samples"] = _samples;
+
+        QFile reportFile(_reportPath);
+        if (reportFile.open(QIODevice::WriteOnly)) {
+            reportFile.write(QJsonDocument(report).toJson());
+            qDebug() << "Wrote the report to" << _reportPath;
+        } else {
+            qWarning() << "Could not write the report to" << _reportPath;
+        }
+    }
+
+    quit();
+}
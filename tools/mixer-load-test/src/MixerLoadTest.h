@@ -0,0 +1,103 @@
+//
+//  MixerLoadTest.h
+//  tools/mixer-load-test/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_MixerLoadTest_h
+#define hifi_MixerLoadTest_h
+
+#include <memory>
+#include <vector>
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QHash>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonObject>
+#include <QtCore/QProcess>
+#include <QtCore/QTimer>
+#include <QtNetwork/QNetworkAccessManager>
+
+#include <HifiSockAddr.h>
+
+#include "SyntheticAgent.h"
+
+// Drives the audio and avatar mixers of a domain with synthetic agents and reports how they hold up:
+// the mixers' frame times and throttling (scraped from their /metrics endpoints), the audio dropped
+// on the way up and down, and what each agent receives. Optionally starts the domain-server and the
+// two mixers itself, so a run needs nothing but a build.
+class MixerLoadTest : public QCoreApplication {
+    Q_OBJECT
+public:
+    MixerLoadTest(int& argc, char** argv);
+    ~MixerLoadTest();
+
+private slots:
+    void sendAudio();
+    void sendAvatars();
+    void addAgents();
+    void checkIn();
+    void sampleStats();
+
+private:
+    // a mixer's frame time histogram, as of the last scrape
+    struct FrameTimes {
+        double sum { 0.0 };
+        double count { 0.0 };
+        std::vector<std::pair<double, double>> buckets; // upper bound and cumulative count
+    };
+
+    struct MixerSample {
+        bool isScraped { false };
+        FrameTimes frameTimes;
+        double frameAverageMsecs { 0.0 };
+        double frameP99Msecs { 0.0 };
+        double throttlingRatio { 0.0 };
+    };
+
+    void parseArguments();
+    void launchServers(const QString& buildPath);
+    void scrapeMixer(quint16 port, const QString& frameMetric, const QString& throttlingMetric, MixerSample& sample);
+    void finish();
+
+    HifiSockAddr _domainServerSockAddr;
+    int _numAgents { 100 };
+    int _numTalkers { -1 };
+    int _agentsPerSecond { 50 };
+    float _avatarSendsPerSecond { 50.0f };
+    QString _codecName;
+    int _metricsPortBase { 0 };
+    int _durationSeconds { -1 };
+    QString _reportPath;
+
+    std::vector<std::unique_ptr<SyntheticAgent>> _agents;
+
+    QTimer _audioTimer;
+    QTimer _avatarTimer;
+    QTimer _addAgentsTimer;
+    QTimer _checkInTimer;
+    QTimer _statsTimer;
+    QElapsedTimer _runTimer;
+    quint64 _audioFramesSent { 0 };
+    quint64 _lastAvatarSendUsecs { 0 };
+    size_t _nextCheckInIndex { 0 };
+
+    std::vector<std::unique_ptr<QProcess>> _servers;
+    QNetworkAccessManager _networkAccessManager;
+    MixerSample _audioMixerSample;
+    MixerSample _avatarMixerSample;
+
+    // reset every stats interval
+    int _lateAudioFrames { 0 };
+
+    QJsonArray _samples;
+};
+
+#endif // hifi_MixerLoadTest_h
@@ -0,0 +1,484 @@
+//
+//  SyntheticAgent.cpp
+//  tools/mixer-load-test/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "SyntheticAgent.h"
+
+#include <limits>
+
+#include <QtCore/QDataStream>
+#include <QtCore/QDebug>
+#include <QtCore/QStringList>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <AudioConstants.h>
+#include <AudioStreamStats.h>
+#include <GLMHelpers.h>
+#include <LimitedNodeList.h>
+#include <NodePermissions.h>
+#include <NodeType.h>
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+#include <ViewFrustum.h>
+#include <plugins/PluginManager.h>
+#include <udt/PacketHeaders.h>
+
+// agents walk in circles around where they start, a couple of meters across
+const float WALK_RADIUS = 1.0f;
+const float WALK_SPEED = 0.5f; // meters per second
+const int NUM_JOINTS = 60;
+const float EYE_HEIGHT = 1.6f;
+const glm::vec3 AVATAR_BOUNDING_BOX_SCALE { 0.6f, 1.8f, 0.6f };
+
+// talkers speak in phrases, with a syllable envelope, and pause between them
+const int PHRASE_FRAMES = 300;
+const int PAUSE_FRAMES = 100;
+const float SYLLABLES_PER_SECOND = 4.0f;
+const float TONE_AMPLITUDE = 0.25f * AudioConstants::MAX_SAMPLE_VALUE;
+
+SyntheticAgent::SyntheticAgent(int index, const HifiSockAddr& domainServerSockAddr, bool isTalking, const QString& codecName,
+                               QObject* parent) :
+    QObject(parent),
+    _domainServerSockAddr(domainServerSockAddr),
+    _machineFingerprint(QUuid::createUuid()),
+    _isTalking(isTalking),
+    _codecName(codecName),
+    _toneFrequency(randFloatInRange(100.0f, 300.0f)),
+    _avatar(new AvatarData()),
+    _walkAngle(randFloatInRange(0.0f, TWO_PI))
+{
+    _socket.bind(QHostAddress::LocalHost);
+    _sockAddr = HifiSockAddr(QHostAddress::LocalHost, _socket.localPort());
+
+    _socket.setPacketHandler([this](std::unique_ptr<udt::Packet> packet) {
+        handlePacket(std::move(packet));
+    });
+    _socket.setMessageHandler([this](std::unique_ptr<udt::Packet> packet) {
+        handleMessagePacket(std::move(packet));
+    });
+    _socket.setMessageFailureHandler([this](HifiSockAddr from, udt::Packet::MessageNumber messageNumber) {
+        _pendingMessages.erase(messageNumber);
+    });
+
+    // every agent looks like its own machine, so the domain-server does not match them up
+    QByteArray addressBytes = _machineFingerprint.toRfc4122().left(6);
+    addressBytes[0] = 0x02; // locally administered
+    QStringList addressParts;
+    for (char byte : addressBytes) {
+        addressParts << QString("%1").arg((quint8)byte, 2, 16, QChar('0'));
+    }
+    _hardwareAddress = addressParts.join(':');
+
+    // spread the agents over a grid, a few meters apart
+    const float GRID_SPACING = 3.0f;
+    const int GRID_WIDTH = 32;
+    _walkCenter = glm::vec3(GRID_SPACING * (index % GRID_WIDTH), 0.0f, GRID_SPACING * (index / GRID_WIDTH));
+    sendAvatarFrame(0.0f);
+}
+
+SyntheticAgent::~SyntheticAgent() {
+    if (isConnected()) {
+        auto packet = NLPacket::create(PacketType::DomainDisconnectRequest, 0);
+        packet->writeSourceID(_sessionUUID);
+        _socket.writePacket(std::move(packet), _domainServerSockAddr);
+    }
+
+    if (_codec && _encoder) {
+        _codec->releaseEncoder(_encoder);
+    }
+}
+
+void SyntheticAgent::checkIn() {
+    QList<NodeType_t> interestList { NodeType::AudioMixer, NodeType::AvatarMixer };
+
+    if (!isConnected()) {
+        auto packet = NLPacket::create(PacketType::DomainConnectRequest);
+        QDataStream packetStream(packet.get());
+
+        packetStream << QUuid();
+
+        QByteArray protocolVersionSig = protocolVersionsSignature();
+        packetStream.writeBytes(protocolVersionSig.constData(), protocolVersionSig.size());
+
+        packetStream << _hardwareAddress << _machineFingerprint;
+        packetStream << NodeType::Agent << _sockAddr << _sockAddr << interestList << QString();
+
+        // an anonymous agent
+        packetStream << QString();
+
+        _socket.writePacket(std::move(packet), _domainServerSockAddr);
+        return;
+    }
+
+    auto packet = NLPacket::create(PacketType::DomainListRequest);
+    packet->writeSourceID(_sessionUUID);
+
+    QDataStream packetStream(packet.get());
+    packetStream << NodeType::Agent << _sockAddr << _sockAddr << interestList << QString();
+    packetStream << _domainListVersion;
+
+    _socket.writePacket(std::move(packet), _domainServerSockAddr);
+
+    // the format negotiation is a plain packet, ask again until the audio mixer answers
+    if (isLinkedToAudioMixer() && !_hasSelectedCodec) {
+        negotiateAudioFormat();
+    }
+}
+
+void SyntheticAgent::sendAudioFrame() {
+    if (!isLinkedToAudioMixer() || !_hasSelectedCodec) {
+        return;
+    }
+
+    int phraseFrame = _audioFrame++ % (PHRASE_FRAMES + PAUSE_FRAMES);
+    bool isSilent = !_isTalking || phraseFrame >= PHRASE_FRAMES;
+
+    auto packetType = isSilent ? PacketType::SilentAudioFrame : PacketType::MicrophoneAudioNoEcho;
+    auto audioPacket = NLPacket::create(packetType);
+
+    audioPacket->writePrimitive(_outgoingAudioSequence++);
+    audioPacket->writeString(_selectedCodecName);
+
+    if (isSilent) {
+        quint16 numSilentSamples = AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL;
+        audioPacket->writePrimitive(numSilentSamples);
+    } else {
+        quint8 isStereo = 0;
+        audioPacket->writePrimitive(isStereo);
+    }
+
+    glm::vec3 position = _avatar->getPosition();
+    audioPacket->writePrimitive(position);
+    audioPacket->writePrimitive(_avatar->getOrientation());
+    audioPacket->writePrimitive(position - 0.5f * AVATAR_BOUNDING_BOX_SCALE);
+    audioPacket->writePrimitive(AVATAR_BOUNDING_BOX_SCALE);
+
+    if (!isSilent) {
+        QByteArray decodedBuffer(AudioConstants::NETWORK_FRAME_BYTES_PER_CHANNEL, 0);
+        auto samples = reinterpret_cast<int16_t*>(decodedBuffer.data());
+
+        const float PHASE_STEP = TWO_PI * _toneFrequency / AudioConstants::SAMPLE_RATE;
+        const float ENVELOPE_STEP = TWO_PI * SYLLABLES_PER_SECOND / AudioConstants::SAMPLE_RATE;
+        int firstSample = phraseFrame * AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL;
+        for (int i = 0; i < AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL; ++i) {
+            float envelope = 0.5f - 0.5f * cosf(ENVELOPE_STEP * (firstSample + i));
+            samples[i] = (int16_t)(TONE_AMPLITUDE * envelope * sinf(_tonePhase));
+            _tonePhase = fmodf(_tonePhase + PHASE_STEP, TWO_PI);
+        }
+
+        if (_encoder) {
+            QByteArray encodedBuffer;
+            _encoder->encode(decodedBuffer, encodedBuffer);
+            audioPacket->write(encodedBuffer);
+        } else {
+            audioPacket->write(decodedBuffer);
+        }
+    }
+
+    sendToMixer(*audioPacket, _audioMixer);
+}
+
+void SyntheticAgent::sendAvatarFrame(float deltaTime) {
+    _walkAngle = fmodf(_walkAngle + deltaTime * WALK_SPEED / WALK_RADIUS, TWO_PI);
+    glm::vec3 offset(cosf(_walkAngle), 0.0f, sinf(_walkAngle));
+    _avatar->setPosition(_walkCenter + WALK_RADIUS * offset);
+    // face along the circle
+    _avatar->setOrientation(glm::angleAxis(-_walkAngle, Vectors::UNIT_Y));
+
+    // sway the joints a little, so some of them change from one frame to the next
+    for (int i = 0; i < NUM_JOINTS; ++i) {
+        float angle = 0.2f * sinf(_walkAngle * 4.0f + (float)i);
+        _avatar->setJointData(i, glm::angleAxis(angle, Vectors::UNIT_X), Vectors::ZERO);
+    }
+
+    if (!isLinkedToAvatarMixer()) {
+        return;
+    }
+
+    // now and then send all of the joints, like a client does
+    bool sendAll = randFloat() < AVATAR_SEND_FULL_UPDATE_RATIO;
+    QByteArray avatarByteArray = _avatar->toByteArrayStateful(sendAll ? AvatarData::SendAllData : AvatarData::CullSmallData);
+    _avatar->doneEncoding(sendAll);
+
+    auto avatarPacket = NLPacket::create(PacketType::AvatarData, avatarByteArray.size() + sizeof(_avatarSequence));
+    avatarPacket->writePrimitive(_avatarSequence++);
+    avatarPacket->write(avatarByteArray);
+
+    sendToMixer(*avatarPacket, _avatarMixer);
+}
+
+void SyntheticAgent::sendViewFrustum() {
+    if (!isLinkedToAvatarMixer()) {
+        return;
+    }
+
+    ViewFrustum viewFrustum;
+    viewFrustum.setPosition(_avatar->getPosition() + glm::vec3(0.0f, EYE_HEIGHT, 0.0f));
+    viewFrustum.setOrientation(_avatar->getOrientation());
+    viewFrustum.setProjection(glm::perspective(glm::radians(DEFAULT_FIELD_OF_VIEW_DEGREES), DEFAULT_ASPECT_RATIO,
+                                               DEFAULT_NEAR_CLIP, DEFAULT_FAR_CLIP));
+    viewFrustum.calculate();
+
+    QByteArray viewFrustumByteArray = viewFrustum.toByteArray();
+    auto viewFrustumPacket = NLPacket::create(PacketType::ViewFrustum, viewFrustumByteArray.size());
+    viewFrustumPacket->write(viewFrustumByteArray);
+
+    sendToMixer(*viewFrustumPacket, _avatarMixer);
+}
+
+SyntheticAgent::Stats SyntheticAgent::takeStats() {
+    Stats stats = _stats;
+    _stats = Stats();
+    return stats;
+}
+
+SyntheticAgent::Mixer* SyntheticAgent::mixerForPacket(const NLPacket& packet) {
+    if (packet.getSourceID().isNull()) {
+        return nullptr;
+    } else if (packet.getSourceID() == _audioMixer.uuid) {
+        return &_audioMixer;
+    } else if (packet.getSourceID() == _avatarMixer.uuid) {
+        return &_avatarMixer;
+    }
+    return nullptr;
+}
+
+void SyntheticAgent::sendToMixer(NLPacket& packet, const Mixer& mixer) {
+    packet.writeSourceID(_sessionUUID);
+    packet.writeVerificationHashGivenSecret(mixer.connectionSecret);
+    _socket.writePacket(packet, mixer.activeSockAddr);
+}
+
+void SyntheticAgent::handlePacket(std::unique_ptr<udt::Packet> packet) {
+    auto nlPacket = NLPacket::fromBase(std::move(packet));
+
+    if (nlPacket->getType() == PacketType::DomainConnectionDenied) {
+        qWarning() << "The domain-server refused an agent - check its max capacity and anonymous permissions";
+        return;
+    }
+
+    auto mixer = mixerForPacket(*nlPacket);
+    if (!mixer) {
+        return;
+    }
+
+    if (mixer == &_audioMixer) {
+        _stats.audioBytesReceived += nlPacket->getDataSize();
+    } else {
+        _stats.avatarBytesReceived += nlPacket->getDataSize();
+    }
+
+    switch (nlPacket->getType()) {
+        case PacketType::Ping:
+            handlePing(*nlPacket, *mixer);
+            break;
+        case PacketType::SelectedAudioFormat:
+            handleSelectedAudioFormat(*nlPacket);
+            break;
+        case PacketType::MixedAudio:
+        case PacketType::SilentAudioFrame:
+            handleMixedAudio(*nlPacket);
+            break;
+        case PacketType::AudioStreamStats:
+            handleAudioStreamStats(*nlPacket);
+            break;
+        default:
+            // avatar data, environment and the rest are only counted
+            break;
+    }
+}
+
+void SyntheticAgent::handleMessagePacket(std::unique_ptr<udt::Packet> packet) {
+    auto messageNumber = packet->getMessageNumber();
+    auto position = packet->getPacketPosition();
+    auto nlPacket = NLPacket::fromBase(std::move(packet));
+
+    // avatar identities from the avatar mixer are the only other messages we get, and are only counted
+    if (auto mixer = mixerForPacket(*nlPacket)) {
+        if (mixer == &_avatarMixer) {
+            _stats.avatarBytesReceived += nlPacket->getDataSize();
+        }
+        return;
+    }
+
+    if (position == udt::Packet::ONLY) {
+        if (nlPacket->getType() == PacketType::DomainList) {
+            handleDomainList(nlPacket->readAll());
+        }
+        return;
+    }
+
+    // the header of each packet in a list is dropped, the payloads are joined up into the message
+    auto it = _pendingMessages.find(messageNumber);
+    if (it == _pendingMessages.end()) {
+        it = _pendingMessages.emplace(messageNumber, std::unique_ptr<Message>(new Message())).first;
+    }
+    it->second->data.append(nlPacket->readAll());
+
+    if (position == udt::Packet::LAST) {
+        if (nlPacket->getType() == PacketType::DomainList) {
+            handleDomainList(it->second->data);
+        }
+        _pendingMessages.erase(it);
+    }
+}
+
+void SyntheticAgent::handleDomainList(const QByteArray& message) {
+    QDataStream packetStream(message);
+
+    QUuid domainUUID;
+    QUuid sessionUUID;
+    NodePermissions permissions;
+    bool isDelta;
+    packetStream >> domainUUID >> sessionUUID >> permissions >> _domainListVersion >> isDelta;
+
+    _sessionUUID = sessionUUID;
+
+    if (isDelta) {
+        QList<QUuid> removedNodes;
+        packetStream >> removedNodes;
+        for (Mixer* mixer : { &_audioMixer, &_avatarMixer }) {
+            if (removedNodes.contains(mixer->uuid)) {
+                *mixer = Mixer();
+            }
+        }
+    }
+
+    while (!packetStream.atEnd()) {
+        qint8 nodeType;
+        QUuid nodeUUID, connectionSecret;
+        HifiSockAddr publicSocket, localSocket;
+        NodePermissions nodePermissions;
+        packetStream >> nodeType >> nodeUUID >> publicSocket >> localSocket >> nodePermissions >> connectionSecret;
+
+        Mixer* mixer = nodeType == NodeType::AudioMixer ? &_audioMixer
+            : nodeType == NodeType::AvatarMixer ? &_avatarMixer : nullptr;
+        if (!mixer) {
+            continue;
+        }
+
+        if (mixer->uuid != nodeUUID) {
+            // a new mixer, it pings us once it hears about us from the domain-server
+            *mixer = Mixer();
+            mixer->uuid = nodeUUID;
+
+            if (mixer == &_audioMixer) {
+                _hasSelectedCodec = false;
+                _hasMixedAudioSequence = false;
+                _upstreamLost = 0;
+                _upstreamFramesDropped = 0;
+            }
+        }
+        mixer->connectionSecret = connectionSecret;
+    }
+}
+
+void SyntheticAgent::handlePing(NLPacket& packet, Mixer& mixer) {
+    PingType_t pingType;
+    quint64 timeFromOriginalPing;
+    packet.readPrimitive(&pingType);
+    packet.readPrimitive(&timeFromOriginalPing);
+
+    bool isFirstPing = mixer.activeSockAddr.isNull();
+    mixer.activeSockAddr = packet.getSenderSockAddr();
+
+    // the mixer takes our reply as the go ahead to send to us
+    int packetSize = sizeof(PingType_t) + sizeof(quint64) + sizeof(quint64);
+    auto replyPacket = NLPacket::create(PacketType::PingReply, packetSize);
+    replyPacket->writePrimitive(pingType);
+    replyPacket->writePrimitive(timeFromOriginalPing);
+    replyPacket->writePrimitive(usecTimestampNow());
+    sendToMixer(*replyPacket, mixer);
+
+    if (isFirstPing && &mixer == &_audioMixer) {
+        negotiateAudioFormat();
+    }
+}
+
+void SyntheticAgent::negotiateAudioFormat() {
+    QStringList codecNames;
+    for (auto& plugin : PluginManager::getInstance()->getCodecPlugins()) {
+        if (_codecName.isEmpty() || plugin->getName() == _codecName) {
+            codecNames << plugin->getName();
+        }
+    }
+
+    // with no codecs the mixer falls back to raw PCM
+    auto negotiateFormatPacket = NLPacket::create(PacketType::NegotiateAudioFormat);
+    quint8 numberOfCodecs = (quint8)codecNames.size();
+    negotiateFormatPacket->writePrimitive(numberOfCodecs);
+    for (auto& codecName : codecNames) {
+        negotiateFormatPacket->writeString(codecName);
+    }
+
+    sendToMixer(*negotiateFormatPacket, _audioMixer);
+}
+
+void SyntheticAgent::handleSelectedAudioFormat(NLPacket& packet) {
+    selectAudioFormat(packet.readString());
+}
+
+void SyntheticAgent::selectAudioFormat(const QString& codecName) {
+    if (_codec && _encoder) {
+        _codec->releaseEncoder(_encoder);
+        _encoder = nullptr;
+        _codec = nullptr;
+    }
+
+    for (auto& plugin : PluginManager::getInstance()->getCodecPlugins()) {
+        if (codecName == plugin->getName()) {
+            _codec = plugin;
+            _encoder = plugin->createEncoder(AudioConstants::SAMPLE_RATE, AudioConstants::MONO);
+            break;
+        }
+    }
+
+    _selectedCodecName = codecName;
+    _hasSelectedCodec = true;
+}
+
+void SyntheticAgent::handleMixedAudio(NLPacket& packet) {
+    quint16 sequence;
+    packet.readPrimitive(&sequence);
+
+    if (_hasMixedAudioSequence) {
+        // anything in the back half of the sequence space is late or duplicated, not a gap
+        quint16 gap = sequence - _nextMixedAudioSequence;
+        if (gap >= std::numeric_limits<quint16>::max() / 2) {
+            return;
+        }
+        _stats.mixedAudioDropped += gap;
+    }
+
+    _hasMixedAudioSequence = true;
+    _nextMixedAudioSequence = sequence + 1;
+}
+
+void SyntheticAgent::handleAudioStreamStats(NLPacket& packet) {
+    quint8 appendFlag;
+    quint16 numStreamStats;
+    packet.readPrimitive(&appendFlag);
+    packet.readPrimitive(&numStreamStats);
+
+    // the stats of our own microphone stream are the only ones the mixer has for us
+    if (numStreamStats == 0) {
+        return;
+    }
+    AudioStreamStats streamStats;
+    packet.readPrimitive(&streamStats);
+
+    // the mixer's totals only go up for a given stream
+    quint32 lost = streamStats._packetStreamStats._lost;
+    quint32 framesDropped = streamStats._framesDropped;
+    _stats.upstreamAudioLost += lost >= _upstreamLost ? lost - _upstreamLost : lost;
+    _stats.upstreamFramesDropped += framesDropped >= _upstreamFramesDropped ? framesDropped - _upstreamFramesDropped : framesDropped;
+    _upstreamLost = lost;
+    _upstreamFramesDropped = framesDropped;
+}
@@ -0,0 +1,126 @@
+//
+//  SyntheticAgent.h
+//  tools/mixer-load-test/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_SyntheticAgent_h
+#define hifi_SyntheticAgent_h
+
+#include <memory>
+#include <unordered_map>
+
+#include <QtCore/QObject>
+#include <QtCore/QUuid>
+
+#include <glm/glm.hpp>
+
+#include <AvatarData.h>
+#include <HifiSockAddr.h>
+#include <NLPacket.h>
+#include <plugins/CodecPlugin.h>
+#include <udt/Socket.h>
+
+// A headless client with its own socket: it connects to the domain-server like an interface does,
+// answers the mixers' pings and then streams microphone audio and avatar data to them, counting
+// what the mixers send back.
+class SyntheticAgent : public QObject {
+    Q_OBJECT
+public:
+    // totals since the last takeStats()
+    struct Stats {
+        int audioBytesReceived { 0 };
+        int avatarBytesReceived { 0 };
+        int mixedAudioDropped { 0 }; // gaps in the sequence numbers of the mixes sent to this agent
+        int upstreamAudioLost { 0 }; // mic packets the audio mixer says it never got
+        int upstreamFramesDropped { 0 }; // mic frames the audio mixer dropped from its jitter buffer
+    };
+
+    SyntheticAgent(int index, const HifiSockAddr& domainServerSockAddr, bool isTalking, const QString& codecName,
+                   QObject* parent = nullptr);
+    ~SyntheticAgent();
+
+    // connect to the domain-server, or check in once connected
+    void checkIn();
+    // one network frame of audio to the audio mixer
+    void sendAudioFrame();
+    // one frame of avatar data to the avatar mixer, moving the avatar by deltaTime
+    void sendAvatarFrame(float deltaTime);
+    // where the avatar is looking, so the avatar mixer can cull what it sends
+    void sendViewFrustum();
+
+    bool isConnected() const { return !_sessionUUID.isNull(); }
+    bool isLinkedToAudioMixer() const { return !_audioMixer.activeSockAddr.isNull(); }
+    bool isLinkedToAvatarMixer() const { return !_avatarMixer.activeSockAddr.isNull(); }
+
+    Stats takeStats();
+
+private:
+    struct Mixer {
+        QUuid uuid;
+        QUuid connectionSecret;
+        HifiSockAddr activeSockAddr; // where its pings come from, null until the first one
+    };
+
+    struct Message {
+        QByteArray data;
+    };
+
+    void handlePacket(std::unique_ptr<udt::Packet> packet);
+    void handleMessagePacket(std::unique_ptr<udt::Packet> packet);
+    void handleDomainList(const QByteArray& message);
+    void handlePing(NLPacket& packet, Mixer& mixer);
+    void handleSelectedAudioFormat(NLPacket& packet);
+    void handleMixedAudio(NLPacket& packet);
+    void handleAudioStreamStats(NLPacket& packet);
+
+    Mixer* mixerForPacket(const NLPacket& packet);
+    void sendToMixer(NLPacket& packet, const Mixer& mixer);
+    void negotiateAudioFormat();
+    void selectAudioFormat(const QString& codecName);
+
+    udt::Socket _socket;
+    HifiSockAddr _domainServerSockAddr;
+    HifiSockAddr _sockAddr;
+    QString _hardwareAddress;
+    QUuid _machineFingerprint;
+
+    QUuid _sessionUUID;
+    quint32 _domainListVersion { 0 };
+    std::unordered_map<udt::Packet::MessageNumber, std::unique_ptr<Message>> _pendingMessages;
+
+    Mixer _audioMixer;
+    Mixer _avatarMixer;
+
+    // audio
+    bool _isTalking;
+    QString _codecName; // empty negotiates every codec plugin there is
+    CodecPluginPointer _codec;
+    Encoder* _encoder { nullptr };
+    QString _selectedCodecName;
+    bool _hasSelectedCodec { false };
+    quint16 _outgoingAudioSequence { 0 };
+    float _tonePhase { 0.0f };
+    float _toneFrequency;
+    int _audioFrame { 0 };
+    bool _hasMixedAudioSequence { false };
+    quint16 _nextMixedAudioSequence { 0 };
+    quint32 _upstreamLost { 0 };
+    quint32 _upstreamFramesDropped { 0 };
+
+    // avatar
+    std::unique_ptr<AvatarData> _avatar;
+    AvatarDataSequenceNumber _avatarSequence { 0 };
+    glm::vec3 _walkCenter;
+    float _walkAngle;
+
+    Stats _stats;
+};
+
+#endif // hifi_SyntheticAgent_h
@@ -0,0 +1,17 @@
+//
+//  main.cpp
+//  tools/mixer-load-test/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+
+#include <QtCore/QCoreApplication>
+
+#include "MixerLoadTest.h"
+
+int main(int argc, char* argv[]) {
+    MixerLoadTest app(argc, argv);
+    return app.exec();
+}